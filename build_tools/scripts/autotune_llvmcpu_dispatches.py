@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+# Copyright 2023 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Tunes LLVMCPU dispatch tile sizes on the local CPU.
+
+Sweeps lowering configurations for the executables produced by
+`--iree-hal-dump-executable-benchmarks-to=` and records the fastest
+configuration per (target CPU, op signature) in a tuning database that the
+compiler consults with `--iree-codegen-llvmcpu-tuning-database=`.
+
+Example:
+  iree-compile model.mlir --iree-hal-target-backends=llvm-cpu \\
+      --iree-llvmcpu-target-cpu=host \\
+      --iree-hal-dump-executable-benchmarks-to=/tmp/benchmarks -o /dev/null
+  autotune_llvmcpu_dispatches.py --benchmarks_dir=/tmp/benchmarks \\
+      --database=tuning.json --compile_flag=--iree-llvmcpu-target-cpu=host
+  iree-compile model.mlir --iree-hal-target-backends=llvm-cpu \\
+      --iree-llvmcpu-target-cpu=host \\
+      --iree-codegen-llvmcpu-tuning-database=tuning.json -o model.vmfb
+
+Only the distribution and vector-parallel tile sizes of the root op are
+swept; other levels are kept from the compiler's default configuration.
+Existing database entries are replaced only when a faster configuration is
+found.
+"""
+
+import argparse
+import itertools
+import json
+import pathlib
+import re
+import subprocess
+import sys
+import tempfile
+from typing import Dict, List, Optional, Tuple
+
+# Must match kCPUTuningDatabaseVersion in
+# compiler/src/iree/compiler/Codegen/LLVMCPU/TuningDatabase.h.
+DATABASE_VERSION = 1
+
+ENTRY_PREFIX = "iree-llvmcpu-tuning-entry: "
+TILE_SIZES_PATTERN = re.compile(r"tile_sizes = (\[\[[0-9, \[\]]*\]\])")
+
+
+def parse_arguments():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--benchmarks_dir",
+        type=pathlib.Path,
+        required=True,
+        help="directory of *_benchmark.mlir files to tune",
+    )
+    parser.add_argument(
+        "--database",
+        type=pathlib.Path,
+        required=True,
+        help="tuning database to update (created if it does not exist)",
+    )
+    parser.add_argument(
+        "--iree_compile", default="iree-compile", help="path to iree-compile"
+    )
+    parser.add_argument(
+        "--iree_benchmark_module",
+        default="iree-benchmark-module",
+        help="path to iree-benchmark-module",
+    )
+    parser.add_argument(
+        "--compile_flag",
+        action="append",
+        default=[],
+        help="additional flag passed to iree-compile (repeatable)",
+    )
+    parser.add_argument(
+        "--device", default="local-task", help="device to benchmark on"
+    )
+    parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=5,
+        help="benchmark repetitions; the median is used",
+    )
+    parser.add_argument(
+        "--min_speedup",
+        type=float,
+        default=1.03,
+        help="minimum speedup over the default configuration to record",
+    )
+    parser.add_argument(
+        "--max_candidates",
+        type=int,
+        default=64,
+        help="maximum number of candidates to measure per dispatch",
+    )
+    return parser.parse_args()
+
+
+def compile_module(
+    args, source: pathlib.Path, output: pathlib.Path, extra_flags: List[str]
+) -> str:
+    """Compiles `source` and returns the compiler's stderr."""
+    cmd = [
+        args.iree_compile,
+        str(source),
+        "--iree-hal-target-backends=llvm-cpu",
+        f"-o={output}",
+    ]
+    cmd += args.compile_flag + extra_flags
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"compilation failed:\n{result.stderr}")
+    return result.stderr
+
+
+def benchmark_module(args, module: pathlib.Path, export_name: str) -> float:
+    """Returns the median real time in nanoseconds of the benchmark for
+    `export_name` in `module`."""
+    cmd = [
+        args.iree_benchmark_module,
+        f"--module={module}",
+        f"--device={args.device}",
+        f"--benchmark_filter=_{re.escape(export_name)}(_|/)",
+        f"--benchmark_repetitions={args.repetitions}",
+        "--benchmark_report_aggregates_only=true",
+        "--benchmark_format=json",
+    ]
+    result = subprocess.run(cmd, capture_output=True, text=True, check=True)
+    report = json.loads(result.stdout)
+    for benchmark in report["benchmarks"]:
+        if benchmark.get("aggregate_name") != "median":
+            continue
+        unit_scale = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+        return benchmark["real_time"] * unit_scale[benchmark["time_unit"]]
+    raise RuntimeError(f"no benchmark results for {export_name}")
+
+
+def query_entries(args, source: pathlib.Path, workdir: pathlib.Path) -> List[Dict]:
+    """Returns the default tuning entries for all dispatches in `source`."""
+    stderr = compile_module(
+        args,
+        source,
+        workdir / "default.vmfb",
+        ["--iree-codegen-llvmcpu-print-tuning-entries"],
+    )
+    entries = []
+    for line in stderr.splitlines():
+        if line.startswith(ENTRY_PREFIX):
+            entries.append(json.loads(line[len(ENTRY_PREFIX) :]))
+    return entries
+
+
+def get_tile_sizes(compilation_info: str) -> Optional[List[List[int]]]:
+    match = TILE_SIZES_PATTERN.search(compilation_info)
+    return json.loads(match.group(1)) if match else None
+
+
+def set_tile_sizes(compilation_info: str, tile_sizes: List[List[int]]) -> str:
+    return TILE_SIZES_PATTERN.sub(
+        f"tile_sizes = {json.dumps(tile_sizes)}", compilation_info, count=1
+    )
+
+
+def generate_candidates(tile_sizes: List[List[int]]) -> List[List[List[int]]]:
+    """Returns tile size variations scaling the distribution and vector
+    parallel levels by powers of two."""
+    if len(tile_sizes) < 2:
+        return []
+    distribution, vector = tile_sizes[0], tile_sizes[1]
+    scales = [0.25, 0.5, 1, 2, 4]
+
+    def scale_level(level, factors):
+        return [
+            max(1, int(size * factor)) if size else 0
+            for size, factor in zip(level, factors)
+        ]
+
+    parallel_dims = [i for i, size in enumerate(distribution) if size]
+    candidates = []
+    seen = {json.dumps(tile_sizes)}
+    for dist_factors in itertools.product(scales, repeat=len(parallel_dims)):
+        for vector_factor in [0.5, 1, 2]:
+            factors = [1.0] * len(distribution)
+            for dim, factor in zip(parallel_dims, dist_factors):
+                factors[dim] = factor
+            new_distribution = scale_level(distribution, factors)
+            new_vector = scale_level(vector, [vector_factor] * len(vector))
+            # Vector tiles must fit within the distribution tiles.
+            if any(d and v > d for d, v in zip(new_distribution, new_vector)):
+                continue
+            candidate = [new_distribution, new_vector] + tile_sizes[2:]
+            key = json.dumps(candidate)
+            if key not in seen:
+                seen.add(key)
+                candidates.append(candidate)
+    return candidates
+
+
+def measure_entry(
+    args, source: pathlib.Path, workdir: pathlib.Path, entry: Dict
+) -> Optional[float]:
+    """Compiles `source` with `entry` as the only database entry and returns
+    the measured time or None if the configuration fails to compile or run."""
+    database_path = workdir / "candidate.json"
+    database_path.write_text(
+        json.dumps({"version": DATABASE_VERSION, "entries": [entry]})
+    )
+    module_path = workdir / "candidate.vmfb"
+    try:
+        compile_module(
+            args,
+            source,
+            module_path,
+            [f"--iree-codegen-llvmcpu-tuning-database={database_path}"],
+        )
+        return benchmark_module(args, module_path, entry["export"])
+    except (RuntimeError, subprocess.CalledProcessError) as e:
+        print(f"    candidate failed: {str(e).splitlines()[0]}", file=sys.stderr)
+        return None
+
+
+def tune_entry(
+    args, source: pathlib.Path, workdir: pathlib.Path, entry: Dict
+) -> Optional[Tuple[Dict, float, float]]:
+    """Returns the best entry found for the dispatch described by `entry`
+    along with its time and the time of the default configuration."""
+    tile_sizes = get_tile_sizes(entry["compilation_info"])
+    if not tile_sizes:
+        return None
+    default_time = measure_entry(args, source, workdir, entry)
+    if default_time is None:
+        return None
+    print(f"  {entry['export']}: default {default_time:.0f}ns", file=sys.stderr)
+
+    best_entry, best_time = entry, default_time
+    candidates = generate_candidates(tile_sizes)[: args.max_candidates]
+    for candidate in candidates:
+        candidate_entry = dict(entry)
+        candidate_entry["compilation_info"] = set_tile_sizes(
+            entry["compilation_info"], candidate
+        )
+        time = measure_entry(args, source, workdir, candidate_entry)
+        if time is not None and time < best_time:
+            print(f"    {candidate}: {time:.0f}ns", file=sys.stderr)
+            best_entry, best_time = candidate_entry, time
+    return best_entry, best_time, default_time
+
+
+def load_database(path: pathlib.Path) -> Dict[Tuple[str, str], Dict]:
+    if not path.exists():
+        return {}
+    database = json.loads(path.read_text())
+    if database.get("version") != DATABASE_VERSION:
+        raise RuntimeError(
+            f"{path} has unsupported version {database.get('version')}; "
+            f"expected {DATABASE_VERSION}"
+        )
+    return {(e["target"], e["key"]): e for e in database.get("entries", [])}
+
+
+def main(args):
+    entries = load_database(args.database)
+    sources = sorted(args.benchmarks_dir.glob("*_benchmark.mlir"))
+    if not sources:
+        raise RuntimeError(f"no *_benchmark.mlir files in {args.benchmarks_dir}")
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        workdir = pathlib.Path(tmpdir)
+        for source in sources:
+            print(f"tuning {source.name}", file=sys.stderr)
+            for entry in query_entries(args, source, workdir):
+                result = tune_entry(args, source, workdir, entry)
+                if not result:
+                    continue
+                best_entry, best_time, default_time = result
+                if default_time / best_time < args.min_speedup:
+                    continue
+                db_key = (best_entry["target"], best_entry["key"])
+                existing = entries.get(db_key)
+                if existing and existing.get("time_ns", float("inf")) <= best_time:
+                    continue
+                best_entry = dict(best_entry)
+                best_entry.pop("export", None)
+                best_entry["time_ns"] = int(best_time)
+                best_entry["default_time_ns"] = int(default_time)
+                entries[db_key] = best_entry
+
+    database = {
+        "version": DATABASE_VERSION,
+        "entries": sorted(entries.values(), key=lambda e: (e["target"], e["key"])),
+    }
+    args.database.write_text(json.dumps(database, indent=2) + "\n")
+
+
+if __name__ == "__main__":
+    main(parse_arguments())
@@ -45,6 +45,7 @@
 #include "iree/compiler/API/MLIRInterop.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/Dialect/VM/Target/init_targets.h"
+#include "iree/compiler/Pipelines/CompileStatistics.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/PluginAPI/PluginManager.h"
 #include "iree/compiler/Tools/init_dialects.h"
@@ -123,6 +124,7 @@ struct GlobalInit {
   BindingOptions *clBindingOptions = nullptr;
   InputDialectOptions *clInputOptions = nullptr;
   PreprocessingOptions *clPreprocessingOptions = nullptr;
+  CompileStatisticsOptions *clCompileStatisticsOptions = nullptr;
   HighLevelOptimizationOptions *clHighLevelOptimizationOptions = nullptr;
   SchedulingOptions *clSchedulingOptions = nullptr;
   IREE::HAL::TargetOptions *clHalTargetOptions = nullptr;
@@ -167,6 +169,7 @@ void GlobalInit::registerCommandLineOptions() {
   clBindingOptions = &BindingOptions::FromFlags::get();
   clInputOptions = &InputDialectOptions::FromFlags::get();
   clPreprocessingOptions = &PreprocessingOptions::FromFlags::get();
+  clCompileStatisticsOptions = &CompileStatisticsOptions::FromFlags::get();
   clHighLevelOptimizationOptions =
       &HighLevelOptimizationOptions::FromFlags::get();
   clSchedulingOptions = &SchedulingOptions::FromFlags::get();
@@ -252,6 +255,7 @@ struct Session {
   BindingOptions bindingOptions;
   InputDialectOptions inputOptions;
   PreprocessingOptions preprocessingOptions;
+  CompileStatisticsOptions compileStatisticsOptions;
   HighLevelOptimizationOptions highLevelOptimizationOptions;
   SchedulingOptions schedulingOptions;
   IREE::HAL::TargetOptions halTargetOptions;
@@ -275,6 +279,7 @@ Session::Session(GlobalInit &globalInit)
     bindingOptions = *globalInit.clBindingOptions;
     inputOptions = *globalInit.clInputOptions;
     preprocessingOptions = *globalInit.clPreprocessingOptions;
+    compileStatisticsOptions = *globalInit.clCompileStatisticsOptions;
     highLevelOptimizationOptions = *globalInit.clHighLevelOptimizationOptions;
     schedulingOptions = *globalInit.clSchedulingOptions;
     halTargetOptions = *globalInit.clHalTargetOptions;
@@ -290,6 +295,7 @@ Session::Session(GlobalInit &globalInit)
   // mnemonically via the API.
   bindingOptions.bindOptions(binder);
   preprocessingOptions.bindOptions(binder);
+  compileStatisticsOptions.bindOptions(binder);
   inputOptions.bindOptions(binder);
   highLevelOptimizationOptions.bindOptions(binder);
   schedulingOptions.bindOptions(binder);
@@ -718,6 +724,18 @@ Operation *Invocation::exportModule() {
 
 bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
   auto passManager = createPassManager();
+
+  // Optionally collect compile statistics for the run. The hooks are copied so
+  // that the statistics markers only apply to this pipeline.
+  IREEVMPipelineHooks hooks = pipelineHooks;
+  std::optional<CompileStatistics> statistics;
+  const auto &statisticsFile = session.compileStatisticsOptions.statisticsFile;
+  if (!statisticsFile.empty()) {
+    statistics.emplace();
+    statistics->installPipelineHooks(hooks);
+    passManager->addInstrumentation(statistics->createInstrumentation());
+  }
+
   switch (pipeline) {
   case IREE_COMPILER_PIPELINE_STD: {
     // Parse the compile to phase name.
@@ -766,7 +784,7 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
         session.targetRegistry, session.bindingOptions, session.inputOptions,
         session.preprocessingOptions, session.highLevelOptimizationOptions,
         session.schedulingOptions, session.halTargetOptions,
-        session.vmTargetOptions, pipelineHooks, *passManager, *compileFromPhase,
+        session.vmTargetOptions, hooks, *passManager, *compileFromPhase,
         *compileToPhase);
     break;
   }
@@ -793,10 +811,13 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
     return false;
   }
 
-  if (failed(passManager->run(parsedModule))) {
+  bool succeeded = !failed(passManager->run(parsedModule));
+  // Statistics are written even on failure as they are most useful for
+  // finding out where a compilation ran out of time or memory.
+  if (statistics && failed(statistics->writeJSON(statisticsFile))) {
     return false;
   }
-  return true;
+  return succeeded;
 }
 
 bool Invocation::runTextualPassPipeline(const char *textPassPipeline) {
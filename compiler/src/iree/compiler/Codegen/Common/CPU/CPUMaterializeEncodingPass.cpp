@@ -71,6 +71,17 @@ chooseMatmulTileParamsAArch64(EncodingUser user, ExecutableTargetAttr target) {
       return {8, 4, 8};
     }
     return {8, 1, 8};
+  case EncodingUser::MATMUL_I8I4I32:
+    // The int4 RHS is packed two values per byte along K, so K0 must be even.
+    if (hasFeature(target, "+i8mm")) {
+      // Aim to use SMMLA after expanding the RHS to int8.
+      return {8, 8, 8};
+    }
+    if (hasFeature(target, "+dotprod")) {
+      // Aim to use SDOT after expanding the RHS to int8.
+      return {8, 4, 8};
+    }
+    return {8, 2, 8};
   default:
     assert(false);
     return {};
@@ -125,6 +136,17 @@ chooseMatmulTileParamsX86_64(EncodingUser user, ExecutableTargetAttr target) {
     }
     // SSE fallback. Aim to use PMADDWD (xmm).
     return {8, 2, 4};
+  case EncodingUser::MATMUL_I8I4I32:
+    // Same as i8i8i32: the int4 RHS is expanded to int16 in registers for
+    // VPDPWSSD / VPMADDWD. K0=2 is also the minimum as int4 values are packed
+    // two per byte along K.
+    if (hasFeature(target, "+avx512vnni")) {
+      return {16, 2, 16};
+    }
+    if (hasFeature(target, "+avx2")) {
+      return {8, 2, 8};
+    }
+    return {8, 2, 4};
   default:
     assert(false);
     return {};
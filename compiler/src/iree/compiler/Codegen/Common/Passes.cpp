@@ -11,12 +11,15 @@
 namespace mlir {
 namespace iree_compiler {
 
-void addCommonTargetExecutablePreprocessingPasses(OpPassManager &passManager) {
+void addCommonTargetExecutablePreprocessingPasses(
+    OpPassManager &passManager,
+    IREE::LinalgExt::DecomposeSoftmaxControlFn decomposeSoftmaxControlFn) {
   passManager.addNestedPass<func::FuncOp>(createTypePropagationPass());
   passManager.addPass(createBubbleUpOrdinalOpsPass());
   passManager.addPass(createBufferizeCopyOnlyDispatchesPass());
   passManager.addNestedPass<func::FuncOp>(
-      IREE::LinalgExt::createDecomposeSoftmaxPass());
+      IREE::LinalgExt::createDecomposeSoftmaxPass(
+          std::move(decomposeSoftmaxControlFn)));
 }
 
 //===---------------------------------------------------------------------===//
@@ -12,6 +12,7 @@
 #ifndef IREE_COMPILER_CODEGEN_COMMON_PASSES_H_
 #define IREE_COMPILER_CODEGEN_COMMON_PASSES_H_
 
+#include "iree-dialects/Dialect/LinalgExt/Passes/Passes.h"
 #include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
 #include "mlir/Dialect/Bufferization/IR/BufferizableOpInterface.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
@@ -21,8 +22,12 @@ namespace mlir {
 namespace iree_compiler {
 
 /// Passes that are done on all backends before target-specific code-generation
-/// kicks in.
-void addCommonTargetExecutablePreprocessingPasses(OpPassManager &passManager);
+/// kicks in. Softmax ops are decomposed unless `decomposeSoftmaxControlFn` is
+/// set and returns false for them.
+void addCommonTargetExecutablePreprocessingPasses(
+    OpPassManager &passManager,
+    IREE::LinalgExt::DecomposeSoftmaxControlFn decomposeSoftmaxControlFn =
+        nullptr);
 
 /// Post-bufferization passes run to cleanup the IR
 /// (ResolveShapedTypeResultDims, Canonicalization/CSE and
@@ -216,12 +221,16 @@ std::unique_ptr<OperationPass<void>> createTestExecutablePreprocessingPass();
 std::unique_ptr<OperationPass<void>>
 createTestPartitionableLoopsInterfacePass();
 
-/// Pass to tile and distribute to workgroups.
+/// Pass to tile and distribute to workgroups. If
+/// `workgroupsPerDeviceConcurrency` is non-zero the workgroup count is clamped
+/// at runtime to that multiple of the device dispatch concurrency; requires
+/// cyclic distribution.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
 createTileAndDistributeToWorkgroupsPass(
     int32_t maxWorkgroupParallelDims = kNumMaxParallelDims,
     linalg::DistributionMethod distributionMethod =
-        linalg::DistributionMethod::Cyclic);
+        linalg::DistributionMethod::Cyclic,
+    int32_t workgroupsPerDeviceConcurrency = 0);
 
 /// Create an IREE-specific Transform dialect interpreter pass with all
 /// registrations necessary for IREE.
@@ -275,6 +275,61 @@ static LogicalResult lowerWorkgroupCount(
       .Default([&](Operation *) { return success(); });
 }
 
+/// Clamps the workgroup count returned from the workgroup count region of
+/// `exportOp` to `workgroupsPerConcurrency` times the dispatch concurrency the
+/// device reports at runtime. This is only valid with cyclic distribution
+/// where each workgroup loops over the tiles it is assigned. Only the first
+/// `numClampableDims` dimensions (in x, y, z order) are clamped; a dimension
+/// with multiple loops folded into it must keep the exact number of tiles.
+static void
+clampWorkgroupCountToDeviceConcurrency(RewriterBase &rewriter,
+                                       IREE::HAL::ExecutableExportOp exportOp,
+                                       int64_t workgroupsPerConcurrency,
+                                       unsigned numClampableDims) {
+  Block *body = exportOp.getWorkgroupCountBody();
+  if (!body || numClampableDims == 0)
+    return;
+  auto returnOp = cast<IREE::HAL::ReturnOp>(body->getTerminator());
+  OpBuilder::InsertionGuard g(rewriter);
+  rewriter.setInsertionPoint(returnOp);
+  Location loc = returnOp.getLoc();
+  MLIRContext *context = rewriter.getContext();
+
+  // The first argument of the region is the device the dispatch runs on. If
+  // the query is not supported fall back to assuming a single worker.
+  Value device = body->getArgument(0);
+  auto i32Type = rewriter.getI32Type();
+  auto queryOp = rewriter.create<IREE::HAL::DeviceQueryOp>(
+      loc, rewriter.getI1Type(), i32Type, device,
+      rewriter.getStringAttr("hal.dispatch"),
+      rewriter.getStringAttr("concurrency"), rewriter.getI32IntegerAttr(1));
+  Value concurrency = rewriter.create<arith::IndexCastOp>(
+      loc, rewriter.getIndexType(), queryOp.getValue());
+
+  AffineExpr s0, s1;
+  bindSymbols(context, s0, s1);
+  AffineExpr one = getAffineConstantExpr(1, context);
+  OpFoldResult budget = affine::makeComposedFoldedAffineMax(
+      rewriter, loc, AffineMap::get(0, 1, {s0 * workgroupsPerConcurrency, one}),
+      {getAsOpFoldResult(concurrency)});
+  SmallVector<Value> counts = llvm::to_vector(returnOp.getOperands());
+  for (unsigned i = 0; i < std::min<unsigned>(numClampableDims, counts.size());
+       ++i) {
+    if (isConstantIntValue(getAsOpFoldResult(counts[i]), 1))
+      continue;
+    OpFoldResult clamped = affine::makeComposedFoldedAffineMin(
+        rewriter, loc, AffineMap::get(0, 2, {s0, s1}, context),
+        {getAsOpFoldResult(counts[i]), budget});
+    counts[i] = getValueOrCreateConstantIndexOp(rewriter, loc, clamped);
+    // Whatever budget is left is spread over the next dimensions.
+    budget = affine::makeComposedFoldedAffineMax(
+        rewriter, loc, AffineMap::get(0, 2, {s0.floorDiv(s1), one}),
+        {budget, clamped});
+  }
+  rewriter.updateRootInPlace(returnOp,
+                             [&]() { returnOp->setOperands(counts); });
+}
+
 //===---------------------------------------------------------------------===//
 // Patterns and methods for tile and distribute of Linalg ops to workgroups.
 //===---------------------------------------------------------------------===//
@@ -286,9 +341,11 @@ struct TileAndDistributeToWorkgroupsPass
           TileAndDistributeToWorkgroupsPass> {
   TileAndDistributeToWorkgroupsPass(
       int32_t maxWorkgroupParallelDims,
-      linalg::DistributionMethod distributionMethod) {
+      linalg::DistributionMethod distributionMethod,
+      int32_t workgroupsPerDeviceConcurrency) {
     this->maxWorkgroupParallelDims = maxWorkgroupParallelDims;
     this->distributionMethod = (int32_t)distributionMethod;
+    this->workgroupsPerDeviceConcurrency = workgroupsPerDeviceConcurrency;
   }
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<affine::AffineDialect, IREE::Flow::FlowDialect,
@@ -400,6 +457,22 @@ void TileAndDistributeToWorkgroupsPass::runOnOperation() {
       }
     }
 
+    // Clamp the workgroup count to the device concurrency before the static
+    // workgroup count is used to fold away the distributed loops below.
+    if (workgroupsPerDeviceConcurrency > 0 &&
+        distributionMethodValue == linalg::DistributionMethod::Cyclic) {
+      unsigned numDistributedLoops = llvm::count_if(
+          partitionableLoops, [&](unsigned loop) {
+            return loop < tileSizes.size() && tileSizes[loop] != 0;
+          });
+      unsigned numClampableDims = maxWorkgroupParallelDims;
+      if (numDistributedLoops > maxWorkgroupParallelDims)
+        numClampableDims = maxWorkgroupParallelDims - 1;
+      clampWorkgroupCountToDeviceConcurrency(rewriter, exportOp,
+                                             workgroupsPerDeviceConcurrency,
+                                             numClampableDims);
+    }
+
     {
       RewritePatternSet patterns(context);
       populateTileAndDistributeToWorkgroupsCleanupPatterns(patterns,
@@ -456,9 +529,11 @@ void TileAndDistributeToWorkgroupsPass::runOnOperation() {
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableVariantOp>>
 createTileAndDistributeToWorkgroupsPass(
     int32_t maxWorkgroupParallelDims,
-    linalg::DistributionMethod distributionMethod) {
+    linalg::DistributionMethod distributionMethod,
+    int32_t workgroupsPerDeviceConcurrency) {
   return std::make_unique<TileAndDistributeToWorkgroupsPass>(
-      maxWorkgroupParallelDims, distributionMethod);
+      maxWorkgroupParallelDims, distributionMethod,
+      workgroupsPerDeviceConcurrency);
 }
 
 } // namespace iree_compiler
@@ -0,0 +1,64 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(hal.executable(hal.executable.variant(iree-codegen-tile-and-distribute-to-workgroups{workgroups-per-device-concurrency=2})), canonicalize, cse)' --split-input-file %s | FileCheck %s
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64, 64, 0], [16, 4, 0], [0, 0, 64]]>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {
+  data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+  native_vector_size = 16 : index,
+  target_triple = "x86_64-none-elf"
+}>
+#translation = #iree_codegen.translation_info<CPUDoubleTilingExpert>
+hal.executable private @static_matmul {
+  hal.executable.variant public @llvm, target = #executable_target_embedded_elf_x86_64_ {
+    hal.executable.export public @static_matmul layout(#pipeline_layout) attributes {translation_info = #translation} {
+    ^bb0(%arg0: !hal.device):
+      %x, %y, %z = flow.dispatch.workgroup_count_from_slice
+      hal.return %x, %y, %z : index, index, index
+    }
+    builtin.module {
+      func.func @static_matmul() {
+        %cst = arith.constant 0.0 : f32
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0)
+            : !flow.dispatch.tensor<readonly:tensor<1024x512xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0)
+            : !flow.dispatch.tensor<readonly:tensor<512x1024xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0)
+            : !flow.dispatch.tensor<writeonly:tensor<1024x1024xf32>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [1024, 512], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:tensor<1024x512xf32>> -> tensor<1024x512xf32>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [512, 1024], strides = [1, 1]
+            : !flow.dispatch.tensor<readonly:tensor<512x1024xf32>> -> tensor<512x1024xf32>
+        %5 = tensor.empty() : tensor<1024x1024xf32>
+        %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+        %7 = linalg.matmul {lowering_config = #config}
+            ins(%3, %4 : tensor<1024x512xf32>, tensor<512x1024xf32>) outs(%6 : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1]
+            : tensor<1024x1024xf32> -> !flow.dispatch.tensor<writeonly:tensor<1024x1024xf32>>
+        return
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[BUDGET:.+]] = affine_map<()[s0] -> (s0 * 2, 1)>
+//      CHECK: hal.executable.export public @static_matmul
+// CHECK-NEXT:   (%[[DEVICE:.+]]: !hal.device)
+//  CHECK-DAG:    %[[C1:.+]] = arith.constant 1 : index
+//      CHECK:    %{{.+}}, %[[CONCURRENCY:.+]] = hal.device.query<%[[DEVICE]] : !hal.device> key("hal.dispatch" :: "concurrency") : i1, i32 = 1 : i32
+//      CHECK:    %[[CONCURRENCY_INDEX:.+]] = arith.index_cast %[[CONCURRENCY]] : i32 to index
+//      CHECK:    %[[MAX_WORKGROUPS:.+]] = affine.max #[[BUDGET]]()[%[[CONCURRENCY_INDEX]]]
+//      CHECK:    %[[X:.+]] = affine.min #{{.+}}()[%[[MAX_WORKGROUPS]]]
+//      CHECK:    %[[Y:.+]] = affine.min
+//      CHECK:    hal.return %[[X]], %[[Y]], %[[C1]] : index, index, index
+//      CHECK: func.func @static_matmul()
+//  CHECK-DAG:   %[[WG_COUNT_X:.+]] = hal.interface.workgroup.count[0]
+//  CHECK-DAG:   %[[WG_COUNT_Y:.+]] = hal.interface.workgroup.count[1]
+//      CHECK:   scf.for
+//      CHECK:     scf.for
+//      CHECK:       linalg.matmul
@@ -11,6 +11,7 @@
 #include "iree-dialects/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "iree/compiler/Codegen/Common/UserConfig.h"
 #include "iree/compiler/Codegen/LLVMCPU/TargetMLTransformInfo.h"
+#include "iree/compiler/Codegen/LLVMCPU/TuningDatabase.h"
 #include "iree/compiler/Codegen/LLVMCPU/Utils.h"
 #include "iree/compiler/Codegen/TransformStrategies/CPU/Common.h"
 #include "iree/compiler/Codegen/Transforms/Transforms.h"
@@ -75,6 +76,12 @@ static llvm::cl::opt<int>
                         llvm::cl::desc("default distribution tile size"),
                         llvm::cl::init(64));
 
+static llvm::cl::opt<int> clAttentionTileCacheBytes(
+    "iree-codegen-llvm-attention-tile-cache-bytes",
+    llvm::cl::desc("target size in bytes of the working set of one query "
+                   "tile of the tiled iree_linalg_ext.attention decomposition"),
+    llvm::cl::init(32 * 1024));
+
 // TODO(hanchung): Remove the flag. This is the flag for fastly falling back to
 // the previous snapshot.
 
@@ -89,6 +96,13 @@ static llvm::cl::opt<bool>
                         llvm::cl::init(true));
 
 // Non-static options are used in other places.
+llvm::cl::opt<int> clWorkgroupsPerDeviceConcurrency(
+    "iree-codegen-llvm-workgroups-per-device-concurrency",
+    llvm::cl::desc(
+        "If non-zero, the number of workgroups is clamped at runtime to this "
+        "multiple of the dispatch concurrency of the executing device instead "
+        "of assuming `iree-codegen-llvm-number-of-threads` at compile time"),
+    llvm::cl::init(0));
 llvm::cl::opt<std::string> clCPUCodegenTransformDialectFileName(
     "iree-codegen-llvmcpu-use-transform-dialect",
     llvm::cl::desc(
@@ -440,6 +454,13 @@ getDefaultDistributionTileSizes(ArrayRef<int64_t> lbs, ArrayRef<int64_t> ubs,
         llvm::divideCeil(workload[i], distributedTileSizes[i]);
   }
 
+  // When the workgroup count is clamped to the device concurrency at runtime
+  // the tiles are processed cyclically by the available workgroups so there is
+  // no need to guess the number of threads here.
+  if (clWorkgroupsPerDeviceConcurrency > 0) {
+    return distributedTileSizes;
+  }
+
   // Reduce the number of workgroups in cases where we are dividing the work too
   // much. Over-provision the number of workgroups to twice the number of
   // threads.
@@ -1264,6 +1285,53 @@ setRootConfig(func::FuncOp entryPointFn, IREE::LinalgExt::FftOp fftOp,
                                                pipeline);
 }
 
+/// Sets the lowering configuration for dispatch region for
+/// iree_linalg_ext.attention root op. Each workgroup computes one query tile
+/// of one batch, and the tiled decomposition then iterates over key/value
+/// tiles of the same length with an online softmax. The tile length is the
+/// largest divisor of both sequence lengths that keeps the query, key and
+/// value tiles, the f32 score tile and the f32 accumulator within
+/// `clAttentionTileCacheBytes`.
+static LogicalResult setRootConfig(func::FuncOp entryPointFn,
+                                   IREE::LinalgExt::AttentionOp attnOp) {
+  assert(!getLoweringConfig(attnOp) && "expected lowering_config is not set");
+  ArrayRef<int64_t> queryShape = attnOp.getQueryType().getShape();
+  ArrayRef<int64_t> keyShape = attnOp.getKeyType().getShape();
+  Type elementType = attnOp.getQueryType().getElementType();
+
+  // The decomposition steps through the keys with the query tile length, so
+  // the query sequence is only tiled when it is known to divide the key
+  // sequence. Otherwise each workgroup processes a whole batch. The same
+  // applies when the sequence lengths only have small common divisors, as
+  // such tiles are too short to amortize the per-tile softmax rescaling.
+  constexpr int64_t kMinimumTileSize = 8;
+  int64_t tileSize = 0;
+  if (!ShapedType::isDynamicShape(queryShape) &&
+      !ShapedType::isDynamicShape(keyShape)) {
+    int64_t headDim = queryShape[2];
+    int64_t elementBytes =
+        std::max<int64_t>(1, elementType.getIntOrFloatBitWidth() / 8);
+    auto getWorkingSetBytes = [&](int64_t t) {
+      return 3 * t * headDim * elementBytes + t * t * 4 + t * headDim * 4;
+    };
+    int64_t commonLength = std::gcd(queryShape[1], keyShape[1]);
+    int64_t cacheBytes = clAttentionTileCacheBytes;
+    int64_t candidate = std::min<int64_t>(commonLength, defaultDistTileSize);
+    for (; candidate >= kMinimumTileSize; --candidate) {
+      if (commonLength % candidate == 0 &&
+          getWorkingSetBytes(candidate) <= cacheBytes) {
+        tileSize = candidate;
+        break;
+      }
+    }
+  }
+
+  TileSizesListType tileSizes = {{1, tileSize}};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, attnOp, tileSizes,
+      DispatchLoweringPassPipeline::CPULinalgExtTileAndVectorize);
+}
+
 static void setX86VectorTileSizes(linalg::GenericOp genericOp,
                                   unsigned numLoops,
                                   ArrayRef<int64_t> distTileSizes,
@@ -1892,8 +1960,8 @@ setRootConfigImpl(func::FuncOp entryPointFn, Operation *op,
           return setRootConfig(entryPointFn, op, LinalgOpInfo(op),
                                targetMLTransInfo);
         })
-        .Case<IREE::LinalgExt::FftOp, tensor::PackOp, tensor::PadOp,
-              linalg::Mmt4DOp>(
+        .Case<IREE::LinalgExt::AttentionOp, IREE::LinalgExt::FftOp,
+              tensor::PackOp, tensor::PadOp, linalg::Mmt4DOp>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<linalg::Conv2DNhwcHwcfOp, linalg::Conv2DNchwFchwOp,
               linalg::PoolingNhwcSumOp, linalg::PoolingNhwcMaxOp,
@@ -2215,8 +2283,24 @@ setTranslationInfoAndRootConfig(func::FuncOp entryPointFn,
     return lowerUsingDefaultPipeline(entryPointFn);
   }
 
+  // Prefer configurations found by offline tuning of the same op signature on
+  // the same target over the heuristics below.
   auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
-  if (isVMVXBackend(targetAttr)) {
+  IREE::Codegen::CompilationInfoAttr tunedInfo;
+  if (!isVMVXBackend(targetAttr)) {
+    FailureOr<IREE::Codegen::CompilationInfoAttr> tunedInfoOr =
+        lookupCPUTuningDatabase(entryPointFn, rootOperation);
+    if (failed(tunedInfoOr)) {
+      return failure();
+    }
+    tunedInfo = *tunedInfoOr;
+  }
+
+  if (tunedInfo) {
+    if (failed(setUserConfig(entryPointFn, rootOperation, tunedInfo))) {
+      return failure();
+    }
+  } else if (isVMVXBackend(targetAttr)) {
     if (failed(setVMVXRootConfigImpl(entryPointFn, rootOperation))) {
       return failure();
     }
@@ -2245,6 +2329,9 @@ setTranslationInfoAndRootConfig(func::FuncOp entryPointFn,
     setLoweringConfigForComputeOps(entryPointFn, computeOps, rootOperation);
   }
 
+  if (!isVMVXBackend(targetAttr)) {
+    printCPUTuningEntry(entryPointFn, rootOperation);
+  }
   return success();
 }
 
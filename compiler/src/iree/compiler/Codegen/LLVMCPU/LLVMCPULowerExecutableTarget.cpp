@@ -242,7 +242,8 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
         switch (translationInfo.value().getDispatchLoweringPassPipeline()) {
         case IREE::Codegen::DispatchLoweringPassPipeline::CPUDefault:
         case IREE::Codegen::DispatchLoweringPassPipeline::None:
-          addCPUDefaultPassPipeline(executableLoweringPipeline);
+          addCPUDefaultPassPipeline(executableLoweringPipeline,
+                                    enableMicrokernels);
           break;
         case IREE::Codegen::DispatchLoweringPassPipeline::
             CPUBufferOpsTileAndVectorize: {
@@ -296,6 +297,11 @@ void LLVMCPULowerExecutableTargetPass::runOnOperation() {
                                    enableVectorMasking);
           break;
         }
+        case IREE::Codegen::DispatchLoweringPassPipeline::
+            CPULinalgExtTileAndVectorize:
+          addCPULinalgExtTileAndVectorizePipeline(executableLoweringPipeline,
+                                                  enableVectorMasking);
+          break;
         case IREE::Codegen::DispatchLoweringPassPipeline::VMVXDefault:
           addVMVXDefaultPassPipeline(executableLoweringPipeline,
                                      enableMicrokernels);
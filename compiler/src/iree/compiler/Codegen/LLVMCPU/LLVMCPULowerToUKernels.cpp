@@ -121,6 +121,10 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
   if (lhsElemType.isSignlessInteger(8) && rhsElemType.isSignlessInteger(8) &&
       outElemType.isSignlessInteger(32)) {
     flags = IREE_UK_FLAG_MMT4D_TYPE_I8I8I32;
+  } else if (lhsElemType.isSignlessInteger(8) &&
+             rhsElemType.isSignlessInteger(4) &&
+             outElemType.isSignlessInteger(32)) {
+    flags = IREE_UK_FLAG_MMT4D_TYPE_I8I4I32;
   } else if (lhsElemType.isF32() && rhsElemType.isF32() &&
              outElemType.isF32()) {
     flags = IREE_UK_FLAG_MMT4D_TYPE_F32F32F32;
@@ -383,6 +387,51 @@ matchDAGForUKernel(RewriterBase &rewriter, tensor::UnPackOp op,
       genericMicroKernelOp.getOperation());
 }
 
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, IREE::LinalgExt::SoftmaxOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  Value in = op.input();
+  Value out = op.output();
+  auto inType = llvm::cast<ShapedType>(in.getType());
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Type inElemType = inType.getElementType();
+  Type outElemType = outType.getElementType();
+  uint32_t flags = 0;
+  if (inElemType.isF32() && outElemType.isF32()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_F32F32;
+  } else if (inElemType.isF16() && outElemType.isF16()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_F16F16;
+  } else if (inElemType.isBF16() && outElemType.isBF16()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_BF16BF16;
+  } else {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+
+  if (inType.getRank() != 2 || outType.getRank() != 2) {
+    return rewriter.notifyMatchFailure(op, "expected 2D input and output");
+  }
+
+  if (op.getDimension() != 1) {
+    return rewriter.notifyMatchFailure(op,
+                                       "expected reduction over inner dim");
+  }
+
+  Location loc = op.getLoc();
+  Value size0 = rewriter.create<tensor::DimOp>(loc, in, 0);
+  Value size1 = rewriter.create<tensor::DimOp>(loc, in, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  auto fn = getFnNameAndDefAttrs("softmax", rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, outType, fn.name, in, out, ValueRange{size0, size1, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 static uint32_t flagForUser(IREE::LinalgExt::EncodingUser user) {
   switch (user) {
   case IREE::LinalgExt::EncodingUser::MATMUL_F32F32F32:
@@ -397,6 +446,8 @@ static uint32_t flagForUser(IREE::LinalgExt::EncodingUser user) {
     return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32;
   case IREE::LinalgExt::EncodingUser::MATMUL_BF16BF16BF16:
     return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16;
+  case IREE::LinalgExt::EncodingUser::MATMUL_I8I4I32:
+    return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32;
   default: // Unreachable.
     assert(false);
     return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_NONE;
@@ -506,6 +557,12 @@ void LLVMCPULowerToUKernelsPass::runOnOperation() {
   auto allTargets = [](auto target) { return true; };
   patterns.insert<LowerToUKernelPattern<linalg::Mmt4DOp>>(
       context, allTargets, skipIntermediateRoundings);
+  // Softmax ops only survive to this point on LLVMCPU when they were kept out
+  // of decomposition for this lowering (see shouldDecomposeSoftmax), so no
+  // fusion opportunity is lost here. There is no VMVX import for softmax.
+  auto notVMVX = [](auto target) { return !isVMVXBackend(target); };
+  patterns.insert<LowerToUKernelPattern<IREE::LinalgExt::SoftmaxOp>>(
+      context, notVMVX);
   // These patterns could in principle be used on LLVMCPU, not just VMVX, but
   // we choose not to, for two reasons:
   // 1. Codegen for these ops is thought to be good enough, that we do not
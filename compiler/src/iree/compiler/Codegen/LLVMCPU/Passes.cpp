@@ -89,6 +89,9 @@ static llvm::cl::opt<bool> clInstrumentMemoryAccesses{
 extern llvm::cl::opt<std::string> clCPUCodegenTransformDialectFileName;
 extern llvm::cl::opt<std::string> clCPUCodegenTransformDialectDebugPayloadTag;
 extern llvm::cl::opt<std::string> clCPUCodegenTransformDialectDebugTransformTag;
+// Defined externally in KernelDispatch.cpp as it also affects the choice of
+// distribution tile sizes.
+extern llvm::cl::opt<int> clWorkgroupsPerDeviceConcurrency;
 
 //===---------------------------------------------------------------------===//
 // Default allocation functions for CPU backend
@@ -134,7 +137,9 @@ static void addBufferizePasses(OpPassManager &passManager) {
 }
 
 static void addTileAndDistributePasses(OpPassManager &pm) {
-  pm.addPass(createTileAndDistributeToWorkgroupsPass());
+  pm.addPass(createTileAndDistributeToWorkgroupsPass(
+      kNumMaxParallelDims, linalg::DistributionMethod::Cyclic,
+      clWorkgroupsPerDeviceConcurrency));
   auto &nestedModulePM = pm.nest<ModuleOp>();
   nestedModulePM.addNestedPass<func::FuncOp>(
       createConvertToDestinationPassingStylePass());
@@ -663,10 +668,47 @@ void addCPUDataTilingPipeline(OpPassManager &passManager,
   }
 }
 
-void addCPUDefaultPassPipeline(OpPassManager &passManager) {
+void addCPUDefaultPassPipeline(OpPassManager &passManager,
+                               bool enableMicrokernels) {
   addTileAndDistributePasses(passManager);
   OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
+  if (enableMicrokernels) {
+    nestedModulePM.addPass(
+        createLLVMCPULowerToUKernelsPass(clSkipIntermediateRoundings));
+  }
+  addBufferizePasses(nestedModulePM);
+}
+
+void addCPULinalgExtTileAndVectorizePipeline(OpPassManager &passManager,
+                                             bool enableVectorMasking) {
+  // Distribution also tiles and decomposes LinalgExt ops (e.g. attention) into
+  // loops of static-shaped linalg ops on tiles.
+  addTileAndDistributePasses(passManager);
+
+  OpPassManager &nestedModulePM = passManager.nest<ModuleOp>();
+  {
+    GenericVectorizationPassOptions options;
+    options.enableVectorMasking = enableVectorMasking;
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        createGenericVectorizationPass(options));
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        createHoistRedundantVectorTransfersPass());
+    nestedModulePM.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+    nestedModulePM.addNestedPass<func::FuncOp>(createCSEPass());
+  }
+
   addBufferizePasses(nestedModulePM);
+
+  // Run IREE specific passes before vector lowering expert.
+  nestedModulePM.addNestedPass<func::FuncOp>(
+      createRemoveSingleIterationLoopPass());
+
+  {
+    LLVMCPUVectorLoweringPassOptions options;
+    options.splitVectorTransfersTo = "linalg-copy";
+    nestedModulePM.addNestedPass<func::FuncOp>(
+        createLLVMCPUVectorLoweringPass(options));
+  }
 }
 
 void addTransformDialectPasses(OpPassManager &passManager) {
@@ -760,10 +802,26 @@ static void addLowerToLLVMPasses(OpPassManager &passManager) {
   passManager.addNestedPass<LLVM::LLVMFuncOp>(createAddFastMathFlagsPass());
 }
 
+/// Returns true if `softmaxOp` should be decomposed into linalg ops. Softmax
+/// ops that can be lowered to the softmax microkernel are kept as-is when
+/// microkernels are enabled.
+static bool shouldDecomposeSoftmax(IREE::LinalgExt::SoftmaxOp softmaxOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(softmaxOp);
+  if (!hasMicrokernels(targetAttr) || isVMVXBackend(targetAttr))
+    return true;
+  ShapedType inputType = softmaxOp.getInputOperandType();
+  if (inputType.getRank() != 2 || softmaxOp.getDimension() != 1)
+    return true;
+  Type elementType = inputType.getElementType();
+  return !(elementType.isF32() || elementType.isF16() ||
+           elementType.isBF16());
+}
+
 void buildLLVMCPUCodegenPassPipeline(OpPassManager &passManager) {
   {
     OpPassManager &modulePassManager = passManager.nest<ModuleOp>();
-    addCommonTargetExecutablePreprocessingPasses(modulePassManager);
+    addCommonTargetExecutablePreprocessingPasses(modulePassManager,
+                                                 shouldDecomposeSoftmax);
     modulePassManager.addNestedPass<func::FuncOp>(
         createRematerializeParallelOpsPass());
     // TODO(#13888): This(createExpandF16OpToF32Pass()) pass is being added way
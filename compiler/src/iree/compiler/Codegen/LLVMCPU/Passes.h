@@ -127,8 +127,16 @@ void addCPUDataTilingPipeline(OpPassManager &passManager,
 
 /// Populates the passes to lower to scalars operations for linalg based
 /// code-generation. This pipeline does not vectorize, but instead just
-/// converts to memrefs
-void addCPUDefaultPassPipeline(OpPassManager &passManager);
+/// converts to memrefs. When `enableMicrokernels` is set, ops with a matching
+/// microkernel (e.g. softmax) are lowered to it after distribution.
+void addCPUDefaultPassPipeline(OpPassManager &passManager,
+                               bool enableMicrokernels);
+
+/// Populates the passes to lower LinalgExt ops that are tiled and decomposed
+/// during distribution (e.g. iree_linalg_ext.attention), vectorizing the
+/// resulting per-tile linalg ops.
+void addCPULinalgExtTileAndVectorizePipeline(OpPassManager &passManager,
+                                             bool enableVectorMasking);
 
 void addConvTileAndDecomposeExpertPassPipeline(OpPassManager &passManager,
                                                TilingConfig &tilingConfig,
@@ -0,0 +1,248 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/LLVMCPU/TuningDatabase.h"
+
+#include <memory>
+
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/xxhash.h"
+#include "mlir/AsmParser/AsmParser.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+
+#define DEBUG_TYPE "iree-llvmcpu-tuning-database"
+
+namespace mlir {
+namespace iree_compiler {
+
+static llvm::cl::opt<std::string> clTuningDatabasePath(
+    "iree-codegen-llvmcpu-tuning-database",
+    llvm::cl::desc("JSON tuning database containing per-target lowering "
+                   "configurations that override the default heuristics for "
+                   "matching dispatches; the file is read once and cached "
+                   "for the lifetime of the process"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<bool> clPrintTuningEntries(
+    "iree-codegen-llvmcpu-print-tuning-entries",
+    llvm::cl::desc("print the tuning database entry for the configuration "
+                   "selected for each dispatch to stderr"),
+    llvm::cl::init(false));
+
+namespace {
+
+/// Parsed tuning database. The configurations are stored as strings and only
+/// parsed when they are used as the database may be shared by compilations
+/// in multiple contexts.
+struct TuningDatabase {
+  /// Compilation info attribute strings keyed by `<target>\n<key>`.
+  llvm::StringMap<std::string> entries;
+};
+
+} // namespace
+
+static std::string getEntryMapKey(StringRef target, StringRef key) {
+  return (target + "\n" + key).str();
+}
+
+static FailureOr<std::unique_ptr<TuningDatabase>>
+parseTuningDatabase(Location loc, StringRef path) {
+  auto fileOr = llvm::MemoryBuffer::getFile(path);
+  if (!fileOr) {
+    return emitError(loc) << "failed to open tuning database '" << path
+                          << "': " << fileOr.getError().message();
+  }
+  auto json = llvm::json::parse(fileOr.get()->getBuffer());
+  if (!json) {
+    return emitError(loc) << "failed to parse tuning database '" << path
+                          << "': " << llvm::toString(json.takeError());
+  }
+
+  llvm::json::Object *root = json->getAsObject();
+  if (!root) {
+    return emitError(loc) << "tuning database '" << path
+                          << "' must be a JSON object";
+  }
+  std::optional<int64_t> version = root->getInteger("version");
+  if (!version || *version != kCPUTuningDatabaseVersion) {
+    return emitError(loc) << "tuning database '" << path
+                          << "' has unsupported version (expected "
+                          << kCPUTuningDatabaseVersion
+                          << "); it must be regenerated";
+  }
+
+  auto database = std::make_unique<TuningDatabase>();
+  llvm::json::Array *entries = root->getArray("entries");
+  if (!entries)
+    return database;
+  for (auto [index, value] : llvm::enumerate(*entries)) {
+    llvm::json::Object *entry = value.getAsObject();
+    std::optional<StringRef> target =
+        entry ? entry->getString("target") : std::nullopt;
+    std::optional<StringRef> key =
+        entry ? entry->getString("key") : std::nullopt;
+    std::optional<StringRef> info =
+        entry ? entry->getString("compilation_info") : std::nullopt;
+    if (!target || !key || !info) {
+      return emitError(loc)
+             << "tuning database '" << path << "' entry " << index
+             << " must have string `target`, `key`, and `compilation_info` "
+                "fields";
+    }
+    // Later entries take precedence such that tools can append to databases.
+    database->entries[getEntryMapKey(*target, *key)] = info->str();
+  }
+  return database;
+}
+
+/// Returns the database at `path`, loading it on first use. Databases are
+/// cached for the lifetime of the process and shared by all contexts such that
+/// compiling many executables parses the file once; changes to the file after
+/// it has been loaded are not observed.
+static FailureOr<const TuningDatabase *> getTuningDatabase(Location loc,
+                                                           StringRef path) {
+  static llvm::sys::SmartMutex<true> mutex;
+  static llvm::StringMap<std::unique_ptr<TuningDatabase>> databases;
+  llvm::sys::SmartScopedLock<true> lock(mutex);
+  auto it = databases.find(path);
+  if (it != databases.end())
+    return it->second.get();
+  auto database = parseTuningDatabase(loc, path);
+  if (failed(database))
+    return failure();
+  const TuningDatabase *result = database->get();
+  databases[path] = std::move(*database);
+  return result;
+}
+
+std::string getCPUTuningTarget(func::FuncOp entryPointFn) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(entryPointFn);
+  std::string arch = "unknown";
+  if (std::optional<llvm::Triple> triple = getTargetTriple(targetAttr)) {
+    arch = triple->getArchName().str();
+  }
+  std::string cpu = "generic";
+  if (std::optional<StringAttr> cpuAttr =
+          getConfigStringAttr(targetAttr, "cpu")) {
+    if (!cpuAttr->getValue().empty())
+      cpu = cpuAttr->getValue().str();
+  }
+  std::string target = arch + ":" + cpu;
+  // The same CPU name (notably `generic`) may be paired with different feature
+  // sets that call for different configurations. Features are hashed to keep
+  // the keys short.
+  if (std::optional<StringAttr> featuresAttr =
+          getConfigStringAttr(targetAttr, "cpu_features")) {
+    StringRef features = featuresAttr->getValue();
+    if (!features.empty()) {
+      llvm::raw_string_ostream os(target);
+      os << ":" << llvm::format_hex_no_prefix(llvm::xxHash64(features), 16);
+    }
+  }
+  return target;
+}
+
+std::string getCPUTuningKey(Operation *rootOp) {
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << rootOp->getName().getStringRef() << "(";
+  llvm::interleaveComma(rootOp->getOperandTypes(), os);
+  os << ")->(";
+  llvm::interleaveComma(rootOp->getResultTypes(), os);
+  os << ")";
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
+    os << " iterators[";
+    llvm::interleaveComma(linalgOp.getIteratorTypesArray(), os,
+                          [&](utils::IteratorType iteratorType) {
+                            os << utils::stringifyIteratorType(iteratorType);
+                          });
+    os << "] maps[";
+    llvm::interleaveComma(linalgOp.getIndexingMapsArray(), os);
+    os << "]";
+    if (isa<linalg::GenericOp>(rootOp)) {
+      os << " body[";
+      llvm::interleaveComma(
+          linalgOp.getBlock()->without_terminator(), os,
+          [&](Operation &op) { os << op.getName().getStringRef(); });
+      os << "]";
+    }
+  }
+  return os.str();
+}
+
+FailureOr<IREE::Codegen::CompilationInfoAttr>
+lookupCPUTuningDatabase(func::FuncOp entryPointFn, Operation *rootOp) {
+  if (clTuningDatabasePath.empty())
+    return IREE::Codegen::CompilationInfoAttr();
+
+  FailureOr<const TuningDatabase *> database =
+      getTuningDatabase(entryPointFn.getLoc(), clTuningDatabasePath);
+  if (failed(database))
+    return failure();
+
+  std::string target = getCPUTuningTarget(entryPointFn);
+  std::string key = getCPUTuningKey(rootOp);
+  auto it = (*database)->entries.find(getEntryMapKey(target, key));
+  if (it == (*database)->entries.end()) {
+    LLVM_DEBUG(llvm::dbgs() << "no tuning entry for " << target << " " << key
+                            << "\n");
+    return IREE::Codegen::CompilationInfoAttr();
+  }
+
+  Attribute attr = parseAttribute(it->second, entryPointFn.getContext());
+  auto compilationInfo =
+      llvm::dyn_cast_if_present<IREE::Codegen::CompilationInfoAttr>(attr);
+  if (!compilationInfo) {
+    return rootOp->emitOpError()
+           << "tuning database entry is not a valid compilation_info: "
+           << it->second;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "using tuning entry for " << target << " " << key
+                          << ": " << compilationInfo << "\n");
+  return compilationInfo;
+}
+
+void printCPUTuningEntry(func::FuncOp entryPointFn, Operation *rootOp) {
+  if (!clPrintTuningEntries)
+    return;
+  IREE::Codegen::LoweringConfigAttr loweringConfig = getLoweringConfig(rootOp);
+  IREE::Codegen::TranslationInfoAttr translationInfo =
+      getTranslationInfo(entryPointFn);
+  FailureOr<IREE::HAL::ExecutableExportOp> exportOp =
+      getEntryPoint(entryPointFn);
+  if (!loweringConfig || !translationInfo || failed(exportOp))
+    return;
+
+  auto compilationInfo = IREE::Codegen::CompilationInfoAttr::get(
+      entryPointFn.getContext(), loweringConfig, translationInfo,
+      getWorkgroupSize(*exportOp), /*subgroupSize=*/std::nullopt);
+  std::string compilationInfoStr;
+  llvm::raw_string_ostream(compilationInfoStr) << compilationInfo;
+
+  llvm::json::Object entry{
+      {"target", getCPUTuningTarget(entryPointFn)},
+      {"key", getCPUTuningKey(rootOp)},
+      {"compilation_info", compilationInfoStr},
+      {"export", entryPointFn.getName()},
+  };
+
+  // Compilation of executables happens in parallel; keep lines intact.
+  static llvm::sys::SmartMutex<true> mutex;
+  llvm::sys::SmartScopedLock<true> lock(mutex);
+  llvm::errs() << "iree-llvmcpu-tuning-entry: "
+               << llvm::json::Value(std::move(entry)) << "\n";
+}
+
+} // namespace iree_compiler
+} // namespace mlir
@@ -0,0 +1,66 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
+#define IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
+
+#include <string>
+
+#include "iree/compiler/Codegen/Dialect/IREECodegenAttrs.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+/// Version of the tuning database format. Databases with a different version
+/// are rejected as the op signatures they were keyed on may no longer match.
+constexpr int64_t kCPUTuningDatabaseVersion = 1;
+
+/// Returns the target identifier used to key tuning database entries for the
+/// executable target of `entryPointFn`, e.g. `x86_64:znver3`. Targets with
+/// `cpu_features` append a hash of them (`x86_64:generic:0123456789abcdef`)
+/// such that configurations tuned for one feature set are not applied to
+/// another.
+std::string getCPUTuningTarget(func::FuncOp entryPointFn);
+
+/// Returns the op signature used to key tuning database entries for `rootOp`.
+/// The signature captures the op name, operand and result types, and for
+/// Linalg ops the indexing maps, iterator types, and payload ops such that
+/// dispatches with the same signature are expected to have the same best
+/// configuration.
+std::string getCPUTuningKey(Operation *rootOp);
+
+/// Looks up a tuned configuration for `rootOp` in the database specified by
+/// `--iree-codegen-llvmcpu-tuning-database=`. Returns a null attribute if no
+/// database is specified or it has no entry for `rootOp` on the target of
+/// `entryPointFn`, and failure if the database could not be loaded. The
+/// database is loaded on first use and cached for the lifetime of the process.
+///
+/// The database is a JSON file of the form:
+///   {
+///     "version": 1,
+///     "entries": [
+///       {
+///         "target": "x86_64:znver3",
+///         "key": "<getCPUTuningKey result>",
+///         "compilation_info": "#iree_codegen.compilation_info<...>"
+///       }
+///     ]
+///   }
+/// Additional fields (such as measured times) are ignored.
+FailureOr<IREE::Codegen::CompilationInfoAttr>
+lookupCPUTuningDatabase(func::FuncOp entryPointFn, Operation *rootOp);
+
+/// Prints the tuning database entry describing the configuration selected for
+/// `rootOp` if `--iree-codegen-llvmcpu-print-tuning-entries` is set. This is
+/// used by tuning tools to discover dispatch signatures and their baseline
+/// configurations.
+void printCPUTuningEntry(func::FuncOp entryPointFn, Operation *rootOp);
+
+} // namespace iree_compiler
+} // namespace mlir
+
+#endif // IREE_COMPILER_CODEGEN_LLVMCPU_TUNINGDATABASE_H_
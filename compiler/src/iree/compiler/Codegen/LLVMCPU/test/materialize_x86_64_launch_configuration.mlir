@@ -517,6 +517,141 @@ hal.executable private @static_1d_fft_stage2  {
 
 // -----
 
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+hal.executable private @attention {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm-cpu", "system-elf-x86_64", {
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    target_triple = "x86_64-unknown-linux-gnu",
+    native_vector_size = 16 : index
+  }> {
+    hal.executable.export @attention layout(#pipeline_layout)
+    builtin.module {
+      func.func @attention() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x128x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x256x64xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x256x64xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<12x128x64xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [12, 128, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x128x64xf32>> -> tensor<12x128x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [12, 256, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x256x64xf32>> -> tensor<12x256x64xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [12, 256, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x256x64xf32>> -> tensor<12x256x64xf32>
+        %7 = tensor.empty() : tensor<12x128x64xf32>
+        %8 = iree_linalg_ext.attention ins(%4, %5, %6 : tensor<12x128x64xf32>, tensor<12x256x64xf32>, tensor<12x256x64xf32>) outs(%7 : tensor<12x128x64xf32>) -> tensor<12x128x64xf32>
+        flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [12, 128, 64], strides = [1, 1, 1] : tensor<12x128x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<12x128x64xf32>>
+        return
+      }
+    }
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 16]{{\]}}>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPULinalgExtTileAndVectorize>
+//       CHECK: hal.executable.export public @attention
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: func.func @attention()
+//       CHECK:   iree_linalg_ext.attention
+//  CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+// Sequence lengths without large power of two factors still get tiled by a
+// larger common divisor.
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+hal.executable private @attention_odd_length {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm-cpu", "system-elf-x86_64", {
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    target_triple = "x86_64-unknown-linux-gnu",
+    native_vector_size = 16 : index
+  }> {
+    hal.executable.export @attention_odd_length layout(#pipeline_layout)
+    builtin.module {
+      func.func @attention_odd_length() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x100x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x200x64xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x200x64xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<12x100x64xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [12, 100, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x100x64xf32>> -> tensor<12x100x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [12, 200, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x200x64xf32>> -> tensor<12x200x64xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [12, 200, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x200x64xf32>> -> tensor<12x200x64xf32>
+        %7 = tensor.empty() : tensor<12x100x64xf32>
+        %8 = iree_linalg_ext.attention ins(%4, %5, %6 : tensor<12x100x64xf32>, tensor<12x200x64xf32>, tensor<12x200x64xf32>) outs(%7 : tensor<12x100x64xf32>) -> tensor<12x100x64xf32>
+        flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [12, 100, 64], strides = [1, 1, 1] : tensor<12x100x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<12x100x64xf32>>
+        return
+      }
+    }
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 25]{{\]}}>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPULinalgExtTileAndVectorize>
+//       CHECK: hal.executable.export public @attention_odd_length
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: func.func @attention_odd_length()
+//       CHECK:   iree_linalg_ext.attention
+//  CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+// Sequence lengths that only have small common divisors are not tiled.
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>,
+    #hal.descriptor_set.binding<3, storage_buffer>
+  ]>
+]>
+hal.executable private @attention_prime_length {
+  hal.executable.variant @system_elf_x86_64, target = <"llvm-cpu", "system-elf-x86_64", {
+    data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128",
+    target_triple = "x86_64-unknown-linux-gnu",
+    native_vector_size = 16 : index
+  }> {
+    hal.executable.export @attention_prime_length layout(#pipeline_layout)
+    builtin.module {
+      func.func @attention_prime_length() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x67x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x134x64xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<12x134x64xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<12x67x64xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [12, 67, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x67x64xf32>> -> tensor<12x67x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [12, 134, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x134x64xf32>> -> tensor<12x134x64xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [12, 134, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<12x134x64xf32>> -> tensor<12x134x64xf32>
+        %7 = tensor.empty() : tensor<12x67x64xf32>
+        %8 = iree_linalg_ext.attention ins(%4, %5, %6 : tensor<12x67x64xf32>, tensor<12x134x64xf32>, tensor<12x134x64xf32>) outs(%7 : tensor<12x67x64xf32>) -> tensor<12x67x64xf32>
+        flow.dispatch.tensor.store %8, %3, offsets = [0, 0, 0], sizes = [12, 67, 64], strides = [1, 1, 1] : tensor<12x67x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<12x67x64xf32>>
+        return
+      }
+    }
+  }
+}
+
+//   CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 0]{{\]}}>
+//   CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<CPULinalgExtTileAndVectorize>
+//       CHECK: hal.executable.export public @attention_prime_length
+//  CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//       CHECK: func.func @attention_prime_length()
+//       CHECK:   iree_linalg_ext.attention
+//  CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
 #pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
   #hal.descriptor_set.layout<0, bindings = [
     #hal.descriptor_set.binding<0, storage_buffer>,
@@ -9,6 +9,7 @@
 #include "iree/compiler/ConstEval/Runtime.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Timer.h"
@@ -206,6 +207,59 @@ public:
     return success();
   }
 
+  // Builds a single exported function that calls each imported JIT function
+  // in initialization order so that all of them can be evaluated with one
+  // invocation. Globals stored by one function and loaded by a later one are
+  // forwarded as SSA values instead of round-tripping through attributes; the
+  // per-initializer functions are made private and get inlined.
+  JitFunctionDesc buildBatchFunction() {
+    Location loc = targetModuleOp.getLoc();
+    OpBuilder moduleBuilder = OpBuilder::atBlockEnd(targetModuleOp.getBody());
+    auto batchOp = moduleBuilder.create<func::FuncOp>(
+        loc, "jit_eval_batch", moduleBuilder.getFunctionType({}, {}));
+    targetSymbolTable.insert(batchOp);
+    JitFunctionDesc batchDesc(loc, batchOp.getName().str());
+
+    Block *entryBlock = batchOp.addEntryBlock();
+    OpBuilder builder = OpBuilder::atBlockEnd(entryBlock);
+    llvm::DenseMap<Operation *, Value> storedGlobals;
+    llvm::SmallVector<Type> argumentTypes;
+    llvm::SmallVector<Type> returnTypes;
+    llvm::SmallVector<Value> returns;
+    for (JitFunctionDesc &desc : jitFunctions) {
+      auto funcOp = targetSymbolTable.lookup<func::FuncOp>(desc.name);
+      funcOp.setPrivate();
+
+      llvm::SmallVector<Value> operands;
+      for (auto [binding, type] :
+           llvm::zip_equal(desc.argumentBindings, funcOp.getArgumentTypes())) {
+        if (binding.getType() == ArgumentBinding::Type::GlobalOp) {
+          auto it = storedGlobals.find(binding.getGlobalOp());
+          if (it != storedGlobals.end()) {
+            operands.push_back(it->second);
+            continue;
+          }
+        }
+        argumentTypes.push_back(type);
+        operands.push_back(entryBlock->addArgument(type, desc.loc));
+        batchDesc.argumentBindings.push_back(binding);
+      }
+
+      auto callOp = builder.create<func::CallOp>(desc.loc, funcOp, operands);
+      for (auto [binding, result] :
+           llvm::zip_equal(desc.resultBindings, callOp.getResults())) {
+        storedGlobals[binding.getGlobalOp()] = result;
+        returns.push_back(result);
+        returnTypes.push_back(result.getType());
+        batchDesc.resultBindings.push_back(binding);
+      }
+    }
+
+    builder.create<func::ReturnOp>(loc, returns);
+    batchOp.setType(builder.getFunctionType(argumentTypes, returnTypes));
+    return batchDesc;
+  }
+
 private:
   static ModuleOp createInnerModule(ModuleOp sourceModuleOp) {
     OpBuilder builder = OpBuilder::atBlockEnd(sourceModuleOp.getBody());
@@ -392,72 +446,69 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     return s;
   }
 
-  LogicalResult
-  processFunctions(CompiledBinary &binary,
-                   llvm::SmallVector<JitFunctionDesc> &jitFunctions,
-                   ModuleOp module, llvm::TimerGroup &tg) {
-    // Process each function through the runtime.
-    for (JitFunctionDesc &jitFunction : jitFunctions) {
-      std::optional<llvm::Timer> invokeTimer;
-      if (debugEnabled) {
-        std::string timerName("Invoke ");
-        timerName.append(jitFunction.name);
-        invokeTimer.emplace(timerName, timerName, tg);
-        invokeTimer->startTimer();
-        dbgs() << "::: Invoking " << jitFunction.name << "\n";
-      }
+  LogicalResult processFunction(CompiledBinary &binary,
+                                JitFunctionDesc &jitFunction,
+                                llvm::TimerGroup &tg) {
+    std::optional<llvm::Timer> invokeTimer;
+    if (debugEnabled) {
+      std::string timerName("Invoke ");
+      timerName.append(jitFunction.name);
+      invokeTimer.emplace(timerName, timerName, tg);
+      invokeTimer->startTimer();
+      dbgs() << "::: Invoking " << jitFunction.name << "\n";
+    }
 
-      FunctionCall call(binary, jitFunction.argumentBindings.size(),
-                        jitFunction.resultBindings.size());
-
-      // Convert arguments.
-      for (ArgumentBinding &arg : jitFunction.argumentBindings) {
-        switch (arg.getType()) {
-        case ArgumentBinding::Type::ElementsAttr:
-          if (failed(call.addArgument(jitFunction.loc, arg.getElementsAttr())))
-            return failure();
-          break;
-
-        case ArgumentBinding::Type::GlobalOp: {
-          auto globalValue = arg.getGlobalOp().getInitialValue();
-          if (!globalValue) {
-            return emitError(jitFunction.loc)
-                   << "internal error: jit global source initialization order. "
-                      "global "
-                   << arg.getGlobalOp().getSymName() << " has no value";
-          }
-          if (failed(
-                  call.addArgument(arg.getGlobalOp().getLoc(), *globalValue)))
-            return failure();
-        } break;
+    FunctionCall call(binary, jitFunction.argumentBindings.size(),
+                      jitFunction.resultBindings.size());
+
+    // Convert arguments.
+    for (ArgumentBinding &arg : jitFunction.argumentBindings) {
+      switch (arg.getType()) {
+      case ArgumentBinding::Type::ElementsAttr:
+        if (failed(call.addArgument(jitFunction.loc, arg.getElementsAttr())))
+          return failure();
+        break;
+
+      case ArgumentBinding::Type::GlobalOp: {
+        auto globalValue = arg.getGlobalOp().getInitialValue();
+        if (!globalValue) {
+          return emitError(jitFunction.loc)
+                 << "internal error: jit global source initialization order. "
+                    "global "
+                 << arg.getGlobalOp().getSymName() << " has no value";
         }
+        if (failed(call.addArgument(arg.getGlobalOp().getLoc(), *globalValue)))
+          return failure();
+      } break;
       }
+    }
 
-      if (failed(call.invoke(jitFunction.loc, jitFunction.name))) {
-        return failure();
-      }
+    if (failed(call.invoke(jitFunction.loc, jitFunction.name))) {
+      return failure();
+    }
 
-      // Process results.
-      for (auto it : llvm::enumerate(jitFunction.resultBindings)) {
-        ResultBinding &resultBinding = it.value();
-        switch (resultBinding.getType()) {
-        case ResultBinding::Type::GlobalOp: {
-          TypedAttr attr;
-          if (failed(call.getResultAsAttr(
-                  resultBinding.getGlobalOp().getLoc(), it.index(),
-                  resultBinding.getGlobalOp().getType(), attr)))
-            return failure();
-          resultBinding.getGlobalOp().setInitialValueAttr(attr);
-          break;
-        }
-        }
+    // Process results. A global may be stored by more than one initializer in
+    // which case the last store (in initialization order) wins.
+    for (auto it : llvm::enumerate(jitFunction.resultBindings)) {
+      ResultBinding &resultBinding = it.value();
+      switch (resultBinding.getType()) {
+      case ResultBinding::Type::GlobalOp: {
+        TypedAttr attr;
+        if (failed(call.getResultAsAttr(resultBinding.getGlobalOp().getLoc(),
+                                        it.index(),
+                                        resultBinding.getGlobalOp().getType(),
+                                        attr)))
+          return failure();
+        resultBinding.getGlobalOp().setInitialValueAttr(attr);
+        break;
       }
-
-      if (debugEnabled) {
-        invokeTimer->stopTimer();
       }
     }
 
+    if (debugEnabled) {
+      invokeTimer->stopTimer();
+    }
+
     return success();
   }
 
@@ -520,6 +571,10 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       return;
     }
 
+    // All initializers are evaluated with a single invocation of one batch
+    // function rather than one round trip through the runtime each.
+    JitFunctionDesc batchFunction = programBuilder.buildBatchFunction();
+
     std::optional<llvm::Timer> compileTimer;
     if (debugEnabled) {
       dbgs() << "::: COMPILING JIT (" << requestedTargetBackend
@@ -543,9 +598,8 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     // Kill the temporary program.
     programBuilder.getTargetModule()->erase();
 
-    // Process the functions.
-    if (failed(processFunctions(binary, programBuilder.getJitFunctions(),
-                                outerModule, tg))) {
+    // Evaluate.
+    if (failed(processFunction(binary, batchFunction, tg))) {
       signalPassFailure();
       return;
     }
@@ -7,8 +7,11 @@
 #include "iree/compiler/ConstEval/Runtime.h"
 
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 #include "iree/hal/drivers/local_task/registration/driver_module.h"
+#include "llvm/Support/CommandLine.h"
+#include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/BuiltinTypes.h"
 
@@ -19,6 +22,13 @@ namespace mlir {
 namespace iree_compiler {
 namespace ConstEval {
 
+static llvm::cl::opt<int64_t> clJitResourceMinBytes(
+    "iree-consteval-jit-resource-min-bytes",
+    llvm::cl::desc("Minimum size in bytes of a non-splat JIT-evaluated "
+                   "constant for it to be stored as a resource blob instead "
+                   "of a dense elements attribute."),
+    llvm::cl::init(4096));
+
 namespace {
 
 LogicalResult handleRuntimeError(Location loc, iree_status_t status) {
@@ -100,24 +110,50 @@ Type mapElementType(Location loc, iree_hal_element_type_t halElementType) {
   return {};
 }
 
+// Returns true if every element in |rawBuffer| is bitwise identical to the
+// first one.
+static bool isSplatRawBuffer(ArrayRef<char> rawBuffer, size_t elementSize) {
+  if (rawBuffer.size() < elementSize)
+    return false;
+  const char *first = rawBuffer.data();
+  for (size_t offset = elementSize; offset < rawBuffer.size();
+       offset += elementSize) {
+    if (std::memcmp(first, rawBuffer.data() + offset, elementSize) != 0)
+      return false;
+  }
+  return true;
+}
+
 static TypedAttr createAttributeFromRawData(Location loc,
                                             RankedTensorType tensorType,
                                             MutableArrayRef<char> rawBuffer) {
   Type elementType = tensorType.getElementType();
-  // For numeric types that are byte-width aligned, we just use the raw buffer
-  // loading support of DenseElementsAttr.
+  // For numeric types that are byte-width aligned the mapped buffer already
+  // has the layout MLIR expects. Splats and small constants are kept as
+  // DenseElementsAttrs so that they remain foldable and readable; everything
+  // else is copied with a single memcpy into a resource blob, which avoids
+  // uniquing a potentially huge attribute in the context and serializes
+  // without being re-encoded.
   if (elementType.isIntOrFloat() &&
       elementType.getIntOrFloatBitWidth() % 8 == 0) {
-    bool detectedSplat = false;
-    if (DenseElementsAttr::isValidRawBuffer(tensorType, rawBuffer,
-                                            detectedSplat)) {
-      return DenseElementsAttr::getFromRawBuffer(tensorType, rawBuffer);
-    } else {
+    size_t elementSize = elementType.getIntOrFloatBitWidth() / 8;
+    if (rawBuffer.size() != tensorType.getNumElements() * elementSize) {
       emitError(loc) << "mapped memory region was not valid for constructing "
                         "tensor of type "
                      << tensorType << " (length=" << rawBuffer.size() << ")";
       return {};
     }
+    if (static_cast<int64_t>(rawBuffer.size()) < clJitResourceMinBytes) {
+      return DenseElementsAttr::getFromRawBuffer(tensorType, rawBuffer);
+    }
+    if (isSplatRawBuffer(rawBuffer, elementSize)) {
+      return DenseElementsAttr::getFromRawBuffer(
+          tensorType, rawBuffer.take_front(elementSize));
+    }
+    AsmResourceBlob blob = HeapAsmResourceBlob::allocateAndCopyWithAlign(
+        rawBuffer, /*align=*/64, /*dataIsMutable=*/false);
+    return IREE::Util::getDenseResourceElementsAttr(tensorType, "jit_eval",
+                                                    std::move(blob));
   }
 
   // For i1, IREE (currently) returns these as 8bit integer values and MLIR
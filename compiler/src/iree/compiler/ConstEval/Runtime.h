@@ -40,6 +40,8 @@ protected:
   // explicitly by subclasses, ensuring that any backing images remain valid
   // through the call to deinitialize().
   void deinitialize();
+  // Converts a result variant to an attribute. Non-splat tensors are copied
+  // out of the mapped HAL buffer into a DenseResourceElementsAttr blob.
   TypedAttr convertVariantToAttribute(Location loc, iree_vm_variant_t &variant,
                                       Type mlirType);
 
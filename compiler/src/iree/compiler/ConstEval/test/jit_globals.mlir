@@ -263,3 +263,58 @@ module @serializable_attrs {
     util.initializer.return
   }
 }
+
+// -----
+// Initializers are evaluated as a single batch; loads of globals stored by an
+// earlier initializer are forwarded within the batch.
+// CHECK-LABEL: @eval_chained_initializers
+// CHECK: util.global private @first = dense<[2, 3]> : tensor<2xi32>
+// CHECK: util.global private @second = dense<[4, 6]> : tensor<2xi32>
+// CHECK-NOT: util.initializer
+module @eval_chained_initializers {
+  util.global private @first : tensor<2xi32>
+  util.global private @second : tensor<2xi32>
+  func.func @main() -> (tensor<2xi32>, tensor<2xi32>) {
+    %first = util.global.load @first : tensor<2xi32>
+    %second = util.global.load @second : tensor<2xi32>
+    return %first, %second : tensor<2xi32>, tensor<2xi32>
+  }
+  util.initializer attributes {iree.compiler.consteval} {
+    %cst = arith.constant dense<[2, 3]> : tensor<2xi32>
+    util.global.store %cst, @first : tensor<2xi32>
+    util.initializer.return
+  }
+  util.initializer attributes {iree.compiler.consteval} {
+    %first = util.global.load @first : tensor<2xi32>
+    %0 = arith.addi %first, %first : tensor<2xi32>
+    util.global.store %0, @second : tensor<2xi32>
+    util.initializer.return
+  }
+}
+
+// -----
+// Non-splat results of at least --iree-consteval-jit-resource-min-bytes are
+// stored as resource blobs.
+// CHECK-LABEL: @eval_large_tensor
+// CHECK: util.global private @{{.*}} = dense_resource<[[RESOURCE:.+]]> : tensor<1024xi32>
+// CHECK: [[RESOURCE]]: "0x40000000000000000100000002000000{{.*}}"
+module @eval_large_tensor {
+  util.global private @hoisted : tensor<1024xi32>
+  func.func @main() -> tensor<1024xi32> {
+    %hoisted = util.global.load @hoisted : tensor<1024xi32>
+    return %hoisted : tensor<1024xi32>
+  }
+  util.initializer attributes {iree.compiler.consteval} {
+    %0 = tensor.empty() : tensor<1024xi32>
+    %1 = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]} outs(%0 : tensor<1024xi32>) {
+    ^bb0(%out : i32):
+      %2 = linalg.index 0 : index
+      %3 = arith.index_cast %2 : index to i32
+      linalg.yield %3 : i32
+    } -> tensor<1024xi32>
+    util.global.store %1, @hoisted : tensor<1024xi32>
+    util.initializer.return
+  }
+}
@@ -7,9 +7,12 @@
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SetVector.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/RegionGraphTraits.h"
@@ -38,10 +41,34 @@ bool compare_ranges(Range &&lhs, Range &&rhs, Pred pred) {
   return true;
 }
 
+// Pairs of scalar constants (lhs, rhs) at the same position in two regions
+// that are compared as equivalent modulo constant values.
+using ConstantPairs = SmallVector<std::pair<Operation *, Operation *>>;
+
 static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs,
-                                       IRMapping &parentMapping);
+                                       IRMapping &parentMapping,
+                                       ConstantPairs *constantPairs);
 static bool isStructurallyEquivalentTo(Operation &lhs, Operation &rhs,
-                                       IRMapping &parentMapping);
+                                       IRMapping &parentMapping,
+                                       ConstantPairs *constantPairs);
+
+// Returns true if |op| is a scalar constant that may be turned into a dispatch
+// operand. Only float constants whose users are all elementwise arith/math ops
+// are parameterized as reading those from an operand costs little. Integer and
+// index constants commonly define shapes, loop bounds and offsets, and float
+// constants feeding other ops (such as fills) are often folded by codegen, so
+// they remain static.
+static bool isParameterizableConstant(Operation &op) {
+  auto constantOp = dyn_cast<arith::ConstantOp>(op);
+  if (!constantOp || !llvm::isa<FloatType>(constantOp.getType()))
+    return false;
+  return !constantOp->use_empty() &&
+         llvm::all_of(constantOp->getUsers(), [](Operation *user) {
+           return isa_and_nonnull<arith::ArithDialect, math::MathDialect>(
+                      user->getDialect()) &&
+                  OpTrait::hasElementwiseMappableTraits(user);
+         });
+}
 
 // Recursively compares two regions for structural equivalence.
 // Structural equivalence ensures that operations on both the |lhs| and |rhs|
@@ -63,13 +90,18 @@ static bool isStructurallyEquivalentTo(Operation &lhs, Operation &rhs,
 //
 // TODO(#3996): upstream into mlir::OperationEquivalence if this works.
 // TODO(#3996): add symbol ref comparison (add to IRMapping).
-static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs) {
+//
+// If |constantPairs| is provided then parameterizable scalar constants are
+// allowed to differ in value and all of them are recorded in the list.
+static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs,
+                                       ConstantPairs *constantPairs = nullptr) {
   IRMapping mapping;
-  return isStructurallyEquivalentTo(lhs, rhs, mapping);
+  return isStructurallyEquivalentTo(lhs, rhs, mapping, constantPairs);
 }
 
 static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs,
-                                       IRMapping &mapping) {
+                                       IRMapping &mapping,
+                                       ConstantPairs *constantPairs) {
   // Use compare_ranges to walk the block list in parallel and get a boolean in
   // the case of size mismatch without an O(N) linked-list size query.
   if (!compare_ranges(
@@ -111,7 +143,7 @@ static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs,
     if (lhsOperations.size() != rhsOperations.size())
       return false;
     for (auto [lhsOp, rhsOp] : llvm::zip_equal(lhsOperations, rhsOperations)) {
-      if (!isStructurallyEquivalentTo(lhsOp, rhsOp, mapping)) {
+      if (!isStructurallyEquivalentTo(lhsOp, rhsOp, mapping, constantPairs)) {
         return false;
       }
     }
@@ -122,7 +154,8 @@ static bool isStructurallyEquivalentTo(Region &lhs, Region &rhs,
 }
 
 static bool isStructurallyEquivalentTo(Operation &lhs, Operation &rhs,
-                                       IRMapping &parentMapping) {
+                                       IRMapping &parentMapping,
+                                       ConstantPairs *constantPairs) {
   // Check operation metadata for early-exit opportunities.
   if (lhs.getName() != rhs.getName())
     return false;
@@ -135,8 +168,17 @@ static bool isStructurallyEquivalentTo(Operation &lhs, Operation &rhs,
   if (lhs.getNumSuccessors() != rhs.getNumSuccessors())
     return false;
 
+  // Constants that can be parameterized only need matching types; the values
+  // are compared by the caller.
+  bool isConstantPair = constantPairs && isParameterizableConstant(lhs) &&
+                        isParameterizableConstant(rhs);
+  if (isConstantPair) {
+    constantPairs->push_back(std::make_pair(&lhs, &rhs));
+  }
+
   // TODO(#3996): symbol mapping; for now allow them to differ unconditionally.
-  if (!compare_ranges(
+  if (!isConstantPair &&
+      !compare_ranges(
           lhs.getAttrs(), rhs.getAttrs(),
           [&](const NamedAttribute &lhs, const NamedAttribute &rhs) {
             if (lhs.getName() == "function_ref" ||
@@ -186,7 +228,8 @@ static bool isStructurallyEquivalentTo(Operation &lhs, Operation &rhs,
     IRMapping regionMapping = lhs.hasTrait<OpTrait::IsIsolatedFromAbove>()
                                   ? scopedRegionMapping
                                   : parentMapping;
-    if (!isStructurallyEquivalentTo(lhsRegion, rhsRegion, regionMapping)) {
+    if (!isStructurallyEquivalentTo(lhsRegion, rhsRegion, regionMapping,
+                                    constantPairs)) {
       return false;
     }
   }
@@ -210,13 +253,76 @@ void replaceEntryPointUses(
   }
 }
 
+// Records replacements of every export in |duplicateExecutableOp| with the
+// matching export in |referenceExecutableOp|.
+static void recordEntryPointReplacements(
+    ExecutableOp duplicateExecutableOp, ExecutableOp referenceExecutableOp,
+    DenseMap<Attribute, SymbolRefAttr> &replacements) {
+  auto *context = duplicateExecutableOp.getContext();
+  for (auto [oldExportOp, newExportOp] : llvm::zip_equal(
+           duplicateExecutableOp.getBlock().getOps<ExecutableExportOp>(),
+           referenceExecutableOp.getBlock().getOps<ExecutableExportOp>())) {
+    auto oldSymbolRefAttr = SymbolRefAttr::get(
+        context, duplicateExecutableOp.getName(),
+        {SymbolRefAttr::get(context, oldExportOp.getSymName())});
+    auto newSymbolRefAttr = SymbolRefAttr::get(
+        context, referenceExecutableOp.getName(),
+        {SymbolRefAttr::get(context, newExportOp.getSymName())});
+    replacements[oldSymbolRefAttr] = newSymbolRefAttr;
+  }
+}
+
+// Returns the dispatch function of |executableOp| if it has a single export.
+static func::FuncOp getSingleEntryFunction(ExecutableOp executableOp) {
+  auto exportOps =
+      llvm::to_vector(executableOp.getBlock().getOps<ExecutableExportOp>());
+  if (exportOps.size() != 1)
+    return {};
+  return executableOp.getInnerModule().lookupSymbol<func::FuncOp>(
+      exportOps.front().getFunctionRef());
+}
+
+// Replaces |constantOps| in |funcOp| with new dispatch operands appended after
+// the existing ones and passes the original values at every dispatch site.
+static void replaceConstantsWithOperands(func::FuncOp funcOp,
+                                  ArrayRef<Operation *> constantOps,
+                                  ArrayRef<DispatchOp> dispatchOps) {
+  unsigned argIndex = dispatchOps.front().getArguments().size();
+  SmallVector<TypedAttr> values;
+  for (auto *op : constantOps) {
+    auto constantOp = cast<arith::ConstantOp>(op);
+    funcOp.insertArgument(argIndex, constantOp.getType(),
+                          DictionaryAttr::get(funcOp.getContext()),
+                          constantOp.getLoc());
+    BlockArgument arg = funcOp.getArgument(argIndex++);
+    constantOp.getResult().replaceAllUsesWith(arg);
+    values.push_back(constantOp.getValue());
+    constantOp.erase();
+  }
+  for (auto dispatchOp : dispatchOps) {
+    OpBuilder builder(dispatchOp);
+    SmallVector<Value> operands;
+    for (TypedAttr value : values) {
+      operands.push_back(
+          builder.create<arith::ConstantOp>(dispatchOp.getLoc(), value));
+    }
+    dispatchOp.getArgumentsMutable().append(operands);
+  }
+}
+
 } // namespace
 
 class DeduplicateExecutablesPass
     : public DeduplicateExecutablesBase<DeduplicateExecutablesPass> {
 public:
-  explicit DeduplicateExecutablesPass() {}
-  DeduplicateExecutablesPass(const DeduplicateExecutablesPass &pass) {}
+  explicit DeduplicateExecutablesPass(bool parameterizeConstants = false,
+                                      unsigned maxParameterizedConstants = 4) {
+    this->parameterizeConstants = parameterizeConstants;
+    this->maxParameterizedConstants = maxParameterizedConstants;
+  }
+  DeduplicateExecutablesPass(const DeduplicateExecutablesPass &pass)
+      : DeduplicateExecutablesPass(pass.parameterizeConstants,
+                                   pass.maxParameterizedConstants) {}
 
   void runOnOperation() override {
     auto moduleOp = getOperation();
@@ -257,31 +363,15 @@ public:
 
           // Found an equivalent executable! Record it and move on to the next.
           duplicateExecutableOps.push_back(duplicateExecutableOp);
-
-          // Record entry point reference replacements.
-          for (auto [oldExportOp, newExportOp] :
-               llvm::zip_equal(duplicateExecutableOp.getBlock()
-                                   .getOps<ExecutableExportOp>(),
-                               referenceExecutableOp.getBlock()
-                                   .getOps<ExecutableExportOp>())) {
-            auto oldSymbolRefAttr = SymbolRefAttr::get(
-                builder.getContext(), duplicateExecutableOp.getName(),
-                {SymbolRefAttr::get(builder.getContext(),
-                                    oldExportOp.getSymName())});
-            auto newSymbolRefAttr = SymbolRefAttr::get(
-                builder.getContext(), referenceExecutableOp.getName(),
-                {SymbolRefAttr::get(builder.getContext(),
-                                    newExportOp.getSymName())});
-            entryPointRefReplacements[oldSymbolRefAttr] = newSymbolRefAttr;
-          }
-
+          recordEntryPointReplacements(duplicateExecutableOp,
+                                       referenceExecutableOp,
+                                       entryPointRefReplacements);
           break;
         }
       }
     }
 
     executablesDeduplicated = duplicateExecutableOps.size();
-    remainingExecutables = totalExecutables - executablesDeduplicated;
 
     replaceEntryPointUses(moduleOp, entryPointRefReplacements);
 
@@ -291,26 +381,154 @@ public:
     // originally numbered. While we could renumber them, we choose to keep
     // original names (numbers and all) to make it easier to track executables
     // through this pass.
+    llvm::DenseSet<Operation *> erasedExecutableOps;
     for (auto executableOp : duplicateExecutableOps) {
+      erasedExecutableOps.insert(executableOp);
       executableOp.erase();
     }
+
+    if (parameterizeConstants) {
+      for (auto &[key, executableOps] : executableOpsMap) {
+        (void)key;
+        SmallVector<ExecutableOp> candidateOps;
+        for (auto executableOp : executableOps) {
+          if (!erasedExecutableOps.contains(executableOp))
+            candidateOps.push_back(executableOp);
+        }
+        deduplicateModuloConstants(moduleOp, candidateOps);
+      }
+    }
+
+    remainingExecutables = totalExecutables - executablesDeduplicated -
+                           executablesParameterized;
   }
 
 private:
+  // Merges executables that are equivalent except for the values of a few
+  // scalar constants by turning those constants into dispatch operands. The
+  // push constants added here are folded back in by the stream uniform operand
+  // folding if they end up being the same at all remaining dispatch sites.
+  void deduplicateModuloConstants(mlir::ModuleOp moduleOp,
+                                  ArrayRef<ExecutableOp> executableOps) {
+    if (executableOps.size() < 2)
+      return;
+
+    // Gather the dispatch sites of each executable. Executables without any
+    // sites or with multiple exports are left alone.
+    DenseMap<Operation *, SmallVector<DispatchOp>> dispatchOpsMap;
+    SymbolTable symbolTable(moduleOp);
+    for (auto funcLikeOp : moduleOp.getOps<FunctionOpInterface>()) {
+      funcLikeOp->walk([&](DispatchOp dispatchOp) {
+        auto executableOp = symbolTable.lookup<ExecutableOp>(
+            dispatchOp.getEntryPoint().getRootReference());
+        if (executableOp)
+          dispatchOpsMap[executableOp].push_back(dispatchOp);
+      });
+    }
+    SmallVector<ExecutableOp> candidateOps;
+    for (auto executableOp : executableOps) {
+      if (getSingleEntryFunction(executableOp) &&
+          !dispatchOpsMap[executableOp].empty()) {
+        candidateOps.push_back(executableOp);
+      }
+    }
+
+    SmallVector<ExecutableOp> mergedExecutableOps;
+    DenseMap<Attribute, SymbolRefAttr> entryPointRefReplacements;
+    llvm::DenseSet<Operation *> mergedSet;
+    for (auto referenceExecutableOp : candidateOps) {
+      if (mergedSet.contains(referenceExecutableOp))
+        continue;
+      auto referenceFuncOp = getSingleEntryFunction(referenceExecutableOp);
+
+      // Find all executables equivalent to the reference modulo constants.
+      SmallVector<std::pair<ExecutableOp, ConstantPairs>> members;
+      for (auto executableOp : candidateOps) {
+        if (executableOp == referenceExecutableOp ||
+            mergedSet.contains(executableOp)) {
+          continue;
+        }
+        ConstantPairs constantPairs;
+        if (isStructurallyEquivalentTo(referenceExecutableOp.getBody(),
+                                       executableOp.getBody(),
+                                       &constantPairs)) {
+          members.push_back(
+              std::make_pair(executableOp, std::move(constantPairs)));
+        }
+      }
+      if (members.empty())
+        continue;
+
+      // Collect the reference constants that differ in any member. They must
+      // live directly in the dispatch function (not the workgroup count
+      // region or another isolated region) to be passed as operands.
+      llvm::SetVector<Operation *> differingOps;
+      bool isLegal = true;
+      for (auto &[executableOp, constantPairs] : members) {
+        (void)executableOp;
+        for (auto [lhsOp, rhsOp] : constantPairs) {
+          if (cast<arith::ConstantOp>(lhsOp).getValue() ==
+              cast<arith::ConstantOp>(rhsOp).getValue()) {
+            continue;
+          }
+          if (lhsOp->getParentWithTrait<OpTrait::IsIsolatedFromAbove>() !=
+              referenceFuncOp) {
+            isLegal = false;
+          }
+          differingOps.insert(lhsOp);
+        }
+      }
+      if (!isLegal || differingOps.empty() ||
+          differingOps.size() > maxParameterizedConstants) {
+        continue;
+      }
+
+      // Parameterize the members first as their constants are looked up via
+      // the reference constants.
+      for (auto &[executableOp, constantPairs] : members) {
+        DenseMap<Operation *, Operation *> constantMap(constantPairs.begin(),
+                                                       constantPairs.end());
+        SmallVector<Operation *> memberOps;
+        for (auto *lhsOp : differingOps) {
+          memberOps.push_back(constantMap.lookup(lhsOp));
+        }
+        replaceConstantsWithOperands(getSingleEntryFunction(executableOp),
+                                     memberOps, dispatchOpsMap[executableOp]);
+        recordEntryPointReplacements(executableOp, referenceExecutableOp,
+                                     entryPointRefReplacements);
+        mergedExecutableOps.push_back(executableOp);
+        mergedSet.insert(executableOp);
+      }
+      replaceConstantsWithOperands(referenceFuncOp, differingOps.getArrayRef(),
+                                   dispatchOpsMap[referenceExecutableOp]);
+    }
+
+    executablesParameterized += mergedExecutableOps.size();
+    replaceEntryPointUses(moduleOp, entryPointRefReplacements);
+    for (auto executableOp : mergedExecutableOps) {
+      executableOp.erase();
+    }
+  }
+
   Statistic totalExecutables{
       this, "total executable(s)",
       "Number of flow.executable ops before deduplication"};
   Statistic executablesDeduplicated{
       this, "duplicate executable(s)",
       "Number of flow.executable ops removed as duplicates"};
+  Statistic executablesParameterized{
+      this, "parameterized executable(s)",
+      "Number of flow.executable ops removed after parameterizing constants"};
   Statistic remainingExecutables{
       this, "unique executable(s)",
       "Number of flow.executable ops remaining after deduplication"};
 };
 
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
-createDeduplicateExecutablesPass() {
-  return std::make_unique<DeduplicateExecutablesPass>();
+createDeduplicateExecutablesPass(bool parameterizeConstants,
+                                 unsigned maxParameterizedConstants) {
+  return std::make_unique<DeduplicateExecutablesPass>(
+      parameterizeConstants, maxParameterizedConstants);
 }
 
 } // namespace Flow
@@ -75,12 +75,26 @@ static llvm::cl::opt<bool> clDemoteF64ToF32(
                    "unconditionally before main flow conversions."),
     llvm::cl::init(true));
 
+static llvm::cl::opt<bool> clDedupeParameterizeConstants(
+    "iree-flow-dedupe-parameterize-constants",
+    llvm::cl::desc("Deduplicates executables that differ only in scalar "
+                   "float constants feeding elementwise math by passing the "
+                   "constants as operands."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clDetensoring(
     "iree-flow-enable-detensoring",
     llvm::cl::desc(
         "Enable changing of tensor operations into scalar operations."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clRaiseAttention(
+    "iree-flow-raise-attention",
+    llvm::cl::desc("Raises matmul/softmax/matmul chains to "
+                   "iree_linalg_ext.attention. Only the llvm-cpu backend "
+                   "can lower the raised op."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clEnablePadHandling(
     "iree-flow-enable-pad-handling",
     llvm::cl::desc("Enable native handling of tensor.pad operations."),
@@ -186,7 +200,7 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       .addPass(createGeneralizeLinalgNamedOpsPass)
       .addPass(createFuseDequantizationMatmulPass)
       .addPass(createFoldUnitExtentDimsPass)
-      .addPass(createRaiseSpecialOps)
+      .addPass([]() { return createRaiseSpecialOps(clRaiseAttention); })
       .addPass(createInterchangeGenericOpsPass)
       .addPass(createCollapseDimsPass)
       .addPass(memref::createResolveShapedTypeResultDimsPass)
@@ -199,7 +213,7 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
       .addPass(mlir::createCanonicalizerPass)
       .addPass(mlir::createCSEPass)
       // Split reduction operations into parallel and reduction.
-      .addPass(createSplitReductionPass)
+      .addPass([]() { return createSplitReductionPass(); })
       // SplitReductionPass may create reduction dimension that are not the last
       // dimension.
       .addPass(createInterchangeGenericOpsPass)
@@ -282,10 +296,14 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
   FunctionLikeNest(passManager).addPass(mlir::createCanonicalizerPass);
 
   // Deduplicate executables created from dispatch regions.
-  // Note: this only deduplicates equivalent executables. We could in addition
-  // generalize executables to prune further (e.g. by promoting a dimension to
-  // an argument if two executables differ only in that one dimension).
-  passManager.addPass(IREE::Flow::createDeduplicateExecutablesPass());
+  // When enabled, executables that differ only in scalar float constants are
+  // merged by promoting the constants to operands; stream uniform operand
+  // folding will inline them again if all dispatch sites end up passing the
+  // same values. We could in addition generalize executables to prune further
+  // (e.g. by promoting a dimension to an argument if two executables differ
+  // only in that one dimension).
+  passManager.addPass(IREE::Flow::createDeduplicateExecutablesPass(
+      clDedupeParameterizeConstants));
 
   // Create one function per exported program entry point that can be used with
   // iree-benchmark-module to benchmark each function individually. Whether
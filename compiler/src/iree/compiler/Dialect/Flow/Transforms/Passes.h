@@ -228,16 +228,35 @@ std::unique_ptr<OperationPass<mlir::ModuleOp>> createExportBenchmarkFuncsPass();
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
 createOutlineLargeConstantsPass();
 
-// Deduplicates equivalent executables.
+// Deduplicates equivalent executables. If |parameterizeConstants| is set then
+// executables differing only in up to |maxParameterizedConstants| scalar
+// constants are merged by passing the constants as dispatch operands.
 std::unique_ptr<OperationPass<mlir::ModuleOp>>
-createDeduplicateExecutablesPass();
+createDeduplicateExecutablesPass(bool parameterizeConstants = false,
+                                 unsigned maxParameterizedConstants = 4);
 
 // Create a pass to raise sequence of ops to higher level linalg.ext
 // representation.
-std::unique_ptr<Pass> createRaiseSpecialOps();
+std::unique_ptr<Pass> createRaiseSpecialOps(bool raiseAttention = false);
+
+// Options for the split reduction pass. These mirror the options declared in
+// the pass definition.
+// TODO(ravishankarm): Move the passes in Flow to use the auto-generated options
+// struct.
+struct SplitReductionOptions {
+  // Number of CPU workers the automatic matmul split-K targets. Matches the
+  // default of the LLVMCPU `--iree-codegen-llvm-number-of-threads` flag.
+  // 0 disables automatic splitting.
+  int64_t cpuNumberOfThreads = 8;
+  // Tile size CPU codegen distributes matmul parallel dimensions with.
+  // Matches the default of the LLVMCPU `--iree-codegen-llvm-distribution-size`
+  // flag.
+  int64_t cpuDistributionTileSize = 64;
+};
 
 // Create a pass to split reduction dimension.
-std::unique_ptr<Pass> createSplitReductionPass();
+std::unique_ptr<Pass>
+createSplitReductionPass(SplitReductionOptions options = {});
 
 // Create a pass to collapse reduction dimensions
 std::unique_ptr<Pass> createCollapseDimsPass();
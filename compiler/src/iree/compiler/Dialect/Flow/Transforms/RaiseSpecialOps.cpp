@@ -11,6 +11,8 @@
 #include "iree-dialects/Transforms/TransformMatchers.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -76,6 +78,199 @@ std::optional<Value> matchATransposeBMatmul(linalg::LinalgOp matmulOp) {
   return std::nullopt;
 }
 
+// Method to match a 3D transpose swapping the two inner dimensions, either as
+// a linalg.transpose or as a linalg.generic. Returns the transposed source on
+// success.
+static std::optional<Value> matchInnerDimsTranspose(Value value) {
+  Operation *op = value.getDefiningOp();
+  if (auto transposeOp = dyn_cast_or_null<linalg::TransposeOp>(op)) {
+    if (transposeOp.getPermutation() != ArrayRef<int64_t>{0, 2, 1}) {
+      return std::nullopt;
+    }
+    return transposeOp.getInput();
+  }
+  auto genericOp = dyn_cast_or_null<linalg::GenericOp>(op);
+  if (!genericOp || genericOp.getNumDpsInputs() != 1 ||
+      genericOp.getNumDpsInits() != 1) {
+    return std::nullopt;
+  }
+  if (genericOp.getNumLoops() != 3 ||
+      genericOp.getNumLoops() != genericOp.getNumParallelLoops()) {
+    return std::nullopt;
+  }
+  AffineExpr d0, d1, d2;
+  MLIRContext *context = genericOp.getContext();
+  bindDims(context, d0, d1, d2);
+  AffineMap identity = AffineMap::get(3, 0, {d0, d1, d2}, context);
+  AffineMap transposed = AffineMap::get(3, 0, {d0, d2, d1}, context);
+  SmallVector<AffineMap> maps = genericOp.getIndexingMapsArray();
+  if (maps != SmallVector<AffineMap>{identity, transposed} &&
+      maps != SmallVector<AffineMap>{transposed, identity}) {
+    return std::nullopt;
+  }
+  Block *body = genericOp.getBlock();
+  if (!llvm::hasSingleElement(*body)) {
+    return std::nullopt;
+  }
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  auto blockArg = yieldOp.getOperand(0).dyn_cast<BlockArgument>();
+  if (!blockArg || blockArg.getOwner() != body ||
+      blockArg.getArgNumber() != 0) {
+    return std::nullopt;
+  }
+  return genericOp.getDpsInputOperand(0)->get();
+}
+
+// Method to match a value produced by a linalg.fill of zero.
+static bool isZeroFilled(Value value) {
+  auto fillOp = value.getDefiningOp<linalg::FillOp>();
+  if (!fillOp) {
+    return false;
+  }
+  Value fillValue = fillOp.getDpsInputOperand(0)->get();
+  return matchPattern(fillValue, m_AnyZeroFloat());
+}
+
+// Method to match an elementwise linalg.generic multiplying (or dividing) its
+// only input by a scalar constant. Returns the input and the effective
+// multiplier on success.
+static std::optional<std::pair<Value, double>>
+matchScalarScale(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() != 1 || genericOp.getNumDpsInits() != 1 ||
+      !isElementwise(genericOp) ||
+      !llvm::all_of(genericOp.getIndexingMapsArray(),
+                    [](AffineMap map) { return map.isIdentity(); })) {
+    return std::nullopt;
+  }
+  Block *body = genericOp.getBlock();
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  Operation *scaleOp = yieldOp.getOperand(0).getDefiningOp();
+  if (!scaleOp || scaleOp->getBlock() != body ||
+      !isa<arith::MulFOp, arith::DivFOp>(scaleOp) ||
+      &body->front() != scaleOp) {
+    return std::nullopt;
+  }
+  Value input = body->getArgument(0);
+  Value lhs = scaleOp->getOperand(0);
+  Value rhs = scaleOp->getOperand(1);
+  bool isDiv = isa<arith::DivFOp>(scaleOp);
+  if (!isDiv && rhs == input) {
+    std::swap(lhs, rhs);
+  }
+  FloatAttr constant;
+  if (lhs != input || !matchPattern(rhs, m_Constant(&constant))) {
+    return std::nullopt;
+  }
+  double value = constant.getValueAsDouble();
+  if (isDiv) {
+    if (value == 0.0) {
+      return std::nullopt;
+    }
+    value = 1.0 / value;
+  }
+  return std::make_pair(genericOp.getDpsInputOperand(0)->get(), value);
+}
+
+// Method to match the unfused attention pattern
+//   linalg.batch_matmul(softmax(scale(linalg.batch_matmul(Q, transpose(K)))),
+//                       V)
+// where the scaling by a scalar constant is optional and both matmuls
+// accumulate into zero-filled tensors. On success, replaces the final matmul
+// with an iree_linalg_ext.attention op. The op computes its softmax with
+// exp2, so the scale and a log2(e) factor are folded into the query.
+static LogicalResult raiseToAttention(linalg::BatchMatmulOp pvMatmul,
+                                      RewriterBase &rewriter) {
+  if (!pvMatmul.hasTensorSemantics() ||
+      !isZeroFilled(pvMatmul.getDpsInitOperand(0)->get())) {
+    return failure();
+  }
+  Value probabilities = pvMatmul.getDpsInputOperand(0)->get();
+  auto softmaxOp = probabilities.getDefiningOp<IREE::LinalgExt::SoftmaxOp>();
+  if (!softmaxOp || softmaxOp.getDimension() != 2 ||
+      !softmaxOp->getResult(0).hasOneUse()) {
+    return failure();
+  }
+
+  Value scores = softmaxOp.input();
+  double scale = 1.0;
+  linalg::GenericOp scaleOp = scores.getDefiningOp<linalg::GenericOp>();
+  if (scaleOp) {
+    std::optional<std::pair<Value, double>> scaled = matchScalarScale(scaleOp);
+    if (!scaled || !scaleOp->getResult(0).hasOneUse()) {
+      return failure();
+    }
+    scores = scaled->first;
+    scale = scaled->second;
+  }
+  auto qkMatmul = scores.getDefiningOp<linalg::BatchMatmulOp>();
+  if (!qkMatmul || !qkMatmul->getResult(0).hasOneUse() ||
+      !isZeroFilled(qkMatmul.getDpsInitOperand(0)->get())) {
+    return failure();
+  }
+  Value query = qkMatmul.getDpsInputOperand(0)->get();
+  std::optional<Value> key =
+      matchInnerDimsTranspose(qkMatmul.getDpsInputOperand(1)->get());
+  if (!key) {
+    return failure();
+  }
+  Value value = pvMatmul.getDpsInputOperand(1)->get();
+
+  // The tiled decomposition of the attention op requires static shapes, a
+  // common element type and a value head dimension matching the query one.
+  auto queryType = cast<RankedTensorType>(query.getType());
+  auto keyType = cast<RankedTensorType>(key->getType());
+  auto valueType = cast<RankedTensorType>(value.getType());
+  auto resultType = cast<RankedTensorType>(pvMatmul->getResult(0).getType());
+  Type elementType = queryType.getElementType();
+  if (!elementType.isF32() && !elementType.isF16()) {
+    return failure();
+  }
+  for (RankedTensorType type :
+       {queryType, keyType, valueType, resultType,
+        cast<RankedTensorType>(qkMatmul->getResult(0).getType())}) {
+    if (!type.hasStaticShape() || type.getElementType() != elementType) {
+      return failure();
+    }
+  }
+  if (keyType.getShape() != valueType.getShape() ||
+      queryType.getShape() != resultType.getShape()) {
+    return failure();
+  }
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(pvMatmul);
+  Location loc = pvMatmul.getLoc();
+  Value multiplier = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getFloatAttr(elementType, scale * llvm::numbers::log2e));
+  Value scaledQueryInit = rewriter.create<tensor::EmptyOp>(
+      loc, queryType.getShape(), elementType);
+  SmallVector<AffineMap> maps(2, rewriter.getMultiDimIdentityMap(3));
+  SmallVector<utils::IteratorType> iteratorTypes(3,
+                                                 utils::IteratorType::parallel);
+  Value scaledQuery =
+      rewriter
+          .create<linalg::GenericOp>(
+              loc, queryType, query, scaledQueryInit, maps, iteratorTypes,
+              [&](OpBuilder &b, Location loc, ValueRange args) {
+                Value result =
+                    b.create<arith::MulFOp>(loc, args[0], multiplier);
+                b.create<linalg::YieldOp>(loc, result);
+              })
+          .getResult(0);
+  auto outputFill =
+      pvMatmul.getDpsInitOperand(0)->get().getDefiningOp<linalg::FillOp>();
+  Value output = outputFill.getDpsInitOperand(0)->get();
+  auto attentionOp = rewriter.create<IREE::LinalgExt::AttentionOp>(
+      loc, resultType, ValueRange{scaledQuery, *key, value}, output);
+  rewriter.replaceOp(pvMatmul, attentionOp.getResult(0));
+  rewriter.eraseOp(softmaxOp);
+  if (scaleOp) {
+    rewriter.eraseOp(scaleOp);
+  }
+  rewriter.eraseOp(qkMatmul);
+  return success();
+}
+
 /// Matches a linalg.generic operation reading data from a tensor `source` using
 /// tensor.extract, and raises the `source` tensor to an input of the linalg
 /// operation.
@@ -301,8 +496,15 @@ static FailureOr<Operation *> tryRaiseToView(linalg::GenericOp linalgOp,
 }
 
 struct RaiseSpecialOpsPass : public RaiseSpecialOpsBase<RaiseSpecialOpsPass> {
+  RaiseSpecialOpsPass(bool raiseAttention) {
+    this->raiseAttention = raiseAttention;
+  }
+  RaiseSpecialOpsPass(const RaiseSpecialOpsPass &pass)
+      : RaiseSpecialOpsPass(pass.raiseAttention) {}
+
   void getDependentDialects(DialectRegistry &registry) const override {
-    registry.insert<IREE::LinalgExt::IREELinalgExtDialect>();
+    registry.insert<arith::ArithDialect, IREE::LinalgExt::IREELinalgExtDialect,
+                    tensor::TensorDialect>();
   }
 
   void runOnOperation() override {
@@ -369,13 +571,26 @@ struct RaiseSpecialOpsPass : public RaiseSpecialOpsBase<RaiseSpecialOpsPass> {
       rewriter.replaceOpWithNewOp<linalg::MatmulTransposeBOp>(
           matmulOp, ValueRange{lhs, newRhs}, ValueRange{init}, attrs);
     }
+
+    // Raise attention after softmax such that softmax written as a sequence
+    // of linalg.generic ops is also matched. Only the LLVMCPU backend has a
+    // lowering for the attention op, so this is opt-in.
+    if (!raiseAttention) {
+      return;
+    }
+    SmallVector<linalg::BatchMatmulOp> attentionRoots;
+    getOperation()->walk(
+        [&](linalg::BatchMatmulOp op) { attentionRoots.push_back(op); });
+    for (linalg::BatchMatmulOp op : attentionRoots) {
+      (void)raiseToAttention(op, rewriter);
+    }
   }
 };
 
 } // namespace
 
-std::unique_ptr<Pass> createRaiseSpecialOps() {
-  return std::make_unique<RaiseSpecialOpsPass>();
+std::unique_ptr<Pass> createRaiseSpecialOps(bool raiseAttention) {
+  return std::make_unique<RaiseSpecialOpsPass>(raiseAttention);
 }
 
 } // namespace Flow
@@ -195,6 +195,10 @@ struct SetMatmulEncoding : public OpRewritePattern<linalg::MatmulOp> {
                rhsElemType.isSignlessInteger(8) &&
                outElemType.isSignlessInteger(32)) {
       user = LinalgExt::EncodingUser::MATMUL_I8I8I32;
+    } else if (lhsElemType.isSignlessInteger(8) &&
+               rhsElemType.isSignlessInteger(4) &&
+               outElemType.isSignlessInteger(32)) {
+      user = LinalgExt::EncodingUser::MATMUL_I8I4I32;
     } else {
       return rewriter.notifyMatchFailure(
           matmulOp,
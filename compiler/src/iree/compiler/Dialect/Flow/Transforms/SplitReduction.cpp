@@ -14,9 +14,12 @@
 #include "iree-dialects/Dialect/LinalgExt/Transforms/Transforms.h"
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "llvm/Support/CommandLine.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -29,11 +32,81 @@ static llvm::cl::opt<int64_t>
     splitReductionRatio("iree-flow-split-matmul-reduction",
                         llvm::cl::desc("split ratio"), llvm::cl::init(1));
 
+static llvm::cl::opt<bool> clSplitMatmulReductionAllowFloatReassociation(
+    "iree-flow-split-matmul-reduction-allow-float-reassociation",
+    llvm::cl::desc(
+        "Also automatically split the reduction dimension of float matmuls "
+        "that do not produce enough parallel workgroups on CPU targets. This "
+        "changes the summation order and thus the rounding of the results; "
+        "integer matmuls are split regardless."),
+    llvm::cl::init(false));
+
 static llvm::cl::list<int64_t> topkSplitReductionRatio(
     "iree-flow-topk-split-reduction",
     llvm::cl::desc("comma separated list of split ratios"),
     llvm::cl::CommaSeparated);
 
+// Minimum reduction size each split handles so that the partial matmuls
+// remain worth dispatching and the combining reduction stays cheap.
+static constexpr int64_t kMinSplitReductionSize = 256;
+
+/// Returns true if all executable targets of the program enclosing |op| are
+/// CPU targets.
+static bool isCPUOnlyProgram(Operation *op) {
+  auto moduleOp = dyn_cast<mlir::ModuleOp>(op);
+  if (!moduleOp)
+    moduleOp = op->getParentOfType<mlir::ModuleOp>();
+  if (!moduleOp)
+    return false;
+  auto executableTargets =
+      IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(moduleOp);
+  if (executableTargets.empty())
+    return false;
+  return llvm::all_of(executableTargets, [](auto executableTarget) {
+    return executableTarget.getBackend().getValue() == "llvm-cpu";
+  });
+}
+
+/// Returns the ratio to split the K dimension of |matmulOp| by so that a
+/// matmul with a small M and N (such as a matrix-vector product) produces
+/// enough workgroups of |distributionTileSize| to occupy |numThreads| CPU
+/// workers. Returns 0 if the matmul already has enough parallelism or cannot
+/// be split profitably or without changing its results.
+static int64_t getAutomaticSplitKRatio(linalg::MatmulOp matmulOp,
+                                       int64_t numThreads,
+                                       int64_t distributionTileSize) {
+  // Splitting reassociates the reduction, which is only exact for integers.
+  Type accType = getElementTypeOrSelf(matmulOp.getOutputs()[0].getType());
+  if (!llvm::isa<IntegerType>(accType) &&
+      !clSplitMatmulReductionAllowFloatReassociation) {
+    return 0;
+  }
+  auto lhsType = llvm::cast<ShapedType>(matmulOp.getInputs()[0].getType());
+  auto rhsType = llvm::cast<ShapedType>(matmulOp.getInputs()[1].getType());
+  if (!lhsType.hasStaticShape() || !rhsType.hasStaticShape())
+    return 0;
+  int64_t M = lhsType.getDimSize(0);
+  int64_t K = lhsType.getDimSize(1);
+  int64_t N = rhsType.getDimSize(1);
+  int64_t numParallelWorkgroups = llvm::divideCeil(M, distributionTileSize) *
+                                  llvm::divideCeil(N, distributionTileSize);
+  if (numParallelWorkgroups >= numThreads)
+    return 0;
+
+  // Over-provision the workgroups to twice the number of threads, matching
+  // the LLVMCPU distribution heuristics, and pick the largest ratio that
+  // evenly divides K.
+  int64_t maxRatio = llvm::divideCeil(2 * numThreads, numParallelWorkgroups);
+  int64_t ratio = 0;
+  for (int64_t candidate = 2;
+       candidate <= maxRatio && K / candidate >= kMinSplitReductionSize;
+       ++candidate) {
+    if (K % candidate == 0)
+      ratio = candidate;
+  }
+  return ratio;
+}
+
 namespace {
 /// Pattern to wrap splitReduction transformation. This also propagates
 /// attributes to allow compilation info attribute to not be lost.
@@ -78,12 +151,30 @@ private:
 };
 
 struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
+  SplitReductionPass() {}
+  SplitReductionPass(const SplitReductionOptions &options)
+      : SplitReductionPass() {
+    cpuNumberOfThreads = options.cpuNumberOfThreads;
+    cpuDistributionTileSize = options.cpuDistributionTileSize;
+  }
+  SplitReductionPass(const SplitReductionPass &other)
+      : SplitReductionPass(SplitReductionOptions{
+            other.cpuNumberOfThreads, other.cpuDistributionTileSize}) {}
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<linalg::LinalgDialect>();
   }
 
   void runOnOperation() override {
-    if (splitReductionRatio.getValue() <= 1 &&
+    // Without an explicit ratio matmuls are split automatically when targeting
+    // only CPUs; the LLVMCPU backend distributes the parallel dimensions only
+    // so skinny matmuls would otherwise leave most workers idle.
+    int64_t numThreads = cpuNumberOfThreads;
+    int64_t distributionTileSize = cpuDistributionTileSize;
+    bool automaticSplitK = splitReductionRatio.getValue() <= 1 &&
+                           numThreads > 0 && distributionTileSize > 0 &&
+                           isCPUOnlyProgram(getOperation());
+    if (splitReductionRatio.getValue() <= 1 && !automaticSplitK &&
         topkSplitReductionRatio.empty()) {
       return;
     }
@@ -93,9 +184,16 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
         &getContext(),
         [&](linalg::LinalgOp op) -> linalg::SplitReductionOptions {
           // For matmul make the new parallel dimension first so that it looks
-          // like a batch_matmul and can follow the same codegen.
-          if (isa<linalg::MatmulOp>(op))
-            return {int64_t(splitReductionRatio), 0, /*innerParallel=*/false};
+          // like a batch_matmul and can follow the same codegen. The partial
+          // results are combined by a separate reduction dispatch.
+          if (auto matmulOp = dyn_cast<linalg::MatmulOp>(op.getOperation())) {
+            int64_t ratio = splitReductionRatio;
+            if (automaticSplitK) {
+              ratio = getAutomaticSplitKRatio(matmulOp, numThreads,
+                                              distributionTileSize);
+            }
+            return {ratio, 0, /*innerParallel=*/false};
+          }
           // Currently disable spliting reduction for non-matmul op. This will
           // get enabled after once tests are ready.
           return {int64_t(0), 0, /*innerParallel=*/false};
@@ -139,8 +237,9 @@ struct SplitReductionPass : public SplitReductionBase<SplitReductionPass> {
 
 } // namespace
 
-std::unique_ptr<Pass> createSplitReductionPass() {
-  return std::make_unique<SplitReductionPass>();
+std::unique_ptr<Pass>
+createSplitReductionPass(SplitReductionOptions options) {
+  return std::make_unique<SplitReductionPass>(options);
 }
 
 } // namespace Flow
@@ -0,0 +1,127 @@
+// RUN: iree-opt --split-input-file --iree-flow-deduplicate-executables="parameterize-constants=true" %s | FileCheck %s
+
+// CHECK-LABEL: flow.executable public @scaled_ex_0
+flow.executable @scaled_ex_0 {
+  flow.executable.export @scaled_entry_0
+  builtin.module {
+    // CHECK: func.func @scaled_entry_0(%[[ARG0:.+]]: tensor<4xf32>, %[[SCALE:.+]]: f32) -> tensor<4xf32>
+    func.func @scaled_entry_0(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      // CHECK-NOT: arith.constant
+      %cst = arith.constant 2.0 : f32
+      %0 = tensor.empty() : tensor<4xf32>
+      // CHECK: linalg.generic
+      %1 = linalg.generic {
+          indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+          iterator_types = ["parallel"]}
+          ins(%arg0 : tensor<4xf32>) outs(%0 : tensor<4xf32>) {
+      ^bb0(%in: f32, %out: f32):
+        // CHECK: arith.mulf %{{.+}}, %[[SCALE]] : f32
+        %2 = arith.mulf %in, %cst : f32
+        linalg.yield %2 : f32
+      } -> tensor<4xf32>
+      return %1 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-NOT: flow.executable public @scaled_ex_1
+flow.executable @scaled_ex_1 {
+  flow.executable.export @scaled_entry_1
+  builtin.module {
+    func.func @scaled_entry_1(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %cst = arith.constant 3.0 : f32
+      %0 = tensor.empty() : tensor<4xf32>
+      %1 = linalg.generic {
+          indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+          iterator_types = ["parallel"]}
+          ins(%arg0 : tensor<4xf32>) outs(%0 : tensor<4xf32>) {
+      ^bb0(%in: f32, %out: f32):
+        %2 = arith.mulf %in, %cst : f32
+        linalg.yield %2 : f32
+      } -> tensor<4xf32>
+      return %1 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: func.func @scaled
+func.func @scaled(%arg0: tensor<4xf32>) -> (tensor<4xf32>, tensor<4xf32>) {
+  %c4 = arith.constant 4 : index
+  // CHECK-DAG: %[[CST2:.+]] = arith.constant 2.000000e+00 : f32
+  // CHECK: %[[RESULT0:.+]] = flow.dispatch @scaled_ex_0::@scaled_entry_0[%c4](%arg0, %[[CST2]]) : (tensor<4xf32>, f32) -> tensor<4xf32>
+  %0 = flow.dispatch @scaled_ex_0::@scaled_entry_0[%c4] (%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  // CHECK-DAG: %[[CST3:.+]] = arith.constant 3.000000e+00 : f32
+  // CHECK: %[[RESULT1:.+]] = flow.dispatch @scaled_ex_0::@scaled_entry_0[%c4](%arg0, %[[CST3]]) : (tensor<4xf32>, f32) -> tensor<4xf32>
+  %1 = flow.dispatch @scaled_ex_1::@scaled_entry_1[%c4] (%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  return %0, %1 : tensor<4xf32>, tensor<4xf32>
+}
+
+// -----
+
+// Index constants are left alone as they are expected to define shapes.
+
+// CHECK-LABEL: flow.executable public @index_ex_0
+flow.executable @index_ex_0 {
+  flow.executable.export @index_entry_0
+  builtin.module {
+    func.func @index_entry_0(%arg0: tensor<4xf32>) -> f32 {
+      %c0 = arith.constant 0 : index
+      %0 = tensor.extract %arg0[%c0] : tensor<4xf32>
+      return %0 : f32
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @index_ex_1
+flow.executable @index_ex_1 {
+  flow.executable.export @index_entry_1
+  builtin.module {
+    func.func @index_entry_1(%arg0: tensor<4xf32>) -> f32 {
+      %c1 = arith.constant 1 : index
+      %0 = tensor.extract %arg0[%c1] : tensor<4xf32>
+      return %0 : f32
+    }
+  }
+}
+// CHECK-LABEL: func.func @index
+func.func @index(%arg0: tensor<4xf32>) -> (f32, f32) {
+  %c4 = arith.constant 4 : index
+  // CHECK: flow.dispatch @index_ex_0::@index_entry_0[%c4](%arg0)
+  %0 = flow.dispatch @index_ex_0::@index_entry_0[%c4] (%arg0) : (tensor<4xf32>) -> f32
+  // CHECK: flow.dispatch @index_ex_1::@index_entry_1[%c4](%arg0)
+  %1 = flow.dispatch @index_ex_1::@index_entry_1[%c4] (%arg0) : (tensor<4xf32>) -> f32
+  return %0, %1 : f32, f32
+}
+
+// -----
+
+// Float constants that feed ops other than elementwise math are left alone.
+
+// CHECK-LABEL: flow.executable public @fill_ex_0
+flow.executable @fill_ex_0 {
+  flow.executable.export @fill_entry_0
+  builtin.module {
+    func.func @fill_entry_0() -> tensor<4xf32> {
+      %cst = arith.constant 2.0 : f32
+      %0 = tensor.splat %cst : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @fill_ex_1
+flow.executable @fill_ex_1 {
+  flow.executable.export @fill_entry_1
+  builtin.module {
+    func.func @fill_entry_1() -> tensor<4xf32> {
+      %cst = arith.constant 3.0 : f32
+      %0 = tensor.splat %cst : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: func.func @fill
+func.func @fill() -> (tensor<4xf32>, tensor<4xf32>) {
+  %c4 = arith.constant 4 : index
+  // CHECK: flow.dispatch @fill_ex_0::@fill_entry_0[%c4]()
+  %0 = flow.dispatch @fill_ex_0::@fill_entry_0[%c4] () : () -> tensor<4xf32>
+  // CHECK: flow.dispatch @fill_ex_1::@fill_entry_1[%c4]()
+  %1 = flow.dispatch @fill_ex_1::@fill_entry_1[%c4] () : () -> tensor<4xf32>
+  return %0, %1 : tensor<4xf32>, tensor<4xf32>
+}
@@ -1,4 +1,5 @@
 // RUN: iree-opt --iree-flow-raise-special-ops -canonicalize --split-input-file %s | FileCheck %s
+// RUN: iree-opt --iree-flow-raise-special-ops='raise-attention' -canonicalize --split-input-file %s | FileCheck %s --check-prefix=ATTN
 
 // CHECK-LABEL: @softmax
 //  CHECK-SAME: %[[ARG:.+]]: tensor<?x?x?xf32>
@@ -189,6 +190,80 @@ func.func @aTransposeBMatmul(%arg0 : tensor<10x20xf32>,
 
 // -----
 
+func.func @attention(%query : tensor<12x128x64xf32>,
+    %key : tensor<12x256x64xf32>, %value : tensor<12x256x64xf32>) -> tensor<12x128x64xf32> {
+  %zero = arith.constant 0.0 : f32
+  %scale = arith.constant 0.125 : f32
+  %0 = tensor.empty() : tensor<12x64x256xf32>
+  %1 = linalg.transpose ins(%key : tensor<12x256x64xf32>)
+      outs(%0 : tensor<12x64x256xf32>) permutation = [0, 2, 1]
+  %2 = tensor.empty() : tensor<12x128x256xf32>
+  %3 = linalg.fill ins(%zero : f32) outs(%2 : tensor<12x128x256xf32>) -> tensor<12x128x256xf32>
+  %4 = linalg.batch_matmul ins(%query, %1 : tensor<12x128x64xf32>, tensor<12x64x256xf32>)
+      outs(%3 : tensor<12x128x256xf32>) -> tensor<12x128x256xf32>
+  %5 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d1, d2)>, affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+      iterator_types = ["parallel", "parallel", "parallel"]}
+      ins(%4 : tensor<12x128x256xf32>) outs(%2 : tensor<12x128x256xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %10 = arith.mulf %b0, %scale : f32
+      linalg.yield %10 : f32
+  } -> tensor<12x128x256xf32>
+  %6 = iree_linalg_ext.softmax dimension(2) ins(%5 : tensor<12x128x256xf32>)
+      outs(%2 : tensor<12x128x256xf32>) -> tensor<12x128x256xf32>
+  %7 = tensor.empty() : tensor<12x128x64xf32>
+  %8 = linalg.fill ins(%zero : f32) outs(%7 : tensor<12x128x64xf32>) -> tensor<12x128x64xf32>
+  %9 = linalg.batch_matmul ins(%6, %value : tensor<12x128x256xf32>, tensor<12x256x64xf32>)
+      outs(%8 : tensor<12x128x64xf32>) -> tensor<12x128x64xf32>
+  return %9 : tensor<12x128x64xf32>
+}
+// CHECK-LABEL: func @attention(
+//   CHECK-NOT:   iree_linalg_ext.attention
+//       CHECK:   linalg.batch_matmul
+
+// ATTN-LABEL: func @attention(
+//  ATTN-SAME:     %[[QUERY:[a-zA-Z0-9]+]]: tensor<12x128x64xf32>
+//  ATTN-SAME:     %[[KEY:[a-zA-Z0-9]+]]: tensor<12x256x64xf32>
+//  ATTN-SAME:     %[[VALUE:[a-zA-Z0-9]+]]: tensor<12x256x64xf32>
+//   ATTN-DAG:   %[[SCALE:.+]] = arith.constant {{.+}} : f32
+//   ATTN-DAG:   %[[EMPTY:.+]] = tensor.empty() : tensor<12x128x64xf32>
+//       ATTN:   %[[SCALED_QUERY:.+]] = linalg.generic
+//  ATTN-SAME:       ins(%[[QUERY]] :
+//       ATTN:     arith.mulf %{{.+}}, %[[SCALE]]
+//       ATTN:   %[[RESULT:.+]] = iree_linalg_ext.attention
+//  ATTN-SAME:       ins(%[[SCALED_QUERY]], %[[KEY]], %[[VALUE]] :
+//  ATTN-SAME:       outs(%[[EMPTY]] :
+//   ATTN-NOT:   linalg.batch_matmul
+//       ATTN:   return %[[RESULT]]
+
+// -----
+
+// Check that attention is not raised when the scores have other uses.
+func.func @attention_multiple_uses(%query : tensor<12x128x64xf32>,
+    %key : tensor<12x128x64xf32>, %value : tensor<12x128x64xf32>)
+    -> (tensor<12x128x64xf32>, tensor<12x128x128xf32>) {
+  %zero = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<12x64x128xf32>
+  %1 = linalg.transpose ins(%key : tensor<12x128x64xf32>)
+      outs(%0 : tensor<12x64x128xf32>) permutation = [0, 2, 1]
+  %2 = tensor.empty() : tensor<12x128x128xf32>
+  %3 = linalg.fill ins(%zero : f32) outs(%2 : tensor<12x128x128xf32>) -> tensor<12x128x128xf32>
+  %4 = linalg.batch_matmul ins(%query, %1 : tensor<12x128x64xf32>, tensor<12x64x128xf32>)
+      outs(%3 : tensor<12x128x128xf32>) -> tensor<12x128x128xf32>
+  %5 = iree_linalg_ext.softmax dimension(2) ins(%4 : tensor<12x128x128xf32>)
+      outs(%2 : tensor<12x128x128xf32>) -> tensor<12x128x128xf32>
+  %6 = tensor.empty() : tensor<12x128x64xf32>
+  %7 = linalg.fill ins(%zero : f32) outs(%6 : tensor<12x128x64xf32>) -> tensor<12x128x64xf32>
+  %8 = linalg.batch_matmul ins(%5, %value : tensor<12x128x128xf32>, tensor<12x128x64xf32>)
+      outs(%7 : tensor<12x128x64xf32>) -> tensor<12x128x64xf32>
+  return %8, %4 : tensor<12x128x64xf32>, tensor<12x128x128xf32>
+}
+// ATTN-LABEL: func @attention_multiple_uses
+//   ATTN-NOT:   iree_linalg_ext.attention
+//       ATTN:   iree_linalg_ext.softmax
+
+// -----
+
 #map = affine_map<(d0) -> (d0)>
 func.func @test(%A : tensor<1x1x5120xf32>, %B : tensor<5120xf32>) -> tensor<5120xf32> {
   %c0 = arith.constant 0 : index
@@ -0,0 +1,96 @@
+// RUN: iree-opt --split-input-file --iree-flow-split-reduction-ops %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-flow-split-reduction-ops --iree-flow-split-matmul-reduction-allow-float-reassociation %s | FileCheck %s --check-prefix=FLOAT
+// RUN: iree-opt --split-input-file --iree-flow-split-reduction-ops="cpu-number-of-threads=4" %s | FileCheck %s --check-prefix=THREADS4
+// RUN: iree-opt --split-input-file --iree-flow-split-reduction-ops="cpu-number-of-threads=0" %s | FileCheck %s --check-prefix=DISABLED
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  func.func @matvec(%lhs : tensor<1x4096xi32>, %rhs : tensor<4096x64xi32>,
+                    %init : tensor<1x64xi32>) -> tensor<1x64xi32> {
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x4096xi32>, tensor<4096x64xi32>)
+        outs(%init : tensor<1x64xi32>) -> tensor<1x64xi32>
+    return %0 : tensor<1x64xi32>
+  }
+}
+// CHECK-LABEL: func.func @matvec(
+//   CHECK-DAG:   %[[LHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<1x4096xi32> into tensor<1x16x256xi32>
+//   CHECK-DAG:   %[[RHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0, 1], [2]] : tensor<4096x64xi32> into tensor<16x256x64xi32>
+//       CHECK:   %[[PARTIAL:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[LHS]], %[[RHS]] :
+//  CHECK-SAME:       -> tensor<16x1x64xi32>
+//       CHECK:   %[[RESULT:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[PARTIAL]] : tensor<16x1x64xi32>)
+//       CHECK:   return %[[RESULT]]
+
+// Fewer workers need fewer splits to be occupied.
+// THREADS4-LABEL: func.func @matvec(
+//       THREADS4:   tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<1x4096xi32> into tensor<1x8x512xi32>
+
+// DISABLED-LABEL: func.func @matvec(
+//   DISABLED-NOT:   tensor.expand_shape
+//       DISABLED:   linalg.matmul
+
+// -----
+
+// Float matmuls are only split when reassociation is allowed.
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  func.func @matvec_f32(%lhs : tensor<1x4096xf32>, %rhs : tensor<4096x64xf32>,
+                        %init : tensor<1x64xf32>) -> tensor<1x64xf32> {
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x4096xf32>, tensor<4096x64xf32>)
+        outs(%init : tensor<1x64xf32>) -> tensor<1x64xf32>
+    return %0 : tensor<1x64xf32>
+  }
+}
+// FLOAT-LABEL: func.func @matvec_f32(
+//   FLOAT-DAG:   %[[LHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] : tensor<1x4096xf32> into tensor<1x16x256xf32>
+//   FLOAT-DAG:   %[[RHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0, 1], [2]] : tensor<4096x64xf32> into tensor<16x256x64xf32>
+//       FLOAT:   %[[PARTIAL:.+]] = linalg.generic
+//  FLOAT-SAME:       ins(%[[LHS]], %[[RHS]] :
+//  FLOAT-SAME:       -> tensor<16x1x64xf32>
+//       FLOAT:   %[[RESULT:.+]] = linalg.generic
+//  FLOAT-SAME:       ins(%[[PARTIAL]] : tensor<16x1x64xf32>)
+//       FLOAT:   return %[[RESULT]]
+
+// CHECK-LABEL: func.func @matvec_f32(
+//   CHECK-NOT:   tensor.expand_shape
+//       CHECK:   linalg.matmul
+
+// -----
+
+// Matmuls with enough parallel workgroups are not split.
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  func.func @matmul(%lhs : tensor<512x4096xi32>, %rhs : tensor<4096x512xi32>,
+                    %init : tensor<512x512xi32>) -> tensor<512x512xi32> {
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<512x4096xi32>, tensor<4096x512xi32>)
+        outs(%init : tensor<512x512xi32>) -> tensor<512x512xi32>
+    return %0 : tensor<512x512xi32>
+  }
+}
+// CHECK-LABEL: func.func @matmul(
+//   CHECK-NOT:   tensor.expand_shape
+//       CHECK:   linalg.matmul
+
+// -----
+
+// Non-CPU targets are left alone.
+
+#executable_target_vulkan = #hal.executable.target<"vulkan", "vulkan-spirv-fb">
+#device_target_vulkan = #hal.device.target<"vulkan", {executable_targets = [#executable_target_vulkan]}>
+module attributes {hal.device.targets = [#device_target_vulkan]} {
+  func.func @matvec_vulkan(%lhs : tensor<1x4096xi32>, %rhs : tensor<4096x64xi32>,
+                           %init : tensor<1x64xi32>) -> tensor<1x64xi32> {
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x4096xi32>, tensor<4096x64xi32>)
+        outs(%init : tensor<1x64xi32>) -> tensor<1x64xi32>
+    return %0 : tensor<1x64xi32>
+  }
+}
+// CHECK-LABEL: func.func @matvec_vulkan(
+//   CHECK-NOT:   tensor.expand_shape
+//       CHECK:   linalg.matmul
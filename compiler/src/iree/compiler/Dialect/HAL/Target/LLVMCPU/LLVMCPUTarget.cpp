@@ -24,6 +24,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVMLinkerUtils.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Utils/ModuleUtils.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -370,6 +371,40 @@ public:
                                     .value_or(APInt(64, 0))
                                     .getSExtValue();
 
+      // Entry points may also hint the order in which workgroups should be
+      // distributed to workers so that neighboring workgroups sharing operand
+      // tiles run close together in time. The runtime may ignore the hint.
+      LibraryBuilder::DispatchAttrs dispatchAttrs;
+      dispatchAttrs.localMemorySize = localMemorySize;
+      if (auto orderAttr = exportOp->getAttrOfType<StringAttr>(
+              "hal.executable.workgroup_order")) {
+        auto workgroupOrder =
+            llvm::StringSwitch<std::optional<LibraryBuilder::WorkgroupOrder>>(
+                orderAttr.getValue())
+                .Case("linear", LibraryBuilder::WorkgroupOrder::LINEAR)
+                .Case("column_major",
+                      LibraryBuilder::WorkgroupOrder::COLUMN_MAJOR)
+                .Case("morton", LibraryBuilder::WorkgroupOrder::MORTON)
+                .Case("grouped", LibraryBuilder::WorkgroupOrder::GROUPED)
+                .Default(std::nullopt);
+        if (!workgroupOrder) {
+          return exportOp.emitOpError()
+                 << "unsupported workgroup order " << orderAttr;
+        }
+        dispatchAttrs.workgroupOrder = *workgroupOrder;
+      }
+      if (auto groupSizeAttr = exportOp->getAttrOfType<IntegerAttr>(
+              "hal.executable.workgroup_order_group_size")) {
+        int64_t groupSize = groupSizeAttr.getInt();
+        if (groupSize < 0 || groupSize > UINT8_MAX) {
+          return exportOp.emitOpError()
+                 << "workgroup order group size " << groupSize
+                 << " out of range [0, " << UINT8_MAX << "]";
+        }
+        dispatchAttrs.workgroupOrderGroupSize =
+            static_cast<uint8_t>(groupSize);
+      }
+
       std::string sourceFile = "";
       int sourceLine = 0;
       if (options.debugLevel >= 1) {
@@ -379,8 +414,8 @@ public:
         }
       }
       libraryBuilder.addExport(
-          exportOp.getName(), sourceFile, sourceLine, /*tag=*/"",
-          LibraryBuilder::DispatchAttrs{localMemorySize}, llvmFunc);
+          exportOp.getName(), sourceFile, sourceLine, /*tag=*/"", dispatchAttrs,
+          llvmFunc);
     }
 
     auto queryFunctionName = std::string(kQueryFunctionName);
@@ -114,19 +114,22 @@ makeDispatchFunctionType(llvm::LLVMContext &context) {
 
 // %struct.iree_hal_executable_dispatch_attrs_v0_t = type {
 //   i16,
-//   i16
+//   i8,
+//   i8
 // }
 static llvm::StructType *makeDispatchAttrsType(llvm::LLVMContext &context) {
   if (auto *existingType = llvm::StructType::getTypeByName(
           context, "iree_hal_executable_dispatch_attrs_v0_t")) {
     return existingType;
   }
+  auto *i8Type = llvm::IntegerType::getInt8Ty(context);
   auto *i16Type = llvm::IntegerType::getInt16Ty(context);
   auto *type =
       llvm::StructType::create(context,
                                {
                                    i16Type,
-                                   i16Type,
+                                   i8Type,
+                                   i8Type,
                                },
                                "iree_hal_executable_dispatch_attrs_v0_t",
                                /*isPacked=*/false);
@@ -398,7 +401,7 @@ LibraryBuilder::buildLibraryV0ExportTable(std::string libraryName) {
       llvm::find_if(exports, [](const Dispatch &dispatch) {
         return !dispatch.attrs.isDefault();
       }) != exports.end();
-  if (!hasNonDefaultAttrs) {
+  if (hasNonDefaultAttrs) {
     SmallVector<llvm::Constant *> exportAttrValues;
     for (auto dispatch : exports) {
       exportAttrValues.push_back(llvm::ConstantStruct::get(
@@ -409,8 +412,12 @@ LibraryBuilder::buildLibraryV0ExportTable(std::string libraryName) {
                   i16Type, RoundUpToAlignment(dispatch.attrs.localMemorySize,
                                               kWorkgroupLocalMemoryPageSize) /
                                kWorkgroupLocalMemoryPageSize),
-              // reserved=
-              llvm::ConstantInt::get(i16Type, 0),
+              // workgroup_order=
+              llvm::ConstantInt::get(
+                  i8Type, static_cast<uint8_t>(dispatch.attrs.workgroupOrder)),
+              // workgroup_order_group_size=
+              llvm::ConstantInt::get(i8Type,
+                                     dispatch.attrs.workgroupOrderGroupSize),
           }));
     }
     auto *exportAttrsType =
@@ -78,13 +78,32 @@ public:
   // IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
   static const int64_t kWorkgroupLocalMemoryPageSize = 4096;
 
+  // iree_hal_executable_workgroup_order_v0_t
+  enum class WorkgroupOrder : uint8_t {
+    // IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_LINEAR
+    LINEAR = 0u,
+    // IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_COLUMN_MAJOR
+    COLUMN_MAJOR = 1u,
+    // IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_MORTON
+    MORTON = 2u,
+    // IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_GROUPED
+    GROUPED = 3u,
+  };
+
   // iree_hal_executable_dispatch_attrs_v0_t
   struct DispatchAttrs {
     // Required workgroup local memory size, in bytes.
     int64_t localMemorySize = 0;
+    // Preferred order in which workgroups are distributed to workers.
+    WorkgroupOrder workgroupOrder = WorkgroupOrder::LINEAR;
+    // Rows per band when using WorkgroupOrder::GROUPED; 0 for the default.
+    uint8_t workgroupOrderGroupSize = 0;
 
     // True if all values are default and the attributes may be omitted.
-    constexpr bool isDefault() const { return localMemorySize == 0; }
+    constexpr bool isDefault() const {
+      return localMemorySize == 0 && workgroupOrder == WorkgroupOrder::LINEAR &&
+             workgroupOrderGroupSize == 0;
+    }
   };
 
   LibraryBuilder(llvm::Module *module, Mode mode,
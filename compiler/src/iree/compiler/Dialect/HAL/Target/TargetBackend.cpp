@@ -82,6 +82,13 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<bool>(
+      "iree-hal-lazy-executable-loading", lazyExecutableLoading,
+      llvm::cl::desc("Creates executables on first use instead of during "
+                     "module initialization. Reduces time-to-first-inference "
+                     "for programs with many executables."),
+      llvm::cl::init(false), llvm::cl::cat(halTargetOptionsCategory));
 }
 
 void dumpDataToPath(StringRef path, StringRef baseName, StringRef suffix,
@@ -56,6 +56,10 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // Defers creation of executables until their first use instead of creating
+  // all of them during module initialization.
+  bool lazyExecutableLoading = false;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
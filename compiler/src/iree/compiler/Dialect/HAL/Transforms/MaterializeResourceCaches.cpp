@@ -206,6 +206,10 @@ private:
     auto loc = executableOp.getLoc();
     auto symbolName =
         (StringRef("_executable_") + executableOp.getSymName()).str();
+    if (targetOptions_.lazyExecutableLoading) {
+      defineLazyExecutableOp(executableOp, symbolName);
+      return;
+    }
 
     auto executableType = ExecutableType::get(executableOp.getContext());
     auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
@@ -216,6 +220,66 @@ private:
     auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
     OpBuilder blockBuilder =
         OpBuilder::atBlockEnd(initializerOp.addEntryBlock());
+    auto executableValue = buildExecutableCreate(executableOp, blockBuilder);
+    blockBuilder.create<IREE::Util::GlobalStoreOp>(loc, executableValue,
+                                                   globalOp.getName());
+    blockBuilder.create<IREE::Util::InitializerReturnOp>(loc);
+  }
+
+  // Defines a mutable global for the executable that starts as null and a
+  // function that creates and caches the executable on its first call. Lookups
+  // are replaced with calls to the function so that executables that are never
+  // used are never loaded and loading is spread across the first invocations
+  // instead of all happening during module initialization.
+  void defineLazyExecutableOp(ExecutableOp executableOp,
+                              StringRef symbolName) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
+    auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+        loc, symbolName, /*isMutable=*/true, executableType);
+    globalOp.setPrivate();
+
+    auto funcOp = moduleBuilder.create<func::FuncOp>(
+        loc, (StringRef("__lookup") + symbolName).str(),
+        moduleBuilder.getFunctionType({}, {executableType}));
+    funcOp.setPrivate();
+    lazyExecutableCache_.try_emplace(executableOp.getSymName(), funcOp);
+
+    // ^entry: return the cached executable if already created.
+    auto *entryBlock = funcOp.addEntryBlock();
+    auto *createBlock = funcOp.addBlock();
+    auto *returnBlock = funcOp.addBlock();
+    returnBlock->addArgument(executableType, loc);
+    auto entryBuilder = OpBuilder::atBlockEnd(entryBlock);
+    auto cachedValue = entryBuilder.create<IREE::Util::GlobalLoadOp>(
+        loc, executableType, globalOp.getSymName());
+    auto nullValue =
+        entryBuilder.create<IREE::Util::NullOp>(loc, executableType);
+    auto isNull =
+        entryBuilder.create<IREE::Util::CmpEQOp>(loc, cachedValue, nullValue);
+    entryBuilder.create<cf::CondBranchOp>(loc, isNull, createBlock,
+                                          ValueRange{}, returnBlock,
+                                          ValueRange{cachedValue});
+
+    // ^create: create the executable and cache it for future lookups.
+    auto createBuilder = OpBuilder::atBlockEnd(createBlock);
+    auto executableValue = buildExecutableCreate(executableOp, createBuilder);
+    createBuilder.create<IREE::Util::GlobalStoreOp>(loc, executableValue,
+                                                    globalOp.getName());
+    createBuilder.create<cf::BranchOp>(loc, returnBlock,
+                                       ValueRange{executableValue});
+
+    // ^return:
+    auto returnBuilder = OpBuilder::atBlockEnd(returnBlock);
+    returnBuilder.create<func::ReturnOp>(loc, returnBlock->getArgument(0));
+  }
+
+  // Builds a device switch creating the executable variant matching the
+  // device (or null if none match) and returns the resulting executable.
+  Value buildExecutableCreate(ExecutableOp executableOp,
+                              OpBuilder &blockBuilder) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
     auto deviceValue = blockBuilder.createOrFold<ExSharedDeviceOp>(loc);
 
     // Create a switch statement with a case for each variant.
@@ -275,10 +339,7 @@ private:
     defaultBuilder.create<IREE::HAL::ReturnOp>(loc, nullValue);
 
     auto switchOp = switchBuilder.build();
-    auto executableValue = switchOp.getResult(0);
-    blockBuilder.create<IREE::Util::GlobalStoreOp>(loc, executableValue,
-                                                   globalOp.getName());
-    blockBuilder.create<IREE::Util::InitializerReturnOp>(loc);
+    return switchOp.getResult(0);
   }
 
   // Inlines a constant block as a function in |moduleBuilder| and then inserts
@@ -341,6 +402,14 @@ private:
 
   void replaceExecutableLookupOp(ExecutableLookupOp &lookupOp) {
     OpBuilder builder(lookupOp);
+    auto lazyIt = lazyExecutableCache_.find(lookupOp.getExecutable());
+    if (lazyIt != lazyExecutableCache_.end()) {
+      auto callOp = builder.create<func::CallOp>(lookupOp.getLoc(),
+                                                 lazyIt->second, ValueRange{});
+      lookupOp.replaceAllUsesWith(callOp.getResult(0));
+      lookupOp.erase();
+      return;
+    }
     auto executableIt = executableCache_.find(lookupOp.getExecutable());
     assert(executableIt != executableCache_.end() &&
            "executable must have been cached");
@@ -358,6 +427,7 @@ private:
   DenseMap<Attribute, IREE::Util::GlobalOp> descriptorSetLayoutCache_;
   DenseMap<Attribute, IREE::Util::GlobalOp> pipelineLayoutCache_;
   DenseMap<StringRef, IREE::Util::GlobalOp> executableCache_;
+  DenseMap<StringRef, func::FuncOp> lazyExecutableCache_;
 
   int nextUniqueConstantBlockId = 0;
   int nextUniquePipelineLayoutId = 0;
@@ -0,0 +1,54 @@
+// RUN: iree-opt --split-input-file --iree-hal-materialize-resource-caches --iree-hal-lazy-executable-loading %s | FileCheck %s
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+
+module attributes {hal.device.targets = [#hal.device.target<"llvm-cpu">]} {
+
+hal.executable @exe {
+  hal.executable.variant @vmvx, target = <"vmvx", "vmvx-bytecode-fb"> {
+    hal.executable.export @entry0 ordinal(0) layout(#pipeline_layout) attributes {
+      workgroup_size = [32 : index, 1 : index, 1 : index]
+    }
+  }
+}
+
+// CHECK: util.global private @_pipeline_layout_0 : !hal.pipeline_layout
+
+// Executables start out null and are not created by an initializer:
+// CHECK: util.global private mutable @_executable_exe : !hal.executable
+// CHECK-NOT: util.initializer
+
+// CHECK: func.func private @__lookup_executable_exe() -> !hal.executable
+// CHECK:   %[[CACHED:.+]] = util.global.load @_executable_exe : !hal.executable
+// CHECK:   %[[NULL:.+]] = util.null : !hal.executable
+// CHECK:   %[[IS_NULL:.+]] = util.cmp.eq %[[CACHED]], %[[NULL]] : !hal.executable
+// CHECK:   cf.cond_br %[[IS_NULL]], ^bb1, ^bb2(%[[CACHED]] : !hal.executable)
+// CHECK: ^bb1:
+// CHECK:   %[[DEVICE:.+]] = hal.ex.shared_device : !hal.device
+// CHECK:   %[[CREATED:.+]] = hal.device.switch<%[[DEVICE]] : !hal.device> -> !hal.executable
+// CHECK:     %[[LAYOUT:.+]] = util.global.load @_pipeline_layout_0 : !hal.pipeline_layout
+// CHECK:     %[[EXE:.+]] = hal.executable.create
+// CHECK-SAME:  device(%[[DEVICE]] : !hal.device)
+// CHECK-SAME:  target(@exe::@vmvx)
+// CHECK-SAME:  layouts([%[[LAYOUT]]])
+// CHECK:     hal.return %[[EXE]] : !hal.executable
+// CHECK:   util.global.store %[[CREATED]], @_executable_exe : !hal.executable
+// CHECK:   cf.br ^bb2(%[[CREATED]] : !hal.executable)
+// CHECK: ^bb2(%[[RESULT:.+]]: !hal.executable):
+// CHECK:   return %[[RESULT]] : !hal.executable
+
+// CHECK-LABEL: @exeLookup
+func.func @exeLookup(%device : !hal.device) -> !hal.executable {
+  // CHECK: %[[EXE:.+]] = call @__lookup_executable_exe() : () -> !hal.executable
+  %0 = hal.executable.lookup device(%device : !hal.device)
+                             executable(@exe) : !hal.executable
+  // CHECK-NEXT: return %[[EXE]]
+  return %0 : !hal.executable
+}
+
+}
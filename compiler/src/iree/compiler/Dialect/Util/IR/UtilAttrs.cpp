@@ -655,6 +655,27 @@ LogicalResult CompositeAttr::serializeToStream(Location loc,
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr utilities
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+// TODO: Just use the DenseResourceElementsAttr::get()
+// builder once https://reviews.llvm.org/D157064 lands.
+class DenseBlobResourceElementsAttr : public DenseResourceElementsAttr {
+public:
+  using DenseResourceElementsAttr::get;
+};
+
+} // namespace
+
+DenseResourceElementsAttr getDenseResourceElementsAttr(ShapedType type,
+                                                       StringRef blobName,
+                                                       AsmResourceBlob blob) {
+  return DenseBlobResourceElementsAttr::get(type, blobName, std::move(blob));
+}
+
 //===----------------------------------------------------------------------===//
 // SerializableAttrInterface implementations
 //===----------------------------------------------------------------------===//
@@ -757,8 +778,27 @@ struct SerializableDenseResourceElementsAttrModel
       return success();
     }
 
+    // Blobs store elements in the native byte-aligned layout (as produced by
+    // consteval and resource import) and can be written out verbatim.
+    if (AsmResourceBlob *blob = handle.getBlob()) {
+      ArrayRef<char> data = blob->getData();
+      if (data.size() != static_cast<size_t>(getStorageSize(baseAttr))) {
+        return mlir::emitError(loc)
+               << "DenseResourceElementsAttr blob size " << data.size()
+               << " does not match the expected storage size "
+               << getStorageSize(baseAttr);
+      }
+      if (endian != llvm::support::endian::system_endianness()) {
+        return mlir::emitError(loc)
+               << "DenseResourceElementsAttr serialization to a non-native "
+                  "endianness is not supported";
+      }
+      os.write(data.data(), data.size());
+      return success();
+    }
+
     return mlir::emitError(loc)
-           << "DenseResourceElementsAttr not yet supported for serialization";
+           << "DenseResourceElementsAttr has no blob data to serialize";
   }
 };
 
@@ -10,7 +10,9 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Endian.h"
+#include "mlir/IR/AsmState.h"
 #include "mlir/IR/Attributes.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Location.h"
@@ -281,6 +283,17 @@ static inline int64_t getRoundedPhysicalStorageSize(ShapedType type) {
                                        type.getElementType());
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr utilities
+//===----------------------------------------------------------------------===//
+
+// Returns a DenseResourceElementsAttr of |type| whose contents are |blob|.
+// The blob is registered with the builtin dialect resource manager under
+// |blobName|, which is uniqued if already in use.
+DenseResourceElementsAttr getDenseResourceElementsAttr(ShapedType type,
+                                                       StringRef blobName,
+                                                       AsmResourceBlob blob);
+
 } // namespace Util
 } // namespace IREE
 } // namespace iree_compiler
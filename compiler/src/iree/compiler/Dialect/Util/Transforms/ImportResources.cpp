@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Dialect/Util/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Util/Transforms/Passes.h"
 #include "llvm/ADT/DenseMap.h"
@@ -20,13 +21,6 @@ namespace mlir::iree_compiler::IREE::Util {
 
 namespace {
 
-// TODO: Just use the DenseResourceElementsAttr::get()
-// builder once https://reviews.llvm.org/D157064 lands.
-class DenseBlobResourceElementsAttr : public DenseResourceElementsAttr {
-public:
-  using DenseResourceElementsAttr::get;
-};
-
 template <typename ElementType, unsigned numBits = sizeof(ElementType) * 8>
 static void copyIntAttrIntoBlob(AsmResourceBlob &blob,
                                 DenseIntElementsAttr attr) {
@@ -133,32 +127,32 @@ public:
         blob = HeapAsmResourceBlob::allocate(numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyIntAttrIntoBlob<uint8_t, /*numBits=*/1>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_i1",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_i1",
+                                            std::move(blob));
       case 8:
         blob = HeapAsmResourceBlob::allocate(numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyIntAttrIntoBlob<uint8_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_i8",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_i8",
+                                            std::move(blob));
       case 16:
         blob = HeapAsmResourceBlob::allocate(2 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyIntAttrIntoBlob<uint16_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_i16",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_i16",
+                                            std::move(blob));
       case 32:
         blob = HeapAsmResourceBlob::allocate(4 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyIntAttrIntoBlob<uint32_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_i32",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_i32",
+                                            std::move(blob));
       case 64:
         blob = HeapAsmResourceBlob::allocate(8 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyIntAttrIntoBlob<uint64_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_i64",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_i64",
+                                            std::move(blob));
       default:
         return {};
       }
@@ -169,26 +163,26 @@ public:
         blob = HeapAsmResourceBlob::allocate(numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyFPAttrIntoBlob<uint8_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_f8",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_f8",
+                                            std::move(blob));
       case 16:
         blob = HeapAsmResourceBlob::allocate(2 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyFPAttrIntoBlob<uint16_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_f16",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_f16",
+                                            std::move(blob));
       case 32:
         blob = HeapAsmResourceBlob::allocate(4 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyFPAttrIntoBlob<uint32_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_f32",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_f32",
+                                            std::move(blob));
       case 64:
         blob = HeapAsmResourceBlob::allocate(8 * numElements, /*align=*/64,
                                              /*dataIsMutable=*/true);
         copyFPAttrIntoBlob<uint64_t>(blob, attr);
-        return DenseBlobResourceElementsAttr::get(st, "dense_elements_f64",
-                                                  std::move(blob));
+        return getDenseResourceElementsAttr(st, "dense_elements_f64",
+                                            std::move(blob));
       default:
         return {};
       }
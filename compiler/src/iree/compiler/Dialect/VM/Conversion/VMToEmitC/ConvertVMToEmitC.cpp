@@ -672,6 +672,7 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
   {
     OpBuilder::InsertionGuard guard(builder);
 
+    const int moduleArgIndex = 0;
     const int allocatorArgIndex = 1;
     const int moduleStateArgIndex = 2;
 
@@ -693,6 +694,7 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
 
     Block *entryBlock = funcOp.addEntryBlock();
 
+    const BlockArgument moduleArg = funcOp.getArgument(moduleArgIndex);
     const BlockArgument allocatorArg = funcOp.getArgument(allocatorArgIndex);
     const BlockArgument moduleStateArg =
         funcOp.getArgument(moduleStateArgIndex);
@@ -730,6 +732,18 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
                                           /*operand=*/state,
                                           /*value=*/allocatorArg);
 
+    // Keep a pointer back to the module so that direct entry points, which
+    // are only handed the module state, can pass it to the implementation.
+    auto moduleCasted = builder.create<emitc::CastOp>(
+        /*location=*/loc,
+        /*type=*/
+        emitc::PointerType::get(emitc::OpaqueType::get(ctx, moduleName + "_t")),
+        /*operand=*/moduleArg);
+    emitc_builders::structPtrMemberAssign(builder, loc,
+                                          /*memberName=*/"module",
+                                          /*operand=*/state,
+                                          /*value=*/moduleCasted.getResult());
+
     // Initialize buffers
     for (auto rodataOp : moduleOp.getOps<IREE::VM::RodataOp>()) {
       auto ordinal = rodataOp.getOrdinal()->getZExtValue();
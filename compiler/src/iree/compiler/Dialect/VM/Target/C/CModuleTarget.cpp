@@ -14,6 +14,7 @@
 #include "iree/compiler/Dialect/VM/Conversion/VMToEmitC/DropExcludedExports.h"
 #include "iree/compiler/Dialect/VM/Target/C/CppEmitter.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
@@ -127,6 +128,7 @@ static LogicalResult printStructDefinitions(IREE::VM::ModuleOp &moduleOp,
 
   auto ordinalCounts = moduleOp.getOrdinalCountsAttr();
   output << "iree_allocator_t allocator;\n";
+  output << "struct " << moduleName << "_t* module;\n";
   output << "uint8_t rwdata[" << countOrEmpty(ordinalCounts.getGlobalBytes())
          << "];\n";
   output << "iree_vm_ref_t refs[" << countOrEmpty(ordinalCounts.getGlobalRefs())
@@ -301,6 +303,180 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
   return success();
 }
 
+namespace {
+
+// An exported function and the implementation its direct entry point calls.
+struct DirectExport {
+  // Name of the public C function.
+  std::string name;
+  // Implementation taking the stack, module, module state, arguments and then
+  // result pointers.
+  mlir::func::FuncOp implOp;
+  // Number of trailing implementation arguments that are result pointers.
+  unsigned numResults = 0;
+};
+
+} // namespace
+
+static FailureOr<SmallVector<DirectExport>>
+collectDirectExports(IREE::VM::ModuleOp &moduleOp) {
+  SymbolTable symbolTable(moduleOp);
+  SmallVector<DirectExport> directExports;
+  for (auto funcOp : moduleOp.getOps<mlir::func::FuncOp>()) {
+    auto exportName = funcOp->getAttrOfType<StringAttr>("vm.export_name");
+    if (!exportName)
+      continue;
+
+    // Export shims are named after the implementation they forward to.
+    StringRef implName = funcOp.getName();
+    if (!implName.consume_back("_export_shim")) {
+      return funcOp.emitError() << "unexpected export shim name";
+    }
+    auto implOp = symbolTable.lookup<mlir::func::FuncOp>(implName);
+    if (!implOp) {
+      return funcOp.emitError()
+             << "export implementation '" << implName << "' not found";
+    }
+
+    auto callingConvention =
+        funcOp->getAttrOfType<StringAttr>("vm.calling_convention");
+    if (!callingConvention) {
+      return funcOp.emitError("Couldn't find calling convention attribute");
+    }
+    StringRef resultTypes = callingConvention.getValue().split('_').second;
+    unsigned numResults = resultTypes == "v" ? 0 : resultTypes.size();
+    if (implOp.getNumArguments() < 3 + numResults) {
+      return implOp.emitError()
+             << "implementation signature does not match calling convention "
+             << callingConvention;
+    }
+
+    std::string name = (moduleOp.getName() + "_direct_").str();
+    for (char c : exportName.getValue()) {
+      name += llvm::isAlnum(c) ? c : '_';
+    }
+    directExports.push_back({name, implOp, numResults});
+  }
+  return directExports;
+}
+
+static bool isRefPointerType(Type type) {
+  auto ptrType = llvm::dyn_cast<emitc::PointerType>(type);
+  if (!ptrType)
+    return false;
+  auto opaqueType = llvm::dyn_cast<emitc::OpaqueType>(ptrType.getPointee());
+  return opaqueType && opaqueType.getValue() == "iree_vm_ref_t";
+}
+
+static LogicalResult
+printDirectExportSignature(const DirectExport &directExport,
+                           llvm::raw_ostream &output,
+                           mlir::emitc::CppEmitter &emitter) {
+  auto implOp = directExport.implOp;
+  auto types = implOp.getFunctionType().getInputs().drop_front(3);
+  const size_t numArguments = types.size() - directExport.numResults;
+  output << "iree_status_t " << directExport.name
+         << "(iree_vm_context_t* context, iree_vm_module_t* module";
+  for (auto [i, type] : llvm::enumerate(types)) {
+    output << ", ";
+    if (failed(emitter.emitType(implOp.getLoc(), type)))
+      return failure();
+    if (i < numArguments) {
+      output << " arg" << i;
+    } else {
+      output << " res" << (i - numArguments);
+    }
+  }
+  output << ")";
+  return success();
+}
+
+static LogicalResult
+printDirectExportDeclarations(ArrayRef<DirectExport> directExports,
+                              llvm::raw_ostream &output,
+                              mlir::emitc::CppEmitter &emitter) {
+  if (directExports.empty())
+    return success();
+  output << "\n";
+  output << "// Direct entry points that call exported functions without "
+            "going through\n"
+         << "// iree_vm_invoke. |module| must be registered in |context|. Ref "
+            "arguments are\n"
+         << "// borrowed and ref results are owned by the caller. Exports that "
+            "call\n"
+         << "// asynchronous imports are not supported.\n";
+  for (auto &directExport : directExports) {
+    if (failed(printDirectExportSignature(directExport, output, emitter)))
+      return failure();
+    output << ";\n";
+  }
+  return success();
+}
+
+static LogicalResult
+printDirectExportDefinitions(IREE::VM::ModuleOp &moduleOp,
+                             ArrayRef<DirectExport> directExports,
+                             mlir::emitc::CppEmitter &emitter) {
+  if (directExports.empty())
+    return success();
+  llvm::raw_ostream &output = emitter.ostream();
+  std::string moduleStateTypeName = (moduleOp.getName() + "_state_t").str();
+
+  for (auto &directExport : directExports) {
+    auto types =
+        directExport.implOp.getFunctionType().getInputs().drop_front(3);
+    const size_t numArguments = types.size() - directExport.numResults;
+
+    if (failed(printDirectExportSignature(directExport, output, emitter)))
+      return failure();
+    output << " {\n";
+    output << "iree_vm_module_state_t* module_state = NULL;\n";
+    output << "IREE_RETURN_IF_ERROR(iree_vm_context_resolve_module_state("
+              "context, module, &module_state));\n";
+    output << moduleStateTypeName << "* state = (" << moduleStateTypeName
+           << "*)module_state;\n";
+
+    // The implementation releases its ref arguments before returning so we
+    // pass it retained copies of the borrowed references.
+    SmallVector<size_t> refArguments;
+    for (size_t i = 0; i < numArguments; ++i) {
+      if (isRefPointerType(types[i]))
+        refArguments.push_back(i);
+    }
+    if (!refArguments.empty()) {
+      output << "iree_vm_ref_t ref_args[" << refArguments.size() << "];\n";
+      output << "memset(ref_args, 0, sizeof(ref_args));\n";
+      for (auto [i, argument] : llvm::enumerate(refArguments)) {
+        output << "iree_vm_ref_retain(arg" << argument << ", &ref_args[" << i
+               << "]);\n";
+      }
+    }
+
+    output << "IREE_VM_INLINE_STACK_INITIALIZE(stack, "
+              "IREE_VM_INVOCATION_FLAG_NONE, "
+              "iree_vm_context_state_resolver(context), state->allocator);\n";
+    output << "iree_status_t status = " << directExport.implOp.getName()
+           << "(stack, state->module, state";
+    size_t refArgumentIndex = 0;
+    for (size_t i = 0; i < types.size(); ++i) {
+      if (i >= numArguments) {
+        output << ", res" << (i - numArguments);
+      } else if (isRefPointerType(types[i])) {
+        output << ", &ref_args[" << refArgumentIndex++ << "]";
+      } else {
+        output << ", arg" << i;
+      }
+    }
+    output << ");\n";
+    output << "iree_vm_stack_deinitialize(stack);\n";
+    output << "return status;\n";
+    output << "}\n";
+  }
+
+  output << "\n";
+  return success();
+}
+
 /// Adapted from BytecodeModuleTarget and extended by C specific passes
 static LogicalResult
 canonicalizeModule(IREE::VM::ModuleOp moduleOp,
@@ -428,6 +604,16 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
       return failure();
   }
 
+  SmallVector<DirectExport> directExports;
+  if (targetOptions.emitDirectExports) {
+    auto collectedExports = collectDirectExports(moduleOp);
+    if (failed(collectedExports))
+      return failure();
+    directExports = std::move(collectedExports.value());
+    if (failed(printDirectExportDeclarations(directExports, output, emitter)))
+      return failure();
+  }
+
   output << "\n";
   output << "#ifdef __cplusplus\n";
   output << "}  // extern \"C\"\n";
@@ -495,6 +681,10 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
     return failure();
   }
 
+  if (failed(printDirectExportDefinitions(moduleOp, directExports, emitter))) {
+    return failure();
+  }
+
   // Emit code for functions marked with `vm.emit_at_end`.
   for (auto funcOp : moduleOp.getOps<mlir::func::FuncOp>()) {
     Operation *op = funcOp.getOperation();
@@ -35,6 +35,11 @@ struct CTargetOptions {
 
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Emits a public C function per export that takes native C arguments and
+  // calls the generated implementation directly, bypassing iree_vm_invoke and
+  // the argument/result list marshaling of the VM calling convention.
+  bool emitDirectExports = false;
 };
 
 // Translates a vm.module to a c module.
@@ -36,11 +36,19 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<bool> directExportsFlag{
+    "iree-vm-c-module-direct-exports",
+    llvm::cl::desc("Emits direct C entry points for each exported function "
+                   "that bypass the VM invocation machinery"),
+    llvm::cl::init(false),
+};
+
 CTargetOptions getCTargetOptionsFromFlags() {
   CTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
   targetOptions.optimize = optimizeFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.emitDirectExports = directExportsFlag;
   return targetOptions;
 }
 
@@ -9,6 +9,7 @@ vm.module @rodata_ops {
   // Check the generated state struct
   // CHECK-LABEL: struct rodata_ops_state_t {
   // CHECK-NEXT: iree_allocator_t allocator;
+  // CHECK-NEXT: struct rodata_ops_t* module;
   // CHECK-NEXT: uint8_t rwdata[1];
   // CHECK-NEXT: iree_vm_ref_t refs[1];
   // CHECK-NEXT: iree_vm_buffer_t rodata_buffers[2];
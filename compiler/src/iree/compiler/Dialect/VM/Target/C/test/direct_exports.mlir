@@ -0,0 +1,40 @@
+// RUN: iree-compile --compile-mode=vm --output-format=vm-c --iree-vm-c-module-direct-exports %s | FileCheck %s
+
+// Check the direct entry point declarations in the header section.
+// CHECK: iree_status_t direct_module_create(
+// CHECK: iree_status_t direct_module_direct_add_i32(iree_vm_context_t* context, iree_vm_module_t* module, int32_t arg0, int32_t arg1, int32_t* res0);
+// CHECK-NEXT: iree_status_t direct_module_direct_passthrough(iree_vm_context_t* context, iree_vm_module_t* module, iree_vm_ref_t* arg0, iree_vm_ref_t* res0);
+// CHECK: #if defined(EMITC_IMPLEMENTATION)
+vm.module @direct_module {
+  vm.export @add as("add.i32")
+  vm.func @add(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.add.i32 %arg0, %arg1 : i32
+    vm.return %0 : i32
+  }
+
+  vm.export @passthrough
+  vm.func @passthrough(%arg0 : !vm.buffer) -> !vm.buffer {
+    vm.return %arg0 : !vm.buffer
+  }
+}
+
+// Skip the module descriptors.
+// CHECK: static const iree_vm_native_module_descriptor_t direct_module_descriptor_
+
+// CHECK: iree_status_t direct_module_direct_add_i32(iree_vm_context_t* context, iree_vm_module_t* module, int32_t arg0, int32_t arg1, int32_t* res0) {
+// CHECK-NEXT: iree_vm_module_state_t* module_state = NULL;
+// CHECK-NEXT: IREE_RETURN_IF_ERROR(iree_vm_context_resolve_module_state(context, module, &module_state));
+// CHECK-NEXT: direct_module_state_t* state = (direct_module_state_t*)module_state;
+// CHECK-NEXT: IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE, iree_vm_context_state_resolver(context), state->allocator);
+// CHECK-NEXT: iree_status_t status = direct_module_add(stack, state->module, state, arg0, arg1, res0);
+// CHECK-NEXT: iree_vm_stack_deinitialize(stack);
+// CHECK-NEXT: return status;
+// CHECK-NEXT: }
+
+// Ref arguments are retained so the implementation can release them.
+// CHECK: iree_status_t direct_module_direct_passthrough(iree_vm_context_t* context, iree_vm_module_t* module, iree_vm_ref_t* arg0, iree_vm_ref_t* res0) {
+// CHECK: iree_vm_ref_t ref_args[1];
+// CHECK-NEXT: memset(ref_args, 0, sizeof(ref_args));
+// CHECK-NEXT: iree_vm_ref_retain(arg0, &ref_args[0]);
+// CHECK-NEXT: IREE_VM_INLINE_STACK_INITIALIZE(
+// CHECK-NEXT: iree_status_t status = direct_module_passthrough(stack, state->module, state, &ref_args[0], res0);
@@ -4,6 +4,7 @@ vm.module @global_ops {
   // check the generated state struct
   // CHECK-LABEL: struct global_ops_state_t {
   // CHECK-NEXT: iree_allocator_t allocator;
+  // CHECK-NEXT: struct global_ops_t* module;
   // CHECK-NEXT: uint8_t rwdata[8];
   // CHECK-NEXT: iree_vm_ref_t refs[1];
   // CHECK-NEXT: iree_vm_buffer_t rodata_buffers[1];
@@ -0,0 +1,95 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/Common/CPU/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassManager.h"
+
+#define DEBUG_TYPE "iree-global-opt-materialize-homogeneous-encodings"
+
+namespace mlir {
+namespace iree_compiler {
+namespace GlobalOptimization {
+
+namespace {
+
+// Materializes tensor encodings into tensor.pack/tensor.unpack/linalg.mmt4d at
+// the program level when the whole module targets a single CPU executable
+// target. The tile sizes are then known before const-expr hoisting so that
+// packing of constant and global weights is hoisted into initializers and
+// evaluated at compile time instead of at load or on every call.
+class MaterializeHomogeneousEncodingsPass
+    : public PassWrapper<MaterializeHomogeneousEncodingsPass,
+                         OperationPass<ModuleOp>> {
+public:
+  MaterializeHomogeneousEncodingsPass()
+      : materializePipeline(ModuleOp::getOperationName()) {
+    materializePipeline.addNestedPass<func::FuncOp>(
+        createCPUMaterializeEncodingPass());
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<IREE::HAL::HALDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+    materializePipeline.getDependentDialects(registry);
+  }
+
+  StringRef getArgument() const override {
+    return "iree-global-opt-materialize-homogeneous-encodings";
+  }
+
+  StringRef getDescription() const override {
+    return "Materializes tensor encodings for the module's executable target "
+           "when all devices agree on a single CPU target.";
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    auto executableTargets =
+        IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(moduleOp);
+    // With multiple targets the layouts may differ per target so leave the
+    // encodings for per-executable materialization.
+    if (executableTargets.size() != 1)
+      return;
+    auto executableTarget = executableTargets.front();
+    // Only the llvm-cpu backend has static tile sizes available at this point
+    // (VMVX with microkernels queries them at runtime).
+    if (executableTarget.getBackend().getValue() != "llvm-cpu")
+      return;
+
+    // The CPU materialization looks up the target from the enclosing ops; pin
+    // it on the module for the duration of the nested pipeline.
+    auto targetAttrName =
+        StringAttr::get(&getContext(), "hal.executable.target");
+    moduleOp->setAttr(targetAttrName, executableTarget);
+    LogicalResult result = runPipeline(materializePipeline, moduleOp);
+    moduleOp->removeAttr(targetAttrName);
+    if (failed(result)) {
+      return signalPassFailure();
+    }
+  }
+
+private:
+  OpPassManager materializePipeline;
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+createMaterializeHomogeneousEncodingsPass() {
+  return std::make_unique<MaterializeHomogeneousEncodingsPass>();
+}
+
+} // namespace GlobalOptimization
+} // namespace iree_compiler
+} // namespace mlir
@@ -35,6 +35,16 @@ void buildGlobalOptimizationPassPipeline(
       .addPass(IREE::Flow::createTopLevelSCFToCFGPass);
   mainPassManager.addPass(IREE::Flow::createExpandTensorShapesPass());
 
+  // Data tiling runs ahead of const-expr hoisting so that packing of constant
+  // and global operands becomes a const-expr that gets hoisted and evaluated.
+  if (transformOptions.dataTiling) {
+    FunctionLikeNest(mainPassManager)
+        .addPass(IREE::Flow::createSetEncodingPass)
+        .addPass(mlir::createCanonicalizerPass)
+        .addPass(mlir::createCSEPass);
+    mainPassManager.addPass(createMaterializeHomogeneousEncodingsPass());
+  }
+
   OpPassManager pipeline(ModuleOp::getOperationName());
   FunctionLikeNest(pipeline)
       // Simplify util.global accesses early on; this can help with dispatch
@@ -71,6 +81,9 @@ void buildGlobalOptimizationPassPipeline(
 }
 
 void registerGlobalOptimizationPipeline() {
+  mlir::registerPass(
+      [] { return createMaterializeHomogeneousEncodingsPass(); });
+
   PassPipelineRegistration<TransformOptions>
       globalOptimizationTransformPassPipeline(
           "iree-global-optimization-transformation-pipeline",
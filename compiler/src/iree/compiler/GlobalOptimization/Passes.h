@@ -9,6 +9,7 @@
 
 #include <functional>
 
+#include "mlir/IR/BuiltinOps.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 
@@ -24,6 +25,12 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
   // Enables passes to perform numeric precision reduction.
   bool numericPrecisionReduction = false;
 
+  // Enables data tiling at the program level: matmul operands get encodings
+  // and, when the module targets a single CPU target, the encodings are
+  // materialized into tensor.pack/linalg.mmt4d before const-expr hoisting so
+  // that weight packing is evaluated at compile time.
+  bool dataTiling = false;
+
   // Hook to populate a constant evaluation pass pipeline. If nullptr, then
   // no passes are added for constant evaluation. This must be injected in
   // because constant-evaluators can depend on the whole compiler, of which
@@ -37,6 +44,11 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
 void buildGlobalOptimizationPassPipeline(
     OpPassManager &mainPassManager, const TransformOptions &transformOptions);
 
+// Materializes tensor encodings into pack/unpack/mmt4d ops at the program
+// level when all devices share one CPU executable target. No-op otherwise.
+std::unique_ptr<OperationPass<ModuleOp>>
+createMaterializeHomogeneousEncodingsPass();
+
 void registerGlobalOptimizationPipeline();
 
 } // namespace GlobalOptimization
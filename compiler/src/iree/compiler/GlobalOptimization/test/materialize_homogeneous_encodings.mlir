@@ -0,0 +1,49 @@
+// RUN: iree-opt --split-input-file --iree-flow-set-encoding --iree-global-opt-materialize-homogeneous-encodings --canonicalize --cse %s | FileCheck %s
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf", cpu_features = "+avx512f"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  util.global private @weight : tensor<256x512xf32>
+  func.func @matmul_global_rhs(%lhs : tensor<128x256xf32>) -> tensor<128x512xf32> {
+    %rhs = util.global.load @weight : tensor<256x512xf32>
+    %cst = arith.constant 0.0 : f32
+    %empty = tensor.empty() : tensor<128x512xf32>
+    %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<128x512xf32>) -> tensor<128x512xf32>
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<128x256xf32>, tensor<256x512xf32>)
+        outs(%fill : tensor<128x512xf32>) -> tensor<128x512xf32>
+    return %0 : tensor<128x512xf32>
+  }
+}
+// CHECK-NOT: hal.executable.target
+//     CHECK: func.func @matmul_global_rhs(
+// CHECK-SAME:    %[[LHS:.+]]: tensor<128x256xf32>
+//     CHECK:   %[[RHS:.+]] = util.global.load @weight
+//     CHECK:   %[[PACK_LHS:.+]] = tensor.pack %[[LHS]]
+// CHECK-SAME:    inner_tiles = [16, 1]
+//     CHECK:   %[[PACK_RHS:.+]] = tensor.pack %[[RHS]]
+// CHECK-SAME:    outer_dims_perm = [1, 0] inner_dims_pos = [1, 0] inner_tiles = [16, 1]
+// CHECK-SAME:    -> tensor<32x256x16x1xf32>
+//     CHECK:   %[[MMT4D:.+]] = linalg.mmt4d
+// CHECK-SAME:    ins(%[[PACK_LHS]], %[[PACK_RHS]] :
+//     CHECK:   %[[UNPACK:.+]] = tensor.unpack %[[MMT4D]]
+//     CHECK:   return %[[UNPACK]]
+
+// -----
+
+// Encodings are left for per-executable materialization when the devices do
+// not agree on a single target.
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf", cpu_features = "+avx512f"}>
+#executable_target_embedded_elf_aarch64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-aarch64", {target_triple = "aarch64-none-elf"}>
+#device_target_llvm_cpu = #hal.device.target<"llvm-cpu", {executable_targets = [#executable_target_embedded_elf_x86_64_, #executable_target_embedded_elf_aarch64_]}>
+module attributes {hal.device.targets = [#device_target_llvm_cpu]} {
+  func.func @matmul_heterogeneous(%lhs : tensor<128x256xf32>, %rhs : tensor<256x512xf32>, %acc : tensor<128x512xf32>) -> tensor<128x512xf32> {
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<128x256xf32>, tensor<256x512xf32>)
+        outs(%acc : tensor<128x512xf32>) -> tensor<128x512xf32>
+    return %0 : tensor<128x512xf32>
+  }
+}
+// CHECK-LABEL: func.func @matmul_heterogeneous(
+//       CHECK:   iree_linalg_ext.set_encoding
+//       CHECK:   linalg.matmul
+//       CHECK:   iree_linalg_ext.unset_encoding
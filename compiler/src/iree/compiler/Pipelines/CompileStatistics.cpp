@@ -0,0 +1,311 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Pipelines/CompileStatistics.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define IREE_COMPILER_HAVE_GETRUSAGE 1
+#else
+#define IREE_COMPILER_HAVE_GETRUSAGE 0
+#endif
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/Support/JSON.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/FileUtilities.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Returns the peak resident set size of the process in bytes or -1 if not
+// available on the platform.
+static int64_t getPeakResidentSetSize() {
+#if IREE_COMPILER_HAVE_GETRUSAGE
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return -1;
+#if defined(__APPLE__)
+  return static_cast<int64_t>(usage.ru_maxrss); // bytes
+#else
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif // __APPLE__
+#else
+  return -1;
+#endif // IREE_COMPILER_HAVE_GETRUSAGE
+}
+
+// Returns the total number of bytes required to serialize all constant
+// attributes (dense/resource elements, executable binaries, etc) in |rootOp|.
+static int64_t calculateConstantStorageSize(Operation *rootOp) {
+  int64_t totalSize = 0;
+  rootOp->walk([&](Operation *op) {
+    for (auto namedAttr : op->getAttrs()) {
+      if (auto serializableAttr =
+              llvm::dyn_cast<IREE::Util::SerializableAttrInterface>(
+                  namedAttr.getValue())) {
+        totalSize += serializableAttr.getStorageSize();
+      }
+    }
+  });
+  return totalSize;
+}
+
+// Returns the number of executables of any dialect in the program.
+static int64_t countExecutables(Operation *rootOp) {
+  int64_t count = 0;
+  for (auto &region : rootOp->getRegions()) {
+    for (auto &op : region.getOps()) {
+      if (isa<IREE::Flow::ExecutableOp, IREE::Stream::ExecutableOp,
+              IREE::HAL::ExecutableOp>(op)) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+// Returns the name of the hal.executable |op| is nested within, if any.
+static std::optional<StringRef> getEnclosingExecutableName(Operation *op) {
+  auto executableOp = dyn_cast<IREE::HAL::ExecutableOp>(op);
+  if (!executableOp)
+    executableOp = op->getParentOfType<IREE::HAL::ExecutableOp>();
+  if (!executableOp)
+    return std::nullopt;
+  return executableOp.getName();
+}
+
+// Returns true if |pass| is a pass manager adaptor running nested pipelines.
+// Their time is already accounted for by the nested passes.
+static bool isPassAdaptor(Pass *pass) {
+  return pass->getName().ends_with("OpToOpPassAdaptor");
+}
+
+static StringRef getPhaseName(IREEVMPipelinePhase phase) {
+  StringRef phaseName;
+  enumerateIREEVMPipelinePhases(
+      [&](IREEVMPipelinePhase it, StringRef mnemonic, StringRef desc) {
+        if (it == phase)
+          phaseName = mnemonic;
+      });
+  return phaseName;
+}
+
+// Marks a phase boundary in the statistics when run.
+class PhaseMarkerPass
+    : public PassWrapper<PhaseMarkerPass, OperationPass<mlir::ModuleOp>> {
+public:
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(PhaseMarkerPass)
+
+  PhaseMarkerPass(CompileStatistics &statistics, StringRef phaseName,
+                  bool isBegin)
+      : statistics(statistics), phaseName(phaseName), isBegin(isBegin) {}
+
+  StringRef getArgument() const override {
+    return "iree-compile-statistics-phase-marker";
+  }
+
+  void runOnOperation() override {
+    if (isBegin) {
+      statistics.beginPhase(phaseName, getOperation());
+    } else {
+      statistics.endPhase(phaseName, getOperation());
+    }
+  }
+
+private:
+  CompileStatistics &statistics;
+  StringRef phaseName;
+  bool isBegin;
+};
+
+} // namespace
+
+class CompileStatistics::Instrumentation : public PassInstrumentation {
+public:
+  explicit Instrumentation(CompileStatistics &statistics)
+      : statistics(statistics) {}
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    statistics.beforePass(pass, op);
+  }
+  void runAfterPass(Pass *pass, Operation *op) override {
+    statistics.afterPass(pass, op);
+  }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    statistics.afterPass(pass, op);
+  }
+
+private:
+  CompileStatistics &statistics;
+};
+
+CompileStatistics::CompileStatistics() : startTime(Clock::now()) {}
+
+void CompileStatistics::installPipelineHooks(IREEVMPipelineHooks &hooks) {
+  auto chain = [](auto existingCallback, bool isBegin,
+                  CompileStatistics &statistics) {
+    return [=, &statistics](IREEVMPipelinePhase phase,
+                            OpPassManager &passManager) {
+      if (existingCallback)
+        existingCallback(phase, passManager);
+      passManager.addPass(std::make_unique<PhaseMarkerPass>(
+          statistics, getPhaseName(phase), isBegin));
+    };
+  };
+  hooks.beginPhaseCallback =
+      chain(hooks.beginPhaseCallback, /*isBegin=*/true, *this);
+  hooks.endPhaseCallback =
+      chain(hooks.endPhaseCallback, /*isBegin=*/false, *this);
+}
+
+std::unique_ptr<PassInstrumentation>
+CompileStatistics::createInstrumentation() {
+  return std::make_unique<Instrumentation>(*this);
+}
+
+void CompileStatistics::beginPhase(StringRef name, Operation *rootOp) {
+  std::lock_guard<std::mutex> lock(mutex);
+  PhaseRecord phase;
+  phase.name = name.str();
+  phase.beginTime = Clock::now();
+  phases.push_back(std::move(phase));
+  activePhase = phases.size() - 1;
+}
+
+void CompileStatistics::endPhase(StringRef name, Operation *rootOp) {
+  // Sample the program outside of the lock; no passes run concurrently with
+  // the module-level marker.
+  int64_t constantStorageBytes = calculateConstantStorageSize(rootOp);
+  int64_t executableCount = countExecutables(rootOp);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!activePhase)
+    return;
+  auto &phase = phases[*activePhase];
+  phase.milliseconds =
+      std::chrono::duration<double, std::milli>(Clock::now() - phase.beginTime)
+          .count();
+  phase.peakResidentBytes = getPeakResidentSetSize();
+  phase.constantStorageBytes = constantStorageBytes;
+  phase.executableCount = executableCount;
+  activePhase = std::nullopt;
+}
+
+void CompileStatistics::beforePass(Pass *pass, Operation *op) {
+  if (isPassAdaptor(pass) || isa<PhaseMarkerPass>(pass))
+    return;
+  auto beginTime = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex);
+  passBeginTimes[std::make_pair(pass, op)] = beginTime;
+}
+
+void CompileStatistics::afterPass(Pass *pass, Operation *op) {
+  if (isPassAdaptor(pass) || isa<PhaseMarkerPass>(pass))
+    return;
+  auto endTime = Clock::now();
+  // Look up the executable before taking the lock; the op is owned by the
+  // thread running the pass.
+  auto executableName = getEnclosingExecutableName(op);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = passBeginTimes.find(std::make_pair(pass, op));
+  if (it == passBeginTimes.end())
+    return;
+  double milliseconds =
+      std::chrono::duration<double, std::milli>(endTime - it->second).count();
+  passBeginTimes.erase(it);
+
+  TimingRecord *timings = &unphasedTimings;
+  if (executableName) {
+    timings = &executableTimings[executableName->str()];
+  } else if (activePhase) {
+    timings = &phases[*activePhase].passTimings;
+  }
+  StringRef passName = pass->getArgument();
+  if (passName.empty())
+    passName = pass->getName();
+  passName = passNames.insert({passName, true}).first->getKey();
+  auto &passRecord = timings->passes[passName];
+  passRecord.milliseconds += milliseconds;
+  ++passRecord.runCount;
+  timings->milliseconds += milliseconds;
+}
+
+void CompileStatistics::printJSON(llvm::raw_ostream &os) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto printPasses = [](llvm::json::OStream &json,
+                        const TimingRecord &timings) {
+    json.attributeArray("passes", [&]() {
+      for (auto &[passName, passRecord] : timings.passes) {
+        json.object([&]() {
+          json.attribute("name", passName);
+          json.attribute("wall_time_ms", passRecord.milliseconds);
+          json.attribute("run_count", passRecord.runCount);
+        });
+      }
+    });
+  };
+
+  llvm::json::OStream json(os, /*IndentSize=*/2);
+  json.object([&]() {
+    json.attribute(
+        "total_wall_time_ms",
+        std::chrono::duration<double, std::milli>(Clock::now() - startTime)
+            .count());
+    json.attribute("peak_rss_bytes", getPeakResidentSetSize());
+    json.attributeArray("phases", [&]() {
+      for (auto &phase : phases) {
+        json.object([&]() {
+          json.attribute("name", phase.name);
+          json.attribute("wall_time_ms", phase.milliseconds);
+          json.attribute("peak_rss_bytes", phase.peakResidentBytes);
+          json.attribute("constant_storage_bytes", phase.constantStorageBytes);
+          json.attribute("executable_count", phase.executableCount);
+          printPasses(json, phase.passTimings);
+        });
+      }
+    });
+    // Executable pass times are summed across threads and may exceed the
+    // wall time of the phase they ran in.
+    json.attributeArray("executables", [&]() {
+      for (auto &[executableName, timings] : executableTimings) {
+        json.object([&]() {
+          json.attribute("name", executableName);
+          json.attribute("wall_time_ms", timings.milliseconds);
+          printPasses(json, timings);
+        });
+      }
+    });
+    if (!unphasedTimings.passes.empty()) {
+      json.attributeObject("unphased", [&]() {
+        json.attribute("wall_time_ms", unphasedTimings.milliseconds);
+        printPasses(json, unphasedTimings);
+      });
+    }
+  });
+  os << "\n";
+}
+
+LogicalResult CompileStatistics::writeJSON(StringRef path) {
+  std::string errorMessage;
+  auto file = openOutputFile(path, &errorMessage);
+  if (!file) {
+    llvm::errs() << "failed to open compile statistics file '" << path
+                 << "': " << errorMessage << "\n";
+    return failure();
+  }
+  printJSON(file->os());
+  file->keep();
+  return success();
+}
+
+} // namespace iree_compiler
+} // namespace mlir
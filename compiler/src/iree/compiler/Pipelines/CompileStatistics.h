@@ -0,0 +1,111 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_PIPELINES_COMPILESTATISTICS_H_
+#define IREE_COMPILER_PIPELINES_COMPILESTATISTICS_H_
+
+#include <chrono>
+#include <mutex>
+
+#include "iree/compiler/Pipelines/Pipelines.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Pass/PassInstrumentation.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+// Collects compile time and memory statistics for an IREEVM pipeline run.
+//
+// Pass wall time is attributed to the pipeline phase that is active when the
+// pass runs (input, flow, stream, hal, vm, etc) or, for passes nested under a
+// hal.executable, to that executable so that codegen time can be broken down
+// per executable. At the end of each phase the peak resident set size, the
+// total size of serializable constant attributes and the number of
+// executables in the program are sampled.
+//
+// Usage:
+//   CompileStatistics statistics;
+//   statistics.installPipelineHooks(hooks);
+//   passManager.addInstrumentation(statistics.createInstrumentation());
+//   buildIREEVMTransformPassPipeline(..., hooks, passManager, ...);
+//   passManager.run(moduleOp);
+//   statistics.printJSON(llvm::outs());
+//
+// The statistics object must outlive the pass manager.
+class CompileStatistics {
+public:
+  CompileStatistics();
+
+  // Adds phase boundary callbacks to |hooks|. Existing callbacks are chained.
+  void installPipelineHooks(IREEVMPipelineHooks &hooks);
+
+  // Returns a pass instrumentation that records pass timings into this object.
+  std::unique_ptr<PassInstrumentation> createInstrumentation();
+
+  // Marks the beginning/end of a pipeline phase running on |rootOp|.
+  void beginPhase(StringRef name, Operation *rootOp);
+  void endPhase(StringRef name, Operation *rootOp);
+
+  // Prints the collected statistics as a JSON object to |os|.
+  void printJSON(llvm::raw_ostream &os);
+
+  // Writes the JSON report to |path| or stdout if `-`.
+  LogicalResult writeJSON(StringRef path);
+
+private:
+  class Instrumentation;
+  using Clock = std::chrono::steady_clock;
+
+  // Accumulated wall time of all runs of a pass.
+  struct PassRecord {
+    double milliseconds = 0.0;
+    int64_t runCount = 0;
+  };
+
+  // Pass timings for either a phase or an executable.
+  struct TimingRecord {
+    double milliseconds = 0.0;
+    llvm::MapVector<StringRef, PassRecord> passes;
+  };
+
+  struct PhaseRecord {
+    std::string name;
+    Clock::time_point beginTime;
+    double milliseconds = 0.0;
+    TimingRecord passTimings;
+    // Sampled at the end of the phase.
+    int64_t peakResidentBytes = -1;
+    int64_t constantStorageBytes = 0;
+    int64_t executableCount = 0;
+  };
+
+  void beforePass(Pass *pass, Operation *op);
+  void afterPass(Pass *pass, Operation *op);
+
+  std::mutex mutex;
+  Clock::time_point startTime;
+  // Index into |phases| of the active phase, if any.
+  std::optional<size_t> activePhase;
+  SmallVector<PhaseRecord> phases;
+  // Pass timings of passes running outside of any phase.
+  TimingRecord unphasedTimings;
+  // Per-executable pass timings keyed by hal.executable symbol name.
+  llvm::MapVector<std::string, TimingRecord> executableTimings;
+  // Start times of in-flight passes. Nested passes may run concurrently on
+  // different ops so both are used as the key.
+  llvm::DenseMap<std::pair<Pass *, Operation *>, Clock::time_point>
+      passBeginTimes;
+  // Uniqued pass names referenced by the records.
+  llvm::StringMap<bool> passNames;
+};
+
+} // namespace iree_compiler
+} // namespace mlir
+
+#endif // IREE_COMPILER_PIPELINES_COMPILESTATISTICS_H_
@@ -12,6 +12,8 @@ IREE_DEFINE_COMPILER_OPTION_FLAGS(
     mlir::iree_compiler::HighLevelOptimizationOptions);
 IREE_DEFINE_COMPILER_OPTION_FLAGS(mlir::iree_compiler::SchedulingOptions);
 IREE_DEFINE_COMPILER_OPTION_FLAGS(mlir::iree_compiler::PreprocessingOptions);
+IREE_DEFINE_COMPILER_OPTION_FLAGS(
+    mlir::iree_compiler::CompileStatisticsOptions);
 
 namespace mlir {
 namespace iree_compiler {
@@ -118,6 +120,13 @@ void HighLevelOptimizationOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Reduces numeric precision to lower bit depths where possible."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-data-tiling", dataTiling,
+      llvm::cl::desc(
+          "Enables data tiling of matmuls at the program level. When all "
+          "devices share a single CPU target, packing of constant and global "
+          "weights is performed at compile time."),
+      llvm::cl::cat(category));
   binder.opt<bool>("iree-opt-strip-assertions", stripAssertions,
                    llvm::cl::desc("Strips debug assertions after any useful "
                                   "information has been extracted."),
@@ -187,5 +196,18 @@ void PreprocessingOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::cat(category));
 }
 
+void CompileStatisticsOptions::bindOptions(OptionsBinder &binder) {
+  static llvm::cl::OptionCategory category(
+      "IREE options for profiling the compiler itself");
+
+  binder.opt<std::string>(
+      "iree-compile-statistics-file", statisticsFile,
+      llvm::cl::desc("File path to write a JSON report of per-phase and "
+                     "per-executable compile time, peak memory usage, "
+                     "constant storage size and executable counts to; or `-` "
+                     "for stdout."),
+      llvm::cl::cat(category));
+}
+
 } // namespace iree_compiler
 } // namespace mlir
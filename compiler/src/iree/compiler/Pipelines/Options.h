@@ -86,6 +86,10 @@ struct HighLevelOptimizationOptions {
   // Optimizations to reduce numeric precision where it is safe to do so.
   bool numericPrecisionReduction = false;
 
+  // Enables program-level data tiling so that packing of constant weights is
+  // evaluated at compile time for the target's tile sizes.
+  bool dataTiling = false;
+
   // Strips debug assertions after any useful information has been extracted.
   bool stripAssertions = false;
 
@@ -154,6 +158,16 @@ struct PreprocessingOptions {
   using FromFlags = OptionsFromFlags<PreprocessingOptions>;
 };
 
+// Options controlling compiler self-profiling.
+struct CompileStatisticsOptions {
+  // File path to write a JSON compile statistics report to; `-` for stdout.
+  // Statistics collection is disabled when empty.
+  std::string statisticsFile = "";
+
+  void bindOptions(OptionsBinder &binder);
+  using FromFlags = OptionsFromFlags<CompileStatisticsOptions>;
+};
+
 } // namespace iree_compiler
 } // namespace mlir
 
@@ -33,6 +33,20 @@
 namespace mlir {
 namespace iree_compiler {
 
+// Notifies |hooks| that the passes of |phase| are about to be added.
+static void beginPhase(IREEVMPipelineHooks &hooks, IREEVMPipelinePhase phase,
+                       OpPassManager &passManager) {
+  if (hooks.beginPhaseCallback)
+    hooks.beginPhaseCallback(phase, passManager);
+}
+
+// Notifies |hooks| that all passes of |phase| have been added.
+static void endPhase(IREEVMPipelineHooks &hooks, IREEVMPipelinePhase phase,
+                     OpPassManager &passManager) {
+  if (hooks.endPhaseCallback)
+    hooks.endPhaseCallback(phase, passManager);
+}
+
 void buildIREEVMTransformPassPipeline(
     const IREE::HAL::TargetBackendRegistry &targetRegistry,
     BindingOptions bindingOptions, InputDialectOptions inputOptions,
@@ -59,6 +73,7 @@ void buildIREEVMTransformPassPipeline(
   if (compileFrom < IREEVMPipelinePhase::Input) { // late-entry
     auto inputType = inputOptions.parseInputTypeMnemonic();
     IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "Input");
+    beginPhase(hooks, IREEVMPipelinePhase::Input, passManager);
     if (hooks.pipelineExtensions) {
       hooks.pipelineExtensions->extendInputConversionPreprocessingPassPipeline(
           passManager, inputType);
@@ -122,6 +137,7 @@ void buildIREEVMTransformPassPipeline(
 #endif // IREE_HAVE_TOSA_INPUT
     }
     buildCommonInputConversionPassPipeline(passManager);
+    endPhase(hooks, IREEVMPipelinePhase::Input, passManager);
     IREE_TRACE_ADD_END_FRAME_PASS(passManager, "Input");
   }
   if (compileTo == IREEVMPipelinePhase::Input)
@@ -130,6 +146,7 @@ void buildIREEVMTransformPassPipeline(
   // Now that inputs are legalized, generate wrapper for entry functions.
   if (compileFrom < IREEVMPipelinePhase::ABI) { // late-entry
     IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "ABI");
+    beginPhase(hooks, IREEVMPipelinePhase::ABI, passManager);
     IREE::ABI::InvocationOptions invocationOptions;
     invocationOptions.invocationModel =
         schedulingOptions.executionModel ==
@@ -142,6 +159,7 @@ void buildIREEVMTransformPassPipeline(
     if (bindingOptions.tflite) {
       IREE::TFLite::buildTransformPassPipeline(passManager);
     }
+    endPhase(hooks, IREEVMPipelinePhase::ABI, passManager);
     IREE_TRACE_ADD_END_FRAME_PASS(passManager, "ABI");
   }
   if (compileTo == IREEVMPipelinePhase::ABI)
@@ -152,6 +170,7 @@ void buildIREEVMTransformPassPipeline(
       highLevelOptimizationOptions.constExprHoisting;
   globalOptOptions.numericPrecisionReduction =
       highLevelOptimizationOptions.numericPrecisionReduction;
+  globalOptOptions.dataTiling = highLevelOptimizationOptions.dataTiling;
 
   // Enable const-eval via hook. For debug builds, we assert if enabled
   // without a hook. For release, we just silently skip enabling const-eval.
@@ -186,8 +205,10 @@ void buildIREEVMTransformPassPipeline(
   default:
     if (compileFrom < IREEVMPipelinePhase::Preprocessing) { // late-entry.
       IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "Preprocessing");
+      beginPhase(hooks, IREEVMPipelinePhase::Preprocessing, passManager);
       IREE::buildPreprocessingPassPipeline(passManager, preprocessingOptions,
                                            hooks.pipelineExtensions);
+      endPhase(hooks, IREEVMPipelinePhase::Preprocessing, passManager);
       IREE_TRACE_ADD_END_FRAME_PASS(passManager, "Preprocessing");
     }
     if (compileTo == IREEVMPipelinePhase::Preprocessing)
@@ -195,15 +216,19 @@ void buildIREEVMTransformPassPipeline(
 
     if (compileFrom < IREEVMPipelinePhase::GlobalOptimization) { // late-entry
       IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "GlobalOptimization");
+      beginPhase(hooks, IREEVMPipelinePhase::GlobalOptimization, passManager);
       GlobalOptimization::buildGlobalOptimizationPassPipeline(passManager,
                                                               globalOptOptions);
+      endPhase(hooks, IREEVMPipelinePhase::GlobalOptimization, passManager);
       IREE_TRACE_ADD_END_FRAME_PASS(passManager, "GlobalOptimization");
     }
 
     IREE::Flow::TransformOptions flowOptions;
     if (compileFrom < IREEVMPipelinePhase::Flow) { // late-entry
       IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "Flow");
+      beginPhase(hooks, IREEVMPipelinePhase::Flow, passManager);
       IREE::Flow::buildFlowTransformPassPipeline(passManager, flowOptions);
+      endPhase(hooks, IREEVMPipelinePhase::Flow, passManager);
       IREE_TRACE_ADD_END_FRAME_PASS(passManager, "Flow");
     }
     if (compileTo == IREEVMPipelinePhase::Flow)
@@ -211,8 +236,10 @@ void buildIREEVMTransformPassPipeline(
 
     if (compileFrom < IREEVMPipelinePhase::Stream) { // late-entry
       IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "Stream");
+      beginPhase(hooks, IREEVMPipelinePhase::Stream, passManager);
       IREE::Stream::buildStreamTransformPassPipeline(passManager,
                                                      streamOptions);
+      endPhase(hooks, IREEVMPipelinePhase::Stream, passManager);
       IREE_TRACE_ADD_END_FRAME_PASS(passManager, "Stream");
     }
     if (compileTo == IREEVMPipelinePhase::Stream)
@@ -248,6 +275,7 @@ void buildIREEVMTransformPassPipeline(
 
   if (compileFrom < IREEVMPipelinePhase::HAL) { // late-entry
     IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "HAL");
+    beginPhase(hooks, IREEVMPipelinePhase::HAL, passManager);
     switch (schedulingOptions.executionModel) {
     case SchedulingOptions::ExecutionModel::HostOnly:
       // No HAL required.
@@ -268,6 +296,7 @@ void buildIREEVMTransformPassPipeline(
           passManager, targetRegistry, executableOptions);
       break;
     }
+    endPhase(hooks, IREEVMPipelinePhase::HAL, passManager);
     IREE_TRACE_ADD_END_FRAME_PASS(passManager, "HAL");
   }
   if (compileTo == IREEVMPipelinePhase::HAL ||
@@ -277,8 +306,10 @@ void buildIREEVMTransformPassPipeline(
 
   if (compileFrom < IREEVMPipelinePhase::VM) { // late-entry
     IREE_TRACE_ADD_BEGIN_FRAME_PASS(passManager, "VM");
+    beginPhase(hooks, IREEVMPipelinePhase::VM, passManager);
     IREE::VM::buildVMTransformPassPipeline(passManager, targetOptions);
     passManager.addPass(IREE::Util::createDropCompilerHintsPass());
+    endPhase(hooks, IREEVMPipelinePhase::VM, passManager);
     IREE_TRACE_ADD_END_FRAME_PASS(passManager, "VM");
   }
   if (compileTo == IREEVMPipelinePhase::VM)
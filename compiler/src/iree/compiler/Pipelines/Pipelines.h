@@ -18,6 +18,21 @@ namespace iree_compiler {
 
 class PipelineExtensions;
 
+enum class IREEVMPipelinePhase {
+  Start,
+  Input,
+  ABI,
+  Preprocessing,
+  GlobalOptimization,
+  Flow,
+  Stream,
+  ExecutableSources,
+  ExecutableTargets,
+  HAL,
+  VM,
+  End,
+};
+
 // Hooks for injecting behavior into the IREEVM pipeline. Since these are not
 // derived from CLI options, we maintain them as a separate struct.
 struct IREEVMPipelineHooks {
@@ -31,21 +46,12 @@ struct IREEVMPipelineHooks {
 
   // Applies pipeline extensions to the built pipeline if not nullptr.
   PipelineExtensions *pipelineExtensions = nullptr;
-};
 
-enum class IREEVMPipelinePhase {
-  Start,
-  Input,
-  ABI,
-  Preprocessing,
-  GlobalOptimization,
-  Flow,
-  Stream,
-  ExecutableSources,
-  ExecutableTargets,
-  HAL,
-  VM,
-  End,
+  // Optional callbacks invoked with the pass manager immediately before and
+  // after the passes of each phase are added. Used to insert marker passes
+  // such as those used for compile statistics.
+  std::function<void(IREEVMPipelinePhase, OpPassManager &)> beginPhaseCallback;
+  std::function<void(IREEVMPipelinePhase, OpPassManager &)> endPhaseCallback;
 };
 
 // Enumerates names and descriptions for pipeline phase values.
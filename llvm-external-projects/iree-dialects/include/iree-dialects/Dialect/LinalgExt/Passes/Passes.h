@@ -171,6 +171,16 @@ std::unique_ptr<Pass> createConvertConv2DToWinogradPass();
 // linalg generic ops.
 std::unique_ptr<Pass> createDecomposeSoftmaxPass();
 
+// Function that returns true if the given softmax op should be decomposed.
+// Softmax ops for which it returns false are left as-is, e.g. so that they can
+// be lowered to a microkernel.
+using DecomposeSoftmaxControlFn = std::function<bool(SoftmaxOp)>;
+
+// Creates a pass to convert the softmax ops accepted by `controlFn` into a
+// sequence of linalg generic ops.
+std::unique_ptr<Pass>
+createDecomposeSoftmaxPass(DecomposeSoftmaxControlFn controlFn);
+
 // Transform dialect version of tile and decompose attention
 SmallVector<Operation *>
 tileAndDecomposeAttention(IREE::LinalgExt::AttentionOp attnOp,
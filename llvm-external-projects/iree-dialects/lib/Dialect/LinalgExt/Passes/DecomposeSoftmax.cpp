@@ -116,10 +116,14 @@ static Value computeSoftmax(Value numerator, Value denominator, Value output,
 /// 4. Divide z and l. This gives the N-dimensional softmax.
 ///    softmax = z / l
 ///
-LogicalResult convertSoftmaxToGenerics(func::FuncOp funcOp) {
+LogicalResult
+convertSoftmaxToGenerics(func::FuncOp funcOp,
+                         const DecomposeSoftmaxControlFn &controlFn) {
   IRRewriter rewriter(funcOp.getContext());
   SmallVector<Operation *> toDelete;
   funcOp.walk([&](IREE::LinalgExt::SoftmaxOp softmaxOp) {
+    if (controlFn && !controlFn(softmaxOp))
+      return WalkResult::advance();
     OpBuilder::InsertionGuard guard(rewriter);
     rewriter.setInsertionPoint(softmaxOp);
     Location loc = softmaxOp.getLoc();
@@ -187,6 +191,9 @@ LogicalResult convertSoftmaxToGenerics(func::FuncOp funcOp) {
 }
 
 struct DecomposeSoftmaxPass : DecomposeSoftmaxBase<DecomposeSoftmaxPass> {
+  DecomposeSoftmaxPass() = default;
+  DecomposeSoftmaxPass(DecomposeSoftmaxControlFn controlFn)
+      : controlFn(std::move(controlFn)) {}
   void getDependentDialects(DialectRegistry &registry) const override {
     registry
         .insert<linalg::LinalgDialect, IREE::LinalgExt::IREELinalgExtDialect>();
@@ -194,9 +201,12 @@ struct DecomposeSoftmaxPass : DecomposeSoftmaxBase<DecomposeSoftmaxPass> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     IRRewriter rewriter(context);
-    if (failed(convertSoftmaxToGenerics(getOperation())))
+    if (failed(convertSoftmaxToGenerics(getOperation(), controlFn)))
       return signalPassFailure();
   }
+
+private:
+  DecomposeSoftmaxControlFn controlFn;
 };
 
 } // namespace
@@ -205,6 +215,11 @@ std::unique_ptr<Pass> createDecomposeSoftmaxPass() {
   return std::make_unique<DecomposeSoftmaxPass>();
 }
 
+std::unique_ptr<Pass>
+createDecomposeSoftmaxPass(DecomposeSoftmaxControlFn controlFn) {
+  return std::make_unique<DecomposeSoftmaxPass>(std::move(controlFn));
+}
+
 } // namespace LinalgExt
 } // namespace IREE
 } // namespace iree_compiler
@@ -100,6 +100,7 @@ chooseEncodingInfo(RankedTensorType tensorType) {
   case EncodingUser::MATMUL_BF16BF16F32:
   case EncodingUser::MATMUL_BF16BF16BF16:
   case EncodingUser::MATMUL_I8I8I32:
+  case EncodingUser::MATMUL_I8I4I32:
   case EncodingUser::BATCH_MATMUL_F32F32F32:
   case EncodingUser::BATCH_MATMUL_F16F16F32:
   case EncodingUser::BATCH_MATMUL_F16F16F16:
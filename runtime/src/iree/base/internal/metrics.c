@@ -0,0 +1,540 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/metrics.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+
+//===----------------------------------------------------------------------===//
+// iree_metric_t
+//===----------------------------------------------------------------------===//
+
+struct iree_metric_t {
+  // Next metric in registration order.
+  iree_metric_t* next;
+  // Next metric in the same hash bucket.
+  iree_metric_t* hash_next;
+  uint64_t hash;
+
+  iree_metric_type_t type;
+  iree_string_view_t name;
+  iree_string_view_t labels;
+  iree_string_view_t help;
+
+  // Counter/gauge value or histogram sum.
+  iree_atomic_int64_t value;
+  // Histogram observation count and per-bucket counts.
+  iree_atomic_int64_t count;
+  iree_atomic_int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT];
+
+  // + trailing name/labels/help storage
+};
+
+int64_t iree_metric_histogram_bucket_bound(iree_host_size_t bucket_index) {
+  if (bucket_index >= IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1) return INT64_MAX;
+  return 1ll << bucket_index;
+}
+
+// Returns the index of the smallest bucket whose bound is >= |value|.
+static iree_host_size_t iree_metric_histogram_bucket_index(int64_t value) {
+  if (value <= 1) return 0;
+  iree_host_size_t index =
+      64 - iree_math_count_leading_zeros_u64((uint64_t)value - 1);
+  return iree_min(index, IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+void iree_metric_add(iree_metric_t* metric, int64_t delta) {
+  if (!metric) return;
+  iree_atomic_fetch_add_int64(&metric->value, delta, iree_memory_order_relaxed);
+}
+
+void iree_metric_set(iree_metric_t* metric, int64_t value) {
+  if (!metric) return;
+  iree_atomic_store_int64(&metric->value, value, iree_memory_order_relaxed);
+}
+
+void iree_metric_observe(iree_metric_t* metric, int64_t value) {
+  if (!metric) return;
+  iree_atomic_fetch_add_int64(
+      &metric->buckets[iree_metric_histogram_bucket_index(value)], 1,
+      iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&metric->value, value, iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&metric->count, 1, iree_memory_order_relaxed);
+}
+
+void iree_metric_query(iree_metric_t* metric, iree_metric_value_t* out_value) {
+  IREE_ASSERT_ARGUMENT(metric);
+  IREE_ASSERT_ARGUMENT(out_value);
+  memset(out_value, 0, sizeof(*out_value));
+  out_value->type = metric->type;
+  out_value->value =
+      iree_atomic_load_int64(&metric->value, iree_memory_order_relaxed);
+  if (metric->type != IREE_METRIC_TYPE_HISTOGRAM) return;
+  out_value->count =
+      iree_atomic_load_int64(&metric->count, iree_memory_order_relaxed);
+  for (iree_host_size_t i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+    out_value->buckets[i] =
+        iree_atomic_load_int64(&metric->buckets[i], iree_memory_order_relaxed);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_metrics_registry_t
+//===----------------------------------------------------------------------===//
+
+// Number of hash buckets used to find metrics by name/labels.
+#define IREE_METRICS_REGISTRY_HASH_BUCKET_COUNT 64
+
+// Maximum number of collectors that may be registered at a time.
+#define IREE_METRICS_REGISTRY_MAX_COLLECTOR_COUNT 32
+
+struct iree_metrics_registry_t {
+  iree_allocator_t host_allocator;
+
+  // Guards the metric lists and collectors. Metric values are updated
+  // atomically without holding the mutex.
+  iree_slim_mutex_t mutex;
+
+  // All metrics in registration order.
+  iree_metric_t* metric_head;
+  iree_metric_t* metric_tail;
+  iree_metric_t* hash_buckets[IREE_METRICS_REGISTRY_HASH_BUCKET_COUNT];
+
+  iree_host_size_t collector_count;
+  iree_metrics_collector_t
+      collectors[IREE_METRICS_REGISTRY_MAX_COLLECTOR_COUNT];
+};
+
+static iree_atomic_intptr_t iree_metrics_default_registry_ptr;
+
+iree_status_t iree_metrics_format_parse(iree_string_view_t value,
+                                        iree_metrics_format_t* out_format) {
+  IREE_ASSERT_ARGUMENT(out_format);
+  if (iree_string_view_equal(value, IREE_SV("json"))) {
+    *out_format = IREE_METRICS_FORMAT_JSON;
+  } else if (iree_string_view_equal(value, IREE_SV("prometheus"))) {
+    *out_format = IREE_METRICS_FORMAT_PROMETHEUS;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown metrics format '%.*s'; expected `json` "
+                            "or `prometheus`",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_metrics_registry_create(
+    iree_allocator_t host_allocator, iree_metrics_registry_t** out_registry) {
+  IREE_ASSERT_ARGUMENT(out_registry);
+  *out_registry = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_metrics_registry_t* registry = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*registry),
+                                (void**)&registry));
+  registry->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&registry->mutex);
+
+  *out_registry = registry;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_metrics_registry_free(iree_metrics_registry_t* registry) {
+  if (!registry) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = registry->host_allocator;
+
+  // Guard against freeing the registry while it is still the default.
+  intptr_t expected = (intptr_t)registry;
+  iree_atomic_compare_exchange_strong_intptr(
+      &iree_metrics_default_registry_ptr, &expected, 0,
+      iree_memory_order_acq_rel, iree_memory_order_relaxed);
+
+  iree_metric_t* metric = registry->metric_head;
+  while (metric) {
+    iree_metric_t* next = metric->next;
+    iree_allocator_free(host_allocator, metric);
+    metric = next;
+  }
+
+  iree_slim_mutex_deinitialize(&registry->mutex);
+  iree_allocator_free(host_allocator, registry);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_metrics_registry_t* iree_metrics_registry_default(void) {
+  return (iree_metrics_registry_t*)iree_atomic_load_intptr(
+      &iree_metrics_default_registry_ptr, iree_memory_order_acquire);
+}
+
+void iree_metrics_registry_set_default(iree_metrics_registry_t* registry) {
+  iree_atomic_store_intptr(&iree_metrics_default_registry_ptr,
+                           (intptr_t)registry, iree_memory_order_release);
+}
+
+// FNV-1a over the name and labels; a separator keeps `ab`+`c` != `a`+`bc`.
+static uint64_t iree_metrics_hash(iree_string_view_t name,
+                                  iree_string_view_t labels) {
+  uint64_t hash = 14695981039346656037ull;
+  for (iree_host_size_t i = 0; i < name.size; ++i) {
+    hash = (hash ^ (uint8_t)name.data[i]) * 1099511628211ull;
+  }
+  hash = (hash ^ 0xFFu) * 1099511628211ull;
+  for (iree_host_size_t i = 0; i < labels.size; ++i) {
+    hash = (hash ^ (uint8_t)labels.data[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+static const char* iree_metric_type_name(iree_metric_type_t type) {
+  switch (type) {
+    case IREE_METRIC_TYPE_COUNTER:
+      return "counter";
+    case IREE_METRIC_TYPE_GAUGE:
+      return "gauge";
+    case IREE_METRIC_TYPE_HISTOGRAM:
+      return "histogram";
+    default:
+      return "untyped";
+  }
+}
+
+iree_status_t iree_metrics_registry_lookup_or_create(
+    iree_metrics_registry_t* registry, iree_metric_type_t type,
+    iree_string_view_t name, iree_string_view_t labels,
+    iree_string_view_t help, iree_metric_t** out_metric) {
+  IREE_ASSERT_ARGUMENT(registry);
+  IREE_ASSERT_ARGUMENT(out_metric);
+  *out_metric = NULL;
+  if (iree_string_view_is_empty(name)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "metrics must have a name");
+  }
+
+  const uint64_t hash = iree_metrics_hash(name, labels);
+  iree_metric_t** bucket =
+      &registry->hash_buckets[hash % IREE_METRICS_REGISTRY_HASH_BUCKET_COUNT];
+
+  iree_slim_mutex_lock(&registry->mutex);
+
+  // Fast path: return an existing metric.
+  for (iree_metric_t* metric = *bucket; metric; metric = metric->hash_next) {
+    if (metric->hash != hash || !iree_string_view_equal(metric->name, name) ||
+        !iree_string_view_equal(metric->labels, labels)) {
+      continue;
+    }
+    iree_status_t status = iree_ok_status();
+    if (metric->type == type) {
+      *out_metric = metric;
+    } else {
+      status = iree_make_status(
+          IREE_STATUS_ALREADY_EXISTS,
+          "metric '%.*s{%.*s}' already registered as a %s", (int)name.size,
+          name.data, (int)labels.size, labels.data,
+          iree_metric_type_name(metric->type));
+    }
+    iree_slim_mutex_unlock(&registry->mutex);
+    return status;
+  }
+
+  // Allocate the metric with its strings inline.
+  iree_metric_t* metric = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      registry->host_allocator,
+      sizeof(*metric) + name.size + labels.size + help.size, (void**)&metric);
+  if (iree_status_is_ok(status)) {
+    char* string_ptr = (char*)metric + sizeof(*metric);
+    memcpy(string_ptr, name.data, name.size);
+    metric->name = iree_make_string_view(string_ptr, name.size);
+    string_ptr += name.size;
+    if (labels.size) memcpy(string_ptr, labels.data, labels.size);
+    metric->labels = iree_make_string_view(string_ptr, labels.size);
+    string_ptr += labels.size;
+    if (help.size) memcpy(string_ptr, help.data, help.size);
+    metric->help = iree_make_string_view(string_ptr, help.size);
+    metric->type = type;
+    metric->hash = hash;
+
+    metric->hash_next = *bucket;
+    *bucket = metric;
+    if (registry->metric_tail) {
+      registry->metric_tail->next = metric;
+    } else {
+      registry->metric_head = metric;
+    }
+    registry->metric_tail = metric;
+    *out_metric = metric;
+  }
+
+  iree_slim_mutex_unlock(&registry->mutex);
+  return status;
+}
+
+iree_status_t iree_metrics_registry_register_collector(
+    iree_metrics_registry_t* registry, iree_metrics_collector_t collector) {
+  IREE_ASSERT_ARGUMENT(registry);
+  IREE_ASSERT_ARGUMENT(collector.fn);
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&registry->mutex);
+  if (registry->collector_count < IREE_ARRAYSIZE(registry->collectors)) {
+    registry->collectors[registry->collector_count++] = collector;
+  } else {
+    status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "too many metrics collectors registered (%d)",
+                              IREE_METRICS_REGISTRY_MAX_COLLECTOR_COUNT);
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+  return status;
+}
+
+void iree_metrics_registry_unregister_collector(
+    iree_metrics_registry_t* registry, iree_metrics_collector_t collector) {
+  IREE_ASSERT_ARGUMENT(registry);
+  iree_slim_mutex_lock(&registry->mutex);
+  for (iree_host_size_t i = 0; i < registry->collector_count; ++i) {
+    if (registry->collectors[i].fn == collector.fn &&
+        registry->collectors[i].user_data == collector.user_data) {
+      memmove(&registry->collectors[i], &registry->collectors[i + 1],
+              (registry->collector_count - i - 1) *
+                  sizeof(registry->collectors[0]));
+      --registry->collector_count;
+      break;
+    }
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+}
+
+//===----------------------------------------------------------------------===//
+// Formatting
+//===----------------------------------------------------------------------===//
+
+// Splits the next `key="value"` pair off of |labels|.
+// Values are kept in their escaped form as Prometheus label escaping (\\, \",
+// \n) is a subset of JSON string escaping.
+static bool iree_metrics_split_label(iree_string_view_t* labels,
+                                     iree_string_view_t* out_key,
+                                     iree_string_view_t* out_value) {
+  iree_string_view_t remaining = *labels;
+  iree_host_size_t equals = iree_string_view_find_char(remaining, '=', 0);
+  if (equals == IREE_STRING_VIEW_NPOS || equals + 1 >= remaining.size ||
+      remaining.data[equals + 1] != '"') {
+    return false;
+  }
+  *out_key =
+      iree_string_view_trim(iree_string_view_substr(remaining, 0, equals));
+  iree_host_size_t value_start = equals + 2;
+  iree_host_size_t value_end = value_start;
+  while (value_end < remaining.size && remaining.data[value_end] != '"') {
+    if (remaining.data[value_end] == '\\') ++value_end;
+    ++value_end;
+  }
+  if (value_end >= remaining.size) return false;
+  *out_value = iree_make_string_view(remaining.data + value_start,
+                                     value_end - value_start);
+  remaining = iree_string_view_substr(remaining, value_end + 1,
+                                      IREE_STRING_VIEW_NPOS);
+  iree_string_view_consume_prefix(&remaining, IREE_SV(","));
+  *labels = remaining;
+  return true;
+}
+
+static iree_status_t iree_metrics_format_json_metric(
+    iree_metric_t* metric, iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "{\"name\":\"%.*s\",\"type\":\"%s\",\"labels\":{",
+      (int)metric->name.size, metric->name.data,
+      iree_metric_type_name(metric->type)));
+  iree_string_view_t labels = metric->labels;
+  iree_string_view_t key = iree_string_view_empty();
+  iree_string_view_t value = iree_string_view_empty();
+  for (bool first = true; iree_metrics_split_label(&labels, &key, &value);
+       first = false) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%s\"%.*s\":\"%.*s\"", first ? "" : ",", (int)key.size,
+        key.data, (int)value.size, value.data));
+  }
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, "}"));
+
+  iree_metric_value_t snapshot;
+  iree_metric_query(metric, &snapshot);
+  if (metric->type != IREE_METRIC_TYPE_HISTOGRAM) {
+    return iree_string_builder_append_format(builder, ",\"value\":%" PRId64 "}",
+                                             snapshot.value);
+  }
+
+  // Histograms emit only non-empty buckets to keep the output compact.
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, ",\"count\":%" PRId64 ",\"sum\":%" PRId64 ",\"buckets\":[",
+      snapshot.count, snapshot.value));
+  bool first = true;
+  for (iree_host_size_t i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+    if (!snapshot.buckets[i]) continue;
+    int64_t bound = iree_metric_histogram_bucket_bound(i);
+    if (bound == INT64_MAX) {
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+          builder, "%s{\"le\":\"+Inf\",\"count\":%" PRId64 "}",
+          first ? "" : ",", snapshot.buckets[i]));
+    } else {
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+          builder, "%s{\"le\":%" PRId64 ",\"count\":%" PRId64 "}",
+          first ? "" : ",", bound, snapshot.buckets[i]));
+    }
+    first = false;
+  }
+  return iree_string_builder_append_cstring(builder, "]}");
+}
+
+static iree_status_t iree_metrics_format_json(iree_metrics_registry_t* registry,
+                                              iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(
+      iree_string_builder_append_cstring(builder, "{\"metrics\":["));
+  for (iree_metric_t* metric = registry->metric_head; metric;
+       metric = metric->next) {
+    if (metric != registry->metric_head) {
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, ","));
+    }
+    IREE_RETURN_IF_ERROR(iree_metrics_format_json_metric(metric, builder));
+  }
+  return iree_string_builder_append_cstring(builder, "]}\n");
+}
+
+// Appends `name{labels[,extra_label]}` to |builder|.
+static iree_status_t iree_metrics_format_prometheus_series(
+    iree_metric_t* metric, const char* suffix, const char* extra_label,
+    iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "%.*s%s", (int)metric->name.size, metric->name.data, suffix));
+  if (iree_string_view_is_empty(metric->labels) && !extra_label) {
+    return iree_ok_status();
+  }
+  return iree_string_builder_append_format(
+      builder, "{%.*s%s%s}", (int)metric->labels.size, metric->labels.data,
+      !iree_string_view_is_empty(metric->labels) && extra_label ? "," : "",
+      extra_label ? extra_label : "");
+}
+
+static iree_status_t iree_metrics_format_prometheus_metric(
+    iree_metric_t* metric, iree_string_builder_t* builder) {
+  iree_metric_value_t snapshot;
+  iree_metric_query(metric, &snapshot);
+  if (metric->type != IREE_METRIC_TYPE_HISTOGRAM) {
+    IREE_RETURN_IF_ERROR(
+        iree_metrics_format_prometheus_series(metric, "", NULL, builder));
+    return iree_string_builder_append_format(builder, " %" PRId64 "\n",
+                                             snapshot.value);
+  }
+
+  // Prometheus buckets are cumulative. We skip leading empty buckets and stop
+  // once all observations are accounted for to keep the output small; +Inf is
+  // always emitted.
+  int64_t cumulative_count = 0;
+  for (iree_host_size_t i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1;
+       ++i) {
+    if (cumulative_count == 0 && snapshot.buckets[i] == 0) continue;
+    cumulative_count += snapshot.buckets[i];
+    char le_label[32];
+    snprintf(le_label, sizeof(le_label), "le=\"%" PRId64 "\"",
+             iree_metric_histogram_bucket_bound(i));
+    IREE_RETURN_IF_ERROR(iree_metrics_format_prometheus_series(
+        metric, "_bucket", le_label, builder));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, " %" PRId64 "\n", cumulative_count));
+    if (cumulative_count >= snapshot.count) break;
+  }
+  IREE_RETURN_IF_ERROR(iree_metrics_format_prometheus_series(
+      metric, "_bucket", "le=\"+Inf\"", builder));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, " %" PRId64 "\n", snapshot.count));
+  IREE_RETURN_IF_ERROR(
+      iree_metrics_format_prometheus_series(metric, "_sum", NULL, builder));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, " %" PRId64 "\n", snapshot.value));
+  IREE_RETURN_IF_ERROR(
+      iree_metrics_format_prometheus_series(metric, "_count", NULL, builder));
+  return iree_string_builder_append_format(builder, " %" PRId64 "\n",
+                                           snapshot.count);
+}
+
+static iree_status_t iree_metrics_format_prometheus(
+    iree_metrics_registry_t* registry, iree_string_builder_t* builder) {
+  // The exposition format requires all series of a metric family be grouped
+  // under a single HELP/TYPE header. Metrics are stored in registration order
+  // so we emit each family when we first encounter its name.
+  for (iree_metric_t* family = registry->metric_head; family;
+       family = family->next) {
+    bool already_emitted = false;
+    for (iree_metric_t* prior = registry->metric_head; prior != family;
+         prior = prior->next) {
+      if (iree_string_view_equal(prior->name, family->name)) {
+        already_emitted = true;
+        break;
+      }
+    }
+    if (already_emitted) continue;
+    if (!iree_string_view_is_empty(family->help)) {
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+          builder, "# HELP %.*s %.*s\n", (int)family->name.size,
+          family->name.data, (int)family->help.size, family->help.data));
+    }
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "# TYPE %.*s %s\n", (int)family->name.size, family->name.data,
+        iree_metric_type_name(family->type)));
+    for (iree_metric_t* metric = family; metric; metric = metric->next) {
+      if (!iree_string_view_equal(metric->name, family->name)) continue;
+      IREE_RETURN_IF_ERROR(
+          iree_metrics_format_prometheus_metric(metric, builder));
+    }
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_metrics_registry_format(iree_metrics_registry_t* registry,
+                                           iree_metrics_format_t format,
+                                           iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(registry);
+  IREE_ASSERT_ARGUMENT(builder);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Run collectors outside of the lock as they will register/update metrics.
+  iree_slim_mutex_lock(&registry->mutex);
+  iree_host_size_t collector_count = registry->collector_count;
+  iree_metrics_collector_t
+      collectors[IREE_METRICS_REGISTRY_MAX_COLLECTOR_COUNT];
+  memcpy(collectors, registry->collectors,
+         collector_count * sizeof(collectors[0]));
+  iree_slim_mutex_unlock(&registry->mutex);
+  for (iree_host_size_t i = 0; i < collector_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, collectors[i].fn(collectors[i].user_data, registry));
+  }
+
+  iree_slim_mutex_lock(&registry->mutex);
+  iree_status_t status = iree_ok_status();
+  switch (format) {
+    case IREE_METRICS_FORMAT_JSON:
+      status = iree_metrics_format_json(registry, builder);
+      break;
+    case IREE_METRICS_FORMAT_PROMETHEUS:
+      status = iree_metrics_format_prometheus(registry, builder);
+      break;
+    default:
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unsupported metrics format %d", (int)format);
+      break;
+  }
+  iree_slim_mutex_unlock(&registry->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
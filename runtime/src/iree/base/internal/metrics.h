@@ -0,0 +1,169 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Low-overhead always-on runtime metrics.
+//
+// A registry holds named counters, gauges, and histograms that runtime
+// components record into as they execute. Unlike tracing this is intended to
+// be enabled in production: recording is a handful of relaxed atomic adds and
+// metrics are only resolved by name when a component is created so that hot
+// paths just hold iree_metric_t pointers. All record functions accept NULL
+// metrics as no-ops such that components can unconditionally record and only
+// pay for the NULL check when no registry has been installed.
+//
+// Metrics are identified by a name and an optional preformatted label set in
+// Prometheus syntax (`queue="0",device="local"`); registering the same
+// name/labels twice returns the same metric. The registry can be formatted as
+// JSON or Prometheus text exposition format for export.
+//
+// Example:
+//   iree_metrics_registry_t* registry = NULL;
+//   iree_metrics_registry_create(host_allocator, &registry);
+//   iree_metrics_registry_set_default(registry);
+//   ... create devices/contexts and run ...
+//   iree_string_builder_t builder;
+//   iree_string_builder_initialize(host_allocator, &builder);
+//   iree_metrics_registry_format(registry, IREE_METRICS_FORMAT_PROMETHEUS,
+//                                &builder);
+//   iree_metrics_registry_set_default(NULL);
+//   ... release devices/contexts ...
+//   iree_metrics_registry_free(registry);
+
+#ifndef IREE_BASE_INTERNAL_METRICS_H_
+#define IREE_BASE_INTERNAL_METRICS_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_metric_t
+//===----------------------------------------------------------------------===//
+
+// Number of buckets in each histogram.
+// Bucket 0 holds values <= 1 and bucket i holds values in (2^(i-1), 2^i]. The
+// final bucket holds all values larger than the preceding bucket bounds. With
+// nanosecond values this covers ~1ns to ~550s.
+#define IREE_METRIC_HISTOGRAM_BUCKET_COUNT 41
+
+typedef enum iree_metric_type_e {
+  // Monotonically increasing value (such as a number of events).
+  IREE_METRIC_TYPE_COUNTER = 0,
+  // Value that may go up or down (such as bytes in use).
+  IREE_METRIC_TYPE_GAUGE = 1,
+  // Distribution of observed values (such as latencies).
+  IREE_METRIC_TYPE_HISTOGRAM = 2,
+} iree_metric_type_t;
+
+// A single named metric within a registry.
+// Metrics are owned by their registry and remain valid until it is freed.
+typedef struct iree_metric_t iree_metric_t;
+
+// A point-in-time snapshot of a metric value.
+typedef struct iree_metric_value_t {
+  iree_metric_type_t type;
+  // Counter/gauge value or the sum of all observed values for histograms.
+  int64_t value;
+  // Total number of observations for histograms (0 for others).
+  int64_t count;
+  // Number of observations in each histogram bucket (non-cumulative).
+  int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT];
+} iree_metric_value_t;
+
+// Returns the inclusive upper bound of histogram bucket |bucket_index| or
+// INT64_MAX for the final bucket.
+int64_t iree_metric_histogram_bucket_bound(iree_host_size_t bucket_index);
+
+// Adds |delta| to a counter or gauge |metric|. No-op if |metric| is NULL.
+void iree_metric_add(iree_metric_t* metric, int64_t delta);
+
+// Sets a gauge |metric| to |value|. No-op if |metric| is NULL.
+void iree_metric_set(iree_metric_t* metric, int64_t value);
+
+// Records |value| in a histogram |metric|. No-op if |metric| is NULL.
+void iree_metric_observe(iree_metric_t* metric, int64_t value);
+
+// Queries a snapshot of the current |metric| value.
+// As fields are updated independently it's possible for the snapshot to tear
+// (the count may not equal the total of the buckets, etc).
+void iree_metric_query(iree_metric_t* metric, iree_metric_value_t* out_value);
+
+//===----------------------------------------------------------------------===//
+// iree_metrics_registry_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_metrics_registry_t iree_metrics_registry_t;
+
+// Called prior to formatting a registry to allow sources that are expensive
+// to track incrementally (such as allocator statistics) to update gauges.
+typedef struct iree_metrics_collector_t {
+  iree_status_t(IREE_API_PTR* fn)(void* user_data,
+                                  iree_metrics_registry_t* registry);
+  void* user_data;
+} iree_metrics_collector_t;
+
+// Output formats supported by iree_metrics_registry_format.
+typedef enum iree_metrics_format_e {
+  // JSON object with a `metrics` array containing one object per metric.
+  IREE_METRICS_FORMAT_JSON = 0,
+  // Prometheus text exposition format.
+  IREE_METRICS_FORMAT_PROMETHEUS = 1,
+} iree_metrics_format_t;
+
+// Parses a metrics format from a string (`json` or `prometheus`).
+iree_status_t iree_metrics_format_parse(iree_string_view_t value,
+                                        iree_metrics_format_t* out_format);
+
+// Creates an empty metrics registry.
+// Thread-safe: metrics may be registered, recorded, and formatted from any
+// thread concurrently.
+iree_status_t iree_metrics_registry_create(
+    iree_allocator_t host_allocator, iree_metrics_registry_t** out_registry);
+
+// Frees |registry| and all metrics it contains. Any component holding metrics
+// from the registry must have been destroyed prior to freeing it.
+void iree_metrics_registry_free(iree_metrics_registry_t* registry);
+
+// Returns the process-wide default registry or NULL if none is installed.
+// Components query this when created to decide whether to record metrics.
+iree_metrics_registry_t* iree_metrics_registry_default(void);
+
+// Installs |registry| as the process-wide default (or NULL to uninstall).
+// Only components created after the registry is installed will record into
+// it. The caller retains ownership of the registry.
+void iree_metrics_registry_set_default(iree_metrics_registry_t* registry);
+
+// Returns the metric with the given |name| and |labels| in |registry|,
+// creating it with |type| and |help| text if it does not exist.
+// |labels| is either empty or a comma-separated list of `key="value"` pairs.
+// Fails if a metric with the same name/labels exists with a different type.
+iree_status_t iree_metrics_registry_lookup_or_create(
+    iree_metrics_registry_t* registry, iree_metric_type_t type,
+    iree_string_view_t name, iree_string_view_t labels,
+    iree_string_view_t help, iree_metric_t** out_metric);
+
+// Registers a |collector| that will be called prior to each format.
+// The collector must be unregistered before its user data is released.
+iree_status_t iree_metrics_registry_register_collector(
+    iree_metrics_registry_t* registry, iree_metrics_collector_t collector);
+
+// Unregisters a previously registered |collector|.
+void iree_metrics_registry_unregister_collector(
+    iree_metrics_registry_t* registry, iree_metrics_collector_t collector);
+
+// Runs all collectors and appends all metrics in |registry| to |builder| in
+// the given |format|. Metrics are emitted in registration order.
+iree_status_t iree_metrics_registry_format(iree_metrics_registry_t* registry,
+                                           iree_metrics_format_t format,
+                                           iree_string_builder_t* builder);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_METRICS_H_
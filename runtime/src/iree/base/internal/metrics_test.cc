@@ -0,0 +1,198 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/metrics.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::testing::HasSubstr;
+
+class MetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_metrics_registry_create(iree_allocator_system(), &registry_));
+  }
+
+  void TearDown() override { iree_metrics_registry_free(registry_); }
+
+  iree_metric_t* Lookup(iree_metric_type_t type, const char* name,
+                        const char* labels = "") {
+    iree_metric_t* metric = NULL;
+    IREE_CHECK_OK(iree_metrics_registry_lookup_or_create(
+        registry_, type, iree_make_cstring_view(name),
+        iree_make_cstring_view(labels), IREE_SV("Help text."), &metric));
+    return metric;
+  }
+
+  std::string Format(iree_metrics_format_t format) {
+    iree_string_builder_t builder;
+    iree_string_builder_initialize(iree_allocator_system(), &builder);
+    IREE_CHECK_OK(iree_metrics_registry_format(registry_, format, &builder));
+    std::string result(iree_string_builder_buffer(&builder),
+                       iree_string_builder_size(&builder));
+    iree_string_builder_deinitialize(&builder);
+    return result;
+  }
+
+  iree_metrics_registry_t* registry_ = NULL;
+};
+
+TEST_F(MetricsTest, NullMetricsAreNoOps) {
+  iree_metric_add(NULL, 1);
+  iree_metric_set(NULL, 1);
+  iree_metric_observe(NULL, 1);
+}
+
+TEST_F(MetricsTest, LookupReturnsSameMetric) {
+  iree_metric_t* a = Lookup(IREE_METRIC_TYPE_COUNTER, "a", "x=\"0\"");
+  iree_metric_t* b = Lookup(IREE_METRIC_TYPE_COUNTER, "a", "x=\"1\"");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(a, Lookup(IREE_METRIC_TYPE_COUNTER, "a", "x=\"0\""));
+}
+
+TEST_F(MetricsTest, LookupTypeMismatch) {
+  Lookup(IREE_METRIC_TYPE_COUNTER, "a");
+  iree_metric_t* metric = NULL;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_ALREADY_EXISTS,
+      iree_metrics_registry_lookup_or_create(
+          registry_, IREE_METRIC_TYPE_GAUGE, IREE_SV("a"),
+          iree_string_view_empty(), iree_string_view_empty(), &metric));
+}
+
+TEST_F(MetricsTest, CounterAndGauge) {
+  iree_metric_t* counter = Lookup(IREE_METRIC_TYPE_COUNTER, "counter");
+  iree_metric_add(counter, 2);
+  iree_metric_add(counter, 3);
+  iree_metric_t* gauge = Lookup(IREE_METRIC_TYPE_GAUGE, "gauge");
+  iree_metric_set(gauge, 10);
+  iree_metric_add(gauge, -4);
+
+  iree_metric_value_t value;
+  iree_metric_query(counter, &value);
+  EXPECT_EQ(value.value, 5);
+  iree_metric_query(gauge, &value);
+  EXPECT_EQ(value.value, 6);
+}
+
+TEST_F(MetricsTest, HistogramBuckets) {
+  iree_metric_t* histogram = Lookup(IREE_METRIC_TYPE_HISTOGRAM, "histogram");
+  iree_metric_observe(histogram, 0);
+  iree_metric_observe(histogram, 1);
+  iree_metric_observe(histogram, 2);
+  iree_metric_observe(histogram, 3);
+  iree_metric_observe(histogram, 1000);
+  iree_metric_observe(histogram, INT64_MAX);
+
+  iree_metric_value_t value;
+  iree_metric_query(histogram, &value);
+  EXPECT_EQ(value.count, 6);
+  EXPECT_EQ(value.buckets[0], 2);  // <= 1
+  EXPECT_EQ(value.buckets[1], 1);  // (1, 2]
+  EXPECT_EQ(value.buckets[2], 1);  // (2, 4]
+  EXPECT_EQ(value.buckets[10], 1);  // (512, 1024]
+  EXPECT_EQ(value.buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1], 1);
+  EXPECT_EQ(iree_metric_histogram_bucket_bound(10), 1024);
+  EXPECT_EQ(iree_metric_histogram_bucket_bound(
+                IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1),
+            INT64_MAX);
+}
+
+TEST_F(MetricsTest, ConcurrentRecording) {
+  iree_metric_t* histogram = Lookup(IREE_METRIC_TYPE_HISTOGRAM, "histogram");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 1000; ++j) iree_metric_observe(histogram, 8);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  iree_metric_value_t value;
+  iree_metric_query(histogram, &value);
+  EXPECT_EQ(value.count, 4000);
+  EXPECT_EQ(value.value, 4000 * 8);
+  EXPECT_EQ(value.buckets[3], 4000);
+}
+
+TEST_F(MetricsTest, FormatJSON) {
+  iree_metric_add(Lookup(IREE_METRIC_TYPE_COUNTER, "requests", "fn=\"m.f\""),
+                  7);
+  iree_metric_observe(Lookup(IREE_METRIC_TYPE_HISTOGRAM, "latency"), 3);
+  EXPECT_EQ(Format(IREE_METRICS_FORMAT_JSON),
+            "{\"metrics\":["
+            "{\"name\":\"requests\",\"type\":\"counter\","
+            "\"labels\":{\"fn\":\"m.f\"},\"value\":7},"
+            "{\"name\":\"latency\",\"type\":\"histogram\",\"labels\":{},"
+            "\"count\":1,\"sum\":3,\"buckets\":[{\"le\":4,\"count\":1}]}"
+            "]}\n");
+}
+
+TEST_F(MetricsTest, FormatPrometheus) {
+  iree_metric_observe(
+      Lookup(IREE_METRIC_TYPE_HISTOGRAM, "latency", "fn=\"m.f\""), 3);
+  iree_metric_add(Lookup(IREE_METRIC_TYPE_COUNTER, "requests"), 1);
+  iree_metric_observe(
+      Lookup(IREE_METRIC_TYPE_HISTOGRAM, "latency", "fn=\"m.g\""), 2);
+  EXPECT_EQ(Format(IREE_METRICS_FORMAT_PROMETHEUS),
+            "# HELP latency Help text.\n"
+            "# TYPE latency histogram\n"
+            "latency_bucket{fn=\"m.f\",le=\"4\"} 1\n"
+            "latency_bucket{fn=\"m.f\",le=\"+Inf\"} 1\n"
+            "latency_sum{fn=\"m.f\"} 3\n"
+            "latency_count{fn=\"m.f\"} 1\n"
+            "latency_bucket{fn=\"m.g\",le=\"2\"} 1\n"
+            "latency_bucket{fn=\"m.g\",le=\"+Inf\"} 1\n"
+            "latency_sum{fn=\"m.g\"} 2\n"
+            "latency_count{fn=\"m.g\"} 1\n"
+            "# HELP requests Help text.\n"
+            "# TYPE requests counter\n"
+            "requests 1\n");
+}
+
+TEST_F(MetricsTest, Collectors) {
+  iree_metrics_collector_t collector = {
+      +[](void* user_data, iree_metrics_registry_t* registry) {
+        iree_metric_t* metric = NULL;
+        IREE_RETURN_IF_ERROR(iree_metrics_registry_lookup_or_create(
+            registry, IREE_METRIC_TYPE_GAUGE, IREE_SV("collected"),
+            iree_string_view_empty(), iree_string_view_empty(), &metric));
+        iree_metric_set(metric, ++*(int*)user_data);
+        return iree_ok_status();
+      },
+  };
+  int call_count = 0;
+  collector.user_data = &call_count;
+  IREE_ASSERT_OK(
+      iree_metrics_registry_register_collector(registry_, collector));
+  EXPECT_THAT(Format(IREE_METRICS_FORMAT_PROMETHEUS),
+              HasSubstr("collected 1\n"));
+  iree_metrics_registry_unregister_collector(registry_, collector);
+  EXPECT_THAT(Format(IREE_METRICS_FORMAT_PROMETHEUS),
+              HasSubstr("collected 1\n"));
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST(MetricsDefaultRegistryTest, SetDefault) {
+  EXPECT_EQ(iree_metrics_registry_default(), nullptr);
+  iree_metrics_registry_t* registry = NULL;
+  IREE_ASSERT_OK(
+      iree_metrics_registry_create(iree_allocator_system(), &registry));
+  iree_metrics_registry_set_default(registry);
+  EXPECT_EQ(iree_metrics_registry_default(), registry);
+  // Freeing the default registry uninstalls it.
+  iree_metrics_registry_free(registry);
+  EXPECT_EQ(iree_metrics_registry_default(), nullptr);
+}
+
+}  // namespace
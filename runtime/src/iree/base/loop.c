@@ -182,6 +182,32 @@ IREE_API_EXPORT iree_status_t iree_loop_wait_all(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t
+iree_loop_wait_idle(iree_loop_t loop, iree_timeout_t timeout,
+                    iree_loop_callback_fn_t callback, void* user_data) {
+  if (IREE_UNLIKELY(!loop.ctl)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "null loop");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Capture time as an absolute value as we don't know when it's going to run.
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+
+  const iree_loop_wait_idle_params_t params = {
+      .callback =
+          {
+              .fn = callback,
+              .user_data = user_data,
+          },
+      .deadline_ns = deadline_ns,
+  };
+  iree_status_t status =
+      loop.ctl(loop.self, IREE_LOOP_COMMAND_WAIT_IDLE, &params, NULL);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_loop_drain(iree_loop_t loop,
                                               iree_timeout_t timeout) {
   if (IREE_UNLIKELY(!loop.ctl)) {
@@ -182,6 +182,18 @@ IREE_API_EXPORT iree_status_t iree_loop_wait_all(
     iree_loop_t loop, iree_host_size_t count, iree_wait_source_t* wait_sources,
     iree_timeout_t timeout, iree_loop_callback_fn_t callback, void* user_data);
 
+// Waits until the loop has no other pending work or |timeout| is reached and
+// then issues |callback|. Pending idle waits do not count as work and all of
+// them are issued once the loop goes idle. This can be used to perform
+// deferred maintenance (trimming pools, flushing logs, etc) without delaying
+// active work.
+//
+// The callback is guaranteed to be issued.
+// |user_data| is not retained and must be live until the callback is issued.
+IREE_API_EXPORT iree_status_t
+iree_loop_wait_idle(iree_loop_t loop, iree_timeout_t timeout,
+                    iree_loop_callback_fn_t callback, void* user_data);
+
 // Blocks the caller and waits until the loop is idle or |timeout| is reached.
 //
 // Not all implementations support this and may return
@@ -219,8 +231,6 @@ enum iree_loop_command_e {
   // can do scatter/gather I/O with io_uring.
   // Want something with an fd, flags, count, and iree_byte_span_t's.
 
-  // TODO(benvanik): IREE_LOOP_COMMAND_WAIT_IDLE to get idle callbacks.
-
   // Sleeps until the timeout is reached then issues the callback.
   // The callback will always be called (including when aborted).
   //
@@ -262,7 +272,17 @@ enum iree_loop_command_e {
   //   inout_ptr: unused
   IREE_LOOP_COMMAND_DRAIN,
 
-  IREE_LOOP_COMMAND_MAX = IREE_LOOP_COMMAND_DRAIN,
+  // Waits until the loop has no pending work other than idle waits then issues
+  // the callback. The callback will always be called (including when aborted)
+  // and receives IREE_STATUS_DEADLINE_EXCEEDED if the deadline is reached
+  // before the loop goes idle.
+  //
+  // iree_loop_ctl_fn_t:
+  //   params: iree_loop_wait_idle_params_t
+  //   inout_ptr: unused
+  IREE_LOOP_COMMAND_WAIT_IDLE,
+
+  IREE_LOOP_COMMAND_MAX = IREE_LOOP_COMMAND_WAIT_IDLE,
 };
 
 typedef struct iree_loop_callback_t {
@@ -323,6 +343,15 @@ typedef struct iree_loop_wait_multi_params_t {
   iree_wait_source_t* wait_sources;
 } iree_loop_wait_multi_params_t;
 
+// Parameters for IREE_LOOP_COMMAND_WAIT_IDLE.
+typedef struct iree_loop_wait_idle_params_t {
+  // Callback issued once the loop is idle.
+  iree_loop_callback_t callback;
+  // Maximum time to wait before failing the wait with
+  // IREE_STATUS_DEADLINE_EXCEEDED.
+  iree_time_t deadline_ns;
+} iree_loop_wait_idle_params_t;
+
 // Parameters for IREE_LOOP_COMMAND_DRAIN.
 typedef struct iree_loop_drain_params_t {
   // Time when the wait will abort.
@@ -0,0 +1,150 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/wait_handle.h"
+#include "iree/base/loop_sync.h"
+#include "iree/base/loop_threaded.h"
+
+namespace {
+
+//==============================================================================
+// Loop wrappers
+//==============================================================================
+
+class SyncLoop {
+ public:
+  explicit SyncLoop(iree_host_size_t max_count) {
+    iree_loop_sync_options_t options = {0};
+    options.max_queue_depth = max_count * 2;
+    options.max_wait_count = max_count * 2;
+    IREE_CHECK_OK(iree_loop_sync_allocate(options, iree_allocator_system(),
+                                          &loop_sync_));
+    iree_loop_sync_scope_initialize(loop_sync_, NULL, NULL, &scope_);
+  }
+  ~SyncLoop() {
+    iree_loop_sync_scope_deinitialize(&scope_);
+    iree_loop_sync_free(loop_sync_);
+  }
+  iree_loop_t loop() { return iree_loop_sync_scope(&scope_); }
+
+ private:
+  iree_loop_sync_t* loop_sync_ = NULL;
+  iree_loop_sync_scope_t scope_;
+};
+
+class ThreadedLoop {
+ public:
+  explicit ThreadedLoop(iree_host_size_t max_count) {
+    iree_loop_threaded_options_t options = {0};
+    options.worker_count = 4;
+    options.initial_queue_depth = max_count;
+    options.initial_wait_count = max_count;
+    IREE_CHECK_OK(iree_loop_threaded_allocate(options, iree_allocator_system(),
+                                              &loop_threaded_));
+    iree_loop_threaded_scope_initialize(loop_threaded_, NULL, NULL, &scope_);
+  }
+  ~ThreadedLoop() {
+    iree_loop_threaded_scope_deinitialize(&scope_);
+    iree_loop_threaded_free(loop_threaded_);
+  }
+  iree_loop_t loop() { return iree_loop_threaded_scope(&scope_); }
+
+ private:
+  iree_loop_threaded_t* loop_threaded_ = NULL;
+  iree_loop_threaded_scope_t scope_;
+};
+
+//==============================================================================
+// iree_loop_call
+//==============================================================================
+
+// Emulates a small amount of work performed by each callback.
+iree_status_t SpinCallback(void* user_data, iree_loop_t loop,
+                           iree_status_t status) {
+  int data = 0;
+  for (int i = 0; i < 1000; ++i) {
+    ++data;
+    benchmark::DoNotOptimize(data);
+  }
+  return status;
+}
+
+// Enqueues a batch of independent calls and drains the loop.
+template <typename LoopType>
+void BM_CallFanout(benchmark::State& state) {
+  const iree_host_size_t call_count = (iree_host_size_t)state.range(0);
+  LoopType loop_type(call_count);
+  iree_loop_t loop = loop_type.loop();
+  for (auto _ : state) {
+    for (iree_host_size_t i = 0; i < call_count; ++i) {
+      IREE_CHECK_OK(
+          iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT, SpinCallback, NULL));
+    }
+    IREE_CHECK_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  }
+  state.SetItemsProcessed(state.iterations() * call_count);
+}
+BENCHMARK_TEMPLATE(BM_CallFanout, SyncLoop)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_CallFanout, ThreadedLoop)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+//==============================================================================
+// iree_loop_wait_one
+//==============================================================================
+
+iree_status_t NopCallback(void* user_data, iree_loop_t loop,
+                          iree_status_t status) {
+  return status;
+}
+
+// Enqueues waits on many events and then signals them all. Measures the cost
+// of registering and scanning waits as the number outstanding grows.
+template <typename LoopType>
+void BM_WaitMany(benchmark::State& state) {
+  const iree_host_size_t wait_count = (iree_host_size_t)state.range(0);
+  LoopType loop_type(wait_count);
+  iree_loop_t loop = loop_type.loop();
+  std::vector<iree_event_t> events(wait_count);
+  for (auto& event : events) {
+    IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &event));
+  }
+  for (auto _ : state) {
+    for (auto& event : events) {
+      IREE_CHECK_OK(iree_loop_wait_one(loop, iree_event_await(&event),
+                                       iree_infinite_timeout(), NopCallback,
+                                       NULL));
+    }
+    for (auto& event : events) iree_event_set(&event);
+    IREE_CHECK_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+    for (auto& event : events) iree_event_reset(&event);
+  }
+  for (auto& event : events) iree_event_deinitialize(&event);
+  state.SetItemsProcessed(state.iterations() * wait_count);
+}
+BENCHMARK_TEMPLATE(BM_WaitMany, SyncLoop)
+    ->Arg(16)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_WaitMany, ThreadedLoop)
+    ->Arg(16)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
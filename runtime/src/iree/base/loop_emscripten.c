@@ -182,6 +182,18 @@ static iree_status_t iree_loop_emscripten_run_wait_all(
   return status;
 }
 
+static iree_status_t iree_loop_emscripten_run_wait_idle(
+    iree_loop_emscripten_t* loop_emscripten,
+    iree_loop_wait_idle_params_t* params) {
+  iree_loop_t loop = iree_loop_emscripten(loop_emscripten);
+  uint32_t timeout_ms =
+      iree_absolute_deadline_to_timeout_ms(params->deadline_ns);
+  return iree_loop_command(loop_emscripten->scope, IREE_LOOP_COMMAND_WAIT_IDLE,
+                           params->callback.fn, params->callback.user_data,
+                           timeout_ms, /*promise_handles_count=*/0,
+                           /*promise_handles=*/NULL, loop);
+}
+
 // Control function for the Emscripten loop.
 IREE_API_EXPORT iree_status_t
 iree_loop_emscripten_ctl(void* self, iree_loop_command_t command,
@@ -210,6 +222,9 @@ iree_loop_emscripten_ctl(void* self, iree_loop_command_t command,
     case IREE_LOOP_COMMAND_WAIT_ALL:
       return iree_loop_emscripten_run_wait_all(
           loop_emscripten, (iree_loop_wait_multi_params_t*)params);
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
+      return iree_loop_emscripten_run_wait_idle(
+          loop_emscripten, (iree_loop_wait_idle_params_t*)params);
     case IREE_LOOP_COMMAND_DRAIN:
       return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
                               "unsupported loop command");
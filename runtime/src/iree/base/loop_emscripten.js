@@ -21,6 +21,7 @@ const LibraryIreeLoopEmscripten = {
     const IREE_STATUS_OK = 0;
     const IREE_STATUS_CODE_MASK = 0x1F;
     const IREE_STATUS_INVALID_ARGUMENT = 3 & IREE_STATUS_CODE_MASK;
+    const IREE_STATUS_DEADLINE_EXCEEDED = 4 & IREE_STATUS_CODE_MASK;
     const IREE_STATUS_ABORTED = 10 & IREE_STATUS_CODE_MASK;
     const IREE_STATUS_UNIMPLEMENTED = 12 & IREE_STATUS_CODE_MASK;
 
@@ -31,6 +32,7 @@ const LibraryIreeLoopEmscripten = {
     const IREE_LOOP_COMMAND_WAIT_ONE = 3;
     const IREE_LOOP_COMMAND_WAIT_ANY = 4;
     const IREE_LOOP_COMMAND_WAIT_ALL = 5;
+    const IREE_LOOP_COMMAND_WAIT_IDLE = 7;
 
     class LoopCommand {
       abort() {}
@@ -50,7 +52,7 @@ const LibraryIreeLoopEmscripten = {
               [this.userData, this.loop, IREE_STATUS_OK]);
           // TODO(scotttodd): handle the returned status (sticky failure state?)
           //     at least free the status so it doesn't leak
-          delete scope.pendingOperations[operationId];
+          scope.removeOperation(operationId);
         }, 0);
       }
 
@@ -95,7 +97,7 @@ const LibraryIreeLoopEmscripten = {
                   [this.userData, this.loop, IREE_STATUS_ABORTED]);
             })
             .finally(() => {
-              delete scope.pendingOperations[operationId];
+              scope.removeOperation(operationId);
             });
       }
 
@@ -155,7 +157,7 @@ const LibraryIreeLoopEmscripten = {
                   [this.userData, this.loop, IREE_STATUS_ABORTED]);
             })
             .finally(() => {
-              delete scope.pendingOperations[operationId];
+              scope.removeOperation(operationId);
             });
       }
 
@@ -164,6 +166,50 @@ const LibraryIreeLoopEmscripten = {
       }
     }
 
+    class LoopCommandWaitIdle extends LoopCommand {
+      constructor(scope, operationId, callback, userData, timeoutMs, loop) {
+        super();
+
+        this.scope = scope;
+        this.operationId = operationId;
+        this.callback = callback;
+        this.userData = userData;
+        this.loop = loop;
+
+        // The loop may already be idle: check once the current task completes
+        // so that the callback is never issued reentrantly. This is scheduled
+        // before the timeout so that an immediate timeout on an idle loop
+        // still succeeds.
+        this.idleTimeoutId = setTimeout(() => {
+          scope.notifyIfIdle();
+        }, 0);
+        this.deadlineTimeoutId = undefined;
+        if (timeoutMs >= 0 && timeoutMs < 2147483647) {
+          this.deadlineTimeoutId = setTimeout(() => {
+            this.complete(IREE_STATUS_DEADLINE_EXCEEDED);
+          }, timeoutMs);
+        }
+      }
+
+      complete(status) {
+        clearTimeout(this.idleTimeoutId);
+        clearTimeout(this.deadlineTimeoutId);
+        delete this.scope.pendingOperations[this.operationId];
+        Module['dynCall'](
+            'iiii', this.callback, [this.userData, this.loop, status]);
+        // TODO(scotttodd): handle the returned status (sticky failure state?)
+        //     at least free the status so it doesn't leak
+      }
+
+      abort() {
+        clearTimeout(this.idleTimeoutId);
+        clearTimeout(this.deadlineTimeoutId);
+        Module['dynCall'](
+            'iiii', this.callback,
+            [this.userData, this.loop, IREE_STATUS_ABORTED]);
+      }
+    }
+
     class LoopEmscriptenScope {
       constructor() {
         // Note: start at 1, leaving 0 as a sentinel for uninitialized.
@@ -181,6 +227,26 @@ const LibraryIreeLoopEmscripten = {
         }
       }
 
+      // Removes a completed operation and issues any idle waits if it was the
+      // last pending work.
+      removeOperation(operationId) {
+        delete this.pendingOperations[operationId];
+        this.notifyIfIdle();
+      }
+
+      // Issues all pending idle waits if there is no other pending work.
+      notifyIfIdle() {
+        const idleWaits = [];
+        for (const id in this.pendingOperations) {
+          const operation = this.pendingOperations[id];
+          if (!(operation instanceof LoopCommandWaitIdle)) return;
+          idleWaits.push(operation);
+        }
+        for (const operation of idleWaits) {
+          operation.complete(IREE_STATUS_OK);
+        }
+      }
+
       runCommand(command, callback, userData, timeoutMs, waitPromises, loop) {
         // TODO(scotttodd): assert not destroyed to avoid reentrant queueing?
         const operationId = this.nextOperationId++;
@@ -213,6 +279,10 @@ const LibraryIreeLoopEmscripten = {
                 this, operationId, callback, userData, timeoutMs, allPromise,
                 loop);
             break;
+          case IREE_LOOP_COMMAND_WAIT_IDLE:
+            this.pendingOperations[operationId] = new LoopCommandWaitIdle(
+                this, operationId, callback, userData, timeoutMs, loop);
+            break;
           default:
             return IREE_STATUS_UNIMPLEMENTED;
         }
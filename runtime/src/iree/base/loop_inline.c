@@ -191,6 +191,21 @@ static void iree_loop_inline_run_wait_all(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// IREE_LOOP_COMMAND_WAIT_IDLE
+// Only called once all other pending operations have run.
+static void iree_loop_inline_run_wait_idle(
+    iree_loop_t loop, iree_loop_wait_idle_params_t params) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status =
+      params.callback.fn(params.callback.user_data, loop, iree_ok_status());
+  if (!iree_status_is_ok(status)) {
+    iree_loop_inline_emit_error(loop, status);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_loop_inline_ring_t
 //===----------------------------------------------------------------------===//
@@ -223,6 +238,7 @@ typedef struct iree_loop_inline_op_t {
       iree_loop_wait_until_params_t wait_until;
       iree_loop_wait_one_params_t wait_one;
       iree_loop_wait_multi_params_t wait_multi;
+      iree_loop_wait_idle_params_t wait_idle;
     } params;
   };
 } iree_loop_inline_op_t;
@@ -242,6 +258,8 @@ static inline uint8_t iree_loop_params_size(iree_loop_command_t command) {
     case IREE_LOOP_COMMAND_WAIT_ANY:
     case IREE_LOOP_COMMAND_WAIT_ALL:
       return sizeof(iree_loop_wait_multi_params_t);
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
+      return sizeof(iree_loop_wait_idle_params_t);
     default:
       return 0;
   }
@@ -329,6 +347,15 @@ static iree_status_t iree_loop_inline_enqueue(iree_loop_inline_ring_t* ring,
   return iree_ok_status();
 }
 
+// Returns true if all operations in |ring| are idle waits.
+static bool iree_loop_inline_ring_is_idle(const iree_loop_inline_ring_t* ring) {
+  for (uint8_t i = ring->read_head; i != ring->write_head;
+       i = (i + 1) & IREE_LOOP_INLINE_RING_MASK) {
+    if (ring->ops[i].command != IREE_LOOP_COMMAND_WAIT_IDLE) return false;
+  }
+  return true;
+}
+
 // Dequeues the next operation in |ring| and executes it.
 // The operation may reentrantly enqueue more operations.
 static void iree_loop_inline_dequeue_and_run_next(
@@ -370,6 +397,16 @@ static void iree_loop_inline_dequeue_and_run_next(
     case IREE_LOOP_COMMAND_WAIT_ALL:
       iree_loop_inline_run_wait_all(loop, op.params.wait_multi);
       break;
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
+      if (iree_loop_inline_ring_is_idle(ring)) {
+        iree_loop_inline_run_wait_idle(loop, op.params.wait_idle);
+      } else {
+        // Other work is still pending; move to the back of the ring. This
+        // can't fail as we just dequeued the op.
+        iree_status_ignore(iree_loop_inline_enqueue(ring, op.command,
+                                                    &op.params.wait_idle));
+      }
+      break;
     default:
       break;
   }
@@ -32,6 +32,8 @@ static_assert(offsetof(iree_loop_wait_one_params_t, callback) == 0,
               "callback must be at offset 0");
 static_assert(offsetof(iree_loop_wait_multi_params_t, callback) == 0,
               "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_idle_params_t, callback) == 0,
+              "callback must be at offset 0");
 
 static void iree_loop_sync_abort_scope(iree_loop_sync_t* loop_sync,
                                        iree_loop_sync_scope_t* scope);
@@ -230,6 +232,7 @@ typedef struct iree_loop_wait_op_t {
       iree_loop_wait_until_params_t wait_until;
       iree_loop_wait_one_params_t wait_one;
       iree_loop_wait_multi_params_t wait_multi;
+      iree_loop_wait_idle_params_t wait_idle;
     } params;
   };
   iree_loop_command_t command;
@@ -386,6 +389,7 @@ static iree_status_t iree_loop_wait_list_insert(
   iree_status_t status = iree_ok_status();
   switch (op.command) {
     case IREE_LOOP_COMMAND_WAIT_UNTIL:
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
       // No entry in the wait set; we just need it in the list in order to scan.
       break;
     case IREE_LOOP_COMMAND_WAIT_ONE: {
@@ -563,6 +567,34 @@ static iree_status_t iree_loop_wait_list_scan_wait_all(
                         : iree_ok_status();
 }
 
+// Returns DEFERRED if unresolved, OK if resolved, and an error otherwise.
+// If resolved (successful or not) the caller must erase the wait.
+static iree_status_t iree_loop_wait_list_scan_wait_idle(
+    iree_loop_wait_list_t* wait_list, iree_loop_wait_idle_params_t* params,
+    bool is_idle, iree_time_t now_ns, iree_time_t* earliest_deadline_ns) {
+  if (is_idle) {
+    return iree_ok_status();
+  } else if (params->deadline_ns <= now_ns) {
+    // Deadline reached without the loop going idle.
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  } else {
+    // Still waiting.
+    *earliest_deadline_ns =
+        iree_min(*earliest_deadline_ns, params->deadline_ns);
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+}
+
+// Returns true if there is no pending work other than idle waits.
+static bool iree_loop_wait_list_is_idle(iree_loop_wait_list_t* wait_list,
+                                        iree_loop_run_ring_t* run_ring) {
+  if (!iree_loop_run_ring_is_empty(run_ring)) return false;
+  for (iree_host_size_t i = 0; i < wait_list->count; ++i) {
+    if (wait_list->ops[i].command != IREE_LOOP_COMMAND_WAIT_IDLE) return false;
+  }
+  return true;
+}
+
 static void iree_loop_wait_list_handle_wake(iree_loop_wait_list_t* wait_list,
                                             iree_loop_run_ring_t* run_ring,
                                             iree_wait_handle_t wake_handle) {
@@ -587,6 +619,7 @@ static iree_status_t iree_loop_wait_list_scan(
   *out_earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
 
   iree_time_t now_ns = iree_time_now();
+  const bool is_idle = iree_loop_wait_list_is_idle(wait_list, run_ring);
   iree_status_t scan_status = iree_ok_status();
   for (iree_host_size_t i = 0;
        i < wait_list->count && iree_status_is_ok(scan_status); ++i) {
@@ -612,6 +645,11 @@ static iree_status_t iree_loop_wait_list_scan(
             wait_list, &wait_list->ops[i].params.wait_multi, now_ns,
             out_earliest_deadline_ns);
         break;
+      case IREE_LOOP_COMMAND_WAIT_IDLE:
+        wait_status = iree_loop_wait_list_scan_wait_idle(
+            wait_list, &wait_list->ops[i].params.wait_idle, is_idle, now_ns,
+            out_earliest_deadline_ns);
+        break;
     }
     if (!iree_status_is_deferred(wait_status)) {
       // Wait completed/failed - erase from the wait set and op list.
@@ -1089,6 +1127,17 @@ IREE_API_EXPORT iree_status_t iree_loop_sync_ctl(void* self,
                           *(const iree_loop_wait_multi_params_t*)params,
                   },
           });
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
+      return iree_loop_wait_list_insert(
+          loop_sync->wait_list,
+          (iree_loop_wait_op_t){
+              .command = command,
+              .scope = scope,
+              .params =
+                  {
+                      .wait_idle = *(const iree_loop_wait_idle_params_t*)params,
+                  },
+          });
     case IREE_LOOP_COMMAND_DRAIN:
       return iree_loop_sync_drain_scope(
           loop_sync, scope,
@@ -975,5 +975,163 @@ TEST_F(LoopTest, WaitAllBlocking) {
   iree_event_deinitialize(&resolved_event);
 }
 
+//===----------------------------------------------------------------------===//
+// iree_loop_wait_idle
+//===----------------------------------------------------------------------===//
+
+// Tests an idle wait on a loop with no other work.
+TEST_F(LoopTest, WaitIdleEmpty) {
+  IREE_TRACE_SCOPE();
+  struct UserData {
+    iree_status_t wait_status = iree_status_from_code(IREE_STATUS_DATA_LOSS);
+  } user_data;
+  IREE_ASSERT_OK(iree_loop_wait_idle(
+      loop, iree_infinite_timeout(),
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+        user_data->wait_status = status;
+        return iree_ok_status();
+      },
+      &user_data));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  IREE_ASSERT_OK(user_data.wait_status);
+}
+
+// Tests that an idle wait is only issued after calls enqueued after it.
+TEST_F(LoopTest, WaitIdleAfterCalls) {
+  IREE_TRACE_SCOPE();
+  struct UserData {
+    int call_count = 0;
+    int calls_before_idle = -1;
+  } user_data;
+
+  // A -> [idle, B -> C]
+  IREE_ASSERT_OK(iree_loop_call(
+      loop, IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        IREE_EXPECT_OK(status);
+        auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+        ++user_data->call_count;
+
+        // idle
+        IREE_EXPECT_OK(iree_loop_wait_idle(
+            loop, iree_infinite_timeout(),
+            +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+              IREE_TRACE_SCOPE();
+              IREE_EXPECT_OK(status);
+              auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+              user_data->calls_before_idle = user_data->call_count;
+              return iree_ok_status();
+            },
+            user_data));
+
+        // B
+        IREE_EXPECT_OK(iree_loop_call(
+            loop, IREE_LOOP_PRIORITY_DEFAULT,
+            +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+              IREE_TRACE_SCOPE();
+              IREE_EXPECT_OK(status);
+              auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+              ++user_data->call_count;
+
+              // C
+              IREE_EXPECT_OK(iree_loop_call(
+                  loop, IREE_LOOP_PRIORITY_DEFAULT,
+                  +[](void* user_data_ptr, iree_loop_t loop,
+                      iree_status_t status) {
+                    IREE_TRACE_SCOPE();
+                    IREE_EXPECT_OK(status);
+                    auto* user_data =
+                        reinterpret_cast<UserData*>(user_data_ptr);
+                    ++user_data->call_count;
+                    return iree_ok_status();
+                  },
+                  user_data));
+
+              return iree_ok_status();
+            },
+            user_data));
+
+        return iree_ok_status();
+      },
+      &user_data));
+
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_EQ(3, user_data.call_count);
+  EXPECT_EQ(3, user_data.calls_before_idle);
+}
+
+// Tests that an idle wait is only issued after pending timed waits.
+TEST_F(LoopTest, WaitIdleAfterWaitUntil) {
+  IREE_TRACE_SCOPE();
+  struct UserData {
+    bool did_wait_until = false;
+    bool waited_before_idle = false;
+  } user_data;
+
+  // Issue the waits from a call so that loops executing inline enqueue both
+  // before running either.
+  IREE_ASSERT_OK(iree_loop_call(
+      loop, IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        IREE_EXPECT_OK(status);
+        IREE_EXPECT_OK(iree_loop_wait_idle(
+            loop, iree_infinite_timeout(),
+            +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+              IREE_TRACE_SCOPE();
+              IREE_EXPECT_OK(status);
+              auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+              user_data->waited_before_idle = user_data->did_wait_until;
+              return iree_ok_status();
+            },
+            user_data_ptr));
+        IREE_EXPECT_OK(iree_loop_wait_until(
+            loop, iree_make_timeout_ms(10),
+            +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+              IREE_TRACE_SCOPE();
+              IREE_EXPECT_OK(status);
+              auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+              user_data->did_wait_until = true;
+              return iree_ok_status();
+            },
+            user_data_ptr));
+        return iree_ok_status();
+      },
+      &user_data));
+
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_TRUE(user_data.did_wait_until);
+  EXPECT_TRUE(user_data.waited_before_idle);
+}
+
+// Tests that all pending idle waits are issued once the loop goes idle.
+TEST_F(LoopTest, MultiWaitIdle) {
+  IREE_TRACE_SCOPE();
+  struct UserData {
+    int idle_count = 0;
+  } user_data;
+  for (int i = 0; i < 3; ++i) {
+    IREE_ASSERT_OK(iree_loop_wait_idle(
+        loop, iree_infinite_timeout(),
+        +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+          IREE_TRACE_SCOPE();
+          IREE_EXPECT_OK(status);
+          auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+          ++user_data->idle_count;
+          return iree_ok_status();
+        },
+        &user_data));
+  }
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_EQ(3, user_data.idle_count);
+}
+
 }  // namespace testing
 }  // namespace iree
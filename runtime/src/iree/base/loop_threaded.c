@@ -0,0 +1,1347 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_threaded.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/base/internal/wait_handle.h"
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_t utilities
+//===----------------------------------------------------------------------===//
+
+// NOTE: all callbacks should be at offset 0. This allows for easily zipping
+// through the params lists and issuing callbacks.
+static_assert(offsetof(iree_loop_call_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_dispatch_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_until_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_one_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_multi_params_t, callback) == 0,
+              "callback must be at offset 0");
+static_assert(offsetof(iree_loop_wait_idle_params_t, callback) == 0,
+              "callback must be at offset 0");
+
+// Internal command used to run a portion of a dispatch on a worker.
+#define IREE_LOOP_THREADED_COMMAND_DISPATCH_SLICE (IREE_LOOP_COMMAND_MAX + 1)
+
+// Minimum capacity of the growable lists.
+#define IREE_LOOP_THREADED_MIN_CAPACITY 16
+
+typedef struct iree_loop_threaded_dispatch_t iree_loop_threaded_dispatch_t;
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_run_queue_t
+//===----------------------------------------------------------------------===//
+
+// Represents an operation in the run queue.
+typedef struct iree_loop_threaded_run_op_t {
+  union {
+    iree_loop_callback_t callback;  // asserted at offset 0 above
+    union {
+      iree_loop_call_params_t call;
+      iree_loop_dispatch_params_t dispatch;
+    } params;
+  };
+  iree_loop_command_t command;
+  iree_loop_threaded_scope_t* scope;
+
+  // True if the operation is a resolved idle wait that is not counted as
+  // active work.
+  bool is_idle;
+
+  // Shared state for IREE_LOOP_THREADED_COMMAND_DISPATCH_SLICE.
+  iree_loop_threaded_dispatch_t* dispatch;
+
+  // Set on calls when we are issuing a callback for a resolved wait.
+  // Unlike other pointers in the params this is owned by the queue.
+  iree_status_t status;
+} iree_loop_threaded_run_op_t;
+
+// Growable FIFO ringbuffer of operations ready to run.
+// The capacity is always a power of two.
+typedef struct iree_loop_threaded_run_queue_t {
+  iree_loop_threaded_run_op_t* ops;
+  iree_host_size_t capacity;
+  iree_host_size_t read_head;
+  iree_host_size_t count;
+} iree_loop_threaded_run_queue_t;
+
+// Grows |run_queue| such that it can hold at least |min_capacity| operations.
+static iree_status_t iree_loop_threaded_run_queue_reserve(
+    iree_loop_threaded_run_queue_t* run_queue, iree_host_size_t min_capacity,
+    iree_allocator_t allocator) {
+  if (IREE_LIKELY(min_capacity <= run_queue->capacity)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t new_capacity =
+      iree_max(IREE_LOOP_THREADED_MIN_CAPACITY, run_queue->capacity);
+  while (new_capacity < min_capacity) new_capacity *= 2;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)new_capacity);
+
+  iree_loop_threaded_run_op_t* new_ops = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, new_capacity * sizeof(*new_ops),
+                                (void**)&new_ops));
+
+  // Unwrap the ring into the new storage.
+  for (iree_host_size_t i = 0; i < run_queue->count; ++i) {
+    new_ops[i] = run_queue->ops[(run_queue->read_head + i) &
+                                (run_queue->capacity - 1)];
+  }
+  iree_allocator_free(allocator, run_queue->ops);
+  run_queue->ops = new_ops;
+  run_queue->capacity = new_capacity;
+  run_queue->read_head = 0;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Enqueues |op| into |run_queue|. The caller must have reserved capacity.
+static void iree_loop_threaded_run_queue_enqueue(
+    iree_loop_threaded_run_queue_t* run_queue,
+    const iree_loop_threaded_run_op_t* op) {
+  IREE_ASSERT_LT(run_queue->count, run_queue->capacity);
+  iree_host_size_t slot =
+      (run_queue->read_head + run_queue->count) & (run_queue->capacity - 1);
+  run_queue->ops[slot] = *op;
+  ++run_queue->count;
+  IREE_TRACE_PLOT_VALUE_I64("iree_loop_queue_depth", run_queue->count);
+}
+
+static bool iree_loop_threaded_run_queue_dequeue(
+    iree_loop_threaded_run_queue_t* run_queue,
+    iree_loop_threaded_run_op_t* out_op) {
+  if (!run_queue->count) return false;
+  *out_op = run_queue->ops[run_queue->read_head];
+  run_queue->read_head = (run_queue->read_head + 1) & (run_queue->capacity - 1);
+  --run_queue->count;
+  IREE_TRACE_PLOT_VALUE_I64("iree_loop_queue_depth", run_queue->count);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_wait_list_t
+//===----------------------------------------------------------------------===//
+
+// Represents an operation in the wait list.
+// Note that the storage may be reallocated at any time and all pointers must be
+// external to the storage in order to remain valid.
+typedef struct iree_loop_threaded_wait_op_t {
+  union {
+    iree_loop_callback_t callback;  // asserted at offset 0 above
+    union {
+      iree_loop_wait_until_params_t wait_until;
+      iree_loop_wait_one_params_t wait_one;
+      iree_loop_wait_multi_params_t wait_multi;
+      iree_loop_wait_idle_params_t wait_idle;
+    } params;
+  };
+  iree_loop_command_t command;
+  iree_loop_threaded_scope_t* scope;
+
+  // True once the wait sources have been inserted into the wait set.
+  bool registered;
+
+  // Snapshot of whether the operation has been aborted, updated by the wait
+  // thread on each scan.
+  bool aborted;
+
+  // Status passed to the callback once resolved.
+  iree_status_t status;
+} iree_loop_threaded_wait_op_t;
+
+// Growable dense list of wait operations. Order is not preserved.
+typedef struct iree_loop_threaded_wait_list_t {
+  iree_loop_threaded_wait_op_t* ops;
+  iree_host_size_t capacity;
+  iree_host_size_t count;
+} iree_loop_threaded_wait_list_t;
+
+// Grows |wait_list| such that it can hold at least |min_capacity| operations.
+static iree_status_t iree_loop_threaded_wait_list_reserve(
+    iree_loop_threaded_wait_list_t* wait_list, iree_host_size_t min_capacity,
+    iree_allocator_t allocator) {
+  if (IREE_LIKELY(min_capacity <= wait_list->capacity)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t new_capacity =
+      iree_max(IREE_LOOP_THREADED_MIN_CAPACITY, wait_list->capacity);
+  while (new_capacity < min_capacity) new_capacity *= 2;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)new_capacity);
+  iree_status_t status = iree_allocator_realloc(
+      allocator, new_capacity * sizeof(*wait_list->ops),
+      (void**)&wait_list->ops);
+  if (iree_status_is_ok(status)) {
+    wait_list->capacity = new_capacity;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_t
+//===----------------------------------------------------------------------===//
+
+struct iree_loop_threaded_t {
+  iree_allocator_t allocator;
+
+  // Guards all state shared between the worker threads, the wait thread, and
+  // threads enqueuing operations.
+  iree_slim_mutex_t mutex;
+
+  // Set when the loop is being freed. All pending operations are aborted and
+  // no new operations may be enqueued.
+  bool shutting_down;
+  // Set once all operations have retired and the threads should exit.
+  bool exit_requested;
+  // Number of threads that have been created and not yet exited.
+  int32_t live_thread_count;
+  // Set when the wake event has been signaled and the wait thread has not yet
+  // observed it. Avoids redundant signals when many waits are enqueued.
+  bool wake_requested;
+
+  // Operations ready to run on the workers.
+  iree_loop_threaded_run_queue_t run_queue;
+  // Number of dispatch slices in |run_queue|. Slices are not counted as
+  // pending operations and only use spare queue capacity.
+  iree_host_size_t queued_slice_count;
+  // Wait operations enqueued but not yet taken by the wait thread.
+  iree_loop_threaded_wait_list_t incoming_waits;
+
+  // Total number of pending operations across all scopes.
+  int32_t pending_count;
+  // Total number of pending operations excluding idle waits.
+  int32_t active_count;
+  // Total number of pending idle waits that have not yet resolved.
+  int32_t idle_wait_count;
+
+  // Posted when work is added to |run_queue| or the threads should exit.
+  iree_notification_t work_notification;
+  // Posted when a scope or the whole loop goes idle.
+  iree_notification_t idle_notification;
+
+  // Serializes calls to scope error handlers.
+  iree_slim_mutex_t error_mutex;
+
+  // Event used to wake the wait thread when its wait set or the wait list
+  // needs to be rescanned.
+  iree_event_t wake_event;
+
+  // Wait state owned exclusively by the wait thread.
+  iree_loop_threaded_wait_list_t waits;
+  iree_wait_set_t* wait_set;
+  iree_host_size_t wait_set_capacity;
+  // Conservative count of handles in |wait_set| (inserts minus erases).
+  iree_host_size_t wait_set_count;
+
+  iree_thread_t* wait_thread;
+  iree_host_size_t worker_count;
+  iree_thread_t* worker_threads[];
+};
+
+// Returns true if operations against |scope| have been aborted.
+// Must be called with the loop mutex held.
+static bool iree_loop_threaded_is_aborted(iree_loop_threaded_t* loop_threaded,
+                                          iree_loop_threaded_scope_t* scope) {
+  return loop_threaded->shutting_down || scope->is_aborted;
+}
+
+// Marks the wait thread as needing to rescan and returns true if the caller
+// must signal the wake event after releasing the loop mutex.
+static bool iree_loop_threaded_request_wake(
+    iree_loop_threaded_t* loop_threaded) {
+  if (loop_threaded->wake_requested) return false;
+  loop_threaded->wake_requested = true;
+  return true;
+}
+
+// Retires an operation from |scope| after its callback has been issued.
+static void iree_loop_threaded_retire(iree_loop_threaded_t* loop_threaded,
+                                      iree_loop_threaded_scope_t* scope,
+                                      bool is_idle) {
+  bool signal_wake = false;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  --scope->pending_count;
+  --loop_threaded->pending_count;
+  if (!is_idle && --loop_threaded->active_count == 0 &&
+      loop_threaded->idle_wait_count > 0) {
+    // Loop went idle; wake the wait thread to resolve idle waits.
+    signal_wake = iree_loop_threaded_request_wake(loop_threaded);
+  }
+  const bool post_idle =
+      scope->pending_count == 0 || loop_threaded->pending_count == 0;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  // NOTE: |scope| may be deinitialized by another thread once it is idle.
+  if (signal_wake) iree_event_set(&loop_threaded->wake_event);
+  if (post_idle) {
+    iree_notification_post(&loop_threaded->idle_notification,
+                           IREE_ALL_WAITERS);
+  }
+}
+
+// Marks the calling loop thread as exited. The loop may be freed as soon as
+// the last thread exits and |loop_threaded| must not be used afterward.
+static void iree_loop_threaded_thread_exited(
+    iree_loop_threaded_t* loop_threaded) {
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  --loop_threaded->live_thread_count;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  iree_notification_post(&loop_threaded->idle_notification, IREE_ALL_WAITERS);
+}
+
+// Aborts all pending and future operations attributed to |scope|. Operations
+// are issued with IREE_STATUS_ABORTED as they are reached by the workers and
+// wait thread.
+static void iree_loop_threaded_abort_scope(iree_loop_threaded_t* loop_threaded,
+                                           iree_loop_threaded_scope_t* scope) {
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  scope->is_aborted = true;
+  const bool signal_wake = iree_loop_threaded_request_wake(loop_threaded);
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (signal_wake) iree_event_set(&loop_threaded->wake_event);
+}
+
+// Emits |status| to the |scope| error handler and aborts associated operations.
+static void iree_loop_threaded_emit_error(iree_loop_threaded_scope_t* scope,
+                                          iree_status_t status) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(
+      z0, iree_status_code_string(iree_status_code(status)));
+
+  iree_loop_threaded_t* loop_threaded = scope->loop_threaded;
+  iree_slim_mutex_lock(&loop_threaded->error_mutex);
+  if (scope->error_fn) {
+    scope->error_fn(scope->error_user_data, status);
+  } else {
+    iree_status_ignore(status);
+  }
+  iree_slim_mutex_unlock(&loop_threaded->error_mutex);
+
+  iree_loop_threaded_abort_scope(loop_threaded, scope);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// Worker execution
+//===----------------------------------------------------------------------===//
+
+// Shared state of a dispatch split across multiple workers.
+struct iree_loop_threaded_dispatch_t {
+  iree_loop_dispatch_params_t params;
+  iree_loop_threaded_scope_t* scope;
+  // Total number of workgroups in the grid.
+  int64_t workgroup_count;
+  // Linearized index of the next workgroup to run.
+  iree_atomic_int64_t next_workgroup;
+  // Number of slices that have not yet completed. Guarded by the loop mutex.
+  int32_t remaining_slices;
+  // First failure from any workgroup. Guarded by the loop mutex.
+  iree_status_t status;
+};
+
+// Runs workgroups from |dispatch| until all have been claimed.
+// On failure the remaining workgroups are skipped by all slices.
+static iree_status_t iree_loop_threaded_dispatch_run_slice(
+    iree_loop_threaded_dispatch_t* dispatch, iree_loop_t loop) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const uint32_t workgroup_count_x = dispatch->params.workgroup_count_xyz[0];
+  const uint32_t workgroup_count_y = dispatch->params.workgroup_count_xyz[1];
+  iree_status_t status = iree_ok_status();
+  for (;;) {
+    int64_t index = iree_atomic_fetch_add_int64(&dispatch->next_workgroup, 1,
+                                                iree_memory_order_relaxed);
+    if (index >= dispatch->workgroup_count) break;
+    uint32_t x = (uint32_t)(index % workgroup_count_x);
+    uint32_t y = (uint32_t)((index / workgroup_count_x) % workgroup_count_y);
+    uint32_t z =
+        (uint32_t)(index / ((int64_t)workgroup_count_x * workgroup_count_y));
+    status = dispatch->params.workgroup_fn(dispatch->params.callback.user_data,
+                                           loop, x, y, z);
+    if (!iree_status_is_ok(status)) {
+      iree_atomic_store_int64(&dispatch->next_workgroup,
+                              dispatch->workgroup_count,
+                              iree_memory_order_relaxed);
+      break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Issues the dispatch completion callback and retires the dispatch.
+static void iree_loop_threaded_dispatch_complete(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_scope_t* scope,
+    iree_loop_callback_t callback, iree_status_t workgroup_status) {
+  iree_status_t status = callback.fn(
+      callback.user_data, iree_loop_threaded_scope(scope), workgroup_status);
+  if (!iree_status_is_ok(status)) {
+    iree_loop_threaded_emit_error(scope, status);
+  }
+  iree_loop_threaded_retire(loop_threaded, scope, /*is_idle=*/false);
+}
+
+// Completes one slice of |dispatch| and issues the completion callback if it
+// was the last.
+static void iree_loop_threaded_dispatch_end_slice(
+    iree_loop_threaded_t* loop_threaded,
+    iree_loop_threaded_dispatch_t* dispatch, iree_status_t slice_status) {
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  if (iree_status_is_ok(dispatch->status)) {
+    dispatch->status = slice_status;
+  } else {
+    iree_status_ignore(slice_status);
+  }
+  const bool is_last = --dispatch->remaining_slices == 0;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (!is_last) return;
+
+  iree_loop_threaded_scope_t* scope = dispatch->scope;
+  iree_loop_callback_t callback = dispatch->params.callback;
+  iree_status_t workgroup_status = dispatch->status;
+  iree_allocator_free(loop_threaded->allocator, dispatch);
+  iree_loop_threaded_dispatch_complete(loop_threaded, scope, callback,
+                                       workgroup_status);
+}
+
+static void iree_loop_threaded_run_call(iree_loop_threaded_t* loop_threaded,
+                                        iree_loop_threaded_run_op_t* op) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = op->callback.fn(
+      op->callback.user_data, iree_loop_threaded_scope(op->scope), op->status);
+  if (!iree_status_is_ok(status)) {
+    iree_loop_threaded_emit_error(op->scope, status);
+  }
+  iree_loop_threaded_retire(loop_threaded, op->scope, op->is_idle);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_loop_threaded_run_dispatch(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_run_op_t* op) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_loop_dispatch_params_t* params = &op->params.dispatch;
+  const int64_t workgroup_count = (int64_t)params->workgroup_count_xyz[0] *
+                                  params->workgroup_count_xyz[1] *
+                                  params->workgroup_count_xyz[2];
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, workgroup_count);
+  iree_loop_t loop = iree_loop_threaded_scope(op->scope);
+
+  // Split the grid across as many workers as have work to do. Small grids
+  // (or allocation failures) run entirely on this worker.
+  iree_host_size_t slice_count =
+      (iree_host_size_t)iree_min((int64_t)loop_threaded->worker_count,
+                                 workgroup_count);
+  iree_loop_threaded_dispatch_t* dispatch = NULL;
+  if (slice_count > 1) {
+    iree_status_t alloc_status = iree_allocator_malloc(
+        loop_threaded->allocator, sizeof(*dispatch), (void**)&dispatch);
+    if (!iree_status_is_ok(alloc_status)) {
+      iree_status_ignore(alloc_status);
+      dispatch = NULL;
+    }
+  }
+  if (!dispatch) {
+    iree_loop_threaded_dispatch_t local_dispatch = {
+        .params = *params,
+        .scope = op->scope,
+        .workgroup_count = workgroup_count,
+    };
+    iree_atomic_store_int64(&local_dispatch.next_workgroup, 0,
+                            iree_memory_order_relaxed);
+    iree_status_t workgroup_status =
+        workgroup_count > 0
+            ? iree_loop_threaded_dispatch_run_slice(&local_dispatch, loop)
+            : iree_ok_status();
+    iree_loop_threaded_dispatch_complete(loop_threaded, op->scope,
+                                         params->callback, workgroup_status);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+
+  dispatch->params = *params;
+  dispatch->scope = op->scope;
+  dispatch->workgroup_count = workgroup_count;
+  iree_atomic_store_int64(&dispatch->next_workgroup, 0,
+                          iree_memory_order_relaxed);
+  dispatch->status = iree_ok_status();
+
+  // Enqueue slices for the other workers using only spare queue capacity so
+  // that the capacity reserved for pending operations is never consumed.
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  iree_host_size_t reserved_count =
+      (iree_host_size_t)loop_threaded->pending_count +
+      loop_threaded->queued_slice_count;
+  iree_host_size_t spare_count =
+      loop_threaded->run_queue.capacity > reserved_count
+          ? loop_threaded->run_queue.capacity - reserved_count
+          : 0;
+  iree_host_size_t queued_count = iree_min(slice_count - 1, spare_count);
+  iree_loop_threaded_run_op_t slice_op = {
+      .command = IREE_LOOP_THREADED_COMMAND_DISPATCH_SLICE,
+      .scope = op->scope,
+      .dispatch = dispatch,
+  };
+  for (iree_host_size_t i = 0; i < queued_count; ++i) {
+    iree_loop_threaded_run_queue_enqueue(&loop_threaded->run_queue, &slice_op);
+  }
+  loop_threaded->queued_slice_count += queued_count;
+  dispatch->remaining_slices = (int32_t)queued_count + 1;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (queued_count > 0) {
+    iree_notification_post(&loop_threaded->work_notification,
+                           (int32_t)queued_count);
+  }
+
+  // Run our own slice; the last slice to finish issues the completion.
+  iree_status_t slice_status =
+      iree_loop_threaded_dispatch_run_slice(dispatch, loop);
+  iree_loop_threaded_dispatch_end_slice(loop_threaded, dispatch, slice_status);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Issues the callback of an aborted operation.
+// To prevent enqueuing more work while aborting we pass in a NULL loop.
+// We can't do anything with the errors so we ignore them.
+static void iree_loop_threaded_run_aborted(iree_loop_threaded_t* loop_threaded,
+                                           iree_loop_threaded_run_op_t* op) {
+  iree_status_ignore(op->status);
+  iree_status_ignore(op->callback.fn(op->callback.user_data, iree_loop_null(),
+                                     iree_make_status(IREE_STATUS_ABORTED)));
+  iree_loop_threaded_retire(loop_threaded, op->scope, op->is_idle);
+}
+
+static int iree_loop_threaded_worker_main(void* entry_arg) {
+  iree_loop_threaded_t* loop_threaded = (iree_loop_threaded_t*)entry_arg;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  for (;;) {
+    iree_loop_threaded_run_op_t op;
+    if (!iree_loop_threaded_run_queue_dequeue(&loop_threaded->run_queue,
+                                              &op)) {
+      if (loop_threaded->exit_requested) break;
+      // Prepare the wait prior to unlocking so that posts made after we
+      // observed the empty queue are not lost.
+      iree_wait_token_t wait_token =
+          iree_notification_prepare_wait(&loop_threaded->work_notification);
+      iree_slim_mutex_unlock(&loop_threaded->mutex);
+      iree_notification_commit_wait(&loop_threaded->work_notification,
+                                    wait_token, IREE_DURATION_ZERO,
+                                    IREE_TIME_INFINITE_FUTURE);
+      iree_slim_mutex_lock(&loop_threaded->mutex);
+      continue;
+    }
+    bool aborted = false;
+    if (op.command == IREE_LOOP_THREADED_COMMAND_DISPATCH_SLICE) {
+      // In-flight dispatches run to completion even if aborted.
+      --loop_threaded->queued_slice_count;
+    } else {
+      aborted = iree_loop_threaded_is_aborted(loop_threaded, op.scope);
+    }
+    iree_slim_mutex_unlock(&loop_threaded->mutex);
+
+    if (aborted) {
+      iree_loop_threaded_run_aborted(loop_threaded, &op);
+    } else {
+      switch (op.command) {
+        case IREE_LOOP_COMMAND_CALL:
+          iree_loop_threaded_run_call(loop_threaded, &op);
+          break;
+        case IREE_LOOP_COMMAND_DISPATCH:
+          iree_loop_threaded_run_dispatch(loop_threaded, &op);
+          break;
+        case IREE_LOOP_THREADED_COMMAND_DISPATCH_SLICE: {
+          iree_status_t slice_status = iree_loop_threaded_dispatch_run_slice(
+              op.dispatch, iree_loop_threaded_scope(op.scope));
+          iree_loop_threaded_dispatch_end_slice(loop_threaded, op.dispatch,
+                                                slice_status);
+          break;
+        }
+        default:
+          IREE_ASSERT_UNREACHABLE("unhandled run queue command");
+          break;
+      }
+    }
+
+    iree_slim_mutex_lock(&loop_threaded->mutex);
+  }
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  iree_loop_threaded_thread_exited(loop_threaded);
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Wait thread
+//===----------------------------------------------------------------------===//
+
+static void iree_loop_threaded_wait_set_insert(
+    iree_loop_threaded_t* loop_threaded, iree_wait_handle_t wait_handle) {
+  // Capacity was reserved prior to registration so this cannot fail.
+  IREE_CHECK_OK(iree_wait_set_insert(loop_threaded->wait_set, wait_handle));
+  ++loop_threaded->wait_set_count;
+}
+
+static void iree_loop_threaded_wait_set_erase(
+    iree_loop_threaded_t* loop_threaded, iree_wait_source_t* wait_source) {
+  if (iree_wait_source_is_immediate(*wait_source) ||
+      iree_wait_source_is_delay(*wait_source)) {
+    // Not registered or it's already been unregistered.
+    return;
+  }
+  iree_wait_handle_t* wait_handle = iree_wait_handle_from_source(wait_source);
+  if (wait_handle) {
+    iree_wait_set_erase(loop_threaded->wait_set, *wait_handle);
+    --loop_threaded->wait_set_count;
+  }
+  *wait_source = iree_wait_source_immediate();
+}
+
+// Returns the wait sources used by |op| in |out_wait_sources|.
+static iree_host_size_t iree_loop_threaded_wait_op_sources(
+    iree_loop_threaded_wait_op_t* op, iree_wait_source_t** out_wait_sources) {
+  switch (op->command) {
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+      *out_wait_sources = &op->params.wait_one.wait_source;
+      return 1;
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+      *out_wait_sources = op->params.wait_multi.wait_sources;
+      return op->params.wait_multi.count;
+    default:
+      *out_wait_sources = NULL;
+      return 0;
+  }
+}
+
+// Reallocates the wait set with at least |min_capacity| and reinserts the
+// wake event and all handles of registered waits.
+static iree_status_t iree_loop_threaded_grow_wait_set(
+    iree_loop_threaded_t* loop_threaded, iree_host_size_t min_capacity) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t new_capacity = loop_threaded->wait_set_capacity * 2;
+  while (new_capacity < min_capacity) new_capacity *= 2;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)new_capacity);
+
+  iree_wait_set_t* new_wait_set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_wait_set_allocate(new_capacity, loop_threaded->allocator,
+                                 &new_wait_set));
+  iree_wait_set_free(loop_threaded->wait_set);
+  loop_threaded->wait_set = new_wait_set;
+  loop_threaded->wait_set_capacity = new_capacity;
+  loop_threaded->wait_set_count = 0;
+
+  iree_loop_threaded_wait_set_insert(loop_threaded, loop_threaded->wake_event);
+  for (iree_host_size_t i = 0; i < loop_threaded->waits.count; ++i) {
+    iree_loop_threaded_wait_op_t* op = &loop_threaded->waits.ops[i];
+    if (!op->registered) continue;
+    iree_wait_source_t* wait_sources = NULL;
+    iree_host_size_t count =
+        iree_loop_threaded_wait_op_sources(op, &wait_sources);
+    for (iree_host_size_t j = 0; j < count; ++j) {
+      iree_wait_handle_t* wait_handle =
+          iree_wait_handle_from_source(&wait_sources[j]);
+      if (wait_handle) {
+        iree_loop_threaded_wait_set_insert(loop_threaded, *wait_handle);
+      }
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_loop_threaded_register_wait_source(
+    iree_loop_threaded_t* loop_threaded, iree_wait_source_t* wait_source) {
+  if (iree_wait_source_is_immediate(*wait_source)) {
+    // Task has been neutered and is treated as an immediately resolved wait.
+    return iree_ok_status();
+  } else if (iree_wait_source_is_delay(*wait_source)) {
+    // We can't easily support delays as registered wait sources; we need to be
+    // able to snoop the tasks to find the earliest sleep time and can't easily
+    // do that if we tried to put them in the wait set.
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "delays must come from wait-until ops");
+  }
+
+  // Acquire a wait handle and insert it into the wait set.
+  // We swap out the wait source with the handle so that we don't export it
+  // again and can find it on wake.
+  iree_wait_handle_t wait_handle = iree_wait_handle_immediate();
+  iree_wait_handle_t* wait_handle_ptr =
+      iree_wait_handle_from_source(wait_source);
+  if (wait_handle_ptr) {
+    // Already a wait handle - can directly insert it.
+    wait_handle = *wait_handle_ptr;
+  } else {
+    iree_wait_primitive_t wait_primitive = iree_wait_primitive_immediate();
+    IREE_RETURN_IF_ERROR(iree_wait_source_export(
+        *wait_source, IREE_WAIT_PRIMITIVE_TYPE_ANY, iree_immediate_timeout(),
+        &wait_primitive));
+    iree_wait_handle_wrap_primitive(wait_primitive.type, wait_primitive.value,
+                                    &wait_handle);
+    IREE_RETURN_IF_ERROR(iree_wait_source_import(wait_primitive, wait_source));
+  }
+
+  iree_loop_threaded_wait_set_insert(loop_threaded, wait_handle);
+  return iree_ok_status();
+}
+
+// Inserts all wait sources of |op| into the wait set.
+static iree_status_t iree_loop_threaded_register_wait_op(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_wait_op_t* op) {
+  iree_wait_source_t* wait_sources = NULL;
+  iree_host_size_t count =
+      iree_loop_threaded_wait_op_sources(op, &wait_sources);
+  if (count == 0) {
+    op->registered = true;
+    return iree_ok_status();
+  }
+
+  // Ensure the set can hold all of the handles so that inserts can't fail.
+  const iree_host_size_t required_capacity =
+      loop_threaded->wait_set_count + count;
+  if (required_capacity > loop_threaded->wait_set_capacity) {
+    IREE_RETURN_IF_ERROR(
+        iree_loop_threaded_grow_wait_set(loop_threaded, required_capacity));
+  }
+
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t registered_count = 0;
+  for (; registered_count < count; ++registered_count) {
+    status = iree_loop_threaded_register_wait_source(
+        loop_threaded, &wait_sources[registered_count]);
+    if (!iree_status_is_ok(status)) break;
+  }
+  if (iree_status_is_ok(status)) {
+    op->registered = true;
+  } else {
+    // Roll back the wait sources we did insert.
+    for (iree_host_size_t i = 0; i < registered_count; ++i) {
+      iree_loop_threaded_wait_set_erase(loop_threaded, &wait_sources[i]);
+    }
+  }
+  return status;
+}
+
+// Erases all wait sources of |op| from the wait set.
+static void iree_loop_threaded_unregister_wait_op(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_wait_op_t* op) {
+  if (!op->registered) return;
+  iree_wait_source_t* wait_sources = NULL;
+  iree_host_size_t count =
+      iree_loop_threaded_wait_op_sources(op, &wait_sources);
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_loop_threaded_wait_set_erase(loop_threaded, &wait_sources[i]);
+  }
+  op->registered = false;
+}
+
+// Returns DEFERRED if unresolved, OK if resolved, and an error otherwise.
+static iree_status_t iree_loop_threaded_scan_wait_op(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_wait_op_t* op,
+    bool is_idle, iree_time_t now_ns, iree_time_t* earliest_deadline_ns) {
+  if (op->aborted) return iree_status_from_code(IREE_STATUS_ABORTED);
+
+  iree_time_t deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  switch (op->command) {
+    case IREE_LOOP_COMMAND_WAIT_UNTIL: {
+      deadline_ns = op->params.wait_until.deadline_ns;
+      if (deadline_ns <= now_ns) return iree_ok_status();
+      break;
+    }
+    case IREE_LOOP_COMMAND_WAIT_IDLE: {
+      if (is_idle) return iree_ok_status();
+      deadline_ns = op->params.wait_idle.deadline_ns;
+      break;
+    }
+    case IREE_LOOP_COMMAND_WAIT_ONE: {
+      if (!op->registered) {
+        IREE_RETURN_IF_ERROR(
+            iree_loop_threaded_register_wait_op(loop_threaded, op));
+      }
+      iree_status_code_t wait_status_code = IREE_STATUS_OK;
+      IREE_RETURN_IF_ERROR(iree_wait_source_query(
+          op->params.wait_one.wait_source, &wait_status_code));
+      if (wait_status_code != IREE_STATUS_DEFERRED) {
+        return iree_status_from_code(wait_status_code);
+      }
+      deadline_ns = op->params.wait_one.deadline_ns;
+      break;
+    }
+    case IREE_LOOP_COMMAND_WAIT_ANY: {
+      if (!op->registered) {
+        IREE_RETURN_IF_ERROR(
+            iree_loop_threaded_register_wait_op(loop_threaded, op));
+      }
+      iree_loop_wait_multi_params_t* params = &op->params.wait_multi;
+      for (iree_host_size_t i = 0; i < params->count; ++i) {
+        iree_status_code_t wait_status_code = IREE_STATUS_OK;
+        IREE_RETURN_IF_ERROR(
+            iree_wait_source_query(params->wait_sources[i], &wait_status_code));
+        if (wait_status_code != IREE_STATUS_DEFERRED) {
+          // One resolved (or failed); wait-any satisfied.
+          return iree_status_from_code(wait_status_code);
+        }
+      }
+      deadline_ns = params->deadline_ns;
+      break;
+    }
+    case IREE_LOOP_COMMAND_WAIT_ALL: {
+      if (!op->registered) {
+        IREE_RETURN_IF_ERROR(
+            iree_loop_threaded_register_wait_op(loop_threaded, op));
+      }
+      iree_loop_wait_multi_params_t* params = &op->params.wait_multi;
+      bool any_unresolved = false;
+      for (iree_host_size_t i = 0; i < params->count; ++i) {
+        if (iree_wait_source_is_immediate(params->wait_sources[i])) continue;
+        iree_status_code_t wait_status_code = IREE_STATUS_OK;
+        IREE_RETURN_IF_ERROR(
+            iree_wait_source_query(params->wait_sources[i], &wait_status_code));
+        if (wait_status_code == IREE_STATUS_OK) {
+          // Wait resolved; remove it from the wait set so that we don't wait
+          // on it again. This neuters the wait source.
+          iree_loop_threaded_wait_set_erase(loop_threaded,
+                                            &params->wait_sources[i]);
+        } else if (wait_status_code == IREE_STATUS_DEFERRED) {
+          any_unresolved = true;
+        } else {
+          return iree_status_from_code(wait_status_code);
+        }
+      }
+      if (!any_unresolved) return iree_ok_status();
+      deadline_ns = params->deadline_ns;
+      break;
+    }
+    default:
+      IREE_ASSERT_UNREACHABLE("unhandled wait list command");
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled wait list command");
+  }
+
+  if (deadline_ns <= now_ns) {
+    // Deadline reached without having resolved.
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  *earliest_deadline_ns = iree_min(*earliest_deadline_ns, deadline_ns);
+  return iree_status_from_code(IREE_STATUS_DEFERRED);
+}
+
+// Scans all waits owned by the wait thread and moves resolved waits to the
+// end of the list. Returns the number of resolved waits.
+static iree_host_size_t iree_loop_threaded_scan_waits(
+    iree_loop_threaded_t* loop_threaded, bool is_idle,
+    iree_time_t* out_earliest_deadline_ns) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_loop_threaded_wait_list_t* waits = &loop_threaded->waits;
+  iree_time_t now_ns = iree_time_now();
+  iree_host_size_t live_count = waits->count;
+  for (iree_host_size_t i = 0; i < live_count;) {
+    iree_loop_threaded_wait_op_t* op = &waits->ops[i];
+    iree_status_t status = iree_loop_threaded_scan_wait_op(
+        loop_threaded, op, is_idle, now_ns, out_earliest_deadline_ns);
+    if (iree_status_is_deferred(status)) {
+      ++i;
+      continue;
+    }
+    // Wait completed/failed - erase from the wait set and swap to the end of
+    // the list where it'll be picked up for issuing.
+    iree_loop_threaded_unregister_wait_op(loop_threaded, op);
+    op->status = status;
+    --live_count;
+    if (i != live_count) {
+      iree_loop_threaded_wait_op_t resolved_op = *op;
+      *op = waits->ops[live_count];
+      waits->ops[live_count] = resolved_op;
+    }
+  }
+  const iree_host_size_t resolved_count = waits->count - live_count;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)resolved_count);
+  IREE_TRACE_PLOT_VALUE_I64("iree_loop_wait_depth", live_count);
+  IREE_TRACE_ZONE_END(z0);
+  return resolved_count;
+}
+
+// Moves the |resolved_count| waits at the end of the wait list to the run
+// queue so that their callbacks are issued on the workers.
+static void iree_loop_threaded_issue_resolved_waits(
+    iree_loop_threaded_t* loop_threaded, iree_host_size_t resolved_count) {
+  iree_loop_threaded_wait_list_t* waits = &loop_threaded->waits;
+  const iree_host_size_t live_count = waits->count - resolved_count;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  for (iree_host_size_t i = live_count; i < waits->count; ++i) {
+    iree_loop_threaded_wait_op_t* wait_op = &waits->ops[i];
+    const bool is_idle = wait_op->command == IREE_LOOP_COMMAND_WAIT_IDLE;
+    if (is_idle) --loop_threaded->idle_wait_count;
+    // Capacity for all pending operations is reserved when they are enqueued.
+    iree_loop_threaded_run_op_t run_op = {
+        .command = IREE_LOOP_COMMAND_CALL,
+        .scope = wait_op->scope,
+        .is_idle = is_idle,
+        .params =
+            {
+                .call =
+                    {
+                        .callback = wait_op->callback,
+                        .priority = IREE_LOOP_PRIORITY_DEFAULT,
+                    },
+            },
+        .status = wait_op->status,
+    };
+    iree_loop_threaded_run_queue_enqueue(&loop_threaded->run_queue, &run_op);
+  }
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  waits->count = live_count;
+  iree_notification_post(&loop_threaded->work_notification,
+                         (int32_t)resolved_count);
+}
+
+static int iree_loop_threaded_wait_main(void* entry_arg) {
+  iree_loop_threaded_t* loop_threaded = (iree_loop_threaded_t*)entry_arg;
+  iree_loop_threaded_wait_list_t* waits = &loop_threaded->waits;
+  for (;;) {
+    // Reset prior to scanning so that any wake requested after this point
+    // causes the following wait to return immediately.
+    iree_event_reset(&loop_threaded->wake_event);
+
+    iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+    iree_slim_mutex_lock(&loop_threaded->mutex);
+    loop_threaded->wake_requested = false;
+    if (loop_threaded->exit_requested) {
+      iree_slim_mutex_unlock(&loop_threaded->mutex);
+      break;
+    }
+
+    // Take ownership of newly enqueued waits. If we can't grow the list we'll
+    // leave them in the incoming list and try again shortly.
+    iree_loop_threaded_wait_list_t* incoming_waits =
+        &loop_threaded->incoming_waits;
+    if (incoming_waits->count > 0) {
+      iree_status_t status = iree_loop_threaded_wait_list_reserve(
+          waits, waits->count + incoming_waits->count,
+          loop_threaded->allocator);
+      if (iree_status_is_ok(status)) {
+        memcpy(&waits->ops[waits->count], incoming_waits->ops,
+               incoming_waits->count * sizeof(*incoming_waits->ops));
+        waits->count += incoming_waits->count;
+        incoming_waits->count = 0;
+      } else {
+        iree_status_ignore(status);
+        earliest_deadline_ns = iree_time_now() + 1000000;  // 1ms
+      }
+    }
+
+    // Snapshot the state the scan depends on so that it can run unlocked.
+    const bool is_idle = loop_threaded->active_count == 0;
+    for (iree_host_size_t i = 0; i < waits->count; ++i) {
+      iree_loop_threaded_wait_op_t* op = &waits->ops[i];
+      op->aborted = iree_loop_threaded_is_aborted(loop_threaded, op->scope);
+    }
+    iree_slim_mutex_unlock(&loop_threaded->mutex);
+
+    iree_host_size_t resolved_count = iree_loop_threaded_scan_waits(
+        loop_threaded, is_idle, &earliest_deadline_ns);
+    if (resolved_count > 0) {
+      // Don't commit the wait if we woke something; resolving waits may change
+      // the state of others (such as idle waits) and we'll loop back around.
+      iree_loop_threaded_issue_resolved_waits(loop_threaded, resolved_count);
+      continue;
+    }
+
+    // Wait until a registered wait source resolves, the wake event is set, or
+    // the earliest deadline of any wait is reached.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_loop_threaded_wait_commit");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)waits->count);
+    iree_wait_handle_t wake_handle = iree_wait_handle_immediate();
+    iree_status_t status = iree_wait_any(loop_threaded->wait_set,
+                                         earliest_deadline_ns, &wake_handle);
+    // Deadlines are handled by the scan and failures of individual wait
+    // sources are reported by their queries.
+    iree_status_ignore(status);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_loop_threaded_thread_exited(loop_threaded);
+  return 0;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_scope_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_loop_threaded_scope_initialize(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_error_fn_t error_fn,
+    void* error_user_data, iree_loop_threaded_scope_t* out_scope) {
+  memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->loop_threaded = loop_threaded;
+  out_scope->pending_count = 0;
+  out_scope->is_aborted = false;
+  out_scope->error_fn = error_fn;
+  out_scope->error_user_data = error_user_data;
+}
+
+static bool iree_loop_threaded_scope_is_idle(void* arg) {
+  iree_loop_threaded_scope_t* scope = (iree_loop_threaded_scope_t*)arg;
+  iree_slim_mutex_lock(&scope->loop_threaded->mutex);
+  const bool is_idle = scope->pending_count == 0;
+  iree_slim_mutex_unlock(&scope->loop_threaded->mutex);
+  return is_idle;
+}
+
+IREE_API_EXPORT void iree_loop_threaded_scope_deinitialize(
+    iree_loop_threaded_scope_t* scope) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_loop_threaded_t* loop_threaded = scope->loop_threaded;
+  if (loop_threaded) {
+    iree_loop_threaded_abort_scope(loop_threaded, scope);
+    iree_notification_await(&loop_threaded->idle_notification,
+                            iree_loop_threaded_scope_is_idle, scope,
+                            iree_infinite_timeout());
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_t
+//===----------------------------------------------------------------------===//
+
+static bool iree_loop_threaded_has_exited(void* arg) {
+  iree_loop_threaded_t* loop_threaded = (iree_loop_threaded_t*)arg;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  const bool has_exited = loop_threaded->live_thread_count == 0;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  return has_exited;
+}
+
+static bool iree_loop_threaded_is_idle(void* arg) {
+  iree_loop_threaded_t* loop_threaded = (iree_loop_threaded_t*)arg;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  const bool is_idle = loop_threaded->pending_count == 0;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  return is_idle;
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_threaded_allocate(
+    iree_loop_threaded_options_t options, iree_allocator_t allocator,
+    iree_loop_threaded_t** out_loop_threaded) {
+  IREE_ASSERT_ARGUMENT(out_loop_threaded);
+  *out_loop_threaded = NULL;
+  if (IREE_UNLIKELY(options.worker_count == 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "at least one worker is required");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_loop_threaded_t* loop_threaded = NULL;
+  const iree_host_size_t total_size =
+      sizeof(*loop_threaded) +
+      options.worker_count * sizeof(loop_threaded->worker_threads[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(allocator, total_size, (void**)&loop_threaded));
+  memset(loop_threaded, 0, total_size);
+  loop_threaded->allocator = allocator;
+  loop_threaded->worker_count = options.worker_count;
+  iree_slim_mutex_initialize(&loop_threaded->mutex);
+  iree_slim_mutex_initialize(&loop_threaded->error_mutex);
+  iree_notification_initialize(&loop_threaded->work_notification);
+  iree_notification_initialize(&loop_threaded->idle_notification);
+  loop_threaded->wake_event = iree_wait_handle_immediate();
+
+  iree_status_t status = iree_loop_threaded_run_queue_reserve(
+      &loop_threaded->run_queue, options.initial_queue_depth, allocator);
+  if (iree_status_is_ok(status)) {
+    status = iree_loop_threaded_wait_list_reserve(
+        &loop_threaded->incoming_waits, options.initial_wait_count, allocator);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_loop_threaded_wait_list_reserve(
+        &loop_threaded->waits, options.initial_wait_count, allocator);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_event_initialize(/*initial_state=*/false,
+                                   &loop_threaded->wake_event);
+  }
+  if (iree_status_is_ok(status)) {
+    // The wake event is always in the set so it is never empty.
+    loop_threaded->wait_set_capacity = iree_max(
+        IREE_LOOP_THREADED_MIN_CAPACITY, options.initial_wait_count + 1);
+    status = iree_wait_set_allocate(loop_threaded->wait_set_capacity,
+                                    allocator, &loop_threaded->wait_set);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_loop_threaded_wait_set_insert(loop_threaded,
+                                       loop_threaded->wake_event);
+  }
+
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  if (iree_status_is_ok(status)) {
+    thread_params.name = iree_make_cstring_view("iree-loop-wait");
+    status = iree_thread_create(iree_loop_threaded_wait_main, loop_threaded,
+                                thread_params, allocator,
+                                &loop_threaded->wait_thread);
+    if (iree_status_is_ok(status)) ++loop_threaded->live_thread_count;
+  }
+  thread_params.name = iree_make_cstring_view("iree-loop-worker");
+  for (iree_host_size_t i = 0;
+       i < options.worker_count && iree_status_is_ok(status); ++i) {
+    status = iree_thread_create(iree_loop_threaded_worker_main, loop_threaded,
+                                thread_params, allocator,
+                                &loop_threaded->worker_threads[i]);
+    if (iree_status_is_ok(status)) ++loop_threaded->live_thread_count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_loop_threaded = loop_threaded;
+  } else {
+    iree_loop_threaded_free(loop_threaded);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_loop_threaded_free(
+    iree_loop_threaded_t* loop_threaded) {
+  IREE_ASSERT_ARGUMENT(loop_threaded);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t allocator = loop_threaded->allocator;
+
+  // Abort all pending operations and wait for their callbacks to be issued
+  // with IREE_STATUS_ABORTED. New operations are rejected from this point on.
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  loop_threaded->shutting_down = true;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (loop_threaded->wait_thread) {
+    iree_event_set(&loop_threaded->wake_event);
+    iree_notification_await(&loop_threaded->idle_notification,
+                            iree_loop_threaded_is_idle, loop_threaded,
+                            iree_infinite_timeout());
+  }
+
+  // Request all threads exit and wait for them to do so. Threads may not have
+  // started running yet and releasing them only joins once they have.
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  loop_threaded->exit_requested = true;
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  iree_event_set(&loop_threaded->wake_event);
+  iree_notification_post(&loop_threaded->work_notification, IREE_ALL_WAITERS);
+  iree_notification_await(&loop_threaded->idle_notification,
+                          iree_loop_threaded_has_exited, loop_threaded,
+                          iree_infinite_timeout());
+  iree_thread_release(loop_threaded->wait_thread);
+  for (iree_host_size_t i = 0; i < loop_threaded->worker_count; ++i) {
+    iree_thread_release(loop_threaded->worker_threads[i]);
+  }
+
+  if (loop_threaded->wait_set) iree_wait_set_free(loop_threaded->wait_set);
+  iree_event_deinitialize(&loop_threaded->wake_event);
+  iree_allocator_free(allocator, loop_threaded->waits.ops);
+  iree_allocator_free(allocator, loop_threaded->incoming_waits.ops);
+  iree_allocator_free(allocator, loop_threaded->run_queue.ops);
+  iree_notification_deinitialize(&loop_threaded->idle_notification);
+  iree_notification_deinitialize(&loop_threaded->work_notification);
+  iree_slim_mutex_deinitialize(&loop_threaded->error_mutex);
+  iree_slim_mutex_deinitialize(&loop_threaded->mutex);
+  iree_allocator_free(allocator, loop_threaded);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_threaded_wait_idle(
+    iree_loop_threaded_t* loop_threaded, iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(loop_threaded);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  if (!iree_notification_await(&loop_threaded->idle_notification,
+                               iree_loop_threaded_is_idle, loop_threaded,
+                               timeout)) {
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Enqueues a runnable operation and wakes a worker to run it.
+static iree_status_t iree_loop_threaded_enqueue_run(
+    iree_loop_threaded_scope_t* scope, iree_loop_threaded_run_op_t op) {
+  iree_loop_threaded_t* loop_threaded = scope->loop_threaded;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  if (IREE_UNLIKELY(loop_threaded->shutting_down)) {
+    iree_slim_mutex_unlock(&loop_threaded->mutex);
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "new work cannot be enqueued while the loop is shutting down");
+  }
+  iree_status_t status = iree_loop_threaded_run_queue_reserve(
+      &loop_threaded->run_queue,
+      (iree_host_size_t)loop_threaded->pending_count +
+          loop_threaded->queued_slice_count + 1,
+      loop_threaded->allocator);
+  if (iree_status_is_ok(status)) {
+    op.scope = scope;
+    iree_loop_threaded_run_queue_enqueue(&loop_threaded->run_queue, &op);
+    ++scope->pending_count;
+    ++loop_threaded->pending_count;
+    ++loop_threaded->active_count;
+  }
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (iree_status_is_ok(status)) {
+    iree_notification_post(&loop_threaded->work_notification, 1);
+  }
+  return status;
+}
+
+// Enqueues a wait operation and wakes the wait thread to register it.
+static iree_status_t iree_loop_threaded_enqueue_wait(
+    iree_loop_threaded_scope_t* scope, iree_loop_threaded_wait_op_t op) {
+  iree_loop_threaded_t* loop_threaded = scope->loop_threaded;
+  iree_slim_mutex_lock(&loop_threaded->mutex);
+  if (IREE_UNLIKELY(loop_threaded->shutting_down)) {
+    iree_slim_mutex_unlock(&loop_threaded->mutex);
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "new work cannot be enqueued while the loop is shutting down");
+  }
+  // Reserve run queue capacity for when the wait resolves so that the wait
+  // thread never needs to allocate to issue callbacks.
+  iree_status_t status = iree_loop_threaded_run_queue_reserve(
+      &loop_threaded->run_queue,
+      (iree_host_size_t)loop_threaded->pending_count +
+          loop_threaded->queued_slice_count + 1,
+      loop_threaded->allocator);
+  if (iree_status_is_ok(status)) {
+    status = iree_loop_threaded_wait_list_reserve(
+        &loop_threaded->incoming_waits, loop_threaded->incoming_waits.count + 1,
+        loop_threaded->allocator);
+  }
+  bool signal_wake = false;
+  if (iree_status_is_ok(status)) {
+    op.scope = scope;
+    op.registered = false;
+    op.aborted = false;
+    op.status = iree_ok_status();
+    loop_threaded->incoming_waits.ops[loop_threaded->incoming_waits.count++] =
+        op;
+    ++scope->pending_count;
+    ++loop_threaded->pending_count;
+    if (op.command == IREE_LOOP_COMMAND_WAIT_IDLE) {
+      ++loop_threaded->idle_wait_count;
+    } else {
+      ++loop_threaded->active_count;
+    }
+    signal_wake = iree_loop_threaded_request_wake(loop_threaded);
+  }
+  iree_slim_mutex_unlock(&loop_threaded->mutex);
+  if (signal_wake) iree_event_set(&loop_threaded->wake_event);
+  return status;
+}
+
+// Blocks until all operations in |scope| have retired.
+static iree_status_t iree_loop_threaded_drain_scope(
+    iree_loop_threaded_scope_t* scope, iree_time_t deadline_ns) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  if (!iree_notification_await(&scope->loop_threaded->idle_notification,
+                               iree_loop_threaded_scope_is_idle, scope,
+                               iree_make_deadline(deadline_ns))) {
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_loop_threaded_ctl(
+    void* self, iree_loop_command_t command, const void* params,
+    void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(self);
+  iree_loop_threaded_scope_t* scope = (iree_loop_threaded_scope_t*)self;
+
+  // NOTE: we return immediately to make this all (hopefully) tail calls.
+  switch (command) {
+    case IREE_LOOP_COMMAND_CALL:
+      return iree_loop_threaded_enqueue_run(
+          scope, (iree_loop_threaded_run_op_t){
+                     .command = command,
+                     .params =
+                         {
+                             .call = *(const iree_loop_call_params_t*)params,
+                         },
+                 });
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_loop_threaded_enqueue_run(
+          scope,
+          (iree_loop_threaded_run_op_t){
+              .command = command,
+              .params =
+                  {
+                      .dispatch = *(const iree_loop_dispatch_params_t*)params,
+                  },
+          });
+    case IREE_LOOP_COMMAND_WAIT_UNTIL:
+      return iree_loop_threaded_enqueue_wait(
+          scope, (iree_loop_threaded_wait_op_t){
+                     .command = command,
+                     .params =
+                         {
+                             .wait_until =
+                                 *(const iree_loop_wait_until_params_t*)params,
+                         },
+                 });
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+      return iree_loop_threaded_enqueue_wait(
+          scope, (iree_loop_threaded_wait_op_t){
+                     .command = command,
+                     .params =
+                         {
+                             .wait_one =
+                                 *(const iree_loop_wait_one_params_t*)params,
+                         },
+                 });
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+      return iree_loop_threaded_enqueue_wait(
+          scope, (iree_loop_threaded_wait_op_t){
+                     .command = command,
+                     .params =
+                         {
+                             .wait_multi =
+                                 *(const iree_loop_wait_multi_params_t*)params,
+                         },
+                 });
+    case IREE_LOOP_COMMAND_WAIT_IDLE:
+      return iree_loop_threaded_enqueue_wait(
+          scope, (iree_loop_threaded_wait_op_t){
+                     .command = command,
+                     .params =
+                         {
+                             .wait_idle =
+                                 *(const iree_loop_wait_idle_params_t*)params,
+                         },
+                 });
+    case IREE_LOOP_COMMAND_DRAIN:
+      return iree_loop_threaded_drain_scope(
+          scope, ((const iree_loop_drain_params_t*)params)->deadline_ns);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unimplemented loop command");
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_LOOP_THREADED_H_
+#define IREE_BASE_LOOP_THREADED_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_loop_threaded_t
+//===----------------------------------------------------------------------===//
+
+// Configuration options for the threaded loop implementation.
+typedef struct iree_loop_threaded_options_t {
+  // Number of worker threads issuing callbacks. Must be at least 1.
+  // Dispatch operations are split across all workers.
+  iree_host_size_t worker_count;
+
+  // Initial operation queue depth in number of operations.
+  // The queue grows as needed and this only avoids reallocations when the
+  // expected amount of concurrent work is known.
+  iree_host_size_t initial_queue_depth;
+
+  // Initial number of pending waits that can be tracked without growth.
+  iree_host_size_t initial_wait_count;
+} iree_loop_threaded_options_t;
+
+// A loop that runs operations on a pool of worker threads.
+// Waits are serviced by a dedicated thread multi-waiting on all pending wait
+// sources with the platform wait set (along with an event used to wake it when
+// new waits are enqueued) and the callbacks of resolved waits are issued on the
+// workers. Any number of operations may be pending and queues grow as needed.
+//
+// Operations from the same scope may run concurrently and in any order; users
+// must perform their own ordering as with any other loop. Callbacks should not
+// block as doing so prevents the worker from servicing other operations.
+//
+// Thread-safe: operations may be enqueued from any thread, including from
+// within callbacks running on the workers.
+typedef struct iree_loop_threaded_t iree_loop_threaded_t;
+
+// Allocates a threaded loop using |allocator| stored into |out_loop_threaded|.
+// The worker and wait threads are started before returning.
+IREE_API_EXPORT iree_status_t iree_loop_threaded_allocate(
+    iree_loop_threaded_options_t options, iree_allocator_t allocator,
+    iree_loop_threaded_t** out_loop_threaded);
+
+// Frees a threaded |loop_threaded|, aborting all pending operations and
+// joining all threads. Must not be called from a loop callback.
+IREE_API_EXPORT void iree_loop_threaded_free(
+    iree_loop_threaded_t* loop_threaded);
+
+// Waits until the loop is idle (all operations in all scopes have retired).
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if |timeout| is reached before the
+// loop is idle. Must not be called from a loop callback.
+IREE_API_EXPORT iree_status_t iree_loop_threaded_wait_idle(
+    iree_loop_threaded_t* loop_threaded, iree_timeout_t timeout);
+
+// Handles scope errors returned from loop callback operations.
+// Ownership of |status| is passed to the handler and must be freed.
+// All operations of the same scope will be aborted. Calls are serialized but
+// may be made from any worker thread.
+typedef void(IREE_API_PTR* iree_loop_threaded_error_fn_t)(void* user_data,
+                                                          iree_status_t status);
+
+// A scope of execution within a loop.
+// Each scope has a dedicated error handler that is notified when an error
+// propagates from a loop operation scheduled against the scope. When an error
+// arises all other operations in the same scope will be aborted, including any
+// enqueued afterward.
+typedef struct iree_loop_threaded_scope_t {
+  // Target loop for execution.
+  iree_loop_threaded_t* loop_threaded;
+
+  // Total number of pending operations in the scope.
+  // When 0 the scope is considered idle. Guarded by the loop.
+  int32_t pending_count;
+
+  // Set when the scope has failed or is being deinitialized. All pending and
+  // subsequently enqueued operations are issued with IREE_STATUS_ABORTED as
+  // with concurrent execution there is no ordering between the failure and
+  // other operations in the scope. Guarded by the loop.
+  bool is_aborted;
+
+  // Optional function used to report errors that occur during execution.
+  iree_loop_threaded_error_fn_t error_fn;
+  void* error_user_data;
+} iree_loop_threaded_scope_t;
+
+// Initializes a loop scope that runs operations against |loop_threaded|.
+IREE_API_EXPORT void iree_loop_threaded_scope_initialize(
+    iree_loop_threaded_t* loop_threaded, iree_loop_threaded_error_fn_t error_fn,
+    void* error_user_data, iree_loop_threaded_scope_t* out_scope);
+
+// Deinitializes a loop |scope|, aborting any pending operations and waiting
+// for their callbacks to be issued. Must not be called from a loop callback.
+IREE_API_EXPORT void iree_loop_threaded_scope_deinitialize(
+    iree_loop_threaded_scope_t* scope);
+
+// Control function for the threaded loop.
+// |self| must be an iree_loop_threaded_scope_t.
+//
+// IREE_LOOP_COMMAND_DRAIN blocks the caller until the scope is idle and must
+// not be used from within loop callbacks.
+IREE_API_EXPORT iree_status_t iree_loop_threaded_ctl(
+    void* self, iree_loop_command_t command, const void* params,
+    void** inout_ptr);
+
+// Returns a loop that schedules operations against |scope|.
+// The scope must remain valid until all operations scheduled against it have
+// completed.
+static inline iree_loop_t iree_loop_threaded_scope(
+    iree_loop_threaded_scope_t* scope) {
+  iree_loop_t loop = {
+      scope,
+      iree_loop_threaded_ctl,
+  };
+  return loop;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_LOOP_THREADED_H_
@@ -0,0 +1,151 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/loop_threaded.h"
+
+#include <atomic>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// Contains the test definitions applied to all loop implementations:
+#include "iree/base/loop_test.h"
+
+void AllocateLoop(iree_status_t* out_status, iree_allocator_t allocator,
+                  iree_loop_t* out_loop) {
+  iree_loop_threaded_options_t options = {0};
+  options.worker_count = 4;
+  options.initial_queue_depth = 128;
+  options.initial_wait_count = 32;
+
+  iree_loop_threaded_t* loop_threaded = NULL;
+  IREE_CHECK_OK(
+      iree_loop_threaded_allocate(options, allocator, &loop_threaded));
+
+  iree_loop_threaded_scope_t* scope = NULL;
+  IREE_CHECK_OK(
+      iree_allocator_malloc(allocator, sizeof(*scope), (void**)&scope));
+  iree_loop_threaded_scope_initialize(
+      loop_threaded,
+      +[](void* user_data, iree_status_t status) {
+        iree_status_t* status_ptr = (iree_status_t*)user_data;
+        if (iree_status_is_ok(*status_ptr)) {
+          *status_ptr = status;
+        } else {
+          iree_status_ignore(status);
+        }
+      },
+      out_status, scope);
+  *out_loop = iree_loop_threaded_scope(scope);
+}
+
+void FreeLoop(iree_allocator_t allocator, iree_loop_t loop) {
+  iree_loop_threaded_scope_t* scope = (iree_loop_threaded_scope_t*)loop.self;
+  iree_loop_threaded_t* loop_threaded = scope->loop_threaded;
+
+  iree_loop_threaded_scope_deinitialize(scope);
+  iree_allocator_free(allocator, scope);
+
+  iree_loop_threaded_free(loop_threaded);
+}
+
+
+namespace iree {
+namespace testing {
+namespace {
+
+// Tests that idle waits are issued only after all other work has retired.
+TEST_F(LoopTest, WaitIdleAfterCalls) {
+  IREE_TRACE_SCOPE();
+  struct UserData {
+    std::atomic<int> call_count = {0};
+    int idle_call_count = -1;
+  } user_data;
+
+  for (int i = 0; i < 16; ++i) {
+    IREE_ASSERT_OK(iree_loop_call(
+        loop, IREE_LOOP_PRIORITY_DEFAULT,
+        +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+          IREE_TRACE_SCOPE();
+          IREE_EXPECT_OK(status);
+          auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+          ++user_data->call_count;
+          return iree_ok_status();
+        },
+        &user_data));
+  }
+
+  IREE_ASSERT_OK(iree_loop_wait_idle(
+      loop, iree_infinite_timeout(),
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        IREE_EXPECT_OK(status);
+        auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+        user_data->idle_call_count = user_data->call_count;
+        return iree_ok_status();
+      },
+      &user_data));
+
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_EQ(user_data.call_count, 16);
+  EXPECT_EQ(user_data.idle_call_count, 16);
+}
+
+// Tests that a failure in one scope does not abort operations in another.
+TEST(LoopThreadedTest, ScopeFailureIsolation) {
+  IREE_TRACE_SCOPE();
+  iree_allocator_t allocator = iree_allocator_system();
+  iree_loop_threaded_options_t options = {0};
+  options.worker_count = 2;
+  iree_loop_threaded_t* loop_threaded = NULL;
+  IREE_ASSERT_OK(
+      iree_loop_threaded_allocate(options, allocator, &loop_threaded));
+
+  iree_status_t failing_status = iree_ok_status();
+  iree_loop_threaded_scope_t failing_scope;
+  iree_loop_threaded_scope_initialize(
+      loop_threaded,
+      +[](void* user_data, iree_status_t status) {
+        *(iree_status_t*)user_data = status;
+      },
+      &failing_status, &failing_scope);
+  iree_loop_threaded_scope_t other_scope;
+  iree_loop_threaded_scope_initialize(loop_threaded, NULL, NULL, &other_scope);
+
+  IREE_ASSERT_OK(iree_loop_call(
+      iree_loop_threaded_scope(&failing_scope), IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        return iree_status_from_code(IREE_STATUS_DATA_LOSS);
+      },
+      NULL));
+  IREE_ASSERT_OK(iree_loop_drain(iree_loop_threaded_scope(&failing_scope),
+                                 iree_infinite_timeout()));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS, failing_status);
+
+  iree_status_t call_status = iree_status_from_code(IREE_STATUS_DATA_LOSS);
+  IREE_ASSERT_OK(iree_loop_call(
+      iree_loop_threaded_scope(&other_scope), IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_TRACE_SCOPE();
+        *(iree_status_t*)user_data_ptr = status;
+        return iree_ok_status();
+      },
+      &call_status));
+  IREE_ASSERT_OK(iree_loop_threaded_wait_idle(loop_threaded,
+                                              iree_infinite_timeout()));
+  IREE_EXPECT_OK(call_status);
+
+  iree_loop_threaded_scope_deinitialize(&other_scope);
+  iree_loop_threaded_scope_deinitialize(&failing_scope);
+  iree_loop_threaded_free(loop_threaded);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace iree
@@ -89,6 +89,18 @@ static inline int64x2x2_t iree_uk_neon_zip_4xi32_as_2xi64(int32x4_t a,
   return r;
 }
 
+// Loads 32 signed int4 values packed two per byte, low nibble first, from the
+// 16 bytes at `src`, and sign-extends them to int8 in their original order.
+static inline int8x16x2_t iree_uk_neon_load_32xs4_as_32xi8(const void* src) {
+  int8x16_t packed = vld1q_s8((const iree_uk_int8_t*)src);
+  int8x16_t lo = vshrq_n_s8(vshlq_n_s8(packed, 4), 4);
+  int8x16_t hi = vshrq_n_s8(packed, 4);
+  int8x16x2_t result;
+  result.val[0] = vzip1q_s8(lo, hi);
+  result.val[1] = vzip2q_s8(lo, hi);
+  return result;
+}
+
 static inline void iree_uk_neon_copy_8x1xi8_strided_to_unstrided(
     iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
     const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t in_stride) {
@@ -188,4 +200,26 @@ static inline void iree_uk_neon_copy_8x8xi8_transpose_strided_to_unstrided(
                                                         in_stride);
 }
 
+// Vectorized iree_uk_exp_f32: same range reduction and polynomial, with lanes
+// below IREE_UK_EXP_F32_MIN_INPUT flushed to zero.
+static inline float32x4_t iree_uk_neon_exp_f32x4(float32x4_t x) {
+  uint32x4_t in_range = vcgeq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MIN_INPUT));
+  x = vminq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MAX_INPUT));
+  x = vmaxq_f32(x, vdupq_n_f32(IREE_UK_EXP_F32_MIN_INPUT));
+  float32x4_t n = vrndnq_f32(vmulq_n_f32(x, IREE_UK_LOG2E_F32));
+  float32x4_t r = vfmsq_f32(x, n, vdupq_n_f32(IREE_UK_LN2_HI_F32));
+  r = vfmsq_f32(r, n, vdupq_n_f32(IREE_UK_LN2_LO_F32));
+  float32x4_t p = vdupq_n_f32(IREE_UK_EXP_F32_P0);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P1), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P2), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P3), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P4), p, r);
+  p = vfmaq_f32(vdupq_n_f32(IREE_UK_EXP_F32_P5), p, r);
+  float32x4_t y = vfmaq_f32(r, p, vmulq_f32(r, r));
+  y = vaddq_f32(y, vdupq_n_f32(1.0f));
+  int32x4_t e = vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127));
+  y = vmulq_f32(y, vreinterpretq_f32_s32(vshlq_n_s32(e, 23)));
+  return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(y), in_range));
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_COMMON_ARM_64_H_
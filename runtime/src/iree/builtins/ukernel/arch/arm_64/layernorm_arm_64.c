@@ -0,0 +1,62 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/layernorm_arm_64_internal.h"
+
+void iree_uk_layernorm_row_f32f32_arm_64(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale_row,
+    const void* IREE_UK_RESTRICT bias_row, iree_uk_index_t size,
+    float epsilon, iree_uk_uint32_t flags) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  const float* IREE_UK_RESTRICT scale_ptr = scale_row;
+  const float* IREE_UK_RESTRICT bias_ptr = bias_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  bool rms = flags & IREE_UK_FLAG_LAYERNORM_RMS;
+  // Sums of the differences to the first element, see the generic code.
+  float shift = rms ? 0.0f : in_ptr[0];
+  float32x4_t vshift = vdupq_n_f32(shift);
+  float32x4_t vsum = vdupq_n_f32(0.0f);
+  float32x4_t vsum_sq = vdupq_n_f32(0.0f);
+  iree_uk_index_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t d = vsubq_f32(vld1q_f32(in_ptr + i), vshift);
+    vsum = vaddq_f32(vsum, d);
+    vsum_sq = vfmaq_f32(vsum_sq, d, d);
+  }
+  float sum = vaddvq_f32(vsum);
+  float sum_sq = vaddvq_f32(vsum_sq);
+  for (; i < size; ++i) {
+    float d = in_ptr[i] - shift;
+    sum += d;
+    sum_sq += d * d;
+  }
+  float inv_size = 1.0f / (float)size;
+  float mean = 0.0f;
+  float var = sum_sq * inv_size;
+  if (!rms) {
+    float mean_d = sum * inv_size;
+    mean = shift + mean_d;
+    var -= mean_d * mean_d;
+    if (var < 0.0f) var = 0.0f;
+  }
+  float rstd = 1.0f / vget_lane_f32(vsqrt_f32(vdup_n_f32(var + epsilon)), 0);
+  // Fold the mean into the affine transform: y = x * rstd - mean * rstd.
+  float32x4_t vneg_mean_rstd = vdupq_n_f32(-mean * rstd);
+  for (i = 0; i + 4 <= size; i += 4) {
+    float32x4_t y = vfmaq_n_f32(vneg_mean_rstd, vld1q_f32(in_ptr + i), rstd);
+    if (scale_ptr) y = vmulq_f32(y, vld1q_f32(scale_ptr + i));
+    if (bias_ptr) y = vaddq_f32(y, vld1q_f32(bias_ptr + i));
+    vst1q_f32(out_ptr + i, y);
+  }
+  for (; i < size; ++i) {
+    float y = (in_ptr[i] - mean) * rstd;
+    if (scale_ptr) y *= scale_ptr[i];
+    if (bias_ptr) y += bias_ptr[i];
+    out_ptr[i] = y;
+  }
+}
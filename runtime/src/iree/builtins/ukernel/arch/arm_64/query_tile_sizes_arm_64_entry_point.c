@@ -29,6 +29,23 @@ iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
+static iree_uk_matmul_tile_sizes_t
+iree_uk_query_matmul_tile_sizes_arm_64_i8i4i32(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_I8MM
+  if (iree_uk_cpu_supports_i8mm(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 8, .N = 8};
+  }
+#endif
+#ifdef IREE_UK_BUILD_ARM_64_DOTPROD
+  if (iree_uk_cpu_supports_dotprod(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 4, .N = 8};
+  }
+#endif
+  // Generic fallback. K must be even to pack int4 RHS values in pairs.
+  return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 8};
+}
+
 bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
@@ -41,6 +58,10 @@ bool iree_uk_query_matmul_tile_sizes_arch(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32) {
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_arm_64_i8i4i32(params);
+    return true;
   } else {
     // Can't happen, validated earlier.
     IREE_UK_ASSUME_UNREACHABLE;
@@ -0,0 +1,70 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+void iree_uk_softmax_row_f32f32_arm_64(void* IREE_UK_RESTRICT out_row,
+                                       const void* IREE_UK_RESTRICT in_row,
+                                       iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  // Online max and sum, per lane. The running sum is rescaled once per block
+  // of 4 vectors to amortize the cost of the rescaling exp.
+  float32x4_t vmax = vdupq_n_f32(IREE_UK_F32_LOWEST);
+  float32x4_t vsum = vdupq_n_f32(0.0f);
+  iree_uk_index_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    float32x4_t x0 = vld1q_f32(in_ptr + i + 0);
+    float32x4_t x1 = vld1q_f32(in_ptr + i + 4);
+    float32x4_t x2 = vld1q_f32(in_ptr + i + 8);
+    float32x4_t x3 = vld1q_f32(in_ptr + i + 12);
+    float32x4_t new_max = vmaxq_f32(vmax, vmaxq_f32(x0, x1));
+    new_max = vmaxq_f32(new_max, vmaxq_f32(x2, x3));
+    float32x4_t rescale = iree_uk_neon_exp_f32x4(vsubq_f32(vmax, new_max));
+    vsum = vmulq_f32(vsum, rescale);
+    vmax = new_max;
+    float32x4_t e0 = iree_uk_neon_exp_f32x4(vsubq_f32(x0, vmax));
+    float32x4_t e1 = iree_uk_neon_exp_f32x4(vsubq_f32(x1, vmax));
+    float32x4_t e2 = iree_uk_neon_exp_f32x4(vsubq_f32(x2, vmax));
+    float32x4_t e3 = iree_uk_neon_exp_f32x4(vsubq_f32(x3, vmax));
+    vsum = vaddq_f32(vsum, vaddq_f32(vaddq_f32(e0, e1), vaddq_f32(e2, e3)));
+  }
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(in_ptr + i);
+    float32x4_t new_max = vmaxq_f32(vmax, x);
+    float32x4_t rescale = iree_uk_neon_exp_f32x4(vsubq_f32(vmax, new_max));
+    vsum = vmulq_f32(vsum, rescale);
+    vmax = new_max;
+    vsum = vaddq_f32(vsum, iree_uk_neon_exp_f32x4(vsubq_f32(x, vmax)));
+  }
+  // Scalar tail with its own online state.
+  float tail_max = IREE_UK_F32_LOWEST;
+  float tail_sum = 0.0f;
+  for (iree_uk_index_t j = i; j < size; ++j) {
+    float x = in_ptr[j];
+    if (x > tail_max) {
+      tail_sum *= iree_uk_exp_f32(tail_max - x);
+      tail_max = x;
+    }
+    tail_sum += iree_uk_exp_f32(x - tail_max);
+  }
+  // Combine the lanes and the tail, rescaling each to the overall max.
+  float max = vmaxvq_f32(vmax);
+  if (tail_max > max) max = tail_max;
+  float32x4_t vmax_all = vdupq_n_f32(max);
+  vsum = vmulq_f32(vsum, iree_uk_neon_exp_f32x4(vsubq_f32(vmax, vmax_all)));
+  float sum = vaddvq_f32(vsum) + tail_sum * iree_uk_exp_f32(tail_max - max);
+  float inv_sum = 1.0f / sum;
+  for (i = 0; i + 4 <= size; i += 4) {
+    float32x4_t x = vld1q_f32(in_ptr + i);
+    float32x4_t e = iree_uk_neon_exp_f32x4(vsubq_f32(x, vmax_all));
+    vst1q_f32(out_ptr + i, vmulq_n_f32(e, inv_sum));
+  }
+  for (; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
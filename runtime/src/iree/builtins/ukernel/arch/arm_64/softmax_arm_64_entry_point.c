@@ -0,0 +1,18 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64_entry_point.h"
+#include "iree/builtins/ukernel/arch/arm_64/softmax_arm_64_internal.h"
+
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_arch(
+    const iree_uk_softmax_params_t* params) {
+  // Only f32 is vectorized for now. f16 and bf16 use the generic code, which
+  // computes in f32 anyway.
+  if (iree_uk_softmax_type(params->flags) == iree_uk_softmax_type_f32f32) {
+    return iree_uk_softmax_row_f32f32_arm_64;
+  }
+  return 0;
+}
@@ -224,6 +224,59 @@ iree_uk_avx2_copy_8x16xi8_tiled_1x2_transpose_strided_to_strided(
                            r0123456701234567_3);
 }
 
+// Loads 16 signed int4 values packed two per byte, low nibble first, from the
+// 8 bytes at `src`, and sign-extends them to int16 in their original order.
+// Each nibble is moved to the top of its byte so that an arithmetic shift
+// right by 4 after the int8->int16 extension performs the sign extension.
+static inline __m256i iree_uk_avx2_load_16xs4_as_16xi16(const void* src) {
+  __m128i packed = _mm_loadl_epi64((const __m128i*)src);
+  __m128i mask = _mm_set1_epi8((char)0xF0);
+  __m128i lo = _mm_and_si128(_mm_slli_epi16(packed, 4), mask);
+  __m128i hi = _mm_and_si128(packed, mask);
+  return _mm256_srai_epi16(_mm256_cvtepi8_epi16(_mm_unpacklo_epi8(lo, hi)), 4);
+}
+
+// Vectorized iree_uk_exp_f32: same range reduction and polynomial, with lanes
+// below IREE_UK_EXP_F32_MIN_INPUT flushed to zero.
+static inline __m256 iree_uk_avx2_exp_ps(__m256 x) {
+  __m256 underflow =
+      _mm256_cmp_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), _CMP_LT_OQ);
+  x = _mm256_min_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_MAX_INPUT));
+  x = _mm256_max_ps(x, _mm256_set1_ps(IREE_UK_EXP_F32_MIN_INPUT));
+  __m256 n = _mm256_round_ps(
+      _mm256_mul_ps(x, _mm256_set1_ps(IREE_UK_LOG2E_F32)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(IREE_UK_LN2_HI_F32), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(IREE_UK_LN2_LO_F32), r);
+  __m256 p = _mm256_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(IREE_UK_EXP_F32_P5));
+  __m256 y = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+  __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+  y = _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)));
+  return _mm256_andnot_ps(underflow, y);
+}
+
+// Returns the sum of the 8 lanes of `v`.
+static inline float iree_uk_avx2_reduce_add_ps(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+// Returns the max of the 8 lanes of `v`.
+static inline float iree_uk_avx2_reduce_max_ps(__m256 v) {
+  __m128 s = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_max_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
 #if defined(__AVX512F__)
 
 static inline __m512i iree_uk_avx512_loadu_4x128(const void* src0,
@@ -406,6 +459,44 @@ iree_uk_avx512_copy_16x16xi8_tiled_1x2_transpose_strided_to_strided(
       r0123456701234567_3);
 }
 
+// Same as iree_uk_avx2_load_16xs4_as_16xi16 but loading 32 int4 values from
+// the 16 bytes at `src`.
+static inline __m512i iree_uk_avx512_load_32xs4_as_32xi16(const void* src) {
+  __m128i packed = _mm_loadu_si128((const __m128i*)src);
+  __m128i mask = _mm_set1_epi8((char)0xF0);
+  __m128i lo = _mm_and_si128(_mm_slli_epi16(packed, 4), mask);
+  __m128i hi = _mm_and_si128(packed, mask);
+  __m256i i8 =
+      _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(lo, hi)),
+                              _mm_unpackhi_epi8(lo, hi), 1);
+  return _mm512_srai_epi16(_mm512_cvtepi8_epi16(i8), 4);
+}
+
+// Vectorized iree_uk_exp_f32: same range reduction and polynomial, with lanes
+// below IREE_UK_EXP_F32_MIN_INPUT flushed to zero.
+static inline __m512 iree_uk_avx512_exp_ps(__m512 x) {
+  __mmask16 in_range = _mm512_cmp_ps_mask(
+      x, _mm512_set1_ps(IREE_UK_EXP_F32_MIN_INPUT), _CMP_GE_OQ);
+  x = _mm512_min_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_MAX_INPUT));
+  x = _mm512_max_ps(x, _mm512_set1_ps(IREE_UK_EXP_F32_MIN_INPUT));
+  __m512 n = _mm512_roundscale_ps(
+      _mm512_mul_ps(x, _mm512_set1_ps(IREE_UK_LOG2E_F32)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(IREE_UK_LN2_HI_F32), x);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(IREE_UK_LN2_LO_F32), r);
+  __m512 p = _mm512_set1_ps(IREE_UK_EXP_F32_P0);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P1));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P2));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P3));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P4));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(IREE_UK_EXP_F32_P5));
+  __m512 y = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r);
+  y = _mm512_add_ps(y, _mm512_set1_ps(1.0f));
+  __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+  y = _mm512_mul_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(e, 23)));
+  return _mm512_maskz_mov_ps(in_range, y);
+}
+
 #endif  // defined (__AVX512F__)
 
 #endif  // defined(__AVX2__)
@@ -0,0 +1,59 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/layernorm_x86_64_internal.h"
+
+void iree_uk_layernorm_row_f32f32_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale_row,
+    const void* IREE_UK_RESTRICT bias_row, iree_uk_index_t size,
+    float epsilon, iree_uk_uint32_t flags) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  const float* IREE_UK_RESTRICT scale_ptr = scale_row;
+  const float* IREE_UK_RESTRICT bias_ptr = bias_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  bool rms = flags & IREE_UK_FLAG_LAYERNORM_RMS;
+  // Sums of the differences to the first element, see the generic code.
+  float shift = rms ? 0.0f : in_ptr[0];
+  __m512 vshift = _mm512_set1_ps(shift);
+  __m512 vsum = _mm512_setzero_ps();
+  __m512 vsum_sq = _mm512_setzero_ps();
+  for (iree_uk_index_t i = 0; i < size; i += 16) {
+    __mmask16 mask = size - i >= 16 ? 0xFFFF : (1u << (size - i)) - 1;
+    __m512 x = _mm512_maskz_loadu_ps(mask, in_ptr + i);
+    __m512 d = _mm512_maskz_sub_ps(mask, x, vshift);
+    vsum = _mm512_add_ps(vsum, d);
+    vsum_sq = _mm512_fmadd_ps(d, d, vsum_sq);
+  }
+  float sum = _mm512_reduce_add_ps(vsum);
+  float sum_sq = _mm512_reduce_add_ps(vsum_sq);
+  float inv_size = 1.0f / (float)size;
+  float mean = 0.0f;
+  float var = sum_sq * inv_size;
+  if (!rms) {
+    float mean_d = sum * inv_size;
+    mean = shift + mean_d;
+    var -= mean_d * mean_d;
+    if (var < 0.0f) var = 0.0f;
+  }
+  float rstd = 1.0f / _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(var + epsilon)));
+  // Fold the mean into the affine transform: y = x * rstd - mean * rstd.
+  __m512 vrstd = _mm512_set1_ps(rstd);
+  __m512 vneg_mean_rstd = _mm512_set1_ps(-mean * rstd);
+  for (iree_uk_index_t i = 0; i < size; i += 16) {
+    __mmask16 mask = size - i >= 16 ? 0xFFFF : (1u << (size - i)) - 1;
+    __m512 y = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, in_ptr + i), vrstd,
+                               vneg_mean_rstd);
+    if (scale_ptr) {
+      y = _mm512_mul_ps(y, _mm512_maskz_loadu_ps(mask, scale_ptr + i));
+    }
+    if (bias_ptr) {
+      y = _mm512_add_ps(y, _mm512_maskz_loadu_ps(mask, bias_ptr + i));
+    }
+    _mm512_mask_storeu_ps(out_ptr + i, mask, y);
+  }
+}
@@ -41,6 +41,23 @@ iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 4};
 }
 
+static iree_uk_matmul_tile_sizes_t
+iree_uk_query_matmul_tile_sizes_x86_64_i8i4i32(
+    const iree_uk_query_tile_sizes_2d_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_VNNI)
+  if (iree_uk_cpu_supports_avx512_vnni(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_supports_avx2_fma(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 8};
+  }
+#endif
+  // Generic fallback. K must be even to pack int4 RHS values in pairs.
+  return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 4};
+}
+
 bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
@@ -53,6 +70,10 @@ bool iree_uk_query_matmul_tile_sizes_arch(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32) {
+    *out_matmul_tile_sizes =
+        iree_uk_query_matmul_tile_sizes_x86_64_i8i4i32(params);
+    return true;
   } else {
     // Can't happen, validated earlier.
     IREE_UK_ASSUME_UNREACHABLE;
@@ -0,0 +1,74 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+void iree_uk_softmax_row_f32f32_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  // Online max and sum, per lane. The running sum is rescaled once per block
+  // of 4 vectors to amortize the cost of the rescaling exp.
+  __m256 vmax = _mm256_set1_ps(IREE_UK_F32_LOWEST);
+  __m256 vsum = _mm256_setzero_ps();
+  iree_uk_index_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256 x0 = _mm256_loadu_ps(in_ptr + i + 0);
+    __m256 x1 = _mm256_loadu_ps(in_ptr + i + 8);
+    __m256 x2 = _mm256_loadu_ps(in_ptr + i + 16);
+    __m256 x3 = _mm256_loadu_ps(in_ptr + i + 24);
+    __m256 new_max = _mm256_max_ps(vmax, _mm256_max_ps(x0, x1));
+    new_max = _mm256_max_ps(new_max, _mm256_max_ps(x2, x3));
+    __m256 rescale = iree_uk_avx2_exp_ps(_mm256_sub_ps(vmax, new_max));
+    vsum = _mm256_mul_ps(vsum, rescale);
+    vmax = new_max;
+    __m256 e0 = iree_uk_avx2_exp_ps(_mm256_sub_ps(x0, vmax));
+    __m256 e1 = iree_uk_avx2_exp_ps(_mm256_sub_ps(x1, vmax));
+    __m256 e2 = iree_uk_avx2_exp_ps(_mm256_sub_ps(x2, vmax));
+    __m256 e3 = iree_uk_avx2_exp_ps(_mm256_sub_ps(x3, vmax));
+    vsum = _mm256_add_ps(vsum, _mm256_add_ps(_mm256_add_ps(e0, e1),
+                                             _mm256_add_ps(e2, e3)));
+  }
+  for (; i + 8 <= size; i += 8) {
+    __m256 x = _mm256_loadu_ps(in_ptr + i);
+    __m256 new_max = _mm256_max_ps(vmax, x);
+    __m256 rescale = iree_uk_avx2_exp_ps(_mm256_sub_ps(vmax, new_max));
+    vsum = _mm256_mul_ps(vsum, rescale);
+    vmax = new_max;
+    vsum = _mm256_add_ps(vsum, iree_uk_avx2_exp_ps(_mm256_sub_ps(x, vmax)));
+  }
+  // Scalar tail with its own online state.
+  float tail_max = IREE_UK_F32_LOWEST;
+  float tail_sum = 0.0f;
+  for (iree_uk_index_t j = i; j < size; ++j) {
+    float x = in_ptr[j];
+    if (x > tail_max) {
+      tail_sum *= iree_uk_exp_f32(tail_max - x);
+      tail_max = x;
+    }
+    tail_sum += iree_uk_exp_f32(x - tail_max);
+  }
+  // Combine the lanes and the tail, rescaling each to the overall max.
+  float max = iree_uk_avx2_reduce_max_ps(vmax);
+  if (tail_max > max) max = tail_max;
+  vsum = _mm256_mul_ps(
+      vsum, iree_uk_avx2_exp_ps(_mm256_sub_ps(vmax, _mm256_set1_ps(max))));
+  float sum = iree_uk_avx2_reduce_add_ps(vsum) +
+              tail_sum * iree_uk_exp_f32(tail_max - max);
+  float inv_sum = 1.0f / sum;
+  __m256 vmax_all = _mm256_set1_ps(max);
+  __m256 vinv_sum = _mm256_set1_ps(inv_sum);
+  for (i = 0; i + 8 <= size; i += 8) {
+    __m256 x = _mm256_loadu_ps(in_ptr + i);
+    __m256 e = iree_uk_avx2_exp_ps(_mm256_sub_ps(x, vmax_all));
+    _mm256_storeu_ps(out_ptr + i, _mm256_mul_ps(e, vinv_sum));
+  }
+  for (; i < size; ++i) {
+    out_ptr[i] = iree_uk_exp_f32(in_ptr[i] - max) * inv_sum;
+  }
+}
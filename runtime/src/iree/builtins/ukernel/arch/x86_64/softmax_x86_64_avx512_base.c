@@ -0,0 +1,63 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/softmax_x86_64_internal.h"
+
+void iree_uk_softmax_row_f32f32_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size) {
+  const float* IREE_UK_RESTRICT in_ptr = in_row;
+  float* IREE_UK_RESTRICT out_ptr = out_row;
+  // Online max and sum, per lane. The running sum is rescaled once per block
+  // of 4 vectors to amortize the cost of the rescaling exp.
+  __m512 lowest = _mm512_set1_ps(IREE_UK_F32_LOWEST);
+  __m512 vmax = lowest;
+  __m512 vsum = _mm512_setzero_ps();
+  iree_uk_index_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    __m512 x0 = _mm512_loadu_ps(in_ptr + i + 0);
+    __m512 x1 = _mm512_loadu_ps(in_ptr + i + 16);
+    __m512 x2 = _mm512_loadu_ps(in_ptr + i + 32);
+    __m512 x3 = _mm512_loadu_ps(in_ptr + i + 48);
+    __m512 new_max = _mm512_max_ps(vmax, _mm512_max_ps(x0, x1));
+    new_max = _mm512_max_ps(new_max, _mm512_max_ps(x2, x3));
+    __m512 rescale = iree_uk_avx512_exp_ps(_mm512_sub_ps(vmax, new_max));
+    vsum = _mm512_mul_ps(vsum, rescale);
+    vmax = new_max;
+    __m512 e0 = iree_uk_avx512_exp_ps(_mm512_sub_ps(x0, vmax));
+    __m512 e1 = iree_uk_avx512_exp_ps(_mm512_sub_ps(x1, vmax));
+    __m512 e2 = iree_uk_avx512_exp_ps(_mm512_sub_ps(x2, vmax));
+    __m512 e3 = iree_uk_avx512_exp_ps(_mm512_sub_ps(x3, vmax));
+    vsum = _mm512_add_ps(vsum, _mm512_add_ps(_mm512_add_ps(e0, e1),
+                                             _mm512_add_ps(e2, e3)));
+  }
+  // Remaining vectors, the last one partial. Masked-off lanes read as the
+  // lowest float so that they leave the max unchanged, and are excluded from
+  // the sum.
+  for (; i < size; i += 16) {
+    __mmask16 mask = size - i >= 16 ? 0xFFFF : (1u << (size - i)) - 1;
+    __m512 x = _mm512_mask_loadu_ps(lowest, mask, in_ptr + i);
+    __m512 new_max = _mm512_max_ps(vmax, x);
+    __m512 rescale = iree_uk_avx512_exp_ps(_mm512_sub_ps(vmax, new_max));
+    vsum = _mm512_mul_ps(vsum, rescale);
+    vmax = new_max;
+    vsum = _mm512_mask_add_ps(vsum, mask, vsum,
+                              iree_uk_avx512_exp_ps(_mm512_sub_ps(x, vmax)));
+  }
+  // Combine the lanes, rescaling each to the overall max.
+  float max = _mm512_reduce_max_ps(vmax);
+  __m512 vmax_all = _mm512_set1_ps(max);
+  vsum = _mm512_mul_ps(vsum,
+                       iree_uk_avx512_exp_ps(_mm512_sub_ps(vmax, vmax_all)));
+  __m512 vinv_sum = _mm512_set1_ps(1.0f / _mm512_reduce_add_ps(vsum));
+  for (i = 0; i < size; i += 16) {
+    __mmask16 mask = size - i >= 16 ? 0xFFFF : (1u << (size - i)) - 1;
+    __m512 x = _mm512_maskz_loadu_ps(mask, in_ptr + i);
+    __m512 e = iree_uk_avx512_exp_ps(_mm512_sub_ps(x, vmax_all));
+    _mm512_mask_storeu_ps(out_ptr + i, mask, _mm512_mul_ps(e, vinv_sum));
+  }
+}
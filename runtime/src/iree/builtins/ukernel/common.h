@@ -461,6 +461,7 @@ enum {
   IREE_UK_TYPE_OPAQUE_16 = IREE_UK_TYPE_CATEGORY_OPAQUE | 4,
   IREE_UK_TYPE_OPAQUE_32 = IREE_UK_TYPE_CATEGORY_OPAQUE | 5,
   IREE_UK_TYPE_OPAQUE_64 = IREE_UK_TYPE_CATEGORY_OPAQUE | 6,
+  IREE_UK_TYPE_INT_4 = IREE_UK_TYPE_CATEGORY_INTEGER | 2,
   IREE_UK_TYPE_INT_8 = IREE_UK_TYPE_CATEGORY_INTEGER | 3,
   IREE_UK_TYPE_INT_16 = IREE_UK_TYPE_CATEGORY_INTEGER | 4,
   IREE_UK_TYPE_INT_32 = IREE_UK_TYPE_CATEGORY_INTEGER | 5,
@@ -508,6 +509,15 @@ static inline int iree_uk_type_size(iree_uk_type_t t) {
   return 1 << iree_uk_type_size_log2(t);
 }
 
+// Returns the size in bytes of `count` elements of type `t`. Unlike
+// iree_uk_type_size, this is also defined for sub-byte types such as
+// IREE_UK_TYPE_INT_4, as long as `count` elements fill a whole number of
+// bytes (e.g. `count` is even for 4-bit types).
+static inline iree_uk_index_t iree_uk_bits_to_bytes_exact(
+    iree_uk_type_t t, iree_uk_index_t count) {
+  return (count << iree_uk_type_bit_count_log2(t)) >> 3;
+}
+
 //===----------------------------------------------------------------------===//
 // Tuples of types, packed ("tied") into a word.
 //===----------------------------------------------------------------------===//
@@ -865,6 +875,79 @@ static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float value) {
   return iree_uk_f32_to_generic_fp16(value, 8);
 }
 
+//===----------------------------------------------------------------------===//
+// Scalar math approximations.
+//
+// Ukernels are self-contained and can't call into libm, so transcendental
+// functions are implemented here with the same range reduction and polynomials
+// as the vectorized versions in architecture-specific code, which are in turn
+// the ones used by MLIR's math polynomial approximations. This keeps the
+// results of the generic and the optimized code paths close to each other.
+//===----------------------------------------------------------------------===//
+
+// Inputs to exp are clamped to this range. The bounds are chosen so that the
+// 2^n scaling below stays within the range of normal f32 exponents. The lower
+// bound is log(FLT_MIN); exp of anything below it is flushed to zero.
+#define IREE_UK_EXP_F32_MAX_INPUT 88.0f
+#define IREE_UK_EXP_F32_MIN_INPUT -87.3365447505531f
+// log2(e) and ln(2) split into high and low parts for Cody-Waite reduction.
+#define IREE_UK_LOG2E_F32 1.44269504088896341f
+#define IREE_UK_LN2_HI_F32 0.693359375f
+#define IREE_UK_LN2_LO_F32 -2.12194440e-4f
+// Minimax polynomial approximating (exp(r) - 1 - r) / r^2 on [-ln2/2, ln2/2].
+#define IREE_UK_EXP_F32_P0 1.9875691500E-4f
+#define IREE_UK_EXP_F32_P1 1.3981999507E-3f
+#define IREE_UK_EXP_F32_P2 8.3334519073E-3f
+#define IREE_UK_EXP_F32_P3 4.1665795894E-2f
+#define IREE_UK_EXP_F32_P4 1.6666665459E-1f
+#define IREE_UK_EXP_F32_P5 5.0000001201E-1f
+
+// Lowest finite f32 value. Used as the initial value of max-reductions.
+#define IREE_UK_F32_LOWEST -3.40282347e+38f
+
+static inline float iree_uk_f32_from_bits(iree_uk_uint32_t bits) {
+  float value;
+  iree_uk_memcpy(&value, &bits, sizeof value);
+  return value;
+}
+
+static inline iree_uk_uint32_t iree_uk_f32_to_bits(float value) {
+  iree_uk_uint32_t bits;
+  iree_uk_memcpy(&bits, &value, sizeof bits);
+  return bits;
+}
+
+// Returns an approximation of exp(x) with a relative error of a few ulps.
+// Returns 0 for inputs below IREE_UK_EXP_F32_MIN_INPUT.
+static inline float iree_uk_exp_f32(float x) {
+  if (x < IREE_UK_EXP_F32_MIN_INPUT) return 0.0f;
+  if (x > IREE_UK_EXP_F32_MAX_INPUT) x = IREE_UK_EXP_F32_MAX_INPUT;
+  // n = round(x / ln2), rounding half away from zero.
+  float t = x * IREE_UK_LOG2E_F32;
+  iree_uk_int32_t n = (iree_uk_int32_t)(t + (t >= 0.0f ? 0.5f : -0.5f));
+  float nf = (float)n;
+  float r = x - nf * IREE_UK_LN2_HI_F32 - nf * IREE_UK_LN2_LO_F32;
+  float p = IREE_UK_EXP_F32_P0;
+  p = p * r + IREE_UK_EXP_F32_P1;
+  p = p * r + IREE_UK_EXP_F32_P2;
+  p = p * r + IREE_UK_EXP_F32_P3;
+  p = p * r + IREE_UK_EXP_F32_P4;
+  p = p * r + IREE_UK_EXP_F32_P5;
+  float y = p * r * r + r + 1.0f;
+  return y * iree_uk_f32_from_bits((iree_uk_uint32_t)(n + 127) << 23);
+}
+
+// Returns an approximation of 1/sqrt(x) for x > 0, accurate to about 1 ulp.
+// Architecture-specific code should prefer hardware square roots.
+static inline float iree_uk_rsqrt_f32(float x) {
+  float y = iree_uk_f32_from_bits(0x5f375a86u - (iree_uk_f32_to_bits(x) >> 1));
+  // Each Newton-Raphson step roughly doubles the number of correct bits.
+  for (int i = 0; i < 3; ++i) {
+    y = y * (1.5f - 0.5f * x * y * y);
+  }
+  return y;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
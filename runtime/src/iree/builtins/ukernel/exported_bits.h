@@ -49,6 +49,8 @@
 #define IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 0x04
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 0x05
 #define IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 0x06
+// RHS is signed int4, packed two per byte along K0, low nibble first.
+#define IREE_UK_FLAG_MMT4D_TYPE_I8I4I32 0x07
 
 // bit flags
 #define IREE_UK_FLAG_MMT4D_ACCUMULATE 0x100
@@ -91,6 +93,36 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_ACCUMULATE);
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER 0x200
 
+//===----------------------------------------------------------------------===//
+// softmax
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_SOFTMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_SOFTMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F32F32 0x01
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F16F16 0x02
+#define IREE_UK_FLAG_SOFTMAX_TYPE_BF16BF16 0x03
+
+//===----------------------------------------------------------------------===//
+// layernorm
+//===----------------------------------------------------------------------===//
+
+// type enum
+#define IREE_UK_FLAG_LAYERNORM_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_LAYERNORM_TYPE_NONE 0x00
+#define IREE_UK_FLAG_LAYERNORM_TYPE_F32F32 0x01
+#define IREE_UK_FLAG_LAYERNORM_TYPE_F16F16 0x02
+#define IREE_UK_FLAG_LAYERNORM_TYPE_BF16BF16 0x03
+
+// bit flags
+// Normalize by the root mean square without subtracting the mean (RMSNorm).
+#define IREE_UK_FLAG_LAYERNORM_RMS 0x100
+// Multiply the normalized values by the `scale` buffer (gamma).
+#define IREE_UK_FLAG_LAYERNORM_SCALE 0x200
+// Add the `bias` buffer (beta) to the normalized values.
+#define IREE_UK_FLAG_LAYERNORM_BIAS 0x400
+
 //===----------------------------------------------------------------------===//
 // query_tile_sizes
 //===----------------------------------------------------------------------===//
@@ -113,5 +145,6 @@ IREE_UK_ENSURE_CONSISTENT_FLAG(IREE_UK_FLAG_MMT4D_ACCUMULATE);
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16 0x0400
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 0x0500
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16 0x0600
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I4I32 0x0700
 
 #endif  // IREE_BUILTINS_UKERNEL_EXPORTED_BITS_H_
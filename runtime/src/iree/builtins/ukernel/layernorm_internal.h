@@ -0,0 +1,69 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
+
+#include "iree/builtins/ukernel/layernorm.h"
+
+typedef enum iree_uk_layernorm_type_t {
+  iree_uk_layernorm_type_f32f32 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+  iree_uk_layernorm_type_f16f16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_16, FLOAT_16),
+  iree_uk_layernorm_type_bf16bf16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(BFLOAT_16, BFLOAT_16),
+} iree_uk_layernorm_type_t;
+
+static inline iree_uk_layernorm_type_t iree_uk_layernorm_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_LAYERNORM_TYPE_MASK) {
+    case IREE_UK_FLAG_LAYERNORM_TYPE_F32F32:
+      return iree_uk_layernorm_type_f32f32;
+    case IREE_UK_FLAG_LAYERNORM_TYPE_F16F16:
+      return iree_uk_layernorm_type_f16f16;
+    case IREE_UK_FLAG_LAYERNORM_TYPE_BF16BF16:
+      return iree_uk_layernorm_type_bf16bf16;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_in_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_layernorm_out_type(
+    iree_uk_layernorm_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Normalizes the `size` contiguous elements at `in_row` into `out_row`.
+// `scale` and `bias` are NULL when the corresponding flags are not set. Only
+// the IREE_UK_FLAG_LAYERNORM_RMS bit of `flags` is relevant to row functions.
+typedef void (*iree_uk_layernorm_row_func_t)(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    const void* IREE_UK_RESTRICT scale, const void* IREE_UK_RESTRICT bias,
+    iree_uk_index_t size, float epsilon, iree_uk_uint32_t flags);
+
+// Row kernel declarations. Prototype matches iree_uk_layernorm_row_func_t.
+#define IREE_UK_LAYERNORM_ROW_FUNC_DECL(NAME)                              \
+  void NAME(void* IREE_UK_RESTRICT out_row,                                \
+            const void* IREE_UK_RESTRICT in_row,                           \
+            const void* IREE_UK_RESTRICT scale,                            \
+            const void* IREE_UK_RESTRICT bias, iree_uk_index_t size,       \
+            float epsilon, iree_uk_uint32_t flags);
+
+// Returns the row function to use for the layernorm op with the given params.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func(
+    const iree_uk_layernorm_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func_arch(
+    const iree_uk_layernorm_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_LAYERNORM_INTERNAL_H_
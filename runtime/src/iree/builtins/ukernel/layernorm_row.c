@@ -0,0 +1,90 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/layernorm_internal.h"
+
+// Generic implementation of the layernorm row function, templatized over the
+// element type through the LOAD/STORE functions converting to/from f32.
+//
+// The first pass accumulates the sum and sum of squares of the differences to
+// the first element, which avoids the catastrophic cancellation of the naive
+// E[x^2] - E[x]^2 formula when the mean is large relative to the deviation.
+#define IREE_UK_LAYERNORM_ROW_GENERIC(NAME, ELEM_TYPE, LOAD, STORE)        \
+  static void NAME(void* IREE_UK_RESTRICT out_row,                         \
+                   const void* IREE_UK_RESTRICT in_row,                    \
+                   const void* IREE_UK_RESTRICT scale_row,                 \
+                   const void* IREE_UK_RESTRICT bias_row,                  \
+                   iree_uk_index_t size, float epsilon,                    \
+                   iree_uk_uint32_t flags) {                               \
+    const ELEM_TYPE* IREE_UK_RESTRICT in_ptr = in_row;                     \
+    const ELEM_TYPE* IREE_UK_RESTRICT scale_ptr = scale_row;               \
+    const ELEM_TYPE* IREE_UK_RESTRICT bias_ptr = bias_row;                 \
+    ELEM_TYPE* IREE_UK_RESTRICT out_ptr = out_row;                         \
+    bool rms = flags & IREE_UK_FLAG_LAYERNORM_RMS;                         \
+    float shift = rms ? 0.0f : LOAD(in_ptr[0]);                            \
+    float sum = 0.0f;                                                      \
+    float sum_sq = 0.0f;                                                   \
+    for (iree_uk_index_t i = 0; i < size; ++i) {                           \
+      float d = LOAD(in_ptr[i]) - shift;                                   \
+      sum += d;                                                            \
+      sum_sq += d * d;                                                     \
+    }                                                                      \
+    float inv_size = 1.0f / (float)size;                                   \
+    float mean = 0.0f;                                                     \
+    float var = sum_sq * inv_size;                                         \
+    if (!rms) {                                                            \
+      float mean_d = sum * inv_size;                                       \
+      mean = shift + mean_d;                                               \
+      var -= mean_d * mean_d;                                              \
+      if (var < 0.0f) var = 0.0f;                                          \
+    }                                                                      \
+    float rstd = iree_uk_rsqrt_f32(var + epsilon);                         \
+    for (iree_uk_index_t i = 0; i < size; ++i) {                           \
+      float y = (LOAD(in_ptr[i]) - mean) * rstd;                           \
+      if (scale_ptr) y *= LOAD(scale_ptr[i]);                              \
+      if (bias_ptr) y += LOAD(bias_ptr[i]);                                \
+      out_ptr[i] = STORE(y);                                               \
+    }                                                                      \
+  }
+
+static inline float iree_uk_layernorm_load_f32(float x) { return x; }
+static inline float iree_uk_layernorm_store_f32(float x) { return x; }
+
+IREE_UK_LAYERNORM_ROW_GENERIC(iree_uk_layernorm_row_generic_f32f32, float,
+                              iree_uk_layernorm_load_f32,
+                              iree_uk_layernorm_store_f32)
+IREE_UK_LAYERNORM_ROW_GENERIC(iree_uk_layernorm_row_generic_f16f16,
+                              iree_uk_uint16_t, iree_uk_f16_to_f32,
+                              iree_uk_f32_to_f16)
+IREE_UK_LAYERNORM_ROW_GENERIC(iree_uk_layernorm_row_generic_bf16bf16,
+                              iree_uk_uint16_t, iree_uk_bf16_to_f32,
+                              iree_uk_f32_to_bf16)
+
+static iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func_generic(
+    const iree_uk_layernorm_params_t* params) {
+  switch (iree_uk_layernorm_type(params->flags)) {
+    case iree_uk_layernorm_type_f32f32:
+      return iree_uk_layernorm_row_generic_f32f32;
+    case iree_uk_layernorm_type_f16f16:
+      return iree_uk_layernorm_row_generic_f16f16;
+    case iree_uk_layernorm_type_bf16bf16:
+      return iree_uk_layernorm_row_generic_bf16bf16;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+// Select the 'row function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_layernorm_row_func_t iree_uk_layernorm_select_row_func(
+    const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_row_func_t arch_row_func =
+      iree_uk_layernorm_select_row_func_arch(params);
+  if (arch_row_func) {
+    return arch_row_func;
+  }
+  return iree_uk_layernorm_select_row_func_generic(params);
+}
@@ -21,7 +21,8 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F32 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16F16F16 ||
                  flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32 ||
-                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16);
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16 ||
+                 flags_type == IREE_UK_FLAG_MMT4D_TYPE_I8I4I32);
   // Some implementations may wish to avoid supporting absurdly wide types. For
   // instance, K is the innermost (i.e. hottest) loop bound, so some 32bit
   // targets may benefit from K being int32, not int64. We still let K be of
@@ -39,6 +40,13 @@ static void iree_uk_mmt4d_validate(const iree_uk_mmt4d_params_t* params) {
   IREE_UK_ASSERT(params->M0 * params->N0 *
                      iree_uk_type_size(iree_uk_mmt4d_out_type(mmt4d_type)) <=
                  iree_uk_mmt4d_tile_generic_max_bytes);
+  // Sub-byte RHS elements are packed along K0, so each row of an RHS tile
+  // needs to be a whole number of bytes.
+  if (iree_uk_type_bit_count(iree_uk_mmt4d_rhs_type(mmt4d_type)) < 8) {
+    IREE_UK_ASSERT(!(params->K0 & 1));
+    IREE_UK_ASSERT(!(params->rhs_offset & 1));
+    IREE_UK_ASSERT(!(params->rhs_stride0 & 1));
+  }
 #endif  // IREE_UK_ENABLE_ASSERTS
 }
 
@@ -58,19 +66,25 @@ static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
   const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
   const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
   const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
-  const iree_uk_int16_t lhs_elem_size_log2 = iree_uk_type_size_log2(lhs_type);
-  const iree_uk_int16_t rhs_elem_size_log2 = iree_uk_type_size_log2(rhs_type);
-  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  // Offsets and strides are converted to bytes with
+  // iree_uk_bits_to_bytes_exact, as the RHS may have a sub-byte element type.
   char* out_tile_row =
-      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
-  const char* lhs_panel = (const char*)params->lhs_buffer +
-                          (params->lhs_offset << lhs_elem_size_log2);
-  const char* rhs_panel_start = (const char*)params->rhs_buffer +
-                                (params->rhs_offset << rhs_elem_size_log2);
-  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
-  iree_uk_index_t lhs_panel_stride = params->lhs_stride0 << lhs_elem_size_log2;
-  iree_uk_index_t rhs_panel_stride = params->rhs_stride0 << rhs_elem_size_log2;
-  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+      (char*)params->out_buffer +
+      iree_uk_bits_to_bytes_exact(out_type, params->out_offset);
+  const char* lhs_panel =
+      (const char*)params->lhs_buffer +
+      iree_uk_bits_to_bytes_exact(lhs_type, params->lhs_offset);
+  const char* rhs_panel_start =
+      (const char*)params->rhs_buffer +
+      iree_uk_bits_to_bytes_exact(rhs_type, params->rhs_offset);
+  iree_uk_int32_t out_tile_size =
+      iree_uk_bits_to_bytes_exact(out_type, M0 * N0);
+  iree_uk_index_t lhs_panel_stride =
+      iree_uk_bits_to_bytes_exact(lhs_type, params->lhs_stride0);
+  iree_uk_index_t rhs_panel_stride =
+      iree_uk_bits_to_bytes_exact(rhs_type, params->rhs_stride0);
+  iree_uk_index_t out_stride =
+      iree_uk_bits_to_bytes_exact(out_type, params->out_stride0);
   for (iree_uk_int32_t i = 0; i < M; ++i) {
     char* out_tile = out_tile_row;
     const char* rhs_panel = rhs_panel_start;
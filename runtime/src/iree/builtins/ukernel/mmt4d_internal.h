@@ -22,6 +22,8 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
   iree_uk_mmt4d_type_bf16bf16bf16 =
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  iree_uk_mmt4d_type_i8i4i32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(INT_8, INT_4, INT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
@@ -38,6 +40,8 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_bf16bf16f32;
     case IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16:
       return iree_uk_mmt4d_type_bf16bf16bf16;
+    case IREE_UK_FLAG_MMT4D_TYPE_I8I4I32:
+      return iree_uk_mmt4d_type_i8i4i32;
     default:
       // This unreachable statement is not just an optimization, it also works
       // around a LLVM/riscv32 miscompile.
@@ -42,6 +42,49 @@ static void iree_uk_mmt4d_tile_i8i8i32_generic(
   for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
 }
 
+// Generic implementation of matmul tile, i8*i4->i32 case.
+// The RHS tile holds N0*K0 signed int4 values, two per byte along K0, with the
+// even-k0 value in the low nibble.
+static void iree_uk_mmt4d_tile_i8i4i32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, iree_uk_int32_t K, iree_uk_uint32_t flags,
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* out_tile = out_tile_untyped;
+  const iree_uk_int8_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // Initialize the local accumulator tile.
+  iree_uk_int32_t acc[iree_uk_mmt4d_tile_generic_max_bytes / sizeof(*out_tile)];
+  if (flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = out_tile[i];
+  } else {
+    for (int i = 0; i < M0 * N0; ++i) acc[i] = 0;
+  }
+  // Accumulation loop.
+  for (iree_uk_index_t k = 0; k < K; ++k) {
+    for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+      for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+        for (iree_uk_index_t k0 = 0; k0 < K0; k0 += 2) {
+          iree_uk_uint8_t rhs_byte = rhs_panel[(j0 * K0 + k0) / 2];
+          // Sign-extend each nibble by moving it to the top of an int8.
+          iree_uk_int32_t rhs_lo_i32 = (iree_uk_int8_t)(rhs_byte << 4) >> 4;
+          iree_uk_int32_t rhs_hi_i32 = (iree_uk_int8_t)rhs_byte >> 4;
+          iree_uk_int32_t lhs_lo_i32 = lhs_panel[i0 * K0 + k0];
+          iree_uk_int32_t lhs_hi_i32 = lhs_panel[i0 * K0 + k0 + 1];
+          acc[i0 * N0 + j0] +=
+              lhs_lo_i32 * rhs_lo_i32 + lhs_hi_i32 * rhs_hi_i32;
+        }
+      }
+    }
+    lhs_panel += M0 * K0;
+    rhs_panel += N0 * K0 / 2;
+  }
+  // Store the local accumulator tile to the destination.
+  for (int i = 0; i < M0 * N0; ++i) out_tile[i] = acc[i];
+}
+
 // Generic implementation of matmul tile, f32*f32->f32 case.
 static void iree_uk_mmt4d_tile_f32f32f32_generic(
     void* out_tile_untyped, const void* lhs_panel_untyped,
@@ -241,6 +284,8 @@ static iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
       return iree_uk_mmt4d_tile_bf16bf16f32_generic;
     case iree_uk_mmt4d_type_bf16bf16bf16:
       return iree_uk_mmt4d_tile_bf16bf16bf16_generic;
+    case iree_uk_mmt4d_type_i8i4i32:
+      return iree_uk_mmt4d_tile_i8i4i32_generic;
     default:
       // shouldn't happen, validated earlier.
       IREE_UK_ASSUME_UNREACHABLE;
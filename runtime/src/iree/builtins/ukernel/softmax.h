@@ -0,0 +1,43 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// `softmax` microkernel. Computes the softmax of each row of a 2D buffer, i.e.
+// out[i, j] = exp(in[i, j] - max_j(in[i, :])) / sum_j(exp(in[i, :] - max)).
+// Arithmetic is performed in f32 regardless of the element type.
+//
+// Each row is traversed twice: a first pass computes the max and the sum of
+// exponentials together ("online softmax"), rescaling the running sum whenever
+// the running max increases, and a second pass writes the output.
+
+typedef struct iree_uk_softmax_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_softmax_params_t;
+
+IREE_UK_EXPORT int iree_uk_softmax(const iree_uk_softmax_params_t* params);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_H_
@@ -0,0 +1,62 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
+
+#include "iree/builtins/ukernel/softmax.h"
+
+typedef enum iree_uk_softmax_type_t {
+  iree_uk_softmax_type_f32f32 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_32, FLOAT_32),
+  iree_uk_softmax_type_f16f16 = IREE_UK_TIE_2_TYPES_LITERAL(FLOAT_16, FLOAT_16),
+  iree_uk_softmax_type_bf16bf16 =
+      IREE_UK_TIE_2_TYPES_LITERAL(BFLOAT_16, BFLOAT_16),
+} iree_uk_softmax_type_t;
+
+static inline iree_uk_softmax_type_t iree_uk_softmax_type(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_SOFTMAX_TYPE_MASK) {
+    case IREE_UK_FLAG_SOFTMAX_TYPE_F32F32:
+      return iree_uk_softmax_type_f32f32;
+    case IREE_UK_FLAG_SOFTMAX_TYPE_F16F16:
+      return iree_uk_softmax_type_f16f16;
+    case IREE_UK_FLAG_SOFTMAX_TYPE_BF16BF16:
+      return iree_uk_softmax_type_bf16bf16;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+static inline iree_uk_type_t iree_uk_softmax_in_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(0, type);
+}
+
+static inline iree_uk_type_t iree_uk_softmax_out_type(
+    iree_uk_softmax_type_t type) {
+  return iree_uk_untie_type(1, type);
+}
+
+// Computes the softmax of the `size` contiguous elements at `in_row` into
+// `out_row`. The element types are implied by the selected function.
+typedef void (*iree_uk_softmax_row_func_t)(
+    void* IREE_UK_RESTRICT out_row, const void* IREE_UK_RESTRICT in_row,
+    iree_uk_index_t size);
+
+// Row kernel declarations. Prototype matches iree_uk_softmax_row_func_t.
+#define IREE_UK_SOFTMAX_ROW_FUNC_DECL(NAME)                      \
+  void NAME(void* IREE_UK_RESTRICT out_row,                      \
+            const void* IREE_UK_RESTRICT in_row, iree_uk_index_t size);
+
+// Returns the row function to use for the softmax op with the given params.
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func(
+    const iree_uk_softmax_params_t* params);
+
+// Architecture-specific implementation.
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_arch(
+    const iree_uk_softmax_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_INTERNAL_H_
@@ -0,0 +1,72 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+// Generic implementation of the softmax row function, templatized over the
+// element type through the LOAD/STORE functions converting to/from f32.
+#define IREE_UK_SOFTMAX_ROW_GENERIC(NAME, ELEM_TYPE, LOAD, STORE)          \
+  static void NAME(void* IREE_UK_RESTRICT out_row,                         \
+                   const void* IREE_UK_RESTRICT in_row,                    \
+                   iree_uk_index_t size) {                                 \
+    const ELEM_TYPE* IREE_UK_RESTRICT in_ptr = in_row;                     \
+    ELEM_TYPE* IREE_UK_RESTRICT out_ptr = out_row;                         \
+    /* Single pass computing the max and the sum of exponentials relative  \
+     * to the running max, rescaling the sum when the max increases. */    \
+    float max = IREE_UK_F32_LOWEST;                                        \
+    float sum = 0.0f;                                                      \
+    for (iree_uk_index_t i = 0; i < size; ++i) {                           \
+      float x = LOAD(in_ptr[i]);                                           \
+      if (x > max) {                                                       \
+        sum *= iree_uk_exp_f32(max - x);                                   \
+        max = x;                                                           \
+      }                                                                    \
+      sum += iree_uk_exp_f32(x - max);                                     \
+    }                                                                      \
+    float inv_sum = 1.0f / sum;                                            \
+    for (iree_uk_index_t i = 0; i < size; ++i) {                           \
+      out_ptr[i] = STORE(iree_uk_exp_f32(LOAD(in_ptr[i]) - max) * inv_sum); \
+    }                                                                      \
+  }
+
+static inline float iree_uk_softmax_load_f32(float x) { return x; }
+static inline float iree_uk_softmax_store_f32(float x) { return x; }
+
+IREE_UK_SOFTMAX_ROW_GENERIC(iree_uk_softmax_row_generic_f32f32, float,
+                            iree_uk_softmax_load_f32,
+                            iree_uk_softmax_store_f32)
+IREE_UK_SOFTMAX_ROW_GENERIC(iree_uk_softmax_row_generic_f16f16,
+                            iree_uk_uint16_t, iree_uk_f16_to_f32,
+                            iree_uk_f32_to_f16)
+IREE_UK_SOFTMAX_ROW_GENERIC(iree_uk_softmax_row_generic_bf16bf16,
+                            iree_uk_uint16_t, iree_uk_bf16_to_f32,
+                            iree_uk_f32_to_bf16)
+
+static iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func_generic(
+    const iree_uk_softmax_params_t* params) {
+  switch (iree_uk_softmax_type(params->flags)) {
+    case iree_uk_softmax_type_f32f32:
+      return iree_uk_softmax_row_generic_f32f32;
+    case iree_uk_softmax_type_f16f16:
+      return iree_uk_softmax_row_generic_f16f16;
+    case iree_uk_softmax_type_bf16bf16:
+      return iree_uk_softmax_row_generic_bf16bf16;
+    default:
+      IREE_UK_ASSUME_UNREACHABLE;
+  }
+}
+
+// Select the 'row function' that is the typically target-optimized inner loop
+// implementation.
+iree_uk_softmax_row_func_t iree_uk_softmax_select_row_func(
+    const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_row_func_t arch_row_func =
+      iree_uk_softmax_select_row_func_arch(params);
+  if (arch_row_func) {
+    return arch_row_func;
+  }
+  return iree_uk_softmax_select_row_func_generic(params);
+}
@@ -0,0 +1,180 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/layernorm_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static float iree_uk_test_layernorm_load(iree_uk_type_t type, const void* buf,
+                                         iree_uk_index_t i) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_32:
+      return ((const float*)buf)[i];
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_math_f16_to_f32(((const uint16_t*)buf)[i]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_math_bf16_to_f32(((const uint16_t*)buf)[i]);
+    default:
+      IREE_UK_ASSERT(false && "unhandled type");
+      return 0.0f;
+  }
+}
+
+// Reference implementation computing in double precision with libm. Returns
+// the mean and the reciprocal standard deviation of row `i0` of the input.
+static void iree_uk_test_layernorm_reference_row(
+    const iree_uk_layernorm_params_t* params, iree_uk_index_t i0,
+    double* out_mean, double* out_rstd) {
+  iree_uk_type_t in_type =
+      iree_uk_layernorm_in_type(iree_uk_layernorm_type(params->flags));
+  iree_uk_index_t row = params->in_offset + i0 * params->in_stride0;
+  double mean = 0.0;
+  if (!(params->flags & IREE_UK_FLAG_LAYERNORM_RMS)) {
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      mean += iree_uk_test_layernorm_load(in_type, params->in_buffer, row + j);
+    }
+    mean /= params->size1;
+  }
+  double var = 0.0;
+  for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+    double d =
+        iree_uk_test_layernorm_load(in_type, params->in_buffer, row + j) -
+        mean;
+    var += d * d;
+  }
+  var /= params->size1;
+  *out_mean = mean;
+  *out_rstd = 1.0 / sqrt(var + params->epsilon);
+}
+
+static void iree_uk_test_layernorm_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_layernorm_params_t* params) {
+  iree_uk_layernorm_type_t layernorm_type =
+      iree_uk_layernorm_type(params->flags);
+  iree_uk_type_t in_type = iree_uk_layernorm_in_type(layernorm_type);
+  iree_uk_type_t out_type = iree_uk_layernorm_out_type(layernorm_type);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+
+  iree_uk_layernorm_params_t actual_params = *params;
+  iree_uk_index_t in_buffer_size = iree_uk_2d_buffer_length(
+      in_type, params->in_offset + params->size0, params->in_stride0);
+  iree_uk_index_t out_buffer_size = iree_uk_2d_buffer_length(
+      out_type, params->out_offset + params->size0, params->out_stride0);
+  iree_uk_index_t vec_buffer_size =
+      iree_uk_2d_buffer_length(in_type, 1, params->size1);
+  void* in_buffer = malloc(in_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  void* scale_buffer = malloc(vec_buffer_size);
+  void* bias_buffer = malloc(vec_buffer_size);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  iree_uk_write_random_buffer(scale_buffer, vec_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(bias_buffer, vec_buffer_size, in_type, engine);
+  actual_params.in_buffer = in_buffer;
+  actual_params.out_buffer = out_buffer;
+  actual_params.scale_buffer = scale_buffer;
+  actual_params.bias_buffer = bias_buffer;
+  iree_uk_layernorm(&actual_params);
+
+  // Outputs are computed in f32 and then rounded to the output type.
+  bool is_f32 = out_type == IREE_UK_TYPE_FLOAT_32;
+  double rtol = is_f32 ? 1e-4 : 1e-2;
+  double atol = is_f32 ? 1e-4 : 1e-2;
+  for (iree_uk_index_t i0 = 0; i0 < params->size0; ++i0) {
+    double mean = 0.0;
+    double rstd = 0.0;
+    iree_uk_test_layernorm_reference_row(&actual_params, i0, &mean, &rstd);
+    for (iree_uk_index_t i1 = 0; i1 < params->size1; ++i1) {
+      double x = iree_uk_test_layernorm_load(
+          in_type, in_buffer, params->in_offset + i0 * params->in_stride0 + i1);
+      double expected = (x - mean) * rstd;
+      if (params->flags & IREE_UK_FLAG_LAYERNORM_SCALE) {
+        expected *= iree_uk_test_layernorm_load(in_type, scale_buffer, i1);
+      }
+      if (params->flags & IREE_UK_FLAG_LAYERNORM_BIAS) {
+        expected += iree_uk_test_layernorm_load(in_type, bias_buffer, i1);
+      }
+      double actual = iree_uk_test_layernorm_load(
+          out_type, out_buffer,
+          params->out_offset + i0 * params->out_stride0 + i1);
+      if (!(fabs(actual - expected) <= atol + rtol * fabs(expected))) {
+        fprintf(stderr, "layernorm mismatch at (%d, %d): %g vs expected %g\n",
+                (int)i0, (int)i1, actual, expected);
+        IREE_UK_TEST_FAIL(test);
+        goto done;
+      }
+    }
+  }
+
+done:
+  free(in_buffer);
+  free(out_buffer);
+  free(scale_buffer);
+  free(bias_buffer);
+}
+
+static void iree_uk_test_layernorm_for_params(iree_uk_test_t* test,
+                                              const void* src_params) {
+  // Row lengths exercising the vectorized loops and their tails.
+  const iree_uk_index_t sizes1[] = {1, 2, 3, 7, 8, 9, 15, 16,
+                                    17, 31, 33, 100, 257, 1000};
+  const iree_uk_uint32_t variant_flags[] = {
+      0,
+      IREE_UK_FLAG_LAYERNORM_SCALE | IREE_UK_FLAG_LAYERNORM_BIAS,
+      IREE_UK_FLAG_LAYERNORM_RMS,
+      IREE_UK_FLAG_LAYERNORM_RMS | IREE_UK_FLAG_LAYERNORM_SCALE,
+  };
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  for (int v = 0; v < IREE_ARRAYSIZE(variant_flags); ++v) {
+    for (int i = 0; i < IREE_ARRAYSIZE(sizes1); ++i) {
+      iree_uk_layernorm_params_t params;
+      memcpy(&params, src_params, sizeof params);
+      params.flags |= variant_flags[v];
+      params.cpu_data = iree_uk_test_cpu_data(test);
+      params.epsilon = 1e-5f;
+      params.size0 = 1 + iree_uk_random_engine_get_0_65535(engine) % 4;
+      params.size1 = sizes1[i];
+      params.in_offset = iree_uk_random_engine_get_0_65535(engine) % 4;
+      params.out_offset = iree_uk_random_engine_get_0_65535(engine) % 4;
+      params.in_stride0 =
+          params.size1 + iree_uk_random_engine_get_0_65535(engine) % 4;
+      params.out_stride0 =
+          params.size1 + iree_uk_random_engine_get_0_65535(engine) % 4;
+      iree_uk_test_layernorm_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_layernorm(iree_uk_uint32_t flags,
+                                   const char* cpu_features) {
+  iree_uk_layernorm_params_t params = {.flags = flags};
+  char types_str[32];
+  iree_uk_layernorm_type_t layernorm_type = iree_uk_layernorm_type(flags);
+  iree_uk_type_pair_str(types_str, sizeof types_str, layernorm_type);
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s", types_str);
+  iree_uk_test(test_label_str, iree_uk_test_layernorm_for_params, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature.
+  iree_uk_test_layernorm(IREE_UK_FLAG_LAYERNORM_TYPE_F32F32, "");
+  iree_uk_test_layernorm(IREE_UK_FLAG_LAYERNORM_TYPE_F16F16, "");
+  iree_uk_test_layernorm(IREE_UK_FLAG_LAYERNORM_TYPE_BF16BF16, "");
+
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_layernorm(IREE_UK_FLAG_LAYERNORM_TYPE_F32F32, "avx2_fma");
+  iree_uk_test_layernorm(IREE_UK_FLAG_LAYERNORM_TYPE_F32F32, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
@@ -137,34 +137,56 @@ static void iree_mmt4d_reference_innerloop_i8i8i32(
   *out_ptr = acc;
 }
 
+// The RHS holds int4 values packed two per byte along K0, low nibble first.
+static void iree_mmt4d_reference_innerloop_i8i4i32(
+    int32_t* out_ptr, const int8_t* lhs_ptr, const uint8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  int32_t acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      int32_t lhs_i32 = lhs_ptr[k * params->M0 * params->K0 + k0];
+      iree_uk_index_t rhs_index = k * params->N0 * params->K0 + k0;
+      uint8_t rhs_byte = rhs_ptr[rhs_index / 2];
+      int32_t rhs_i32 = (rhs_index & 1) ? (int8_t)rhs_byte >> 4
+                                        : (int8_t)(rhs_byte << 4) >> 4;
+      acc += lhs_i32 * rhs_i32;
+    }
+  }
+  *out_ptr = acc;
+}
+
 static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
-  iree_uk_index_t lhs_elem_size =
-      iree_uk_type_size(iree_uk_mmt4d_lhs_type(mmt4d_type));
-  iree_uk_index_t rhs_elem_size =
-      iree_uk_type_size(iree_uk_mmt4d_rhs_type(mmt4d_type));
-  iree_uk_index_t out_elem_size =
-      iree_uk_type_size(iree_uk_mmt4d_out_type(mmt4d_type));
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
   for (iree_uk_index_t i = 0; i < params->M; ++i) {
     for (iree_uk_index_t j = 0; j < params->N; ++j) {
-      void* out_tile_ptr = ((char*)params->out_buffer) +
-                           (params->out_offset + i * params->out_stride0 +
-                            j * params->M0 * params->N0) *
-                               out_elem_size;
+      void* out_tile_ptr =
+          ((char*)params->out_buffer) +
+          iree_uk_bits_to_bytes_exact(out_type,
+                                      params->out_offset +
+                                          i * params->out_stride0 +
+                                          j * params->M0 * params->N0);
       const void* lhs_panel_ptr =
           ((const char*)params->lhs_buffer) +
-          (params->lhs_offset + i * params->lhs_stride0) * lhs_elem_size;
+          iree_uk_bits_to_bytes_exact(
+              lhs_type, params->lhs_offset + i * params->lhs_stride0);
       const void* rhs_panel_ptr =
           ((const char*)params->rhs_buffer) +
-          (params->rhs_offset + j * params->rhs_stride0) * rhs_elem_size;
+          iree_uk_bits_to_bytes_exact(
+              rhs_type, params->rhs_offset + j * params->rhs_stride0);
       for (iree_uk_index_t i0 = 0; i0 < params->M0; ++i0) {
         for (iree_uk_index_t j0 = 0; j0 < params->N0; ++j0) {
           void* out_ptr =
-              ((char*)out_tile_ptr) + (i0 * params->N0 + j0) * out_elem_size;
+              ((char*)out_tile_ptr) +
+              iree_uk_bits_to_bytes_exact(out_type, i0 * params->N0 + j0);
           const void* lhs_ptr =
-              ((char*)lhs_panel_ptr) + i0 * params->K0 * lhs_elem_size;
+              ((char*)lhs_panel_ptr) +
+              iree_uk_bits_to_bytes_exact(lhs_type, i0 * params->K0);
           const void* rhs_ptr =
-              ((char*)rhs_panel_ptr) + j0 * params->K0 * rhs_elem_size;
+              ((char*)rhs_panel_ptr) +
+              iree_uk_bits_to_bytes_exact(rhs_type, j0 * params->K0);
           switch (params->flags & IREE_UK_FLAG_MMT4D_TYPE_MASK) {
             case IREE_UK_FLAG_MMT4D_TYPE_F32F32F32:
               iree_mmt4d_reference_innerloop_f32f32f32(
@@ -196,10 +218,14 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
                   (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
                   (const int8_t*)rhs_ptr, params);
               break;
+            case IREE_UK_FLAG_MMT4D_TYPE_I8I4I32:
+              iree_mmt4d_reference_innerloop_i8i4i32(
+                  (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, params);
+              break;
             default:
               IREE_UK_ASSERT(false && "unhandled type");
           }
-          out_ptr = ((char*)out_ptr) + out_elem_size;
         }
       }
     }
@@ -223,6 +249,9 @@ static void iree_uk_test_mmt4d_for_shape_params(
   iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
   iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
   iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  // Sub-byte RHS strides and offsets have to be whole bytes.
+  bool rhs_is_sub_byte = iree_uk_type_bit_count(rhs_type) < 8;
+  if (rhs_is_sub_byte) params.rhs_stride0 &= ~1;
   iree_uk_index_t lhs_buffer_size =
       iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
   iree_uk_index_t rhs_buffer_size =
@@ -233,11 +262,12 @@ static void iree_uk_test_mmt4d_for_shape_params(
   iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
   params.lhs_offset = iree_uk_random_engine_get_0_65535(engine);
   params.rhs_offset = iree_uk_random_engine_get_0_65535(engine);
+  if (rhs_is_sub_byte) params.rhs_offset &= ~1;
   params.out_offset = iree_uk_random_engine_get_0_65535(engine);
   params.lhs_buffer = (const char*)lhs_buffer -
-                      (params.lhs_offset * iree_uk_type_size(lhs_type));
+                      iree_uk_bits_to_bytes_exact(lhs_type, params.lhs_offset);
   params.rhs_buffer = (const char*)rhs_buffer -
-                      (params.rhs_offset * iree_uk_type_size(rhs_type));
+                      iree_uk_bits_to_bytes_exact(rhs_type, params.rhs_offset);
 
   iree_uk_mmt4d_params_t reference_params;
   memcpy(&reference_params, &params, sizeof params);
@@ -250,14 +280,15 @@ static void iree_uk_test_mmt4d_for_shape_params(
   memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
   reference_params.out_buffer =
       (char*)reference_out_buffer -
-      (params.out_offset * iree_uk_type_size(out_type));
+      iree_uk_bits_to_bytes_exact(out_type, params.out_offset);
 
   iree_uk_mmt4d_params_t actual_params;
   memcpy(&actual_params, &params, sizeof params);
   void* actual_out_buffer = malloc(out_buffer_size);
   memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
-  actual_params.out_buffer = (char*)actual_out_buffer -
-                             (params.out_offset * iree_uk_type_size(out_type));
+  actual_params.out_buffer =
+      (char*)actual_out_buffer -
+      iree_uk_bits_to_bytes_exact(out_type, params.out_offset);
 
   iree_mmt4d_reference(&reference_params);
   iree_uk_mmt4d(&actual_params);
@@ -382,6 +413,7 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 9, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 5, 3, 6, "");
 
 #if defined(IREE_ARCH_ARM_64)
   // On arm64, some code paths have inline asm and intrinsics variants. For them
@@ -398,6 +430,9 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 4, "dotprod");
   iree_uk_test_mmt4d_default_and_intrinsics(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8,
                                             8, 8, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 8, 8, 2, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 8, 8, 4, "dotprod");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 8, 8, 8, "i8mm");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 4, 1, "");  // SSE
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "avx2_fma");
@@ -414,6 +449,9 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 8, 8, 2, "avx2_fma");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_base");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I8I32, 16, 16, 2, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 8, 4, 2, "");  // SSE2
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 8, 8, 2, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_I8I4I32, 16, 16, 2, "avx512_vnni");
 #endif  // defined(IREE_ARCH_ARM_64)
 
   return iree_uk_test_exit_status();
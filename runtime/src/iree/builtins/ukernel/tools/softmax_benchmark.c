@@ -0,0 +1,110 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(
+    int64_t, working_set_size, 100000,
+    "Number of bytes to be traversed by the benchmark workload (input and "
+    "output buffers together). The number of rows is computed accordingly.");
+
+static iree_status_t iree_uk_benchmark_softmax(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
+  const iree_uk_softmax_params_t* src_params =
+      iree_uk_benchmark_params(user_data);
+  iree_uk_softmax_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
+  iree_uk_softmax_type_t softmax_type = iree_uk_softmax_type(params.flags);
+  iree_uk_type_t in_type = iree_uk_softmax_in_type(softmax_type);
+  iree_uk_type_t out_type = iree_uk_softmax_out_type(softmax_type);
+  iree_uk_index_t in_type_size = iree_uk_type_size(in_type);
+  iree_uk_index_t out_type_size = iree_uk_type_size(out_type);
+
+  // The row length is given to us as part of the benchmark user_data. The
+  // number of rows is determined based on FLAG_working_set_size.
+  params.size0 = iree_max(1, FLAG_working_set_size /
+                                 ((in_type_size + out_type_size) *
+                                  params.size1));
+  params.in_stride0 = params.size1;
+  params.out_stride0 = params.size1;
+  iree_uk_index_t in_buffer_size =
+      iree_uk_2d_buffer_length(in_type, params.size0, params.in_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.size0, params.out_stride0);
+  void* in_buffer = malloc(in_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_write_random_buffer(in_buffer, in_buffer_size, in_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params.in_buffer = in_buffer;
+  params.out_buffer = out_buffer;
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_softmax(&params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  // Report elements per second, which is the natural throughput metric for
+  // an op dominated by exp evaluation.
+  iree_benchmark_set_items_processed(
+      benchmark_state, total_iterations * params.size0 * params.size1);
+  free(in_buffer);
+  free(out_buffer);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_softmax(iree_uk_uint32_t flags,
+                                               int size1,
+                                               const char* cpu_features) {
+  char type_str[32];
+  iree_uk_softmax_type_t softmax_type = iree_uk_softmax_type(flags);
+  iree_uk_type_pair_str(type_str, sizeof type_str, softmax_type);
+  iree_uk_softmax_params_t params = {.flags = flags, .size1 = size1};
+  char name[128];
+  snprintf(name, sizeof name, "softmax_%s_row_%d_wss_%" PRIi64, type_str,
+           size1, FLAG_working_set_size);
+  iree_uk_benchmark_register(name, iree_uk_benchmark_softmax, &params,
+                             sizeof params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("softmax_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+  // Typical attention sequence lengths and classifier widths.
+  const int sizes1[] = {128, 1024, 4096};
+  for (int i = 0; i < IREE_ARRAYSIZE(sizes1); ++i) {
+    iree_uk_benchmark_register_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32,
+                                       sizes1[i], "");
+    iree_uk_benchmark_register_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F16F16,
+                                       sizes1[i], "");
+    iree_uk_benchmark_register_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_BF16BF16,
+                                       sizes1[i], "");
+#if defined(IREE_ARCH_X86_64)
+    iree_uk_benchmark_register_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32,
+                                       sizes1[i], "avx2_fma");
+    iree_uk_benchmark_register_softmax(IREE_UK_FLAG_SOFTMAX_TYPE_F32F32,
+                                       sizes1[i], "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+  }
+
+  iree_uk_benchmark_run_and_cleanup();
+}
@@ -10,10 +10,21 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
 #include "iree/hal/drivers/local_sync/sync_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
 
+IREE_FLAG(
+    int64_t, local_sync_dispatch_cache_capacity, 0,
+    "Enables memoization of dispatch outputs with the given capacity in\n"
+    "bytes. Dispatches are keyed on the executable, workgroup count, push\n"
+    "constants, and the contents of all bindings prior to the dispatch.\n"
+    "Pipeline layouts do not identify write-only outputs so output contents\n"
+    "are hashed as well: dispatches only hit when their outputs also match\n"
+    "and large outputs may exceed the per-dispatch hashing limit and bypass\n"
+    "the cache. 0 disables the cache.");
+
 static iree_status_t iree_hal_local_sync_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -38,6 +49,12 @@ static iree_status_t iree_hal_local_sync_driver_factory_try_create(
 
   iree_hal_sync_device_params_t default_params;
   iree_hal_sync_device_params_initialize(&default_params);
+  if (FLAG_local_sync_dispatch_cache_capacity < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch cache capacity must be >= 0");
+  }
+  default_params.dispatch_cache_capacity =
+      (iree_host_size_t)FLAG_local_sync_dispatch_cache_capacity;
 
   iree_hal_executable_plugin_manager_t* plugin_manager = NULL;
   iree_status_t status = iree_hal_executable_plugin_manager_create_from_flags(
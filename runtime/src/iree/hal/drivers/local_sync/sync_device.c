@@ -14,6 +14,7 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/hal/drivers/local_sync/sync_event.h"
 #include "iree/hal/drivers/local_sync/sync_semaphore.h"
+#include "iree/hal/local/dispatch_cache.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/inline_command_buffer.h"
 #include "iree/hal/local/local_executable_cache.h"
@@ -42,6 +43,10 @@ typedef struct iree_hal_sync_device_t {
   // synchronization ourselves.
   iree_hal_sync_semaphore_state_t semaphore_state;
 
+  // Optional cache memoizing dispatch outputs when enabled by the device
+  // params. NULL if disabled.
+  iree_hal_local_dispatch_cache_t* dispatch_cache;
+
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_sync_device_t;
@@ -111,6 +116,14 @@ iree_status_t iree_hal_sync_device_create(
     iree_hal_sync_semaphore_state_initialize(&device->semaphore_state);
   }
 
+  if (iree_status_is_ok(status) && params->dispatch_cache_capacity > 0) {
+    iree_hal_local_dispatch_cache_params_t dispatch_cache_params;
+    iree_hal_local_dispatch_cache_params_initialize(&dispatch_cache_params);
+    dispatch_cache_params.capacity = params->dispatch_cache_capacity;
+    status = iree_hal_local_dispatch_cache_create(
+        &dispatch_cache_params, host_allocator, &device->dispatch_cache);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -127,6 +140,8 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
 
   iree_hal_sync_semaphore_state_deinitialize(&device->semaphore_state);
 
+  iree_hal_local_dispatch_cache_free(device->dispatch_cache);
+
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -205,6 +220,11 @@ static iree_status_t iree_hal_sync_device_query_i64(
     }
   } else if (iree_string_view_equal(category, IREE_SV("hal.cpu"))) {
     return iree_cpu_lookup_data_by_key(key, out_value);
+  } else if (iree_string_view_equal(category, IREE_SV("hal.dispatch_cache"))) {
+    if (device->dispatch_cache) {
+      return iree_hal_local_dispatch_cache_query_i64(device->dispatch_cache,
+                                                     key, out_value);
+    }
   }
 
   return iree_make_status(
@@ -225,13 +245,14 @@ static iree_status_t iree_hal_sync_device_create_command_buffer(
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   if (iree_all_bits_set(mode,
                         IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION)) {
     return iree_hal_inline_command_buffer_create(
         base_device, mode, command_categories, queue_affinity, binding_capacity,
-        iree_hal_device_host_allocator(base_device), out_command_buffer);
+        device->dispatch_cache, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
   } else {
-    iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
     return iree_hal_deferred_command_buffer_create(
         base_device, mode, command_categories, binding_capacity,
         &device->large_block_pool, device->host_allocator, out_command_buffer);
@@ -260,7 +281,10 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_local_executable_cache_create(
-      identifier, /*worker_capacity=*/1, device->loader_count, device->loaders,
+      identifier, /*worker_capacity=*/1,
+      IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_NONE,
+      iree_hal_local_executable_load_scheduler_null(),
+      /*shared_executable_cache=*/NULL, device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -364,7 +388,8 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
           iree_hal_command_buffer_mode(command_buffer) |
               IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
           IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
-          /*binding_capacity=*/0, device->host_allocator, storage,
+          /*binding_capacity=*/0, device->dispatch_cache,
+          device->host_allocator, storage,
           &inline_command_buffer));
       iree_status_t status = iree_hal_deferred_command_buffer_apply(
           command_buffer, inline_command_buffer,
@@ -22,6 +22,11 @@ typedef struct iree_hal_sync_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Total bytes of dispatch outputs memoized by the device or 0 to disable
+  // dispatch result caching. See iree_hal_local_dispatch_cache_t for how
+  // dispatches are keyed and when they hit.
+  iree_host_size_t dispatch_cache_capacity;
 } iree_hal_sync_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -10,11 +10,43 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
 #include "iree/hal/drivers/local_task/task_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
 #include "iree/task/api.h"
 
+IREE_FLAG(
+    bool, local_task_share_executables, false,
+    "Shares loaded executables across all contexts and devices created from\n"
+    "the driver that load the same executable.");
+
+IREE_FLAG(
+    string, local_task_executable_loading, "eager",
+    "Controls when executables are loaded:\n"
+    "  eager: loaded when prepared.\n"
+    "  lazy: loaded when the first dispatch using them is recorded.\n"
+    "  parallel: loaded in parallel on the executor workers when prepared.");
+
+static iree_status_t iree_hal_local_task_parse_executable_loading(
+    iree_string_view_t value,
+    iree_hal_task_device_executable_loading_t* out_executable_loading) {
+  if (iree_string_view_equal(value, IREE_SV("eager"))) {
+    *out_executable_loading = IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_EAGER;
+  } else if (iree_string_view_equal(value, IREE_SV("lazy"))) {
+    *out_executable_loading = IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_LAZY;
+  } else if (iree_string_view_equal(value, IREE_SV("parallel"))) {
+    *out_executable_loading = IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_PARALLEL;
+  } else {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "unsupported --local_task_executable_loading mode '%.*s'; expected "
+        "one of eager, lazy, or parallel",
+        (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -41,6 +73,10 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
 
   iree_hal_task_device_params_t default_params;
   iree_hal_task_device_params_initialize(&default_params);
+  default_params.share_executables = FLAG_local_task_share_executables;
+  IREE_RETURN_IF_ERROR(iree_hal_local_task_parse_executable_loading(
+      iree_make_cstring_view(FLAG_local_task_executable_loading),
+      &default_params.executable_loading));
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
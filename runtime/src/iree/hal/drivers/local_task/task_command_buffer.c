@@ -14,6 +14,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/lazy_executable.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/utils/resource_set.h"
@@ -814,13 +815,12 @@ typedef struct iree_hal_cmd_dispatch_t {
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
-  // Total number of available 4 byte push constant values in |push_constants|.
-  uint16_t push_constant_count;
-
-  // Total number of binding base pointers in |binding_ptrs| and
-  // |binding_lengths|. The set is packed densely based on which binidngs are
-  // used (known at compile-time).
-  uint16_t binding_count;
+  // Read-only dispatch state shared by all workgroups in the dispatch such
+  // that every worker is hitting the same hot cache line(s). Populated during
+  // recording with the push constant and binding tables pointing into the
+  // trailing storage. Indirect dispatches don't know their workgroup count
+  // until issued and patch a copy of this per range of workgroups.
+  iree_hal_executable_dispatch_state_v0_t dispatch_state;
 
   // Following this structure in memory there are 3 tables:
   // - const uint32_t push_constants[push_constant_count];
@@ -828,54 +828,41 @@ typedef struct iree_hal_cmd_dispatch_t {
   // - const size_t binding_lengths[binding_count];
 } iree_hal_cmd_dispatch_t;
 
-static iree_status_t iree_hal_cmd_dispatch_tile(
+static iree_status_t iree_hal_cmd_dispatch_tiles(
     void* user_context, const iree_task_tile_context_t* tile_context,
-    iree_task_submission_t* pending_submission) {
+    uint32_t tile_count, iree_task_submission_t* pending_submission) {
   const iree_hal_cmd_dispatch_t* cmd =
       (const iree_hal_cmd_dispatch_t*)user_context;
-  IREE_TRACE_ZONE_BEGIN(z0);
 
-  // We could share this across all workgroups in a dispatch and reduce cache
-  // pressure as all cores would be hitting the same hot read-only cache line.
-  // It'd grow the size of iree_hal_cmd_dispatch_t by a few dozen bytes, though,
-  // and so we'd need some profiling to see if it's worth it (fixed command
-  // buffer cost vs potential for saving a cache miss or two).
-  iree_alignas(64) iree_hal_executable_dispatch_state_v0_t dispatch_state = {
-      .workgroup_size_x = tile_context->workgroup_size[0],
-      .workgroup_size_y = tile_context->workgroup_size[1],
-      .workgroup_size_z = tile_context->workgroup_size[2],
-      .push_constant_count = cmd->push_constant_count,
-      .workgroup_count_x = tile_context->workgroup_count[0],
-      .workgroup_count_y = tile_context->workgroup_count[1],
-      .workgroup_count_z = tile_context->workgroup_count[2],
-      .max_concurrency =
-          iree_task_affinity_set_count_ones(cmd->task.header.affinity_set),
-      .binding_count = cmd->binding_count,
-  };
-  uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
-  dispatch_state.push_constants = (uint32_t*)cmd_ptr;
-  cmd_ptr += cmd->push_constant_count * sizeof(*dispatch_state.push_constants);
-  dispatch_state.binding_ptrs = (void**)cmd_ptr;
-  cmd_ptr += cmd->binding_count * sizeof(*dispatch_state.binding_ptrs);
-  dispatch_state.binding_lengths = (size_t*)cmd_ptr;
-  cmd_ptr += cmd->binding_count * sizeof(*dispatch_state.binding_lengths);
-
-  const iree_alignas(64)
-      iree_hal_executable_workgroup_state_v0_t workgroup_state = {
-          .workgroup_id_x = tile_context->workgroup_xyz[0],
-          .workgroup_id_y = tile_context->workgroup_xyz[1],
-          .workgroup_id_z = tile_context->workgroup_xyz[2],
-          .reserved = 0,
-          .processor_id = tile_context->processor_id,
-          .local_memory = tile_context->local_memory.data,
-          .local_memory_size = (size_t)tile_context->local_memory.data_length,
-      };
-  iree_status_t status = iree_hal_local_executable_issue_call(
-      cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
-      tile_context->worker_id);
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+      &cmd->dispatch_state;
+  iree_alignas(64) iree_hal_executable_dispatch_state_v0_t issued_state;
+  if (IREE_UNLIKELY(
+          dispatch_state->workgroup_count_x !=
+              tile_context->workgroup_count[0] ||
+          dispatch_state->workgroup_count_y !=
+              tile_context->workgroup_count[1] ||
+          dispatch_state->workgroup_count_z !=
+              (uint16_t)tile_context->workgroup_count[2])) {
+    issued_state = *dispatch_state;
+    issued_state.workgroup_count_x = tile_context->workgroup_count[0];
+    issued_state.workgroup_count_y = tile_context->workgroup_count[1];
+    issued_state.workgroup_count_z = tile_context->workgroup_count[2];
+    dispatch_state = &issued_state;
+  }
 
-  IREE_TRACE_ZONE_END(z0);
-  return status;
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = tile_context->workgroup_xyz[0],
+      .workgroup_id_y = tile_context->workgroup_xyz[1],
+      .workgroup_id_z = tile_context->workgroup_xyz[2],
+      .reserved = 0,
+      .processor_id = tile_context->processor_id,
+      .local_memory = tile_context->local_memory.data,
+      .local_memory_size = (size_t)tile_context->local_memory.data_length,
+  };
+  return iree_hal_local_executable_issue_call_range(
+      cmd->executable, cmd->ordinal, dispatch_state, &workgroup_state,
+      tile_count, tile_context->worker_id);
 }
 
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
@@ -886,8 +873,9 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  iree_hal_local_executable_t* local_executable =
-      iree_hal_local_executable_cast(executable);
+  iree_hal_local_executable_t* local_executable = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_local_lazy_executable_resolve(executable, &local_executable));
   if (IREE_UNLIKELY(!local_executable->pipeline_layouts)) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -902,7 +890,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   iree_host_size_t used_binding_count =
       iree_math_count_ones_u64(used_binding_mask);
 
-  // To save a few command buffer bytes we narrow these:
+  // The dispatch state narrows these:
   if (IREE_UNLIKELY(push_constant_count >= UINT16_MAX) ||
       IREE_UNLIKELY(used_binding_count >= UINT16_MAX)) {
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
@@ -919,16 +907,18 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
-  cmd->push_constant_count = push_constant_count;
-  cmd->binding_count = used_binding_count;
 
   const uint32_t workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
   // TODO(benvanik): expose on API or keep fixed on executable.
   const uint32_t workgroup_size[3] = {1, 1, 1};
   iree_task_dispatch_initialize(
       command_buffer->scope,
-      iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
+      iree_task_make_dispatch_range_closure(iree_hal_cmd_dispatch_tiles,
+                                            (void*)cmd),
       workgroup_size, workgroup_count, &cmd->task);
+  IREE_STATISTICS(cmd->task.duration_metric =
+                      iree_hal_local_executable_dispatch_metric(
+                          local_executable, entry_point));
 
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
@@ -939,6 +929,29 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Schedule workgroups in the order the executable requested (if any). The
+  // order only changes which workgroups execute concurrently to improve cache
+  // locality and unknown orders can be safely ignored.
+  if (local_executable->dispatch_attrs) {
+    const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs =
+        &local_executable->dispatch_attrs[entry_point];
+    switch (dispatch_attrs->workgroup_order) {
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_COLUMN_MAJOR:
+        cmd->task.order = IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR;
+        break;
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_MORTON:
+        cmd->task.order = IREE_TASK_DISPATCH_ORDER_MORTON;
+        break;
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_GROUPED:
+        cmd->task.order = IREE_TASK_DISPATCH_ORDER_GROUPED;
+        break;
+      default:
+        cmd->task.order = IREE_TASK_DISPATCH_ORDER_LINEAR;
+        break;
+    }
+    cmd->task.order_group_size = dispatch_attrs->workgroup_order_group_size;
+  }
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -972,6 +985,22 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     }
   }
 
+  cmd->dispatch_state = (iree_hal_executable_dispatch_state_v0_t){
+      .workgroup_size_x = workgroup_size[0],
+      .workgroup_size_y = workgroup_size[1],
+      .workgroup_size_z = workgroup_size[2],
+      .push_constant_count = push_constant_count,
+      .workgroup_count_x = workgroup_count[0],
+      .workgroup_count_y = workgroup_count[1],
+      .workgroup_count_z = workgroup_count[2],
+      .max_concurrency =
+          iree_task_affinity_set_count_ones(cmd->task.header.affinity_set),
+      .binding_count = used_binding_count,
+      .push_constants = push_constants,
+      .binding_ptrs = binding_ptrs,
+      .binding_lengths = binding_lengths,
+  };
+
   *out_cmd = cmd;
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
@@ -19,6 +19,7 @@
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/shared_executable_cache.h"
 #include "iree/hal/utils/buffer_transfer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
@@ -43,6 +44,16 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Executable cache flags derived from the device params.
+  iree_hal_local_executable_cache_flags_t executable_cache_flags;
+  // Cache used to share executables across executable caches when enabled.
+  iree_hal_local_shared_executable_cache_t* shared_executable_cache;
+  iree_hal_task_device_executable_loading_t executable_loading;
+
+  // Scope used for parallel executable loads when using
+  // IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_PARALLEL.
+  iree_task_scope_t executable_load_scope;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -58,10 +69,16 @@ static iree_hal_task_device_t* iree_hal_task_device_cast(
 void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
+  out_params->share_executables = false;
+  out_params->shared_executable_cache = NULL;
+  out_params->executable_loading =
+      IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_EAGER;
+  out_params->partition = NULL;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
-    const iree_hal_task_device_params_t* params, iree_host_size_t queue_count) {
+    const iree_hal_task_device_params_t* params, iree_host_size_t queue_count,
+    iree_task_executor_t* const* queue_executors) {
   if (params->arena_block_size < 4096) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "arena block size too small (< 4096 bytes)");
@@ -70,6 +87,19 @@ static iree_status_t iree_hal_task_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "must have at least one queue");
   }
+  if (params->partition) {
+    iree_task_executor_t* executor =
+        iree_task_partition_executor(params->partition);
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      if (queue_executors[i] != executor) {
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "partition must belong to all queue executors; queue %" PRIhsz
+            " uses a different executor",
+            i);
+      }
+    }
+  }
   return iree_ok_status();
 }
 
@@ -96,7 +126,8 @@ iree_status_t iree_hal_task_device_create(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_task_device_check_params(params, queue_count));
+      z0, iree_hal_task_device_check_params(params, queue_count,
+                                             queue_executors));
 
   iree_hal_task_device_t* device = NULL;
   iree_host_size_t struct_size = sizeof(*device) +
@@ -114,6 +145,27 @@ iree_status_t iree_hal_task_device_create(
     device->host_allocator = host_allocator;
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
+    device->executable_cache_flags = IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_NONE;
+    device->executable_loading = params->executable_loading;
+    if (device->executable_loading !=
+        IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_EAGER) {
+      device->executable_cache_flags |=
+          IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED;
+    }
+    if (params->share_executables) {
+      if (params->shared_executable_cache) {
+        device->shared_executable_cache = params->shared_executable_cache;
+        iree_hal_local_shared_executable_cache_retain(
+            device->shared_executable_cache);
+      } else {
+        status = iree_hal_local_shared_executable_cache_create(
+            host_allocator, &device->shared_executable_cache);
+      }
+    }
+    iree_task_scope_initialize(iree_make_cstring_view("executable_load"),
+                               &device->executable_load_scope);
+    iree_task_scope_set_partition(&device->executable_load_scope,
+                                  params->partition);
 
     iree_arena_block_pool_initialize(4096, host_allocator,
                                      &device->small_block_pool);
@@ -135,6 +187,8 @@ iree_status_t iree_hal_task_device_create(
       iree_hal_task_queue_initialize(device->identifier, queue_executors[i],
                                      &device->small_block_pool,
                                      &device->queues[i]);
+      iree_task_scope_set_partition(&device->queues[i].scope,
+                                    params->partition);
     }
   }
 
@@ -152,6 +206,12 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Wait for any in-flight executable loads to complete while the executors
+  // are still retained by the queues.
+  iree_status_ignore(iree_task_scope_wait_idle(&device->executable_load_scope,
+                                               IREE_TIME_INFINITE_FUTURE));
+  iree_task_scope_deinitialize(&device->executable_load_scope);
+
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
@@ -160,6 +220,8 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
 
+  iree_hal_local_shared_executable_cache_release(
+      device->shared_executable_cache);
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
 
@@ -249,6 +311,12 @@ static iree_status_t iree_hal_task_device_query_i64(
     }
   } else if (iree_string_view_equal(category, IREE_SV("hal.cpu"))) {
     return iree_cpu_lookup_data_by_key(key, out_value);
+  } else if (iree_string_view_equal(category,
+                                    IREE_SV("hal.shared_executable_cache"))) {
+    if (device->shared_executable_cache) {
+      return iree_hal_local_shared_executable_cache_query_i64(
+          device->shared_executable_cache, key, out_value);
+    }
   }
 
   return iree_make_status(
@@ -309,6 +377,63 @@ static iree_status_t iree_hal_task_device_create_event(
                                     out_event);
 }
 
+// A parallel executable load task allocated per scheduled load.
+typedef struct iree_hal_task_device_load_task_t {
+  iree_task_call_t task;
+  iree_allocator_t host_allocator;
+  iree_hal_local_executable_load_fn_t fn;
+  void* user_data;
+  bool issued;
+} iree_hal_task_device_load_task_t;
+
+static iree_status_t iree_hal_task_device_load_task_call(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  iree_hal_task_device_load_task_t* load_task =
+      (iree_hal_task_device_load_task_t*)user_context;
+  load_task->issued = true;
+  load_task->fn(load_task->user_data);
+  return iree_ok_status();
+}
+
+static void iree_hal_task_device_load_task_cleanup(
+    iree_task_t* task, iree_status_code_t status_code) {
+  iree_hal_task_device_load_task_t* load_task =
+      (iree_hal_task_device_load_task_t*)task;
+  // The load function must be called exactly once even if the task was
+  // aborted prior to issuing.
+  if (!load_task->issued) load_task->fn(load_task->user_data);
+  iree_allocator_free(load_task->host_allocator, load_task);
+}
+
+// Schedules an executable load on the first queue executor.
+static iree_status_t iree_hal_task_device_schedule_executable_load(
+    void* self, iree_hal_local_executable_load_fn_t fn, void* user_data) {
+  iree_hal_task_device_t* device = (iree_hal_task_device_t*)self;
+  iree_hal_task_device_load_task_t* load_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->host_allocator, sizeof(*load_task), (void**)&load_task));
+  load_task->host_allocator = device->host_allocator;
+  load_task->fn = fn;
+  load_task->user_data = user_data;
+  load_task->issued = false;
+  iree_task_call_initialize(
+      &device->executable_load_scope,
+      iree_task_make_call_closure(iree_hal_task_device_load_task_call,
+                                  load_task),
+      &load_task->task);
+  iree_task_set_cleanup_fn(&load_task->task.header,
+                           iree_hal_task_device_load_task_cleanup);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &load_task->task.header);
+  iree_task_executor_t* executor = device->queues[0].executor;
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
@@ -322,9 +447,19 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
         iree_task_executor_worker_count(device->queues[i].executor);
   }
 
+  iree_hal_local_executable_load_scheduler_t load_scheduler =
+      iree_hal_local_executable_load_scheduler_null();
+  if (device->executable_loading ==
+      IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_PARALLEL) {
+    load_scheduler.self = device;
+    load_scheduler.schedule = iree_hal_task_device_schedule_executable_load;
+  }
+
   return iree_hal_local_executable_cache_create(
-      identifier, total_worker_count, device->loader_count, device->loaders,
-      iree_hal_device_host_allocator(base_device), out_executable_cache);
+      identifier, total_worker_count, device->executable_cache_flags,
+      load_scheduler, device->shared_executable_cache, device->loader_count,
+      device->loaders, iree_hal_device_host_allocator(base_device),
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_task_device_import_file(
@@ -477,10 +612,8 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  return iree_hal_task_semaphore_multi_wait(
-      wait_mode, semaphore_list, timeout,
-      iree_hal_task_device_shared_event_pool(device),
-      &device->large_block_pool);
+  return iree_hal_task_semaphore_multi_wait(wait_mode, semaphore_list, timeout,
+                                            &device->large_block_pool);
 }
 
 static iree_status_t iree_hal_task_device_profiling_begin(
@@ -10,12 +10,24 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/shared_executable_cache.h"
 #include "iree/task/executor.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+// Controls when executables are loaded.
+typedef enum iree_hal_task_device_executable_loading_e {
+  // Executables are loaded on the thread preparing them.
+  IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_EAGER = 0,
+  // Executables are loaded when the first dispatch using them is recorded.
+  IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_LAZY,
+  // Executables are loaded in parallel on the executor workers as they are
+  // prepared and the first dispatch using them waits for the load to complete.
+  IREE_HAL_TASK_DEVICE_EXECUTABLE_LOADING_PARALLEL,
+} iree_hal_task_device_executable_loading_t;
+
 // Parameters configuring an iree_hal_task_device_t.
 // Must be initialized with iree_hal_task_device_params_initialize prior to use.
 typedef struct iree_hal_task_device_params_t {
@@ -23,6 +35,28 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Shares loaded executables across all contexts preparing the same
+  // executable such that they use one loaded copy. Disabled by default.
+  // See iree/hal/local/shared_executable_cache.h.
+  bool share_executables;
+
+  // Optional shared executable cache used when |share_executables| is set.
+  // Allows devices using the same queue executors to share executables with
+  // each other; must not be used by devices using different executors. When
+  // omitted the device creates a cache used only by itself. Retained by the
+  // device.
+  iree_hal_local_shared_executable_cache_t* shared_executable_cache;
+
+  // Controls when executables are loaded. Deferring loading reduces the time
+  // taken to initialize programs with many executables.
+  iree_hal_task_device_executable_loading_t executable_loading;
+
+  // Optional executor partition that all work submitted to the device is
+  // scheduled on. Must be a partition of every queue executor. Workers can be
+  // moved into and out of the partition while the device is in use to
+  // rebalance devices sharing the same executor. Retained by the device.
+  iree_task_partition_t* partition;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
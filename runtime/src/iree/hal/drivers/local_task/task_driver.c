@@ -75,6 +75,20 @@ iree_status_t iree_hal_task_driver_create(
     memcpy(&driver->default_params, default_params,
            sizeof(driver->default_params));
 
+    // All devices created from the driver use the same executors and can
+    // share executables with each other.
+    if (driver->default_params.share_executables) {
+      if (driver->default_params.shared_executable_cache) {
+        iree_hal_local_shared_executable_cache_retain(
+            driver->default_params.shared_executable_cache);
+      } else {
+        status = iree_hal_local_shared_executable_cache_create(
+            host_allocator, &driver->default_params.shared_executable_cache);
+      }
+    } else {
+      driver->default_params.shared_executable_cache = NULL;
+    }
+
     driver->queue_count = queue_count;
     driver->queue_executors =
         (iree_task_executor_t**)((uint8_t*)driver + queue_executors_offset);
@@ -105,6 +119,8 @@ static void iree_hal_task_driver_destroy(iree_hal_driver_t* base_driver) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_allocator_release(driver->device_allocator);
+  iree_hal_local_shared_executable_cache_release(
+      driver->default_params.shared_executable_cache);
   for (iree_host_size_t i = 0; i < driver->loader_count; ++i) {
     iree_hal_executable_loader_release(driver->loaders[i]);
   }
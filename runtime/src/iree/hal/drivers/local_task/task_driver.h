@@ -27,6 +27,9 @@ extern "C" {
 //
 // |loaders| is the set of executable loaders that are available for loading in
 // the device context. The loaders are retained for the lifetime of the device.
+//
+// When |default_params| enables sharing executables all devices created from
+// the driver share executables through a single shared executable cache.
 iree_status_t iree_hal_task_driver_create(
     iree_string_view_t identifier,
     const iree_hal_task_device_params_t* default_params,
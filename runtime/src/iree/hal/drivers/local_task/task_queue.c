@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/local_task/task_queue.h"
 
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
@@ -181,6 +182,9 @@ typedef struct iree_hal_task_queue_issue_cmd_t {
   // if we are the last issue pending.
   iree_hal_task_queue_t* queue;
 
+  // Optional storage in the retire command receiving the time issue began.
+  iree_time_t* start_time_ns;
+
   // Command buffers to be issued in the order the appeared in the submission.
   iree_host_size_t command_buffer_count;
   iree_hal_command_buffer_t* command_buffers[];
@@ -193,6 +197,8 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
   iree_hal_task_queue_issue_cmd_t* cmd = (iree_hal_task_queue_issue_cmd_t*)task;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (cmd->start_time_ns) *cmd->start_time_ns = iree_time_now();
+
   iree_status_t status = iree_ok_status();
 
   // NOTE: it's ok for there to be no command buffers - in that case the
@@ -236,7 +242,8 @@ static void iree_hal_task_queue_issue_cmd_cleanup(
 // Allocates and initializes a iree_hal_task_queue_issue_cmd_t task.
 static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
     iree_task_scope_t* scope, iree_hal_task_queue_t* queue,
-    iree_task_t* retire_task, iree_host_size_t command_buffer_count,
+    iree_task_t* retire_task, iree_time_t* start_time_ns,
+    iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers,
     iree_arena_allocator_t* arena, iree_hal_task_queue_issue_cmd_t** out_cmd) {
   iree_hal_task_queue_issue_cmd_t* cmd = NULL;
@@ -252,6 +259,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
                            iree_hal_task_queue_issue_cmd_cleanup);
   cmd->arena = arena;
   cmd->queue = queue;
+  cmd->start_time_ns = start_time_ns;
 
   cmd->command_buffer_count = command_buffer_count;
   for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
@@ -283,6 +291,13 @@ typedef struct iree_hal_task_queue_retire_cmd_t {
   // A list of semaphores to signal upon retiring.
   iree_hal_semaphore_list_t signal_semaphores;
 
+  // Optional submission latency histograms from the queue. When set the
+  // submission and issue start times are recorded for observation on retire.
+  iree_metric_t* submit_to_start_metric;
+  iree_metric_t* start_to_retire_metric;
+  iree_time_t submit_time_ns;
+  iree_time_t start_time_ns;
+
   // Resources retained until all have retired.
   // We could release them earlier but that would require tracking individual
   // resource-level completion.
@@ -299,6 +314,18 @@ static iree_status_t iree_hal_task_queue_retire_cmd(
       (iree_hal_task_queue_retire_cmd_t*)task;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (cmd->submit_to_start_metric) {
+    // Submissions without command buffers have no issue step and start as
+    // they retire.
+    iree_time_t retire_time_ns = iree_time_now();
+    iree_time_t start_time_ns =
+        cmd->start_time_ns ? cmd->start_time_ns : retire_time_ns;
+    iree_metric_observe(cmd->submit_to_start_metric,
+                        start_time_ns - cmd->submit_time_ns);
+    iree_metric_observe(cmd->start_to_retire_metric,
+                        retire_time_ns - start_time_ns);
+  }
+
   // Release command buffers now that all are known to have retired.
   // We do this before signaling so that waiting threads can immediately reuse
   // resources that are released.
@@ -381,6 +408,10 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
         &cmd->task);
     iree_task_set_cleanup_fn(&cmd->task.header,
                              iree_hal_task_queue_retire_cmd_cleanup);
+    cmd->submit_to_start_metric = NULL;
+    cmd->start_to_retire_metric = NULL;
+    cmd->submit_time_ns = 0;
+    cmd->start_time_ns = 0;
   }
 
   // Clone the signal semaphores from the batch - we retain them and their
@@ -412,6 +443,41 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
 // iree_hal_task_queue_t
 //===----------------------------------------------------------------------===//
 
+// Registers the queue latency histograms in the default metrics registry, if
+// any. Metrics are best-effort and the queue functions without them.
+static void iree_hal_task_queue_initialize_metrics(
+    iree_string_view_t identifier, iree_hal_task_queue_t* queue) {
+  iree_metrics_registry_t* registry = iree_metrics_registry_default();
+  if (!registry) return;
+  char labels[128];
+  int labels_length = snprintf(labels, sizeof(labels), "queue=\"%.*s\"",
+                               (int)identifier.size, identifier.data);
+  if (labels_length < 0 || labels_length >= (int)sizeof(labels)) return;
+  iree_metric_t* submit_to_start_metric = NULL;
+  iree_metric_t* start_to_retire_metric = NULL;
+  iree_status_t status = iree_metrics_registry_lookup_or_create(
+      registry, IREE_METRIC_TYPE_HISTOGRAM,
+      IREE_SV("iree_hal_queue_submit_to_start_ns"),
+      iree_make_string_view(labels, labels_length),
+      IREE_SV("Time from queue submission until execution begins in "
+              "nanoseconds."),
+      &submit_to_start_metric);
+  if (iree_status_is_ok(status)) {
+    status = iree_metrics_registry_lookup_or_create(
+        registry, IREE_METRIC_TYPE_HISTOGRAM,
+        IREE_SV("iree_hal_queue_start_to_retire_ns"),
+        iree_make_string_view(labels, labels_length),
+        IREE_SV("Time from execution beginning until the submission retires "
+                "in nanoseconds."),
+        &start_to_retire_metric);
+  }
+  if (iree_status_is_ok(status)) {
+    queue->submit_to_start_metric = submit_to_start_metric;
+    queue->start_to_retire_metric = start_to_retire_metric;
+  }
+  iree_status_ignore(status);
+}
+
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* block_pool,
@@ -429,6 +495,8 @@ void iree_hal_task_queue_initialize(iree_string_view_t identifier,
 
   iree_hal_task_queue_state_initialize(&out_queue->state);
 
+  iree_hal_task_queue_initialize_metrics(identifier, out_queue);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -464,6 +532,12 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   // NOTE: if we fail from here on we must drop the retire_cmd arena.
   iree_status_t status = iree_ok_status();
 
+  if (queue->submit_to_start_metric) {
+    retire_cmd->submit_to_start_metric = queue->submit_to_start_metric;
+    retire_cmd->start_to_retire_metric = queue->start_to_retire_metric;
+    retire_cmd->submit_time_ns = iree_time_now();
+  }
+
   // A fence we'll use to detect when the entire submission has completed.
   // TODO(benvanik): fold into the retire command.
   iree_task_fence_t* fence = NULL;
@@ -487,6 +561,7 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   if (iree_status_is_ok(status) && batch->command_buffer_count > 0) {
     status = iree_hal_task_queue_issue_cmd_allocate(
         &queue->scope, queue, &retire_cmd->task.header,
+        retire_cmd->submit_to_start_metric ? &retire_cmd->start_time_ns : NULL,
         batch->command_buffer_count, batch->command_buffers, &retire_cmd->arena,
         &issue_cmd);
   }
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/local_task/task_queue_state.h"
@@ -37,6 +38,14 @@ typedef struct iree_hal_task_queue_t {
   // The intra-queue synchronization (barriers/events) carries across command
   // buffers and this is used to rendezvous the tasks in each set.
   iree_hal_task_queue_state_t state;
+
+  // Submission latency histograms recorded into the default metrics registry
+  // if one was installed when the queue was initialized; NULL otherwise.
+  // submit_to_start measures from submission until command buffers begin
+  // issuing (including semaphore waits) and start_to_retire from then until
+  // the submission retires.
+  iree_metric_t* submit_to_start_metric;
+  iree_metric_t* start_to_retire_metric;
 } iree_hal_task_queue_t;
 
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
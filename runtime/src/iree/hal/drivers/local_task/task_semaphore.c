@@ -11,6 +11,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
 #include "iree/hal/utils/semaphore_base.h"
@@ -42,6 +43,60 @@ static iree_status_t iree_hal_task_semaphore_timepoint_callback(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_task_host_waiter_t
+//===----------------------------------------------------------------------===//
+
+// State shared by all timepoints of a host wait on one or more semaphores.
+// Host waits block on a futex-backed notification (where available) instead of
+// acquiring an OS event per timepoint. This avoids consuming file descriptors
+// and only wakes the waiting thread when one of its own timepoints is issued.
+typedef struct iree_hal_task_host_waiter_t {
+  iree_notification_t notification;
+  // Number of timepoints that have not yet been issued.
+  iree_atomic_int32_t pending_count;
+} iree_hal_task_host_waiter_t;
+
+// A timepoint that notifies a host waiter when issued.
+typedef struct iree_hal_task_host_timepoint_t {
+  iree_hal_semaphore_timepoint_t base;
+  iree_hal_semaphore_t* semaphore;
+  iree_hal_task_host_waiter_t* waiter;
+} iree_hal_task_host_timepoint_t;
+
+// Handles timepoint callbacks when either the timepoint is reached or it fails.
+// As with event-based timepoints the waiter deals with the fallout.
+//
+// NOTE: timepoint callbacks are issued under the semaphore timepoint lock and
+// the waiter cancels its timepoints (taking the lock) before tearing down the
+// notification so it remains valid for the duration of the post.
+static iree_status_t iree_hal_task_semaphore_host_timepoint_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_task_host_timepoint_t* timepoint =
+      (iree_hal_task_host_timepoint_t*)user_data;
+  iree_hal_task_host_waiter_t* waiter = timepoint->waiter;
+  iree_atomic_fetch_sub_int32(&waiter->pending_count, 1,
+                              iree_memory_order_acq_rel);
+  iree_notification_post(&waiter->notification, IREE_ALL_WAITERS);
+  return iree_ok_status();
+}
+
+// Returns true when any timepoint of the waiter has been issued.
+typedef struct iree_hal_task_host_waiter_condition_t {
+  iree_hal_task_host_waiter_t* waiter;
+  // Pending count at which the wait is satisfied.
+  int32_t satisfied_count;
+} iree_hal_task_host_waiter_condition_t;
+
+static bool iree_hal_task_host_waiter_is_satisfied(void* arg) {
+  const iree_hal_task_host_waiter_condition_t* condition =
+      (const iree_hal_task_host_waiter_condition_t*)arg;
+  return iree_atomic_load_int32(&condition->waiter->pending_count,
+                                iree_memory_order_acquire) <=
+         condition->satisfied_count;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_semaphore_t
 //===----------------------------------------------------------------------===//
@@ -51,17 +106,17 @@ typedef struct iree_hal_task_semaphore_t {
   iree_allocator_t host_allocator;
   iree_event_pool_t* event_pool;
 
-  // Guards all mutable fields. We expect low contention on semaphores and since
-  // iree_slim_mutex_t is (effectively) just a CAS this keeps things simpler
-  // than trying to make the entire structure lock-free.
+  // Guards |failure_status|. Queries and signals are lock-free and only the
+  // exceptional failure path takes the lock.
   iree_slim_mutex_t mutex;
 
   // Current signaled value. May be IREE_HAL_SEMAPHORE_FAILURE_VALUE to
   // indicate that the semaphore has been signaled for failure and
-  // |failure_status| contains the error.
-  uint64_t current_value;
+  // |failure_status| contains the error. Only ever increases.
+  iree_atomic_int64_t current_value;
 
   // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
+  // Set before |current_value| is changed to the failure value.
   iree_status_t failure_status;
 } iree_hal_task_semaphore_t;
 
@@ -91,7 +146,8 @@ iree_status_t iree_hal_task_semaphore_create(
     semaphore->event_pool = event_pool;
 
     iree_slim_mutex_initialize(&semaphore->mutex);
-    semaphore->current_value = initial_value;
+    iree_atomic_store_int64(&semaphore->current_value, (int64_t)initial_value,
+                            iree_memory_order_relaxed);
     semaphore->failure_status = iree_ok_status();
 
     *out_semaphore = &semaphore->base;
@@ -122,23 +178,53 @@ bool iree_hal_task_semaphore_isa(iree_hal_semaphore_t* semaphore) {
                               &iree_hal_task_semaphore_vtable);
 }
 
-static iree_status_t iree_hal_task_semaphore_query(
-    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
-  iree_hal_task_semaphore_t* semaphore =
-      iree_hal_task_semaphore_cast(base_semaphore);
+// Returns the current value of |semaphore|. Values at or above
+// IREE_HAL_SEMAPHORE_FAILURE_VALUE indicate the semaphore has failed.
+static inline uint64_t iree_hal_task_semaphore_load_value(
+    iree_hal_task_semaphore_t* semaphore) {
+  return (uint64_t)iree_atomic_load_int64(&semaphore->current_value,
+                                          iree_memory_order_seq_cst);
+}
 
+// Returns a clone of the failure status of |semaphore|.
+static iree_status_t iree_hal_task_semaphore_clone_failure_status(
+    iree_hal_task_semaphore_t* semaphore) {
   iree_slim_mutex_lock(&semaphore->mutex);
+  iree_status_t status = iree_status_clone(semaphore->failure_status);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return status;
+}
 
-  *out_value = semaphore->current_value;
-
-  iree_status_t status = iree_ok_status();
-  if (*out_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
-    status = iree_status_clone(semaphore->failure_status);
+// Issues timepoints that a signal or failure racing with their registration
+// may have missed. Must be called after acquiring a timepoint for
+// |minimum_value|.
+//
+// Signals don't synchronize with waiters and only check for timepoints after
+// publishing the new value. Both sides use sequentially consistent operations
+// so either the signal observes the new timepoint or the waiter observes the
+// new value here and issues the timepoint itself.
+static void iree_hal_task_semaphore_recheck_timepoints(
+    iree_hal_task_semaphore_t* semaphore, uint64_t minimum_value) {
+  const uint64_t current_value = iree_hal_task_semaphore_load_value(semaphore);
+  if (current_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
+    iree_status_t status =
+        iree_hal_task_semaphore_clone_failure_status(semaphore);
+    iree_hal_semaphore_notify(&semaphore->base, current_value,
+                              iree_status_consume_code(status));
+  } else if (current_value >= minimum_value) {
+    iree_hal_semaphore_notify(&semaphore->base, current_value, IREE_STATUS_OK);
   }
+}
 
-  iree_slim_mutex_unlock(&semaphore->mutex);
-
-  return status;
+static iree_status_t iree_hal_task_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  iree_hal_task_semaphore_t* semaphore =
+      iree_hal_task_semaphore_cast(base_semaphore);
+  *out_value = iree_hal_task_semaphore_load_value(semaphore);
+  if (IREE_UNLIKELY(*out_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE)) {
+    return iree_hal_task_semaphore_clone_failure_status(semaphore);
+  }
+  return iree_ok_status();
 }
 
 static iree_status_t iree_hal_task_semaphore_signal(
@@ -146,23 +232,22 @@ static iree_status_t iree_hal_task_semaphore_signal(
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
-  iree_slim_mutex_lock(&semaphore->mutex);
-
-  if (new_value <= semaphore->current_value) {
-    uint64_t current_value IREE_ATTRIBUTE_UNUSED = semaphore->current_value;
-    iree_slim_mutex_unlock(&semaphore->mutex);
-    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
-                            "semaphore values must be monotonically "
-                            "increasing; current_value=%" PRIu64
-                            ", new_value=%" PRIu64,
-                            current_value, new_value);
-  }
-
-  semaphore->current_value = new_value;
-
-  iree_slim_mutex_unlock(&semaphore->mutex);
+  // Failed semaphores hold the failure value and reject all signals here.
+  int64_t current_value = iree_atomic_load_int64(&semaphore->current_value,
+                                                 iree_memory_order_relaxed);
+  do {
+    if (new_value <= (uint64_t)current_value) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "semaphore values must be monotonically "
+                              "increasing; current_value=%" PRIu64
+                              ", new_value=%" PRIu64,
+                              (uint64_t)current_value, new_value);
+    }
+  } while (!iree_atomic_compare_exchange_weak_int64(
+      &semaphore->current_value, &current_value, (int64_t)new_value,
+      iree_memory_order_seq_cst, iree_memory_order_relaxed));
 
-  // Notify timepoints - note that this must happen outside the lock.
+  // Notify timepoints. This is lock-free unless a timepoint has been reached.
   iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
 
   return iree_ok_status();
@@ -185,9 +270,12 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
     return;
   }
 
-  // Signal to our failure sentinel value.
-  semaphore->current_value = IREE_HAL_SEMAPHORE_FAILURE_VALUE;
+  // Signal to our failure sentinel value. The status is set first such that
+  // any thread observing the failure value can clone it.
   semaphore->failure_status = status;
+  iree_atomic_store_int64(&semaphore->current_value,
+                          (int64_t)IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+                          iree_memory_order_seq_cst);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
 
@@ -215,6 +303,24 @@ static iree_status_t iree_hal_task_semaphore_acquire_timepoint(
   return iree_ok_status();
 }
 
+// Acquires a timepoint waiting for the given value that notifies |waiter|.
+// |out_timepoint| is owned by the caller and must be kept live until the
+// timepoint has been reached (or it is cancelled by the caller).
+static void iree_hal_task_semaphore_acquire_host_timepoint(
+    iree_hal_task_semaphore_t* semaphore, uint64_t minimum_value,
+    iree_timeout_t timeout, iree_hal_task_host_waiter_t* waiter,
+    iree_hal_task_host_timepoint_t* out_timepoint) {
+  out_timepoint->semaphore = &semaphore->base;
+  out_timepoint->waiter = waiter;
+  iree_hal_semaphore_acquire_timepoint(
+      &semaphore->base, minimum_value, timeout,
+      (iree_hal_semaphore_callback_t){
+          .fn = iree_hal_task_semaphore_host_timepoint_callback,
+          .user_data = out_timepoint,
+      },
+      &out_timepoint->base);
+}
+
 typedef struct iree_hal_task_semaphore_wait_cmd_t {
   iree_task_wait_t task;
   iree_hal_task_semaphore_t* semaphore;
@@ -244,14 +350,13 @@ iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
-  iree_slim_mutex_lock(&semaphore->mutex);
-
   iree_status_t status = iree_ok_status();
-  if (semaphore->current_value >= minimum_value) {
+  const uint64_t current_value = iree_hal_task_semaphore_load_value(semaphore);
+  if (current_value >= minimum_value) {
     // Fast path: already satisfied.
-  } else if (!iree_status_is_ok(semaphore->failure_status)) {
+  } else if (current_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
     // Semaphore failed; can't enqueue timepoints (they'll reject immediately).
-    status = iree_status_clone(semaphore->failure_status);
+    status = iree_hal_task_semaphore_clone_failure_status(semaphore);
   } else {
     // Slow path: acquire a system wait handle and perform a full wait.
     iree_hal_task_semaphore_wait_cmd_t* cmd = NULL;
@@ -270,10 +375,10 @@ iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
       cmd->semaphore = semaphore;
       iree_hal_semaphore_retain(base_semaphore);
       iree_task_submission_enqueue(submission, &cmd->task.header);
+      iree_hal_task_semaphore_recheck_timepoints(semaphore, minimum_value);
     }
   }
 
-  iree_slim_mutex_unlock(&semaphore->mutex);
   return status;
 }
 
@@ -283,40 +388,42 @@ static iree_status_t iree_hal_task_semaphore_wait(
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
-  iree_slim_mutex_lock(&semaphore->mutex);
-
-  if (!iree_status_is_ok(semaphore->failure_status)) {
+  const uint64_t current_value = iree_hal_task_semaphore_load_value(semaphore);
+  if (current_value >= IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
     // Fastest path: failed; return an error to tell callers to query for it.
-    iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_ABORTED);
-  } else if (semaphore->current_value >= value) {
+  } else if (current_value >= value) {
     // Fast path: already satisfied.
-    iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_ok_status();
   } else if (iree_timeout_is_immediate(timeout)) {
     // Not satisfied but a poll, so can avoid the expensive wait handle work.
-    iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
-  // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status = iree_hal_task_semaphore_acquire_timepoint(
-      semaphore, value, timeout, &timepoint);
-
-  iree_slim_mutex_unlock(&semaphore->mutex);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
+  // Slow path: acquire a timepoint and wait for it to be issued.
+  iree_hal_task_host_waiter_t waiter;
+  iree_notification_initialize(&waiter.notification);
+  iree_atomic_store_int32(&waiter.pending_count, 1, iree_memory_order_relaxed);
+  iree_hal_task_host_timepoint_t timepoint;
+  iree_hal_task_semaphore_acquire_host_timepoint(semaphore, value, timeout,
+                                                 &waiter, &timepoint);
+  iree_hal_task_semaphore_recheck_timepoints(semaphore, value);
 
   // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  // Cancelling is a no-op if the timepoint was issued but ensures the callback
+  // has completed before the waiter goes out of scope.
+  iree_hal_task_host_waiter_condition_t condition = {
+      .waiter = &waiter,
+      .satisfied_count = 0,
+  };
+  iree_status_t status = iree_ok_status();
+  if (!iree_notification_await(&waiter.notification,
+                               iree_hal_task_host_waiter_is_satisfied,
+                               &condition, timeout)) {
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
+  iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  iree_notification_deinitialize(&waiter.notification);
 
   return status;
 }
@@ -324,7 +431,7 @@ static iree_status_t iree_hal_task_semaphore_wait(
 iree_status_t iree_hal_task_semaphore_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
-    iree_event_pool_t* event_pool, iree_arena_block_pool_t* block_pool) {
+    iree_arena_block_pool_t* block_pool) {
   if (semaphore_list.count == 0) {
     return iree_ok_status();
   } else if (semaphore_list.count == 1) {
@@ -335,66 +442,73 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
-  // Avoid heap allocations by using the device block pool for the wait set.
+  // Avoid heap allocations by using the device block pool for the timepoints.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
-  iree_wait_set_t* wait_set = NULL;
-  iree_status_t status = iree_wait_set_allocate(
-      semaphore_list.count, iree_arena_allocator(&arena), &wait_set);
-
-  // Acquire a wait handle for each semaphore timepoint we are to wait on.
-  // TODO(benvanik): flip this API around so we can batch request events from
-  // the event pool. We should be acquiring all required time points in one
-  // call.
-  iree_host_size_t timepoint_count = 0;
-  iree_hal_task_timepoint_t* timepoints = NULL;
+  iree_hal_task_host_timepoint_t* timepoints = NULL;
   iree_host_size_t total_timepoint_size =
       semaphore_list.count * sizeof(timepoints[0]);
-  status =
+  iree_status_t status =
       iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
-  if (iree_status_is_ok(status)) {
-    memset(timepoints, 0, total_timepoint_size);
-    for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
-      iree_hal_task_semaphore_t* semaphore =
-          iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
-      iree_slim_mutex_lock(&semaphore->mutex);
-      if (semaphore->current_value >= semaphore_list.payload_values[i]) {
-        // Fast path: already satisfied.
-      } else {
-        // Slow path: get a native wait handle for the timepoint.
-        iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
-        status = iree_hal_task_semaphore_acquire_timepoint(
-            semaphore, semaphore_list.payload_values[i], timeout, timepoint);
-        if (iree_status_is_ok(status)) {
-          status = iree_wait_set_insert(wait_set, timepoint->event);
-        }
-      }
-      iree_slim_mutex_unlock(&semaphore->mutex);
-      if (!iree_status_is_ok(status)) break;
+  if (!iree_status_is_ok(status)) {
+    iree_arena_deinitialize(&arena);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  memset(timepoints, 0, total_timepoint_size);
+
+  // All timepoints notify the same waiter so that the calling thread only
+  // blocks on a single futex regardless of the number of semaphores.
+  iree_hal_task_host_waiter_t waiter;
+  iree_notification_initialize(&waiter.notification);
+  iree_atomic_store_int32(&waiter.pending_count, 0, iree_memory_order_relaxed);
+
+  // Acquire a timepoint for each semaphore that has not yet been reached.
+  bool any_satisfied = false;
+  iree_host_size_t timepoint_count = 0;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    iree_hal_task_semaphore_t* semaphore =
+        iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
+    if (iree_hal_task_semaphore_load_value(semaphore) >=
+        semaphore_list.payload_values[i]) {
+      // Fast path: already satisfied.
+      any_satisfied = true;
+    } else {
+      // Slow path: acquire a timepoint that notifies the waiter.
+      iree_atomic_fetch_add_int32(&waiter.pending_count, 1,
+                                  iree_memory_order_relaxed);
+      iree_hal_task_semaphore_acquire_host_timepoint(
+          semaphore, semaphore_list.payload_values[i], timeout, &waiter,
+          &timepoints[timepoint_count++]);
+      iree_hal_task_semaphore_recheck_timepoints(
+          semaphore, semaphore_list.payload_values[i]);
     }
+    if (any_satisfied && wait_mode == IREE_HAL_WAIT_MODE_ANY) break;
   }
 
   // Perform the wait.
-  if (iree_status_is_ok(status)) {
-    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
-    } else {
-      status = iree_wait_all(wait_set, deadline_ns);
+  if (timepoint_count > 0 &&
+      !(any_satisfied && wait_mode == IREE_HAL_WAIT_MODE_ANY)) {
+    iree_hal_task_host_waiter_condition_t condition = {
+        .waiter = &waiter,
+        .satisfied_count = wait_mode == IREE_HAL_WAIT_MODE_ANY
+                               ? (int32_t)timepoint_count - 1
+                               : 0,
+    };
+    if (!iree_notification_await(&waiter.notification,
+                                 iree_hal_task_host_waiter_is_satisfied,
+                                 &condition, timeout)) {
+      status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
     }
   }
 
-  // TODO(benvanik): if we flip the API to multi-acquire events from the pool
-  // above then we can multi-release here too.
+  // Cancel any timepoints that were not issued. This also ensures no callbacks
+  // are still in-flight using the waiter.
   for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
-    iree_hal_semaphore_t* semaphore = timepoints[i].semaphore;
-    if (semaphore) {
-      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i].base);
-      iree_event_pool_release(event_pool, 1, &timepoints[i].event);
-    }
+    iree_hal_semaphore_cancel_timepoint(timepoints[i].semaphore,
+                                        &timepoints[i].base);
   }
-  iree_wait_set_free(wait_set);
+  iree_notification_deinitialize(&waiter.notification);
   iree_arena_deinitialize(&arena);
 
   IREE_TRACE_ZONE_END(z0);
@@ -0,0 +1,459 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+
+// Number of hash buckets; must be a power of two.
+#define IREE_HAL_LOCAL_DISPATCH_CACHE_BUCKET_COUNT 256
+
+//===----------------------------------------------------------------------===//
+// Hashing
+//===----------------------------------------------------------------------===//
+
+#define IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_SEED 0xCBF29CE484222325ull
+#define IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_PRIME 0x100000001B3ull
+
+// Final avalanche so that low bits are usable for bucketing.
+static inline uint64_t iree_hal_local_dispatch_cache_hash_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+// FNV-1a style hash consuming 64-bit words at a time.
+// Not cryptographically strong: only intended to detect identical inputs.
+static uint64_t iree_hal_local_dispatch_cache_hash_bytes(
+    uint64_t hash, const void* data, iree_host_size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  iree_host_size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_PRIME;
+  }
+  for (; i < length; ++i) {
+    hash = (hash ^ bytes[i]) * IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_PRIME;
+  }
+  return iree_hal_local_dispatch_cache_hash_mix(hash ^ length);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_cache_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_dispatch_cache_entry_t {
+  // Next entry in the same hash bucket.
+  struct iree_hal_local_dispatch_cache_entry_t* bucket_next;
+  // Doubly-linked LRU list with the most recently used entry at the head.
+  struct iree_hal_local_dispatch_cache_entry_t* lru_prev;
+  struct iree_hal_local_dispatch_cache_entry_t* lru_next;
+  // Total output bytes stored in |data|.
+  iree_host_size_t data_length;
+  // Key with |key.executable| retained for the lifetime of the entry.
+  iree_hal_local_dispatch_cache_key_t key;
+  // Output binding contents concatenated in packed binding order.
+  uint8_t data[];
+} iree_hal_local_dispatch_cache_entry_t;
+
+struct iree_hal_local_dispatch_cache_t {
+  iree_allocator_t host_allocator;
+  iree_hal_local_dispatch_cache_params_t params;
+
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+
+  iree_hal_local_dispatch_cache_entry_t* lru_head;
+  iree_hal_local_dispatch_cache_entry_t* lru_tail;
+  iree_hal_local_dispatch_cache_statistics_t statistics;
+  iree_hal_local_dispatch_cache_entry_t*
+      buckets[IREE_HAL_LOCAL_DISPATCH_CACHE_BUCKET_COUNT];
+};
+
+void iree_hal_local_dispatch_cache_params_initialize(
+    iree_hal_local_dispatch_cache_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->capacity = 64 * 1024 * 1024;
+  out_params->max_hashed_bytes = 16 * 1024 * 1024;
+}
+
+iree_status_t iree_hal_local_dispatch_cache_create(
+    const iree_hal_local_dispatch_cache_params_t* params,
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_dispatch_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*cache),
+                                (void**)&cache));
+  memset(cache, 0, sizeof(*cache));
+  cache->host_allocator = host_allocator;
+  cache->params = *params;
+  iree_slim_mutex_initialize(&cache->mutex);
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_dispatch_cache_entry_free(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_entry_t* entry) {
+  iree_hal_executable_release(entry->key.executable);
+  iree_allocator_free(cache->host_allocator, entry);
+}
+
+void iree_hal_local_dispatch_cache_free(
+    iree_hal_local_dispatch_cache_t* cache) {
+  if (!cache) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_local_dispatch_cache_entry_t* entry = cache->lru_head;
+  while (entry) {
+    iree_hal_local_dispatch_cache_entry_t* next_entry = entry->lru_next;
+    iree_hal_local_dispatch_cache_entry_free(cache, entry);
+    entry = next_entry;
+  }
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(cache->host_allocator, cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static bool iree_hal_local_dispatch_cache_key_equal(
+    const iree_hal_local_dispatch_cache_key_t* lhs,
+    const iree_hal_local_dispatch_cache_key_t* rhs) {
+  if (lhs->hash != rhs->hash || lhs->executable != rhs->executable ||
+      lhs->ordinal != rhs->ordinal ||
+      memcmp(lhs->workgroup_count, rhs->workgroup_count,
+             sizeof(lhs->workgroup_count)) != 0 ||
+      lhs->push_constant_count != rhs->push_constant_count ||
+      lhs->binding_count != rhs->binding_count ||
+      lhs->read_only_mask != rhs->read_only_mask ||
+      lhs->write_only_mask != rhs->write_only_mask) {
+    return false;
+  }
+  return memcmp(lhs->push_constants, rhs->push_constants,
+                lhs->push_constant_count * sizeof(lhs->push_constants[0])) ==
+             0 &&
+         memcmp(lhs->binding_lengths, rhs->binding_lengths,
+                lhs->binding_count * sizeof(lhs->binding_lengths[0])) == 0 &&
+         memcmp(lhs->binding_hashes, rhs->binding_hashes,
+                lhs->binding_count * sizeof(lhs->binding_hashes[0])) == 0;
+}
+
+// Returns the total bytes of output bindings described by |key|.
+static iree_host_size_t iree_hal_local_dispatch_cache_key_output_length(
+    const iree_hal_local_dispatch_cache_key_t* key) {
+  iree_host_size_t length = 0;
+  for (uint16_t i = 0; i < key->binding_count; ++i) {
+    if (!(key->read_only_mask & (1ull << i))) {
+      length += key->binding_lengths[i];
+    }
+  }
+  return length;
+}
+
+bool iree_hal_local_dispatch_cache_make_key(
+    iree_hal_local_dispatch_cache_t* cache, iree_hal_executable_t* executable,
+    uint32_t ordinal, iree_hal_local_binding_mask_t read_only_mask,
+    iree_hal_local_binding_mask_t write_only_mask,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_local_dispatch_cache_key_t* out_key) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(executable);
+  IREE_ASSERT_ARGUMENT(dispatch_state);
+  IREE_ASSERT_ARGUMENT(out_key);
+
+  // A binding can't be both read-only and write-only; read-only wins.
+  write_only_mask &= ~read_only_mask;
+
+  // Verify the dispatch is eligible: it must have at least one output and we
+  // must be willing to hash all of its inputs. Outputs that are not known to
+  // be write-only may be read by the dispatch and count as inputs.
+  bool eligible =
+      dispatch_state->binding_count <=
+          IREE_HAL_LOCAL_DISPATCH_CACHE_MAX_BINDING_COUNT &&
+      dispatch_state->push_constant_count <=
+          IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT;
+  iree_host_size_t hashed_bytes = 0;
+  iree_host_size_t output_bytes = 0;
+  for (uint16_t i = 0; eligible && i < dispatch_state->binding_count; ++i) {
+    if (!(read_only_mask & (1ull << i))) {
+      output_bytes += dispatch_state->binding_lengths[i];
+    }
+    if (!(write_only_mask & (1ull << i))) {
+      hashed_bytes += dispatch_state->binding_lengths[i];
+    }
+  }
+  eligible = eligible && output_bytes > 0 &&
+             output_bytes <= cache->params.capacity &&
+             hashed_bytes <= cache->params.max_hashed_bytes;
+  if (!eligible) {
+    iree_slim_mutex_lock(&cache->mutex);
+    ++cache->statistics.bypass_count;
+    iree_slim_mutex_unlock(&cache->mutex);
+    return false;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, hashed_bytes);
+
+  out_key->executable = executable;
+  out_key->ordinal = ordinal;
+  out_key->workgroup_count[0] = dispatch_state->workgroup_count_x;
+  out_key->workgroup_count[1] = dispatch_state->workgroup_count_y;
+  out_key->workgroup_count[2] = dispatch_state->workgroup_count_z;
+  out_key->push_constant_count = dispatch_state->push_constant_count;
+  out_key->binding_count = dispatch_state->binding_count;
+  out_key->read_only_mask = read_only_mask;
+  out_key->write_only_mask = write_only_mask;
+  memcpy(out_key->push_constants, dispatch_state->push_constants,
+         out_key->push_constant_count * sizeof(out_key->push_constants[0]));
+
+  // NOTE: fields are hashed individually as the key struct has padding.
+  const uint64_t header[] = {
+      (uint64_t)(uintptr_t)out_key->executable,
+      out_key->ordinal,
+      out_key->workgroup_count[0],
+      out_key->workgroup_count[1],
+      out_key->workgroup_count[2],
+      ((uint64_t)out_key->push_constant_count << 16) | out_key->binding_count,
+      out_key->read_only_mask,
+      out_key->write_only_mask,
+  };
+  uint64_t hash = iree_hal_local_dispatch_cache_hash_bytes(
+      IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_SEED, header, sizeof(header));
+  hash = iree_hal_local_dispatch_cache_hash_bytes(
+      hash, out_key->push_constants,
+      out_key->push_constant_count * sizeof(out_key->push_constants[0]));
+  for (uint16_t i = 0; i < out_key->binding_count; ++i) {
+    out_key->binding_lengths[i] = dispatch_state->binding_lengths[i];
+    out_key->binding_hashes[i] =
+        (write_only_mask & (1ull << i))
+            ? 0
+            : iree_hal_local_dispatch_cache_hash_bytes(
+                  IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_SEED,
+                  dispatch_state->binding_ptrs[i],
+                  dispatch_state->binding_lengths[i]);
+    hash = (hash ^ out_key->binding_hashes[i] ^ out_key->binding_lengths[i]) *
+           IREE_HAL_LOCAL_DISPATCH_CACHE_HASH_PRIME;
+  }
+  out_key->hash = iree_hal_local_dispatch_cache_hash_mix(hash);
+
+  IREE_TRACE_ZONE_END(z0);
+  return true;
+}
+
+// Unlinks |entry| from the LRU list.
+// Must be called with the cache mutex held.
+static void iree_hal_local_dispatch_cache_lru_unlink(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_entry_t* entry) {
+  if (entry->lru_prev) {
+    entry->lru_prev->lru_next = entry->lru_next;
+  } else {
+    cache->lru_head = entry->lru_next;
+  }
+  if (entry->lru_next) {
+    entry->lru_next->lru_prev = entry->lru_prev;
+  } else {
+    cache->lru_tail = entry->lru_prev;
+  }
+  entry->lru_prev = entry->lru_next = NULL;
+}
+
+// Links |entry| at the head of the LRU list.
+// Must be called with the cache mutex held.
+static void iree_hal_local_dispatch_cache_lru_push_front(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_entry_t* entry) {
+  entry->lru_prev = NULL;
+  entry->lru_next = cache->lru_head;
+  if (cache->lru_head) cache->lru_head->lru_prev = entry;
+  cache->lru_head = entry;
+  if (!cache->lru_tail) cache->lru_tail = entry;
+}
+
+// Finds the entry matching |key|, if any.
+// Must be called with the cache mutex held.
+static iree_hal_local_dispatch_cache_entry_t*
+iree_hal_local_dispatch_cache_find(
+    iree_hal_local_dispatch_cache_t* cache,
+    const iree_hal_local_dispatch_cache_key_t* key) {
+  iree_hal_local_dispatch_cache_entry_t* entry =
+      cache->buckets[key->hash &
+                     (IREE_HAL_LOCAL_DISPATCH_CACHE_BUCKET_COUNT - 1)];
+  while (entry && !iree_hal_local_dispatch_cache_key_equal(&entry->key, key)) {
+    entry = entry->bucket_next;
+  }
+  return entry;
+}
+
+// Removes |entry| from its bucket and the LRU list and returns it to the
+// caller for freeing outside of the lock.
+// Must be called with the cache mutex held.
+static void iree_hal_local_dispatch_cache_remove(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_entry_t* entry) {
+  iree_hal_local_dispatch_cache_entry_t** link =
+      &cache->buckets[entry->key.hash &
+                      (IREE_HAL_LOCAL_DISPATCH_CACHE_BUCKET_COUNT - 1)];
+  while (*link != entry) link = &(*link)->bucket_next;
+  *link = entry->bucket_next;
+  entry->bucket_next = NULL;
+  iree_hal_local_dispatch_cache_lru_unlink(cache, entry);
+  --cache->statistics.entry_count;
+  cache->statistics.resident_bytes -= entry->data_length;
+}
+
+bool iree_hal_local_dispatch_cache_lookup(
+    iree_hal_local_dispatch_cache_t* cache,
+    const iree_hal_local_dispatch_cache_key_t* key,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(key);
+  IREE_ASSERT_ARGUMENT(dispatch_state);
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_local_dispatch_cache_entry_t* entry =
+      iree_hal_local_dispatch_cache_find(cache, key);
+  if (entry) {
+    // Copy while holding the lock so the entry can't be evicted underneath us.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_hal_local_dispatch_cache_hit");
+    const uint8_t* data = entry->data;
+    for (uint16_t i = 0; i < key->binding_count; ++i) {
+      if (key->read_only_mask & (1ull << i)) continue;
+      memcpy(dispatch_state->binding_ptrs[i], data,
+             dispatch_state->binding_lengths[i]);
+      data += dispatch_state->binding_lengths[i];
+    }
+    iree_hal_local_dispatch_cache_lru_unlink(cache, entry);
+    iree_hal_local_dispatch_cache_lru_push_front(cache, entry);
+    ++cache->statistics.hit_count;
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  return entry != NULL;
+}
+
+iree_status_t iree_hal_local_dispatch_cache_insert(
+    iree_hal_local_dispatch_cache_t* cache,
+    const iree_hal_local_dispatch_cache_key_t* key,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(key);
+  IREE_ASSERT_ARGUMENT(dispatch_state);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Snapshot the outputs outside of the lock.
+  const iree_host_size_t data_length =
+      iree_hal_local_dispatch_cache_key_output_length(key);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, data_length);
+  iree_hal_local_dispatch_cache_entry_t* entry = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(cache->host_allocator,
+                                sizeof(*entry) + data_length, (void**)&entry));
+  entry->bucket_next = NULL;
+  entry->lru_prev = entry->lru_next = NULL;
+  entry->data_length = data_length;
+  entry->key = *key;
+  iree_hal_executable_retain(entry->key.executable);
+  uint8_t* data = entry->data;
+  for (uint16_t i = 0; i < key->binding_count; ++i) {
+    if (key->read_only_mask & (1ull << i)) continue;
+    memcpy(data, dispatch_state->binding_ptrs[i],
+           dispatch_state->binding_lengths[i]);
+    data += dispatch_state->binding_lengths[i];
+  }
+
+  // Evicted entries are chained through bucket_next and freed outside the lock
+  // as releasing the executable may be expensive.
+  iree_hal_local_dispatch_cache_entry_t* free_list = NULL;
+  iree_slim_mutex_lock(&cache->mutex);
+  ++cache->statistics.miss_count;
+  iree_hal_local_dispatch_cache_entry_t* existing_entry =
+      iree_hal_local_dispatch_cache_find(cache, key);
+  if (existing_entry) {
+    // Raced with another thread inserting the same dispatch; keep theirs.
+    entry->bucket_next = free_list;
+    free_list = entry;
+  } else {
+    while (cache->lru_tail &&
+           cache->statistics.resident_bytes + data_length >
+               cache->params.capacity) {
+      iree_hal_local_dispatch_cache_entry_t* evicted_entry = cache->lru_tail;
+      iree_hal_local_dispatch_cache_remove(cache, evicted_entry);
+      evicted_entry->bucket_next = free_list;
+      free_list = evicted_entry;
+      ++cache->statistics.eviction_count;
+    }
+    iree_hal_local_dispatch_cache_entry_t** bucket =
+        &cache->buckets[key->hash &
+                        (IREE_HAL_LOCAL_DISPATCH_CACHE_BUCKET_COUNT - 1)];
+    entry->bucket_next = *bucket;
+    *bucket = entry;
+    iree_hal_local_dispatch_cache_lru_push_front(cache, entry);
+    ++cache->statistics.entry_count;
+    cache->statistics.resident_bytes += data_length;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  while (free_list) {
+    iree_hal_local_dispatch_cache_entry_t* next_entry = free_list->bucket_next;
+    iree_hal_local_dispatch_cache_entry_free(cache, free_list);
+    free_list = next_entry;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_local_dispatch_cache_query_statistics(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_slim_mutex_lock(&cache->mutex);
+  *out_statistics = cache->statistics;
+  iree_slim_mutex_unlock(&cache->mutex);
+}
+
+iree_status_t iree_hal_local_dispatch_cache_query_i64(
+    iree_hal_local_dispatch_cache_t* cache, iree_string_view_t key,
+    int64_t* out_value) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_value);
+  iree_hal_local_dispatch_cache_statistics_t statistics;
+  iree_hal_local_dispatch_cache_query_statistics(cache, &statistics);
+  if (iree_string_view_equal(key, IREE_SV("hits"))) {
+    *out_value = (int64_t)statistics.hit_count;
+  } else if (iree_string_view_equal(key, IREE_SV("misses"))) {
+    *out_value = (int64_t)statistics.miss_count;
+  } else if (iree_string_view_equal(key, IREE_SV("bypasses"))) {
+    *out_value = (int64_t)statistics.bypass_count;
+  } else if (iree_string_view_equal(key, IREE_SV("evictions"))) {
+    *out_value = (int64_t)statistics.eviction_count;
+  } else if (iree_string_view_equal(key, IREE_SV("entries"))) {
+    *out_value = (int64_t)statistics.entry_count;
+  } else if (iree_string_view_equal(key, IREE_SV("resident_bytes"))) {
+    *out_value = (int64_t)statistics.resident_bytes;
+  } else {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "unknown dispatch cache statistic '%.*s'",
+                            (int)key.size, key.data);
+  }
+  return iree_ok_status();
+}
@@ -0,0 +1,167 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_CACHE_H_
+#define IREE_HAL_LOCAL_DISPATCH_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_pipeline_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_cache_t
+//===----------------------------------------------------------------------===//
+
+// Maximum number of packed bindings a cached dispatch may have.
+#define IREE_HAL_LOCAL_DISPATCH_CACHE_MAX_BINDING_COUNT \
+  (IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *            \
+   IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT)
+
+// Parameters configuring an iree_hal_local_dispatch_cache_t.
+// Must be initialized with iree_hal_local_dispatch_cache_params_initialize
+// prior to use.
+typedef struct iree_hal_local_dispatch_cache_params_t {
+  // Total bytes of dispatch outputs that may be resident in the cache.
+  // Least-recently-used entries are evicted to stay under the capacity and
+  // dispatches producing more than this are never cached.
+  iree_host_size_t capacity;
+
+  // Maximum total bytes of binding contents hashed per dispatch.
+  // Dispatches reading more than this bypass the cache as hashing their inputs
+  // would likely cost more than the dispatch itself.
+  iree_host_size_t max_hashed_bytes;
+} iree_hal_local_dispatch_cache_params_t;
+
+// Initializes |out_params| to default values.
+void iree_hal_local_dispatch_cache_params_initialize(
+    iree_hal_local_dispatch_cache_params_t* out_params);
+
+// Statistics tracked over the lifetime of a dispatch cache.
+typedef struct iree_hal_local_dispatch_cache_statistics_t {
+  // Dispatches whose outputs were produced from the cache.
+  uint64_t hit_count;
+  // Dispatches that were executed and then inserted into the cache.
+  uint64_t miss_count;
+  // Dispatches that were not eligible for caching.
+  uint64_t bypass_count;
+  // Entries dropped to stay under the capacity.
+  uint64_t eviction_count;
+  // Entries currently resident.
+  iree_host_size_t entry_count;
+  // Output bytes currently resident.
+  iree_host_size_t resident_bytes;
+} iree_hal_local_dispatch_cache_statistics_t;
+
+// Lookup key identifying a dispatch and the contents of its inputs.
+// Populated with iree_hal_local_dispatch_cache_make_key and usually stored on
+// the stack between a lookup and an insert.
+typedef struct iree_hal_local_dispatch_cache_key_t {
+  // Hash over all of the fields below used for bucketing.
+  uint64_t hash;
+  iree_hal_executable_t* executable;
+  uint32_t ordinal;
+  uint32_t workgroup_count[3];
+  uint16_t push_constant_count;
+  uint16_t binding_count;
+  // Bit i set if packed binding i is read-only; all other bindings are treated
+  // as outputs and restored on a hit.
+  iree_hal_local_binding_mask_t read_only_mask;
+  // Bit i set if packed binding i is an output known to be fully overwritten
+  // by the dispatch and whose prior contents do not contribute to the key.
+  iree_hal_local_binding_mask_t write_only_mask;
+  uint32_t push_constants[IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT];
+  size_t binding_lengths[IREE_HAL_LOCAL_DISPATCH_CACHE_MAX_BINDING_COUNT];
+  // Content hash of each binding prior to the dispatch (0 for write-only).
+  uint64_t binding_hashes[IREE_HAL_LOCAL_DISPATCH_CACHE_MAX_BINDING_COUNT];
+} iree_hal_local_dispatch_cache_key_t;
+
+// A bounded LRU cache memoizing the outputs of local dispatches.
+//
+// Dispatches are keyed on the executable, export ordinal, workgroup count,
+// push constants, and the lengths and content hashes of their bindings.
+// Bindings not declared read-only in the pipeline layout are outputs: on a hit
+// their contents are restored from the cache instead of running the dispatch.
+// As outputs may be read-modify-write (in-place updates, accumulators, etc)
+// their contents prior to the dispatch are hashed into the key as well unless
+// the caller knows they are write-only and will be fully overwritten.
+//
+// NOTE: pipeline layouts only carry a read-only flag and executables do not
+// declare write-only bindings, so the inline command buffer passes an empty
+// |write_only_mask| today. Outputs then count against max_hashed_bytes and a
+// dispatch only hits when its outputs hold the same contents as when the
+// entry was inserted (such as when a program reuses its output buffers).
+//
+// Content hashes are 64-bit and not cryptographically strong; the cache is an
+// opt-in performance mode for workloads known to repeat identical dispatches.
+//
+// Thread-safe.
+typedef struct iree_hal_local_dispatch_cache_t iree_hal_local_dispatch_cache_t;
+
+// Creates a new dispatch cache configured by |params|.
+// Must be freed with iree_hal_local_dispatch_cache_free and must outlive any
+// command buffers using it.
+iree_status_t iree_hal_local_dispatch_cache_create(
+    const iree_hal_local_dispatch_cache_params_t* params,
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_cache_t** out_cache);
+
+// Frees |cache| and releases all executables retained by its entries.
+void iree_hal_local_dispatch_cache_free(iree_hal_local_dispatch_cache_t* cache);
+
+// Builds the key for a dispatch of |ordinal| in |executable| with the bindings
+// and push constants of |dispatch_state|. |read_only_mask| has bit i set if
+// packed binding i is read-only and |write_only_mask| has bit i set if packed
+// binding i is fully overwritten by the dispatch without being read. Bindings
+// in neither mask are treated as read-write and hashed like inputs.
+//
+// Returns false if the dispatch is not eligible for caching (such as when it
+// has no outputs or its inputs are too large to hash); the bypass is recorded
+// in the cache statistics.
+bool iree_hal_local_dispatch_cache_make_key(
+    iree_hal_local_dispatch_cache_t* cache, iree_hal_executable_t* executable,
+    uint32_t ordinal, iree_hal_local_binding_mask_t read_only_mask,
+    iree_hal_local_binding_mask_t write_only_mask,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_local_dispatch_cache_key_t* out_key);
+
+// Looks up |key| and on a hit copies the cached outputs into the output
+// bindings of |dispatch_state| and returns true. The caller must then skip
+// executing the dispatch.
+bool iree_hal_local_dispatch_cache_lookup(
+    iree_hal_local_dispatch_cache_t* cache,
+    const iree_hal_local_dispatch_cache_key_t* key,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state);
+
+// Inserts the outputs of a completed dispatch identified by |key|.
+// Evicts least-recently-used entries as required to stay under capacity.
+iree_status_t iree_hal_local_dispatch_cache_insert(
+    iree_hal_local_dispatch_cache_t* cache,
+    const iree_hal_local_dispatch_cache_key_t* key,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state);
+
+// Queries the statistics of |cache| at the time the call is made.
+void iree_hal_local_dispatch_cache_query_statistics(
+    iree_hal_local_dispatch_cache_t* cache,
+    iree_hal_local_dispatch_cache_statistics_t* out_statistics);
+
+// Handles a `hal.dispatch_cache` device query for |key| by returning the
+// corresponding statistic of |cache| in |out_value|. Intended to be used by
+// device query_i64 implementations. Keys: `hits`, `misses`, `bypasses`,
+// `evictions`, `entries`, `resident_bytes`.
+iree_status_t iree_hal_local_dispatch_cache_query_i64(
+    iree_hal_local_dispatch_cache_t* cache, iree_string_view_t key,
+    int64_t* out_value);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_CACHE_H_
@@ -0,0 +1,311 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_cache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Executable with no behavior that tracks whether it is still live so that we
+// can verify cache entries retain and release it.
+typedef struct iree_hal_test_executable_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  bool* live;
+} iree_hal_test_executable_t;
+
+static void iree_hal_test_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_test_executable_t* executable =
+      (iree_hal_test_executable_t*)base_executable;
+  *executable->live = false;
+  iree_allocator_free(executable->host_allocator, executable);
+}
+
+static const iree_hal_executable_vtable_t iree_hal_test_executable_vtable = {
+    /*.destroy=*/iree_hal_test_executable_destroy,
+};
+
+static iree_status_t iree_hal_test_executable_create(
+    bool* live, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
+  iree_hal_test_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*executable), (void**)&executable));
+  iree_hal_resource_initialize(&iree_hal_test_executable_vtable,
+                               &executable->resource);
+  executable->host_allocator = host_allocator;
+  executable->live = live;
+  *live = true;
+  *out_executable = (iree_hal_executable_t*)executable;
+  return iree_ok_status();
+}
+
+// A dispatch with bindings backed by host vectors.
+struct TestDispatch {
+  std::vector<std::vector<uint32_t>> bindings;
+  std::vector<void*> binding_ptrs;
+  std::vector<size_t> binding_lengths;
+  std::vector<uint32_t> push_constants;
+  iree_hal_executable_dispatch_state_v0_t state;
+
+  explicit TestDispatch(std::vector<std::vector<uint32_t>> contents)
+      : bindings(std::move(contents)) {
+    for (auto& binding : bindings) {
+      binding_ptrs.push_back(binding.data());
+      binding_lengths.push_back(binding.size() * sizeof(uint32_t));
+    }
+    memset(&state, 0, sizeof(state));
+    state.workgroup_count_x = 1;
+    state.workgroup_count_y = 1;
+    state.workgroup_count_z = 1;
+    state.binding_count = (uint8_t)bindings.size();
+    state.binding_ptrs = binding_ptrs.data();
+    state.binding_lengths = binding_lengths.data();
+  }
+
+  void SetPushConstants(std::vector<uint32_t> values) {
+    push_constants = std::move(values);
+    state.push_constant_count = (uint16_t)push_constants.size();
+    state.push_constants = push_constants.data();
+  }
+};
+
+class DispatchCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_hal_local_dispatch_cache_params_initialize(&params_);
+    IREE_ASSERT_OK(iree_hal_test_executable_create(
+        &executable_live_, iree_allocator_system(), &executable_));
+  }
+
+  void TearDown() override {
+    iree_hal_local_dispatch_cache_free(cache_);
+    iree_hal_executable_release(executable_);
+    EXPECT_FALSE(executable_live_);
+  }
+
+  void CreateCache() {
+    IREE_ASSERT_OK(iree_hal_local_dispatch_cache_create(
+        &params_, iree_allocator_system(), &cache_));
+  }
+
+  iree_hal_local_dispatch_cache_statistics_t QueryStatistics() {
+    iree_hal_local_dispatch_cache_statistics_t statistics;
+    iree_hal_local_dispatch_cache_query_statistics(cache_, &statistics);
+    return statistics;
+  }
+
+  // Runs |dispatch| through the cache as the inline command buffer does: on a
+  // miss |execute| is applied to the bindings and the outputs are inserted.
+  // Returns true if the dispatch was a cache hit.
+  template <typename Fn>
+  bool RunDispatch(TestDispatch& dispatch,
+                   iree_hal_local_binding_mask_t read_only_mask,
+                   iree_hal_local_binding_mask_t write_only_mask, Fn execute) {
+    iree_hal_local_dispatch_cache_key_t key;
+    bool cacheable = iree_hal_local_dispatch_cache_make_key(
+        cache_, executable_, /*ordinal=*/0, read_only_mask, write_only_mask,
+        &dispatch.state, &key);
+    if (cacheable &&
+        iree_hal_local_dispatch_cache_lookup(cache_, &key, &dispatch.state)) {
+      return true;
+    }
+    execute(dispatch);
+    if (cacheable) {
+      IREE_EXPECT_OK(
+          iree_hal_local_dispatch_cache_insert(cache_, &key, &dispatch.state));
+    }
+    return false;
+  }
+
+  iree_hal_local_dispatch_cache_params_t params_;
+  iree_hal_local_dispatch_cache_t* cache_ = NULL;
+  iree_hal_executable_t* executable_ = NULL;
+  bool executable_live_ = false;
+};
+
+// out = lhs + rhs over bindings [lhs, rhs, out].
+static void AddDispatch(TestDispatch& dispatch) {
+  for (size_t i = 0; i < dispatch.bindings[2].size(); ++i) {
+    dispatch.bindings[2][i] = dispatch.bindings[0][i] + dispatch.bindings[1][i];
+  }
+}
+
+// acc += value over bindings [value, acc].
+static void AccumulateDispatch(TestDispatch& dispatch) {
+  for (size_t i = 0; i < dispatch.bindings[1].size(); ++i) {
+    dispatch.bindings[1][i] += dispatch.bindings[0][i];
+  }
+}
+
+TEST_F(DispatchCacheTest, HitRestoresOutputs) {
+  CreateCache();
+  TestDispatch first({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(first, 0b011, 0b100, AddDispatch));
+  EXPECT_EQ(first.bindings[2], (std::vector<uint32_t>{11, 22, 33}));
+
+  TestDispatch second({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_TRUE(RunDispatch(second, 0b011, 0b100, [](TestDispatch&) {
+    FAIL() << "dispatch should have been served from the cache";
+  }));
+  EXPECT_EQ(second.bindings[2], (std::vector<uint32_t>{11, 22, 33}));
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(1u, statistics.hit_count);
+  EXPECT_EQ(1u, statistics.miss_count);
+  EXPECT_EQ(0u, statistics.bypass_count);
+  EXPECT_EQ(1u, statistics.entry_count);
+  EXPECT_EQ(3 * sizeof(uint32_t), statistics.resident_bytes);
+}
+
+TEST_F(DispatchCacheTest, ChangedInputMisses) {
+  CreateCache();
+  TestDispatch first({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(first, 0b011, 0b100, AddDispatch));
+  TestDispatch second({{1, 2, 4}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(second, 0b011, 0b100, AddDispatch));
+  EXPECT_EQ(second.bindings[2], (std::vector<uint32_t>{11, 22, 34}));
+  EXPECT_EQ(2u, QueryStatistics().entry_count);
+}
+
+TEST_F(DispatchCacheTest, ChangedPushConstantsMiss) {
+  CreateCache();
+  TestDispatch first({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  first.SetPushConstants({1});
+  EXPECT_FALSE(RunDispatch(first, 0b011, 0b100, AddDispatch));
+  TestDispatch second({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  second.SetPushConstants({2});
+  EXPECT_FALSE(RunDispatch(second, 0b011, 0b100, AddDispatch));
+  EXPECT_EQ(0u, QueryStatistics().hit_count);
+}
+
+// Outputs not known to be write-only may be read by the dispatch: an
+// accumulator with different prior contents must not hit.
+TEST_F(DispatchCacheTest, ReadWriteBindingContentsAreKeyed) {
+  CreateCache();
+  TestDispatch first({{1, 2, 3}, {100, 200, 300}});
+  EXPECT_FALSE(
+      RunDispatch(first, 0b01, /*write_only_mask=*/0, AccumulateDispatch));
+  EXPECT_EQ(first.bindings[1], (std::vector<uint32_t>{101, 202, 303}));
+
+  // Same input but the accumulator now holds the prior result.
+  EXPECT_FALSE(
+      RunDispatch(first, 0b01, /*write_only_mask=*/0, AccumulateDispatch));
+  EXPECT_EQ(first.bindings[1], (std::vector<uint32_t>{102, 204, 306}));
+
+  // Same input and same accumulator contents as the first dispatch hit.
+  TestDispatch second({{1, 2, 3}, {100, 200, 300}});
+  EXPECT_TRUE(
+      RunDispatch(second, 0b01, /*write_only_mask=*/0, AccumulateDispatch));
+  EXPECT_EQ(second.bindings[1], (std::vector<uint32_t>{101, 202, 303}));
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(1u, statistics.hit_count);
+  EXPECT_EQ(2u, statistics.miss_count);
+}
+
+// Write-only outputs don't contribute their prior contents to the key.
+TEST_F(DispatchCacheTest, WriteOnlyBindingContentsAreIgnored) {
+  CreateCache();
+  TestDispatch first({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(first, 0b011, 0b100, AddDispatch));
+  TestDispatch second({{1, 2, 3}, {10, 20, 30}, {7, 7, 7}});
+  EXPECT_TRUE(RunDispatch(second, 0b011, 0b100, AddDispatch));
+  EXPECT_EQ(second.bindings[2], (std::vector<uint32_t>{11, 22, 33}));
+}
+
+TEST_F(DispatchCacheTest, BypassWithoutOutputs) {
+  CreateCache();
+  TestDispatch dispatch({{1, 2, 3}});
+  EXPECT_FALSE(RunDispatch(dispatch, 0b1, 0, [](TestDispatch&) {}));
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(1u, statistics.bypass_count);
+  EXPECT_EQ(0u, statistics.miss_count);
+  EXPECT_EQ(0u, statistics.entry_count);
+}
+
+// Read-write outputs count against the hashing limit while write-only outputs
+// do not.
+TEST_F(DispatchCacheTest, BypassOverMaxHashedBytes) {
+  params_.max_hashed_bytes = 4 * sizeof(uint32_t);
+  CreateCache();
+  TestDispatch dispatch({{1, 2, 3}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(dispatch, 0b01, 0b00, AccumulateDispatch));
+  EXPECT_EQ(1u, QueryStatistics().bypass_count);
+  EXPECT_FALSE(RunDispatch(dispatch, 0b01, 0b10, AccumulateDispatch));
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(1u, statistics.bypass_count);
+  EXPECT_EQ(1u, statistics.miss_count);
+}
+
+TEST_F(DispatchCacheTest, EvictsLeastRecentlyUsed) {
+  params_.capacity = 2 * 3 * sizeof(uint32_t);
+  CreateCache();
+  TestDispatch a({{1, 1, 1}, {0, 0, 0}, {0, 0, 0}});
+  TestDispatch b({{2, 2, 2}, {0, 0, 0}, {0, 0, 0}});
+  TestDispatch c({{3, 3, 3}, {0, 0, 0}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(a, 0b011, 0b100, AddDispatch));
+  EXPECT_FALSE(RunDispatch(b, 0b011, 0b100, AddDispatch));
+  // Touch a so that b is the least recently used.
+  EXPECT_TRUE(RunDispatch(a, 0b011, 0b100, AddDispatch));
+  EXPECT_FALSE(RunDispatch(c, 0b011, 0b100, AddDispatch));
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(1u, statistics.eviction_count);
+  EXPECT_EQ(2u, statistics.entry_count);
+  EXPECT_EQ(params_.capacity, statistics.resident_bytes);
+  EXPECT_TRUE(RunDispatch(a, 0b011, 0b100, AddDispatch));
+  EXPECT_TRUE(RunDispatch(c, 0b011, 0b100, AddDispatch));
+  EXPECT_FALSE(RunDispatch(b, 0b011, 0b100, AddDispatch));
+}
+
+TEST_F(DispatchCacheTest, EntriesRetainExecutable) {
+  CreateCache();
+  TestDispatch dispatch({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(dispatch, 0b011, 0b100, AddDispatch));
+  iree_hal_executable_release(executable_);
+  executable_ = NULL;
+  EXPECT_TRUE(executable_live_);
+  iree_hal_local_dispatch_cache_free(cache_);
+  cache_ = NULL;
+  EXPECT_FALSE(executable_live_);
+}
+
+TEST_F(DispatchCacheTest, QueryI64) {
+  CreateCache();
+  TestDispatch dispatch({{1, 2, 3}, {10, 20, 30}, {0, 0, 0}});
+  EXPECT_FALSE(RunDispatch(dispatch, 0b011, 0b100, AddDispatch));
+  EXPECT_TRUE(RunDispatch(dispatch, 0b011, 0b100, AddDispatch));
+  int64_t value = 0;
+  IREE_ASSERT_OK(
+      iree_hal_local_dispatch_cache_query_i64(cache_, IREE_SV("hits"), &value));
+  EXPECT_EQ(1, value);
+  IREE_ASSERT_OK(iree_hal_local_dispatch_cache_query_i64(
+      cache_, IREE_SV("misses"), &value));
+  EXPECT_EQ(1, value);
+  IREE_ASSERT_OK(iree_hal_local_dispatch_cache_query_i64(
+      cache_, IREE_SV("resident_bytes"), &value));
+  EXPECT_EQ(3 * (int64_t)sizeof(uint32_t), value);
+  EXPECT_THAT(Status(iree_hal_local_dispatch_cache_query_i64(
+                  cache_, IREE_SV("unknown"), &value)),
+              StatusIs(StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
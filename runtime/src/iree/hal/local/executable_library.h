@@ -374,6 +374,22 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+// Hint for the order in which workgroups of a dispatch should be scheduled to
+// improve the cache locality of concurrently executing workgroups. Runtimes
+// may ignore the hint and workgroups must not depend on the order.
+enum iree_hal_executable_workgroup_order_v0_e {
+  // x-major order: each row of the grid is scheduled before the next.
+  IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_LINEAR = 0u,
+  // y-major order: each column of the grid is scheduled before the next.
+  IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_COLUMN_MAJOR = 1u,
+  // Morton (Z-order) within square blocks of workgroup_order_group_size
+  // workgroups per side.
+  IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_MORTON = 2u,
+  // Bands of workgroup_order_group_size rows each scheduled in y-major order.
+  IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_GROUPED = 3u,
+};
+typedef uint8_t iree_hal_executable_workgroup_order_v0_t;
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -382,9 +398,10 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
-  // Must be 0. May be used in the future for flags controlling the dispatch
-  // behavior/synchronization requirements.
-  uint16_t reserved;
+  // Hint for the order in which workgroups are scheduled.
+  iree_hal_executable_workgroup_order_v0_t workgroup_order;
+  // Order-specific group size or 0 to let the runtime choose.
+  uint8_t workgroup_order_group_size;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
@@ -19,6 +19,7 @@
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/local/plugins/registration/init.h"
+#include "iree/task/task.h"
 #include "iree/testing/benchmark.h"
 
 IREE_FLAG(string, executable_format, "",
@@ -49,6 +50,26 @@ IREE_FLAG(int32_t, workgroup_size_z, 1,
 IREE_FLAG(int32_t, max_concurrency, 1,
           "Maximum available concurrency exposed to the dispatch.");
 
+IREE_FLAG(int32_t, workgroups_per_range, 8,
+          "Number of contiguous workgroups issued per call in the\n"
+          "`dispatch_ranges` benchmark. The task system issues each shard\n"
+          "reservation (up to 8 workgroups) as a single range.");
+
+IREE_FLAG(string, workgroup_order, "",
+          "Order in which workgroups are issued:\n"
+          "  'linear': x-major order\n"
+          "  'column_major': y-major order\n"
+          "  'morton': Z-order within square blocks of\n"
+          "      --workgroup_order_group_size= workgroups per side\n"
+          "  'grouped': bands of --workgroup_order_group_size= rows each\n"
+          "      issued in y-major order\n"
+          "Defaults to the order requested by the executable (if any).\n"
+          "Executables whose workgroups share operand data across rows or\n"
+          "columns of the grid can be compared between orders to measure the\n"
+          "cache effects of the traversal.");
+IREE_FLAG(int32_t, workgroup_order_group_size, 0,
+          "Group size used by --workgroup_order= or 0 for the default.");
+
 // Total number of bindings we (currently) allow any executable to have.
 #define IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT \
   (IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *   \
@@ -130,12 +151,162 @@ IREE_FLAG_CALLBACK(
     "  # 2 4-byte floating-point values with contents [[1.4], [2.1]]:\n"
     "  --binding=2x1xf32=1.4,2.1");
 
+// Selects the workgroup order from flags or |dispatch_attrs| if not specified.
+static iree_status_t iree_hal_executable_library_select_order(
+    const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs,
+    iree_task_dispatch_order_t* out_order, uint32_t* out_group_size) {
+  *out_order = IREE_TASK_DISPATCH_ORDER_LINEAR;
+  *out_group_size = (uint32_t)iree_max(0, FLAG_workgroup_order_group_size);
+  iree_string_view_t order_flag = iree_make_cstring_view(FLAG_workgroup_order);
+  if (iree_string_view_is_empty(order_flag)) {
+    if (!dispatch_attrs) return iree_ok_status();
+    switch (dispatch_attrs->workgroup_order) {
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_COLUMN_MAJOR:
+        *out_order = IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR;
+        break;
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_MORTON:
+        *out_order = IREE_TASK_DISPATCH_ORDER_MORTON;
+        break;
+      case IREE_HAL_EXECUTABLE_WORKGROUP_ORDER_GROUPED:
+        *out_order = IREE_TASK_DISPATCH_ORDER_GROUPED;
+        break;
+      default:
+        break;
+    }
+    if (!*out_group_size) {
+      *out_group_size = dispatch_attrs->workgroup_order_group_size;
+    }
+  } else if (iree_string_view_equal(order_flag, IREE_SV("linear"))) {
+    *out_order = IREE_TASK_DISPATCH_ORDER_LINEAR;
+  } else if (iree_string_view_equal(order_flag, IREE_SV("column_major"))) {
+    *out_order = IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR;
+  } else if (iree_string_view_equal(order_flag, IREE_SV("morton"))) {
+    *out_order = IREE_TASK_DISPATCH_ORDER_MORTON;
+  } else if (iree_string_view_equal(order_flag, IREE_SV("grouped"))) {
+    *out_order = IREE_TASK_DISPATCH_ORDER_GROUPED;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown workgroup order '%s'",
+                            FLAG_workgroup_order);
+  }
+  return iree_ok_status();
+}
+
+// Issues a run of |run_length| workgroups contiguous in x-major order starting
+// at the workgroup ID in |workgroup_state|. When |workgroups_per_range| is 0
+// the run must be a single workgroup.
+static iree_status_t iree_hal_executable_library_issue_run(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t run_length, uint32_t workgroups_per_range) {
+  if (workgroups_per_range == 0) {
+    return iree_hal_local_executable_issue_call(
+        executable, ordinal, dispatch_state, workgroup_state, /*worker_id=*/0);
+  }
+  return iree_hal_local_executable_issue_call_range(
+      executable, ordinal, dispatch_state, workgroup_state, run_length,
+      /*worker_id=*/0);
+}
+
+// Issues every workgroup in the grid defined by |dispatch_state| in |order|.
+// When |workgroups_per_range| is 0 each workgroup is issued with its own call
+// and otherwise that many workgroups are reserved at a time with one call per
+// run of workgroups contiguous in x-major order, as the task system does.
+static iree_status_t iree_hal_executable_library_issue_ordered_grid(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_byte_span_t local_memory, uint32_t workgroups_per_range,
+    iree_task_dispatch_order_t order, uint32_t order_group_size) {
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = 0,
+      .workgroup_id_y = 0,
+      .workgroup_id_z = 0,
+      .processor_id = 0,
+      .local_memory = local_memory.data,
+      .local_memory_size = (size_t)local_memory.data_length,
+  };
+  const uint32_t workgroup_count[3] = {
+      dispatch_state->workgroup_count_x,
+      dispatch_state->workgroup_count_y,
+      dispatch_state->workgroup_count_z,
+  };
+  const uint32_t total_count =
+      workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
+  const uint32_t reservation_size = iree_max(1u, workgroups_per_range);
+  uint32_t run_xyz[3] = {0, 0, 0};
+  uint32_t run_length = 0;
+  for (uint32_t i = 0; i < total_count; ++i) {
+    uint32_t xyz[3];
+    iree_task_dispatch_order_tile_xyz(order, order_group_size, workgroup_count,
+                                      i, xyz);
+    if (run_length > 0 && i % reservation_size != 0 &&
+        xyz[0] == run_xyz[0] + run_length && xyz[1] == run_xyz[1] &&
+        xyz[2] == run_xyz[2]) {
+      ++run_length;
+      continue;
+    }
+    if (run_length > 0) {
+      IREE_RETURN_IF_ERROR(iree_hal_executable_library_issue_run(
+          executable, ordinal, dispatch_state, &workgroup_state, run_length,
+          workgroups_per_range));
+    }
+    workgroup_state.workgroup_id_x = xyz[0];
+    workgroup_state.workgroup_id_y = xyz[1];
+    workgroup_state.workgroup_id_z = (uint16_t)xyz[2];
+    memcpy(run_xyz, xyz, sizeof(run_xyz));
+    run_length = 1;
+  }
+  if (run_length == 0) return iree_ok_status();
+  return iree_hal_executable_library_issue_run(
+      executable, ordinal, dispatch_state, &workgroup_state, run_length,
+      workgroups_per_range);
+}
+
+// Issues every workgroup in the grid defined by |dispatch_state|.
+// When |workgroups_per_range| is 0 each workgroup is issued with its own call
+// and otherwise contiguous ranges of that many workgroups are issued per call.
+static iree_status_t iree_hal_executable_library_issue_grid(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_byte_span_t local_memory, uint32_t workgroups_per_range) {
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = 0,
+      .workgroup_id_y = 0,
+      .workgroup_id_z = 0,
+      .processor_id = 0,
+      .local_memory = local_memory.data,
+      .local_memory_size = (size_t)local_memory.data_length,
+  };
+  const uint64_t workgroup_count = (uint64_t)dispatch_state->workgroup_count_x *
+                                   dispatch_state->workgroup_count_y *
+                                   dispatch_state->workgroup_count_z;
+  if (workgroups_per_range == 0) {
+    for (uint64_t i = 0; i < workgroup_count; ++i) {
+      IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_call(
+          executable, ordinal, dispatch_state, &workgroup_state,
+          /*worker_id=*/0));
+      iree_hal_local_executable_next_workgroup(dispatch_state,
+                                               &workgroup_state);
+    }
+    return iree_ok_status();
+  }
+  for (uint64_t i = 0; i < workgroup_count; i += workgroups_per_range) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_call_range(
+        executable, ordinal, dispatch_state, &workgroup_state,
+        (uint32_t)iree_min((uint64_t)workgroups_per_range,
+                           workgroup_count - i),
+        /*worker_id=*/0));
+  }
+  return iree_ok_status();
+}
+
 // NOTE: error handling is here just for better diagnostics: it is not tracking
 // allocations correctly and will leak. Don't use this as an example for how to
 // write robust code.
 static iree_status_t iree_hal_executable_library_run(
     const iree_benchmark_def_t* benchmark_def,
-    iree_benchmark_state_t* benchmark_state) {
+    iree_benchmark_state_t* benchmark_state, uint32_t workgroups_per_range) {
   iree_allocator_t host_allocator = benchmark_state->host_allocator;
   iree_hal_executable_plugin_manager_t* plugin_manager =
       (iree_hal_executable_plugin_manager_t*)benchmark_def->user_data;
@@ -241,10 +412,24 @@ static iree_status_t iree_hal_executable_library_run(
   // we are testing the memory access patterns: if we just ran the same single
   // tile processing the same exact region of memory over and over we are not
   // testing cache effects.
+  iree_task_dispatch_order_t order = IREE_TASK_DISPATCH_ORDER_LINEAR;
+  uint32_t order_group_size = 0;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_library_select_order(
+      local_executable->dispatch_attrs
+          ? &local_executable->dispatch_attrs[FLAG_entry_point]
+          : NULL,
+      &order, &order_group_size));
   int64_t dispatch_count = 0;
   while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
-    IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_dispatch_inline(
-        local_executable, FLAG_entry_point, &dispatch_state, 0, local_memory));
+    if (order == IREE_TASK_DISPATCH_ORDER_LINEAR) {
+      IREE_RETURN_IF_ERROR(iree_hal_executable_library_issue_grid(
+          local_executable, FLAG_entry_point, &dispatch_state, local_memory,
+          workgroups_per_range));
+    } else {
+      IREE_RETURN_IF_ERROR(iree_hal_executable_library_issue_ordered_grid(
+          local_executable, FLAG_entry_point, &dispatch_state, local_memory,
+          workgroups_per_range, order, order_group_size));
+    }
     ++dispatch_count;
   }
 
@@ -270,6 +455,24 @@ static iree_status_t iree_hal_executable_library_run(
   return iree_ok_status();
 }
 
+// Issues each workgroup with its own call into the executable.
+static iree_status_t iree_hal_executable_library_run_dispatch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  return iree_hal_executable_library_run(benchmark_def, benchmark_state,
+                                         /*workgroups_per_range=*/0);
+}
+
+// Issues contiguous ranges of workgroups with one call each as the task system
+// does; the difference from `dispatch` is the per-workgroup call overhead.
+static iree_status_t iree_hal_executable_library_run_dispatch_ranges(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  return iree_hal_executable_library_run(
+      benchmark_def, benchmark_state,
+      (uint32_t)iree_max(1, FLAG_workgroups_per_range));
+}
+
 int main(int argc, char** argv) {
   iree_flags_set_usage(
       "executable_library_benchmark",
@@ -317,10 +520,13 @@ int main(int argc, char** argv) {
       .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
       .minimum_duration_ns = 0,
       .iteration_count = 0,
-      .run = iree_hal_executable_library_run,
+      .run = iree_hal_executable_library_run_dispatch,
       .user_data = plugin_manager,
   };
   iree_benchmark_register(iree_make_cstring_view("dispatch"), &benchmark_def);
+  benchmark_def.run = iree_hal_executable_library_run_dispatch_ranges;
+  iree_benchmark_register(iree_make_cstring_view("dispatch_ranges"),
+                          &benchmark_def);
 
   iree_benchmark_run_specified();
 
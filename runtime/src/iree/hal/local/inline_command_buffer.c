@@ -14,7 +14,9 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/base/internal/fpu_state.h"
 #include "iree/base/internal/math.h"
+#include "iree/hal/local/dispatch_cache.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/lazy_executable.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 
@@ -27,6 +29,10 @@ typedef struct iree_hal_inline_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
 
+  // Optional dispatch cache used to memoize dispatch outputs.
+  // Owned by the device and not retained.
+  iree_hal_local_dispatch_cache_t* dispatch_cache;
+
   struct {
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -93,6 +99,7 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_cache_t* dispatch_cache,
     iree_allocator_t host_allocator, iree_byte_span_t storage,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
@@ -130,6 +137,7 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
       device, mode, command_categories, queue_affinity, binding_capacity,
       &iree_hal_inline_command_buffer_vtable, &command_buffer->base);
   command_buffer->host_allocator = host_allocator;
+  command_buffer->dispatch_cache = dispatch_cache;
   iree_hal_inline_command_buffer_reset(command_buffer);
 
   *out_command_buffer = &command_buffer->base;
@@ -149,6 +157,7 @@ iree_status_t iree_hal_inline_command_buffer_create(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_cache_t* dispatch_cache,
     iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
@@ -162,7 +171,7 @@ iree_status_t iree_hal_inline_command_buffer_create(
   if (iree_status_is_ok(status)) {
     status = iree_hal_inline_command_buffer_initialize(
         device, mode, command_categories, queue_affinity, binding_capacity,
-        host_allocator,
+        dispatch_cache, host_allocator,
         iree_make_byte_span(storage, iree_hal_inline_command_buffer_size()),
         &command_buffer);
   }
@@ -443,8 +452,9 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   iree_hal_inline_command_buffer_t* command_buffer =
       iree_hal_inline_command_buffer_cast(base_command_buffer);
 
-  iree_hal_local_executable_t* local_executable =
-      iree_hal_local_executable_cast(executable);
+  iree_hal_local_executable_t* local_executable = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_local_lazy_executable_resolve(executable, &local_executable));
   if (IREE_UNLIKELY(!local_executable->pipeline_layouts)) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -500,6 +510,7 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   dispatch_state->binding_count = used_binding_count;
   void** binding_ptrs = (void**)dispatch_state->binding_ptrs;
   size_t* binding_lengths = (size_t*)dispatch_state->binding_lengths;
+  iree_hal_local_binding_mask_t read_only_mask = 0;
   iree_host_size_t binding_base = 0;
   for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
     int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
@@ -513,6 +524,26 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
     }
     binding_lengths[i] =
         command_buffer->state.full_binding_lengths[binding_ordinal];
+    if (local_layout->read_only_bindings & (1ull << binding_ordinal)) {
+      read_only_mask |= 1ull << i;
+    }
+  }
+
+  // If memoizing dispatches then check to see if we've already produced the
+  // outputs for these exact inputs. The key is kept on the stack so that we
+  // can insert the results once the dispatch completes. Layouts don't tell us
+  // which outputs are write-only so all outputs are hashed as if read-write.
+  iree_hal_local_dispatch_cache_key_t cache_key;
+  bool cacheable = false;
+  if (command_buffer->dispatch_cache) {
+    cacheable = iree_hal_local_dispatch_cache_make_key(
+        command_buffer->dispatch_cache, executable, (uint32_t)entry_point,
+        read_only_mask, /*write_only_mask=*/0, dispatch_state, &cache_key);
+    if (cacheable &&
+        iree_hal_local_dispatch_cache_lookup(command_buffer->dispatch_cache,
+                                             &cache_key, dispatch_state)) {
+      return iree_ok_status();
+    }
   }
 
   // TODO(benvanik): plumb through an arena or fixed-size reservation to use.
@@ -541,6 +572,11 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   if (local_memory.data) {
     iree_allocator_free(command_buffer->host_allocator, local_memory.data);
   }
+
+  if (iree_status_is_ok(status) && cacheable) {
+    status = iree_hal_local_dispatch_cache_insert(
+        command_buffer->dispatch_cache, &cache_key, dispatch_state);
+  }
   return status;
 }
 
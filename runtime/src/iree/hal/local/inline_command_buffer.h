@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,6 +32,7 @@ iree_status_t iree_hal_inline_command_buffer_initialize(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_cache_t* dispatch_cache,
     iree_allocator_t host_allocator, iree_byte_span_t storage,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -48,10 +50,14 @@ void iree_hal_inline_command_buffer_deinitialize(
 // Executes all work on the calling thread synchronously (today).
 //
 // Must have IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION set.
+//
+// If an optional |dispatch_cache| is provided dispatches are memoized in it.
+// The cache must remain valid for the lifetime of the command buffer.
 iree_status_t iree_hal_inline_command_buffer_create(
     iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_local_dispatch_cache_t* dispatch_cache,
     iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
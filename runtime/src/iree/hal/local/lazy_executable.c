@@ -0,0 +1,289 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/lazy_executable.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+enum iree_hal_local_lazy_executable_state_e {
+  IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_PENDING = 0,
+  IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_LOADED = 1,
+  IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_FAILED = 2,
+};
+
+typedef struct iree_hal_local_lazy_executable_t {
+  // Pipeline layouts are retained by the base for the lifetime of the
+  // executable as they are needed to load it.
+  iree_hal_local_executable_t base;
+
+  // Executable cache whose loaders are used to load the executable.
+  iree_hal_executable_cache_t* executable_cache;
+
+  // iree_hal_local_lazy_executable_state_e. Only transitions out of PENDING
+  // while holding |mutex|.
+  iree_atomic_int32_t state;
+
+  // Held for the duration of loading such that concurrent resolves wait for
+  // the load to complete.
+  iree_slim_mutex_t mutex;
+
+  // Loaded executable when LOADED.
+  iree_hal_local_executable_t* executable;
+  // Load failure when FAILED; cloned for each resolve.
+  iree_status_t status;
+
+  // Copy of the executable data when aliasing is not allowed. Allocated
+  // separately such that it has the allocator alignment loaders expect (ELF
+  // headers, flatbuffers, etc) and freed once loading completes.
+  void* data_copy;
+
+  // Params captured at creation. Format and constants are stored inline after
+  // the layouts. Only valid while PENDING.
+  iree_hal_executable_params_t params;
+  iree_hal_pipeline_layout_t* layouts[];
+} iree_hal_local_lazy_executable_t;
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_lazy_executable_vtable;
+
+static iree_hal_local_lazy_executable_t* iree_hal_local_lazy_executable_cast(
+    iree_hal_executable_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_lazy_executable_vtable);
+  return (iree_hal_local_lazy_executable_t*)base_value;
+}
+
+static bool iree_hal_local_lazy_executable_isa(
+    iree_hal_executable_t* base_value) {
+  return iree_hal_resource_is(base_value,
+                              &iree_hal_local_lazy_executable_vtable);
+}
+
+// Loads the executable if it has not yet been loaded.
+static iree_status_t iree_hal_local_lazy_executable_load(
+    iree_hal_local_lazy_executable_t* executable) {
+  int32_t state =
+      iree_atomic_load_int32(&executable->state, iree_memory_order_acquire);
+  if (IREE_LIKELY(state == IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_LOADED)) {
+    return iree_ok_status();
+  }
+
+  iree_slim_mutex_lock(&executable->mutex);
+  state = iree_atomic_load_int32(&executable->state, iree_memory_order_relaxed);
+  if (state == IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_PENDING) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    iree_hal_executable_t* loaded_executable = NULL;
+    iree_status_t status = iree_hal_local_executable_cache_load(
+        executable->executable_cache, &executable->params, &loaded_executable);
+    if (iree_status_is_ok(status)) {
+      executable->executable =
+          iree_hal_local_executable_cast(loaded_executable);
+      state = IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_LOADED;
+    } else {
+      executable->status = status;
+      state = IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_FAILED;
+    }
+    iree_atomic_store_int32(&executable->state, state,
+                            iree_memory_order_release);
+
+    // The loaded executable has its own copy of anything it needs so the data
+    // copy is dropped instead of being held for the lifetime of the
+    // placeholder.
+    iree_allocator_free(executable->base.host_allocator,
+                        executable->data_copy);
+    executable->data_copy = NULL;
+    executable->params.executable_data = iree_const_byte_span_empty();
+    IREE_TRACE_ZONE_END(z0);
+  }
+  iree_slim_mutex_unlock(&executable->mutex);
+
+  return state == IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_LOADED
+             ? iree_ok_status()
+             : iree_status_clone(executable->status);
+}
+
+// Scheduled by the load scheduler; holds a reference to the executable that is
+// released once loading completes.
+static void iree_hal_local_lazy_executable_load_async(void* user_data) {
+  iree_hal_local_lazy_executable_t* executable =
+      (iree_hal_local_lazy_executable_t*)user_data;
+  // Errors are retained on the executable and reported on first use.
+  iree_status_ignore(iree_hal_local_lazy_executable_load(executable));
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+iree_status_t iree_hal_local_lazy_executable_create(
+    iree_hal_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_local_executable_load_scheduler_t load_scheduler,
+    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(executable_cache);
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(!executable_params->pipeline_layout_count ||
+                       executable_params->pipeline_layouts);
+  IREE_ASSERT_ARGUMENT(!executable_params->constant_count ||
+                       executable_params->constants);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  *out_executable = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Data that may not outlive the call is copied into the executable.
+  const bool alias_data =
+      iree_all_bits_set(executable_params->caching_mode,
+                        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA);
+  const iree_host_size_t layouts_size =
+      executable_params->pipeline_layout_count *
+      sizeof(*executable_params->pipeline_layouts);
+  const iree_host_size_t constants_size =
+      executable_params->constant_count * sizeof(*executable_params->constants);
+  const iree_host_size_t data_size =
+      alias_data ? 0 : executable_params->executable_data.data_length;
+  const iree_host_size_t format_size =
+      executable_params->executable_format.size;
+
+  void* data_copy = NULL;
+  if (data_size > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(host_allocator, data_size, &data_copy));
+    memcpy(data_copy, executable_params->executable_data.data, data_size);
+  }
+
+  iree_hal_local_lazy_executable_t* executable = NULL;
+  iree_host_size_t total_size =
+      sizeof(*executable) + layouts_size + constants_size + format_size;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, total_size, (void**)&executable);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, data_copy);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  iree_hal_local_executable_initialize(
+      &iree_hal_local_lazy_executable_vtable,
+      executable_params->pipeline_layout_count,
+      executable_params->pipeline_layouts, &executable->layouts[0],
+      host_allocator, &executable->base);
+  executable->executable_cache = executable_cache;
+  iree_hal_executable_cache_retain(executable_cache);
+  iree_atomic_store_int32(&executable->state,
+                          IREE_HAL_LOCAL_LAZY_EXECUTABLE_STATE_PENDING,
+                          iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&executable->mutex);
+  executable->executable = NULL;
+  executable->status = iree_ok_status();
+  executable->data_copy = data_copy;
+
+  uint8_t* storage_ptr = (uint8_t*)executable + sizeof(*executable) +
+                         layouts_size;
+  executable->params = *executable_params;
+  executable->params.pipeline_layouts = executable->layouts;
+  if (constants_size > 0) {
+    memcpy(storage_ptr, executable_params->constants, constants_size);
+    executable->params.constants = (const uint32_t*)storage_ptr;
+    storage_ptr += constants_size;
+  }
+  if (data_copy) {
+    executable->params.executable_data =
+        iree_make_const_byte_span(data_copy, data_size);
+  }
+  iree_string_view_append_to_buffer(executable_params->executable_format,
+                                    &executable->params.executable_format,
+                                    (char*)storage_ptr);
+
+  // Start loading in the background, if possible. The scheduled load holds a
+  // reference that is released when it completes.
+  if (load_scheduler.schedule) {
+    iree_hal_executable_retain((iree_hal_executable_t*)executable);
+    iree_status_t schedule_status = load_scheduler.schedule(
+        load_scheduler.self, iree_hal_local_lazy_executable_load_async,
+        executable);
+    if (!iree_status_is_ok(schedule_status)) {
+      // Falls back to loading on first use.
+      iree_status_ignore(schedule_status);
+      iree_hal_executable_release((iree_hal_executable_t*)executable);
+    }
+  }
+
+  *out_executable = (iree_hal_executable_t*)executable;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_lazy_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_local_lazy_executable_t* executable =
+      iree_hal_local_lazy_executable_cast(base_executable);
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_executable_release((iree_hal_executable_t*)executable->executable);
+  iree_status_ignore(executable->status);
+  iree_allocator_free(host_allocator, executable->data_copy);
+  iree_slim_mutex_deinitialize(&executable->mutex);
+  iree_hal_executable_cache_release(executable->executable_cache);
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_local_lazy_executable_resolve(
+    iree_hal_executable_t* executable,
+    iree_hal_local_executable_t** out_local_executable) {
+  IREE_ASSERT_ARGUMENT(executable);
+  IREE_ASSERT_ARGUMENT(out_local_executable);
+  *out_local_executable = NULL;
+  if (!iree_hal_local_lazy_executable_isa(executable)) {
+    *out_local_executable = iree_hal_local_executable_cast(executable);
+    return iree_ok_status();
+  }
+  iree_hal_local_lazy_executable_t* lazy_executable =
+      iree_hal_local_lazy_executable_cast(executable);
+  IREE_RETURN_IF_ERROR(iree_hal_local_lazy_executable_load(lazy_executable));
+  *out_local_executable = lazy_executable->executable;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_local_lazy_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  // Command buffers should have resolved the executable while recording but
+  // forward in case the placeholder is used directly.
+  iree_hal_local_lazy_executable_t* executable =
+      (iree_hal_local_lazy_executable_t*)base_executable;
+  IREE_RETURN_IF_ERROR(iree_hal_local_lazy_executable_load(executable));
+  return iree_hal_local_executable_issue_call(executable->executable, ordinal,
+                                              dispatch_state, workgroup_state,
+                                              worker_id);
+}
+
+static iree_status_t iree_hal_local_lazy_executable_issue_call_range(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t workgroup_count, uint32_t worker_id) {
+  iree_hal_local_lazy_executable_t* executable =
+      (iree_hal_local_lazy_executable_t*)base_executable;
+  IREE_RETURN_IF_ERROR(iree_hal_local_lazy_executable_load(executable));
+  return iree_hal_local_executable_issue_call_range(
+      executable->executable, ordinal, dispatch_state, workgroup_state,
+      workgroup_count, worker_id);
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_lazy_executable_vtable = {
+        .base =
+            {
+                .destroy = iree_hal_local_lazy_executable_destroy,
+            },
+        .issue_call = iree_hal_local_lazy_executable_issue_call,
+        .issue_call_range = iree_hal_local_lazy_executable_issue_call_range,
+};
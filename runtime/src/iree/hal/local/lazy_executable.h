@@ -0,0 +1,55 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
+#define IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_lazy_executable_t
+//===----------------------------------------------------------------------===//
+// A local executable placeholder returned from executable caches created with
+// IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED. Preparing it only captures the
+// executable params and the actual loading happens either on a worker provided
+// by the cache load scheduler (in parallel with other executables being
+// prepared) or on the first dispatch recorded that uses it, whichever comes
+// first. Load failures are reported from the first dispatch.
+//
+// Command buffers must use iree_hal_local_lazy_executable_resolve to get the
+// loaded executable to record against.
+
+// Creates a lazy executable that will load |executable_params| with the
+// loaders of |executable_cache|. The params are copied (or aliased if the
+// caching mode allows) such that they need not outlive the call. If
+// |load_scheduler| is provided loading is scheduled immediately.
+iree_status_t iree_hal_local_lazy_executable_create(
+    iree_hal_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_local_executable_load_scheduler_t load_scheduler,
+    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable);
+
+// Returns the loaded local executable backing |executable|. Lazy executables
+// are loaded on the calling thread if they have not been loaded already and
+// otherwise this waits for any in-progress load. Other local executables are
+// returned as-is. The returned executable is borrowed and valid for as long as
+// |executable| is.
+iree_status_t iree_hal_local_lazy_executable_resolve(
+    iree_hal_executable_t* executable,
+    iree_hal_local_executable_t** out_local_executable);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_LAZY_EXECUTABLE_H_
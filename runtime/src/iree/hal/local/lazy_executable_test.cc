@@ -0,0 +1,437 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/lazy_executable.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/inline_command_buffer.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_cache.h"
+#include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+//===----------------------------------------------------------------------===//
+// Test executables and loader
+//===----------------------------------------------------------------------===//
+
+// Executable counting the workgroups dispatched to it.
+typedef struct iree_hal_test_executable_t {
+  iree_hal_local_executable_t base;
+  std::atomic<int>* workgroup_count;
+} iree_hal_test_executable_t;
+
+static void iree_hal_test_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_test_executable_t* executable =
+      (iree_hal_test_executable_t*)base_executable;
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+}
+
+static iree_status_t iree_hal_test_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  iree_hal_test_executable_t* executable =
+      (iree_hal_test_executable_t*)base_executable;
+  ++*executable->workgroup_count;
+  return iree_ok_status();
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_test_executable_vtable = {
+        /*.base=*/
+        {
+            /*.destroy=*/iree_hal_test_executable_destroy,
+        },
+        /*.issue_call=*/iree_hal_test_executable_issue_call,
+        /*.issue_call_range=*/NULL,
+};
+
+// Loader producing test executables for the `test` format. Executables with
+// the contents `invalid` fail to load. Like real loaders that cast the data to
+// headers, executable data must be aligned to iree_max_align_t.
+typedef struct iree_hal_test_loader_t {
+  iree_hal_executable_loader_t base;
+  iree_allocator_t host_allocator;
+  std::atomic<int> load_count;
+  std::atomic<int> workgroup_count;
+} iree_hal_test_loader_t;
+
+static void iree_hal_test_loader_destroy(
+    iree_hal_executable_loader_t* base_loader) {
+  iree_hal_test_loader_t* loader = (iree_hal_test_loader_t*)base_loader;
+  iree_allocator_free(loader->host_allocator, loader);
+}
+
+static bool iree_hal_test_loader_query_support(
+    iree_hal_executable_loader_t* base_loader,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  return iree_string_view_equal(executable_format, IREE_SV("test"));
+}
+
+static iree_status_t iree_hal_test_loader_try_load(
+    iree_hal_executable_loader_t* base_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable) {
+  iree_hal_test_loader_t* loader = (iree_hal_test_loader_t*)base_loader;
+  ++loader->load_count;
+  iree_string_view_t contents = iree_make_string_view(
+      (const char*)executable_params->executable_data.data,
+      executable_params->executable_data.data_length);
+  if (!iree_host_size_has_alignment(
+          (iree_host_size_t)executable_params->executable_data.data,
+          iree_max_align_t)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "executable data is misaligned");
+  }
+  if (iree_string_view_equal(contents, IREE_SV("invalid"))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid executable");
+  }
+  iree_hal_test_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      loader->host_allocator, sizeof(*executable) +
+                                  executable_params->pipeline_layout_count *
+                                      sizeof(iree_hal_pipeline_layout_t*),
+      (void**)&executable));
+  iree_hal_local_executable_initialize(
+      &iree_hal_test_executable_vtable,
+      executable_params->pipeline_layout_count,
+      executable_params->pipeline_layouts,
+      (iree_hal_pipeline_layout_t**)(executable + 1), loader->host_allocator,
+      &executable->base);
+  executable->workgroup_count = &loader->workgroup_count;
+  *out_executable = (iree_hal_executable_t*)executable;
+  return iree_ok_status();
+}
+
+static const iree_hal_executable_loader_vtable_t iree_hal_test_loader_vtable =
+    {
+        /*.destroy=*/iree_hal_test_loader_destroy,
+        /*.query_support=*/iree_hal_test_loader_query_support,
+        /*.try_load=*/iree_hal_test_loader_try_load,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_lazy_executable_t
+//===----------------------------------------------------------------------===//
+
+class LazyExecutableTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host_allocator_ = iree_allocator_system();
+    IREE_ASSERT_OK(iree_allocator_malloc(host_allocator_, sizeof(*loader_),
+                                         (void**)&loader_));
+    iree_hal_executable_loader_initialize(
+        &iree_hal_test_loader_vtable,
+        iree_hal_executable_import_provider_null(), &loader_->base);
+    loader_->host_allocator = host_allocator_;
+    new (&loader_->load_count) std::atomic<int>(0);
+    new (&loader_->workgroup_count) std::atomic<int>(0);
+    IREE_ASSERT_OK(iree_hal_local_pipeline_layout_create(
+        /*push_constants=*/0, /*set_layout_count=*/0, /*set_layouts=*/NULL,
+        host_allocator_, &pipeline_layout_));
+  }
+
+  void TearDown() override {
+    JoinLoads();
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_pipeline_layout_release(pipeline_layout_);
+    iree_hal_executable_loader_release(&loader_->base);
+  }
+
+  // Creates the deferred executable cache. Loads are scheduled with
+  // ScheduleLoad when |parallel| is set and otherwise happen on first use.
+  void CreateExecutableCache(bool parallel) {
+    iree_hal_local_executable_load_scheduler_t load_scheduler =
+        iree_hal_local_executable_load_scheduler_null();
+    if (parallel) {
+      load_scheduler.self = this;
+      load_scheduler.schedule = ScheduleLoad;
+    }
+    iree_hal_executable_loader_t* loaders[1] = {&loader_->base};
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+        IREE_SV("test"), /*worker_capacity=*/1,
+        IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED, load_scheduler,
+        /*shared_executable_cache=*/NULL, IREE_ARRAYSIZE(loaders), loaders,
+        host_allocator_, &executable_cache_));
+  }
+
+  // Runs each scheduled load on its own thread.
+  static iree_status_t ScheduleLoad(void* self,
+                                    iree_hal_local_executable_load_fn_t fn,
+                                    void* user_data) {
+    auto* test = (LazyExecutableTest*)self;
+    if (test->fail_schedule_) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED);
+    }
+    test->load_threads_.emplace_back([fn, user_data]() { fn(user_data); });
+    return iree_ok_status();
+  }
+
+  // Waits for all scheduled loads to complete.
+  void JoinLoads() {
+    for (auto& thread : load_threads_) thread.join();
+    load_threads_.clear();
+  }
+
+  iree_status_t Prepare(iree_string_view_t contents,
+                        iree_hal_executable_t** out_executable,
+                        iree_host_size_t constant_count = 0) {
+    static const uint32_t constants[3] = {1, 2, 3};
+    iree_hal_executable_params_t params;
+    iree_hal_executable_params_initialize(&params);
+    params.caching_mode = IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_OPTIMIZATION;
+    params.executable_format = IREE_SV("test");
+    params.executable_data =
+        iree_make_const_byte_span(contents.data, contents.size);
+    params.pipeline_layout_count = 1;
+    params.pipeline_layouts = &pipeline_layout_;
+    params.constant_count = constant_count;
+    params.constants = constants;
+    return iree_hal_executable_cache_prepare_executable(executable_cache_,
+                                                        &params,
+                                                        out_executable);
+  }
+
+  iree_allocator_t host_allocator_;
+  iree_hal_test_loader_t* loader_ = NULL;
+  iree_hal_pipeline_layout_t* pipeline_layout_ = NULL;
+  iree_hal_executable_cache_t* executable_cache_ = NULL;
+  bool fail_schedule_ = false;
+  std::vector<std::thread> load_threads_;
+};
+
+// Preparing does not load; the first resolve does and later resolves reuse it.
+TEST_F(LazyExecutableTest, LoadsOnFirstResolve) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable));
+  EXPECT_EQ(0, loader_->load_count);
+
+  iree_hal_local_executable_t* local_executable_a = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_local_lazy_executable_resolve(executable, &local_executable_a));
+  EXPECT_EQ(1, loader_->load_count);
+  EXPECT_NE((iree_hal_local_executable_t*)executable, local_executable_a);
+
+  iree_hal_local_executable_t* local_executable_b = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_local_lazy_executable_resolve(executable, &local_executable_b));
+  EXPECT_EQ(local_executable_a, local_executable_b);
+  EXPECT_EQ(1, loader_->load_count);
+
+  iree_hal_executable_release(executable);
+}
+
+// Copied executable data stays aligned regardless of what else is captured.
+TEST_F(LazyExecutableTest, CopiedDataIsAligned) {
+  CreateExecutableCache(/*parallel=*/false);
+  for (iree_host_size_t constant_count = 0; constant_count <= 3;
+       ++constant_count) {
+    iree_hal_executable_t* executable = NULL;
+    IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable, constant_count));
+    iree_hal_local_executable_t* local_executable = NULL;
+    IREE_EXPECT_OK(
+        iree_hal_local_lazy_executable_resolve(executable, &local_executable));
+    iree_hal_executable_release(executable);
+  }
+}
+
+// Unsupported formats fail when preparing and not when first used.
+TEST_F(LazyExecutableTest, UnsupportedFormatFailsPrepare) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_params_t params;
+  iree_hal_executable_params_initialize(&params);
+  params.executable_format = IREE_SV("other");
+  iree_hal_executable_t* executable = NULL;
+  EXPECT_THAT(Status(iree_hal_executable_cache_prepare_executable(
+                  executable_cache_, &params, &executable)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(nullptr, executable);
+}
+
+// Load failures are deferred to each resolve of the executable.
+TEST_F(LazyExecutableTest, DeferredLoadError) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("invalid"), &executable));
+  iree_hal_local_executable_t* local_executable = NULL;
+  EXPECT_THAT(Status(iree_hal_local_lazy_executable_resolve(
+                  executable, &local_executable)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(nullptr, local_executable);
+  // The failure is retained and not retried.
+  EXPECT_THAT(Status(iree_hal_local_lazy_executable_resolve(
+                  executable, &local_executable)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(1, loader_->load_count);
+  iree_hal_executable_release(executable);
+}
+
+// Scheduled loads run concurrently with preparation and resolves use the
+// executables they loaded.
+TEST_F(LazyExecutableTest, ParallelLoads) {
+  CreateExecutableCache(/*parallel=*/true);
+  static const char* kContents[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+  std::vector<iree_hal_executable_t*> executables;
+  for (const char* contents : kContents) {
+    iree_hal_executable_t* executable = NULL;
+    IREE_ASSERT_OK(Prepare(iree_make_cstring_view(contents), &executable));
+    executables.push_back(executable);
+  }
+  EXPECT_EQ(IREE_ARRAYSIZE(kContents), load_threads_.size());
+  JoinLoads();
+  EXPECT_EQ(IREE_ARRAYSIZE(kContents), loader_->load_count);
+
+  for (auto* executable : executables) {
+    iree_hal_local_executable_t* local_executable = NULL;
+    IREE_ASSERT_OK(
+        iree_hal_local_lazy_executable_resolve(executable, &local_executable));
+    EXPECT_NE(nullptr, local_executable);
+  }
+  EXPECT_EQ(IREE_ARRAYSIZE(kContents), loader_->load_count);
+
+  for (auto* executable : executables) iree_hal_executable_release(executable);
+}
+
+// Executables may be released while their scheduled load is still pending.
+TEST_F(LazyExecutableTest, ReleaseBeforeParallelLoad) {
+  CreateExecutableCache(/*parallel=*/true);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable));
+  iree_hal_executable_release(executable);
+  JoinLoads();
+  EXPECT_EQ(1, loader_->load_count);
+}
+
+// Failures of scheduled loads are reported when the executable is resolved.
+TEST_F(LazyExecutableTest, ParallelLoadError) {
+  CreateExecutableCache(/*parallel=*/true);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("invalid"), &executable));
+  JoinLoads();
+  EXPECT_EQ(1, loader_->load_count);
+  iree_hal_local_executable_t* local_executable = NULL;
+  EXPECT_THAT(Status(iree_hal_local_lazy_executable_resolve(
+                  executable, &local_executable)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(1, loader_->load_count);
+  iree_hal_executable_release(executable);
+}
+
+// Executables fall back to loading on first use if scheduling fails.
+TEST_F(LazyExecutableTest, ScheduleFailureLoadsOnFirstUse) {
+  CreateExecutableCache(/*parallel=*/true);
+  fail_schedule_ = true;
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable));
+  EXPECT_EQ(0, loader_->load_count);
+  iree_hal_local_executable_t* local_executable = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_local_lazy_executable_resolve(executable, &local_executable));
+  EXPECT_EQ(1, loader_->load_count);
+  iree_hal_executable_release(executable);
+}
+
+// Concurrent resolves of the same executable load it once.
+TEST_F(LazyExecutableTest, ConcurrentResolves) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable));
+  std::vector<iree_hal_local_executable_t*> local_executables(8, NULL);
+  std::vector<std::thread> threads;
+  for (auto& local_executable : local_executables) {
+    threads.emplace_back([executable, &local_executable]() {
+      IREE_CHECK_OK(iree_hal_local_lazy_executable_resolve(executable,
+                                                           &local_executable));
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(1, loader_->load_count);
+  for (auto* local_executable : local_executables) {
+    EXPECT_EQ(local_executables[0], local_executable);
+  }
+  iree_hal_executable_release(executable);
+}
+
+// Recording a dispatch resolves the executable and dispatches to the loaded
+// executable. Inline command buffers issue the dispatch while recording.
+TEST_F(LazyExecutableTest, ResolveWhileRecording) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("contents"), &executable));
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_inline_command_buffer_create(
+      /*device=*/NULL,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, /*dispatch_cache=*/NULL, host_allocator_,
+      &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  EXPECT_EQ(0, loader_->load_count);
+  IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(command_buffer, executable,
+                                                  /*entry_point=*/0, 2, 3, 1));
+  EXPECT_EQ(1, loader_->load_count);
+  EXPECT_EQ(2 * 3 * 1, loader_->workgroup_count);
+  IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(command_buffer, executable,
+                                                  /*entry_point=*/0, 1, 1, 1));
+  EXPECT_EQ(1, loader_->load_count);
+  EXPECT_EQ(2 * 3 * 1 + 1, loader_->workgroup_count);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_executable_release(executable);
+}
+
+// Deferred load failures are reported when recording the first dispatch.
+TEST_F(LazyExecutableTest, LoadErrorWhileRecording) {
+  CreateExecutableCache(/*parallel=*/false);
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Prepare(IREE_SV("invalid"), &executable));
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_inline_command_buffer_create(
+      /*device=*/NULL,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, /*dispatch_cache=*/NULL, host_allocator_,
+      &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  EXPECT_THAT(Status(iree_hal_command_buffer_dispatch(
+                  command_buffer, executable, /*entry_point=*/0, 1, 1, 1)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(0, loader_->workgroup_count);
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_executable_release(executable);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -201,7 +201,10 @@ static iree_status_t iree_hal_system_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
-  return iree_ok_status();
+  return iree_hal_local_executable_initialize_metrics(
+      &executable->base, executable->identifier,
+      executable->library.v0->exports.count,
+      executable->library.v0->exports.names);
 }
 
 static int iree_hal_system_executable_import_thunk_v0(
@@ -332,6 +335,37 @@ static iree_status_t iree_hal_system_executable_issue_call(
                         ret);
 }
 
+static iree_status_t iree_hal_system_executable_issue_call_range(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t workgroup_count, uint32_t worker_id) {
+  iree_hal_system_executable_t* executable =
+      (iree_hal_system_executable_t*)base_executable;
+  const iree_hal_executable_library_v0_t* library = executable->library.v0;
+
+  if (IREE_UNLIKELY(ordinal >= library->exports.count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "entry point ordinal out of bounds");
+  }
+
+  IREE_HAL_EXECUTABLE_LIBRARY_CALL_TRACE_ZONE_BEGIN(z0, executable->identifier,
+                                                    library, ordinal);
+  const iree_hal_executable_dispatch_v0_t fn = library->exports.ptrs[ordinal];
+  int ret = 0;
+  for (uint32_t i = 0; i < workgroup_count && ret == 0; ++i) {
+    ret = fn(&base_executable->environment, dispatch_state, workgroup_state);
+    iree_hal_local_executable_next_workgroup(dispatch_state, workgroup_state);
+  }
+  IREE_TRACE_ZONE_END(z0);
+
+  return ret == 0 ? iree_ok_status()
+                  : iree_make_status(
+                        IREE_STATUS_INTERNAL,
+                        "executable entry point returned catastrophic error %d",
+                        ret);
+}
+
 static const iree_hal_local_executable_vtable_t
     iree_hal_system_executable_vtable = {
         .base =
@@ -339,6 +373,7 @@ static const iree_hal_local_executable_vtable_t
                 .destroy = iree_hal_system_executable_destroy,
             },
         .issue_call = iree_hal_system_executable_issue_call,
+        .issue_call_range = iree_hal_system_executable_issue_call_range,
 };
 
 //===----------------------------------------------------------------------===//
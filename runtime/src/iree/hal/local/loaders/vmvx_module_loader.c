@@ -118,6 +118,12 @@ typedef struct iree_hal_vmvx_worker_state_t {
   // Pointer into the VMVX module state for the worker context.
   // This is used to update module state directly.
   iree_vm_module_state_t* vmvx_module_state;
+
+  // VM stack storage reused by every workgroup invocation issued from this
+  // worker. Only the owning worker touches it so no synchronization is needed
+  // and we avoid committing IREE_VM_STACK_DEFAULT_SIZE of native stack per
+  // workgroup.
+  iree_byte_span_t stack_storage;
 } iree_hal_vmvx_worker_state_t;
 
 static iree_status_t iree_hal_vmvx_worker_state_initialize(
@@ -150,10 +156,20 @@ static iree_status_t iree_hal_vmvx_worker_state_initialize(
         executable_params->constants, host_allocator);
   }
 
+  // Preallocate the VM stack used for all calls made from this worker.
+  uint8_t* stack_storage = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(host_allocator, IREE_VM_STACK_DEFAULT_SIZE,
+                                   (void**)&stack_storage);
+  }
+
   if (iree_status_is_ok(status)) {
     out_state->context = context;
     out_state->vmvx_module_state = vmvx_module_state;
+    out_state->stack_storage =
+        iree_make_byte_span(stack_storage, IREE_VM_STACK_DEFAULT_SIZE);
   } else {
+    iree_allocator_free(host_allocator, stack_storage);
     iree_vm_context_release(context);
   }
   IREE_TRACE_ZONE_END(z0);
@@ -161,9 +177,13 @@ static iree_status_t iree_hal_vmvx_worker_state_initialize(
 }
 
 static void iree_hal_vmvx_worker_state_deinitialize(
-    iree_hal_vmvx_worker_state_t* state) {
+    iree_hal_vmvx_worker_state_t* state, iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(state);
   IREE_TRACE_ZONE_BEGIN(z0);
+  if (state->stack_storage.data) {
+    iree_allocator_free(host_allocator, state->stack_storage.data);
+    state->stack_storage = iree_byte_span_empty();
+  }
   if (state->context) {
     iree_vm_context_release(state->context);
     state->context = NULL;
@@ -291,6 +311,14 @@ static iree_status_t iree_hal_vmvx_executable_create(
     }
   }
 
+  // VMVX modules don't carry export names usable as labels so metrics are
+  // identified by export ordinal.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_local_executable_initialize_metrics(
+        &executable->base, iree_vm_module_name(bytecode_module),
+        executable->entry_fn_count, /*export_names=*/NULL);
+  }
+
   // Query the optional local workgroup size from each entry point.
   if (iree_status_is_ok(status)) {
     // TODO(benvanik): pack this more efficiently; this requires a lot of
@@ -341,7 +369,8 @@ static void iree_hal_vmvx_executable_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   for (iree_host_size_t i = 0; i < executable->worker_capacity; ++i) {
-    iree_hal_vmvx_worker_state_deinitialize(&executable->worker_states[i]);
+    iree_hal_vmvx_worker_state_deinitialize(&executable->worker_states[i],
+                                            host_allocator);
   }
   iree_hal_local_executable_deinitialize(
       (iree_hal_local_executable_t*)base_executable);
@@ -501,32 +530,34 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
       .workgroup_count_z = dispatch_state->workgroup_count_z,
   };
 
-  // Call arguments are retained by the caller.
-  iree_vm_list_retain(binding_list);            // for call
-  iree_vm_buffer_retain(&local_memory_buffer);  // for call
-  iree_vm_buffer_retain(&constants_buffer);     // for call
-
-  // VM stack stored on native stack. We really do abuse the stack too much
-  // here but it's 8KB and that should be reasonable given that there isn't too
-  // much above us in the stack.
-  // TODO(benvanik): pass in an iree_arena_t that can be used for this.
-  IREE_VM_INLINE_STACK_INITIALIZE(
-      stack, IREE_VM_INVOCATION_FLAG_TRACE_INLINE,
+  // VM stack stored in the worker-local storage preallocated when the
+  // executable was created. The stack may still grow from the host allocator
+  // if a call exceeds the initial capacity.
+  iree_vm_stack_t* stack = NULL;
+  status = iree_vm_stack_initialize(
+      worker_state->stack_storage, IREE_VM_INVOCATION_FLAG_TRACE_INLINE,
       iree_vm_context_state_resolver(worker_state->context),
-      executable->base.host_allocator);
-
-  // Direct call interface.
-  // This only works because we know the exact signature and that these will
-  // never block (if they do it'll be handled as if it's an error).
-  iree_vm_function_call_t call;
-  memset(&call, 0, sizeof(call));
-  call.function = entry_fn;
-  call.arguments = iree_make_byte_span(&call_args, sizeof(call_args));
-  call.results = iree_make_byte_span(NULL, 0);
-  status = entry_fn.module->begin_call(entry_fn.module->self, stack, call);
-
-  // Clean up the stack if needed, such as when the call fails.
-  iree_vm_stack_deinitialize(stack);
+      executable->base.host_allocator, &stack);
+
+  if (iree_status_is_ok(status)) {
+    // Call arguments are retained by the caller.
+    iree_vm_list_retain(binding_list);            // for call
+    iree_vm_buffer_retain(&local_memory_buffer);  // for call
+    iree_vm_buffer_retain(&constants_buffer);     // for call
+
+    // Direct call interface.
+    // This only works because we know the exact signature and that these will
+    // never block (if they do it'll be handled as if it's an error).
+    iree_vm_function_call_t call;
+    memset(&call, 0, sizeof(call));
+    call.function = entry_fn;
+    call.arguments = iree_make_byte_span(&call_args, sizeof(call_args));
+    call.results = iree_make_byte_span(NULL, 0);
+    status = entry_fn.module->begin_call(entry_fn.module->self, stack, call);
+
+    // Clean up the stack if needed, such as when the call fails.
+    iree_vm_stack_deinitialize(stack);
+  }
 
   iree_vm_buffer_deinitialize(&local_memory_buffer);
   iree_vm_buffer_deinitialize(&constants_buffer);
@@ -6,6 +6,8 @@
 
 #include "iree/hal/local/local_executable.h"
 
+#include <stdio.h>
+
 #include "iree/hal/local/executable_environment.h"
 
 void iree_hal_local_executable_initialize(
@@ -28,6 +30,13 @@ void iree_hal_local_executable_initialize(
   // Function attributes are optional and populated by the parent type.
   out_base_executable->dispatch_attrs = NULL;
 
+  // Metrics are optional and populated by the parent type.
+  out_base_executable->dispatch_metric_count = 0;
+  out_base_executable->dispatch_metrics = NULL;
+
+  out_base_executable->destroy_callback.fn = NULL;
+  out_base_executable->destroy_callback.user_data = NULL;
+
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
                                              &out_base_executable->environment);
@@ -35,10 +44,67 @@ void iree_hal_local_executable_initialize(
 
 void iree_hal_local_executable_deinitialize(
     iree_hal_local_executable_t* base_executable) {
+  if (base_executable->destroy_callback.fn) {
+    base_executable->destroy_callback.fn(
+        base_executable->destroy_callback.user_data, base_executable);
+  }
   for (iree_host_size_t i = 0; i < base_executable->pipeline_layout_count;
        ++i) {
     iree_hal_pipeline_layout_release(base_executable->pipeline_layouts[i]);
   }
+  iree_allocator_free(base_executable->host_allocator,
+                      base_executable->dispatch_metrics);
+}
+
+iree_status_t iree_hal_local_executable_initialize_metrics(
+    iree_hal_local_executable_t* base_executable, iree_string_view_t identifier,
+    iree_host_size_t export_count, const char* const* export_names) {
+  IREE_ASSERT_ARGUMENT(base_executable);
+  iree_metrics_registry_t* registry = iree_metrics_registry_default();
+  if (!registry || !export_count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_metric_t** metrics = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(base_executable->host_allocator,
+                                export_count * sizeof(*metrics),
+                                (void**)&metrics));
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < export_count; ++i) {
+    char labels[256];
+    int labels_length = 0;
+    if (export_names && export_names[i]) {
+      labels_length = snprintf(labels, sizeof(labels),
+                               "executable=\"%.*s\",export=\"%s\"",
+                               (int)identifier.size, identifier.data,
+                               export_names[i]);
+    } else {
+      labels_length = snprintf(labels, sizeof(labels),
+                               "executable=\"%.*s\",export=\"%" PRIhsz "\"",
+                               (int)identifier.size, identifier.data, i);
+    }
+    if (labels_length < 0 || labels_length >= (int)sizeof(labels)) {
+      // Names too long to be useful as labels; skip the export.
+      continue;
+    }
+    status = iree_metrics_registry_lookup_or_create(
+        registry, IREE_METRIC_TYPE_HISTOGRAM,
+        IREE_SV("iree_hal_dispatch_duration_ns"),
+        iree_make_string_view(labels, labels_length),
+        IREE_SV("Local executable dispatch duration in nanoseconds."),
+        &metrics[i]);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (iree_status_is_ok(status)) {
+    base_executable->dispatch_metric_count = export_count;
+    base_executable->dispatch_metrics = metrics;
+  } else {
+    iree_allocator_free(base_executable->host_allocator, metrics);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
@@ -60,6 +126,29 @@ iree_status_t iree_hal_local_executable_issue_call(
                    worker_id);
 }
 
+iree_status_t iree_hal_local_executable_issue_call_range(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t workgroup_count, uint32_t worker_id) {
+  IREE_ASSERT_ARGUMENT(executable);
+  IREE_ASSERT_ARGUMENT(dispatch_state);
+  IREE_ASSERT_ARGUMENT(workgroup_state);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  if (vtable->issue_call_range) {
+    return vtable->issue_call_range(executable, ordinal, dispatch_state,
+                                    workgroup_state, workgroup_count,
+                                    worker_id);
+  }
+  for (uint32_t i = 0; i < workgroup_count; ++i) {
+    IREE_RETURN_IF_ERROR(vtable->issue_call(
+        executable, ordinal, dispatch_state, workgroup_state, worker_id));
+    iree_hal_local_executable_next_workgroup(dispatch_state, workgroup_state);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -82,8 +171,12 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
   });
 #endif  // IREE_HAL_VERBOSE_TRACING_ENABLE
 
-  iree_status_t status = iree_ok_status();
+  iree_metric_t* dispatch_metric =
+      iree_hal_local_executable_dispatch_metric(executable, ordinal);
+  iree_time_t start_time_ns = dispatch_metric ? iree_time_now() : 0;
 
+  // The whole grid is issued as a single range unless it has more workgroups
+  // than a range can hold; the workgroup ID carries over between ranges.
   iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
       .workgroup_id_x = 0,
       .workgroup_id_y = 0,
@@ -92,18 +185,19 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
       .local_memory = local_memory.data,
       .local_memory_size = (size_t)local_memory.data_length,
   };
-  for (uint32_t z = 0; z < workgroup_count_z; ++z) {
-    workgroup_state.workgroup_id_z = z;
-    for (uint32_t y = 0; y < workgroup_count_y; ++y) {
-      workgroup_state.workgroup_id_y = y;
-      for (uint32_t x = 0; x < workgroup_count_x; ++x) {
-        workgroup_state.workgroup_id_x = x;
-        status = iree_hal_local_executable_issue_call(
-            executable, ordinal, dispatch_state, &workgroup_state,
-            /*worker_id=*/0);
-        if (!iree_status_is_ok(status)) break;
-      }
-    }
+  const uint64_t workgroup_count =
+      (uint64_t)workgroup_count_x * workgroup_count_y * workgroup_count_z;
+  iree_status_t status = iree_ok_status();
+  for (uint64_t i = 0; i < workgroup_count && iree_status_is_ok(status);
+       i += UINT32_MAX) {
+    status = iree_hal_local_executable_issue_call_range(
+        executable, ordinal, dispatch_state, &workgroup_state,
+        (uint32_t)iree_min(workgroup_count - i, (uint64_t)UINT32_MAX),
+        /*worker_id=*/0);
+  }
+
+  if (dispatch_metric) {
+    iree_metric_observe(dispatch_metric, iree_time_now() - start_time_ns);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -8,6 +8,7 @@
 #define IREE_HAL_LOCAL_LOCAL_EXECUTABLE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
 
@@ -15,6 +16,18 @@
 extern "C" {
 #endif  // __cplusplus
 
+struct iree_hal_local_executable_t;
+
+// Callback issued when a local executable is destroyed.
+typedef struct iree_hal_local_executable_destroy_callback_t {
+  // Called from iree_hal_local_executable_deinitialize after the last
+  // reference to |executable| has been released.
+  void(IREE_API_PTR* fn)(void* user_data,
+                         struct iree_hal_local_executable_t* executable);
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_hal_local_executable_destroy_callback_t;
+
 typedef struct iree_hal_local_executable_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
@@ -37,6 +50,15 @@ typedef struct iree_hal_local_executable_t {
 
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
+
+  // Optional per-export dispatch duration histograms populated by
+  // iree_hal_local_executable_initialize_metrics when metrics are enabled.
+  iree_host_size_t dispatch_metric_count;
+  iree_metric_t** dispatch_metrics;
+
+  // Optional callback used by caches tracking the executable without retaining
+  // it (see shared_executable_cache.h).
+  iree_hal_local_executable_destroy_callback_t destroy_callback;
 } iree_hal_local_executable_t;
 
 typedef struct iree_hal_local_executable_vtable_t {
@@ -47,6 +69,15 @@ typedef struct iree_hal_local_executable_vtable_t {
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
       uint32_t worker_id);
+
+  // Optional batched variant of |issue_call|; see
+  // iree_hal_local_executable_issue_call_range. When omitted the range is
+  // issued as individual calls.
+  iree_status_t(IREE_API_PTR* issue_call_range)(
+      iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+      const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+      iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+      uint32_t workgroup_count, uint32_t worker_id);
 } iree_hal_local_executable_vtable_t;
 
 // Initializes the local executable base type.
@@ -64,6 +95,23 @@ void iree_hal_local_executable_initialize(
 void iree_hal_local_executable_deinitialize(
     iree_hal_local_executable_t* base_executable);
 
+// Registers per-export dispatch duration histograms in the default metrics
+// registry, if one is installed. |identifier| names the executable and
+// |export_names| is an optional list of |export_count| export names; ordinals
+// are used when omitted. No-op if metrics are not enabled.
+iree_status_t iree_hal_local_executable_initialize_metrics(
+    iree_hal_local_executable_t* base_executable, iree_string_view_t identifier,
+    iree_host_size_t export_count, const char* const* export_names);
+
+// Returns the dispatch duration histogram for export |ordinal| or NULL if
+// metrics are not enabled for the executable.
+static inline iree_metric_t* iree_hal_local_executable_dispatch_metric(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  return ordinal < executable->dispatch_metric_count
+             ? executable->dispatch_metrics[ordinal]
+             : NULL;
+}
+
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
@@ -73,6 +121,34 @@ iree_status_t iree_hal_local_executable_issue_call(
     const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
     uint32_t worker_id);
 
+// Issues |workgroup_count| workgroups of export |ordinal| starting at the
+// workgroup ID in |workgroup_state| and advancing in x-major order through the
+// grid defined by |dispatch_state|. All workgroups share |dispatch_state| and
+// the other fields of |workgroup_state|. The workgroup ID in |workgroup_state|
+// is used as the iterator and upon success is left at the workgroup following
+// the range. Stops at the first workgroup that fails.
+iree_status_t iree_hal_local_executable_issue_call_range(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t workgroup_count, uint32_t worker_id);
+
+// Advances the workgroup ID in |workgroup_state| to the next workgroup in
+// x-major order within the grid defined by |dispatch_state|.
+static inline void iree_hal_local_executable_next_workgroup(
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  if (++workgroup_state->workgroup_id_x < dispatch_state->workgroup_count_x) {
+    return;
+  }
+  workgroup_state->workgroup_id_x = 0;
+  if (++workgroup_state->workgroup_id_y < dispatch_state->workgroup_count_y) {
+    return;
+  }
+  workgroup_state->workgroup_id_y = 0;
+  ++workgroup_state->workgroup_id_z;
+}
+
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -9,11 +9,16 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "iree/hal/local/lazy_executable.h"
+
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
   iree_host_size_t worker_capacity;
+  iree_hal_local_executable_cache_flags_t flags;
+  iree_hal_local_executable_load_scheduler_t load_scheduler;
+  iree_hal_local_shared_executable_cache_t* shared_executable_cache;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_local_executable_cache_t;
@@ -29,6 +34,9 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_hal_local_executable_cache_flags_t flags,
+    iree_hal_local_executable_load_scheduler_t load_scheduler,
+    iree_hal_local_shared_executable_cache_t* shared_executable_cache,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
@@ -52,6 +60,10 @@ iree_status_t iree_hal_local_executable_cache_create(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
     executable_cache->worker_capacity = worker_capacity;
+    executable_cache->flags = flags;
+    executable_cache->load_scheduler = load_scheduler;
+    executable_cache->shared_executable_cache = shared_executable_cache;
+    iree_hal_local_shared_executable_cache_retain(shared_executable_cache);
 
     executable_cache->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
@@ -76,6 +88,8 @@ static void iree_hal_local_executable_cache_destroy(
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     iree_hal_executable_loader_release(executable_cache->loaders[i]);
   }
+  iree_hal_local_shared_executable_cache_release(
+      executable_cache->shared_executable_cache);
   iree_allocator_free(host_allocator, executable_cache);
 
   IREE_TRACE_ZONE_END(z0);
@@ -96,7 +110,7 @@ static bool iree_hal_local_executable_cache_can_prepare_format(
   return false;
 }
 
-static iree_status_t iree_hal_local_executable_cache_prepare_executable(
+iree_status_t iree_hal_local_executable_cache_load(
     iree_hal_executable_cache_t* base_executable_cache,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable) {
@@ -112,9 +126,15 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
     // The loader _may_ handle the executable; if the specific executable is not
     // supported then the try will fail with IREE_STATUS_CANCELLED and we should
     // continue trying other loaders.
-    iree_status_t status = iree_hal_executable_loader_try_load(
-        executable_cache->loaders[i], executable_params,
-        executable_cache->worker_capacity, out_executable);
+    iree_status_t status =
+        executable_cache->shared_executable_cache
+            ? iree_hal_local_shared_executable_cache_try_load(
+                  executable_cache->shared_executable_cache,
+                  executable_cache->loaders[i], executable_params,
+                  executable_cache->worker_capacity, out_executable)
+            : iree_hal_executable_loader_try_load(
+                  executable_cache->loaders[i], executable_params,
+                  executable_cache->worker_capacity, out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
       return status;
@@ -131,6 +151,35 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
       executable_params->executable_format.data);
 }
 
+static iree_status_t iree_hal_local_executable_cache_prepare_executable(
+    iree_hal_executable_cache_t* base_executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable) {
+  iree_hal_local_executable_cache_t* executable_cache =
+      iree_hal_local_executable_cache_cast(base_executable_cache);
+  if (!iree_all_bits_set(executable_cache->flags,
+                         IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED)) {
+    return iree_hal_local_executable_cache_load(
+        base_executable_cache, executable_params, out_executable);
+  }
+
+  // Fail early if the format is unsupported; errors from loading the
+  // executable contents are deferred until the executable is first used.
+  if (!iree_hal_local_executable_cache_can_prepare_format(
+          base_executable_cache, executable_params->caching_mode,
+          executable_params->executable_format)) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "no executable loader registered for the given "
+                            "executable format '%.*s'",
+                            (int)executable_params->executable_format.size,
+                            executable_params->executable_format.data);
+  }
+  return iree_hal_local_lazy_executable_create(
+      base_executable_cache, executable_params,
+      executable_cache->load_scheduler, executable_cache->host_allocator,
+      out_executable);
+}
+
 static const iree_hal_executable_cache_vtable_t
     iree_hal_local_executable_cache_vtable = {
         .destroy = iree_hal_local_executable_cache_destroy,
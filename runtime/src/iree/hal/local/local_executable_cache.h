@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/shared_executable_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,12 +24,61 @@ extern "C" {
 // one device is the same JIT'ed executable in another, and in multi-tenant
 // situations we're likely to want that isolation _and_ sharing.
 
+enum iree_hal_local_executable_cache_flag_bits_t {
+  IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_NONE = 0u,
+  // Returns executables that are loaded on first use or in the background by
+  // the load scheduler instead of loading them while preparing. See
+  // lazy_executable.h.
+  IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED = 1u << 0,
+};
+typedef uint32_t iree_hal_local_executable_cache_flags_t;
+
+typedef void(IREE_API_PTR* iree_hal_local_executable_load_fn_t)(
+    void* user_data);
+
+// Schedules deferred executable loads to run asynchronously so that multiple
+// executables can load in parallel with each other and with the thread
+// preparing them.
+typedef struct iree_hal_local_executable_load_scheduler_t {
+  // User-defined pointer passed to all functions.
+  void* self;
+  // Schedules |fn| to be called exactly once with |user_data| from any thread.
+  // If scheduling fails the executable is loaded on first use instead.
+  iree_status_t(IREE_API_PTR* schedule)(void* self,
+                                        iree_hal_local_executable_load_fn_t fn,
+                                        void* user_data);
+} iree_hal_local_executable_load_scheduler_t;
+
+static inline iree_hal_local_executable_load_scheduler_t
+iree_hal_local_executable_load_scheduler_null(void) {
+  iree_hal_local_executable_load_scheduler_t scheduler = {NULL, NULL};
+  return scheduler;
+}
+
+// Creates a local executable cache loading executables with |loaders|.
+// |load_scheduler| is only used with
+// IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED and may be null to load
+// deferred executables on first use. When |shared_executable_cache| is
+// provided executables are loaded through it such that identical executables
+// loaded by other caches using it are reused instead of loaded again; it is
+// retained by the executable cache.
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
+    iree_hal_local_executable_cache_flags_t flags,
+    iree_hal_local_executable_load_scheduler_t load_scheduler,
+    iree_hal_local_shared_executable_cache_t* shared_executable_cache,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
+// Loads |executable_params| immediately with the first loader in
+// |executable_cache| that supports it, ignoring
+// IREE_HAL_LOCAL_EXECUTABLE_CACHE_FLAG_DEFERRED. Used by deferred executables.
+iree_status_t iree_hal_local_executable_cache_load(
+    iree_hal_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,446 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shared_executable_cache.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_pipeline_layout.h"
+
+// Number of hash buckets; must be a power of two.
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT 64
+
+//===----------------------------------------------------------------------===//
+// Hashing
+//===----------------------------------------------------------------------===//
+
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED 0xCBF29CE484222325ull
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED_ALT \
+  0x84222325CBF29CE4ull
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_PRIME 0x100000001B3ull
+
+// Final avalanche so that low bits are usable for bucketing.
+static inline uint64_t iree_hal_local_shared_executable_cache_hash_mix(
+    uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+// FNV-1a style hash consuming 64-bit words at a time.
+// Not cryptographically strong: only intended to detect identical inputs.
+static uint64_t iree_hal_local_shared_executable_cache_hash_bytes(
+    uint64_t hash, const void* data, iree_host_size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  iree_host_size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = (hash ^ word) * IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_PRIME;
+  }
+  for (; i < length; ++i) {
+    hash =
+        (hash ^ bytes[i]) * IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_PRIME;
+  }
+  return iree_hal_local_shared_executable_cache_hash_mix(hash ^ length);
+}
+
+static uint64_t iree_hal_local_shared_executable_cache_hash_u64(
+    uint64_t hash, uint64_t value) {
+  return (hash ^ value) * IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_PRIME;
+}
+
+//===----------------------------------------------------------------------===//
+// Keys
+//===----------------------------------------------------------------------===//
+
+// Identifies a loaded executable. Executable contents are compared by a pair
+// of independently seeded hashes plus length as the data is not guaranteed to
+// outlive the prepare call and retaining a copy would defeat the purpose of
+// sharing.
+typedef struct iree_hal_local_shared_executable_key_t {
+  // Hash over all of the fields below used for bucketing.
+  uint64_t hash;
+  iree_hal_executable_loader_t* loader;
+  iree_host_size_t worker_capacity;
+  iree_hal_executable_caching_mode_t caching_mode;
+  iree_host_size_t data_length;
+  uint64_t data_hashes[2];
+  uint64_t format_hash;
+  // Hash of the push constant counts and binding masks of all pipeline layouts.
+  uint64_t layout_hash;
+  iree_host_size_t constant_count;
+  uint64_t constant_hash;
+} iree_hal_local_shared_executable_key_t;
+
+static void iree_hal_local_shared_executable_cache_make_key(
+    iree_hal_executable_loader_t* loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity,
+    iree_hal_local_shared_executable_key_t* out_key) {
+  memset(out_key, 0, sizeof(*out_key));
+  out_key->loader = loader;
+  out_key->worker_capacity = worker_capacity;
+  out_key->caching_mode = executable_params->caching_mode;
+  out_key->data_length = executable_params->executable_data.data_length;
+  out_key->data_hashes[0] = iree_hal_local_shared_executable_cache_hash_bytes(
+      IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED,
+      executable_params->executable_data.data,
+      executable_params->executable_data.data_length);
+  out_key->data_hashes[1] = iree_hal_local_shared_executable_cache_hash_bytes(
+      IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED_ALT,
+      executable_params->executable_data.data,
+      executable_params->executable_data.data_length);
+  out_key->format_hash = iree_hal_local_shared_executable_cache_hash_bytes(
+      IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED,
+      executable_params->executable_format.data,
+      executable_params->executable_format.size);
+
+  // Layouts are compared by signature and not identity as each device creates
+  // its own layout objects. Only the fields consulted when recording dispatches
+  // matter as the executable retains the layouts of whichever device loaded it.
+  uint64_t layout_hash = iree_hal_local_shared_executable_cache_hash_u64(
+      IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED,
+      executable_params->pipeline_layout_count);
+  for (iree_host_size_t i = 0; i < executable_params->pipeline_layout_count;
+       ++i) {
+    iree_hal_local_pipeline_layout_t* layout =
+        iree_hal_local_pipeline_layout_cast(
+            executable_params->pipeline_layouts[i]);
+    layout_hash = iree_hal_local_shared_executable_cache_hash_u64(
+        layout_hash, layout->push_constants);
+    layout_hash = iree_hal_local_shared_executable_cache_hash_u64(
+        layout_hash, layout->used_bindings);
+    layout_hash = iree_hal_local_shared_executable_cache_hash_u64(
+        layout_hash, layout->read_only_bindings);
+  }
+  out_key->layout_hash =
+      iree_hal_local_shared_executable_cache_hash_mix(layout_hash);
+
+  out_key->constant_count = executable_params->constant_count;
+  out_key->constant_hash = iree_hal_local_shared_executable_cache_hash_bytes(
+      IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED,
+      executable_params->constants,
+      executable_params->constant_count *
+          sizeof(*executable_params->constants));
+
+  // NOTE: fields are hashed individually as the key struct has padding.
+  uint64_t hash = IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_HASH_SEED;
+  hash = iree_hal_local_shared_executable_cache_hash_u64(
+      hash, (uint64_t)(uintptr_t)out_key->loader);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(
+      hash, out_key->worker_capacity);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(hash,
+                                                         out_key->caching_mode);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(
+      hash, out_key->data_hashes[0]);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(hash,
+                                                         out_key->format_hash);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(hash,
+                                                         out_key->layout_hash);
+  hash = iree_hal_local_shared_executable_cache_hash_u64(
+      hash, out_key->constant_hash);
+  out_key->hash = iree_hal_local_shared_executable_cache_hash_mix(hash);
+}
+
+static bool iree_hal_local_shared_executable_cache_key_equal(
+    const iree_hal_local_shared_executable_key_t* lhs,
+    const iree_hal_local_shared_executable_key_t* rhs) {
+  return lhs->hash == rhs->hash && lhs->loader == rhs->loader &&
+         lhs->worker_capacity == rhs->worker_capacity &&
+         lhs->caching_mode == rhs->caching_mode &&
+         lhs->data_length == rhs->data_length &&
+         lhs->data_hashes[0] == rhs->data_hashes[0] &&
+         lhs->data_hashes[1] == rhs->data_hashes[1] &&
+         lhs->format_hash == rhs->format_hash &&
+         lhs->layout_hash == rhs->layout_hash &&
+         lhs->constant_count == rhs->constant_count &&
+         lhs->constant_hash == rhs->constant_hash;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_shared_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_shared_executable_entry_t {
+  // Next entry in the same hash bucket.
+  struct iree_hal_local_shared_executable_entry_t* bucket_next;
+  // Cache the entry belongs to; retained for the lifetime of the entry.
+  iree_hal_local_shared_executable_cache_t* cache;
+  // Key with |key.loader| retained for the lifetime of the entry so that the
+  // loader address cannot be reused while the entry is resident.
+  iree_hal_local_shared_executable_key_t key;
+  // Executable tracked by the entry. Not retained: the entry is removed when
+  // the executable is destroyed.
+  iree_hal_local_executable_t* executable;
+} iree_hal_local_shared_executable_entry_t;
+
+struct iree_hal_local_shared_executable_cache_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+
+  iree_hal_local_shared_executable_cache_statistics_t statistics;
+  iree_hal_local_shared_executable_entry_t*
+      buckets[IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT];
+};
+
+iree_status_t iree_hal_local_shared_executable_cache_create(
+    iree_allocator_t host_allocator,
+    iree_hal_local_shared_executable_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_shared_executable_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*cache), (void**)&cache));
+  memset(cache, 0, sizeof(*cache));
+  iree_atomic_ref_count_init(&cache->ref_count);
+  cache->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&cache->mutex);
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_shared_executable_cache_destroy(
+    iree_hal_local_shared_executable_cache_t* cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // Resident entries retain the cache so no entries can remain.
+  IREE_ASSERT_EQ(cache->statistics.entry_count, 0);
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(cache->host_allocator, cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_local_shared_executable_cache_retain(
+    iree_hal_local_shared_executable_cache_t* cache) {
+  if (IREE_LIKELY(cache)) {
+    iree_atomic_ref_count_inc(&cache->ref_count);
+  }
+}
+
+void iree_hal_local_shared_executable_cache_release(
+    iree_hal_local_shared_executable_cache_t* cache) {
+  if (IREE_LIKELY(cache) &&
+      iree_atomic_ref_count_dec(&cache->ref_count) == 1) {
+    iree_hal_local_shared_executable_cache_destroy(cache);
+  }
+}
+
+// Returns the bucket containing entries with the given key |hash|.
+static iree_hal_local_shared_executable_entry_t**
+iree_hal_local_shared_executable_cache_bucket(
+    iree_hal_local_shared_executable_cache_t* cache, uint64_t hash) {
+  return &cache->buckets[hash &
+                         (IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_BUCKET_COUNT -
+                          1)];
+}
+
+// Finds the entry matching |key|, if any.
+// Must be called with the cache mutex held.
+static iree_hal_local_shared_executable_entry_t*
+iree_hal_local_shared_executable_cache_find(
+    iree_hal_local_shared_executable_cache_t* cache,
+    const iree_hal_local_shared_executable_key_t* key) {
+  iree_hal_local_shared_executable_entry_t* entry =
+      *iree_hal_local_shared_executable_cache_bucket(cache, key->hash);
+  while (entry &&
+         !iree_hal_local_shared_executable_cache_key_equal(&entry->key, key)) {
+    entry = entry->bucket_next;
+  }
+  return entry;
+}
+
+// Removes |entry| from its bucket if it is still linked.
+// Must be called with the cache mutex held.
+static void iree_hal_local_shared_executable_cache_unlink(
+    iree_hal_local_shared_executable_cache_t* cache,
+    iree_hal_local_shared_executable_entry_t* entry) {
+  iree_hal_local_shared_executable_entry_t** link =
+      iree_hal_local_shared_executable_cache_bucket(cache, entry->key.hash);
+  while (*link && *link != entry) link = &(*link)->bucket_next;
+  if (!*link) return;
+  *link = entry->bucket_next;
+  entry->bucket_next = NULL;
+  --cache->statistics.entry_count;
+  cache->statistics.resident_bytes -= entry->key.data_length;
+}
+
+// Retains the entry executable unless its last reference has already been
+// released and it is being destroyed. Entries are only removed from the cache
+// when their executable is destroyed so the executable memory remains valid
+// while the cache mutex is held.
+// Must be called with the cache mutex held.
+static bool iree_hal_local_shared_executable_entry_try_retain(
+    iree_hal_local_shared_executable_entry_t* entry) {
+  iree_atomic_ref_count_t* ref_count = &entry->executable->resource.ref_count;
+  int32_t value = iree_atomic_load_int32(ref_count, iree_memory_order_acquire);
+  while (value > 0) {
+    if (iree_atomic_compare_exchange_weak_int32(
+            ref_count, &value, value + 1, iree_memory_order_acq_rel,
+            iree_memory_order_acquire)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Removes the entry of an executable whose last reference was released.
+// Called from iree_hal_local_executable_deinitialize.
+static void iree_hal_local_shared_executable_entry_destroy(
+    void* user_data, iree_hal_local_executable_t* executable) {
+  iree_hal_local_shared_executable_entry_t* entry =
+      (iree_hal_local_shared_executable_entry_t*)user_data;
+  iree_hal_local_shared_executable_cache_t* cache = entry->cache;
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_local_shared_executable_cache_unlink(cache, entry);
+  iree_slim_mutex_unlock(&cache->mutex);
+  iree_hal_executable_loader_release(entry->key.loader);
+  iree_allocator_free(cache->host_allocator, entry);
+  iree_hal_local_shared_executable_cache_release(cache);
+}
+
+iree_status_t iree_hal_local_shared_executable_cache_try_load(
+    iree_hal_local_shared_executable_cache_t* cache,
+    iree_hal_executable_loader_t* loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(loader);
+  IREE_ASSERT_ARGUMENT(executable_params);
+  IREE_ASSERT_ARGUMENT(!executable_params->pipeline_layout_count ||
+                       executable_params->pipeline_layouts);
+  IREE_ASSERT_ARGUMENT(out_executable);
+  *out_executable = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, executable_params->executable_data.data_length);
+
+  iree_hal_local_shared_executable_key_t key;
+  iree_hal_local_shared_executable_cache_make_key(loader, executable_params,
+                                                  worker_capacity, &key);
+
+  // Fast path: already loaded by another context or device and still in use.
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_hal_local_shared_executable_entry_t* entry =
+      iree_hal_local_shared_executable_cache_find(cache, &key);
+  if (entry && iree_hal_local_shared_executable_entry_try_retain(entry)) {
+    *out_executable = (iree_hal_executable_t*)entry->executable;
+    ++cache->statistics.hit_count;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  if (*out_executable) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // Load outside of the lock; loading may take a while and other executables
+  // may be loaded concurrently.
+  iree_hal_executable_t* executable = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_loader_try_load(loader, executable_params,
+                                              worker_capacity, &executable));
+
+  entry = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      cache->host_allocator, sizeof(*entry), (void**)&entry);
+  if (!iree_status_is_ok(status)) {
+    // Still usable, just not shared.
+    iree_status_ignore(status);
+    *out_executable = executable;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  memset(entry, 0, sizeof(*entry));
+  entry->key = key;
+  entry->executable = iree_hal_local_executable_cast(executable);
+
+  iree_slim_mutex_lock(&cache->mutex);
+  ++cache->statistics.miss_count;
+  iree_hal_local_shared_executable_entry_t* existing_entry =
+      iree_hal_local_shared_executable_cache_find(cache, &key);
+  if (existing_entry &&
+      iree_hal_local_shared_executable_entry_try_retain(existing_entry)) {
+    // Raced with another thread loading the same executable; keep theirs so
+    // that all users share a single copy.
+    *out_executable = (iree_hal_executable_t*)existing_entry->executable;
+  } else {
+    if (existing_entry) {
+      // The existing executable is being destroyed; replace its entry. Its
+      // destroy callback will find the entry already unlinked.
+      iree_hal_local_shared_executable_cache_unlink(cache, existing_entry);
+    }
+    iree_hal_executable_loader_retain(entry->key.loader);
+    iree_hal_local_shared_executable_cache_retain(cache);
+    entry->cache = cache;
+    entry->executable->destroy_callback.fn =
+        iree_hal_local_shared_executable_entry_destroy;
+    entry->executable->destroy_callback.user_data = entry;
+    iree_hal_local_shared_executable_entry_t** bucket =
+        iree_hal_local_shared_executable_cache_bucket(cache, key.hash);
+    entry->bucket_next = *bucket;
+    *bucket = entry;
+    ++cache->statistics.entry_count;
+    cache->statistics.resident_bytes += key.data_length;
+    *out_executable = executable;
+    executable = NULL;
+    entry = NULL;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  // Drops our redundant load and its unused entry, if any.
+  iree_hal_executable_release(executable);
+  iree_allocator_free(cache->host_allocator, entry);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_local_shared_executable_cache_query_statistics(
+    iree_hal_local_shared_executable_cache_t* cache,
+    iree_hal_local_shared_executable_cache_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_slim_mutex_lock(&cache->mutex);
+  *out_statistics = cache->statistics;
+  iree_slim_mutex_unlock(&cache->mutex);
+}
+
+iree_status_t iree_hal_local_shared_executable_cache_query_i64(
+    iree_hal_local_shared_executable_cache_t* cache, iree_string_view_t key,
+    int64_t* out_value) {
+  IREE_ASSERT_ARGUMENT(out_value);
+  iree_hal_local_shared_executable_cache_statistics_t statistics;
+  iree_hal_local_shared_executable_cache_query_statistics(cache, &statistics);
+  if (iree_string_view_equal(key, IREE_SV("hits"))) {
+    *out_value = (int64_t)statistics.hit_count;
+  } else if (iree_string_view_equal(key, IREE_SV("misses"))) {
+    *out_value = (int64_t)statistics.miss_count;
+  } else if (iree_string_view_equal(key, IREE_SV("entries"))) {
+    *out_value = (int64_t)statistics.entry_count;
+  } else if (iree_string_view_equal(key, IREE_SV("resident_bytes"))) {
+    *out_value = (int64_t)statistics.resident_bytes;
+  } else {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "unknown shared executable cache statistic '%.*s'",
+                            (int)key.size, key.data);
+  }
+  return iree_ok_status();
+}
@@ -0,0 +1,98 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
+#define IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_shared_executable_cache_t
+//===----------------------------------------------------------------------===//
+// Loaded executables shared across all local executable caches created with
+// the same shared cache. Each context preparing the same executable (same
+// contents, format, constants, pipeline layout signatures, and worker capacity)
+// with the same loader receives a reference to the same loaded executable
+// instead of mapping, relocating, and protecting its own copy.
+//
+// Executables may keep per-worker state (such as the VMVX loader's per-worker
+// contexts and stacks) indexed by the worker ID issuing dispatches and must
+// only be shared by users that issue work with distinct worker IDs from the
+// same set of workers. A shared cache must therefore only be used by devices
+// that schedule work on the same executors: the local-task driver creates one
+// per driver when sharing is enabled and all devices created from the driver
+// use the same executors.
+//
+// Executables are keyed on the loader instance as loaders carry the import
+// providers used to resolve executable imports.
+//
+// The cache does not retain executables: entries are removed when the last
+// user releases the executable. Each resident entry retains the cache such
+// that the cache outlives all of the executables it tracks.
+//
+// Thread-safe.
+typedef struct iree_hal_local_shared_executable_cache_t
+    iree_hal_local_shared_executable_cache_t;
+
+// Statistics tracked over the lifetime of a shared executable cache.
+typedef struct iree_hal_local_shared_executable_cache_statistics_t {
+  // Prepares that were satisfied by an executable already resident.
+  uint64_t hit_count;
+  // Prepares that loaded a new executable.
+  uint64_t miss_count;
+  // Entries currently resident.
+  iree_host_size_t entry_count;
+  // Executable data bytes currently resident. This approximates the memory
+  // used by loaded executable images.
+  iree_host_size_t resident_bytes;
+} iree_hal_local_shared_executable_cache_statistics_t;
+
+// Creates an empty shared executable cache.
+iree_status_t iree_hal_local_shared_executable_cache_create(
+    iree_allocator_t host_allocator,
+    iree_hal_local_shared_executable_cache_t** out_cache);
+
+// Retains the given |cache| for the caller.
+void iree_hal_local_shared_executable_cache_retain(
+    iree_hal_local_shared_executable_cache_t* cache);
+
+// Releases the given |cache| from the caller.
+void iree_hal_local_shared_executable_cache_release(
+    iree_hal_local_shared_executable_cache_t* cache);
+
+// Loads an executable described by |executable_params| using |loader| or
+// returns a reference to a previously loaded executable with matching
+// parameters that is still in use. Behaves as
+// iree_hal_executable_loader_try_load and returns IREE_STATUS_CANCELLED if the
+// loader does not support the executable.
+iree_status_t iree_hal_local_shared_executable_cache_try_load(
+    iree_hal_local_shared_executable_cache_t* cache,
+    iree_hal_executable_loader_t* loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable);
+
+// Queries the current cache statistics.
+void iree_hal_local_shared_executable_cache_query_statistics(
+    iree_hal_local_shared_executable_cache_t* cache,
+    iree_hal_local_shared_executable_cache_statistics_t* out_statistics);
+
+// Queries a single statistic by |key| for exposure through device queries:
+// `hits`, `misses`, `entries`, `resident_bytes`.
+iree_status_t iree_hal_local_shared_executable_cache_query_i64(
+    iree_hal_local_shared_executable_cache_t* cache, iree_string_view_t key,
+    int64_t* out_value);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_SHARED_EXECUTABLE_CACHE_H_
@@ -0,0 +1,258 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shared_executable_cache.h"
+
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+//===----------------------------------------------------------------------===//
+// Test executables and loader
+//===----------------------------------------------------------------------===//
+
+// Executable with no behavior that tracks the number of live instances.
+typedef struct iree_hal_test_executable_t {
+  iree_hal_local_executable_t base;
+  int* live_count;
+} iree_hal_test_executable_t;
+
+static void iree_hal_test_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_test_executable_t* executable =
+      (iree_hal_test_executable_t*)base_executable;
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  --*executable->live_count;
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_test_executable_vtable = {
+        /*.base=*/
+        {
+            /*.destroy=*/iree_hal_test_executable_destroy,
+        },
+        /*.issue_call=*/NULL,
+        /*.issue_call_range=*/NULL,
+};
+
+// Loader producing test executables for the `test` format and counting the
+// number of executables it loads.
+typedef struct iree_hal_test_loader_t {
+  iree_hal_executable_loader_t base;
+  iree_allocator_t host_allocator;
+  int load_count;
+  int live_count;
+} iree_hal_test_loader_t;
+
+static void iree_hal_test_loader_destroy(
+    iree_hal_executable_loader_t* base_loader) {
+  iree_hal_test_loader_t* loader = (iree_hal_test_loader_t*)base_loader;
+  iree_allocator_free(loader->host_allocator, loader);
+}
+
+static bool iree_hal_test_loader_query_support(
+    iree_hal_executable_loader_t* base_loader,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  return iree_string_view_equal(executable_format, IREE_SV("test"));
+}
+
+static iree_status_t iree_hal_test_loader_try_load(
+    iree_hal_executable_loader_t* base_loader,
+    const iree_hal_executable_params_t* executable_params,
+    iree_host_size_t worker_capacity, iree_hal_executable_t** out_executable) {
+  iree_hal_test_loader_t* loader = (iree_hal_test_loader_t*)base_loader;
+  if (!iree_hal_test_loader_query_support(
+          base_loader, executable_params->caching_mode,
+          executable_params->executable_format)) {
+    return iree_status_from_code(IREE_STATUS_CANCELLED);
+  }
+  iree_hal_test_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      loader->host_allocator, sizeof(*executable), (void**)&executable));
+  iree_hal_local_executable_initialize(
+      &iree_hal_test_executable_vtable, /*pipeline_layout_count=*/0,
+      /*source_pipeline_layouts=*/NULL, /*target_pipeline_layouts=*/NULL,
+      loader->host_allocator, &executable->base);
+  executable->live_count = &loader->live_count;
+  ++loader->load_count;
+  ++loader->live_count;
+  *out_executable = (iree_hal_executable_t*)executable;
+  return iree_ok_status();
+}
+
+static const iree_hal_executable_loader_vtable_t iree_hal_test_loader_vtable =
+    {
+        /*.destroy=*/iree_hal_test_loader_destroy,
+        /*.query_support=*/iree_hal_test_loader_query_support,
+        /*.try_load=*/iree_hal_test_loader_try_load,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_shared_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+class SharedExecutableCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_ASSERT_OK(iree_allocator_malloc(host_allocator, sizeof(*loader_),
+                                         (void**)&loader_));
+    iree_hal_executable_loader_initialize(
+        &iree_hal_test_loader_vtable,
+        iree_hal_executable_import_provider_null(), &loader_->base);
+    loader_->host_allocator = host_allocator;
+    loader_->load_count = 0;
+    loader_->live_count = 0;
+    IREE_ASSERT_OK(
+        iree_hal_local_shared_executable_cache_create(host_allocator, &cache_));
+  }
+
+  void TearDown() override {
+    iree_hal_local_shared_executable_cache_release(cache_);
+    iree_hal_executable_loader_release(&loader_->base);
+  }
+
+  // Loads |data| in |format| through the shared cache.
+  iree_status_t Load(iree_string_view_t data, iree_hal_executable_t** out,
+                     iree_string_view_t format = IREE_SV("test"),
+                     iree_host_size_t worker_capacity = 1) {
+    iree_hal_executable_params_t params;
+    iree_hal_executable_params_initialize(&params);
+    params.executable_format = format;
+    params.executable_data = iree_make_const_byte_span(data.data, data.size);
+    return iree_hal_local_shared_executable_cache_try_load(
+        cache_, &loader_->base, &params, worker_capacity, out);
+  }
+
+  iree_hal_local_shared_executable_cache_statistics_t Statistics() {
+    iree_hal_local_shared_executable_cache_statistics_t statistics;
+    iree_hal_local_shared_executable_cache_query_statistics(cache_,
+                                                            &statistics);
+    return statistics;
+  }
+
+  iree_hal_test_loader_t* loader_ = NULL;
+  iree_hal_local_shared_executable_cache_t* cache_ = NULL;
+};
+
+// Loading the same executable twice while in use returns the same instance.
+TEST_F(SharedExecutableCacheTest, Hit) {
+  iree_hal_executable_t* executable_a = NULL;
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_a));
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_b));
+  EXPECT_EQ(executable_a, executable_b);
+  EXPECT_EQ(1, loader_->load_count);
+  auto statistics = Statistics();
+  EXPECT_EQ(1u, statistics.hit_count);
+  EXPECT_EQ(1u, statistics.miss_count);
+  EXPECT_EQ(1u, statistics.entry_count);
+  EXPECT_EQ(8u, statistics.resident_bytes);
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_release(executable_b);
+}
+
+// Executables differing in contents or worker capacity are loaded separately.
+TEST_F(SharedExecutableCacheTest, Miss) {
+  iree_hal_executable_t* executable_a = NULL;
+  iree_hal_executable_t* executable_b = NULL;
+  iree_hal_executable_t* executable_c = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_a));
+  IREE_ASSERT_OK(Load(IREE_SV("contents2"), &executable_b));
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_c, IREE_SV("test"),
+                      /*worker_capacity=*/4));
+  EXPECT_NE(executable_a, executable_b);
+  EXPECT_NE(executable_a, executable_c);
+  EXPECT_EQ(3, loader_->load_count);
+  auto statistics = Statistics();
+  EXPECT_EQ(0u, statistics.hit_count);
+  EXPECT_EQ(3u, statistics.miss_count);
+  EXPECT_EQ(3u, statistics.entry_count);
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_release(executable_b);
+  iree_hal_executable_release(executable_c);
+}
+
+// Unsupported formats are reported as such and not cached.
+TEST_F(SharedExecutableCacheTest, UnsupportedFormat) {
+  iree_hal_executable_t* executable = NULL;
+  EXPECT_THAT(Status(Load(IREE_SV("contents"), &executable, IREE_SV("other"))),
+              StatusIs(StatusCode::kCancelled));
+  EXPECT_EQ(nullptr, executable);
+  EXPECT_EQ(0u, Statistics().entry_count);
+}
+
+// Entries are removed when the last user releases the executable and a later
+// load of the same executable loads it again.
+TEST_F(SharedExecutableCacheTest, ReleaseOnLastUser) {
+  iree_hal_executable_t* executable_a = NULL;
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_a));
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_b));
+  iree_hal_executable_release(executable_a);
+  EXPECT_EQ(1, loader_->live_count);
+  EXPECT_EQ(1u, Statistics().entry_count);
+  iree_hal_executable_release(executable_b);
+  EXPECT_EQ(0, loader_->live_count);
+  auto statistics = Statistics();
+  EXPECT_EQ(0u, statistics.entry_count);
+  EXPECT_EQ(0u, statistics.resident_bytes);
+
+  iree_hal_executable_t* executable_c = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_c));
+  EXPECT_EQ(2, loader_->load_count);
+  EXPECT_EQ(1u, Statistics().entry_count);
+  iree_hal_executable_release(executable_c);
+}
+
+// Executables may outlive the cache and their users' references to it; the
+// cache is destroyed once the last executable is.
+TEST_F(SharedExecutableCacheTest, TeardownWithLiveExecutables) {
+  iree_hal_executable_t* executable_a = NULL;
+  iree_hal_executable_t* executable_b = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable_a));
+  IREE_ASSERT_OK(Load(IREE_SV("contents2"), &executable_b));
+  iree_hal_local_shared_executable_cache_release(cache_);
+  cache_ = NULL;
+  iree_hal_executable_release(executable_a);
+  EXPECT_EQ(1, loader_->live_count);
+  iree_hal_executable_release(executable_b);
+  EXPECT_EQ(0, loader_->live_count);
+}
+
+TEST_F(SharedExecutableCacheTest, QueryI64) {
+  iree_hal_executable_t* executable = NULL;
+  IREE_ASSERT_OK(Load(IREE_SV("contents"), &executable));
+  int64_t value = 0;
+  IREE_ASSERT_OK(iree_hal_local_shared_executable_cache_query_i64(
+      cache_, IREE_SV("misses"), &value));
+  EXPECT_EQ(1, value);
+  IREE_ASSERT_OK(iree_hal_local_shared_executable_cache_query_i64(
+      cache_, IREE_SV("resident_bytes"), &value));
+  EXPECT_EQ(8, value);
+  EXPECT_THAT(Status(iree_hal_local_shared_executable_cache_query_i64(
+                  cache_, IREE_SV("unknown"), &value)),
+              StatusIs(StatusCode::kNotFound));
+  iree_hal_executable_release(executable);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
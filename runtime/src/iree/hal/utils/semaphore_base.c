@@ -19,6 +19,7 @@ static inline bool iree_hal_semaphore_timepoint_list_is_empty(
 }
 
 // Pushes |timepoint| on to the end of the given timepoint |list|.
+// The caller must ensure this maintains the list order, if any.
 static void iree_hal_semaphore_timepoint_list_push_back(
     iree_hal_semaphore_timepoint_list_t* list,
     iree_hal_semaphore_timepoint_t* timepoint) {
@@ -32,6 +33,31 @@ static void iree_hal_semaphore_timepoint_list_push_back(
   list->tail = timepoint;
 }
 
+// Inserts |timepoint| into |list| sorted by minimum value after any other
+// timepoints with the same value. Scans from the tail as most waiters are for
+// increasing values of the timeline.
+static void iree_hal_semaphore_timepoint_list_insert_sorted(
+    iree_hal_semaphore_timepoint_list_t* list,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  iree_hal_semaphore_timepoint_t* prev = list->tail;
+  while (prev && prev->minimum_value > timepoint->minimum_value) {
+    prev = prev->prev;
+  }
+  iree_hal_semaphore_timepoint_t* next = prev ? prev->next : list->head;
+  timepoint->prev = prev;
+  timepoint->next = next;
+  if (prev) {
+    prev->next = timepoint;
+  } else {
+    list->head = timepoint;
+  }
+  if (next) {
+    next->prev = timepoint;
+  } else {
+    list->tail = timepoint;
+  }
+}
+
 // Erases |timepoint| from |list|.
 static void iree_hal_semaphore_timepoint_list_erase(
     iree_hal_semaphore_timepoint_list_t* list,
@@ -107,49 +133,87 @@ static void iree_hal_semaphore_issue_timepoint_callbacks(
   list->tail = NULL;
 }
 
+// Publishes the minimum value of the timepoint list for the lock-free fast
+// path in iree_hal_semaphore_notify.
+// Must be called with the timepoint lock held.
+static void iree_hal_semaphore_update_timepoint_minimum_value(
+    iree_hal_semaphore_t* semaphore) {
+  iree_hal_semaphore_timepoint_t* head = semaphore->timepoint_list.head;
+  const uint64_t minimum_value = head ? head->minimum_value : UINT64_MAX;
+  iree_atomic_store_int64(&semaphore->timepoint_minimum_value,
+                          (int64_t)minimum_value, iree_memory_order_seq_cst);
+}
+
+// Returns true if a notification of |new_value| may resolve or expire any
+// timepoint. May return true spuriously but never returns false if a
+// timepoint registered prior to the value being set needs to be issued.
+static bool iree_hal_semaphore_has_affected_timepoints(
+    iree_hal_semaphore_t* semaphore, uint64_t new_value) {
+  const uint64_t minimum_value = (uint64_t)iree_atomic_load_int64(
+      &semaphore->timepoint_minimum_value, iree_memory_order_seq_cst);
+  if (new_value >= minimum_value) return true;
+  const iree_time_t deadline_ns = iree_atomic_load_int64(
+      &semaphore->timepoint_deadline_ns, iree_memory_order_seq_cst);
+  return deadline_ns != IREE_TIME_INFINITE_FUTURE &&
+         deadline_ns <= iree_time_now();
+}
+
 // NOTE: semaphore timepoint lock must not be held.
 static void iree_hal_semaphore_resolve_timepoints(
     iree_hal_semaphore_t* semaphore, uint64_t new_value) {
+  // Fast path for when no timepoints are reached; this is the common case of
+  // signals that have no waiters or whose waiters are for future values.
+  if (!iree_hal_semaphore_has_affected_timepoints(semaphore, new_value)) {
+    return;
+  }
+
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_semaphore_timepoint_list_t pending_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t ready_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t expired_list = {NULL, NULL};
 
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
 
-  if (iree_hal_semaphore_timepoint_list_is_empty(&semaphore->timepoint_list)) {
-    iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
-    IREE_TRACE_ZONE_END(z0);
-    return;
+  // Take the prefix of the list that has been reached. Even if the deadline has
+  // been reached we'll still consider these a hit.
+  iree_hal_semaphore_timepoint_list_t* list = &semaphore->timepoint_list;
+  while (list->head && list->head->minimum_value <= new_value) {
+    iree_hal_semaphore_timepoint_t* timepoint = list->head;
+    iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+    if (timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      --semaphore->timepoint_deadline_count;
+    }
+    iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
   }
 
-  // Scan through the list and divvy up timepoints into still-pending, ready to
-  // resolve, and expired buckets.
-  iree_time_t now_ns = iree_time_now();
-  for (iree_hal_semaphore_timepoint_t* timepoint =
-           semaphore->timepoint_list.head;
-       timepoint != NULL;) {
-    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
-    timepoint->next = NULL;
-
-    if (timepoint->minimum_value <= new_value) {
-      // Reached the timepoint; even if the deadline has been reached we'll
-      // still consider this a hit.
-      iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
-    } else if (timepoint->deadline_ns <= now_ns) {
-      // Deadline expired before the timepoint was reached.
-      iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
-    } else {
-      // Still pending.
-      iree_hal_semaphore_timepoint_list_push_back(&pending_list, timepoint);
+  // Scan for expired timepoints only if the earliest deadline has been
+  // reached. The deadline is recomputed as we go as it's only a lower bound.
+  iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  if (semaphore->timepoint_deadline_count > 0) {
+    earliest_deadline_ns = iree_atomic_load_int64(
+        &semaphore->timepoint_deadline_ns, iree_memory_order_relaxed);
+    iree_time_t now_ns = iree_time_now();
+    if (earliest_deadline_ns <= now_ns) {
+      earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
+      for (iree_hal_semaphore_timepoint_t* timepoint = list->head;
+           timepoint != NULL;) {
+        iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
+        if (timepoint->deadline_ns <= now_ns) {
+          // Deadline expired before the timepoint was reached.
+          iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+          --semaphore->timepoint_deadline_count;
+          iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
+        } else {
+          earliest_deadline_ns =
+              iree_min(earliest_deadline_ns, timepoint->deadline_ns);
+        }
+        timepoint = next_timepoint;
+      }
     }
-
-    timepoint = next_timepoint;
   }
-
-  // Preserve pending timepoints.
-  semaphore->timepoint_list = pending_list;
+  iree_atomic_store_int64(&semaphore->timepoint_deadline_ns,
+                          earliest_deadline_ns, iree_memory_order_seq_cst);
+  iree_hal_semaphore_update_timepoint_minimum_value(semaphore);
 
   // Issue callbacks for all successes and failures.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, new_value,
@@ -169,10 +233,23 @@ static void iree_hal_semaphore_reject_timepoints(
 
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
 
+  // Failures affect all timepoints regardless of their minimum value so the
+  // lock-free check used when resolving can't skip any work here; failures are
+  // rare and we just check whether any timepoints are registered.
+  if (semaphore->timepoint_list.head == NULL) {
+    iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+
   // Take the entire timepoint list from the semaphore.
   iree_hal_semaphore_timepoint_list_t failed_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_take_all(&semaphore->timepoint_list,
                                              &failed_list);
+  semaphore->timepoint_deadline_count = 0;
+  iree_atomic_store_int64(&semaphore->timepoint_deadline_ns,
+                          IREE_TIME_INFINITE_FUTURE, iree_memory_order_seq_cst);
+  iree_hal_semaphore_update_timepoint_minimum_value(semaphore);
 
   // Issue failure callbacks for all timepoints.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, UINT64_MAX,
@@ -195,6 +272,11 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
   iree_slim_mutex_initialize(&out_semaphore->timepoint_mutex);
   memset(&out_semaphore->timepoint_list, 0,
          sizeof(out_semaphore->timepoint_list));
+  out_semaphore->timepoint_deadline_count = 0;
+  iree_atomic_store_int64(&out_semaphore->timepoint_minimum_value,
+                          (int64_t)UINT64_MAX, iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_semaphore->timepoint_deadline_ns,
+                          IREE_TIME_INFINITE_FUTURE, iree_memory_order_relaxed);
 }
 
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -226,8 +308,19 @@ IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
   // After we release the lock the callback may be issued immediately as another
   // thread may be waiting to signal the timepoint.
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
-  iree_hal_semaphore_timepoint_list_push_back(&semaphore->timepoint_list,
-                                              out_timepoint);
+  iree_hal_semaphore_timepoint_list_insert_sorted(&semaphore->timepoint_list,
+                                                  out_timepoint);
+  if (out_timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+    ++semaphore->timepoint_deadline_count;
+    const iree_time_t earliest_deadline_ns = iree_atomic_load_int64(
+        &semaphore->timepoint_deadline_ns, iree_memory_order_relaxed);
+    if (out_timepoint->deadline_ns < earliest_deadline_ns) {
+      iree_atomic_store_int64(&semaphore->timepoint_deadline_ns,
+                              out_timepoint->deadline_ns,
+                              iree_memory_order_seq_cst);
+    }
+  }
+  iree_hal_semaphore_update_timepoint_minimum_value(semaphore);
   iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
 
   IREE_TRACE_ZONE_END(z0);
@@ -250,6 +343,11 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
     // callback.
     iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
                                             timepoint);
+    if (timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      // The earliest deadline is left as-is as it's only a lower bound.
+      --semaphore->timepoint_deadline_count;
+    }
+    iree_hal_semaphore_update_timepoint_minimum_value(semaphore);
 
     // Neuter the timepoint so that it is never called.
     // Other threads may be sitting and waiting for the lock and we need to
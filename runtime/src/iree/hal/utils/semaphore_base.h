@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
 
@@ -66,9 +67,10 @@ typedef struct iree_hal_semaphore_timepoint_t {
   iree_hal_semaphore_callback_t callback;
 } iree_hal_semaphore_timepoint_t;
 
-// A doubly-linked FIFO list of timepoints.
-// The order of the timepoints does *not* match increasing payload values but
-// instead the order they were added to the list.
+// A doubly-linked list of timepoints sorted by increasing minimum value.
+// Timepoints with the same minimum value are kept in the order they were added
+// to the list. Insertion scans from the tail as the common case is waiting on
+// increasing values of the timeline making it O(1).
 //
 // Note that the timepoints are not owned by the list - this just nicely
 // stitches together timepoints for easier management.
@@ -95,14 +97,25 @@ struct iree_hal_semaphore_t {
   // Non-recursive mutex guarding access to the timepoint list.
   iree_slim_mutex_t timepoint_mutex;
 
-  // Timepoint list in insertion order.
-  // There are probably better orderings we could use here that allow us to
-  // walk the entire list less frequently, though target payload value is not
-  // enough as deadlines still require the scan. We could sort by non-infinite
-  // deadlines first and then infinite ones last but given the common timepoint
-  // counts (0..1) it's not worth the complexity today.
+  // Timepoint list sorted by minimum value.
+  // Notifications only need to walk the prefix of the list that has been
+  // reached. Deadlines still require a scan of the entire list but only once
+  // the earliest deadline has been reached.
   iree_hal_semaphore_timepoint_list_t timepoint_list
       IREE_GUARDED_BY(timepoint_mutex);
+
+  // Number of timepoints in the list with a finite deadline.
+  iree_host_size_t timepoint_deadline_count IREE_GUARDED_BY(timepoint_mutex);
+
+  // Minimum value of any timepoint in the list or UINT64_MAX if empty.
+  // Readable without the lock so that notifications that don't reach any
+  // timepoint can return without contending with other threads.
+  iree_atomic_int64_t timepoint_minimum_value;
+
+  // Lower bound on the earliest deadline of any timepoint in the list or
+  // IREE_TIME_INFINITE_FUTURE if none have deadlines. Readable without the
+  // lock for the same reason as |timepoint_minimum_value|.
+  iree_atomic_int64_t timepoint_deadline_ns;
 };
 
 // Initializes the base |out_semaphore| resource.
@@ -156,6 +169,10 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
 // Implementations must call this when they observe changes.
 // Calling this incorrectly will result in undefined behavior.
 //
+// Notifications that do not reach or expire any timepoint return without
+// taking the timepoint lock. Callbacks are issued in increasing minimum value
+// order.
+//
 // Must not be called from a timepoint callback.
 // Must not be called with a semaphore lock held as notifications may
 // re-entrantly use the semaphore.
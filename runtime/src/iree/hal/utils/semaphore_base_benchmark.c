@@ -0,0 +1,270 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
+#include "iree/testing/benchmark.h"
+
+// Minimal semaphore that only tracks its value and notifies timepoints.
+// Benchmarks are single-threaded and don't need any synchronization beyond
+// what the base semaphore provides.
+typedef struct iree_hal_test_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+  uint64_t current_value;
+} iree_hal_test_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable;
+
+static iree_hal_test_semaphore_t* iree_hal_test_semaphore_cast(
+    iree_hal_semaphore_t* base_value) {
+  return (iree_hal_test_semaphore_t*)base_value;
+}
+
+static iree_status_t iree_hal_test_semaphore_create(
+    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_test_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*semaphore),
+                                             (void**)&semaphore));
+  iree_hal_semaphore_initialize(&iree_hal_test_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  semaphore->current_value = 0ull;
+  *out_semaphore = &semaphore->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_test_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(host_allocator, semaphore);
+}
+
+static iree_status_t iree_hal_test_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  *out_value = semaphore->current_value;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_test_semaphore_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  semaphore->current_value = new_value;
+  iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
+  return iree_ok_status();
+}
+
+static void iree_hal_test_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
+                                         iree_status_t status) {
+  const iree_status_code_t status_code = iree_status_code(status);
+  iree_status_ignore(status);
+  iree_hal_semaphore_notify(base_semaphore, 0, status_code);
+}
+
+static iree_status_t iree_hal_test_semaphore_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_timeout_t timeout) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "waits are not benchmarked");
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable = {
+    .destroy = iree_hal_test_semaphore_destroy,
+    .query = iree_hal_test_semaphore_query,
+    .signal = iree_hal_test_semaphore_signal,
+    .fail = iree_hal_test_semaphore_fail,
+    .wait = iree_hal_test_semaphore_wait,
+};
+
+static iree_status_t iree_hal_semaphore_benchmark_nop_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  ++*(uint32_t*)user_data;
+  return iree_ok_status();
+}
+
+// Tests signaling a semaphore that has no timepoints. This is the common case
+// for device-side semaphores that are only ever waited on by the device and
+// should not need to take the timepoint lock.
+static iree_status_t iree_hal_semaphore_benchmark_signal_no_waiters(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(benchmark_state->host_allocator,
+                                               &semaphore));
+
+  uint64_t value = 0ull;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, ++value));
+  }
+
+  iree_hal_semaphore_release(semaphore);
+  return iree_ok_status();
+}
+
+// Tests signaling a semaphore that has timepoints for values that are never
+// reached by the signals. Each signal should only need to compare against the
+// minimum pending value instead of walking the timepoint list.
+//
+// user_data is a count of outstanding timepoints.
+static iree_status_t iree_hal_semaphore_benchmark_signal_unaffected_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator,
+                                      sizeof(*timepoints) * count,
+                                      (void**)&timepoints));
+  uint32_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      iree_hal_semaphore_benchmark_nop_callback,
+      &callback_count,
+  };
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_acquire_timepoint(semaphore, UINT64_MAX - count + i,
+                                         iree_infinite_timeout(), callback,
+                                         &timepoints[i]);
+  }
+
+  uint64_t value = 0ull;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, ++value));
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i]);
+  }
+  iree_allocator_free(host_allocator, timepoints);
+  iree_hal_semaphore_release(semaphore);
+  return iree_ok_status();
+}
+
+// Tests acquiring timepoints on increasing values and then resolving them one
+// at a time by signaling each value in order. This models a pipeline of queue
+// operations each waiting on the completion of the prior one and should scale
+// linearly with the number of timepoints.
+//
+// user_data is a count of timepoints acquired and resolved per iteration.
+static iree_status_t iree_hal_semaphore_benchmark_resolve_in_order_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator,
+                                      sizeof(*timepoints) * count,
+                                      (void**)&timepoints));
+  uint32_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      iree_hal_semaphore_benchmark_nop_callback,
+      &callback_count,
+  };
+
+  uint64_t base_value = 0ull;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    for (uint32_t i = 0; i < count; ++i) {
+      iree_hal_semaphore_acquire_timepoint(semaphore, base_value + i + 1,
+                                           iree_infinite_timeout(), callback,
+                                           &timepoints[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+      IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, base_value + i + 1));
+    }
+    base_value += count;
+  }
+  if (callback_count != base_value) {
+    fprintf(stderr, "expected %" PRIu64 " callbacks but got %u\n", base_value,
+            callback_count);
+    abort();
+  }
+
+  iree_allocator_free(host_allocator, timepoints);
+  iree_hal_semaphore_release(semaphore);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_semaphore_benchmark_signal_no_waiters
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_signal_no_waiters,
+    };
+    iree_benchmark_register(iree_make_cstring_view("signal_no_waiters"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_semaphore_benchmark_signal_unaffected_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_signal_unaffected_n,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("signal_unaffected_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)1024u;
+    iree_benchmark_register(iree_make_cstring_view("signal_unaffected_1024"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_semaphore_benchmark_resolve_in_order_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_resolve_in_order_n,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("resolve_in_order_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)64u;
+    iree_benchmark_register(iree_make_cstring_view("resolve_in_order_64"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)1024u;
+    iree_benchmark_register(iree_make_cstring_view("resolve_in_order_1024"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)4096u;
+    iree_benchmark_register(iree_make_cstring_view("resolve_in_order_4096"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
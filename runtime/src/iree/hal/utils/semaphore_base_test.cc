@@ -374,6 +374,70 @@ TEST_F(TrackingSemaphoreTest, CancelResolvedTimepoint) {
   iree_hal_semaphore_release(*semaphore);
 }
 
+// Tests that only the timepoints reached are resolved regardless of the order
+// they were acquired in.
+TEST_F(TrackingSemaphoreTest, ResolvePartialTimepoints) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState states[3];
+  iree_hal_semaphore_timepoint_t timepoints[3];
+  const uint64_t values[3] = {3ull, 1ull, 2ull};
+  for (int i = 0; i < 3; ++i) {
+    iree_hal_semaphore_acquire_timepoint(*semaphore, values[i],
+                                         iree_infinite_timeout(),
+                                         MakeCallback(&states[i]),
+                                         &timepoints[i]);
+  }
+
+  // Only the timepoint for 1 is reached:
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 1ull));
+  ASSERT_EQ(states[0].callback_count, 0);
+  ASSERT_EQ(states[1].callback_count, 1);
+  ASSERT_EQ(states[2].callback_count, 0);
+
+  // Remaining timepoints are reached:
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 3ull));
+  ASSERT_EQ(states[0].callback_count, 1);
+  ASSERT_EQ(states[1].callback_count, 1);
+  ASSERT_EQ(states[2].callback_count, 1);
+  ASSERT_EQ(states[0].value, 3ull);
+  ASSERT_EQ(states[2].value, 3ull);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests that timepoints expire when their deadline is reached even if the
+// semaphore value does not change.
+TEST_F(TrackingSemaphoreTest, ExpireTimepoint) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState expired_state;
+  iree_hal_semaphore_timepoint_t expired_timepoint;
+  iree_hal_semaphore_acquire_timepoint(*semaphore, 2ull,
+                                       iree_immediate_timeout(),
+                                       MakeCallback(&expired_state),
+                                       &expired_timepoint);
+  CallbackState pending_state;
+  iree_hal_semaphore_timepoint_t pending_timepoint;
+  iree_hal_semaphore_acquire_timepoint(*semaphore, 2ull,
+                                       iree_infinite_timeout(),
+                                       MakeCallback(&pending_state),
+                                       &pending_timepoint);
+
+  // Callback happens here for the expired timepoint only:
+  iree_hal_semaphore_poll(*semaphore);
+  ASSERT_EQ(expired_state.callback_count, 1);
+  ASSERT_EQ(expired_state.status_code, IREE_STATUS_DEADLINE_EXCEEDED);
+  ASSERT_EQ(pending_state.callback_count, 0);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  ASSERT_EQ(expired_state.callback_count, 1);
+  ASSERT_EQ(pending_state.callback_count, 1);
+  ASSERT_EQ(pending_state.status_code, IREE_STATUS_OK);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -12,6 +12,10 @@
 // would still like to avoid the libc dep for compatibility with the bitcode
 // path.
 #include <math.h>
+#include <stdint.h>
+
+#include "iree/base/internal/cpu.h"
+#include "iree/modules/vmvx/elementwise_internal.h"
 
 //===----------------------------------------------------------------------===//
 // Helpers for defining generic implementations of elementwise functions.
@@ -19,46 +23,17 @@
 // is dispatched based on an opcode.
 //===----------------------------------------------------------------------===//
 
-// Opcodes for generic functions operating on 32-bit operands and result.
-// Since the outer dispatcher only differentiates based on width, all other
-// type specificity is carried by the opcode.
-// Binary opcodes are named "X32B" and unary opcodes "X32U".
-// The initial list was sorted, and it is encouraged to sort extensions, but
-// each opcode must be numerically stable, so the list is not expected to
-// be sorted over time.
-typedef enum {
-  IREE_UK_X32B_ADDF = 0,
-  IREE_UK_X32B_ADDI = 1,
-  IREE_UK_X32B_ANDI = 2,
-  IREE_UK_X32B_DIVF = 3,
-  IREE_UK_X32B_DIVSI = 4,
-  IREE_UK_X32B_DIVUI = 5,
-  IREE_UK_X32B_MULF = 6,
-  IREE_UK_X32B_MULI = 7,
-  IREE_UK_X32B_ORI = 8,
-  IREE_UK_X32B_SHLI = 9,
-  IREE_UK_X32B_SHRSI = 10,
-  IREE_UK_X32B_SHRUI = 11,
-  IREE_UK_X32B_SUBF = 12,
-  IREE_UK_X32B_SUBI = 13,
-  IREE_UKENREL_X32B_XORI = 14,
-} iree_uk_x32b_opcode_t;
-
-typedef enum {
-  IREE_UK_X32U_ABSF,
-  IREE_UK_X32U_CEILF,
-  IREE_UK_X32U_CTLZ,
-  IREE_UK_X32U_EXPF,
-  IREE_UK_X32U_FLOORF,
-  IREE_UK_X32U_LOGF,
-  IREE_UK_X32U_NEGF,
-  IREE_UK_X32U_RSQRTF,
-} iree_uk_x32u_opcode_t;
-
-// Macros to access various typed, dereferenced pointers.
-#define ASF32(ptr) *((float*)ptr)
-#define ASUI32(ptr) *((iree_uk_uint32_t*)ptr)
-#define ASSI32(ptr) *((iree_uk_int32_t*)ptr)
+#if !defined(IREE_UK_ARCH_X86_64)
+// Architectures without specialized row kernels (see elementwise_x86_64.c).
+iree_uk_x32b_row_func_t iree_uk_x32b_select_row_func_arch(
+    iree_uk_x32b_opcode_t opcode, const iree_uk_uint64_t* cpu_data) {
+  return 0;
+}
+iree_uk_x32u_row_func_t iree_uk_x32u_select_row_func_arch(
+    iree_uk_x32u_opcode_t opcode, const iree_uk_uint64_t* cpu_data) {
+  return 0;
+}
+#endif  // !IREE_UK_ARCH_X86_64
 
 //===----------------------------------------------------------------------===//
 // Implementation macros.
@@ -73,7 +48,7 @@ typedef enum {
       iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,               \
       const dtype* rhs, iree_uk_index_t rhs_offset,                           \
       iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,               \
-      dtype* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,                \
+      dtype* out, iree_uk_index_t out_offset,                                \
       iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
       iree_uk_index_t size0, iree_uk_index_t size1) {                         \
     return iree_uk_generic_##category##_2d(                                   \
@@ -88,112 +63,117 @@ typedef enum {
 #define DISPATCH_UKERNEL_UNARY_2D(opcode, opcode_t, dtype, category)          \
   IREE_UK_EXPORT int iree_uk_##category##_##opcode##_2d(                      \
       const dtype* in, iree_uk_index_t in_offset, iree_uk_index_t in_stride0, \
-      iree_uk_index_t in_stride1, dtype* IREE_UK_RESTRICT out,                \
-      iree_uk_index_t out_offset, iree_uk_index_t out_stride0,                \
-      iree_uk_index_t out_stride1, iree_uk_index_t size0,                     \
-      iree_uk_index_t size1) {                                                \
+      iree_uk_index_t in_stride1, dtype* out, iree_uk_index_t out_offset,     \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
+      iree_uk_index_t size0, iree_uk_index_t size1) {                         \
     return iree_uk_generic_##category##_2d(                                   \
         opcode_t, in, in_offset, in_stride0, in_stride1, out, out_offset,     \
         out_stride0, out_stride1, size0, size1);                              \
   }
 
 //===----------------------------------------------------------------------===//
-// Internal helpers.
+// Loop nests.
 //===----------------------------------------------------------------------===//
+// The opcode switch is hoisted out of the loop nest so that each opcode gets
+// its own tight inner loop. VMVX ops may run in place (out aliasing an input)
+// so the entry points cannot promise the operands are disjoint. When all
+// operands are contiguous along the inner dimension and the output row does
+// not overlap any input row the row is handed to the architecture-specific
+// row kernel selected for the opcode based on the runtime CPU features (AVX2
+// and AVX-512 on x86_64). Without one the inner loop runs over restrict
+// pointers that compilers vectorize with the baseline ISA of the target (SSE2
+// on x86_64, NEON on arm64). Overlapping rows keep a plain unit-stride loop
+// and strided operands take the scalar path.
+//
+// TODO: VMVX lowers reductions to VM loops as it has no reduction ops. Once the
+// compiler emits them they should get row kernels selected the same way.
 
-// Computes a single element of an x32b opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32b_op(iree_uk_x32b_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* lhs,
-                                    const iree_uk_uint32_t* rhs,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32B_ADDF:
-      ASF32(out) = ASF32(lhs) + ASF32(rhs);
-      return;
-    case IREE_UK_X32B_ADDI:
-      ASUI32(out) = ASUI32(lhs) + ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ANDI:
-      ASUI32(out) = ASUI32(lhs) & ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVF:
-      ASF32(out) = ASF32(lhs) / ASF32(rhs);
-      return;
-    case IREE_UK_X32B_DIVSI:
-      ASSI32(out) = ASSI32(lhs) / ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVUI:
-      ASUI32(out) = ASUI32(lhs) / ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_MULF:
-      ASF32(out) = ASF32(lhs) * ASF32(rhs);
-      return;
-    case IREE_UK_X32B_MULI:
-      ASUI32(out) = ASUI32(lhs) * ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ORI:
-      ASUI32(out) = ASUI32(lhs) | ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHLI:
-      ASUI32(out) = ASUI32(lhs) << ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRSI:
-      ASSI32(out) = ASSI32(lhs) >> ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRUI:
-      ASUI32(out) = ASUI32(lhs) >> ASUI32(rhs);
-      return;
-    case IREE_UKENREL_X32B_XORI:
-      ASUI32(out) = ASUI32(lhs) ^ ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SUBF:
-      ASF32(out) = ASF32(lhs) - ASF32(rhs);
-      return;
-    case IREE_UK_X32B_SUBI:
-      ASSI32(out) = ASUI32(lhs) - ASUI32(rhs);
-      return;
-    default:
-      *result_code = 1;
-  }
+// Returns true if the |count| 32-bit elements starting at |a| and |b| overlap.
+static inline bool iree_uk_x32_rows_overlap(const void* a, const void* b,
+                                            iree_uk_index_t count) {
+  const iree_uk_uint64_t a_begin = (iree_uk_uint64_t)(uintptr_t)a;
+  const iree_uk_uint64_t b_begin = (iree_uk_uint64_t)(uintptr_t)b;
+  const iree_uk_uint64_t length = (iree_uk_uint64_t)count * 4;
+  return a_begin < b_begin + length && b_begin < a_begin + length;
 }
 
-// Computes a single element of an x32u opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32u_op(iree_uk_x32u_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* in,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32U_ABSF:
-      ASF32(out) = fabsf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CEILF:
-      ASF32(out) = ceilf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CTLZ:
-      ASUI32(out) = iree_uk_count_leading_zeros_u32(ASUI32(in));
-      return;
-    case IREE_UK_X32U_EXPF:
-      ASF32(out) = expf(ASF32(in));
-      return;
-    case IREE_UK_X32U_FLOORF:
-      ASF32(out) = floorf(ASF32(in));
-      return;
-    case IREE_UK_X32U_LOGF:
-      ASF32(out) = logf(ASF32(in));
-      return;
-    case IREE_UK_X32U_NEGF:
-      ASF32(out) = -ASF32(in);
-      return;
-    case IREE_UK_X32U_RSQRTF:
-      ASF32(out) = 1.0f / sqrtf(ASF32(in));
-      return;
-    default:
-      *result_code = 1;
+// Emits the loop nest for a binary op computing `out = OP(lhs, rhs)` with
+// operands reinterpreted as |type|.
+#define IREE_UK_X32B_LOOP_NEST(type, OP)                                    \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {                             \
+    const type* lhs_row = (const type*)lhs + i * lhs_stride0;               \
+    const type* rhs_row = (const type*)rhs + i * rhs_stride0;               \
+    type* out_row = (type*)out + i * out_stride0;                           \
+    if (lhs_stride1 == 1 && rhs_stride1 == 1 && out_stride1 == 1) {         \
+      if (!iree_uk_x32_rows_overlap(out_row, lhs_row, size1) &&             \
+          !iree_uk_x32_rows_overlap(out_row, rhs_row, size1)) {             \
+        if (row_func) {                                                     \
+          row_func((const iree_uk_uint32_t*)lhs_row,                        \
+                   (const iree_uk_uint32_t*)rhs_row,                        \
+                   (iree_uk_uint32_t*)out_row, size1);                      \
+          continue;                                                         \
+        }                                                                   \
+        const type* IREE_UK_RESTRICT lhs_r = lhs_row;                       \
+        const type* IREE_UK_RESTRICT rhs_r = rhs_row;                       \
+        type* IREE_UK_RESTRICT out_r = out_row;                             \
+        for (iree_uk_index_t j = 0; j < size1; ++j) {                       \
+          out_r[j] = OP(lhs_r[j], rhs_r[j]);                                \
+        }                                                                   \
+      } else {                                                              \
+        for (iree_uk_index_t j = 0; j < size1; ++j) {                       \
+          out_row[j] = OP(lhs_row[j], rhs_row[j]);                          \
+        }                                                                   \
+      }                                                                     \
+    } else {                                                                \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                         \
+        out_row[j * out_stride1] =                                          \
+            OP(lhs_row[j * lhs_stride1], rhs_row[j * rhs_stride1]);         \
+      }                                                                     \
+    }                                                                       \
+  }
+
+// Emits the loop nest for a unary op computing `out = OP(in)` with operands
+// reinterpreted as |type|.
+#define IREE_UK_X32U_LOOP_NEST(type, OP)                                      \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {                               \
+    const type* in_row = (const type*)in + i * in_stride0;                    \
+    type* out_row = (type*)out + i * out_stride0;                             \
+    if (in_stride1 == 1 && out_stride1 == 1) {                                \
+      if (!iree_uk_x32_rows_overlap(out_row, in_row, size1)) {                \
+        if (row_func) {                                                       \
+          row_func((const iree_uk_uint32_t*)in_row,                           \
+                   (iree_uk_uint32_t*)out_row, size1);                        \
+          continue;                                                           \
+        }                                                                     \
+        const type* IREE_UK_RESTRICT in_r = in_row;                           \
+        type* IREE_UK_RESTRICT out_r = out_row;                               \
+        for (iree_uk_index_t j = 0; j < size1; ++j) {                         \
+          out_r[j] = OP(in_r[j]);                                             \
+        }                                                                     \
+      } else {                                                                \
+        for (iree_uk_index_t j = 0; j < size1; ++j) {                         \
+          out_row[j] = OP(in_row[j]);                                         \
+        }                                                                     \
+      }                                                                       \
+    } else {                                                                  \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                           \
+        out_row[j * out_stride1] = OP(in_row[j * in_stride1]);                \
+      }                                                                       \
+    }                                                                         \
   }
-}
+
+// Scalar element functions used as the OP of the loop nests above.
+#define IREE_UK_OP_ADD(a, b) ((a) + (b))
+#define IREE_UK_OP_AND(a, b) ((a) & (b))
+#define IREE_UK_OP_DIV(a, b) ((a) / (b))
+#define IREE_UK_OP_MUL(a, b) ((a) * (b))
+#define IREE_UK_OP_OR(a, b) ((a) | (b))
+#define IREE_UK_OP_SHL(a, b) ((a) << (b))
+#define IREE_UK_OP_SHR(a, b) ((a) >> (b))
+#define IREE_UK_OP_SUB(a, b) ((a) - (b))
+#define IREE_UK_OP_XOR(a, b) ((a) ^ (b))
+#define IREE_UK_OP_NEG(a) (-(a))
+#define IREE_UK_OP_RSQRT(a) (1.0f / sqrtf(a))
 
 //===----------------------------------------------------------------------===//
 // Opcode dispatch entry points.
@@ -209,21 +189,61 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32b_2d(
     const iree_uk_uint32_t* rhs, iree_uk_index_t rhs_offset,
     iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,
     // OUT.
-    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_uint32_t* out, iree_uk_index_t out_offset,
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32b_op(opcode, &result_code,
-                              &lhs[i * lhs_stride0 + j * lhs_stride1],
-                              &rhs[i * rhs_stride0 + j * rhs_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  const iree_uk_x32b_row_func_t row_func = iree_uk_x32b_select_row_func_arch(
+      opcode, (const iree_uk_uint64_t*)iree_cpu_data_fields());
+  switch (opcode) {
+    case IREE_UK_X32B_ADDF:
+      IREE_UK_X32B_LOOP_NEST(float, IREE_UK_OP_ADD);
+      return 0;
+    case IREE_UK_X32B_ADDI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_ADD);
+      return 0;
+    case IREE_UK_X32B_ANDI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_AND);
+      return 0;
+    case IREE_UK_X32B_DIVF:
+      IREE_UK_X32B_LOOP_NEST(float, IREE_UK_OP_DIV);
+      return 0;
+    case IREE_UK_X32B_DIVSI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_int32_t, IREE_UK_OP_DIV);
+      return 0;
+    case IREE_UK_X32B_DIVUI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_DIV);
+      return 0;
+    case IREE_UK_X32B_MULF:
+      IREE_UK_X32B_LOOP_NEST(float, IREE_UK_OP_MUL);
+      return 0;
+    case IREE_UK_X32B_MULI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_MUL);
+      return 0;
+    case IREE_UK_X32B_ORI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_OR);
+      return 0;
+    case IREE_UK_X32B_SHLI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_SHL);
+      return 0;
+    case IREE_UK_X32B_SHRSI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_int32_t, IREE_UK_OP_SHR);
+      return 0;
+    case IREE_UK_X32B_SHRUI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_SHR);
+      return 0;
+    case IREE_UKENREL_X32B_XORI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_XOR);
+      return 0;
+    case IREE_UK_X32B_SUBF:
+      IREE_UK_X32B_LOOP_NEST(float, IREE_UK_OP_SUB);
+      return 0;
+    case IREE_UK_X32B_SUBI:
+      IREE_UK_X32B_LOOP_NEST(iree_uk_uint32_t, IREE_UK_OP_SUB);
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 // Generic 32bit unary kernels.
@@ -233,20 +253,41 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32u_2d(
     const iree_uk_uint32_t* in, iree_uk_index_t in_offset,
     iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
     // OUT.
-    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_uint32_t* out, iree_uk_index_t out_offset,
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32u_op(opcode, &result_code,
-                              &in[i * in_stride0 + j * in_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  const iree_uk_x32u_row_func_t row_func = iree_uk_x32u_select_row_func_arch(
+      opcode, (const iree_uk_uint64_t*)iree_cpu_data_fields());
+  switch (opcode) {
+    case IREE_UK_X32U_ABSF:
+      IREE_UK_X32U_LOOP_NEST(float, fabsf);
+      return 0;
+    case IREE_UK_X32U_CEILF:
+      IREE_UK_X32U_LOOP_NEST(float, ceilf);
+      return 0;
+    case IREE_UK_X32U_CTLZ:
+      IREE_UK_X32U_LOOP_NEST(iree_uk_uint32_t,
+                             iree_uk_count_leading_zeros_u32);
+      return 0;
+    case IREE_UK_X32U_EXPF:
+      IREE_UK_X32U_LOOP_NEST(float, expf);
+      return 0;
+    case IREE_UK_X32U_FLOORF:
+      IREE_UK_X32U_LOOP_NEST(float, floorf);
+      return 0;
+    case IREE_UK_X32U_LOGF:
+      IREE_UK_X32U_LOOP_NEST(float, logf);
+      return 0;
+    case IREE_UK_X32U_NEGF:
+      IREE_UK_X32U_LOOP_NEST(float, IREE_UK_OP_NEG);
+      return 0;
+    case IREE_UK_X32U_RSQRTF:
+      IREE_UK_X32U_LOOP_NEST(float, IREE_UK_OP_RSQRT);
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 DISPATCH_UKERNEL_BINARY_2D(addf, IREE_UK_X32B_ADDF, iree_uk_uint32_t, x32b);
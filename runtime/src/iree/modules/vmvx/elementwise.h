@@ -38,7 +38,7 @@ typedef int (*iree_uk_x32b_2d_func_t)(
       iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1, \
       const dtype* rhs, iree_uk_index_t rhs_offset,             \
       iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1, \
-      dtype* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,  \
+      dtype* out, iree_uk_index_t out_offset,                   \
       iree_uk_index_t out_stride0, iree_uk_index_t out_stride1, \
       iree_uk_index_t size0, iree_uk_index_t size1)
 
@@ -79,10 +79,9 @@ typedef int (*iree_uk_x32u_2d_func_t)(
 #define DECLARE_UKERNEL_UNARY_2D(opcode, dtype, category)                     \
   IREE_UK_EXPORT int iree_uk_##category##_##opcode##_2d(                      \
       const dtype* in, iree_uk_index_t in_offset, iree_uk_index_t in_stride0, \
-      iree_uk_index_t in_stride1, dtype* IREE_UK_RESTRICT out,                \
-      iree_uk_index_t out_offset, iree_uk_index_t out_stride0,                \
-      iree_uk_index_t out_stride1, iree_uk_index_t size0,                     \
-      iree_uk_index_t size1)
+      iree_uk_index_t in_stride1, dtype* out, iree_uk_index_t out_offset,     \
+      iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
+      iree_uk_index_t size0, iree_uk_index_t size1)
 
 DECLARE_UKERNEL_UNARY_2D(absf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(ceilf, iree_uk_uint32_t, x32u);
@@ -0,0 +1,135 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/modules/vmvx/elementwise.h"
+#include "iree/testing/benchmark.h"
+
+// Elements per row; large enough that the inner loop dominates.
+#define IREE_VMVX_BENCHMARK_SIZE0 64
+#define IREE_VMVX_BENCHMARK_SIZE1 1024
+#define IREE_VMVX_BENCHMARK_ELEMENTS \
+  (IREE_VMVX_BENCHMARK_SIZE0 * IREE_VMVX_BENCHMARK_SIZE1)
+
+typedef enum iree_vmvx_benchmark_layout_e {
+  // Distinct contiguous operands; takes the architecture-specific row kernels
+  // when available and the restrict fast path otherwise.
+  IREE_VMVX_BENCHMARK_LAYOUT_CONTIGUOUS = 0,
+  // Output aliases the lhs operand; takes the plain unit-stride path.
+  IREE_VMVX_BENCHMARK_LAYOUT_IN_PLACE = 1,
+  // Operands strided by 2 along the inner dimension; takes the scalar path.
+  IREE_VMVX_BENCHMARK_LAYOUT_STRIDED = 2,
+} iree_vmvx_benchmark_layout_t;
+
+// Allocates zeroed operand storage for |layout|; strided layouts need twice
+// the elements.
+static uint32_t* iree_vmvx_benchmark_allocate(
+    iree_allocator_t host_allocator, iree_vmvx_benchmark_layout_t layout) {
+  iree_host_size_t count =
+      IREE_VMVX_BENCHMARK_ELEMENTS *
+      (layout == IREE_VMVX_BENCHMARK_LAYOUT_STRIDED ? 2 : 1);
+  uint32_t* values = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator, count * sizeof(*values),
+                                      (void**)&values));
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    float value = 1.0f + (float)(i % 97);
+    memcpy(&values[i], &value, sizeof(value));
+  }
+  return values;
+}
+
+// Runs iree_uk_x32b_addf_2d over the operand layout in user_data.
+static iree_status_t iree_vmvx_benchmark_addf(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_vmvx_benchmark_layout_t layout =
+      (iree_vmvx_benchmark_layout_t)(uintptr_t)benchmark_def->user_data;
+  uint32_t* lhs = iree_vmvx_benchmark_allocate(host_allocator, layout);
+  uint32_t* rhs = iree_vmvx_benchmark_allocate(host_allocator, layout);
+  uint32_t* out = layout == IREE_VMVX_BENCHMARK_LAYOUT_IN_PLACE
+                      ? lhs
+                      : iree_vmvx_benchmark_allocate(host_allocator, layout);
+  const iree_uk_index_t stride1 =
+      layout == IREE_VMVX_BENCHMARK_LAYOUT_STRIDED ? 2 : 1;
+  const iree_uk_index_t stride0 = IREE_VMVX_BENCHMARK_SIZE1 * stride1;
+
+  while (iree_benchmark_keep_running(
+      benchmark_state, /*batch_count=*/IREE_VMVX_BENCHMARK_ELEMENTS)) {
+    iree_uk_x32b_addf_2d(lhs, 0, stride0, stride1, rhs, 0, stride0, stride1,
+                         out, 0, stride0, stride1, IREE_VMVX_BENCHMARK_SIZE0,
+                         IREE_VMVX_BENCHMARK_SIZE1);
+  }
+
+  if (out != lhs) iree_allocator_free(host_allocator, out);
+  iree_allocator_free(host_allocator, rhs);
+  iree_allocator_free(host_allocator, lhs);
+  return iree_ok_status();
+}
+
+// Runs iree_uk_x32u_negf_2d over the operand layout in user_data.
+static iree_status_t iree_vmvx_benchmark_negf(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_vmvx_benchmark_layout_t layout =
+      (iree_vmvx_benchmark_layout_t)(uintptr_t)benchmark_def->user_data;
+  uint32_t* in = iree_vmvx_benchmark_allocate(host_allocator, layout);
+  uint32_t* out = layout == IREE_VMVX_BENCHMARK_LAYOUT_IN_PLACE
+                      ? in
+                      : iree_vmvx_benchmark_allocate(host_allocator, layout);
+  const iree_uk_index_t stride1 =
+      layout == IREE_VMVX_BENCHMARK_LAYOUT_STRIDED ? 2 : 1;
+  const iree_uk_index_t stride0 = IREE_VMVX_BENCHMARK_SIZE1 * stride1;
+
+  while (iree_benchmark_keep_running(
+      benchmark_state, /*batch_count=*/IREE_VMVX_BENCHMARK_ELEMENTS)) {
+    iree_uk_x32u_negf_2d(in, 0, stride0, stride1, out, 0, stride0, stride1,
+                         IREE_VMVX_BENCHMARK_SIZE0, IREE_VMVX_BENCHMARK_SIZE1);
+  }
+
+  if (out != in) iree_allocator_free(host_allocator, out);
+  iree_allocator_free(host_allocator, in);
+  return iree_ok_status();
+}
+
+// Registers |run| once per operand layout with |name| as the prefix.
+static void iree_vmvx_benchmark_register_layouts(
+    const char* name,
+    iree_status_t (*run)(const iree_benchmark_def_t*,
+                         iree_benchmark_state_t*)) {
+  static const char* layout_names[] = {"contiguous", "in_place", "strided"};
+  for (uintptr_t layout = 0; layout < IREE_ARRAYSIZE(layout_names); ++layout) {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = run,
+        .user_data = (void*)layout,
+    };
+    char full_name[64];
+    snprintf(full_name, sizeof(full_name), "%s_%s", name,
+             layout_names[layout]);
+    iree_benchmark_register(iree_make_cstring_view(full_name), &benchmark_def);
+  }
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+  // Required to select the architecture-specific row kernels.
+  iree_cpu_initialize(iree_allocator_system());
+  iree_vmvx_benchmark_register_layouts("addf", iree_vmvx_benchmark_addf);
+  iree_vmvx_benchmark_register_layouts("negf", iree_vmvx_benchmark_negf);
+  iree_benchmark_run_specified();
+  return 0;
+}
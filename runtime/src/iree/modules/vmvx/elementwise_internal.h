@@ -0,0 +1,81 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_VMVX_ELEMENTWISE_INTERNAL_H_
+#define IREE_MODULES_VMVX_ELEMENTWISE_INTERNAL_H_
+
+#include "iree/builtins/ukernel/api.h"
+
+// Opcodes for generic functions operating on 32-bit operands and result.
+// Since the outer dispatcher only differentiates based on width, all other
+// type specificity is carried by the opcode.
+// Binary opcodes are named "X32B" and unary opcodes "X32U".
+// The initial list was sorted, and it is encouraged to sort extensions, but
+// each opcode must be numerically stable, so the list is not expected to
+// be sorted over time.
+typedef enum {
+  IREE_UK_X32B_ADDF = 0,
+  IREE_UK_X32B_ADDI = 1,
+  IREE_UK_X32B_ANDI = 2,
+  IREE_UK_X32B_DIVF = 3,
+  IREE_UK_X32B_DIVSI = 4,
+  IREE_UK_X32B_DIVUI = 5,
+  IREE_UK_X32B_MULF = 6,
+  IREE_UK_X32B_MULI = 7,
+  IREE_UK_X32B_ORI = 8,
+  IREE_UK_X32B_SHLI = 9,
+  IREE_UK_X32B_SHRSI = 10,
+  IREE_UK_X32B_SHRUI = 11,
+  IREE_UK_X32B_SUBF = 12,
+  IREE_UK_X32B_SUBI = 13,
+  IREE_UKENREL_X32B_XORI = 14,
+} iree_uk_x32b_opcode_t;
+
+typedef enum {
+  IREE_UK_X32U_ABSF,
+  IREE_UK_X32U_CEILF,
+  IREE_UK_X32U_CTLZ,
+  IREE_UK_X32U_EXPF,
+  IREE_UK_X32U_FLOORF,
+  IREE_UK_X32U_LOGF,
+  IREE_UK_X32U_NEGF,
+  IREE_UK_X32U_RSQRTF,
+} iree_uk_x32u_opcode_t;
+
+// Computes a binary op over the `size` contiguous elements at `lhs` and `rhs`
+// into `out`. The rows must not overlap. The op is implied by the selected
+// function.
+typedef void (*iree_uk_x32b_row_func_t)(
+    const iree_uk_uint32_t* IREE_UK_RESTRICT lhs,
+    const iree_uk_uint32_t* IREE_UK_RESTRICT rhs,
+    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size);
+
+// Computes a unary op over the `size` contiguous elements at `in` into `out`.
+// The rows must not overlap. The op is implied by the selected function.
+typedef void (*iree_uk_x32u_row_func_t)(
+    const iree_uk_uint32_t* IREE_UK_RESTRICT in,
+    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size);
+
+// Row kernel declarations. Prototype matches iree_uk_x32b_row_func_t.
+#define IREE_UK_X32B_ROW_FUNC_DECL(NAME)                            \
+  void NAME(const iree_uk_uint32_t* IREE_UK_RESTRICT lhs,           \
+            const iree_uk_uint32_t* IREE_UK_RESTRICT rhs,           \
+            iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size);
+
+// Row kernel declarations. Prototype matches iree_uk_x32u_row_func_t.
+#define IREE_UK_X32U_ROW_FUNC_DECL(NAME)                  \
+  void NAME(const iree_uk_uint32_t* IREE_UK_RESTRICT in,  \
+            iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size);
+
+// Architecture-specific implementations. Return NULL when no specialized row
+// kernel exists for |opcode| on the CPU described by |cpu_data|, in which case
+// the generic loop nest is used.
+iree_uk_x32b_row_func_t iree_uk_x32b_select_row_func_arch(
+    iree_uk_x32b_opcode_t opcode, const iree_uk_uint64_t* cpu_data);
+iree_uk_x32u_row_func_t iree_uk_x32u_select_row_func_arch(
+    iree_uk_x32u_opcode_t opcode, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_MODULES_VMVX_ELEMENTWISE_INTERNAL_H_
@@ -0,0 +1,276 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/elementwise.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/internal/cpu.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+static uint32_t F32Bits(float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float BitsF32(uint32_t bits) {
+  float value = 0.0f;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Returns a row-major size0 x size1 matrix of distinct f32 values (as bits)
+// offset by |base|.
+static std::vector<uint32_t> MakeF32Matrix(int size0, int size1, float base) {
+  std::vector<uint32_t> values(size0 * size1);
+  for (int i = 0; i < size0; ++i) {
+    for (int j = 0; j < size1; ++j) {
+      values[i * size1 + j] = F32Bits(base + i * 100.0f + j);
+    }
+  }
+  return values;
+}
+
+// Row lengths cover both vectorized bodies and scalar remainders.
+static const int kSize0 = 3;
+static const int kSize1 = 37;
+
+TEST(ElementwiseTest, BinaryContiguous) {
+  auto lhs = MakeF32Matrix(kSize0, kSize1, 1.0f);
+  auto rhs = MakeF32Matrix(kSize0, kSize1, 0.5f);
+  std::vector<uint32_t> out(kSize0 * kSize1, 0);
+  ASSERT_EQ(0, iree_uk_x32b_addf_2d(lhs.data(), 0, kSize1, 1, rhs.data(), 0,
+                                    kSize1, 1, out.data(), 0, kSize1, 1,
+                                    kSize0, kSize1));
+  for (size_t i = 0; i < out.size(); ++i) {
+    EXPECT_EQ(BitsF32(lhs[i]) + BitsF32(rhs[i]), BitsF32(out[i]));
+  }
+}
+
+TEST(ElementwiseTest, BinaryStrided) {
+  // lhs is read transposed and out is written with a stride of 2.
+  auto lhs = MakeF32Matrix(kSize1, kSize0, 1.0f);
+  auto rhs = MakeF32Matrix(kSize0, kSize1, 0.5f);
+  std::vector<uint32_t> out(kSize0 * kSize1 * 2, 0);
+  ASSERT_EQ(0, iree_uk_x32b_subf_2d(lhs.data(), 0, 1, kSize0, rhs.data(), 0,
+                                    kSize1, 1, out.data(), 0, kSize1 * 2, 2,
+                                    kSize0, kSize1));
+  for (int i = 0; i < kSize0; ++i) {
+    for (int j = 0; j < kSize1; ++j) {
+      float expected =
+          BitsF32(lhs[j * kSize0 + i]) - BitsF32(rhs[i * kSize1 + j]);
+      EXPECT_EQ(expected, BitsF32(out[i * kSize1 * 2 + j * 2]));
+      EXPECT_EQ(0u, out[i * kSize1 * 2 + j * 2 + 1]);
+    }
+  }
+}
+
+TEST(ElementwiseTest, BinaryInPlaceLhs) {
+  auto lhs = MakeF32Matrix(kSize0, kSize1, 1.0f);
+  auto rhs = MakeF32Matrix(kSize0, kSize1, 0.5f);
+  auto original = lhs;
+  ASSERT_EQ(0, iree_uk_x32b_mulf_2d(lhs.data(), 0, kSize1, 1, rhs.data(), 0,
+                                    kSize1, 1, lhs.data(), 0, kSize1, 1,
+                                    kSize0, kSize1));
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    EXPECT_EQ(BitsF32(original[i]) * BitsF32(rhs[i]), BitsF32(lhs[i]));
+  }
+}
+
+TEST(ElementwiseTest, BinaryInPlaceRhs) {
+  std::vector<uint32_t> lhs(kSize0 * kSize1), rhs(kSize0 * kSize1);
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    lhs[i] = 1000u + static_cast<uint32_t>(i);
+    rhs[i] = static_cast<uint32_t>(i) * 3u;
+  }
+  auto original = rhs;
+  ASSERT_EQ(0, iree_uk_x32b_subi_2d(lhs.data(), 0, kSize1, 1, rhs.data(), 0,
+                                    kSize1, 1, rhs.data(), 0, kSize1, 1,
+                                    kSize0, kSize1));
+  for (size_t i = 0; i < rhs.size(); ++i) {
+    EXPECT_EQ(lhs[i] - original[i], rhs[i]);
+  }
+}
+
+TEST(ElementwiseTest, BinaryAllAliased) {
+  std::vector<uint32_t> values(kSize0 * kSize1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint32_t>(i);
+  }
+  ASSERT_EQ(0, iree_uk_x32b_addi_2d(values.data(), 0, kSize1, 1,
+                                    values.data(), 0, kSize1, 1,
+                                    values.data(), 0, kSize1, 1, kSize0,
+                                    kSize1));
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(static_cast<uint32_t>(i) * 2u, values[i]);
+  }
+}
+
+TEST(ElementwiseTest, UnaryContiguous) {
+  auto in = MakeF32Matrix(kSize0, kSize1, 1.0f);
+  std::vector<uint32_t> out(kSize0 * kSize1, 0);
+  ASSERT_EQ(0, iree_uk_x32u_negf_2d(in.data(), 0, kSize1, 1, out.data(), 0,
+                                    kSize1, 1, kSize0, kSize1));
+  for (size_t i = 0; i < out.size(); ++i) {
+    EXPECT_EQ(-BitsF32(in[i]), BitsF32(out[i]));
+  }
+}
+
+TEST(ElementwiseTest, UnaryStrided) {
+  std::vector<uint32_t> in(kSize0 * kSize1 * 2);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i] = 1u << (i % 32);
+  }
+  std::vector<uint32_t> out(kSize0 * kSize1, 0);
+  ASSERT_EQ(0, iree_uk_x32u_ctlz_2d(in.data(), 0, kSize1 * 2, 2, out.data(), 0,
+                                    kSize1, 1, kSize0, kSize1));
+  for (int i = 0; i < kSize0; ++i) {
+    for (int j = 0; j < kSize1; ++j) {
+      uint32_t value = in[i * kSize1 * 2 + j * 2];
+      uint32_t expected = 0;
+      while (!(value & 0x80000000u)) {
+        value <<= 1;
+        ++expected;
+      }
+      EXPECT_EQ(expected, out[i * kSize1 + j]);
+    }
+  }
+}
+
+TEST(ElementwiseTest, UnaryInPlace) {
+  auto values = MakeF32Matrix(kSize0, kSize1, 1.25f);
+  auto original = values;
+  ASSERT_EQ(0, iree_uk_x32u_floorf_2d(values.data(), 0, kSize1, 1,
+                                      values.data(), 0, kSize1, 1, kSize0,
+                                      kSize1));
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(std::floor(BitsF32(original[i])), BitsF32(values[i]));
+  }
+}
+
+// Contiguous rows are issued to the architecture-specific row kernels when the
+// CPU supports them while strided outputs always take the generic loops. The
+// results of both must match bit for bit. The row length covers the unrolled
+// vector bodies, single vectors, and masked tails.
+class ElementwiseRowKernelTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { iree_cpu_initialize(iree_allocator_system()); }
+
+  static const int kRowSize0 = 2;
+  static const int kRowSize1 = 71;
+};
+
+// Returns |count| pseudo-random 32-bit values.
+static std::vector<uint32_t> MakeBits(int count, uint32_t seed) {
+  std::vector<uint32_t> values(count);
+  uint32_t state = seed;
+  for (int i = 0; i < count; ++i) {
+    state = state * 1664525u + 1013904223u;
+    values[i] = state;
+  }
+  return values;
+}
+
+// Returns |count| f32 values (as bits) in (|min|, |min| + 200) of both signs
+// unless |positive|, including values with fractional parts.
+static std::vector<uint32_t> MakeF32Values(int count, uint32_t seed, float min,
+                                           bool positive) {
+  auto bits = MakeBits(count, seed);
+  std::vector<uint32_t> values(count);
+  for (int i = 0; i < count; ++i) {
+    float value = min + (bits[i] % 20000u) / 100.0f;
+    if (!positive && (bits[i] & 0x80000000u)) value = -value;
+    values[i] = F32Bits(value);
+  }
+  return values;
+}
+
+struct BinaryCase {
+  const char* name;
+  iree_uk_x32b_2d_func_t func;
+  bool is_float;
+};
+
+TEST_F(ElementwiseRowKernelTest, BinaryMatchesGeneric) {
+  const BinaryCase cases[] = {
+      {"addf", iree_uk_x32b_addf_2d, true},
+      {"addi", iree_uk_x32b_addi_2d, false},
+      {"andi", iree_uk_x32b_andi_2d, false},
+      {"divf", iree_uk_x32b_divf_2d, true},
+      {"mulf", iree_uk_x32b_mulf_2d, true},
+      {"muli", iree_uk_x32b_muli_2d, false},
+      {"ori", iree_uk_x32b_ori_2d, false},
+      {"shli", iree_uk_x32b_shli_2d, false},
+      {"shrsi", iree_uk_x32b_shrsi_2d, false},
+      {"shrui", iree_uk_x32b_shrui_2d, false},
+      {"subf", iree_uk_x32b_subf_2d, true},
+      {"subi", iree_uk_x32b_subi_2d, false},
+      {"xori", iree_uk_x32b_xori_2d, false},
+  };
+  const int count = kRowSize0 * kRowSize1;
+  for (const auto& c : cases) {
+    SCOPED_TRACE(c.name);
+    auto lhs = c.is_float ? MakeF32Values(count, 1, 0.0f, false)
+                          : MakeBits(count, 1);
+    auto rhs = c.is_float ? MakeF32Values(count, 2, 0.5f, false)
+                          : MakeBits(count, 2);
+    if (!c.is_float) {
+      // Keep shift amounts in range.
+      for (auto& value : rhs) value %= 32u;
+    }
+    std::vector<uint32_t> contiguous(count, 0);
+    std::vector<uint32_t> strided(count * 2, 0);
+    ASSERT_EQ(0, c.func(lhs.data(), 0, kRowSize1, 1, rhs.data(), 0, kRowSize1,
+                        1, contiguous.data(), 0, kRowSize1, 1, kRowSize0,
+                        kRowSize1));
+    ASSERT_EQ(0, c.func(lhs.data(), 0, kRowSize1, 1, rhs.data(), 0, kRowSize1,
+                        1, strided.data(), 0, kRowSize1 * 2, 2, kRowSize0,
+                        kRowSize1));
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(strided[i * 2], contiguous[i]) << "at " << i;
+    }
+  }
+}
+
+struct UnaryCase {
+  const char* name;
+  iree_uk_x32u_2d_func_t func;
+  bool positive;
+};
+
+TEST_F(ElementwiseRowKernelTest, UnaryMatchesGeneric) {
+  const UnaryCase cases[] = {
+      {"absf", iree_uk_x32u_absf_2d, false},
+      {"ceilf", iree_uk_x32u_ceilf_2d, false},
+      {"ctlz", iree_uk_x32u_ctlz_2d, false},
+      {"floorf", iree_uk_x32u_floorf_2d, false},
+      {"negf", iree_uk_x32u_negf_2d, false},
+      {"rsqrtf", iree_uk_x32u_rsqrtf_2d, true},
+  };
+  const int count = kRowSize0 * kRowSize1;
+  for (const auto& c : cases) {
+    SCOPED_TRACE(c.name);
+    auto in = MakeF32Values(count, 3, 0.0f, c.positive);
+    // Includes zero.
+    in[count / 2] = 0;
+    std::vector<uint32_t> contiguous(count, 0);
+    std::vector<uint32_t> strided(count * 2, 0);
+    ASSERT_EQ(0, c.func(in.data(), 0, kRowSize1, 1, contiguous.data(), 0,
+                        kRowSize1, 1, kRowSize0, kRowSize1));
+    ASSERT_EQ(0, c.func(in.data(), 0, kRowSize1, 1, strided.data(), 0,
+                        kRowSize1 * 2, 2, kRowSize0, kRowSize1));
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(strided[i * 2], contiguous[i]) << "at " << i;
+    }
+  }
+}
+
+}  // namespace
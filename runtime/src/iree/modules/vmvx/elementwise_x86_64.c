@@ -0,0 +1,177 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/elementwise_internal.h"
+
+// The x86_64 row kernels are only built by CMake, which defines
+// IREE_VMVX_BUILD_X86_64_* for each ISA the toolchain supports. Other builds
+// use the generic loop nests.
+#if defined(IREE_UK_ARCH_X86_64)
+
+#include "iree/modules/vmvx/elementwise_x86_64_internal.h"
+#include "iree/schemas/cpu_data.h"
+
+// Matches iree_uk_cpu_supports_avx2_fma in the x86_64 ukernels such that the
+// same CPUs take the same code paths.
+static inline bool iree_uk_vmvx_cpu_supports_avx2_fma(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX2 |
+                                               IREE_CPU_DATA0_X86_64_FMA |
+                                               IREE_CPU_DATA0_X86_64_F16C);
+}
+
+// Matches iree_uk_cpu_supports_avx512_base in the x86_64 ukernels.
+static inline bool iree_uk_vmvx_cpu_supports_avx512_base(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_vmvx_cpu_supports_avx2_fma(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512F |
+                                               IREE_CPU_DATA0_X86_64_AVX512BW |
+                                               IREE_CPU_DATA0_X86_64_AVX512DQ |
+                                               IREE_CPU_DATA0_X86_64_AVX512VL |
+                                               IREE_CPU_DATA0_X86_64_AVX512CD);
+}
+
+#if defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+static iree_uk_x32b_row_func_t iree_uk_x32b_select_row_func_x86_64_avx2_fma(
+    iree_uk_x32b_opcode_t opcode) {
+  switch (opcode) {
+    case IREE_UK_X32B_ADDF:
+      return iree_uk_x32b_row_addf_x86_64_avx2_fma;
+    case IREE_UK_X32B_ADDI:
+      return iree_uk_x32b_row_addi_x86_64_avx2_fma;
+    case IREE_UK_X32B_ANDI:
+      return iree_uk_x32b_row_andi_x86_64_avx2_fma;
+    case IREE_UK_X32B_DIVF:
+      return iree_uk_x32b_row_divf_x86_64_avx2_fma;
+    case IREE_UK_X32B_MULF:
+      return iree_uk_x32b_row_mulf_x86_64_avx2_fma;
+    case IREE_UK_X32B_MULI:
+      return iree_uk_x32b_row_muli_x86_64_avx2_fma;
+    case IREE_UK_X32B_ORI:
+      return iree_uk_x32b_row_ori_x86_64_avx2_fma;
+    case IREE_UK_X32B_SHLI:
+      return iree_uk_x32b_row_shli_x86_64_avx2_fma;
+    case IREE_UK_X32B_SHRSI:
+      return iree_uk_x32b_row_shrsi_x86_64_avx2_fma;
+    case IREE_UK_X32B_SHRUI:
+      return iree_uk_x32b_row_shrui_x86_64_avx2_fma;
+    case IREE_UK_X32B_SUBF:
+      return iree_uk_x32b_row_subf_x86_64_avx2_fma;
+    case IREE_UK_X32B_SUBI:
+      return iree_uk_x32b_row_subi_x86_64_avx2_fma;
+    case IREE_UKENREL_X32B_XORI:
+      return iree_uk_x32b_row_xori_x86_64_avx2_fma;
+    default:
+      return 0;
+  }
+}
+
+static iree_uk_x32u_row_func_t iree_uk_x32u_select_row_func_x86_64_avx2_fma(
+    iree_uk_x32u_opcode_t opcode) {
+  switch (opcode) {
+    case IREE_UK_X32U_ABSF:
+      return iree_uk_x32u_row_absf_x86_64_avx2_fma;
+    case IREE_UK_X32U_CEILF:
+      return iree_uk_x32u_row_ceilf_x86_64_avx2_fma;
+    case IREE_UK_X32U_FLOORF:
+      return iree_uk_x32u_row_floorf_x86_64_avx2_fma;
+    case IREE_UK_X32U_NEGF:
+      return iree_uk_x32u_row_negf_x86_64_avx2_fma;
+    case IREE_UK_X32U_RSQRTF:
+      return iree_uk_x32u_row_rsqrtf_x86_64_avx2_fma;
+    default:
+      return 0;
+  }
+}
+#endif  // IREE_VMVX_BUILD_X86_64_AVX2_FMA
+
+#if defined(IREE_VMVX_BUILD_X86_64_AVX512_BASE)
+static iree_uk_x32b_row_func_t iree_uk_x32b_select_row_func_x86_64_avx512_base(
+    iree_uk_x32b_opcode_t opcode) {
+  switch (opcode) {
+    case IREE_UK_X32B_ADDF:
+      return iree_uk_x32b_row_addf_x86_64_avx512_base;
+    case IREE_UK_X32B_ADDI:
+      return iree_uk_x32b_row_addi_x86_64_avx512_base;
+    case IREE_UK_X32B_ANDI:
+      return iree_uk_x32b_row_andi_x86_64_avx512_base;
+    case IREE_UK_X32B_DIVF:
+      return iree_uk_x32b_row_divf_x86_64_avx512_base;
+    case IREE_UK_X32B_MULF:
+      return iree_uk_x32b_row_mulf_x86_64_avx512_base;
+    case IREE_UK_X32B_MULI:
+      return iree_uk_x32b_row_muli_x86_64_avx512_base;
+    case IREE_UK_X32B_ORI:
+      return iree_uk_x32b_row_ori_x86_64_avx512_base;
+    case IREE_UK_X32B_SHLI:
+      return iree_uk_x32b_row_shli_x86_64_avx512_base;
+    case IREE_UK_X32B_SHRSI:
+      return iree_uk_x32b_row_shrsi_x86_64_avx512_base;
+    case IREE_UK_X32B_SHRUI:
+      return iree_uk_x32b_row_shrui_x86_64_avx512_base;
+    case IREE_UK_X32B_SUBF:
+      return iree_uk_x32b_row_subf_x86_64_avx512_base;
+    case IREE_UK_X32B_SUBI:
+      return iree_uk_x32b_row_subi_x86_64_avx512_base;
+    case IREE_UKENREL_X32B_XORI:
+      return iree_uk_x32b_row_xori_x86_64_avx512_base;
+    default:
+      return 0;
+  }
+}
+
+static iree_uk_x32u_row_func_t iree_uk_x32u_select_row_func_x86_64_avx512_base(
+    iree_uk_x32u_opcode_t opcode) {
+  switch (opcode) {
+    case IREE_UK_X32U_ABSF:
+      return iree_uk_x32u_row_absf_x86_64_avx512_base;
+    case IREE_UK_X32U_CEILF:
+      return iree_uk_x32u_row_ceilf_x86_64_avx512_base;
+    case IREE_UK_X32U_CTLZ:
+      return iree_uk_x32u_row_ctlz_x86_64_avx512_base;
+    case IREE_UK_X32U_FLOORF:
+      return iree_uk_x32u_row_floorf_x86_64_avx512_base;
+    case IREE_UK_X32U_NEGF:
+      return iree_uk_x32u_row_negf_x86_64_avx512_base;
+    case IREE_UK_X32U_RSQRTF:
+      return iree_uk_x32u_row_rsqrtf_x86_64_avx512_base;
+    default:
+      return 0;
+  }
+}
+#endif  // IREE_VMVX_BUILD_X86_64_AVX512_BASE
+
+iree_uk_x32b_row_func_t iree_uk_x32b_select_row_func_arch(
+    iree_uk_x32b_opcode_t opcode, const iree_uk_uint64_t* cpu_data) {
+#if defined(IREE_VMVX_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_vmvx_cpu_supports_avx512_base(cpu_data)) {
+    return iree_uk_x32b_select_row_func_x86_64_avx512_base(opcode);
+  }
+#endif
+#if defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_vmvx_cpu_supports_avx2_fma(cpu_data)) {
+    return iree_uk_x32b_select_row_func_x86_64_avx2_fma(opcode);
+  }
+#endif
+  return 0;
+}
+
+iree_uk_x32u_row_func_t iree_uk_x32u_select_row_func_arch(
+    iree_uk_x32u_opcode_t opcode, const iree_uk_uint64_t* cpu_data) {
+#if defined(IREE_VMVX_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_vmvx_cpu_supports_avx512_base(cpu_data)) {
+    return iree_uk_x32u_select_row_func_x86_64_avx512_base(opcode);
+  }
+#endif
+#if defined(IREE_VMVX_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_vmvx_cpu_supports_avx2_fma(cpu_data)) {
+    return iree_uk_x32u_select_row_func_x86_64_avx2_fma(opcode);
+  }
+#endif
+  return 0;
+}
+
+#endif  // IREE_UK_ARCH_X86_64
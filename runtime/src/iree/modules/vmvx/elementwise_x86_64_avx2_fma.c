@@ -0,0 +1,124 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/modules/vmvx/elementwise_x86_64_internal.h"
+
+// Returns a mask enabling the first |remaining| (< 8) lanes.
+static inline __m256i iree_uk_avx2_tail_mask(iree_uk_index_t remaining) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)remaining),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Vector ops on 8 x 32-bit lanes. Float ops bitcast their operands such that
+// all row kernels share the same integer loads and stores.
+#define IREE_UK_AVX2_F32_BINARY(name, intrinsic)                       \
+  static inline __m256i iree_uk_avx2_##name(__m256i a, __m256i b) {    \
+    return _mm256_castps_si256(                                        \
+        intrinsic(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));    \
+  }
+IREE_UK_AVX2_F32_BINARY(addf, _mm256_add_ps)
+IREE_UK_AVX2_F32_BINARY(divf, _mm256_div_ps)
+IREE_UK_AVX2_F32_BINARY(mulf, _mm256_mul_ps)
+IREE_UK_AVX2_F32_BINARY(subf, _mm256_sub_ps)
+#define iree_uk_avx2_addi _mm256_add_epi32
+#define iree_uk_avx2_andi _mm256_and_si256
+#define iree_uk_avx2_muli _mm256_mullo_epi32
+#define iree_uk_avx2_ori _mm256_or_si256
+#define iree_uk_avx2_shli _mm256_sllv_epi32
+#define iree_uk_avx2_shrsi _mm256_srav_epi32
+#define iree_uk_avx2_shrui _mm256_srlv_epi32
+#define iree_uk_avx2_subi _mm256_sub_epi32
+#define iree_uk_avx2_xori _mm256_xor_si256
+
+static inline __m256i iree_uk_avx2_absf(__m256i a) {
+  return _mm256_and_si256(a, _mm256_set1_epi32(0x7FFFFFFF));
+}
+static inline __m256i iree_uk_avx2_negf(__m256i a) {
+  return _mm256_xor_si256(a, _mm256_set1_epi32((int)0x80000000u));
+}
+static inline __m256i iree_uk_avx2_ceilf(__m256i a) {
+  return _mm256_castps_si256(
+      _mm256_round_ps(_mm256_castsi256_ps(a),
+                      _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+}
+static inline __m256i iree_uk_avx2_floorf(__m256i a) {
+  return _mm256_castps_si256(
+      _mm256_round_ps(_mm256_castsi256_ps(a),
+                      _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+}
+// Matches the generic 1.0f / sqrtf(a) exactly instead of using the
+// approximate _mm256_rsqrt_ps.
+static inline __m256i iree_uk_avx2_rsqrtf(__m256i a) {
+  return _mm256_castps_si256(_mm256_div_ps(
+      _mm256_set1_ps(1.0f), _mm256_sqrt_ps(_mm256_castsi256_ps(a))));
+}
+
+// Defines a binary row kernel. The tail is handled with masked loads and
+// stores so that no scalar fallback is needed.
+#define IREE_UK_X32B_ROW_AVX2(op)                                          \
+  void iree_uk_x32b_row_##op##_x86_64_avx2_fma(                            \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT lhs,                        \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT rhs,                        \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size) {      \
+    iree_uk_index_t i = 0;                                                 \
+    for (; i + 16 <= size; i += 16) {                                      \
+      __m256i a0 = _mm256_loadu_si256((const __m256i*)(lhs + i));          \
+      __m256i a1 = _mm256_loadu_si256((const __m256i*)(lhs + i + 8));      \
+      __m256i b0 = _mm256_loadu_si256((const __m256i*)(rhs + i));          \
+      __m256i b1 = _mm256_loadu_si256((const __m256i*)(rhs + i + 8));      \
+      _mm256_storeu_si256((__m256i*)(out + i), iree_uk_avx2_##op(a0, b0)); \
+      _mm256_storeu_si256((__m256i*)(out + i + 8),                         \
+                          iree_uk_avx2_##op(a1, b1));                      \
+    }                                                                      \
+    for (; i < size; i += 8) {                                             \
+      __m256i mask = iree_uk_avx2_tail_mask(size - i);                     \
+      __m256i a = _mm256_maskload_epi32((const int*)(lhs + i), mask);      \
+      __m256i b = _mm256_maskload_epi32((const int*)(rhs + i), mask);      \
+      _mm256_maskstore_epi32((int*)(out + i), mask,                        \
+                             iree_uk_avx2_##op(a, b));                     \
+    }                                                                      \
+  }
+
+// Defines a unary row kernel.
+#define IREE_UK_X32U_ROW_AVX2(op)                                             \
+  void iree_uk_x32u_row_##op##_x86_64_avx2_fma(                               \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT in,                            \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size) {         \
+    iree_uk_index_t i = 0;                                                    \
+    for (; i + 16 <= size; i += 16) {                                         \
+      __m256i a0 = _mm256_loadu_si256((const __m256i*)(in + i));              \
+      __m256i a1 = _mm256_loadu_si256((const __m256i*)(in + i + 8));          \
+      _mm256_storeu_si256((__m256i*)(out + i), iree_uk_avx2_##op(a0));        \
+      _mm256_storeu_si256((__m256i*)(out + i + 8), iree_uk_avx2_##op(a1));    \
+    }                                                                         \
+    for (; i < size; i += 8) {                                                \
+      __m256i mask = iree_uk_avx2_tail_mask(size - i);                        \
+      __m256i a = _mm256_maskload_epi32((const int*)(in + i), mask);          \
+      _mm256_maskstore_epi32((int*)(out + i), mask, iree_uk_avx2_##op(a));    \
+    }                                                                         \
+  }
+
+IREE_UK_X32B_ROW_AVX2(addf)
+IREE_UK_X32B_ROW_AVX2(addi)
+IREE_UK_X32B_ROW_AVX2(andi)
+IREE_UK_X32B_ROW_AVX2(divf)
+IREE_UK_X32B_ROW_AVX2(mulf)
+IREE_UK_X32B_ROW_AVX2(muli)
+IREE_UK_X32B_ROW_AVX2(ori)
+IREE_UK_X32B_ROW_AVX2(shli)
+IREE_UK_X32B_ROW_AVX2(shrsi)
+IREE_UK_X32B_ROW_AVX2(shrui)
+IREE_UK_X32B_ROW_AVX2(subf)
+IREE_UK_X32B_ROW_AVX2(subi)
+IREE_UK_X32B_ROW_AVX2(xori)
+
+IREE_UK_X32U_ROW_AVX2(absf)
+IREE_UK_X32U_ROW_AVX2(ceilf)
+IREE_UK_X32U_ROW_AVX2(floorf)
+IREE_UK_X32U_ROW_AVX2(negf)
+IREE_UK_X32U_ROW_AVX2(rsqrtf)
@@ -0,0 +1,122 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <immintrin.h>
+
+#include "iree/modules/vmvx/elementwise_x86_64_internal.h"
+
+// Vector ops on 16 x 32-bit lanes. Float ops bitcast their operands such that
+// all row kernels share the same integer loads and stores.
+#define IREE_UK_AVX512_F32_BINARY(name, intrinsic)                       \
+  static inline __m512i iree_uk_avx512_##name(__m512i a, __m512i b) {    \
+    return _mm512_castps_si512(                                          \
+        intrinsic(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b)));      \
+  }
+IREE_UK_AVX512_F32_BINARY(addf, _mm512_add_ps)
+IREE_UK_AVX512_F32_BINARY(divf, _mm512_div_ps)
+IREE_UK_AVX512_F32_BINARY(mulf, _mm512_mul_ps)
+IREE_UK_AVX512_F32_BINARY(subf, _mm512_sub_ps)
+#define iree_uk_avx512_addi _mm512_add_epi32
+#define iree_uk_avx512_andi _mm512_and_si512
+#define iree_uk_avx512_muli _mm512_mullo_epi32
+#define iree_uk_avx512_ori _mm512_or_si512
+#define iree_uk_avx512_shli _mm512_sllv_epi32
+#define iree_uk_avx512_shrsi _mm512_srav_epi32
+#define iree_uk_avx512_shrui _mm512_srlv_epi32
+#define iree_uk_avx512_subi _mm512_sub_epi32
+#define iree_uk_avx512_xori _mm512_xor_si512
+#define iree_uk_avx512_ctlz _mm512_lzcnt_epi32
+
+static inline __m512i iree_uk_avx512_absf(__m512i a) {
+  return _mm512_and_si512(a, _mm512_set1_epi32(0x7FFFFFFF));
+}
+static inline __m512i iree_uk_avx512_negf(__m512i a) {
+  return _mm512_xor_si512(a, _mm512_set1_epi32((int)0x80000000u));
+}
+static inline __m512i iree_uk_avx512_ceilf(__m512i a) {
+  return _mm512_castps_si512(
+      _mm512_roundscale_ps(_mm512_castsi512_ps(a),
+                           _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+}
+static inline __m512i iree_uk_avx512_floorf(__m512i a) {
+  return _mm512_castps_si512(
+      _mm512_roundscale_ps(_mm512_castsi512_ps(a),
+                           _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+}
+// Matches the generic 1.0f / sqrtf(a) exactly instead of using the
+// approximate _mm512_rsqrt14_ps.
+static inline __m512i iree_uk_avx512_rsqrtf(__m512i a) {
+  return _mm512_castps_si512(_mm512_div_ps(
+      _mm512_set1_ps(1.0f), _mm512_sqrt_ps(_mm512_castsi512_ps(a))));
+}
+
+// Defines a binary row kernel. The tail is handled with masked loads and
+// stores so that no scalar fallback is needed.
+#define IREE_UK_X32B_ROW_AVX512(op)                                        \
+  void iree_uk_x32b_row_##op##_x86_64_avx512_base(                         \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT lhs,                        \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT rhs,                        \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size) {      \
+    iree_uk_index_t i = 0;                                                 \
+    for (; i + 32 <= size; i += 32) {                                      \
+      __m512i a0 = _mm512_loadu_si512(lhs + i);                            \
+      __m512i a1 = _mm512_loadu_si512(lhs + i + 16);                       \
+      __m512i b0 = _mm512_loadu_si512(rhs + i);                            \
+      __m512i b1 = _mm512_loadu_si512(rhs + i + 16);                       \
+      _mm512_storeu_si512(out + i, iree_uk_avx512_##op(a0, b0));           \
+      _mm512_storeu_si512(out + i + 16, iree_uk_avx512_##op(a1, b1));      \
+    }                                                                      \
+    for (; i < size; i += 16) {                                            \
+      __mmask16 mask = (__mmask16)(size - i >= 16                          \
+                                       ? 0xFFFFu                           \
+                                       : (1u << (size - i)) - 1);          \
+      __m512i a = _mm512_maskz_loadu_epi32(mask, lhs + i);                 \
+      __m512i b = _mm512_maskz_loadu_epi32(mask, rhs + i);                 \
+      _mm512_mask_storeu_epi32(out + i, mask, iree_uk_avx512_##op(a, b));  \
+    }                                                                      \
+  }
+
+// Defines a unary row kernel.
+#define IREE_UK_X32U_ROW_AVX512(op)                                        \
+  void iree_uk_x32u_row_##op##_x86_64_avx512_base(                         \
+      const iree_uk_uint32_t* IREE_UK_RESTRICT in,                         \
+      iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t size) {      \
+    iree_uk_index_t i = 0;                                                 \
+    for (; i + 32 <= size; i += 32) {                                      \
+      __m512i a0 = _mm512_loadu_si512(in + i);                             \
+      __m512i a1 = _mm512_loadu_si512(in + i + 16);                        \
+      _mm512_storeu_si512(out + i, iree_uk_avx512_##op(a0));               \
+      _mm512_storeu_si512(out + i + 16, iree_uk_avx512_##op(a1));          \
+    }                                                                      \
+    for (; i < size; i += 16) {                                            \
+      __mmask16 mask = (__mmask16)(size - i >= 16                          \
+                                       ? 0xFFFFu                           \
+                                       : (1u << (size - i)) - 1);          \
+      __m512i a = _mm512_maskz_loadu_epi32(mask, in + i);                  \
+      _mm512_mask_storeu_epi32(out + i, mask, iree_uk_avx512_##op(a));     \
+    }                                                                      \
+  }
+
+IREE_UK_X32B_ROW_AVX512(addf)
+IREE_UK_X32B_ROW_AVX512(addi)
+IREE_UK_X32B_ROW_AVX512(andi)
+IREE_UK_X32B_ROW_AVX512(divf)
+IREE_UK_X32B_ROW_AVX512(mulf)
+IREE_UK_X32B_ROW_AVX512(muli)
+IREE_UK_X32B_ROW_AVX512(ori)
+IREE_UK_X32B_ROW_AVX512(shli)
+IREE_UK_X32B_ROW_AVX512(shrsi)
+IREE_UK_X32B_ROW_AVX512(shrui)
+IREE_UK_X32B_ROW_AVX512(subf)
+IREE_UK_X32B_ROW_AVX512(subi)
+IREE_UK_X32B_ROW_AVX512(xori)
+
+IREE_UK_X32U_ROW_AVX512(absf)
+IREE_UK_X32U_ROW_AVX512(ceilf)
+IREE_UK_X32U_ROW_AVX512(ctlz)
+IREE_UK_X32U_ROW_AVX512(floorf)
+IREE_UK_X32U_ROW_AVX512(negf)
+IREE_UK_X32U_ROW_AVX512(rsqrtf)
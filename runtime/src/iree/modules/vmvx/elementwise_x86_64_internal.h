@@ -0,0 +1,51 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_VMVX_ELEMENTWISE_X86_64_INTERNAL_H_
+#define IREE_MODULES_VMVX_ELEMENTWISE_X86_64_INTERNAL_H_
+
+#include "iree/modules/vmvx/elementwise_internal.h"
+
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_addf_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_addi_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_andi_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_divf_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_mulf_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_muli_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_ori_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shli_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shrsi_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shrui_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_subf_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_subi_x86_64_avx2_fma)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_xori_x86_64_avx2_fma)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_absf_x86_64_avx2_fma)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_ceilf_x86_64_avx2_fma)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_floorf_x86_64_avx2_fma)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_negf_x86_64_avx2_fma)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_rsqrtf_x86_64_avx2_fma)
+
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_addf_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_addi_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_andi_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_divf_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_mulf_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_muli_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_ori_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shli_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shrsi_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_shrui_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_subf_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_subi_x86_64_avx512_base)
+IREE_UK_X32B_ROW_FUNC_DECL(iree_uk_x32b_row_xori_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_absf_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_ceilf_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_ctlz_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_floorf_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_negf_x86_64_avx512_base)
+IREE_UK_X32U_ROW_FUNC_DECL(iree_uk_x32u_row_rsqrtf_x86_64_avx512_base)
+
+#endif  // IREE_MODULES_VMVX_ELEMENTWISE_X86_64_INTERNAL_H_
@@ -315,6 +315,129 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call_by_name(
   return iree_runtime_session_call(session, &function, input_list, output_list);
 }
 
+// Issues one call of a coarse-fences |function| that waits for |semaphore| to
+// reach |wait_value| and signals it to |wait_value| + 1. The fences are
+// appended to |input_list| and removed after the call has been issued. If
+// |input_list| is NULL a temporary list is used to pass the fences.
+static iree_status_t iree_runtime_session_issue_async_call(
+    iree_runtime_session_t* session, const iree_vm_function_t* function,
+    iree_hal_semaphore_t* semaphore, uint64_t wait_value,
+    iree_vm_list_t* input_list, iree_vm_list_t* output_list) {
+  iree_allocator_t host_allocator =
+      iree_runtime_session_host_allocator(session);
+
+  iree_vm_list_t* temp_list = NULL;
+  if (!input_list) {
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                             2, host_allocator, &temp_list));
+    input_list = temp_list;
+  }
+  iree_host_size_t original_size = iree_vm_list_size(input_list);
+
+  // The first call in the batch has nothing to wait on. All others wait on the
+  // call before them such that the semaphore is signaled in order.
+  iree_hal_fence_t* wait_fence = NULL;
+  iree_status_t status = iree_ok_status();
+  if (wait_value > 0) {
+    status = iree_hal_fence_create_at(semaphore, wait_value, host_allocator,
+                                      &wait_fence);
+  }
+  iree_hal_fence_t* signal_fence = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_fence_create_at(semaphore, wait_value + 1,
+                                      host_allocator, &signal_fence);
+  }
+
+  // Append (wait, signal) fences.
+  if (iree_status_is_ok(status)) {
+    iree_vm_ref_t wait_fence_ref = wait_fence
+                                       ? iree_hal_fence_retain_ref(wait_fence)
+                                       : iree_vm_ref_null();
+    status = iree_vm_list_push_ref_move(input_list, &wait_fence_ref);
+    iree_vm_ref_release(&wait_fence_ref);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_vm_ref_t signal_fence_ref = iree_hal_fence_retain_ref(signal_fence);
+    status = iree_vm_list_push_ref_move(input_list, &signal_fence_ref);
+    iree_vm_ref_release(&signal_fence_ref);
+  }
+  iree_hal_fence_release(signal_fence);
+  iree_hal_fence_release(wait_fence);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke(iree_runtime_session_context(session), *function,
+                            IREE_VM_INVOCATION_FLAG_NONE,
+                            /*policy=*/NULL, input_list, output_list,
+                            host_allocator);
+  }
+
+  // Restore the input list so that callers can reuse it.
+  if (temp_list) {
+    iree_vm_list_release(temp_list);
+  } else {
+    iree_status_ignore(iree_vm_list_resize(input_list, original_size));
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_batch(
+    iree_runtime_session_t* session, const iree_vm_function_t* function,
+    iree_host_size_t call_count, iree_vm_list_t* const* input_lists,
+    iree_vm_list_t* const* output_lists) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(function);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, call_count);
+
+  // Async functions can have all calls in flight at once but require a device
+  // to create the fences tracking their completion.
+  iree_hal_device_t* device = iree_runtime_session_device(session);
+  iree_string_view_t model =
+      iree_vm_function_lookup_attr_by_name(function, IREE_SV("iree.abi.model"));
+  if (!device || !iree_string_view_equal(model, IREE_SV("coarse-fences"))) {
+    iree_status_t status = iree_ok_status();
+    for (iree_host_size_t i = 0; i < call_count; ++i) {
+      status = iree_runtime_session_call(
+          session, function, input_lists ? input_lists[i] : NULL,
+          output_lists ? output_lists[i] : NULL);
+      if (!iree_status_is_ok(status)) break;
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Call i signals payload value i + 1 on a single timeline semaphore after
+  // waiting on value i. The host never blocks between calls so issuing later
+  // calls overlaps with the device executing earlier ones and the whole batch
+  // is complete once the last value issued is reached.
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_semaphore_create(device, 0ull, &semaphore));
+
+  iree_status_t status = iree_ok_status();
+  uint64_t issued_value = 0ull;
+  for (iree_host_size_t i = 0; i < call_count; ++i) {
+    status = iree_runtime_session_issue_async_call(
+        session, function, semaphore, issued_value,
+        input_lists ? input_lists[i] : NULL,
+        output_lists ? output_lists[i] : NULL);
+    if (!iree_status_is_ok(status)) break;
+    ++issued_value;
+  }
+
+  // Wait for all issued calls to complete even if one failed to issue as
+  // their outputs may still be in use by the device.
+  if (issued_value > 0) {
+    status = iree_status_join(
+        status, iree_hal_semaphore_wait(semaphore, issued_value,
+                                        iree_infinite_timeout()));
+  }
+
+  iree_hal_semaphore_release(semaphore);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_runtime_session_call_direct(
     iree_runtime_session_t* session, const iree_vm_function_call_t call) {
   IREE_ASSERT_ARGUMENT(session);
@@ -217,6 +217,31 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call_by_name(
     iree_runtime_session_t* session, iree_string_view_t full_name,
     iree_vm_list_t* input_list, iree_vm_list_t* output_list);
 
+// Synchronously issues |call_count| calls to the same |function|.
+//
+// |input_lists| and |output_lists| contain one list per call with the same
+// semantics as iree_runtime_session_call; either array or any list within
+// it may be NULL if the function has no inputs or outputs. List ownership
+// remains with the caller and lists can be reused across batches to avoid
+// per-call allocations.
+//
+// Functions using the asynchronous `coarse-fences` ABI model are issued
+// back-to-back without waiting such that the host can issue later calls while
+// the device executes earlier ones. The session appends a wait and signal
+// fence on a single timeline semaphore to each input list: call i waits on
+// payload value i and signals i + 1 so device work completes in issue order.
+// A single wait on the last value issued completes the batch. The appended
+// fences are removed from the input lists before returning and calls with a
+// NULL input list are given a temporary list to carry their fences.
+// Synchronous functions are invoked in order.
+//
+// Calls are issued in order and the first failure is returned after all
+// previously issued calls have completed; subsequent calls are not issued.
+IREE_API_EXPORT iree_status_t iree_runtime_session_call_batch(
+    iree_runtime_session_t* session, const iree_vm_function_t* function,
+    iree_host_size_t call_count, iree_vm_list_t* const* input_lists,
+    iree_vm_list_t* const* output_lists);
+
 // Synchronously issues a direct function call.
 // This bypasses signature verification and directly calls through the VM ABI.
 // Though still safe(ish) the errors reported on a signature mismatch will be
@@ -0,0 +1,227 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/session.h"
+
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/modules/hal/types.h"
+#include "iree/runtime/instance.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace iree {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// deferred_module
+//===----------------------------------------------------------------------===//
+// A native module exporting a coarse-fences function that holds on to the
+// fences of each call and only processes them once all calls expected in a
+// batch have been issued. Like a device queue the calls are then processed in
+// issue order and each must find its wait fence already satisfied by the
+// calls before it.
+
+// (wait, signal) fences of a deferred call. The wait fence may be NULL.
+typedef std::pair<iree_hal_fence_t*, iree_hal_fence_t*> deferred_call_t;
+
+// Number of calls that must be issued before any are processed.
+static iree_host_size_t deferred_call_count = 0;
+// Fences of all calls issued so far.
+static std::vector<deferred_call_t>* deferred_calls = nullptr;
+
+// vm.import @deferred.call(%wait : !hal.fence, %signal : !hal.fence)
+static iree_status_t deferred_module_call(
+    iree_vm_stack_t* stack, iree_vm_native_function_flags_t flags,
+    iree_byte_span_t args_storage, iree_byte_span_t rets_storage,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state) {
+  if (args_storage.data_length != sizeof(iree_vm_abi_rr_t)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "argument signature mismatch");
+  }
+  // Like bytecode functions the call takes ownership of its arguments.
+  iree_vm_abi_rr_t* args = (iree_vm_abi_rr_t*)args_storage.data;
+  iree_hal_fence_t* wait_fence = iree_hal_fence_deref(args->r0);
+  iree_hal_fence_t* signal_fence = NULL;
+  iree_status_t status = iree_hal_fence_check_deref(args->r1, &signal_fence);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_ref_release(&args->r0);
+    iree_vm_ref_release(&args->r1);
+    return status;
+  }
+  args->r0 = iree_vm_ref_null();
+  args->r1 = iree_vm_ref_null();
+  deferred_calls->push_back(std::make_pair(wait_fence, signal_fence));
+  if (deferred_calls->size() > 1) {
+    // Nothing has been signaled yet so calls chained onto the ones before
+    // them can't be ready.
+    status = iree_hal_fence_query(wait_fence);
+    if (iree_status_is_ok(status)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "call does not wait on the call before it");
+    }
+    iree_status_ignore(status);
+    status = iree_ok_status();
+  }
+  if (deferred_calls->size() < deferred_call_count) {
+    return iree_ok_status();
+  }
+  for (auto& call : *deferred_calls) {
+    if (iree_status_is_ok(status)) status = iree_hal_fence_query(call.first);
+    if (iree_status_is_ok(status)) status = iree_hal_fence_signal(call.second);
+    iree_hal_fence_release(call.first);
+    iree_hal_fence_release(call.second);
+  }
+  deferred_calls->clear();
+  return status;
+}
+
+static const iree_string_pair_t deferred_module_call_attrs_[] = {
+    {{IREE_SVL("iree.abi.model")}, {IREE_SVL("coarse-fences")}},
+};
+static const iree_vm_native_export_descriptor_t deferred_module_exports_[] = {
+    {IREE_SVL("call"), IREE_SVL("0rr_v"),
+     IREE_ARRAYSIZE(deferred_module_call_attrs_), deferred_module_call_attrs_},
+};
+static const iree_vm_native_function_ptr_t deferred_module_funcs_[] = {
+    {deferred_module_call, /*target=*/NULL},
+};
+static const iree_vm_native_module_descriptor_t deferred_module_descriptor_ = {
+    /*name=*/IREE_SVL("deferred"),
+    /*version=*/0,
+    /*attr_count=*/0,
+    /*attrs=*/NULL,
+    /*dependency_count=*/0,
+    /*dependencies=*/NULL,
+    /*import_count=*/0,
+    /*imports=*/NULL,
+    /*export_count=*/IREE_ARRAYSIZE(deferred_module_exports_),
+    /*exports=*/deferred_module_exports_,
+    /*function_count=*/IREE_ARRAYSIZE(deferred_module_funcs_),
+    /*functions=*/deferred_module_funcs_,
+};
+
+static iree_status_t deferred_module_create(iree_vm_instance_t* instance,
+                                            iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(&interface, &deferred_module_descriptor_,
+                                      instance, allocator, out_module);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_session_call_batch
+//===----------------------------------------------------------------------===//
+
+class SessionCallBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_runtime_instance_options_t instance_options;
+    iree_runtime_instance_options_initialize(&instance_options);
+    iree_runtime_instance_options_use_all_available_drivers(&instance_options);
+    IREE_ASSERT_OK(iree_runtime_instance_create(
+        &instance_options, iree_allocator_system(), &instance_));
+    iree_status_t status = iree_runtime_instance_try_create_default_device(
+        instance_, IREE_SV("local-sync"), &device_);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      GTEST_SKIP() << "local-sync driver not available";
+    }
+
+    iree_runtime_session_options_t session_options;
+    iree_runtime_session_options_initialize(&session_options);
+    IREE_ASSERT_OK(iree_runtime_session_create_with_device(
+        instance_, &session_options, device_,
+        iree_runtime_instance_host_allocator(instance_), &session_));
+    iree_vm_module_t* module = NULL;
+    IREE_ASSERT_OK(deferred_module_create(
+        iree_runtime_instance_vm_instance(instance_), iree_allocator_system(),
+        &module));
+    iree_status_t append_status =
+        iree_runtime_session_append_module(session_, module);
+    iree_vm_module_release(module);
+    IREE_ASSERT_OK(append_status);
+    IREE_ASSERT_OK(iree_runtime_session_lookup_function(
+        session_, IREE_SV("deferred.call"), &function_));
+
+    deferred_calls = &calls_;
+  }
+
+  void TearDown() override {
+    deferred_calls = nullptr;
+    for (auto& call : calls_) {
+      iree_hal_fence_release(call.first);
+      iree_hal_fence_release(call.second);
+    }
+    for (auto* list : input_lists_) iree_vm_list_release(list);
+    iree_runtime_session_release(session_);
+    iree_hal_device_release(device_);
+    iree_runtime_instance_release(instance_);
+  }
+
+  // Issues a batch of |call_count| calls with empty input lists.
+  iree_status_t CallBatch(iree_host_size_t call_count) {
+    for (iree_host_size_t i = input_lists_.size(); i < call_count; ++i) {
+      iree_vm_list_t* list = NULL;
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_create(iree_vm_make_undefined_type_def(), 2,
+                              iree_allocator_system(), &list));
+      input_lists_.push_back(list);
+    }
+    return iree_runtime_session_call_batch(session_, &function_, call_count,
+                                           input_lists_.data(),
+                                           /*output_lists=*/NULL);
+  }
+
+  iree_runtime_instance_t* instance_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_runtime_session_t* session_ = NULL;
+  iree_vm_function_t function_;
+  std::vector<iree_vm_list_t*> input_lists_;
+  std::vector<deferred_call_t> calls_;
+};
+
+// The last call processes all calls, each of which must have been chained
+// onto the signal of the call before it.
+TEST_F(SessionCallBatchTest, ChainedCompletion) {
+  deferred_call_count = 4;
+  IREE_ASSERT_OK(CallBatch(deferred_call_count));
+  EXPECT_TRUE(calls_.empty());
+  // Fences appended by the batch are removed from the input lists.
+  for (auto* list : input_lists_) EXPECT_EQ(0, iree_vm_list_size(list));
+}
+
+// Batches can be issued repeatedly with the same input lists.
+TEST_F(SessionCallBatchTest, ReusedInputLists) {
+  deferred_call_count = 3;
+  IREE_ASSERT_OK(CallBatch(deferred_call_count));
+  IREE_ASSERT_OK(CallBatch(deferred_call_count));
+  EXPECT_TRUE(calls_.empty());
+}
+
+TEST_F(SessionCallBatchTest, SingleCall) {
+  deferred_call_count = 1;
+  IREE_ASSERT_OK(CallBatch(deferred_call_count));
+  EXPECT_TRUE(calls_.empty());
+}
+
+// Calls without input lists are given temporary lists to carry their fences.
+TEST_F(SessionCallBatchTest, NullInputLists) {
+  deferred_call_count = 2;
+  IREE_ASSERT_OK(iree_runtime_session_call_batch(
+      session_, &function_, deferred_call_count, /*input_lists=*/NULL,
+      /*output_lists=*/NULL));
+  EXPECT_TRUE(calls_.empty());
+}
+
+}  // namespace
+}  // namespace iree
@@ -76,7 +76,14 @@ IREE_FLAG(
     "   All threads will be unpinned and run on system-determined processors.\n"
     " 'physical_cores':\n"
     "   Creates one group per physical core in each NUMA node up to\n"
-    "   the value specified by --task_topology_max_group_count=.");
+    "   the value specified by --task_topology_max_group_count=. On hybrid\n"
+    "   systems work is weighted by the relative throughput of each core.\n"
+    " 'performance_cores':\n"
+    "   Like 'physical_cores' but only uses the high-performance cores of\n"
+    "   hybrid systems (Intel P-cores, Arm big cores).\n"
+    " 'efficiency_cores':\n"
+    "   Like 'physical_cores' but only uses the power-efficient cores of\n"
+    "   hybrid systems (Intel E-cores, Arm LITTLE cores).");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -160,6 +167,16 @@ iree_status_t iree_task_topology_initialize_from_flags(
     // Physical cores sourced from a specific NUMA node.
     return iree_task_topology_initialize_from_physical_cores(
         node_id, FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "performance_cores") == 0) {
+    // Only performance cores sourced from a specific NUMA node.
+    return iree_task_topology_initialize_from_physical_cores_of_class(
+        node_id, IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE,
+        FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "efficiency_cores") == 0) {
+    // Only efficiency cores sourced from a specific NUMA node.
+    return iree_task_topology_initialize_from_physical_cores_of_class(
+        node_id, IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY,
+        FLAG_task_topology_max_group_count, out_topology);
   } else {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -214,6 +231,8 @@ static iree_status_t iree_task_flags_dump_task_topologies(
       const iree_task_topology_group_t* group = &topology.groups[j];
       fprintf(stdout, "# group[%d]: '%s'\n", group->group_index, group->name);
       fprintf(stdout, "#      processor: %u\n", group->processor_index);
+      fprintf(stdout, "#     throughput: %u/%u\n", group->throughput,
+              IREE_TASK_TOPOLOGY_MAX_THROUGHPUT);
       fprintf(stdout, "#       affinity: ");
       if (group->ideal_thread_affinity.specified) {
         fprintf(stdout, "group=%u, id=%u, smt=%u",
@@ -8,6 +8,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/internal/debugging.h"
@@ -29,6 +30,29 @@ void iree_task_executor_options_initialize(
   memset(out_options, 0, sizeof(*out_options));
 }
 
+// Registers the executor counters in the default metrics registry, if any.
+static iree_status_t iree_task_executor_initialize_metrics(
+    iree_task_executor_t* executor) {
+  iree_metrics_registry_t* registry = iree_metrics_registry_default();
+  if (!registry) return iree_ok_status();
+  static iree_atomic_int32_t executor_id = IREE_ATOMIC_VAR_INIT(0);
+  char labels[32];
+  int labels_length =
+      snprintf(labels, sizeof(labels), "executor=\"%d\"",
+               iree_atomic_fetch_add_int32(&executor_id, 1,
+                                           iree_memory_order_relaxed));
+  IREE_RETURN_IF_ERROR(iree_metrics_registry_lookup_or_create(
+      registry, IREE_METRIC_TYPE_COUNTER, IREE_SV("iree_task_worker_wakes"),
+      iree_make_string_view(labels, labels_length),
+      IREE_SV("Number of times executor workers woke from waiting for work."),
+      &executor->worker_wake_metric));
+  return iree_metrics_registry_lookup_or_create(
+      registry, IREE_METRIC_TYPE_COUNTER, IREE_SV("iree_task_steals"),
+      iree_make_string_view(labels, labels_length),
+      IREE_SV("Number of successful task thefts between executor workers."),
+      &executor->steal_metric);
+}
+
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
                                         const iree_task_topology_t* topology,
                                         iree_allocator_t allocator,
@@ -81,6 +105,18 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   executor->worker_spin_ns = options.worker_spin_ns;
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
+  iree_slim_mutex_initialize(&executor->partition_mutex);
+
+  // All workers start in the default partition.
+  iree_task_partition_t* default_partition = &executor->default_partition;
+  iree_atomic_ref_count_init(&default_partition->ref_count);
+  default_partition->executor = executor;
+  iree_string_view_t default_partition_name = IREE_SV("default");
+  memcpy(default_partition->name, default_partition_name.data,
+         default_partition_name.size);
+  iree_atomic_task_affinity_set_store(&default_partition->worker_mask,
+                                      iree_task_affinity_set_ones(worker_count),
+                                      iree_memory_order_relaxed);
 
   IREE_TRACE({
     static iree_atomic_int32_t executor_id = IREE_ATOMIC_VAR_INIT(0);
@@ -99,6 +135,8 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
     IREE_TRACE_PLOT_VALUE_F32(executor->trace_name, 0.0f);
   });
 
+  iree_status_t status = iree_task_executor_initialize_metrics(executor);
+
   // Simple PRNG used to generate seeds for the per-worker PRNGs used to
   // distribute work. This isn't strong (and doesn't need to be); it's just
   // enough to ensure each worker gets a sufficiently random seed for itself to
@@ -111,8 +149,6 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(&seed_prng),
                                   &executor->donation_theft_prng);
 
-  iree_status_t status = iree_ok_status();
-
   // Pool used for system events; exposed to users of the task system to ensure
   // we minimize the number of live events and reduce overheads in
   // high-frequency transient parking operations.
@@ -221,6 +257,7 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
   iree_task_poller_deinitialize(&executor->poller);
 
   iree_event_pool_free(executor->event_pool);
+  iree_slim_mutex_deinitialize(&executor->partition_mutex);
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
   iree_atomic_task_slist_deinitialize(&executor->incoming_ready_slist);
   iree_task_pool_deinitialize(&executor->transient_task_pool);
@@ -275,6 +312,180 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
   return iree_ok_status();
 }
 
+//==============================================================================
+// Executor partitions
+//==============================================================================
+
+// Moves the workers in |worker_mask| into |partition| and updates the theft
+// masks of all workers.
+//
+// Expects the executor partition_mutex to be held.
+static void iree_task_executor_move_workers(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_affinity_set_t worker_mask) {
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    if (!(worker_mask & worker->worker_bit)) continue;
+    iree_task_partition_t* old_partition = worker->partition;
+    if (old_partition == partition) continue;
+    iree_atomic_task_affinity_set_fetch_and(&old_partition->worker_mask,
+                                            ~worker->worker_bit,
+                                            iree_memory_order_relaxed);
+    iree_atomic_task_affinity_set_fetch_or(&partition->worker_mask,
+                                           worker->worker_bit,
+                                           iree_memory_order_relaxed);
+    worker->partition = partition;
+  }
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    iree_atomic_task_affinity_set_store(
+        &worker->partition_mask,
+        iree_atomic_task_affinity_set_load(&worker->partition->worker_mask,
+                                           iree_memory_order_relaxed),
+        iree_memory_order_relaxed);
+  }
+}
+
+static iree_status_t iree_task_executor_verify_worker_mask(
+    iree_task_executor_t* executor, iree_task_affinity_set_t worker_mask) {
+  iree_task_affinity_set_t valid_mask =
+      iree_task_affinity_set_ones(executor->worker_count);
+  if (IREE_UNLIKELY(worker_mask & ~valid_mask)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "worker mask 0x%016" PRIx64
+                            " references workers outside of the %" PRIhsz
+                            " executor workers",
+                            worker_mask, executor->worker_count);
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_task_executor_create_partition(
+    iree_task_executor_t* executor, iree_string_view_t name,
+    iree_task_affinity_set_t worker_mask,
+    iree_task_partition_t** out_partition) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(out_partition);
+  *out_partition = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_task_executor_verify_worker_mask(executor, worker_mask));
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, name.data, name.size);
+
+  iree_task_partition_t* partition = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(executor->allocator, sizeof(*partition),
+                                (void**)&partition));
+  memset(partition, 0, sizeof(*partition));
+  iree_atomic_ref_count_init(&partition->ref_count);
+  partition->executor = executor;
+  iree_task_executor_retain(executor);
+  iree_host_size_t name_length =
+      iree_min(name.size, IREE_ARRAYSIZE(partition->name) - 1);
+  memcpy(partition->name, name.data, name_length);
+
+  iree_slim_mutex_lock(&executor->partition_mutex);
+  iree_task_executor_move_workers(executor, partition, worker_mask);
+  iree_slim_mutex_unlock(&executor->partition_mutex);
+
+  *out_partition = partition;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_task_partition_destroy(iree_task_partition_t* partition) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_task_executor_t* executor = partition->executor;
+
+  // Return all workers to the default partition.
+  iree_slim_mutex_lock(&executor->partition_mutex);
+  iree_task_executor_move_workers(
+      executor, &executor->default_partition,
+      iree_atomic_task_affinity_set_load(&partition->worker_mask,
+                                         iree_memory_order_relaxed));
+  iree_slim_mutex_unlock(&executor->partition_mutex);
+
+  iree_allocator_free(executor->allocator, partition);
+  iree_task_executor_release(executor);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_task_partition_retain(iree_task_partition_t* partition) {
+  if (partition) {
+    iree_atomic_ref_count_inc(&partition->ref_count);
+  }
+}
+
+void iree_task_partition_release(iree_task_partition_t* partition) {
+  if (partition && iree_atomic_ref_count_dec(&partition->ref_count) == 1) {
+    iree_task_partition_destroy(partition);
+  }
+}
+
+iree_task_executor_t* iree_task_partition_executor(
+    const iree_task_partition_t* partition) {
+  IREE_ASSERT_ARGUMENT(partition);
+  return partition->executor;
+}
+
+iree_status_t iree_task_executor_assign_workers(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_affinity_set_t worker_mask) {
+  IREE_ASSERT_ARGUMENT(executor);
+  if (!partition) partition = &executor->default_partition;
+  if (IREE_UNLIKELY(partition->executor != executor)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "partition belongs to a different executor");
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_task_executor_verify_worker_mask(executor, worker_mask));
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, partition->name);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, iree_task_affinity_set_count_ones(worker_mask));
+
+  iree_slim_mutex_lock(&executor->partition_mutex);
+  iree_task_executor_move_workers(executor, partition, worker_mask);
+  iree_slim_mutex_unlock(&executor->partition_mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_task_executor_query_partition(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_partition_statistics_t* out_statistics) {
+  if (!partition) partition = &executor->default_partition;
+  memset(out_statistics, 0, sizeof(*out_statistics));
+
+  // The masks are accessed with 'relaxed' order because they are just hints.
+  iree_task_affinity_set_t worker_mask = iree_atomic_task_affinity_set_load(
+      &partition->worker_mask, iree_memory_order_relaxed);
+  iree_task_affinity_set_t worker_idle_mask =
+      iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
+                                         iree_memory_order_relaxed);
+  out_statistics->worker_mask = worker_mask;
+  out_statistics->worker_count = iree_task_affinity_set_count_ones(worker_mask);
+  out_statistics->busy_worker_count =
+      iree_task_affinity_set_count_ones(worker_mask & ~worker_idle_mask);
+
+  // Walking the worker queues is slow but queries are expected to be
+  // infrequent (on the order of the rebalancing they inform).
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_t* worker = &executor->workers[i];
+    if (!(worker_mask & worker->worker_bit)) continue;
+    out_statistics->queued_task_count +=
+        iree_task_worker_queued_task_count(worker);
+  }
+
+  out_statistics->scheduled_task_count = (uint64_t)iree_atomic_load_int64(
+      &partition->scheduled_task_count, iree_memory_order_relaxed);
+  out_statistics->dispatch_count = (uint64_t)iree_atomic_load_int64(
+      &partition->dispatch_count, iree_memory_order_relaxed);
+  out_statistics->dispatch_tile_count = (uint64_t)iree_atomic_load_int64(
+      &partition->dispatch_tile_count, iree_memory_order_relaxed);
+}
+
 // Schedules a generic task to a worker matching its affinity.
 // The task will be posted to the worker mailbox and available for the worker to
 // begin processing as soon as the |post_batch| is submitted.
@@ -282,17 +493,127 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
 // Only called during coordination and expects the coordinator lock to be held.
 static void iree_task_executor_relay_to_worker(
     iree_task_executor_t* executor, iree_task_post_batch_t* post_batch,
-    iree_task_t* task) {
+    iree_task_affinity_set_t worker_mask, iree_task_t* task) {
   iree_host_size_t worker_index =
-      iree_task_post_batch_select_worker(post_batch, task->affinity_set);
+      iree_task_post_batch_select_worker(post_batch, worker_mask);
   iree_task_post_batch_enqueue(post_batch, worker_index, task);
 }
 
+// Returns the partition |task| is scheduled on.
+static iree_task_partition_t* iree_task_executor_task_partition(
+    iree_task_executor_t* executor, iree_task_t* task) {
+  iree_task_partition_t* partition = task->scope->partition;
+  if (!partition) return &executor->default_partition;
+  IREE_ASSERT_EQ(partition->executor, executor,
+                 "scope partition must be from the executor it submits to");
+  return partition;
+}
+
+// Returns the set of workers that |task| may be scheduled on based on its
+// affinity and the workers assigned to its |partition|. If the partition has no
+// usable workers the task may be scheduled on any worker in its affinity set so
+// that it still makes forward progress. Always returns a non-empty subset of
+// the live workers.
+static iree_task_affinity_set_t iree_task_executor_task_worker_mask(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_t* task) {
+  // The masks are accessed with 'relaxed' order because they are just hints.
+  iree_task_affinity_set_t worker_live_mask =
+      iree_atomic_task_affinity_set_load(&executor->worker_live_mask,
+                                         iree_memory_order_relaxed);
+  iree_task_affinity_set_t affinity_set = task->affinity_set & worker_live_mask;
+  iree_task_affinity_set_t worker_mask =
+      affinity_set & iree_atomic_task_affinity_set_load(
+                         &partition->worker_mask, iree_memory_order_relaxed);
+  if (worker_mask) return worker_mask;
+  return affinity_set ? affinity_set : worker_live_mask;
+}
+
+// Schedules a single ready |task| as part of
+// iree_task_executor_schedule_ready_tasks.
+//
+// Only called during coordination and expects the coordinator lock to be held.
+static void iree_task_executor_schedule_ready_task(
+    iree_task_executor_t* executor, iree_task_t* task,
+    iree_task_submission_t* pending_submission,
+    iree_task_post_batch_t* post_batch) {
+  switch (task->type) {
+    case IREE_TASK_TYPE_NOP:
+      // Doesn't do anything; just retire and continue on to any dependents.
+      iree_task_nop_retire((iree_task_nop_t*)task, pending_submission);
+      break;
+    case IREE_TASK_TYPE_CALL: {
+      // Generic routing to workers for tasks that should always run there.
+      iree_task_partition_t* partition =
+          iree_task_executor_task_partition(executor, task);
+      iree_task_executor_relay_to_worker(
+          executor, post_batch,
+          iree_task_executor_task_worker_mask(executor, partition, task),
+          task);
+      iree_atomic_fetch_add_int64(&partition->scheduled_task_count, 1,
+                                  iree_memory_order_relaxed);
+      break;
+    }
+    case IREE_TASK_TYPE_BARRIER: {
+      // Retire the barrier to (possibly) ready up all dependent tasks.
+      // This acts as a fan-out in cases where the dependent task count >1.
+      iree_task_barrier_retire((iree_task_barrier_t*)task, pending_submission);
+      break;
+    }
+    case IREE_TASK_TYPE_FENCE: {
+      // Scope fence hit; notifies the scope so that anyone waiting on the
+      // fence can be notified without us having to do so explicitly.
+      iree_task_fence_retire((iree_task_fence_t*)task, pending_submission);
+      break;
+    }
+    case IREE_TASK_TYPE_WAIT: {
+      // We should only ever see completed waits here; ones that have yet to
+      // resolve are sent to the poller.
+      iree_task_wait_retire(
+          (iree_task_wait_t*)task, pending_submission,
+          iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_COMPLETED)
+              ? iree_ok_status()
+              : iree_make_status(IREE_STATUS_INTERNAL,
+                                 "unresolved wait task ended up in the "
+                                 "executor run queue"));
+      break;
+    }
+    case IREE_TASK_TYPE_DISPATCH: {
+      // Dispatches may need to be issued (fanning out the tiles to workers)
+      // or retired (after all tiles have completed).
+      if (task->flags & IREE_TASK_FLAG_DISPATCH_RETIRE) {
+        iree_task_dispatch_retire((iree_task_dispatch_t*)task,
+                                  pending_submission);
+      } else {
+        iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+        iree_task_partition_t* partition =
+            iree_task_executor_task_partition(executor, task);
+        iree_task_dispatch_issue(
+            dispatch_task, &executor->transient_task_pool,
+            iree_task_executor_task_worker_mask(executor, partition, task),
+            pending_submission, post_batch);
+        iree_atomic_fetch_add_int64(&partition->scheduled_task_count, 1,
+                                    iree_memory_order_relaxed);
+        iree_atomic_fetch_add_int64(&partition->dispatch_count, 1,
+                                    iree_memory_order_relaxed);
+        iree_atomic_fetch_add_int64(&partition->dispatch_tile_count,
+                                    dispatch_task->tile_count,
+                                    iree_memory_order_relaxed);
+      }
+      break;
+    }
+  }
+}
+
 // Schedules all ready tasks in the |pending_submission| list.
 // Task may enqueue zero or more new tasks (or newly-ready/waiting tasks) to
 // |pending_submission| or queue work for posting to workers via the
 // |post_batch|.
 //
+// Tasks are scheduled in priority order so that the most urgent tasks are the
+// first to be assigned to idle workers. Tasks readied while scheduling (such as
+// the dependents of a retired barrier) are scheduled in a subsequent pass.
+//
 // NOTE: the pending submission list we walk here is in FIFO order and the
 // post batch we are building is in LIFO; this means that as we pop off the
 // least recently added tasks from the submission (nice in-order traversal) we
@@ -303,67 +624,33 @@ void iree_task_executor_schedule_ready_tasks(
     iree_task_executor_t* executor, iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_task_t* task = NULL;
-  while ((task = iree_task_list_pop_front(&pending_submission->ready_list))) {
-    // If the scope has been marked as failing then we abort the task.
-    // This needs to happen as a poll here because one or more of the tasks we
-    // are joining may have failed.
-    if (IREE_UNLIKELY(!task->scope ||
-                      iree_task_scope_has_failed(task->scope))) {
-      iree_task_list_t discard_worklist;
-      iree_task_list_initialize(&discard_worklist);
-      iree_task_discard(task, &discard_worklist);
-      iree_task_list_discard(&discard_worklist);
-      continue;
+  while (!iree_task_list_is_empty(&pending_submission->ready_list)) {
+    // Partition the ready tasks by priority preserving their relative order.
+    iree_task_list_t priority_lists[IREE_TASK_PRIORITY_COUNT];
+    for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+      iree_task_list_initialize(&priority_lists[i]);
     }
-
-    switch (task->type) {
-      case IREE_TASK_TYPE_NOP:
-        // Doesn't do anything; just retire and continue on to any dependents.
-        iree_task_nop_retire((iree_task_nop_t*)task, pending_submission);
-        break;
-      case IREE_TASK_TYPE_CALL: {
-        // Generic routing to workers for tasks that should always run there.
-        iree_task_executor_relay_to_worker(executor, post_batch, task);
-        break;
+    iree_task_t* task = NULL;
+    while ((task = iree_task_list_pop_front(&pending_submission->ready_list))) {
+      // If the scope has been marked as failing then we abort the task.
+      // This needs to happen as a poll here because one or more of the tasks
+      // we are joining may have failed.
+      if (IREE_UNLIKELY(!task->scope ||
+                        iree_task_scope_has_failed(task->scope))) {
+        iree_task_list_t discard_worklist;
+        iree_task_list_initialize(&discard_worklist);
+        iree_task_discard(task, &discard_worklist);
+        iree_task_list_discard(&discard_worklist);
+        continue;
       }
-      case IREE_TASK_TYPE_BARRIER: {
-        // Retire the barrier to (possibly) ready up all dependent tasks.
-        // This acts as a fan-out in cases where the dependent task count >1.
-        iree_task_barrier_retire((iree_task_barrier_t*)task,
-                                 pending_submission);
-        break;
-      }
-      case IREE_TASK_TYPE_FENCE: {
-        // Scope fence hit; notifies the scope so that anyone waiting on the
-        // fence can be notified without us having to do so explicitly.
-        iree_task_fence_retire((iree_task_fence_t*)task, pending_submission);
-        break;
-      }
-      case IREE_TASK_TYPE_WAIT: {
-        // We should only ever see completed waits here; ones that have yet to
-        // resolve are sent to the poller.
-        iree_task_wait_retire(
-            (iree_task_wait_t*)task, pending_submission,
-            iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_COMPLETED)
-                ? iree_ok_status()
-                : iree_make_status(IREE_STATUS_INTERNAL,
-                                   "unresolved wait task ended up in the "
-                                   "executor run queue"));
-        break;
-      }
-      case IREE_TASK_TYPE_DISPATCH: {
-        // Dispatches may need to be issued (fanning out the tiles to workers)
-        // or retired (after all tiles have completed).
-        if (task->flags & IREE_TASK_FLAG_DISPATCH_RETIRE) {
-          iree_task_dispatch_retire((iree_task_dispatch_t*)task,
-                                    pending_submission);
-        } else {
-          iree_task_dispatch_issue((iree_task_dispatch_t*)task,
-                                   &executor->transient_task_pool,
-                                   pending_submission, post_batch);
-        }
-        break;
+      iree_task_list_push_back(&priority_lists[iree_task_priority(task)],
+                               task);
+    }
+
+    for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+      while ((task = iree_task_list_pop_front(&priority_lists[i]))) {
+        iree_task_executor_schedule_ready_task(executor, task,
+                                               pending_submission, post_batch);
       }
     }
   }
@@ -494,7 +781,7 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
     uint32_t max_theft_attempts, int rotation_offset,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_queue_t* local_task_queues) {
   if (!victim_mask) return NULL;
   max_theft_attempts = iree_min(max_theft_attempts,
                                 iree_task_affinity_set_count_ones(victim_mask));
@@ -533,7 +820,7 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     // thievery taking ~half of the tasks each time (across all queues) will
     // lead to a relatively even distribution.
     iree_task_t* task = iree_task_worker_try_steal_task(
-        victim_worker, local_task_queue,
+        victim_worker, local_task_queues,
         /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
     if (task) return task;
   }
@@ -544,7 +831,7 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the |local_task_queues|.
 //
 // We do a scan through ideal victims indicated by the
 // |constructive_sharing_mask|; these are the workers most likely to have some
@@ -559,8 +846,9 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_affinity_set_t partition_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -571,8 +859,9 @@ iree_task_t* iree_task_executor_try_steal_task(
       iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
                                          iree_memory_order_relaxed);
   // Limit the workers we will steal from to the ones that are currently live
-  // and not idle.
-  iree_task_affinity_set_t victim_mask = worker_live_mask & ~worker_idle_mask;
+  // and not idle within our own partition.
+  iree_task_affinity_set_t victim_mask =
+      worker_live_mask & ~worker_idle_mask & partition_mask;
 
   // TODO(benvanik): it may be possible to rework this such that we better
   // use the prng; for example, instead of all this rotating stuff we could just
@@ -588,17 +877,18 @@ iree_task_t* iree_task_executor_try_steal_task(
   // event that the thief and victim are running close to each other in time.
   iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
       executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
+      rotation_offset, local_task_queues);
   if (task) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
   } else {
     task = iree_task_executor_try_steal_task_from_affinity_set(
         executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+        rotation_offset, local_task_queues);
     if (task) {
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
     }
   }
+  if (task) iree_metric_add(executor->steal_metric, 1);
 
   IREE_TRACE_ZONE_END(z0);
   return task;
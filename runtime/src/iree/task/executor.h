@@ -122,9 +122,9 @@ extern "C" {
 //      FIFO task queue. This centralizes enqueuing from all threads into a
 //      single ordered list.
 //
-//   b. iree_task_executor_schedule_ready_tasks: walks the FIFO task queue and
-//      builds a iree_task_post_batch_t containing the per-worker tasks
-//      in LIFO order.
+//   b. iree_task_executor_schedule_ready_tasks: walks the FIFO task queue in
+//      scope priority order and builds a iree_task_post_batch_t containing the
+//      per-worker tasks in LIFO order.
 //
 //   c. iree_task_post_batch_submit: per-worker tasks are pushed to their
 //      respective iree_task_worker_t mailbox_slist and the workers with new
@@ -135,13 +135,16 @@ extern "C" {
 //    each worker will check its mailbox_slist to see if any tasks have been
 //    posted.
 //
-//    a. Tasks are flushed from the LIFO mailbox into the local_task_queue FIFO
-//       for the particular worker.
+//    a. Tasks are flushed from the LIFO mailbox into the local_task_queues
+//       FIFO matching their scope priority for the particular worker. Posting
+//       tasks more urgent than those queued flushes the mailbox immediately.
 //
 //    b. If the mailbox is empty the worker *may* attempt to steal work from
 //       another nearby worker in the topology.
 //
-//    c. Any tasks in the local_task_queue are executed until empty.
+//    c. Any tasks in the local_task_queues are executed until empty, most
+//       urgent first. Dispatch shards yield between tile reservations when
+//       more urgent tasks are posted to the worker and resume afterward.
 //       Tasks are retired and dependent tasks (via completion_task or barriers)
 //       are made ready and placed in the executor incoming_ready_slist as with
 //       iree_task_executor_submit.
@@ -347,6 +350,84 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence);
 
+//==============================================================================
+// Executor partitions
+//==============================================================================
+
+// A logical subset of the workers in an executor.
+//
+// Partitions allow multiple tenants (devices, contexts, models, etc) to share
+// a single executor without competing for the same workers. Every worker
+// belongs to exactly one partition at a time: workers not assigned to any
+// user-created partition belong to the executor default partition. Tasks are
+// scheduled to the workers of the partition assigned to their scope (see
+// iree_task_scope_set_partition) and workers only steal from other workers in
+// their own partition.
+//
+// Workers can be moved between partitions at any time to rebalance capacity
+// based on load (see iree_task_partition_statistics_t). Tasks already posted
+// to a moved worker complete there and only newly scheduled tasks observe the
+// change. If a partition has no workers its tasks are scheduled to any worker
+// so that they always make forward progress.
+//
+// Thread-safe. Partitions retain their executor.
+typedef struct iree_task_partition_t iree_task_partition_t;
+
+// Statistics describing the load on a partition.
+// Counters are monotonically increasing for the lifetime of the partition and
+// callers interested in rates should sample them periodically.
+typedef struct iree_task_partition_statistics_t {
+  // Workers currently assigned to the partition.
+  iree_task_affinity_set_t worker_mask;
+  // Number of workers currently assigned to the partition.
+  iree_host_size_t worker_count;
+  // Number of workers currently assigned that are processing tasks.
+  iree_host_size_t busy_worker_count;
+  // Number of tasks queued on the workers assigned to the partition.
+  iree_host_size_t queued_task_count;
+  // Total number of calls and dispatches scheduled on the partition.
+  uint64_t scheduled_task_count;
+  // Total number of dispatches issued on the partition.
+  uint64_t dispatch_count;
+  // Total number of tiles in all dispatches issued on the partition.
+  uint64_t dispatch_tile_count;
+} iree_task_partition_statistics_t;
+
+// Creates a new partition of |executor| named |name| and moves the workers in
+// |worker_mask| into it from the partitions they were previously assigned to.
+// |worker_mask| may be 0 to create an empty partition that is populated later
+// with iree_task_executor_assign_workers.
+//
+// When the partition is destroyed all of its workers return to the executor
+// default partition.
+iree_status_t iree_task_executor_create_partition(
+    iree_task_executor_t* executor, iree_string_view_t name,
+    iree_task_affinity_set_t worker_mask,
+    iree_task_partition_t** out_partition);
+
+// Retains the given |partition| for the caller.
+void iree_task_partition_retain(iree_task_partition_t* partition);
+
+// Releases the given |partition| from the caller.
+void iree_task_partition_release(iree_task_partition_t* partition);
+
+// Returns the executor that |partition| divides.
+iree_task_executor_t* iree_task_partition_executor(
+    const iree_task_partition_t* partition);
+
+// Moves the workers in |worker_mask| into |partition| from the partitions they
+// are currently assigned to. A NULL |partition| returns the workers to the
+// executor default partition.
+iree_status_t iree_task_executor_assign_workers(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_affinity_set_t worker_mask);
+
+// Queries the current statistics of |partition| or the executor default
+// partition if NULL.
+void iree_task_executor_query_partition(
+    iree_task_executor_t* executor, iree_task_partition_t* partition,
+    iree_task_partition_statistics_t* out_statistics);
+
 // TODO(benvanik): scheduling mode mutation, compute quota control, etc.
 
 // Submits a batch of tasks for execution.
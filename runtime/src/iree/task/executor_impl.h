@@ -8,6 +8,7 @@
 #define IREE_TASK_EXECUTOR_IMPL_H_
 
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/base/internal/prng.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
@@ -25,6 +26,28 @@
 extern "C" {
 #endif  // __cplusplus
 
+struct iree_task_partition_t {
+  iree_atomic_ref_count_t ref_count;
+
+  // Executor the partition divides. Retained by all partitions but the
+  // executor default partition, which is owned by the executor itself.
+  iree_task_executor_t* executor;
+
+  // Name used for logging and tracing.
+  char name[16];
+
+  // Workers currently assigned to the partition.
+  // Only modified with the executor partition_mutex held and otherwise a hint
+  // accessed with memory_order_relaxed by the coordinator.
+  iree_atomic_task_affinity_set_t worker_mask;
+
+  // Counters updated by the coordinator as tasks are scheduled.
+  // See iree_task_partition_statistics_t.
+  iree_atomic_int64_t scheduled_task_count;
+  iree_atomic_int64_t dispatch_count;
+  iree_atomic_int64_t dispatch_tile_count;
+};
+
 struct iree_task_executor_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
@@ -116,6 +139,13 @@ struct iree_task_executor_t {
   // comment on worker_live_mask.
   iree_atomic_task_affinity_set_t worker_idle_mask;
 
+  // Guards changes to partition membership of workers.
+  iree_slim_mutex_t partition_mutex;
+
+  // Partition containing all workers not assigned to user partitions and used
+  // by all scopes without a partition.
+  iree_task_partition_t default_partition;
+
   // Base value added to each executor-local worker index.
   // This allows workers to uniquely identify themselves in multi-executor
   // configurations.
@@ -126,6 +156,11 @@ struct iree_task_executor_t {
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // Counters recorded into the default metrics registry if one was installed
+  // when the executor was created; NULL otherwise.
+  iree_metric_t* worker_wake_metric;
+  iree_metric_t* steal_metric;
 };
 
 // Merges a submission into the primary FIFO queues.
@@ -155,13 +190,16 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker);
 
 // Tries to steal an entire task from a sibling worker (based on topology).
+// Only workers in |partition_mask| are considered as victims.
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the |local_task_queues| matching
+// their priorities. Victims give up their most urgent tasks first.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_affinity_set_t partition_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -6,6 +6,7 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
 #include <cstddef>
 
 #include "iree/testing/gtest.h"
@@ -13,6 +14,10 @@
 
 namespace {
 
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
 // Tests that an executor can be created and destroyed repeatedly without
 // running out of system resources. Since all systems are different there's no
 // guarantee this will fail but it does give ASAN/TSAN some nice stuff to chew
@@ -133,4 +138,249 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Tests that a long-running low priority dispatch yields to high priority work
+// that arrives while it is executing. A single worker is used such that the
+// high priority call would only be able to run after all tiles completed if
+// the dispatch did not yield.
+TEST(ExecutorTest, PriorityPreemption) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t low_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("low"), &low_scope);
+  iree_task_scope_set_priority(&low_scope, IREE_TASK_PRIORITY_LOW);
+  iree_task_scope_t high_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("high"), &high_scope);
+  iree_task_scope_set_priority(&high_scope, IREE_TASK_PRIORITY_HIGH);
+
+  struct TestState {
+    iree_task_executor_t* executor;
+    iree_task_call_t high_call;
+    std::atomic<uint32_t> tiles_completed = {0};
+    std::atomic<uint32_t> tiles_completed_before_call = {0};
+  } state;
+  state.executor = executor;
+
+  iree_task_call_initialize(
+      &high_scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (TestState*)user_context;
+            state->tiles_completed_before_call =
+                state->tiles_completed.load();
+            return iree_ok_status();
+          },
+          &state),
+      &state.high_call);
+  iree_task_fence_t* high_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &high_scope, &high_fence));
+  iree_task_set_completion_task(&state.high_call.header, &high_fence->header);
+
+  // The high priority call is submitted from the first tile executed and will
+  // be posted to the only worker: the one executing the dispatch.
+  const uint32_t tile_count = 1024;
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &low_scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (TestState*)user_context;
+            if (state->tiles_completed.fetch_add(1) == 0) {
+              iree_task_submission_t submission;
+              iree_task_submission_initialize(&submission);
+              iree_task_submission_enqueue(&submission,
+                                           &state->high_call.header);
+              iree_task_executor_submit(state->executor, &submission);
+              iree_task_executor_flush(state->executor);
+            }
+            return iree_ok_status();
+          },
+          &state),
+      workgroup_size, workgroup_count, &dispatch);
+  iree_task_fence_t* low_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor, &low_scope, &low_fence));
+  iree_task_set_completion_task(&dispatch.header, &low_fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&low_scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&high_scope, IREE_TIME_INFINITE_FUTURE));
+
+  EXPECT_EQ(state.tiles_completed, tile_count);
+  EXPECT_LT(state.tiles_completed_before_call, tile_count)
+      << "high priority call did not preempt the low priority dispatch";
+
+  iree_task_scope_deinitialize(&high_scope);
+  iree_task_scope_deinitialize(&low_scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that tasks in a scope assigned to a partition only execute on the
+// workers within the partition and that workers can be moved between
+// partitions.
+TEST(ExecutorTest, Partition) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+
+  iree_task_partition_t* partition = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create_partition(
+      executor, iree_make_cstring_view("tenant"), /*worker_mask=*/0x3ull,
+      &partition));
+  EXPECT_EQ(iree_task_partition_executor(partition), executor);
+
+  iree_task_partition_statistics_t statistics;
+  iree_task_executor_query_partition(executor, partition, &statistics);
+  EXPECT_EQ(statistics.worker_mask, 0x3ull);
+  EXPECT_EQ(statistics.worker_count, 2);
+  iree_task_executor_query_partition(executor, NULL, &statistics);
+  EXPECT_EQ(statistics.worker_mask, 0xCull);
+  EXPECT_EQ(statistics.worker_count, 2);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+  iree_task_scope_set_partition(&scope, partition);
+  EXPECT_EQ(iree_task_scope_partition(&scope), partition);
+
+  // Runs a dispatch in the scope and returns the mask of workers that executed
+  // its tiles.
+  const uint32_t tile_count = 256;
+  auto run_dispatch = [&]() -> iree_task_affinity_set_t {
+    static std::atomic<iree_task_affinity_set_t> worker_mask = {0};
+    worker_mask = 0;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              worker_mask.fetch_or(1ull << tile_context->worker_id);
+              return iree_ok_status();
+            },
+            NULL),
+        workgroup_size, workgroup_count, &dispatch);
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+    return worker_mask;
+  };
+
+  EXPECT_EQ(run_dispatch() & ~0x3ull, 0ull)
+      << "tiles executed on workers outside of the partition";
+  iree_task_executor_query_partition(executor, partition, &statistics);
+  EXPECT_EQ(statistics.dispatch_count, 1);
+  EXPECT_EQ(statistics.dispatch_tile_count, tile_count);
+  EXPECT_GE(statistics.scheduled_task_count, 1);
+
+  // Rebalance so that the partition has a different set of workers.
+  IREE_ASSERT_OK(
+      iree_task_executor_assign_workers(executor, partition, 0x8ull));
+  IREE_ASSERT_OK(iree_task_executor_assign_workers(executor, NULL, 0x3ull));
+  iree_task_executor_query_partition(executor, partition, &statistics);
+  EXPECT_EQ(statistics.worker_mask, 0x8ull);
+  EXPECT_EQ(statistics.worker_count, 1);
+  EXPECT_EQ(run_dispatch(), 0x8ull)
+      << "tiles executed on workers outside of the partition";
+  iree_task_executor_query_partition(executor, partition, &statistics);
+  EXPECT_EQ(statistics.dispatch_count, 2);
+  EXPECT_EQ(statistics.dispatch_tile_count, 2 * tile_count);
+
+  // Workers beyond those in the executor cannot be assigned.
+  EXPECT_THAT(Status(iree_task_executor_assign_workers(executor, partition,
+                                                       1ull << 63)),
+              StatusIs(StatusCode::kInvalidArgument));
+
+  // Releasing the partition returns its workers to the default partition.
+  iree_task_scope_deinitialize(&scope);
+  iree_task_partition_release(partition);
+  iree_task_executor_query_partition(executor, NULL, &statistics);
+  EXPECT_EQ(statistics.worker_mask, 0xFull);
+  EXPECT_EQ(statistics.worker_count, 4);
+
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests that dispatches complete every tile exactly once when some workers run
+// on slower cores and reserve fewer tiles at a time.
+TEST(ExecutorTest, HeterogeneousThroughput) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  topology.groups[1].throughput = IREE_TASK_TOPOLOGY_MAX_THROUGHPUT / 2;
+  topology.groups[3].throughput = 1;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  static constexpr uint32_t kTileCount = 4096;
+  static std::atomic<uint32_t> tile_hits[kTileCount];
+  for (auto& tile_hit : tile_hits) tile_hit = 0;
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {kTileCount, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            tile_hits[tile_context->workgroup_xyz[0]].fetch_add(1);
+            return iree_ok_status();
+          },
+          NULL),
+      workgroup_size, workgroup_count, &dispatch);
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+  for (uint32_t i = 0; i < kTileCount; ++i) {
+    ASSERT_EQ(tile_hits[i], 1) << "tile " << i;
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
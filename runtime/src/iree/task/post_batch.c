@@ -153,8 +153,8 @@ bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
       // role of coordinator and we want to ensure we aren't doing a fully
       // block-and-flush loop when we could just be popping the next new task
       // off the list.
-      iree_task_queue_append_from_lifo_list_unsafe(&worker->local_task_queue,
-                                                   target_pending_lifo);
+      iree_task_list_reverse(target_pending_lifo);
+      iree_task_worker_append_local_tasks(worker, target_pending_lifo);
     } else {
       iree_task_worker_post_tasks(worker, target_pending_lifo);
       worker_wake_mask |= iree_task_affinity_for_worker(target_index);
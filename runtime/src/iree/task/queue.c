@@ -27,12 +27,26 @@ bool iree_task_queue_is_empty(iree_task_queue_t* queue) {
   return is_empty;
 }
 
+iree_host_size_t iree_task_queue_calculate_size(iree_task_queue_t* queue) {
+  iree_slim_mutex_lock(&queue->mutex);
+  iree_host_size_t size = iree_task_list_calculate_size(&queue->list);
+  iree_slim_mutex_unlock(&queue->mutex);
+  return size;
+}
+
 void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task) {
   iree_slim_mutex_lock(&queue->mutex);
   iree_task_list_push_front(&queue->list, task);
   iree_slim_mutex_unlock(&queue->mutex);
 }
 
+void iree_task_queue_append_from_fifo_list_unsafe(iree_task_queue_t* queue,
+                                                  iree_task_list_t* list) {
+  iree_slim_mutex_lock(&queue->mutex);
+  iree_task_list_append(&queue->list, list);
+  iree_slim_mutex_unlock(&queue->mutex);
+}
+
 void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
                                                   iree_task_list_t* list) {
   // NOTE: reversing the list outside of the lock.
@@ -121,6 +121,10 @@ void iree_task_queue_deinitialize(iree_task_queue_t* queue);
 // Note that due to races this may return both false-positives and -negatives.
 bool iree_task_queue_is_empty(iree_task_queue_t* queue);
 
+// Returns the total number of tasks in the queue. Requires a full walk.
+// Note that due to races the value may be out of date immediately.
+iree_host_size_t iree_task_queue_calculate_size(iree_task_queue_t* queue);
+
 // Pushes a task to the front of the queue.
 // Always prefer the multi-push variants (prepend/append) when adding more than
 // one task to the queue. This is mostly useful for exceptional cases such as
@@ -129,6 +133,12 @@ bool iree_task_queue_is_empty(iree_task_queue_t* queue);
 // Must only be called from the owning worker's thread.
 void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task);
 
+// Appends a FIFO |list| of tasks to the queue.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_queue_append_from_fifo_list_unsafe(iree_task_queue_t* queue,
+                                                  iree_task_list_t* list);
+
 // Appends a LIFO |list| of tasks to the queue.
 //
 // Must only be called from the owning worker's thread.
@@ -109,6 +109,31 @@ TEST(QueueTest, AppendListOrdered) {
   iree_task_queue_deinitialize(&queue);
 }
 
+TEST(QueueTest, AppendFifoListOrdered) {
+  iree_task_queue_t queue;
+  iree_task_queue_initialize(&queue);
+
+  // Make a fifo list: a->b.
+  iree_task_list_t list = {0};
+  iree_task_t task_a = {0};
+  iree_task_list_push_back(&list, &task_a);
+  iree_task_t task_b = {0};
+  iree_task_list_push_back(&list, &task_b);
+
+  // Append the list to the queue; it should retain its order.
+  EXPECT_TRUE(iree_task_queue_is_empty(&queue));
+  iree_task_queue_append_from_fifo_list_unsafe(&queue, &list);
+  EXPECT_FALSE(iree_task_queue_is_empty(&queue));
+  EXPECT_TRUE(iree_task_list_is_empty(&list));
+
+  // Pop list and ensure order: a->b.
+  EXPECT_EQ(&task_a, iree_task_queue_pop_front(&queue));
+  EXPECT_EQ(&task_b, iree_task_queue_pop_front(&queue));
+  EXPECT_TRUE(iree_task_queue_is_empty(&queue));
+
+  iree_task_queue_deinitialize(&queue);
+}
+
 TEST(QueueTest, FlushSlistEmpty) {
   iree_task_queue_t queue;
   iree_task_queue_initialize(&queue);
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/threading.h"
+#include "iree/task/executor.h"
 
 void iree_task_scope_initialize(iree_string_view_t name,
                                 iree_task_scope_t* out_scope) {
@@ -24,6 +25,8 @@ void iree_task_scope_initialize(iree_string_view_t name,
   memcpy(out_scope->name, name.data, name_length);
   out_scope->name[name_length] = 0;
 
+  out_scope->priority = IREE_TASK_PRIORITY_NORMAL;
+
   // TODO(benvanik): pick trace colors based on name hash.
   IREE_TRACE(out_scope->task_trace_color = 0xFFFF0000u);
 
@@ -56,6 +59,9 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope) {
   }
   iree_notification_deinitialize(&scope->idle_notification);
 
+  iree_task_partition_release(scope->partition);
+  scope->partition = NULL;
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -63,6 +69,31 @@ iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope) {
   return iree_make_cstring_view(scope->name);
 }
 
+iree_task_priority_t iree_task_scope_priority(iree_task_scope_t* scope) {
+  return scope->priority;
+}
+
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority) {
+  IREE_ASSERT(iree_task_scope_is_idle(scope),
+              "scope priority must only be changed while idle");
+  IREE_ASSERT_LT(priority, IREE_TASK_PRIORITY_COUNT);
+  scope->priority = priority;
+}
+
+iree_task_partition_t* iree_task_scope_partition(iree_task_scope_t* scope) {
+  return scope->partition;
+}
+
+void iree_task_scope_set_partition(iree_task_scope_t* scope,
+                                   iree_task_partition_t* partition) {
+  IREE_ASSERT(iree_task_scope_is_idle(scope),
+              "scope partition must only be changed while idle");
+  iree_task_partition_retain(partition);
+  iree_task_partition_release(scope->partition);
+  scope->partition = partition;
+}
+
 iree_task_dispatch_statistics_t iree_task_scope_consume_statistics(
     iree_task_scope_t* scope) {
   iree_task_dispatch_statistics_t result = scope->dispatch_statistics;
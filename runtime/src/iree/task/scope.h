@@ -42,6 +42,12 @@ extern "C" {
 // overhead is low and the only advantage of reusing them is that lifetime can
 // become easier to manage by tying them 1:1 with producers.
 //
+// Each scope carries a scheduling priority applied to all of its tasks. This
+// allows latency-sensitive producers to share an executor with batch producers
+// without waiting behind their queued work: see iree_task_priority_t.
+// Scopes may also be assigned an executor partition to limit which workers
+// their tasks are scheduled on: see iree_task_partition_t.
+//
 // Thread-safe; once created scopes are modified exclusively via atomic
 // operations.
 typedef struct iree_task_scope_t {
@@ -52,6 +58,15 @@ typedef struct iree_task_scope_t {
   // The color will be modulated based on task type.
   IREE_TRACE(uint32_t task_trace_color;)
 
+  // Scheduling priority of all tasks within the scope.
+  // Only changed while the scope is idle and otherwise read-only.
+  iree_task_priority_t priority;
+
+  // Executor partition all tasks within the scope are scheduled on or NULL to
+  // use the executor default partition. Retained.
+  // Only changed while the scope is idle and otherwise read-only.
+  iree_task_partition_t* partition;
+
   // A permanent status code set when a task within the scope fails. All pending
   // tasks will be aborted, though any in-flight tasks may continue executing
   // to completion.
@@ -88,6 +103,27 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope);
 // string.
 iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope);
 
+// Returns the scheduling priority of tasks within the scope.
+iree_task_priority_t iree_task_scope_priority(iree_task_scope_t* scope);
+
+// Sets the scheduling priority of tasks within the scope.
+// Scopes default to IREE_TASK_PRIORITY_NORMAL. Must only be called while the
+// scope is idle as tasks that have already been submitted may be queued based
+// on the priority at the time they were scheduled.
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_priority_t priority);
+
+// Returns the executor partition tasks within the scope are scheduled on or
+// NULL if the default partition of the executor is used.
+iree_task_partition_t* iree_task_scope_partition(iree_task_scope_t* scope);
+
+// Sets the executor |partition| tasks within the scope are scheduled on.
+// The partition is retained by the scope and must be from the executor the
+// scope's tasks are submitted to. NULL selects the default partition of the
+// executor. Must only be called while the scope is idle.
+void iree_task_scope_set_partition(iree_task_scope_t* scope,
+                                   iree_task_partition_t* partition);
+
 // Returns and resets the statistics for the scope.
 // Statistics may experience tearing (non-atomic update across fields) if this
 // is performed while tasks are in-flight.
@@ -15,6 +15,7 @@
 #include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task_impl.h"
+#include "iree/task/topology.h"
 #include "iree/task/tuning.h"
 
 //==============================================================================
@@ -522,6 +523,79 @@ void iree_task_dispatch_statistics_merge(
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
 
+// Returns the even bits of |value| packed into the low 16 bits.
+static inline uint32_t iree_task_morton_compact_u32(uint32_t value) {
+  value &= 0x55555555u;
+  value = (value | (value >> 1)) & 0x33333333u;
+  value = (value | (value >> 2)) & 0x0F0F0F0Fu;
+  value = (value | (value >> 4)) & 0x00FF00FFu;
+  value = (value | (value >> 8)) & 0x0000FFFFu;
+  return value;
+}
+
+void iree_task_dispatch_order_tile_xyz(iree_task_dispatch_order_t order,
+                                       uint32_t group_size,
+                                       const uint32_t workgroup_count[3],
+                                       uint32_t tile_index,
+                                       uint32_t out_workgroup_xyz[3]) {
+  const uint32_t count_x = workgroup_count[0];
+  const uint32_t count_y = workgroup_count[1];
+  const uint32_t slice_size = count_x * count_y;
+  out_workgroup_xyz[2] = tile_index / slice_size;
+  uint64_t i = tile_index - out_workgroup_xyz[2] * slice_size;
+  if (group_size == 0) group_size = IREE_TASK_DISPATCH_DEFAULT_ORDER_GROUP_SIZE;
+  switch (order) {
+    default:
+    case IREE_TASK_DISPATCH_ORDER_LINEAR: {
+      out_workgroup_xyz[0] = (uint32_t)(i % count_x);
+      out_workgroup_xyz[1] = (uint32_t)(i / count_x);
+      break;
+    }
+    case IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR: {
+      out_workgroup_xyz[0] = (uint32_t)(i / count_y);
+      out_workgroup_xyz[1] = (uint32_t)(i % count_y);
+      break;
+    }
+    case IREE_TASK_DISPATCH_ORDER_MORTON: {
+      // Round down to a power of two small enough that the Morton index of a
+      // block fits in 32 bits.
+      const uint32_t block_size =
+          1u << (31 - iree_math_count_leading_zeros_u32(
+                          iree_min(group_size, 1u << 15)));
+      // Rows of blocks are block_size tiles tall except for the last.
+      const uint32_t block_y =
+          (uint32_t)(i / ((uint64_t)block_size * count_x)) * block_size;
+      const uint32_t block_height = iree_min(block_size, count_y - block_y);
+      i -= (uint64_t)block_y * count_x;
+      // Blocks are block_size tiles wide except for the last in each row.
+      const uint32_t block_x =
+          (uint32_t)(i / ((uint64_t)block_size * block_height)) * block_size;
+      const uint32_t block_width = iree_min(block_size, count_x - block_x);
+      i -= (uint64_t)block_x * block_height;
+      if (block_width == block_size && block_height == block_size) {
+        out_workgroup_xyz[0] =
+            block_x + iree_task_morton_compact_u32((uint32_t)i);
+        out_workgroup_xyz[1] =
+            block_y + iree_task_morton_compact_u32((uint32_t)i >> 1);
+      } else {
+        out_workgroup_xyz[0] = block_x + (uint32_t)(i % block_width);
+        out_workgroup_xyz[1] = block_y + (uint32_t)(i / block_width);
+      }
+      break;
+    }
+    case IREE_TASK_DISPATCH_ORDER_GROUPED: {
+      // Bands are group_size rows tall except for the last.
+      const uint32_t band_y =
+          (uint32_t)(i / ((uint64_t)group_size * count_x)) * group_size;
+      const uint32_t band_height = iree_min(group_size, count_y - band_y);
+      i -= (uint64_t)band_y * count_x;
+      out_workgroup_xyz[0] = (uint32_t)(i / band_height);
+      out_workgroup_xyz[1] = band_y + (uint32_t)(i % band_height);
+      break;
+    }
+  }
+}
+
 static void iree_task_dispatch_initialize_base(
     iree_task_scope_t* scope, iree_task_dispatch_closure_t closure,
     const uint32_t workgroup_size[3], iree_task_dispatch_t* out_task) {
@@ -530,8 +604,11 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->local_memory_size = 0;
+  out_task->order = IREE_TASK_DISPATCH_ORDER_LINEAR;
+  out_task->order_group_size = 0;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
+  IREE_STATISTICS(out_task->duration_metric = NULL);
 
   IREE_TRACE({
     static iree_atomic_int64_t next_dispatch_id = IREE_ATOMIC_VAR_INIT(0);
@@ -561,6 +638,7 @@ void iree_task_dispatch_initialize_indirect(
 
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
+                              iree_task_affinity_set_t worker_mask,
                               iree_task_submission_t* pending_submission,
                               iree_task_post_batch_t* post_batch) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -569,6 +647,11 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   // Mark the dispatch as having been issued; the next time it retires it'll be
   // because all work has completed.
   dispatch_task->header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+  IREE_STATISTICS({
+    if (dispatch_task->duration_metric) {
+      dispatch_task->issue_time_ns = iree_time_now();
+    }
+  });
 
   // Fetch the workgroup count (directly or indirectly).
   if (dispatch_task->header.flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
@@ -602,9 +685,10 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   dispatch_task->tile_count =
       workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
 
-  // Compute shard count - almost always worker_count unless we are a very small
-  // dispatch (1x1x1, etc).
-  iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
+  // Compute shard count - almost always the number of workers we can use
+  // unless we are a very small dispatch (1x1x1, etc).
+  iree_host_size_t worker_count =
+      iree_task_affinity_set_count_ones(worker_mask);
   iree_host_size_t shard_count =
       iree_min(dispatch_task->tile_count, worker_count);
 
@@ -620,20 +704,22 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
         IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
   }
 
-  // Randomize starting worker.
-  iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
-      post_batch, dispatch_task->header.affinity_set);
-  iree_host_size_t worker_index = worker_offset;
+  // Randomize starting worker and then walk the remaining workers in the mask.
+  iree_host_size_t total_worker_count =
+      iree_task_post_batch_worker_count(post_batch);
+  iree_host_size_t worker_index =
+      iree_task_post_batch_select_worker(post_batch, worker_mask);
+  for (iree_host_size_t i = 0; i < shard_count; ++worker_index) {
+    worker_index %= total_worker_count;
+    if (!(worker_mask & iree_task_affinity_for_worker(worker_index))) continue;
 
-  for (iree_host_size_t i = 0; i < shard_count; ++i) {
     // Allocate and initialize the shard.
     iree_task_dispatch_shard_t* shard_task =
         iree_task_dispatch_shard_allocate(dispatch_task, shard_task_pool);
 
     // Enqueue on the worker selected for the task.
-    iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
-                                 &shard_task->header);
-    ++worker_index;
+    iree_task_post_batch_enqueue(post_batch, worker_index, &shard_task->header);
+    ++i;
   }
 
   // NOTE: the dispatch is not retired until all shards complete. Upon the last
@@ -662,6 +748,12 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
   iree_task_dispatch_statistics_merge(
       &dispatch_task->statistics,
       &dispatch_task->header.scope->dispatch_statistics);
+  IREE_STATISTICS({
+    if (dispatch_task->duration_metric) {
+      iree_metric_observe(dispatch_task->duration_metric,
+                          iree_time_now() - dispatch_task->issue_time_ns);
+    }
+  });
 
   // Consume the status of the dispatch that may have been set from a workgroup
   // and notify the scope. We need to do this here so that each shard retires
@@ -709,9 +801,60 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
-void iree_task_dispatch_shard_execute(
+// Calls the range closure of |dispatch_task| for |tile_count| tiles starting
+// at the tile described by |tile_context| and continuing in x-major order.
+static iree_status_t iree_task_dispatch_shard_execute_range(
+    iree_task_dispatch_t* dispatch_task,
+    const iree_task_tile_context_t* tile_context, uint32_t tile_count,
+    iree_task_submission_t* pending_submission) {
+  IREE_TRACE_ZONE_BEGIN_NAMED(z_range,
+                              "iree_task_dispatch_shard_execute_range");
+  IREE_TRACE_ZONE_SET_COLOR(z_range, iree_task_tile_to_color(tile_context));
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z_range, tile_count);
+  iree_status_t status =
+      dispatch_task->closure.range_fn(dispatch_task->closure.user_context,
+                                      tile_context, tile_count,
+                                      pending_submission);
+  IREE_TRACE_ZONE_END(z_range);
+  return status;
+}
+
+// Calls the range closure of |dispatch_task| for the tiles in
+// [tile_base, tile_end) of the dispatch order. The tiles are split into runs
+// that are contiguous in x-major order as required by range closures.
+static iree_status_t iree_task_dispatch_shard_execute_ordered_ranges(
+    iree_task_dispatch_t* dispatch_task, uint32_t tile_base, uint32_t tile_end,
+    iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  uint32_t run_length = 0;
+  for (uint32_t tile_index = tile_base; tile_index < tile_end; ++tile_index) {
+    uint32_t workgroup_xyz[3];
+    iree_task_dispatch_order_tile_xyz(
+        dispatch_task->order, dispatch_task->order_group_size,
+        tile_context->workgroup_count, tile_index, workgroup_xyz);
+    if (run_length > 0 &&
+        workgroup_xyz[0] == tile_context->workgroup_xyz[0] + run_length &&
+        workgroup_xyz[1] == tile_context->workgroup_xyz[1] &&
+        workgroup_xyz[2] == tile_context->workgroup_xyz[2]) {
+      ++run_length;
+      continue;
+    }
+    if (run_length > 0) {
+      IREE_RETURN_IF_ERROR(iree_task_dispatch_shard_execute_range(
+          dispatch_task, tile_context, run_length, pending_submission));
+    }
+    memcpy(tile_context->workgroup_xyz, workgroup_xyz, sizeof(workgroup_xyz));
+    run_length = 1;
+  }
+  if (run_length == 0) return iree_ok_status();
+  return iree_task_dispatch_shard_execute_range(
+      dispatch_task, tile_context, run_length, pending_submission);
+}
+
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    uint32_t worker_throughput, iree_atomic_int32_t* preempt_priority_mask,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -734,7 +877,7 @@ void iree_task_dispatch_shard_execute(
                          worker_local_memory.data_length));
     iree_task_retire(&task->header, pending_submission, iree_ok_status());
     IREE_TRACE_ZONE_END(z0);
-    return;
+    return true;
   }
   iree_byte_span_t local_memory = iree_make_byte_span(
       worker_local_memory.data, dispatch_task->local_memory_size);
@@ -760,9 +903,24 @@ void iree_task_dispatch_shard_execute(
   // Hint as to which processor we are running on.
   tile_context.processor_id = processor_id;
 
+  // Any work arriving for the worker with one of these priorities preempts the
+  // shard at the next tile reservation boundary.
+  const uint32_t preempting_priorities =
+      preempt_priority_mask
+          ? iree_task_priority_mask_above(iree_task_priority(&task->header))
+          : 0;
+
   // Loop over all tiles until they are all processed.
   const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  // Workers on slower processors (such as the efficiency cores of hybrid
+  // systems) reserve fewer tiles at a time so that the last tiles they reserve
+  // complete around the same time as those reserved by faster workers. The
+  // faster workers make up the difference by reserving more often.
+  const uint32_t tiles_per_reservation = iree_max(
+      1u, (uint32_t)(((uint64_t)dispatch_task->tiles_per_reservation *
+                          worker_throughput +
+                      IREE_TASK_TOPOLOGY_MAX_THROUGHPUT - 1) /
+                     IREE_TASK_TOPOLOGY_MAX_THROUGHPUT));
   // relaxed order because we only care about atomic increments, not about
   // ordering of tile_index accesses w.r.t. other memory accesses.
   uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
@@ -771,55 +929,100 @@ void iree_task_dispatch_shard_execute(
   while (tile_base < tile_count) {
     const uint32_t tile_range =
         iree_min(tile_base + tiles_per_reservation, tile_count);
-    for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
-      // TODO(benvanik): faster math here, especially knowing we pull off N
-      // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
+
+    iree_status_t status = iree_ok_status();
+    if (dispatch_task->closure.range_fn &&
+        dispatch_task->order != IREE_TASK_DISPATCH_ORDER_LINEAR) {
+      status = iree_task_dispatch_shard_execute_ordered_ranges(
+          dispatch_task, tile_base, tile_range, &tile_context,
+          pending_submission);
+    } else if (dispatch_task->closure.range_fn) {
+      // The entire reservation is handed to the closure in one call.
+      uint32_t tile_i = tile_base;
       tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
       tile_i /= workgroup_count_x;
       tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
       tile_i /= workgroup_count_y;
       tile_context.workgroup_xyz[2] = tile_i;
 
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
-                                  "iree_task_dispatch_shard_execute_tile");
-      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
+      status = iree_task_dispatch_shard_execute_range(
+          dispatch_task, &tile_context, tile_range - tile_base,
+          pending_submission);
+    } else {
+      for (uint32_t tile_index = tile_base; tile_index < tile_range;
+           ++tile_index) {
+        if (dispatch_task->order == IREE_TASK_DISPATCH_ORDER_LINEAR) {
+          // TODO(benvanik): faster math here, especially knowing we pull off N
+          // sequential indices per reservation.
+          uint32_t tile_i = tile_index;
+          tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
+          tile_i /= workgroup_count_x;
+          tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
+          tile_i /= workgroup_count_y;
+          tile_context.workgroup_xyz[2] = tile_i;
+        } else {
+          iree_task_dispatch_order_tile_xyz(
+              dispatch_task->order, dispatch_task->order_group_size,
+              tile_context.workgroup_count, tile_index,
+              tile_context.workgroup_xyz);
+        }
+
+        IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
+                                    "iree_task_dispatch_shard_execute_tile");
+        IREE_TRACE_ZONE_SET_COLOR(z_tile,
+                                  iree_task_tile_to_color(&tile_context));
 
 #ifndef NDEBUG
-      // NOTE: these are useful for debugging but dramatically increase our
-      // cost here; only enable if needed for tracking work distribution:
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[0]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[1]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[2]);
-      // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
+        // NOTE: these are useful for debugging but dramatically increase our
+        // cost here; only enable if needed for tracking work distribution:
+        IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[0]);
+        IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[1]);
+        IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[2]);
+        // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
 #endif  // !NDEBUG
 
-      iree_status_t status =
-          dispatch_task->closure.fn(dispatch_task->closure.user_context,
-                                    &tile_context, pending_submission);
-
-      IREE_TRACE_ZONE_END(z_tile);
-
-      // If any tile fails we bail early from the loop. This doesn't match
-      // what an accelerator would do but saves some unneeded work.
-      // Note that other shards may have completed execution, be executing
-      // concurrently with this one, or still be pending - this does not
-      // have any influence on them and they may continue to execute even
-      // after we bail from here.
-      if (!iree_status_is_ok(status)) {
-        // Propagate failures to the dispatch task.
-        iree_task_try_set_status(&dispatch_task->status, status);
-        goto abort_shard;  // out of the while-for nest
+        status = dispatch_task->closure.fn(dispatch_task->closure.user_context,
+                                           &tile_context, pending_submission);
+
+        IREE_TRACE_ZONE_END(z_tile);
+
+        if (!iree_status_is_ok(status)) break;
       }
     }
 
+    // If any tile fails we bail early from the loop. This doesn't match
+    // what an accelerator would do but saves some unneeded work.
+    // Note that other shards may have completed execution, be executing
+    // concurrently with this one, or still be pending - this does not
+    // have any influence on them and they may continue to execute even
+    // after we bail from here.
+    if (!iree_status_is_ok(status)) {
+      // Propagate failures to the dispatch task.
+      iree_task_try_set_status(&dispatch_task->status, status);
+      break;
+    }
+
+    // Yield to more urgent work before reserving more tiles. The tiles we have
+    // not reserved remain available to the other shards of the dispatch and
+    // this shard will continue from wherever they left off when resumed.
+    // relaxed order because the mask is only a hint; the worker synchronizes
+    // with the mailbox the tasks are actually posted through.
+    if (IREE_UNLIKELY(preempting_priorities &&
+                      (iree_atomic_load_int32(preempt_priority_mask,
+                                              iree_memory_order_relaxed) &
+                       preempting_priorities))) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "yield");
+      iree_task_dispatch_statistics_merge(&shard_statistics,
+                                          &dispatch_task->statistics);
+      IREE_TRACE_ZONE_END(z0);
+      return false;
+    }
+
     // Try to grab the next slice of tiles.
     tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
                                             tiles_per_reservation,
                                             iree_memory_order_relaxed);
   }
-abort_shard:
 
   // Push aggregate statistics up to the dispatch.
   // Note that we may have partial information here if we errored out of the
@@ -831,4 +1034,5 @@ abort_shard:
   // propagated to the dispatch and it'll clean up after all shards are joined.
   iree_task_retire(&task->header, pending_submission, iree_ok_status());
   IREE_TRACE_ZONE_END(z0);
+  return true;
 }
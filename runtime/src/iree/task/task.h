@@ -15,6 +15,7 @@
 #include "iree/base/internal/atomic_slist.h"
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/task/affinity_set.h"
 
@@ -23,10 +24,40 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_task_list_t iree_task_list_t;
+typedef struct iree_task_partition_t iree_task_partition_t;
 typedef struct iree_task_pool_t iree_task_pool_t;
 typedef struct iree_task_scope_t iree_task_scope_t;
 typedef struct iree_task_submission_t iree_task_submission_t;
 
+//==============================================================================
+// Task scheduling priority
+//==============================================================================
+
+// Scheduling priority of a task as assigned by the scope it belongs to.
+// Workers run ready tasks of a higher priority before any of a lower priority
+// and dispatches yield between tile reservations when higher priority work
+// arrives on the worker executing them. Lower values are more urgent and the
+// values are dense such that they can be used as indices.
+typedef enum iree_task_priority_e {
+  // Latency-sensitive work such as interactive requests.
+  IREE_TASK_PRIORITY_HIGH = 0,
+  // Default priority of all scopes.
+  IREE_TASK_PRIORITY_NORMAL = 1,
+  // Throughput-oriented work such as batch jobs that should only use the
+  // executor when nothing else needs it.
+  IREE_TASK_PRIORITY_LOW = 2,
+} iree_task_priority_t;
+
+// Total number of iree_task_priority_t levels.
+#define IREE_TASK_PRIORITY_COUNT 3
+
+// Returns a bitmask of (1 << priority) bits for all priority levels that are
+// more urgent than |priority|.
+static inline uint32_t iree_task_priority_mask_above(
+    iree_task_priority_t priority) {
+  return (1u << priority) - 1u;
+}
+
 //==============================================================================
 // Task header for internal tracking
 //==============================================================================
@@ -558,9 +589,18 @@ typedef iree_status_t(IREE_API_PTR* iree_task_dispatch_closure_fn_t)(
     void* user_context, const iree_task_tile_context_t* tile_context,
     iree_task_submission_t* pending_submission);
 
+// Function called per contiguous range of |tile_count| tiles.
+// |tile_context| describes the first tile in the range and the remaining tiles
+// follow in x-major order through the workgroup grid (wrapping into y and z).
+// Implementations may use this to amortize per-tile overheads across all tiles
+// reserved by a shard at once.
+typedef iree_status_t(IREE_API_PTR* iree_task_dispatch_range_closure_fn_t)(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    uint32_t tile_count, iree_task_submission_t* pending_submission);
+
 // A function closure representing the function to call and its arguments.
 typedef struct iree_task_dispatch_closure_t {
-  // Function called per tile invocation.
+  // Function called per tile invocation. Unused if |range_fn| is set.
   iree_task_dispatch_closure_fn_t fn;
 
   // User-defined argument passed to task functions during invocation.
@@ -569,6 +609,9 @@ typedef struct iree_task_dispatch_closure_t {
   // system and it is required that users ensure that the memory referenced is
   // live until after the task has completed.
   void* user_context;
+
+  // Optional function called per contiguous range of tiles instead of |fn|.
+  iree_task_dispatch_range_closure_fn_t range_fn;
 } iree_task_dispatch_closure_t;
 
 // Binds a function pointer and the arguments it should be called with.
@@ -576,7 +619,17 @@ typedef struct iree_task_dispatch_closure_t {
 // has completed execution.
 static inline iree_task_dispatch_closure_t iree_task_make_dispatch_closure(
     iree_task_dispatch_closure_fn_t fn, void* user_context) {
-  iree_task_dispatch_closure_t closure = {fn, user_context};
+  iree_task_dispatch_closure_t closure = {fn, user_context, NULL};
+  return closure;
+}
+
+// Binds a range function pointer and the arguments it should be called with.
+// If the arguments represent pointers they must remain live until the task
+// has completed execution.
+static inline iree_task_dispatch_closure_t
+iree_task_make_dispatch_range_closure(
+    iree_task_dispatch_range_closure_fn_t range_fn, void* user_context) {
+  iree_task_dispatch_closure_t closure = {NULL, user_context, range_fn};
   return closure;
 }
 
@@ -584,6 +637,38 @@ static inline iree_task_dispatch_closure_t iree_task_make_dispatch_closure(
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
 
+// Order in which the tiles of a dispatch are handed out to shards.
+// Concurrently executing shards process tiles that are close to each other in
+// the order and the order can be used to improve the locality of the operand
+// data they share. All orders traverse the grid one z slice at a time.
+typedef enum iree_task_dispatch_order_e {
+  // x-major order: each row of the grid is processed before the next.
+  IREE_TASK_DISPATCH_ORDER_LINEAR = 0,
+  // y-major order: each column of the grid is processed before the next.
+  IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR = 1,
+  // Morton (Z-order) within square blocks of order_group_size (a power of two)
+  // tiles per side. Blocks are processed in x-major order and partial blocks
+  // along the grid edges are processed in x-major order within the block.
+  IREE_TASK_DISPATCH_ORDER_MORTON = 2,
+  // Grouped order as used by GPU grouped launches: the grid is split into
+  // bands of order_group_size rows and each band is processed in y-major order
+  // before the next. Tiles processed together share both the rows of one
+  // operand and the columns of the other.
+  IREE_TASK_DISPATCH_ORDER_GROUPED = 3,
+} iree_task_dispatch_order_t;
+
+// Default order_group_size used when the dispatch does not specify one.
+#define IREE_TASK_DISPATCH_DEFAULT_ORDER_GROUP_SIZE 8
+
+// Returns the workgroup XYZ of the |tile_index|-th tile visited when traversing
+// a grid of |workgroup_count| tiles in |order|. |group_size| is the
+// order-specific group size (or 0 for the default).
+void iree_task_dispatch_order_tile_xyz(iree_task_dispatch_order_t order,
+                                       uint32_t group_size,
+                                       const uint32_t workgroup_count[3],
+                                       uint32_t tile_index,
+                                       uint32_t out_workgroup_xyz[3]);
+
 // An execution request across a tiled grid.
 // Dispatches are fork points where zero or more dispatch shard tasks are
 // spawned and processed prior to joining again on the dispatch completion task.
@@ -628,6 +713,14 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // dispatch closure.
   uint32_t local_memory_size;
 
+  // Order in which tiles are processed. Defaults to linear order and may be
+  // changed by the dispatch creator after initialization. Range closures are
+  // called once per run of tiles that are contiguous in x-major order.
+  iree_task_dispatch_order_t order;
+  // Order-specific group size or 0 to use the default. See
+  // iree_task_dispatch_order_t.
+  uint32_t order_group_size;
+
   // Resulting status from the dispatch available once all workgroups have
   // completed (or would have completed). If multiple shards processing the
   // workgroups hit an error the first will be taken and the result ignored. A
@@ -655,6 +748,14 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
 
   // Incrementing process-lifetime dispatch identifier.
   IREE_TRACE(int64_t dispatch_id;)
+
+#if IREE_STATISTICS_ENABLE
+  // Optional histogram observing the issue-to-retire duration of the dispatch.
+  // Set by the dispatch creator after initialization.
+  iree_metric_t* duration_metric;
+  // Time the dispatch was issued when |duration_metric| is set.
+  iree_time_t issue_time_ns;
+#endif  // IREE_STATISTICS_ENABLE
 } iree_task_dispatch_t;
 
 void iree_task_dispatch_initialize(iree_task_scope_t* scope,
@@ -10,6 +10,7 @@
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
+#include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
@@ -17,6 +18,11 @@
 extern "C" {
 #endif
 
+// Returns the scheduling priority of |task| as assigned by its scope.
+static inline iree_task_priority_t iree_task_priority(const iree_task_t* task) {
+  return task->scope->priority;
+}
+
 //==============================================================================
 // IREE_TASK_TYPE_NOP
 //==============================================================================
@@ -86,9 +92,12 @@ void iree_task_wait_retire(iree_task_wait_t* task,
 // execution prior to the shards and end execution after the last shard
 // finishes.
 //
+// One shard is issued to each worker in |worker_mask| (up to the tile count).
+//
 // Only called during coordination and expects the coordinator lock to be held.
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
+                              iree_task_affinity_set_t worker_mask,
                               iree_task_submission_t* pending_submission,
                               iree_task_post_batch_t* post_batch);
 
@@ -118,11 +127,23 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
 //
+// |worker_throughput| is the relative throughput of the executing worker's
+// processor as defined by iree_task_topology_group_t::throughput. Workers on
+// slower processors reserve proportionally fewer tiles at a time.
+//
+// |preempt_priority_mask| is an optional bitmask of (1 << iree_task_priority_t)
+// bits indicating the priorities of work that has arrived for the executing
+// worker. It is polled between tile reservations and if any work more urgent
+// than the shard has arrived the shard yields: it returns false without being
+// retired and the caller must requeue it to continue processing later.
+// Returns true if the shard has been retired.
+//
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
-void iree_task_dispatch_shard_execute(
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    uint32_t worker_throughput, iree_atomic_int32_t* preempt_priority_mask,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
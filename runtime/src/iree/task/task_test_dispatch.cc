@@ -4,9 +4,11 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <array>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <vector>
 
 #include "iree/base/api.h"
 #include "iree/task/submission.h"
@@ -62,6 +64,27 @@ class GridCoverage {
     return iree_ok_status();
   }
 
+  static iree_status_t Range(void* user_context,
+                             const iree_task_tile_context_t* tile_context,
+                             uint32_t tile_count,
+                             iree_task_submission_t* pending_submission) {
+    iree_task_tile_context_t range_context = *tile_context;
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      IREE_RETURN_IF_ERROR(
+          Tile(user_context, &range_context, pending_submission));
+      if (++range_context.workgroup_xyz[0] < tile_context->workgroup_count[0]) {
+        continue;
+      }
+      range_context.workgroup_xyz[0] = 0;
+      if (++range_context.workgroup_xyz[1] < tile_context->workgroup_count[1]) {
+        continue;
+      }
+      range_context.workgroup_xyz[1] = 0;
+      ++range_context.workgroup_xyz[2];
+    }
+    return iree_ok_status();
+  }
+
  private:
   size_t workgroup_count_;
   std::unique_ptr<iree_atomic_int32_t[]> storage_;
@@ -69,9 +92,11 @@ class GridCoverage {
 
 class TaskDispatchTest : public TaskTest {
  public:
-  void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
-                             const uint32_t workgroup_count[3],
-                             uint32_t dispatch_flags) {
+  void DispatchAndVerifyGrid(
+      const uint32_t workgroup_size[3], const uint32_t workgroup_count[3],
+      uint32_t dispatch_flags,
+      iree_task_dispatch_order_t order = IREE_TASK_DISPATCH_ORDER_LINEAR,
+      uint32_t order_group_size = 0) {
     IREE_TRACE_SCOPE();
     GridCoverage coverage(workgroup_count);
     iree_task_dispatch_t task;
@@ -80,6 +105,26 @@ class TaskDispatchTest : public TaskTest {
         iree_task_make_dispatch_closure(GridCoverage::Tile, (void*)&coverage),
         workgroup_size, workgroup_count, &task);
     task.header.flags |= dispatch_flags;
+    task.order = order;
+    task.order_group_size = order_group_size;
+    IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+    EXPECT_TRUE(coverage.Verify());
+  }
+
+  void DispatchRangesAndVerifyGrid(
+      const uint32_t workgroup_size[3], const uint32_t workgroup_count[3],
+      iree_task_dispatch_order_t order = IREE_TASK_DISPATCH_ORDER_LINEAR,
+      uint32_t order_group_size = 0) {
+    IREE_TRACE_SCOPE();
+    GridCoverage coverage(workgroup_count);
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_range_closure(GridCoverage::Range,
+                                              (void*)&coverage),
+        workgroup_size, workgroup_count, &task);
+    task.order = order;
+    task.order_group_size = order_group_size;
     IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
     EXPECT_TRUE(coverage.Verify());
   }
@@ -113,6 +158,88 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+TEST_F(TaskDispatchTest, IssueRange345) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchRangesAndVerifyGrid(kWorkgroupSize, kWorkgroupCount);
+}
+
+// Large enough that shards reserve multiple tiles at a time and ranges wrap
+// across rows and slices.
+TEST_F(TaskDispatchTest, IssueRangeLarge) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {61, 17, 3};
+  DispatchRangesAndVerifyGrid(kWorkgroupSize, kWorkgroupCount);
+}
+
+// Tests the tile traversal orders on small grids where the expected order can
+// be listed.
+TEST(TaskDispatchOrderTest, TileOrder) {
+  auto traverse = [](iree_task_dispatch_order_t order, uint32_t group_size,
+                     const uint32_t workgroup_count[3]) {
+    std::vector<std::array<uint32_t, 3>> tiles;
+    uint32_t tile_count =
+        workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      std::array<uint32_t, 3> xyz;
+      iree_task_dispatch_order_tile_xyz(order, group_size, workgroup_count, i,
+                                        xyz.data());
+      tiles.push_back(xyz);
+    }
+    return tiles;
+  };
+  using Tiles = std::vector<std::array<uint32_t, 3>>;
+
+  const uint32_t k322[3] = {3, 2, 2};
+  EXPECT_EQ(traverse(IREE_TASK_DISPATCH_ORDER_LINEAR, 0, k322),
+            (Tiles{{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {0, 1, 0}, {1, 1, 0},
+                   {2, 1, 0}, {0, 0, 1}, {1, 0, 1}, {2, 0, 1}, {0, 1, 1},
+                   {1, 1, 1}, {2, 1, 1}}));
+  EXPECT_EQ(traverse(IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR, 0, k322),
+            (Tiles{{0, 0, 0}, {0, 1, 0}, {1, 0, 0}, {1, 1, 0}, {2, 0, 0},
+                   {2, 1, 0}, {0, 0, 1}, {0, 1, 1}, {1, 0, 1}, {1, 1, 1},
+                   {2, 0, 1}, {2, 1, 1}}));
+
+  // 2x2 Morton blocks with a partial block along the right and bottom edges.
+  const uint32_t k531[3] = {5, 3, 1};
+  EXPECT_EQ(traverse(IREE_TASK_DISPATCH_ORDER_MORTON, 2, k531),
+            (Tiles{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {2, 0, 0},
+                   {3, 0, 0}, {2, 1, 0}, {3, 1, 0}, {4, 0, 0}, {4, 1, 0},
+                   {0, 2, 0}, {1, 2, 0}, {2, 2, 0}, {3, 2, 0}, {4, 2, 0}}));
+
+  // Bands of 2 rows with a partial band at the bottom.
+  EXPECT_EQ(traverse(IREE_TASK_DISPATCH_ORDER_GROUPED, 2, k531),
+            (Tiles{{0, 0, 0}, {0, 1, 0}, {1, 0, 0}, {1, 1, 0}, {2, 0, 0},
+                   {2, 1, 0}, {3, 0, 0}, {3, 1, 0}, {4, 0, 0}, {4, 1, 0},
+                   {0, 2, 0}, {1, 2, 0}, {2, 2, 0}, {3, 2, 0}, {4, 2, 0}}));
+}
+
+TEST_F(TaskDispatchTest, IssueOrdered) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 19, 3};
+  for (auto order :
+       {IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR, IREE_TASK_DISPATCH_ORDER_MORTON,
+        IREE_TASK_DISPATCH_ORDER_GROUPED}) {
+    DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE,
+                          order, /*order_group_size=*/4);
+  }
+}
+
+TEST_F(TaskDispatchTest, IssueRangeOrdered) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 19, 3};
+  for (auto order :
+       {IREE_TASK_DISPATCH_ORDER_COLUMN_MAJOR, IREE_TASK_DISPATCH_ORDER_MORTON,
+        IREE_TASK_DISPATCH_ORDER_GROUPED}) {
+    DispatchRangesAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, order,
+                                /*order_group_size=*/4);
+  }
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -17,6 +17,7 @@ void iree_task_topology_group_initialize(
   out_group->group_index = group_index;
   snprintf(out_group->name, IREE_ARRAYSIZE(out_group->name), "iree-worker-%u",
            group_index);
+  out_group->throughput = IREE_TASK_TOPOLOGY_MAX_THROUGHPUT;
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
   out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
 }
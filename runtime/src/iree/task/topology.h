@@ -37,6 +37,27 @@ iree_host_size_t iree_task_topology_query_node_count(void);
 // is not available on the platform.
 iree_task_topology_node_id_t iree_task_topology_query_current_node(void);
 
+//===----------------------------------------------------------------------===//
+// Core classes
+//===----------------------------------------------------------------------===//
+
+// Classes of physical cores on heterogeneous (hybrid) systems such as those
+// with Intel P-cores and E-cores or Arm big.LITTLE clusters. Systems with only
+// one kind of core report all cores as performance cores.
+typedef enum iree_task_topology_core_class_e {
+  // Selects cores of all classes. Workers on slower cores are weighted by
+  // their relative throughput when distributing work.
+  IREE_TASK_TOPOLOGY_CORE_CLASS_ANY = 0,
+  // Selects only the high-performance cores.
+  IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE,
+  // Selects only the power-efficient cores.
+  IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY,
+} iree_task_topology_core_class_t;
+
+// Throughput assigned to the fastest cores in the system.
+// Slower cores have proportionally lower throughput values down to 1.
+#define IREE_TASK_TOPOLOGY_MAX_THROUGHPUT 256
+
 //===----------------------------------------------------------------------===//
 // Topology group (worker thread(s) assigned to a processor)
 //===----------------------------------------------------------------------===//
@@ -63,6 +84,12 @@ typedef struct iree_task_topology_group_t {
   // Processor index in the cpuinfo set.
   uint32_t processor_index;
 
+  // Throughput of the processor relative to the fastest processor in the
+  // system in the range [1, IREE_TASK_TOPOLOGY_MAX_THROUGHPUT]. Workers on
+  // slower processors take smaller slices of dispatches so that they don't
+  // hold up dispatch completion on hybrid systems.
+  uint32_t throughput;
+
   // Ideal thread affinity for threads within this group.
   // All threads within the group share the same affinity and this is what
   // allows us to model Simultaneous Multi-Threading (SMT) (aka hyperthreading).
@@ -159,6 +186,18 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
     iree_task_topology_t* out_topology);
 
+// Initializes a topology with one group for each physical core of the given
+// |core_class| with the given NUMA node ID. Up to |max_core_count| physical
+// cores will be selected from the node. Each group is assigned the throughput
+// of its core relative to the fastest core in the system.
+//
+// Returns IREE_STATUS_UNAVAILABLE if no cores of |core_class| exist on the
+// node, such as when requesting efficiency cores on a homogeneous system.
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_class(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_class_t core_class,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -42,6 +42,21 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   return iree_ok_status();
 }
 
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_class(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_class_t core_class,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  // Without cpuinfo we can't tell cores apart and treat them all as
+  // performance cores.
+  if (core_class == IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY) {
+    iree_task_topology_initialize(out_topology);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "core classes cannot be queried without cpuinfo");
+  }
+  iree_task_topology_initialize_fallback(max_core_count, out_topology);
+  return iree_ok_status();
+}
+
 #else
 
 #include <cpuinfo.h>
@@ -230,6 +245,126 @@ static bool iree_task_topology_core_filter_by_cluster_id(
   return core->cluster->cluster_id == cluster_id;
 }
 
+// Returns true if |uarch| is only used for the power-efficient cores of
+// heterogeneous systems (the LITTLE cores of Arm big.LITTLE).
+static bool iree_task_topology_is_efficiency_uarch(enum cpuinfo_uarch uarch) {
+  switch (uarch) {
+    case cpuinfo_uarch_cortex_a5:
+    case cpuinfo_uarch_cortex_a7:
+    case cpuinfo_uarch_cortex_a53:
+    case cpuinfo_uarch_cortex_a55r0:
+    case cpuinfo_uarch_cortex_a55:
+    case cpuinfo_uarch_cortex_a510:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Information about all cores in the system used to classify each core.
+typedef struct iree_task_topology_core_summary_t {
+  // Maximum frequency of the fastest core or 0 if unknown.
+  uint64_t max_frequency;
+  // Microarchitecture of the fastest core.
+  enum cpuinfo_uarch max_frequency_uarch;
+  // True if the system has more than one class of core.
+  bool is_heterogeneous;
+} iree_task_topology_core_summary_t;
+
+// Returns true if |core| looks like an efficiency core when compared against
+// the fastest core in the system. cpuinfo does not directly report core
+// classes so we rely on known efficiency microarchitectures (Arm) and
+// otherwise on cores of a different microarchitecture running significantly
+// slower than the fastest core (Intel hybrid). Performance cores that differ
+// only in their boost frequency share the microarchitecture of the fastest
+// core and are not matched.
+static bool iree_task_topology_core_looks_efficient(
+    const struct cpuinfo_core* core,
+    const iree_task_topology_core_summary_t* summary) {
+  if (iree_task_topology_is_efficiency_uarch(core->uarch)) return true;
+  return summary->max_frequency && core->frequency &&
+         core->uarch != summary->max_frequency_uarch &&
+         core->frequency * 5 < summary->max_frequency * 4;
+}
+
+// Summarizes all cores in the system.
+static void iree_task_topology_summarize_cores(
+    iree_task_topology_core_summary_t* out_summary) {
+  memset(out_summary, 0, sizeof(*out_summary));
+  out_summary->max_frequency_uarch = cpuinfo_get_core(0)->uarch;
+  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); ++i) {
+    const struct cpuinfo_core* core = cpuinfo_get_core(i);
+    if (core->frequency > out_summary->max_frequency) {
+      out_summary->max_frequency = core->frequency;
+      out_summary->max_frequency_uarch = core->uarch;
+    }
+  }
+  // The system is heterogeneous only if it has a mix of core classes; a
+  // system of only little cores treats them all as performance cores.
+  iree_host_size_t efficiency_core_count = 0;
+  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); ++i) {
+    if (iree_task_topology_core_looks_efficient(cpuinfo_get_core(i),
+                                                out_summary)) {
+      ++efficiency_core_count;
+    }
+  }
+  out_summary->is_heterogeneous =
+      efficiency_core_count > 0 &&
+      efficiency_core_count < cpuinfo_get_cores_count();
+}
+
+// Returns the class of |core| within the system described by |summary|.
+static iree_task_topology_core_class_t iree_task_topology_classify_core(
+    const struct cpuinfo_core* core,
+    const iree_task_topology_core_summary_t* summary) {
+  return summary->is_heterogeneous &&
+                 iree_task_topology_core_looks_efficient(core, summary)
+             ? IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY
+             : IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE;
+}
+
+// Estimates the throughput of |core| relative to the fastest core.
+// Cores are scaled by their maximum frequency when known. Efficiency cores
+// have narrower pipelines than performance cores and are assumed to retire
+// half as much work per cycle. This is only a heuristic used to balance work
+// and does not need to be precise.
+static uint32_t iree_task_topology_estimate_core_throughput(
+    const struct cpuinfo_core* core,
+    const iree_task_topology_core_summary_t* summary) {
+  uint64_t throughput = IREE_TASK_TOPOLOGY_MAX_THROUGHPUT;
+  if (summary->max_frequency && core->frequency) {
+    throughput = throughput * core->frequency / summary->max_frequency;
+  }
+  if (iree_task_topology_classify_core(core, summary) ==
+      IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY) {
+    throughput /= 2;
+  }
+  return (uint32_t)iree_min(iree_max(throughput, 1),
+                            IREE_TASK_TOPOLOGY_MAX_THROUGHPUT);
+}
+
+// Filter data for iree_task_topology_core_filter_by_cluster_id_and_class.
+typedef struct iree_task_topology_core_class_filter_t {
+  iree_task_topology_node_id_t cluster_id;
+  iree_task_topology_core_class_t core_class;
+  const iree_task_topology_core_summary_t* summary;
+} iree_task_topology_core_class_filter_t;
+
+// Matches all cores that have the provided cluster ID and core class.
+// |user_data| is a pointer to an iree_task_topology_core_class_filter_t.
+static bool iree_task_topology_core_filter_by_cluster_id_and_class(
+    const struct cpuinfo_core* core, uintptr_t user_data) {
+  const iree_task_topology_core_class_filter_t* filter =
+      (const iree_task_topology_core_class_filter_t*)user_data;
+  if (!iree_task_topology_core_filter_by_cluster_id(
+          core, (uintptr_t)filter->cluster_id)) {
+    return false;
+  }
+  return filter->core_class == IREE_TASK_TOPOLOGY_CORE_CLASS_ANY ||
+         iree_task_topology_classify_core(core, filter->summary) ==
+             filter->core_class;
+}
+
 // Initializes a topology with one group for each core that matches |filter_fn|.
 //
 // If cpuinfo is not available this falls back to the same behavior as
@@ -283,9 +418,52 @@ static void iree_task_topology_initialize_from_physical_cores_with_filter(
 iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
     iree_task_topology_t* out_topology) {
+  return iree_task_topology_initialize_from_physical_cores_of_class(
+      node_id, IREE_TASK_TOPOLOGY_CORE_CLASS_ANY, max_core_count,
+      out_topology);
+}
+
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_class(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_class_t core_class,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  if (!iree_task_topology_is_cpuinfo_available()) {
+    if (core_class == IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY) {
+      iree_task_topology_initialize(out_topology);
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "core classes cannot be queried");
+    }
+    iree_task_topology_initialize_fallback(max_core_count, out_topology);
+    return iree_ok_status();
+  }
+
+  iree_task_topology_core_summary_t summary;
+  iree_task_topology_summarize_cores(&summary);
+  iree_task_topology_core_class_filter_t filter = {
+      .cluster_id = node_id,
+      .core_class = core_class,
+      .summary = &summary,
+  };
   iree_task_topology_initialize_from_physical_cores_with_filter(
-      iree_task_topology_core_filter_by_cluster_id, (uintptr_t)node_id,
-      max_core_count, out_topology);
+      iree_task_topology_core_filter_by_cluster_id_and_class,
+      (uintptr_t)&filter, max_core_count, out_topology);
+  if (core_class != IREE_TASK_TOPOLOGY_CORE_CLASS_ANY &&
+      out_topology->group_count == 0) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE, "no %s cores found with NUMA node ID %u",
+        core_class == IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE ? "performance"
+                                                                : "efficiency",
+        node_id);
+  }
+
+  // Weight each group by the throughput of its core so that work is balanced
+  // between classes of cores on hybrid systems.
+  for (iree_host_size_t i = 0; i < out_topology->group_count; ++i) {
+    iree_task_topology_group_t* group = &out_topology->groups[i];
+    group->throughput = iree_task_topology_estimate_core_throughput(
+        cpuinfo_get_processor(group->processor_index)->core, &summary);
+  }
+
   return iree_ok_status();
 }
 
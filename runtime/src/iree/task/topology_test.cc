@@ -60,6 +60,7 @@ TEST(TopologyTest, Construction) {
     const iree_task_topology_group_t* group =
         iree_task_topology_get_group(&topology, i);
     EXPECT_EQ(i, group->group_index);
+    EXPECT_EQ(IREE_TASK_TOPOLOGY_MAX_THROUGHPUT, group->throughput);
   }
 
   iree_task_topology_deinitialize(&topology);
@@ -131,6 +132,8 @@ static void EnsureTopologyValid(iree_host_size_t max_group_count,
     const iree_task_topology_group_t* group =
         iree_task_topology_get_group(topology, i);
     EXPECT_EQ(i, group->group_index);
+    EXPECT_GE(group->throughput, 1);
+    EXPECT_LE(group->throughput, IREE_TASK_TOPOLOGY_MAX_THROUGHPUT);
   }
 }
 
@@ -144,4 +147,17 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// All systems have performance cores (homogeneous systems only have those) but
+// only hybrid systems have efficiency cores so we can't check for them here.
+TEST(TopologyTest, FromPerformanceCores) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_physical_cores_of_class(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE,
+      kMaxGroupCount, &topology));
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
@@ -89,9 +89,44 @@ static void iree_task_topology_assign_constructive_sharing(
   }
 }
 
+// Returns true if |processor| is of |core_class|. Windows reports an
+// EfficiencyClass per core where higher values are more performant and all
+// cores have the same value on homogeneous systems.
+static bool iree_task_topology_core_matches_class(
+    const PROCESSOR_RELATIONSHIP* processor,
+    iree_task_topology_core_class_t core_class, BYTE max_efficiency_class) {
+  switch (core_class) {
+    default:
+    case IREE_TASK_TOPOLOGY_CORE_CLASS_ANY:
+      return true;
+    case IREE_TASK_TOPOLOGY_CORE_CLASS_PERFORMANCE:
+      return processor->EfficiencyClass == max_efficiency_class;
+    case IREE_TASK_TOPOLOGY_CORE_CLASS_EFFICIENCY:
+      return processor->EfficiencyClass < max_efficiency_class;
+  }
+}
+
+// Estimates the throughput of |processor| relative to the fastest core.
+// Windows doesn't report per-core frequencies so cores in lower efficiency
+// classes are assumed to have half the throughput of the class above them.
+static uint32_t iree_task_topology_estimate_core_throughput(
+    const PROCESSOR_RELATIONSHIP* processor, BYTE max_efficiency_class) {
+  uint32_t shift = max_efficiency_class - processor->EfficiencyClass;
+  return iree_max(1u, IREE_TASK_TOPOLOGY_MAX_THROUGHPUT >> iree_min(shift, 8));
+}
+
 iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id, iree_host_size_t max_core_count,
     iree_task_topology_t* out_topology) {
+  return iree_task_topology_initialize_from_physical_cores_of_class(
+      node_id, IREE_TASK_TOPOLOGY_CORE_CLASS_ANY, max_core_count,
+      out_topology);
+}
+
+iree_status_t iree_task_topology_initialize_from_physical_cores_of_class(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_core_class_t core_class,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)node_id);
 
@@ -175,6 +210,15 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
       }
     }
   }
+  BYTE max_efficiency_class = 0;
+  for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* p = all_relationships;
+       p < all_relationships_end;
+       p = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)p + p->Size)) {
+    if (p->Relationship == RelationProcessorCore) {
+      max_efficiency_class =
+          iree_max(max_efficiency_class, p->Processor.EfficiencyClass);
+    }
+  }
   iree_host_size_t total_core_count = 0;
   iree_host_size_t selected_core_count = 0;
   for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* p = all_relationships;
@@ -182,7 +226,9 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
        p = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)p + p->Size)) {
     if (p->Relationship == RelationProcessorCore) {
       assert(p->Processor.GroupCount == 1);
-      if (group_table[p->Processor.GroupMask[0].Group].selected) {
+      if (group_table[p->Processor.GroupMask[0].Group].selected &&
+          iree_task_topology_core_matches_class(&p->Processor, core_class,
+                                                max_efficiency_class)) {
         ++group_table[p->Processor.GroupMask[0].Group].core_count;
         ++selected_core_count;
       }
@@ -192,7 +238,8 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   if (!selected_core_count) {
     IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                            "no processors found with NUMA node ID %u",
+                            "no processors of the requested class found with "
+                            "NUMA node ID %u",
                             node_id);
   }
 
@@ -239,23 +286,33 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   // sense vs being random as it is now.
 
   // Initialize all topology groups from the selected cores.
-  for (iree_host_size_t used_core_index = 0; used_core_index < used_core_count;
-       ++used_core_index) {
-    iree_host_size_t adjusted_core_index = used_core_index;
+  for (iree_host_size_t core_index = 0;
+       core_index < total_core_count &&
+       out_topology->group_count < used_core_count;
+       ++core_index) {
+    iree_host_size_t adjusted_core_index = core_index;
     if (base_group->selected) {
       // Rotate the starting core index by the base core such that we only use
       // the base core if all other available cores are utilized.
       adjusted_core_index =
-          (((base_core_index + 1) % total_core_count) + used_core_index) %
+          (((base_core_index + 1) % total_core_count) + core_index) %
           total_core_count;
     }
+    const PROCESSOR_RELATIONSHIP* core = all_cores[adjusted_core_index];
+    if (!group_table[core->GroupMask[0].Group].selected ||
+        !iree_task_topology_core_matches_class(core, core_class,
+                                               max_efficiency_class)) {
+      continue;
+    }
     uint8_t group_index = (uint8_t)out_topology->group_count++;
     iree_task_topology_group_t* group = &out_topology->groups[group_index];
     iree_task_topology_group_initialize(group_index, group);
     group->processor_index = (uint32_t)adjusted_core_index;
+    group->throughput =
+        iree_task_topology_estimate_core_throughput(core, max_efficiency_class);
     group->constructive_sharing_mask = 0;  // set below
     iree_task_topology_set_affinity_from_processor(
-        all_cores[adjusted_core_index], &group->ideal_thread_affinity);
+        core, &group->ideal_thread_affinity);
   }
 
   // Assign constructive sharing masks to each topology group. These indicate
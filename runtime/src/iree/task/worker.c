@@ -34,6 +34,13 @@ iree_status_t iree_task_worker_initialize(
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
+  out_worker->throughput = topology_group->throughput;
+  out_worker->partition = &executor->default_partition;
+  iree_atomic_task_affinity_set_store(
+      &out_worker->partition_mask,
+      iree_atomic_task_affinity_set_load(
+          &executor->default_partition.worker_mask, iree_memory_order_relaxed),
+      iree_memory_order_relaxed);
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
@@ -45,7 +52,11 @@ iree_status_t iree_task_worker_initialize(
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
-  iree_task_queue_initialize(&out_worker->local_task_queue);
+  iree_atomic_store_int32(&out_worker->mailbox_priority_mask, 0,
+                          iree_memory_order_relaxed);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_queue_initialize(&out_worker->local_task_queues[i]);
+  }
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   iree_atomic_store_int32(&out_worker->state, initial_state,
@@ -130,40 +141,129 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_list_discard(&worker->local_task_queues[i].list);
+  }
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
-  iree_task_queue_deinitialize(&worker->local_task_queue);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_queue_deinitialize(&worker->local_task_queues[i]);
+  }
 
   IREE_TRACE_ZONE_END(z0);
 }
 
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list) {
+  // Gather the priorities of the tasks while we still own the list.
+  int32_t priority_mask = 0;
+  for (iree_task_t* task = list->head; task; task = task->next_task) {
+    priority_mask |= 1 << iree_task_priority(task);
+  }
+
   // Move the list into the mailbox. Note that the mailbox is LIFO and this list
   // is concatenated with its current order preserved (which should be LIFO).
   iree_atomic_task_slist_concat(&worker->mailbox_slist, list->head, list->tail);
   memset(list, 0, sizeof(*list));
+
+  // Publish the priorities only after the tasks are visible in the mailbox so
+  // that a worker observing the bits is guaranteed to find the tasks.
+  iree_atomic_fetch_or_int32(&worker->mailbox_priority_mask, priority_mask,
+                             iree_memory_order_relaxed);
 }
 
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
+                                             iree_task_queue_t* target_queues,
                                              iree_host_size_t max_tasks) {
-  // Try to grab tasks from the worker; if more than one task is stolen then the
-  // first will be returned and the remaining will be added to the target queue.
-  iree_task_t* task = iree_task_queue_try_steal(&worker->local_task_queue,
-                                                target_queue, max_tasks);
-  if (task) return task;
+  // Try to grab tasks from the worker starting with its most urgent queue; if
+  // more than one task is stolen then the first will be returned and the
+  // remaining will be added to the target queue of the same priority.
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_t* task = iree_task_queue_try_steal(
+        &worker->local_task_queues[i], &target_queues[i], max_tasks);
+    if (task) return task;
+  }
 
   // If we still didn't steal any tasks then let's try the slist instead.
-  task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
-  if (task) return task;
+  return iree_atomic_task_slist_pop(&worker->mailbox_slist);
+}
+
+iree_host_size_t iree_task_worker_queued_task_count(
+    iree_task_worker_t* worker) {
+  iree_host_size_t task_count = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    task_count +=
+        iree_task_queue_calculate_size(&worker->local_task_queues[i]);
+  }
+  return task_count;
+}
+
+void iree_task_worker_append_local_tasks(iree_task_worker_t* worker,
+                                         iree_task_list_t* list) {
+  // Split the list by priority outside of the queue locks. Nearly all lists
+  // contain tasks of a single priority and will only touch one queue.
+  iree_task_list_t priority_lists[IREE_TASK_PRIORITY_COUNT];
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_list_initialize(&priority_lists[i]);
+  }
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(list))) {
+    iree_task_list_push_back(&priority_lists[iree_task_priority(task)], task);
+  }
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    if (iree_task_list_is_empty(&priority_lists[i])) continue;
+    iree_task_queue_append_from_fifo_list_unsafe(&worker->local_task_queues[i],
+                                                 &priority_lists[i]);
+  }
+}
+
+// Flushes the worker mailbox into the local queues matching the priorities of
+// the posted tasks.
+static void iree_task_worker_flush_mailbox(iree_task_worker_t* worker) {
+  // Clear the priority mask before flushing so that any tasks posted after the
+  // flush will set it again.
+  iree_atomic_store_int32(&worker->mailbox_priority_mask, 0,
+                          iree_memory_order_relaxed);
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (iree_atomic_task_slist_flush(
+          &worker->mailbox_slist,
+          IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_FIFO, &list.head,
+          &list.tail)) {
+    iree_task_worker_append_local_tasks(worker, &list);
+  }
+}
 
+// Pops the next task from the most urgent non-empty local queue.
+// If tasks more urgent than any queued have been posted to the mailbox they are
+// flushed into the local queues first. Returns NULL if the local queues are
+// empty.
+static iree_task_t* iree_task_worker_pop_local_task(
+    iree_task_worker_t* worker) {
+  uint32_t mailbox_priority_mask = (uint32_t)iree_atomic_load_int32(
+      &worker->mailbox_priority_mask, iree_memory_order_relaxed);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    if (mailbox_priority_mask & (1u << i)) {
+      iree_task_worker_flush_mailbox(worker);
+      mailbox_priority_mask = 0;
+    }
+    iree_task_t* task =
+        iree_task_queue_pop_front(&worker->local_task_queues[i]);
+    if (task) return task;
+  }
   return NULL;
 }
 
+// Returns true if any of the worker-local queues have tasks.
+static bool iree_task_worker_has_local_tasks(iree_task_worker_t* worker) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    if (!iree_task_queue_is_empty(&worker->local_task_queues[i])) return true;
+  }
+  return false;
+}
+
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
 // handled by the coordinator during scheduling.
@@ -177,16 +277,22 @@ static void iree_task_worker_execute(
   // TODO(benvanik): think a bit more about this timing; this ensures we have
   // BFS behavior at the cost of the additional merge overhead - it's probably
   // worth it?
-  // TODO(benvanik): handle partial tasks and re-queuing.
   switch (task->type) {
     case IREE_TASK_TYPE_CALL: {
       iree_task_call_execute((iree_task_call_t*)task, pending_submission);
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+      if (!iree_task_dispatch_shard_execute(
+              (iree_task_dispatch_shard_t*)task, worker->processor_id,
+              worker->worker_index, worker->local_memory, worker->throughput,
+              &worker->mailbox_priority_mask, pending_submission)) {
+        // Shard yielded to more urgent work; put it back at the head of its
+        // queue so that it resumes as soon as that work has completed. Other
+        // workers may steal it in the meantime.
+        iree_task_queue_push_front(
+            &worker->local_task_queues[iree_task_priority(task)], task);
+      }
       break;
     }
     default:
@@ -205,10 +311,10 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Check the local work queue for any work we know we should start
+  // Check the local work queues for any work we know we should start
   // processing immediately. Other workers may try to steal some of this work
   // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
+  iree_task_t* task = iree_task_worker_pop_local_task(worker);
 
   // Check the mailbox to see if we have incoming work that has been posted.
   // We try to greedily move it to our local work list so that we can work
@@ -220,20 +326,22 @@ static bool iree_task_worker_pump_once(
     // first place (large uneven workloads for various workers, bad distribution
     // in the face of heterogenous multi-core architectures where some workers
     // complete tasks faster than others, etc).
-    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
-                                                 &worker->mailbox_slist);
+    iree_task_worker_flush_mailbox(worker);
+    task = iree_task_worker_pop_local_task(worker);
   }
 
 #if IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
   // If we ran out of work assigned to this specific worker try to steal some
   // from other workers that we hopefully share some of the cache hierarchy
-  // with. Their tasks will be moved from their local queue into ours and the
-  // the first task in the queue is popped off and returned.
+  // with. Their tasks will be moved from their local queues into ours and the
+  // the first task stolen is returned.
   if (!task) {
     task = iree_task_executor_try_steal_task(
         worker->executor, worker->constructive_sharing_mask,
+        iree_atomic_task_affinity_set_load(&worker->partition_mask,
+                                           iree_memory_order_relaxed),
         worker->max_theft_attempts, &worker->theft_prng,
-        &worker->local_task_queue);
+        worker->local_task_queues);
   }
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
@@ -338,8 +446,7 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // If nothing has been enqueued since we started this loop (so even
     // coordination didn't find anything) we go idle. Otherwise we fall
     // through and try the loop again.
-    if (schedule_dirty ||
-        !iree_task_queue_is_empty(&worker->local_task_queue)) {
+    if (schedule_dirty || iree_task_worker_has_local_tasks(worker)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
     } else {
@@ -352,6 +459,7 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
           /*spin_ns=*/worker->executor->worker_spin_ns,
           /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
       IREE_TRACE_ZONE_END(z_wait);
+      iree_metric_add(worker->executor->worker_wake_metric, 1);
 
       // Woke from a wait - query the processor ID in case we migrated during
       // the sleep.
@@ -60,9 +60,18 @@ typedef struct iree_task_worker_t {
   // them based on the work distribution policy. When workers go to look for
   // more work after their local queue empties they will flush this list and
   // move all of the tasks into their local queue and restart processing.
-  // LAYOUT: must be 64b away from local_task_queue.
+  // LAYOUT: must be 64b away from local_task_queues.
   iree_atomic_task_slist_t mailbox_slist;
 
+  // A bitmask of (1 << iree_task_priority_t) bits indicating the priorities of
+  // tasks posted to mailbox_slist since the worker last flushed it. Used by the
+  // worker to flush urgent work ahead of what it has queued locally and polled
+  // by long-running tasks to decide when they should yield.
+  // Bits are set after tasks are posted and cleared before the mailbox is
+  // flushed such that the mask may be stale but never misses posted work.
+  // LAYOUT: next to mailbox_slist as they are always accessed together.
+  iree_atomic_int32_t mailbox_priority_mask;
+
   // Current state of the worker (iree_task_worker_state_t).
   // LAYOUT: frequent access; next to wake_notification as they are always
   //         accessed together.
@@ -98,6 +107,20 @@ typedef struct iree_task_worker_t {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
+  // Throughput of the worker's processor relative to the fastest processor in
+  // the system. See iree_task_topology_group_t::throughput.
+  uint32_t throughput;
+
+  // Partition the worker is assigned to.
+  // Only accessed with the executor partition_mutex held.
+  iree_task_partition_t* partition;
+
+  // Workers in the same partition as this worker, including itself. Thefts are
+  // limited to these workers such that partitions don't take on each other's
+  // work. Updated with the executor partition_mutex held and otherwise a hint
+  // accessed with memory_order_relaxed.
+  iree_atomic_task_affinity_set_t partition_mask;
+
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
   // (try stealing from these 3 other cores that share your L3 cache).
@@ -120,8 +143,8 @@ typedef struct iree_task_worker_t {
   // An opaque tag used to reduce the cost of processor ID queries.
   iree_cpu_processor_tag_t processor_tag;
 
-  // Destructive interference padding between the mailbox and local task queue
-  // to ensure that the worker - who is pounding on local_task_queue - doesn't
+  // Destructive interference padding between the mailbox and local task queues
+  // to ensure that the worker - who is pounding on local_task_queues - doesn't
   // contend with submissions or coordinators dropping new tasks in the mailbox.
   //
   // Today we don't need this, however on 32-bit systems or if we adjust the
@@ -137,19 +160,20 @@ typedef struct iree_task_worker_t {
   // workers.
   iree_byte_span_t local_memory;
 
-  // Worker-local FIFO queue containing the tasks that will be processed by the
-  // worker. This queue supports work-stealing by other workers if they run out
-  // of work of their own.
+  // Worker-local FIFO queues containing the tasks that will be processed by the
+  // worker, one per iree_task_priority_t. Tasks in a queue are only processed
+  // once all queues of higher priority are empty. These queues support
+  // work-stealing by other workers if they run out of work of their own.
   // LAYOUT: must be 64b away from mailbox_slist.
-  iree_task_queue_t local_task_queue;
+  iree_task_queue_t local_task_queues[IREE_TASK_PRIORITY_COUNT];
 } iree_task_worker_t;
-static_assert(offsetof(iree_task_worker_t, mailbox_slist) +
-                      sizeof(iree_atomic_task_slist_t) <
+static_assert(offsetof(iree_task_worker_t, mailbox_priority_mask) +
+                      sizeof(iree_atomic_int32_t) <
                   iree_hardware_constructive_interference_size,
               "mailbox_slist must be in the first cache line");
-static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
+static_assert(offsetof(iree_task_worker_t, local_task_queues) >=
                   iree_hardware_constructive_interference_size,
-              "local_task_queue must be separated from mailbox_slist by "
+              "local_task_queues must be separated from mailbox_slist by "
               "at least a cache line");
 
 // Initializes a worker by creating its thread and configuring it for receiving
@@ -190,15 +214,31 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list);
 
-// Tries to steal up to |max_tasks| from the back of the queue.
+// Tries to steal up to |max_tasks| from the back of the most urgent non-empty
+// worker queue.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
-// that were at the tail of the worker FIFO will be moved to the |target_queue|
-// and the first of the stolen tasks is returned. While tasks from the FIFO
-// are preferred this may also steal tasks from the mailbox.
+// that were at the tail of the worker FIFO will be moved to the queue of the
+// same priority in |target_queues| and the first of the stolen tasks is
+// returned. While tasks from the FIFOs are preferred this may also steal tasks
+// from the mailbox.
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
+                                             iree_task_queue_t* target_queues,
                                              iree_host_size_t max_tasks);
 
+// Returns the total number of tasks in the worker-local queues.
+// Tasks posted to the worker mailbox but not yet flushed are not included.
+//
+// May be called from any thread.
+iree_host_size_t iree_task_worker_queued_task_count(
+    iree_task_worker_t* worker);
+
+// Appends a FIFO list of tasks to the worker-local queues matching their
+// priorities.
+//
+// Must only be called from the worker thread.
+void iree_task_worker_append_local_tasks(iree_task_worker_t* worker,
+                                         iree_task_list_t* list);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -439,3 +439,34 @@ iree_status_t iree_hal_end_profiling_from_flags(iree_hal_device_t* device) {
   if (strlen(FLAG_device_profiling_mode) == 0) return iree_ok_status();
   return iree_hal_device_profiling_end(device);
 }
+
+//===----------------------------------------------------------------------===//
+// Statistics
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_device_dispatch_cache_statistics_fprint(
+    FILE* file, iree_hal_device_t* device) {
+  if (!device) return iree_ok_status();
+
+  static const char* keys[] = {
+      "hits", "misses", "bypasses", "evictions", "entries", "resident_bytes",
+  };
+  int64_t values[IREE_ARRAYSIZE(keys)] = {0};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(keys); ++i) {
+    iree_status_t status = iree_hal_device_query_i64(
+        device, IREE_SV("hal.dispatch_cache"),
+        iree_make_cstring_view(keys[i]), &values[i]);
+    if (iree_status_is_not_found(status)) {
+      // Device does not support (or has not enabled) the dispatch cache.
+      iree_status_ignore(status);
+      return iree_ok_status();
+    }
+    IREE_RETURN_IF_ERROR(status);
+  }
+
+  fprintf(file, "[[ iree_hal_device_t dispatch cache statistics ]]\n");
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(keys); ++i) {
+    fprintf(file, "  %-14s: %" PRId64 "\n", keys[i], values[i]);
+  }
+  return iree_ok_status();
+}
@@ -52,6 +52,11 @@ iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device);
 // command line flags. No-op if profiling is not enabled.
 iree_status_t iree_hal_end_profiling_from_flags(iree_hal_device_t* device);
 
+// Prints the dispatch cache statistics of |device| to |file|.
+// No-op if the device does not have a dispatch cache enabled.
+iree_status_t iree_hal_device_dispatch_cache_statistics_fprint(
+    FILE* file, iree_hal_device_t* device);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
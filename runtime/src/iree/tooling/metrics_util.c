@@ -0,0 +1,151 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/metrics_util.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/flags.h"
+
+//===----------------------------------------------------------------------===//
+// Runtime metrics
+//===----------------------------------------------------------------------===//
+
+IREE_FLAG(string, print_metrics, "",
+          "Enables runtime metrics collection and prints them on exit in the\n"
+          "given format: `json` or `prometheus` (text exposition format).\n"
+          "Metrics include invocation latency, per-queue submission latency,\n"
+          "per-export dispatch durations, allocator bytes in flight, and task\n"
+          "executor wake/steal counts.");
+
+IREE_FLAG(string, metrics_file, "",
+          "File to write metrics to when --print_metrics= is set. Defaults to\n"
+          "stderr.");
+
+iree_status_t iree_tooling_create_metrics_registry_from_flags(
+    iree_allocator_t host_allocator, iree_metrics_registry_t** out_registry) {
+  IREE_ASSERT_ARGUMENT(out_registry);
+  *out_registry = NULL;
+  if (strlen(FLAG_print_metrics) == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Verify the format early so we don't fail after a potentially long run.
+  iree_metrics_format_t format = IREE_METRICS_FORMAT_JSON;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_metrics_format_parse(iree_make_cstring_view(FLAG_print_metrics),
+                                    &format));
+
+  iree_metrics_registry_t* registry = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_metrics_registry_create(host_allocator, &registry));
+  iree_metrics_registry_set_default(registry);
+
+  *out_registry = registry;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Updates allocator gauges from the current allocator statistics.
+static iree_status_t iree_tooling_collect_allocator_metrics(
+    void* user_data, iree_metrics_registry_t* registry) {
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_t* device_allocator = (iree_hal_allocator_t*)user_data;
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(device_allocator, &statistics);
+  struct {
+    const char* name;
+    const char* labels;
+    const char* help;
+    int64_t value;
+  } gauges[] = {
+      {"iree_hal_allocator_bytes_in_flight", "heap=\"host\"",
+       "Bytes currently allocated from the device allocator.",
+       (int64_t)(statistics.host_bytes_allocated -
+                 statistics.host_bytes_freed)},
+      {"iree_hal_allocator_bytes_in_flight", "heap=\"device\"",
+       "Bytes currently allocated from the device allocator.",
+       (int64_t)(statistics.device_bytes_allocated -
+                 statistics.device_bytes_freed)},
+      {"iree_hal_allocator_bytes_peak", "heap=\"host\"",
+       "Peak bytes allocated from the device allocator.",
+       (int64_t)statistics.host_bytes_peak},
+      {"iree_hal_allocator_bytes_peak", "heap=\"device\"",
+       "Peak bytes allocated from the device allocator.",
+       (int64_t)statistics.device_bytes_peak},
+  };
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(gauges); ++i) {
+    iree_metric_t* metric = NULL;
+    IREE_RETURN_IF_ERROR(iree_metrics_registry_lookup_or_create(
+        registry, IREE_METRIC_TYPE_GAUGE,
+        iree_make_cstring_view(gauges[i].name),
+        iree_make_cstring_view(gauges[i].labels),
+        iree_make_cstring_view(gauges[i].help), &metric));
+    iree_metric_set(metric, gauges[i].value);
+  }
+#endif  // IREE_STATISTICS_ENABLE
+  return iree_ok_status();
+}
+
+iree_status_t iree_tooling_register_allocator_metrics(
+    iree_metrics_registry_t* registry, iree_hal_allocator_t* device_allocator) {
+  if (!registry || !device_allocator) return iree_ok_status();
+  iree_metrics_collector_t collector = {
+      .fn = iree_tooling_collect_allocator_metrics,
+      .user_data = device_allocator,
+  };
+  return iree_metrics_registry_register_collector(registry, collector);
+}
+
+void iree_tooling_unregister_allocator_metrics(
+    iree_metrics_registry_t* registry, iree_hal_allocator_t* device_allocator) {
+  if (!registry || !device_allocator) return;
+  iree_metrics_collector_t collector = {
+      .fn = iree_tooling_collect_allocator_metrics,
+      .user_data = device_allocator,
+  };
+  iree_metrics_registry_unregister_collector(registry, collector);
+}
+
+iree_status_t iree_tooling_write_metrics_from_flags(
+    iree_metrics_registry_t* registry) {
+  if (!registry) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_metrics_format_t format = IREE_METRICS_FORMAT_JSON;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_metrics_format_parse(iree_make_cstring_view(FLAG_print_metrics),
+                                    &format));
+
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  iree_status_t status =
+      iree_metrics_registry_format(registry, format, &builder);
+
+  FILE* file = stderr;
+  if (iree_status_is_ok(status) && strlen(FLAG_metrics_file) > 0) {
+    file = fopen(FLAG_metrics_file, "wb");
+    if (!file) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to open metrics file '%s' for writing",
+                                FLAG_metrics_file);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    if (fwrite(iree_string_builder_buffer(&builder), 1,
+               iree_string_builder_size(&builder),
+               file) != iree_string_builder_size(&builder)) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to write metrics");
+    }
+  }
+  if (file && file != stderr) fclose(file);
+
+  iree_string_builder_deinitialize(&builder);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,50 @@
+// Copyright 2023 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TOOLING_METRICS_UTIL_H_
+#define IREE_TOOLING_METRICS_UTIL_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/metrics.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Runtime metrics
+//===----------------------------------------------------------------------===//
+
+// Creates a metrics registry and installs it as the process default if
+// --print_metrics= is set. Must be called prior to creating devices/contexts
+// so that they record into the registry. Returns NULL in |out_registry| when
+// metrics are not enabled.
+iree_status_t iree_tooling_create_metrics_registry_from_flags(
+    iree_allocator_t host_allocator, iree_metrics_registry_t** out_registry);
+
+// Registers a collector exporting the statistics of |device_allocator| as
+// gauges in |registry|. The collector must be unregistered with
+// iree_tooling_unregister_allocator_metrics before the allocator is released.
+// No-op if |registry| is NULL.
+iree_status_t iree_tooling_register_allocator_metrics(
+    iree_metrics_registry_t* registry, iree_hal_allocator_t* device_allocator);
+
+// Unregisters a collector added by iree_tooling_register_allocator_metrics.
+void iree_tooling_unregister_allocator_metrics(
+    iree_metrics_registry_t* registry, iree_hal_allocator_t* device_allocator);
+
+// Writes all metrics in |registry| in the format specified by
+// --print_metrics= to the file specified by --metrics_file= (or stderr).
+// No-op if |registry| is NULL.
+iree_status_t iree_tooling_write_metrics_from_flags(
+    iree_metrics_registry_t* registry);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TOOLING_METRICS_UTIL_H_
@@ -14,6 +14,7 @@
 #include "iree/tooling/context_util.h"
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/instrument_util.h"
+#include "iree/tooling/metrics_util.h"
 #include "iree/tooling/vm_util.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
@@ -332,36 +333,61 @@ iree_status_t iree_tooling_run_module_with_data(
     int* out_exit_code) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Install the metrics registry (if enabled) prior to creating any devices or
+  // contexts so that they record into it.
+  iree_metrics_registry_t* metrics_registry = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_tooling_create_metrics_registry_from_flags(host_allocator,
+                                                          &metrics_registry));
+
   // Setup the VM context with all required modules and get the function to run.
   // This also returns the HAL device and allocator (if any) for I/O handling.
   iree_vm_context_t* context = NULL;
   iree_vm_function_t function = {0};
   iree_hal_device_t* device = NULL;
   iree_hal_allocator_t* device_allocator = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_tooling_create_run_context(instance, default_device_uri,
-                                      module_contents, host_allocator, &context,
-                                      &function, &device, &device_allocator),
-      "creating run context");
+  iree_status_t status = iree_tooling_create_run_context(
+      instance, default_device_uri, module_contents, host_allocator, &context,
+      &function, &device, &device_allocator);
+  if (!iree_status_is_ok(status)) {
+    iree_metrics_registry_free(metrics_registry);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_annotate(status, IREE_SV("creating run context"));
+  }
+  status = iree_tooling_register_allocator_metrics(metrics_registry,
+                                                   device_allocator);
 
   // Parse inputs, run the function, and process outputs.
-  iree_status_t status =
-      iree_tooling_run_function(context, function, device, device_allocator,
-                                host_allocator, out_exit_code);
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_tooling_run_function(context, function, device, device_allocator,
+                                  host_allocator, out_exit_code);
+  }
 
   // Release the context and all retained resources (variables, constants, etc).
   iree_vm_context_release(context);
 
+  // Write metrics after the context is released so allocator gauges reflect
+  // any resources that were leaked.
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_write_metrics_from_flags(metrics_registry);
+  }
+  iree_tooling_unregister_allocator_metrics(metrics_registry, device_allocator);
+
   // Print statistics after we've released the inputs/outputs and the context
   // which may be holding on to resources like constants/variables.
   if (device_allocator && FLAG_print_statistics) {
     IREE_IGNORE_ERROR(
         iree_hal_allocator_statistics_fprint(stderr, device_allocator));
   }
+  if (device && FLAG_print_statistics) {
+    IREE_IGNORE_ERROR(
+        iree_hal_device_dispatch_cache_statistics_fprint(stderr, device));
+  }
 
   iree_hal_allocator_release(device_allocator);
   iree_hal_device_release(device);
+  iree_metrics_registry_free(metrics_registry);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -12,6 +12,15 @@
 
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/debugging.h"
+#include "iree/base/internal/metrics.h"
+
+// Metrics resolved for a module when it is registered with a context so that
+// invocations need not look them up by name.
+typedef struct iree_vm_context_module_metrics_t {
+  iree_host_size_t export_count;
+  // Latency histogram of each exported function indexed by export ordinal.
+  iree_metric_t* invocation_latency[];
+} iree_vm_context_module_metrics_t;
 
 struct iree_vm_context_t {
   iree_atomic_ref_count_t ref_count;
@@ -36,6 +45,9 @@ struct iree_vm_context_t {
     iree_host_size_t capacity;
     iree_vm_module_t** modules;
     iree_vm_module_state_t** module_states;
+    // Metrics for each module or NULL if metrics were not enabled when the
+    // module was registered.
+    iree_vm_context_module_metrics_t** module_metrics;
   } list;
 };
 
@@ -246,6 +258,55 @@ static iree_status_t iree_vm_context_resolve_module_imports(
   return iree_ok_status();
 }
 
+// Resolves the metrics of |module| in the default metrics registry, if any.
+// |out_module_metrics| is set to NULL if metrics are not enabled.
+static iree_status_t iree_vm_context_resolve_module_metrics(
+    iree_vm_context_t* context, iree_vm_module_t* module,
+    iree_vm_context_module_metrics_t** out_module_metrics) {
+  *out_module_metrics = NULL;
+  iree_metrics_registry_t* registry = iree_metrics_registry_default();
+  if (!registry) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t export_count =
+      iree_vm_module_signature(module).export_function_count;
+  iree_vm_context_module_metrics_t* module_metrics = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              context->allocator,
+              sizeof(*module_metrics) +
+                  export_count * sizeof(module_metrics->invocation_latency[0]),
+              (void**)&module_metrics));
+  module_metrics->export_count = export_count;
+
+  iree_string_view_t module_name = iree_vm_module_name(module);
+  for (iree_host_size_t i = 0; i < export_count; ++i) {
+    module_metrics->invocation_latency[i] = NULL;
+    iree_vm_function_t function;
+    if (!iree_status_is_ok(iree_vm_module_lookup_function_by_ordinal(
+            module, IREE_VM_FUNCTION_LINKAGE_EXPORT, i, &function))) {
+      continue;
+    }
+    iree_string_view_t function_name = iree_vm_function_name(&function);
+    char labels[256];
+    int labels_length =
+        snprintf(labels, sizeof(labels), "function=\"%.*s.%.*s\"",
+                 (int)module_name.size, module_name.data,
+                 (int)function_name.size, function_name.data);
+    if (labels_length < 0 || labels_length >= (int)sizeof(labels)) continue;
+    iree_status_ignore(iree_metrics_registry_lookup_or_create(
+        registry, IREE_METRIC_TYPE_HISTOGRAM,
+        IREE_SV("iree_vm_invocation_latency_ns"),
+        iree_make_string_view(labels, labels_length),
+        IREE_SV("Synchronous iree_vm_invoke latency in nanoseconds."),
+        &module_metrics->invocation_latency[i]));
+  }
+
+  *out_module_metrics = module_metrics;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static void iree_vm_context_release_modules(iree_vm_context_t* context,
                                             iree_host_size_t start,
                                             iree_host_size_t end) {
@@ -282,6 +343,8 @@ static void iree_vm_context_release_modules(iree_vm_context_t* context,
 
   // Release modules now that there are no import tables remaining.
   for (int i = (int)end; i >= (int)start; --i) {
+    iree_allocator_free(context->allocator, context->list.module_metrics[i]);
+    context->list.module_metrics[i] = NULL;
     if (context->list.modules[i]) {
       iree_vm_module_release(context->list.modules[i]);
       context->list.modules[i] = NULL;
@@ -309,7 +372,8 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
 
   iree_host_size_t context_size =
       sizeof(iree_vm_context_t) + sizeof(iree_vm_module_t*) * module_count +
-      sizeof(iree_vm_module_state_t*) * module_count;
+      sizeof(iree_vm_module_state_t*) * module_count +
+      sizeof(iree_vm_context_module_metrics_t*) * module_count;
 
   iree_vm_context_t* context = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -331,6 +395,8 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
   p += sizeof(iree_vm_module_t*) * module_count;
   context->list.module_states = (iree_vm_module_state_t**)p;
   p += sizeof(iree_vm_module_state_t*) * module_count;
+  context->list.module_metrics = (iree_vm_context_module_metrics_t**)p;
+  p += sizeof(iree_vm_context_module_metrics_t*) * module_count;
   context->list.count = 0;
   context->list.capacity = module_count;
 
@@ -363,6 +429,8 @@ static void iree_vm_context_destroy(iree_vm_context_t* context) {
     context->list.modules = NULL;
     iree_allocator_free(context->allocator, context->list.module_states);
     context->list.module_states = NULL;
+    iree_allocator_free(context->allocator, context->list.module_metrics);
+    context->list.module_metrics = NULL;
   }
 
   iree_vm_instance_release(context->instance);
@@ -458,18 +526,28 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
         iree_allocator_malloc(context->allocator,
                               sizeof(iree_vm_module_state_t*) * new_capacity,
                               (void**)&new_module_state_list));
+    iree_vm_context_module_metrics_t** new_module_metrics_list = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(
+                context->allocator,
+                sizeof(iree_vm_context_module_metrics_t*) * new_capacity,
+                (void**)&new_module_metrics_list));
     memcpy(new_module_list, context->list.modules,
            sizeof(iree_vm_module_t*) * context->list.count);
     memcpy(new_module_state_list, context->list.module_states,
            sizeof(iree_vm_module_state_t*) * context->list.count);
+    memcpy(new_module_metrics_list, context->list.module_metrics,
+           sizeof(iree_vm_context_module_metrics_t*) * context->list.count);
     // The existing memory is only dynamically allocated if it has been
     // grown.
     if (context->list.capacity > 0) {
       iree_allocator_free(context->allocator, context->list.modules);
       iree_allocator_free(context->allocator, context->list.module_states);
+      iree_allocator_free(context->allocator, context->list.module_metrics);
     }
     context->list.modules = new_module_list;
     context->list.module_states = new_module_state_list;
+    context->list.module_metrics = new_module_metrics_list;
     context->list.capacity = new_capacity;
   }
 
@@ -490,9 +568,18 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
     iree_vm_module_t* module = modules[i];
     context->list.modules[original_count + i] = module;
     context->list.module_states[original_count + i] = NULL;
+    context->list.module_metrics[original_count + i] = NULL;
 
     iree_vm_module_retain(module);
 
+    // Resolve metrics once so that invocations need not look them up.
+    status = iree_vm_context_resolve_module_metrics(
+        context, module, &context->list.module_metrics[original_count + i]);
+    if (!iree_status_is_ok(status)) {
+      // Cleanup handled below.
+      break;
+    }
+
     // Allocate module state.
     iree_vm_module_state_t* module_state = NULL;
     status =
@@ -564,6 +651,21 @@ IREE_API_EXPORT iree_status_t iree_vm_context_resolve_module_state(
                                             out_module_state);
 }
 
+IREE_API_EXPORT iree_metric_t* iree_vm_context_invocation_latency_metric(
+    const iree_vm_context_t* context, iree_vm_function_t function) {
+  if (function.linkage != IREE_VM_FUNCTION_LINKAGE_EXPORT) return NULL;
+  for (iree_host_size_t i = 0; i < context->list.count; ++i) {
+    if (context->list.modules[i] != function.module) continue;
+    const iree_vm_context_module_metrics_t* module_metrics =
+        context->list.module_metrics[i];
+    if (!module_metrics || function.ordinal >= module_metrics->export_count) {
+      return NULL;
+    }
+    return module_metrics->invocation_latency[function.ordinal];
+  }
+  return NULL;
+}
+
 static iree_status_t iree_vm_context_resolve_function_impl(
     const iree_vm_context_t* context, iree_string_view_t full_name,
     const iree_vm_function_signature_t* expected_signature,
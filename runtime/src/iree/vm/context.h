@@ -121,6 +121,13 @@ IREE_API_EXPORT iree_status_t iree_vm_context_resolve_module_state(
     const iree_vm_context_t* context, iree_vm_module_t* module,
     iree_vm_module_state_t** out_module_state);
 
+// Returns the latency histogram for synchronous invocations of the exported
+// |function| or NULL if metrics were not enabled when its module was
+// registered with |context|. Metrics are resolved once at registration so this
+// is cheap enough to call on every invocation.
+IREE_API_EXPORT struct iree_metric_t* iree_vm_context_invocation_latency_metric(
+    const iree_vm_context_t* context, iree_vm_function_t function);
+
 // Sets |out_function| to an exported function with the fully-qualified name
 // of |full_name| or returns IREE_STATUS_NOT_FOUND. The function reference is
 // valid for the lifetime of |context|.
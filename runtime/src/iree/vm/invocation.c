@@ -8,10 +8,12 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/debugging.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
 #include "iree/vm/value.h"
@@ -276,6 +278,11 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Measure the end-to-end latency of the invocation if metrics are enabled.
+  iree_metric_t* latency_metric =
+      iree_vm_context_invocation_latency_metric(context, function);
+  iree_time_t start_time_ns = latency_metric ? iree_time_now() : 0;
+
   // Bound the synchronous invocation to the timeout specified by the user
   // regardless of what the target of the invocation wants when it waits.
   // TODO(benvanik): add a timeout arg to iree_vm_invoke.
@@ -364,6 +371,10 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
               (!iree_status_is_ok(status) && iree_status_is_ok(invoke_status)));
   status = !iree_status_is_ok(invoke_status) ? invoke_status : status;
 
+  if (latency_metric) {
+    iree_metric_observe(latency_metric, iree_time_now() - start_time_ns);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
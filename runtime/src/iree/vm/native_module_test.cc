@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/metrics.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 #include "iree/vm/context.h"
@@ -111,5 +112,65 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Invocation latency metrics are resolved when modules are registered with a
+// context while a default metrics registry is installed.
+TEST(VMNativeModuleMetricsTest, InvocationLatency) {
+  iree_metrics_registry_t* registry = nullptr;
+  IREE_ASSERT_OK(
+      iree_metrics_registry_create(iree_allocator_system(), &registry));
+  iree_metrics_registry_set_default(registry);
+
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                         iree_allocator_system(), &instance));
+  iree_vm_module_t* module_a = nullptr;
+  IREE_ASSERT_OK(module_a_create(instance, iree_allocator_system(), &module_a));
+  iree_vm_module_t* module_b = nullptr;
+  IREE_ASSERT_OK(module_b_create(instance, iree_allocator_system(), &module_b));
+  std::vector<iree_vm_module_t*> modules = {module_a, module_b};
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, modules.size(), modules.data(),
+      iree_allocator_system(), &context));
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context, IREE_SV("module_b.entry"), &function));
+  iree_metric_t* metric =
+      iree_vm_context_invocation_latency_metric(context, function);
+  ASSERT_NE(metric, nullptr);
+  iree_metric_t* registered_metric = nullptr;
+  IREE_ASSERT_OK(iree_metrics_registry_lookup_or_create(
+      registry, IREE_METRIC_TYPE_HISTOGRAM,
+      IREE_SV("iree_vm_invocation_latency_ns"),
+      IREE_SV("function=\"module_b.entry\""), IREE_SV(""),
+      &registered_metric));
+  EXPECT_EQ(metric, registered_metric);
+
+  for (int32_t i = 0; i < 2; ++i) {
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                       iree_allocator_system(), &input_list));
+    auto arg0_value = iree_vm_value_make_i32(i);
+    IREE_ASSERT_OK(iree_vm_list_push_value(input_list.get(), &arg0_value));
+    vm::ref<iree_vm_list_t> output_list;
+    IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                       iree_allocator_system(), &output_list));
+    IREE_ASSERT_OK(iree_vm_invoke(
+        context, function, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr,
+        input_list.get(), output_list.get(), iree_allocator_system()));
+  }
+  iree_metric_value_t value;
+  iree_metric_query(metric, &value);
+  EXPECT_EQ(value.count, 2);
+
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+  iree_metrics_registry_set_default(nullptr);
+  iree_metrics_registry_free(registry);
+}
+
 }  // namespace
 }  // namespace iree
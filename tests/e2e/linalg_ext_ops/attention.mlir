@@ -0,0 +1,15 @@
+func.func @attention() {
+  %query = util.unfoldable_constant dense<1.0> : tensor<2x16x8xf32>
+  %key = util.unfoldable_constant dense<0.5> : tensor<2x32x8xf32>
+  %value = util.unfoldable_constant dense<2.0> : tensor<2x32x8xf32>
+
+  %init = tensor.empty() : tensor<2x16x8xf32>
+  %1 = iree_linalg_ext.attention
+       ins(%query, %key, %value : tensor<2x16x8xf32>, tensor<2x32x8xf32>, tensor<2x32x8xf32>)
+       outs(%init : tensor<2x16x8xf32>) -> tensor<2x16x8xf32>
+  check.expect_almost_eq_const(
+      %1,
+      dense<2.0> : tensor<2x16x8xf32>
+  ) : tensor<2x16x8xf32>
+  return
+}
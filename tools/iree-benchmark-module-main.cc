@@ -51,11 +51,28 @@
 // how the full program will run, though, and YMMV. Always verify timings with
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
-
+//
+// To measure throughput and tail latency under concurrent load use
+// --concurrent_clients=N: each benchmarked function is additionally run by N
+// client threads submitting to the same device. By default each client gets
+// its own VM context (as independent requests in a server would) and issues
+// requests back-to-back (closed loop). --concurrent_arrival_rate= switches to
+// an open loop where requests arrive on a fixed schedule and latency includes
+// any time spent waiting behind previous requests. Latency percentiles are
+// reported as benchmark counters.
+
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -67,6 +84,7 @@
 #include "iree/modules/hal/types.h"
 #include "iree/tooling/context_util.h"
 #include "iree/tooling/device_util.h"
+#include "iree/tooling/metrics_util.h"
 #include "iree/tooling/vm_util.h"
 #include "iree/vm/api.h"
 
@@ -83,6 +101,24 @@ IREE_FLAG(int32_t, batch_size, 1,
 IREE_FLAG(int32_t, batch_concurrency, 1,
           "Number of invocations within a batch that should run concurrently.");
 
+IREE_FLAG(int32_t, concurrent_clients, 0,
+          "Number of client threads concurrently invoking each benchmarked\n"
+          "function. When non-zero an additional `/clients:N` benchmark is\n"
+          "registered per function reporting throughput and latency\n"
+          "percentiles under load.");
+IREE_FLAG(bool, concurrent_shared_context, false,
+          "Whether concurrent clients share the primary VM context instead of\n"
+          "each creating its own context on the shared device. Only valid for\n"
+          "programs that support concurrent invocation within a context.");
+IREE_FLAG(int32_t, concurrent_requests_per_client, 8,
+          "Number of requests each concurrent client issues per benchmark\n"
+          "iteration.");
+IREE_FLAG(double, concurrent_arrival_rate, 0.0,
+          "Open-loop request arrival rate in requests per second per client.\n"
+          "Requests are issued on a fixed schedule and latency is measured\n"
+          "from the scheduled arrival time. 0 issues requests back-to-back\n"
+          "(closed loop).");
+
 IREE_FLAG(string, function, "",
           "Name of a function contained in the module specified by --module= "
           "to run. If this is not set, all the exported functions will be "
@@ -413,6 +449,206 @@ void RegisterDispatchBenchmark(const std::string& function_name,
                                   : benchmark::kMicrosecond);
 }
 
+// State for a single client thread of a concurrent benchmark.
+struct ConcurrentClient {
+  // Context the client invokes in; either owned by the client or the shared
+  // primary context.
+  vm::ref<iree_vm_context_t> context;
+  // Clone of the common inputs so that clients don't share the list. For
+  // coarse-fences functions the list ends with the wait and signal fences and
+  // the signal fence is replaced for each request.
+  vm::ref<iree_vm_list_t> inputs;
+  // Reused for the outputs of each request.
+  vm::ref<iree_vm_list_t> outputs;
+  // Timeline used to signal completion of coarse-fences invocations.
+  vm::ref<iree_hal_semaphore_t> timeline_semaphore;
+  uint64_t timeline_value = 0;
+  // Latency of each request issued by the client, in nanoseconds.
+  std::vector<int64_t> latencies_ns;
+};
+
+// Issues a single synchronous request from |client| and blocks until it has
+// completed. Asynchronous (coarse-fences) functions are invoked with no wait
+// fence and a signal fence on the client timeline that is waited on.
+static void IssueConcurrentRequest(ConcurrentClient* client,
+                                   iree_vm_function_t function, bool is_async) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  vm::ref<iree_hal_fence_t> signal_fence;
+  if (is_async) {
+    IREE_CHECK_OK(iree_hal_fence_create_at(client->timeline_semaphore.get(),
+                                           ++client->timeline_value,
+                                           host_allocator, &signal_fence));
+    IREE_CHECK_OK(iree_vm_list_set_ref_retain(
+        client->inputs.get(), iree_vm_list_size(client->inputs.get()) - 1,
+        signal_fence));
+  }
+  IREE_CHECK_OK(iree_vm_invoke(client->context.get(), function,
+                               IREE_VM_INVOCATION_FLAG_NONE,
+                               /*policy=*/nullptr, client->inputs.get(),
+                               client->outputs.get(), host_allocator));
+  if (is_async) {
+    IREE_CHECK_OK(
+        iree_hal_fence_wait(signal_fence.get(), iree_infinite_timeout()));
+  }
+}
+
+// Runs |request_count| requests from |client|. With a non-zero
+// |arrival_interval| requests are scheduled at fixed intervals from the start
+// and their latency includes any queuing delay behind prior requests.
+static void RunConcurrentClient(ConcurrentClient* client,
+                                iree_vm_function_t function, bool is_async,
+                                int32_t request_count,
+                                std::chrono::nanoseconds arrival_interval) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  using clock = std::chrono::steady_clock;
+  const auto start_time = clock::now();
+  for (int32_t i = 0; i < request_count; ++i) {
+    auto arrival_time = clock::now();
+    if (arrival_interval.count() > 0) {
+      const auto scheduled_time = start_time + i * arrival_interval;
+      std::this_thread::sleep_until(scheduled_time);
+      arrival_time = scheduled_time;
+    }
+    IssueConcurrentRequest(client, function, is_async);
+    const auto completion_time = clock::now();
+    client->latencies_ns.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(completion_time -
+                                                             arrival_time)
+            .count());
+    IREE_CHECK_OK(iree_vm_list_resize(client->outputs.get(), 0));
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Reusable barrier used to start and finish each benchmark iteration across
+// the benchmark thread and all client threads.
+class IterationBarrier {
+ public:
+  explicit IterationBarrier(size_t count) : count_(count) {}
+
+  // Blocks until all |count| threads have arrived.
+  void ArriveAndWait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t generation = generation_;
+    if (++arrived_ == count_) {
+      arrived_ = 0;
+      ++generation_;
+      condition_.notify_all();
+      return;
+    }
+    condition_.wait(lock, [&] { return generation_ != generation; });
+  }
+
+ private:
+  const size_t count_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  size_t arrived_ = 0;
+  uint64_t generation_ = 0;
+};
+
+// Thread body of a client that runs one round of requests per benchmark
+// iteration until |running| is cleared.
+static void RunConcurrentClientThread(ConcurrentClient* client,
+                                      iree_vm_function_t function,
+                                      bool is_async, int32_t request_count,
+                                      std::chrono::nanoseconds arrival_interval,
+                                      IterationBarrier* barrier,
+                                      const std::atomic<bool>* running) {
+  while (true) {
+    barrier->ArriveAndWait();
+    if (!running->load(std::memory_order_acquire)) break;
+    RunConcurrentClient(client, function, is_async, request_count,
+                        arrival_interval);
+    barrier->ArriveAndWait();
+  }
+}
+
+// Returns the nearest-rank |percentile| of the sorted |samples|.
+static int64_t ComputePercentile(const std::vector<int64_t>& samples,
+                                 double percentile) {
+  if (samples.empty()) return 0;
+  size_t rank = (size_t)std::ceil(percentile / 100.0 * samples.size());
+  return samples[std::min(std::max(rank, (size_t)1), samples.size()) - 1];
+}
+
+// Converts |value_ns| to the time unit selected by --time_unit= (defaulting to
+// milliseconds) and returns the unit suffix in |out_suffix|.
+static double ConvertToTimeUnit(int64_t value_ns, const char** out_suffix) {
+  switch (FLAG_time_unit.first ? FLAG_time_unit.second
+                               : benchmark::kMillisecond) {
+    case benchmark::kNanosecond:
+      *out_suffix = kNanosecondsUnitString;
+      return (double)value_ns;
+    case benchmark::kMicrosecond:
+      *out_suffix = kMicrosecondsUnitString;
+      return value_ns / 1e3;
+    default:
+      *out_suffix = kMillisecondsUnitString;
+      return value_ns / 1e6;
+  }
+}
+
+// Runs all |clients| concurrently for each benchmark iteration and reports the
+// aggregate throughput (items/s) and the latency distribution over all
+// requests issued during timing.
+static void BenchmarkConcurrentFunction(
+    const std::string& benchmark_name,
+    std::vector<std::unique_ptr<ConcurrentClient>>* clients,
+    int32_t requests_per_client, std::chrono::nanoseconds arrival_interval,
+    iree_vm_function_t function, bool is_async,
+    benchmark::State& state) {
+  IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(z0, benchmark_name.data(),
+                                      benchmark_name.size());
+  IREE_TRACE_FRAME_MARK();
+
+  for (auto& client : *clients) client->latencies_ns.clear();
+
+  // Client threads are created once and parked on the barrier between
+  // iterations so that thread creation is not included in the timing.
+  IterationBarrier barrier(clients->size() + 1);
+  std::atomic<bool> running(true);
+  std::vector<std::thread> threads;
+  threads.reserve(clients->size());
+  for (auto& client : *clients) {
+    threads.emplace_back(RunConcurrentClientThread, client.get(), function,
+                         is_async, requests_per_client, arrival_interval,
+                         &barrier, &running);
+  }
+
+  const int32_t batch_size = (int32_t)clients->size() * requests_per_client;
+  while (state.KeepRunningBatch(batch_size)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "BenchmarkIteration");
+    IREE_TRACE_FRAME_MARK_NAMED("Iteration");
+    barrier.ArriveAndWait();  // start
+    barrier.ArriveAndWait();  // finish
+    IREE_TRACE_ZONE_END(z1);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  running.store(false, std::memory_order_release);
+  barrier.ArriveAndWait();
+  for (auto& thread : threads) thread.join();
+
+  // Merge latencies from all clients and report the distribution.
+  std::vector<int64_t> latencies_ns;
+  for (auto& client : *clients) {
+    latencies_ns.insert(latencies_ns.end(), client->latencies_ns.begin(),
+                        client->latencies_ns.end());
+  }
+  std::sort(latencies_ns.begin(), latencies_ns.end());
+  static const std::pair<const char*, double> kPercentiles[] = {
+      {"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p999", 99.9}};
+  for (const auto& percentile : kPercentiles) {
+    const char* suffix = nullptr;
+    double value = ConvertToTimeUnit(
+        ComputePercentile(latencies_ns, percentile.second), &suffix);
+    state.counters[std::string(percentile.first) + "_" + suffix] = value;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 // The lifetime of IREEBenchmark should be as long as
 // ::benchmark::RunSpecifiedBenchmarks() where the resources are used during
 // benchmarking.
@@ -424,6 +660,7 @@ class IREEBenchmark {
     IREE_TRACE_SCOPE_NAMED("IREEBenchmark::dtor");
 
     // Order matters. Tear down modules first to release resources.
+    concurrent_clients_.clear();
     inputs_.reset();
     context_.reset();
     iree_tooling_module_list_reset(&module_list_);
@@ -434,8 +671,16 @@ class IREEBenchmark {
       IREE_IGNORE_ERROR(iree_hal_allocator_statistics_fprint(
           stderr, device_allocator_.get()));
     }
+    if (device_ && FLAG_print_statistics) {
+      IREE_IGNORE_ERROR(iree_hal_device_dispatch_cache_statistics_fprint(
+          stderr, device_.get()));
+    }
+    IREE_IGNORE_ERROR(iree_tooling_write_metrics_from_flags(metrics_registry_));
+    iree_tooling_unregister_allocator_metrics(metrics_registry_,
+                                              device_allocator_.get());
     device_allocator_.reset();
     device_.reset();
+    iree_metrics_registry_free(metrics_registry_);
   };
 
   iree_hal_device_t* device() const { return device_.get(); }
@@ -462,6 +707,8 @@ class IREEBenchmark {
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
 
     iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_RETURN_IF_ERROR(iree_tooling_create_metrics_registry_from_flags(
+        host_allocator, &metrics_registry_));
     IREE_RETURN_IF_ERROR(
         iree_tooling_create_instance(host_allocator, &instance_));
 
@@ -472,6 +719,8 @@ class IREEBenchmark {
         instance_.get(), module_list_.count, module_list_.values,
         /*default_device_uri=*/iree_string_view_empty(), host_allocator,
         &context_, &device_, &device_allocator_));
+    IREE_RETURN_IF_ERROR(iree_tooling_register_allocator_metrics(
+        metrics_registry_, device_allocator_.get()));
 
     IREE_TRACE_FRAME_MARK_END_NAMED("init");
     return iree_ok_status();
@@ -500,10 +749,14 @@ class IREEBenchmark {
       // Asynchronous invocation.
       iree::RegisterAsyncBenchmark(function_name, device_.get(), context_.get(),
                                    function, inputs_.get());
+      IREE_RETURN_IF_ERROR(RegisterConcurrentBenchmark(
+          function_name, function, inputs_.get(), /*is_async=*/true));
     } else {
       // Synchronous invocation.
       iree::RegisterGenericBenchmark(function_name, context_.get(), function,
                                      inputs_.get());
+      IREE_RETURN_IF_ERROR(RegisterConcurrentBenchmark(
+          function_name, function, inputs_.get(), /*is_async=*/false));
     }
     return iree_ok_status();
   }
@@ -562,6 +815,9 @@ class IREEBenchmark {
                 std::string(function_name.data, function_name.size),
                 device_.get(), context_.get(), function,
                 /*inputs=*/nullptr);
+            IREE_RETURN_IF_ERROR(RegisterConcurrentBenchmark(
+                std::string(function_name.data, function_name.size), function,
+                /*inputs=*/nullptr, /*is_async=*/true));
           }
         } else {
           // Basic synchronous invocation.
@@ -572,6 +828,9 @@ class IREEBenchmark {
                 std::string(function_name.data, function_name.size),
                 context_.get(), function,
                 /*inputs=*/nullptr);
+            IREE_RETURN_IF_ERROR(RegisterConcurrentBenchmark(
+                std::string(function_name.data, function_name.size), function,
+                /*inputs=*/nullptr, /*is_async=*/false));
           }
         }
       }
@@ -579,12 +838,106 @@ class IREEBenchmark {
     return iree_ok_status();
   }
 
+  // Registers a concurrent benchmark of |function| if --concurrent_clients= is
+  // set. Clients are created up-front so that context creation is not measured.
+  iree_status_t RegisterConcurrentBenchmark(const std::string& function_name,
+                                            iree_vm_function_t function,
+                                            iree_vm_list_t* inputs,
+                                            bool is_async) {
+    if (FLAG_concurrent_clients <= 0) return iree_ok_status();
+    if (FLAG_concurrent_requests_per_client <= 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--concurrent_requests_per_client must be > 0");
+    }
+    if (FLAG_concurrent_arrival_rate < 0.0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--concurrent_arrival_rate must be >= 0");
+    }
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RegisterConcurrentBenchmark");
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    // Gather the modules of the primary context so that per-client contexts
+    // share the same module instances (and through them the same device).
+    std::vector<iree_vm_module_t*> modules;
+    for (iree_host_size_t i = 0;
+         i < iree_vm_context_module_count(context_.get()); ++i) {
+      modules.push_back(iree_vm_context_module_at(context_.get(), i));
+    }
+
+    auto clients =
+        std::make_unique<std::vector<std::unique_ptr<ConcurrentClient>>>();
+    for (int32_t i = 0; i < FLAG_concurrent_clients; ++i) {
+      auto client = std::make_unique<ConcurrentClient>();
+      if (FLAG_concurrent_shared_context) {
+        client->context = vm::retain_ref(context_.get());
+      } else {
+        IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+            instance_.get(), iree_vm_context_flags(context_.get()),
+            modules.size(), modules.data(), host_allocator, &client->context));
+      }
+      if (inputs) {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_list_clone(inputs, host_allocator, &client->inputs));
+      } else {
+        IREE_RETURN_IF_ERROR(iree_vm_list_create(
+            iree_vm_make_undefined_type_def(), 2, host_allocator,
+            &client->inputs));
+      }
+      if (is_async) {
+        IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
+            device_.get(), 0ull, &client->timeline_semaphore));
+        // Requests have no wait fence and replace the signal fence placeholder.
+        vm::ref<iree_hal_fence_t> wait_fence;
+        vm::ref<iree_hal_fence_t> signal_fence;
+        IREE_RETURN_IF_ERROR(
+            iree_vm_list_push_ref_move(client->inputs.get(), wait_fence));
+        IREE_RETURN_IF_ERROR(
+            iree_vm_list_push_ref_move(client->inputs.get(), signal_fence));
+      }
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_create(iree_vm_make_undefined_type_def(), 16,
+                              host_allocator, &client->outputs));
+      clients->push_back(std::move(client));
+    }
+
+    std::chrono::nanoseconds arrival_interval(0);
+    if (FLAG_concurrent_arrival_rate > 0.0) {
+      arrival_interval = std::chrono::nanoseconds(
+          (int64_t)(1e9 / FLAG_concurrent_arrival_rate));
+    }
+
+    auto benchmark_name = "BM_" + function_name +
+                          "/clients:" + std::to_string(FLAG_concurrent_clients);
+    auto* clients_ptr = clients.get();
+    int32_t requests_per_client = FLAG_concurrent_requests_per_client;
+    benchmark::RegisterBenchmark(
+        benchmark_name.c_str(),
+        [=](benchmark::State& state) -> void {
+          BenchmarkConcurrentFunction(benchmark_name, clients_ptr,
+                                      requests_per_client, arrival_interval,
+                                      function, is_async, state);
+        })
+        // Clients run on their own threads; include them in CPU time.
+        ->MeasureProcessCPUTime()
+        ->UseRealTime()
+        ->Unit(FLAG_time_unit.first ? FLAG_time_unit.second
+                                    : benchmark::kMillisecond);
+    concurrent_clients_.push_back(std::move(clients));
+    return iree_ok_status();
+  }
+
   iree::vm::ref<iree_vm_instance_t> instance_;
   iree::vm::ref<iree_vm_context_t> context_;
   iree::vm::ref<iree_hal_device_t> device_;
   iree::vm::ref<iree_hal_allocator_t> device_allocator_;
   iree_tooling_module_list_t module_list_;
   iree::vm::ref<iree_vm_list_t> inputs_;
+  // Default metrics registry when --print_metrics= is set; freed last.
+  iree_metrics_registry_t* metrics_registry_ = nullptr;
+  // Clients for each registered concurrent benchmark; released before the
+  // primary context as they may hold contexts sharing its modules.
+  std::vector<std::unique_ptr<std::vector<std::unique_ptr<ConcurrentClient>>>>
+      concurrent_clients_;
 };
 }  // namespace
 }  // namespace iree
@@ -0,0 +1,17 @@
+// RUN: iree-compile --iree-hal-target-backends=vmvx --iree-compile-statistics-file=- --output-format=vm-asm -o /dev/null %s | FileCheck %s
+
+// CHECK: "total_wall_time_ms":
+// CHECK: "phases": [
+// CHECK: "name": "input"
+// CHECK: "name": "flow"
+// CHECK: "executable_count": 1
+// CHECK: "name": "iree-flow-deduplicate-executables"
+// CHECK: "name": "stream"
+// CHECK: "name": "hal"
+// CHECK: "name": "vm"
+// CHECK: "executables": [
+// CHECK: "name": "abs_dispatch_0"
+func.func @abs(%input : tensor<f32>) -> (tensor<f32>) {
+  %result = math.absf %input : tensor<f32>
+  return %result : tensor<f32>
+}